@@ -82,6 +82,8 @@ char usage[] = "\n"
   "      -t       : output statistics\n"
   "      -e       : show input cloud during encoding\n"
   "      -r       : raw encoding of disparity maps\n"
+  "      -p       : predictive lossless image codec instead of PNG\n"
+  "      -m       : temporal prediction (with -p)\n"
 
   "\n"
   "  example:\n"
@@ -293,6 +295,8 @@ main (int argc, char **argv)
   bool doColorEncoding;
   bool bShowInputCloud;
   bool bRawImageEncoding;
+  bool bPredictiveCodec;
+  bool bTemporalPrediction;
 
   std::string fileName = "pc_compressed.pcc";
   std::string hostName = "localhost";
@@ -309,6 +313,8 @@ main (int argc, char **argv)
   doColorEncoding = false;
   bShowInputCloud = false;
   bRawImageEncoding = false;
+  bPredictiveCodec = false;
+  bTemporalPrediction = false;
 
   if (pcl::console::find_argument (argc, argv, "-e")>0) 
     bShowInputCloud = true;
@@ -316,6 +322,12 @@ main (int argc, char **argv)
   if (pcl::console::find_argument (argc, argv, "-r")>0)
     bRawImageEncoding = true;
 
+  if (pcl::console::find_argument (argc, argv, "-p")>0)
+    bPredictiveCodec = true;
+
+  if (pcl::console::find_argument (argc, argv, "-m")>0)
+    bTemporalPrediction = true;
+
   if (pcl::console::find_argument (argc, argv, "-s")>0) 
   {
     bEnDecode = true;
@@ -368,6 +380,11 @@ main (int argc, char **argv)
   }
 
   organizedCoder = new OrganizedPointCloudCompression<PointXYZRGBA> ();
+  if (bPredictiveCodec)
+  {
+    organizedCoder->setImageCodec (OrganizedPointCloudCompression<PointXYZRGBA>::PREDICTIVE_IMAGE_CODEC);
+    organizedCoder->setTemporalPrediction (bTemporalPrediction);
+  }
 
 
   if (!bServerFileMode) 
@@ -0,0 +1,504 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+#include "benchmark.h"
+#include <pcl/common/profiler.h>
+#include <pcl/console/parse.h>
+#include <boost/date_time/posix_time/posix_time.hpp>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <sstream>
+
+using namespace pcl::console;
+
+namespace
+{
+  /** \brief A registered benchmark. */
+  struct Entry
+  {
+    std::string name;
+    benchmark::Function function;
+  };
+
+  bool
+  compareEntries (const Entry &a, const Entry &b)
+  {
+    return (a.name < b.name);
+  }
+
+  /** \brief The registered benchmarks, created on first use as they are registered at static initialization. */
+  std::vector<Entry>&
+  getRegistry ()
+  {
+    static std::vector<Entry> registry;
+    return (registry);
+  }
+
+  double
+  getMilliseconds (const boost::posix_time::time_duration &duration)
+  {
+    return (static_cast<double> (duration.total_microseconds ()) * 1e-3);
+  }
+
+  /** \brief Statistics of the samples of a benchmark. */
+  struct Statistics
+  {
+    Statistics () : iterations (0), mean (0), stddev (0), min (0), p50 (0), p90 (0), p99 (0), max (0), items_per_second (0), bytes_per_second (0) {}
+
+    size_t iterations;
+    double mean, stddev, min, p50, p90, p99, max;
+    double items_per_second, bytes_per_second;
+  };
+
+  /** \brief The sample of rank ceil (q * n) in the sorted samples. */
+  double
+  getPercentile (const std::vector<double> &sorted, double q)
+  {
+    size_t rank = static_cast<size_t> (std::ceil (q * static_cast<double> (sorted.size ())));
+    rank = std::min (std::max (rank, static_cast<size_t> (1)), sorted.size ());
+    return (sorted[rank - 1]);
+  }
+
+  Statistics
+  computeStatistics (const benchmark::Benchmark &b)
+  {
+    Statistics stats;
+    std::vector<double> sorted = b.getSamples ();
+    if (sorted.empty ())
+      return (stats);
+    std::sort (sorted.begin (), sorted.end ());
+    stats.iterations = sorted.size ();
+    double sum = 0, sum_sq = 0;
+    for (size_t i = 0; i < sorted.size (); ++i)
+    {
+      sum += sorted[i];
+      sum_sq += sorted[i] * sorted[i];
+    }
+    const double n = static_cast<double> (sorted.size ());
+    stats.mean = sum / n;
+    stats.stddev = std::sqrt (std::max (sum_sq / n - stats.mean * stats.mean, 0.0));
+    stats.min = sorted.front ();
+    stats.p50 = getPercentile (sorted, 0.5);
+    stats.p90 = getPercentile (sorted, 0.9);
+    stats.p99 = getPercentile (sorted, 0.99);
+    stats.max = sorted.back ();
+    if (sum > 0)
+    {
+      stats.items_per_second = static_cast<double> (b.getItemsPerIteration ()) * n / (sum * 1e-3);
+      stats.bytes_per_second = static_cast<double> (b.getBytesPerIteration ()) * n / (sum * 1e-3);
+    }
+    return (stats);
+  }
+
+  std::string
+  escapeJSON (const std::string &str)
+  {
+    std::string escaped;
+    for (size_t i = 0; i < str.size (); ++i)
+    {
+      if (str[i] == '"' || str[i] == '\\')
+        escaped += '\\';
+      escaped += str[i];
+    }
+    return (escaped);
+  }
+
+  /** \brief Write one benchmark per line, which is what \ref readResults expects. */
+  void
+  writeJSONResult (std::ostream &os, const benchmark::Benchmark &b, const Statistics &stats)
+  {
+    os << "{\"name\": \"" << escapeJSON (b.getName ()) << "\"";
+    if (b.isSkipped ())
+    {
+      os << ", \"skipped\": \"" << escapeJSON (b.getSkipReason ()) << "\"}";
+      return;
+    }
+    os << ", \"iterations\": " << stats.iterations
+       << ", \"items_per_iteration\": " << b.getItemsPerIteration ()
+       << ", \"items_per_second\": " << stats.items_per_second
+       << ", \"bytes_per_second\": " << stats.bytes_per_second
+       << ", \"mean_ms\": " << stats.mean
+       << ", \"stddev_ms\": " << stats.stddev
+       << ", \"min_ms\": " << stats.min
+       << ", \"p50_ms\": " << stats.p50
+       << ", \"p90_ms\": " << stats.p90
+       << ", \"p99_ms\": " << stats.p99
+       << ", \"max_ms\": " << stats.max << "}";
+  }
+
+  std::string
+  getBuildDescription ()
+  {
+    std::ostringstream os;
+#ifdef NDEBUG
+    os << "release";
+#else
+    os << "debug";
+#endif
+#ifdef __SSE4_1__
+    os << ", sse4.1";
+#elif defined (__SSE2__)
+    os << ", sse2";
+#endif
+#ifdef _OPENMP
+    os << ", openmp";
+#endif
+#ifdef __VERSION__
+    os << ", compiler " << __VERSION__;
+#endif
+    return (os.str ());
+  }
+
+  bool
+  writeJSON (const std::string &file_name, const std::vector<benchmark::Benchmark*> &results, const benchmark::Settings &settings)
+  {
+    std::ofstream file (file_name.c_str ());
+    if (!file.is_open ())
+      return (false);
+    file << std::setprecision (10);
+    file << "{\n  \"context\": {\"date\": \"" << boost::posix_time::to_iso_extended_string (boost::posix_time::second_clock::universal_time ())
+         << "\", \"build\": \"" << escapeJSON (getBuildDescription ())
+         << "\", \"threads\": " << settings.nr_threads
+         << ", \"hardware_threads\": " << boost::thread::hardware_concurrency ()
+         << ", \"min_time_ms\": " << settings.min_time
+         << ", \"min_iterations\": " << settings.min_iterations << "},\n  \"benchmarks\": [\n";
+    for (size_t i = 0; i < results.size (); ++i)
+    {
+      file << "    ";
+      writeJSONResult (file, *results[i], computeStatistics (*results[i]));
+      file << (i + 1 < results.size () ? ",\n" : "\n");
+    }
+    file << "  ]\n}\n";
+    return (file.good ());
+  }
+
+  /** \brief Extract the value of \a key from a line written by \ref writeJSONResult. */
+  bool
+  extractValue (const std::string &line, const std::string &key, std::string &value)
+  {
+    const std::string pattern = "\"" + key + "\": ";
+    size_t pos = line.find (pattern);
+    if (pos == std::string::npos)
+      return (false);
+    pos += pattern.size ();
+    if (line[pos] == '"')
+    {
+      const size_t end = line.find ('"', pos + 1);
+      value = line.substr (pos + 1, end - pos - 1);
+    }
+    else
+      value = line.substr (pos, line.find_first_of (",}", pos) - pos);
+    return (true);
+  }
+
+  /** \brief Read the median latencies of a result file, by benchmark name. */
+  bool
+  readResults (const std::string &file_name, std::map<std::string, double> &medians, std::vector<std::string> &names)
+  {
+    std::ifstream file (file_name.c_str ());
+    if (!file.is_open ())
+      return (false);
+    std::string line, name, p50;
+    while (std::getline (file, line))
+    {
+      if (!extractValue (line, "name", name) || !extractValue (line, "p50_ms", p50))
+        continue;
+      medians[name] = atof (p50.c_str ());
+      names.push_back (name);
+    }
+    return (true);
+  }
+
+  /** \brief Print the change of the median latencies between two result files.
+    * \return the number of benchmarks slower by more than \a threshold percents
+    */
+  int
+  compareResults (const std::string &baseline_file, const std::string &current_file, double threshold)
+  {
+    std::map<std::string, double> baseline, current;
+    std::vector<std::string> baseline_names, names;
+    if (!readResults (baseline_file, baseline, baseline_names) || !readResults (current_file, current, names))
+    {
+      print_error ("Could not read %s or %s!\n", baseline_file.c_str (), current_file.c_str ());
+      return (-1);
+    }
+
+    int nr_regressions = 0;
+    print_info ("%-52s %12s %12s %9s\n", "benchmark", "base p50 ms", "p50 ms", "change");
+    for (size_t i = 0; i < names.size (); ++i)
+    {
+      std::map<std::string, double>::const_iterator it = baseline.find (names[i]);
+      if (it == baseline.end () || it->second <= 0)
+      {
+        print_info ("%-52s %12s %12.4g %9s\n", names[i].c_str (), "-", current[names[i]], "new");
+        continue;
+      }
+      const double change = (current[names[i]] / it->second - 1.0) * 100.0;
+      print_info ("%-52s %12.4g %12.4g ", names[i].c_str (), it->second, current[names[i]]);
+      // the table stays on stdout, print_error would write to stderr
+      if (change > threshold)
+      {
+        print_color (stdout, TT_BRIGHT, TT_RED, "%+8.1f%%\n", change);
+        ++nr_regressions;
+      }
+      else if (change < -threshold)
+        print_color (stdout, TT_BRIGHT, TT_GREEN, "%+8.1f%%\n", change);
+      else
+        print_info ("%+8.1f%%\n", change);
+    }
+    print_info ("%d benchmark(s) slower by more than %g%%.\n", nr_regressions, threshold);
+    return (nr_regressions);
+  }
+
+  void
+  printResult (const benchmark::Benchmark &b)
+  {
+    if (b.isSkipped ())
+    {
+      print_warn ("%-52s skipped: %s\n", b.getName ().c_str (), b.getSkipReason ().c_str ());
+      return;
+    }
+    const Statistics stats = computeStatistics (b);
+    print_info ("%-52s %6zu ", b.getName ().c_str (), stats.iterations);
+    print_value ("%10.4g %10.4g %10.4g %10.4g", stats.p50, stats.p90, stats.p99, stats.mean);
+    if (b.getBytesPerIteration () > 0)
+      print_info (" %10.4g MB/s\n", stats.bytes_per_second * 1e-6);
+    else if (b.getItemsPerIteration () > 0)
+      print_info (" %10.4g M/s\n", stats.items_per_second * 1e-6);
+    else
+      print_info ("\n");
+  }
+
+  void
+  printHelp (int, char **argv)
+  {
+    const benchmark::Settings defaults;
+    print_error ("Syntax is: %s <options>\n", argv[0]);
+    print_info ("  where options are:\n");
+    print_info ("                     -data_dir X       = directory of the data sets, i.e. test/ of the source tree (default: .)\n");
+    print_info ("                     -filter X         = only run the benchmarks whose name contains X\n");
+    print_info ("                     -list             = list the benchmarks and exit\n");
+    print_info ("                     -output X         = save the results to the JSON file X\n");
+    print_info ("                     -compare X Y      = compare the result files X (baseline) and Y, and exit\n");
+    print_info ("                     -threshold X      = change of the median in percents reported as a regression (default: 5)\n");
+    print_info ("                     -min_time X       = minimum time spent in every benchmark, in ms (default: ");
+    print_value ("%g", defaults.min_time); print_info (")\n");
+    print_info ("                     -min_iterations X = minimum number of samples of every benchmark (default: ");
+    print_value ("%d", defaults.min_iterations); print_info (")\n");
+    print_info ("                     -max_iterations X = maximum number of samples of every benchmark (default: ");
+    print_value ("%d", defaults.max_iterations); print_info (")\n");
+    print_info ("                     -warmup X         = number of repetitions before the samples are recorded (default: ");
+    print_value ("%d", defaults.warmup_iterations); print_info (")\n");
+    print_info ("                     -threads X        = number of threads of the parallel algorithms (default: number of cores)\n");
+    print_info ("                     -profile X        = enable pcl::Profiler and save its JSON report to X\n");
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+benchmark::Benchmark::Benchmark (const std::string &name, const Settings &settings)
+  : name_ (name), settings_ (settings), samples_ (), total_time_ (0.0), warmup_done_ (0), running_ (false)
+  , start_ (), pause_start_ (), paused_time_ (0.0), items_per_iteration_ (0), bytes_per_iteration_ (0)
+  , skipped_ (false), skip_reason_ ()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+benchmark::Benchmark::keepRunning ()
+{
+  if (running_)
+  {
+    const double sample = getMilliseconds (boost::posix_time::microsec_clock::universal_time () - start_) - paused_time_;
+    if (warmup_done_ < settings_.warmup_iterations)
+      ++warmup_done_;
+    else
+    {
+      samples_.push_back (sample);
+      total_time_ += sample;
+    }
+  }
+
+  const int nr_samples = static_cast<int> (samples_.size ());
+  if (skipped_ || nr_samples >= settings_.max_iterations ||
+      (nr_samples >= settings_.min_iterations && total_time_ >= settings_.min_time))
+  {
+    running_ = false;
+    return (false);
+  }
+  running_ = true;
+  paused_time_ = 0.0;
+  start_ = boost::posix_time::microsec_clock::universal_time ();
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+benchmark::Benchmark::pauseTiming ()
+{
+  pause_start_ = boost::posix_time::microsec_clock::universal_time ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+benchmark::Benchmark::resumeTiming ()
+{
+  paused_time_ += getMilliseconds (boost::posix_time::microsec_clock::universal_time () - pause_start_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+benchmark::Benchmark::skip (const std::string &reason)
+{
+  skipped_ = true;
+  skip_reason_ = reason;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+std::string
+benchmark::Benchmark::getDataFile (const std::string &file_name) const
+{
+  return (settings_.data_dir + "/" + file_name);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+benchmark::Registrar::Registrar (const char* name, Function function)
+{
+  Entry entry;
+  entry.name = name;
+  entry.function = function;
+  getRegistry ().push_back (entry);
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  if (find_switch (argc, argv, "-h"))
+  {
+    printHelp (argc, argv);
+    return (0);
+  }
+
+  const int compare_index = find_argument (argc, argv, "-compare");
+  if (compare_index != -1)
+  {
+    if (compare_index + 2 >= argc)
+    {
+      print_error ("-compare needs two result files!\n");
+      return (-1);
+    }
+    double threshold = 5.0;
+    parse_argument (argc, argv, "-threshold", threshold);
+    return (compareResults (argv[compare_index + 1], argv[compare_index + 2], threshold) == 0 ? 0 : 1);
+  }
+
+  benchmark::Settings settings;
+  settings.nr_threads = std::max (static_cast<int> (boost::thread::hardware_concurrency ()), 1);
+  parse_argument (argc, argv, "-data_dir", settings.data_dir);
+  parse_argument (argc, argv, "-min_time", settings.min_time);
+  parse_argument (argc, argv, "-min_iterations", settings.min_iterations);
+  parse_argument (argc, argv, "-max_iterations", settings.max_iterations);
+  parse_argument (argc, argv, "-warmup", settings.warmup_iterations);
+  parse_argument (argc, argv, "-threads", settings.nr_threads);
+  settings.min_iterations = std::max (settings.min_iterations, 1);
+  settings.max_iterations = std::max (settings.max_iterations, settings.min_iterations);
+  settings.nr_threads = std::max (settings.nr_threads, 1);
+  std::string filter, output_file, profile_file;
+  parse_argument (argc, argv, "-filter", filter);
+  parse_argument (argc, argv, "-output", output_file);
+  parse_argument (argc, argv, "-profile", profile_file);
+
+  // the registration order depends on the link order, the benchmarks are sorted by name
+  std::vector<Entry> entries = getRegistry ();
+  std::vector<Entry> selected;
+  for (size_t i = 0; i < entries.size (); ++i)
+    if (entries[i].name.find (filter) != std::string::npos)
+      selected.push_back (entries[i]);
+  std::sort (selected.begin (), selected.end (), compareEntries);
+
+  if (find_switch (argc, argv, "-list"))
+  {
+    for (size_t i = 0; i < selected.size (); ++i)
+      print_info ("%s\n", selected[i].name.c_str ());
+    return (0);
+  }
+
+  if (!profile_file.empty ())
+    pcl::Profiler::getInstance ().setEnabled (true);
+
+  print_info ("Running "); print_value ("%zu", selected.size ()); print_info (" benchmarks (");
+  print_value ("%s", getBuildDescription ().c_str ()); print_info (", "); print_value ("%d", settings.nr_threads);
+  print_info (" threads), latencies in ms:\n");
+  print_info ("%-52s %6s %10s %10s %10s %10s %12s\n", "benchmark", "iter", "p50", "p90", "p99", "mean", "throughput");
+  std::vector<benchmark::Benchmark*> results;
+  for (size_t i = 0; i < selected.size (); ++i)
+  {
+    results.push_back (new benchmark::Benchmark (selected[i].name, settings));
+    {
+      PCL_PROFILE_SCOPE (selected[i].name.c_str ());
+      // the library output would be interleaved with the results
+      const pcl::console::VERBOSITY_LEVEL level = pcl::console::getVerbosityLevel ();
+      pcl::console::setVerbosityLevel (pcl::console::L_ERROR);
+      selected[i].function (*results.back ());
+      pcl::console::setVerbosityLevel (level);
+    }
+    printResult (*results.back ());
+  }
+
+  int result = 0;
+  if (!output_file.empty () && !writeJSON (output_file, results, settings))
+  {
+    print_error ("Could not write %s!\n", output_file.c_str ());
+    result = -1;
+  }
+  if (!profile_file.empty () && !pcl::Profiler::getInstance ().saveJSON (profile_file))
+  {
+    print_error ("Could not write %s!\n", profile_file.c_str ());
+    result = -1;
+  }
+  for (size_t i = 0; i < results.size (); ++i)
+    delete results[i];
+  return (result);
+}
+/* ]--- */
@@ -0,0 +1,239 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+#ifndef PCL_BENCHMARKS_BENCHMARK_H_
+#define PCL_BENCHMARKS_BENCHMARK_H_
+
+#include <pcl/point_cloud.h>
+#include <pcl/io/pcd_io.h>
+#include <pcl/filters/filter.h>
+#include <pcl/console/print.h>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <string>
+#include <vector>
+
+/** \brief Harness of pcl_benchmarks.
+  *
+  * A benchmark is a function which prepares its data, then repeats the measured code as long as
+  * \ref Benchmark::keepRunning returns true. Every repetition is one sample, of which the harness
+  * reports the throughput and the latency percentiles:
+  * \code
+  * void
+  * voxelGrid (benchmark::Benchmark &b)
+  * {
+  *   pcl::PointCloud<pcl::PointXYZ>::Ptr cloud (new pcl::PointCloud<pcl::PointXYZ>);
+  *   if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+  *     return;
+  *   ...
+  *   while (b.keepRunning ())
+  *     grid.filter (output);
+  *   b.setItemsPerIteration (cloud->points.size ());
+  * }
+  * PCL_BENCHMARK ("filters/VoxelGrid", voxelGrid);
+  * \endcode
+  *
+  * Benchmarks must be deterministic (fixed seeds, fixed data) so that the results of two builds can
+  * be compared.
+  */
+namespace benchmark
+{
+  /** \brief The settings shared by all the benchmarks. */
+  struct Settings
+  {
+    Settings ()
+      : data_dir ("."), min_time (1000.0), min_iterations (5), max_iterations (1000)
+      , warmup_iterations (1), nr_threads (1)
+    {
+    }
+
+    /** \brief The directory of the data sets (the test directory of the source tree). */
+    std::string data_dir;
+    /** \brief The minimum time spent in a benchmark, in milliseconds. */
+    double min_time;
+    /** \brief The minimum number of samples of a benchmark. */
+    int min_iterations;
+    /** \brief The maximum number of samples of a benchmark. */
+    int max_iterations;
+    /** \brief The number of repetitions run before the samples are recorded. */
+    int warmup_iterations;
+    /** \brief The number of threads given to the parallel algorithms. */
+    int nr_threads;
+  };
+
+  /** \brief The state of a running benchmark, and its samples. */
+  class Benchmark
+  {
+    public:
+      Benchmark (const std::string &name, const Settings &settings);
+
+      /** \brief Return true while the measured code must be repeated. The time between two
+        * calls is one sample, unless it is a warmup repetition.
+        */
+      bool
+      keepRunning ();
+
+      /** \brief Exclude the time until \ref resumeTiming from the current sample, e.g. to reset an input. */
+      void
+      pauseTiming ();
+
+      /** \brief Resume the timing of the current sample. */
+      void
+      resumeTiming ();
+
+      /** \brief Set the number of items (usually points) processed by one repetition. */
+      inline void
+      setItemsPerIteration (size_t items)
+      {
+        items_per_iteration_ = items;
+      }
+
+      /** \brief Set the number of bytes processed by one repetition, for the I/O benchmarks. */
+      inline void
+      setBytesPerIteration (size_t bytes)
+      {
+        bytes_per_iteration_ = bytes;
+      }
+
+      /** \brief Mark the benchmark as skipped, e.g. because a data set is missing. */
+      void
+      skip (const std::string &reason);
+
+      /** \brief Get the number of threads to give to the parallel algorithms. */
+      inline int
+      getNumberOfThreads () const
+      {
+        return (settings_.nr_threads);
+      }
+
+      /** \brief Get the path of a data set. */
+      std::string
+      getDataFile (const std::string &file_name) const;
+
+      /** \brief Load a data set, and remove its non finite points. The benchmark is skipped if the file cannot be read.
+        * \param[in] file_name the name of the PCD file in the data directory
+        * \param[out] cloud the dense point cloud
+        * \return false if the benchmark must return
+        */
+      template <typename PointT> bool
+      loadCloud (const std::string &file_name, pcl::PointCloud<PointT> &cloud)
+      {
+        if (pcl::io::loadPCDFile (getDataFile (file_name), cloud) < 0)
+        {
+          skip ("cannot read " + getDataFile (file_name));
+          return (false);
+        }
+        std::vector<int> indices;
+        pcl::removeNaNFromPointCloud (cloud, cloud, indices);
+        return (true);
+      }
+
+      inline const std::string&
+      getName () const
+      {
+        return (name_);
+      }
+
+      inline bool
+      isSkipped () const
+      {
+        return (skipped_);
+      }
+
+      inline const std::string&
+      getSkipReason () const
+      {
+        return (skip_reason_);
+      }
+
+      /** \brief Get the samples, in milliseconds. */
+      inline const std::vector<double>&
+      getSamples () const
+      {
+        return (samples_);
+      }
+
+      inline size_t
+      getItemsPerIteration () const
+      {
+        return (items_per_iteration_);
+      }
+
+      inline size_t
+      getBytesPerIteration () const
+      {
+        return (bytes_per_iteration_);
+      }
+
+    private:
+      std::string name_;
+      const Settings &settings_;
+      std::vector<double> samples_;
+      /** \brief The sum of the samples, in milliseconds. */
+      double total_time_;
+      int warmup_done_;
+      bool running_;
+      boost::posix_time::ptime start_;
+      boost::posix_time::ptime pause_start_;
+      /** \brief The time paused during the current sample, in milliseconds. */
+      double paused_time_;
+      size_t items_per_iteration_;
+      size_t bytes_per_iteration_;
+      bool skipped_;
+      std::string skip_reason_;
+  };
+
+  /** \brief The signature of the benchmarks. */
+  typedef void (*Function) (Benchmark &b);
+
+  /** \brief Register a benchmark at static initialization, see PCL_BENCHMARK. */
+  class Registrar
+  {
+    public:
+      Registrar (const char* name, Function function);
+  };
+}
+
+#define PCL_BENCHMARK_JOIN_(a, b) a ## b
+#define PCL_BENCHMARK_JOIN(a, b) PCL_BENCHMARK_JOIN_(a, b)
+
+/** \brief Register \a function under \a name ("<module>/<algorithm>"). */
+#define PCL_BENCHMARK(name, function) \
+  static benchmark::Registrar PCL_BENCHMARK_JOIN (benchmark_registrar_, __LINE__) (name, function)
+
+#endif    // PCL_BENCHMARKS_BENCHMARK_H_
@@ -0,0 +1,132 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include "benchmark.h"
+#include <pcl/point_types.h>
+#include <pcl/compression/octree_pointcloud_compression.h>
+#include <pcl/compression/tiled_octree_pointcloud_compression.h>
+
+#include <sstream>
+
+namespace
+{
+  typedef pcl::PointXYZRGBA PointT;
+  typedef pcl::PointCloud<PointT> Cloud;
+
+  // every frame is an intra frame, so that all the repetitions do the same work
+  const double point_resolution = 0.001;
+  const double octree_resolution = 0.01;
+  const unsigned int i_frame_rate = 0;
+
+  template <typename Encoder> void
+  encode (benchmark::Benchmark &b, Encoder &encoder)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    std::stringstream stream;
+    while (b.keepRunning ())
+    {
+      b.pauseTiming ();
+      stream.str ("");
+      stream.clear ();
+      b.resumeTiming ();
+      encoder.encodePointCloud (cloud, stream);
+    }
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+
+  template <typename Encoder, typename Decoder> void
+  decode (benchmark::Benchmark &b, Encoder &encoder, Decoder &decoder)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    std::stringstream encoded;
+    encoder.encodePointCloud (cloud, encoded);
+    const std::string data = encoded.str ();
+    Cloud::Ptr decoded (new Cloud);
+    while (b.keepRunning ())
+    {
+      b.pauseTiming ();
+      std::istringstream stream (data);
+      b.resumeTiming ();
+      decoder.decodePointCloud (stream, decoded);
+    }
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+
+  void
+  octreeEncode (benchmark::Benchmark &b)
+  {
+    pcl::io::OctreePointCloudCompression<PointT> encoder (pcl::io::MANUAL_CONFIGURATION, false, point_resolution, octree_resolution, false, i_frame_rate);
+    encode (b, encoder);
+  }
+
+  void
+  octreeDecode (benchmark::Benchmark &b)
+  {
+    pcl::io::OctreePointCloudCompression<PointT> encoder (pcl::io::MANUAL_CONFIGURATION, false, point_resolution, octree_resolution, false, i_frame_rate);
+    pcl::io::OctreePointCloudCompression<PointT> decoder (pcl::io::MANUAL_CONFIGURATION, false, point_resolution, octree_resolution, false, i_frame_rate);
+    decode (b, encoder, decoder);
+  }
+
+  void
+  tiledEncode (benchmark::Benchmark &b)
+  {
+    pcl::io::TiledOctreePointCloudCompression<PointT> encoder (pcl::io::MANUAL_CONFIGURATION, false, point_resolution, octree_resolution, false, i_frame_rate);
+    encoder.setNumberOfThreads (b.getNumberOfThreads ());
+    encode (b, encoder);
+  }
+
+  void
+  tiledDecode (benchmark::Benchmark &b)
+  {
+    pcl::io::TiledOctreePointCloudCompression<PointT> encoder (pcl::io::MANUAL_CONFIGURATION, false, point_resolution, octree_resolution, false, i_frame_rate);
+    pcl::io::TiledOctreePointCloudCompression<PointT> decoder (pcl::io::MANUAL_CONFIGURATION, false, point_resolution, octree_resolution, false, i_frame_rate);
+    encoder.setNumberOfThreads (b.getNumberOfThreads ());
+    decoder.setNumberOfThreads (b.getNumberOfThreads ());
+    decode (b, encoder, decoder);
+  }
+}
+
+PCL_BENCHMARK ("compression/OctreePointCloudCompression/encode", octreeEncode);
+PCL_BENCHMARK ("compression/OctreePointCloudCompression/decode", octreeDecode);
+PCL_BENCHMARK ("compression/TiledOctreePointCloudCompression/encode", tiledEncode);
+PCL_BENCHMARK ("compression/TiledOctreePointCloudCompression/decode", tiledDecode);
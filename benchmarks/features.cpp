@@ -0,0 +1,127 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include "benchmark.h"
+#include <pcl/point_types.h>
+#include <pcl/features/normal_3d.h>
+#include <pcl/features/normal_3d_omp.h>
+#include <pcl/features/fpfh_omp.h>
+#include <pcl/filters/voxel_grid.h>
+#include <pcl/search/kdtree.h>
+
+namespace
+{
+  typedef pcl::PointXYZ PointT;
+  typedef pcl::PointCloud<PointT> Cloud;
+
+  /** \brief Load the table scene, downsampled to 5 mm. */
+  bool
+  loadScene (benchmark::Benchmark &b, Cloud &cloud)
+  {
+    Cloud::Ptr input (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *input))
+      return (false);
+    pcl::VoxelGrid<PointT> grid;
+    grid.setInputCloud (input);
+    grid.setLeafSize (0.005f, 0.005f, 0.005f);
+    grid.filter (cloud);
+    return (true);
+  }
+
+  void
+  normalEstimation (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!loadScene (b, *cloud))
+      return;
+    pcl::NormalEstimation<PointT, pcl::Normal> ne;
+    ne.setInputCloud (cloud);
+    ne.setSearchMethod (pcl::search::KdTree<PointT>::Ptr (new pcl::search::KdTree<PointT>));
+    ne.setRadiusSearch (0.015);
+    pcl::PointCloud<pcl::Normal> normals;
+    while (b.keepRunning ())
+      ne.compute (normals);
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+
+  void
+  normalEstimationOMP (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!loadScene (b, *cloud))
+      return;
+    pcl::NormalEstimationOMP<PointT, pcl::Normal> ne (b.getNumberOfThreads ());
+    ne.setInputCloud (cloud);
+    ne.setSearchMethod (pcl::search::KdTree<PointT>::Ptr (new pcl::search::KdTree<PointT>));
+    ne.setRadiusSearch (0.015);
+    pcl::PointCloud<pcl::Normal> normals;
+    while (b.keepRunning ())
+      ne.compute (normals);
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+
+  void
+  fpfhEstimationOMP (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!loadScene (b, *cloud))
+      return;
+    pcl::search::KdTree<PointT>::Ptr tree (new pcl::search::KdTree<PointT>);
+    pcl::PointCloud<pcl::Normal>::Ptr normals (new pcl::PointCloud<pcl::Normal>);
+    pcl::NormalEstimationOMP<PointT, pcl::Normal> ne (b.getNumberOfThreads ());
+    ne.setInputCloud (cloud);
+    ne.setSearchMethod (tree);
+    ne.setRadiusSearch (0.015);
+    ne.compute (*normals);
+
+    pcl::FPFHEstimationOMP<PointT, pcl::Normal, pcl::FPFHSignature33> fpfh (b.getNumberOfThreads ());
+    fpfh.setInputCloud (cloud);
+    fpfh.setInputNormals (normals);
+    fpfh.setSearchMethod (tree);
+    fpfh.setRadiusSearch (0.025);
+    pcl::PointCloud<pcl::FPFHSignature33> features;
+    while (b.keepRunning ())
+      fpfh.compute (features);
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+}
+
+PCL_BENCHMARK ("features/NormalEstimation_r15mm", normalEstimation);
+PCL_BENCHMARK ("features/NormalEstimationOMP_r15mm", normalEstimationOMP);
+PCL_BENCHMARK ("features/FPFHEstimationOMP_r25mm", fpfhEstimationOMP);
@@ -0,0 +1,120 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include "benchmark.h"
+#include <pcl/point_types.h>
+#include <pcl/filters/voxel_grid.h>
+#include <pcl/filters/passthrough.h>
+#include <pcl/filters/statistical_outlier_removal.h>
+
+namespace
+{
+  typedef pcl::PointXYZRGBA PointT;
+  typedef pcl::PointCloud<PointT> Cloud;
+
+  void
+  voxelGrid (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    pcl::VoxelGrid<PointT> grid;
+    grid.setInputCloud (cloud);
+    grid.setLeafSize (0.01f, 0.01f, 0.01f);
+    Cloud output;
+    while (b.keepRunning ())
+      grid.filter (output);
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+
+  void
+  voxelGridPointCloud2 (benchmark::Benchmark &b)
+  {
+    sensor_msgs::PointCloud2::Ptr cloud (new sensor_msgs::PointCloud2);
+    if (pcl::io::loadPCDFile (b.getDataFile ("table_scene_mug_stereo_textured.pcd"), *cloud) < 0)
+    {
+      b.skip ("cannot read " + b.getDataFile ("table_scene_mug_stereo_textured.pcd"));
+      return;
+    }
+    pcl::VoxelGrid<sensor_msgs::PointCloud2> grid;
+    grid.setInputCloud (cloud);
+    grid.setLeafSize (0.01f, 0.01f, 0.01f);
+    sensor_msgs::PointCloud2 output;
+    while (b.keepRunning ())
+      grid.filter (output);
+    b.setItemsPerIteration (cloud->width * cloud->height);
+  }
+
+  void
+  passThrough (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    pcl::PassThrough<PointT> pass;
+    pass.setInputCloud (cloud);
+    pass.setFilterFieldName ("z");
+    pass.setFilterLimits (0.0f, 1.0f);
+    Cloud output;
+    while (b.keepRunning ())
+      pass.filter (output);
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+
+  void
+  statisticalOutlierRemoval (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    pcl::StatisticalOutlierRemoval<PointT> sor;
+    sor.setInputCloud (cloud);
+    sor.setMeanK (10);
+    sor.setStddevMulThresh (1.0);
+    Cloud output;
+    while (b.keepRunning ())
+      sor.filter (output);
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+}
+
+PCL_BENCHMARK ("filters/VoxelGrid_1cm", voxelGrid);
+PCL_BENCHMARK ("filters/VoxelGrid_1cm_PointCloud2", voxelGridPointCloud2);
+PCL_BENCHMARK ("filters/PassThrough", passThrough);
+PCL_BENCHMARK ("filters/StatisticalOutlierRemoval_k10", statisticalOutlierRemoval);
@@ -0,0 +1,174 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include "benchmark.h"
+#include <pcl/point_types.h>
+#include <pcl/io/pcd_io.h>
+#include <pcl/io/ply_io.h>
+#include <boost/filesystem.hpp>
+
+namespace
+{
+  typedef pcl::PointXYZRGBA PointT;
+  typedef pcl::PointCloud<PointT> Cloud;
+
+  enum Format
+  {
+    PCD_ASCII,
+    PCD_BINARY,
+    PCD_BINARY_COMPRESSED,
+    PLY_ASCII,
+    PLY_BINARY
+  };
+
+  /** \brief A file of the temporary directory, removed with the object. */
+  class TemporaryFile
+  {
+    public:
+      TemporaryFile (const std::string &extension)
+        : path_ ((boost::filesystem::temp_directory_path () / boost::filesystem::unique_path ("pcl_benchmark_%%%%%%%%" + extension)).string ())
+      {
+      }
+
+      ~TemporaryFile ()
+      {
+        boost::system::error_code error;
+        boost::filesystem::remove (path_, error);
+      }
+
+      const std::string&
+      getPath () const
+      {
+        return (path_);
+      }
+
+    private:
+      std::string path_;
+  };
+
+  int
+  save (const std::string &file_name, const Cloud &cloud, Format format)
+  {
+    pcl::PCDWriter writer;
+    switch (format)
+    {
+      case PCD_ASCII:
+        return (writer.writeASCII (file_name, cloud));
+      case PCD_BINARY:
+        return (writer.writeBinary (file_name, cloud));
+      case PCD_BINARY_COMPRESSED:
+        return (writer.writeBinaryCompressed (file_name, cloud));
+      case PLY_ASCII:
+        return (pcl::io::savePLYFileASCII (file_name, cloud));
+      case PLY_BINARY:
+        return (pcl::io::savePLYFileBinary (file_name, cloud));
+    }
+    return (-1);
+  }
+
+  int
+  load (const std::string &file_name, Cloud &cloud, Format format)
+  {
+    if (format == PLY_ASCII || format == PLY_BINARY)
+      return (pcl::io::loadPLYFile (file_name, cloud));
+    return (pcl::io::loadPCDFile (file_name, cloud));
+  }
+
+  std::string
+  getExtension (Format format)
+  {
+    return (format == PLY_ASCII || format == PLY_BINARY ? ".ply" : ".pcd");
+  }
+
+  template <Format format> void
+  write (benchmark::Benchmark &b)
+  {
+    // without the NaN points, which the ASCII PLY reader does not parse
+    Cloud cloud;
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", cloud))
+      return;
+    TemporaryFile file (getExtension (format));
+    while (b.keepRunning ())
+    {
+      if (save (file.getPath (), cloud, format) < 0)
+      {
+        b.skip ("cannot write " + file.getPath ());
+        return;
+      }
+    }
+    b.setItemsPerIteration (cloud.points.size ());
+    b.setBytesPerIteration (static_cast<size_t> (boost::filesystem::file_size (file.getPath ())));
+  }
+
+  template <Format format> void
+  read (benchmark::Benchmark &b)
+  {
+    Cloud cloud;
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", cloud))
+      return;
+    TemporaryFile file (getExtension (format));
+    if (save (file.getPath (), cloud, format) < 0)
+    {
+      b.skip ("cannot write " + file.getPath ());
+      return;
+    }
+    Cloud loaded;
+    while (b.keepRunning ())
+    {
+      if (load (file.getPath (), loaded, format) < 0)
+      {
+        b.skip ("cannot read " + file.getPath ());
+        return;
+      }
+    }
+    b.setItemsPerIteration (cloud.points.size ());
+    b.setBytesPerIteration (static_cast<size_t> (boost::filesystem::file_size (file.getPath ())));
+  }
+}
+
+PCL_BENCHMARK ("io/PCD/write_ascii", write<PCD_ASCII>);
+PCL_BENCHMARK ("io/PCD/write_binary", write<PCD_BINARY>);
+PCL_BENCHMARK ("io/PCD/write_binary_compressed", write<PCD_BINARY_COMPRESSED>);
+PCL_BENCHMARK ("io/PCD/read_ascii", read<PCD_ASCII>);
+PCL_BENCHMARK ("io/PCD/read_binary", read<PCD_BINARY>);
+PCL_BENCHMARK ("io/PCD/read_binary_compressed", read<PCD_BINARY_COMPRESSED>);
+PCL_BENCHMARK ("io/PLY/write_ascii", write<PLY_ASCII>);
+PCL_BENCHMARK ("io/PLY/write_binary", write<PLY_BINARY>);
+PCL_BENCHMARK ("io/PLY/read_ascii", read<PLY_ASCII>);
+PCL_BENCHMARK ("io/PLY/read_binary", read<PLY_BINARY>);
@@ -0,0 +1,150 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include "benchmark.h"
+#include <pcl/point_types.h>
+#include <pcl/filters/passthrough.h>
+#include <pcl/filters/voxel_grid.h>
+#include <pcl/filters/extract_indices.h>
+#include <pcl/features/normal_3d_omp.h>
+#include <pcl/segmentation/sac_segmentation.h>
+#include <pcl/segmentation/extract_clusters.h>
+#include <pcl/registration/icp.h>
+#include <pcl/search/kdtree.h>
+
+namespace
+{
+  /** \brief Tabletop object detection, from the raw frame to the object clusters:
+    * cropping, downsampling, normals, plane fitting with normals, and clustering of the rest.
+    */
+  void
+  tabletopSegmentation (benchmark::Benchmark &b)
+  {
+    typedef pcl::PointXYZRGBA PointT;
+    typedef pcl::PointCloud<PointT> Cloud;
+    Cloud::Ptr cloud (new Cloud);
+    if (pcl::io::loadPCDFile (b.getDataFile ("table_scene_mug_stereo_textured.pcd"), *cloud) < 0)
+    {
+      b.skip ("cannot read " + b.getDataFile ("table_scene_mug_stereo_textured.pcd"));
+      return;
+    }
+
+    pcl::PassThrough<PointT> pass;
+    pass.setFilterFieldName ("z");
+    pass.setFilterLimits (0.0f, 1.5f);
+    pcl::VoxelGrid<PointT> grid;
+    grid.setLeafSize (0.005f, 0.005f, 0.005f);
+    pcl::search::KdTree<PointT>::Ptr tree (new pcl::search::KdTree<PointT>);
+    pcl::NormalEstimationOMP<PointT, pcl::Normal> ne (b.getNumberOfThreads ());
+    ne.setSearchMethod (tree);
+    ne.setKSearch (20);
+    pcl::SACSegmentationFromNormals<PointT, pcl::Normal> seg;
+    seg.setModelType (pcl::SACMODEL_NORMAL_PLANE);
+    seg.setMethodType (pcl::SAC_RANSAC);
+    seg.setNormalDistanceWeight (0.1);
+    seg.setMaxIterations (100);
+    seg.setDistanceThreshold (0.01);
+    pcl::ExtractIndices<PointT> extract;
+    extract.setNegative (true);
+    pcl::EuclideanClusterExtraction<PointT> ec;
+    ec.setClusterTolerance (0.02);
+    ec.setMinClusterSize (50);
+    ec.setMaxClusterSize (100000);
+    ec.setSearchMethod (pcl::search::KdTree<PointT>::Ptr (new pcl::search::KdTree<PointT>));
+
+    Cloud::Ptr cropped (new Cloud), downsampled (new Cloud), objects (new Cloud);
+    pcl::PointCloud<pcl::Normal>::Ptr normals (new pcl::PointCloud<pcl::Normal>);
+    pcl::PointIndices::Ptr plane (new pcl::PointIndices);
+    pcl::ModelCoefficients coefficients;
+    std::vector<pcl::PointIndices> clusters;
+    while (b.keepRunning ())
+    {
+      pass.setInputCloud (cloud);
+      pass.filter (*cropped);
+      grid.setInputCloud (cropped);
+      grid.filter (*downsampled);
+      ne.setInputCloud (downsampled);
+      ne.compute (*normals);
+      seg.setInputCloud (downsampled);
+      seg.setInputNormals (normals);
+      seg.segment (*plane, coefficients);
+      extract.setInputCloud (downsampled);
+      extract.setIndices (plane);
+      extract.filter (*objects);
+      ec.setInputCloud (objects);
+      ec.extract (clusters);
+    }
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+
+  /** \brief Scan matching: downsampling of both scans and ICP. */
+  void
+  scanMatching (benchmark::Benchmark &b)
+  {
+    typedef pcl::PointXYZ PointT;
+    typedef pcl::PointCloud<PointT> Cloud;
+    Cloud::Ptr source (new Cloud), target (new Cloud);
+    if (!b.loadCloud ("bun0.pcd", *source) || !b.loadCloud ("bun4.pcd", *target))
+      return;
+
+    pcl::VoxelGrid<PointT> grid;
+    grid.setLeafSize (0.005f, 0.005f, 0.005f);
+    pcl::IterativeClosestPoint<PointT, PointT> icp;
+    icp.setMaximumIterations (50);
+    icp.setTransformationEpsilon (1e-8);
+    icp.setMaxCorrespondenceDistance (0.05);
+
+    Cloud::Ptr source_downsampled (new Cloud), target_downsampled (new Cloud);
+    Cloud output;
+    while (b.keepRunning ())
+    {
+      grid.setInputCloud (source);
+      grid.filter (*source_downsampled);
+      grid.setInputCloud (target);
+      grid.filter (*target_downsampled);
+      icp.setInputCloud (source_downsampled);
+      icp.setInputTarget (target_downsampled);
+      icp.align (output);
+    }
+    b.setItemsPerIteration (source->points.size ());
+  }
+}
+
+PCL_BENCHMARK ("pipeline/tabletop_segmentation", tabletopSegmentation);
+PCL_BENCHMARK ("pipeline/scan_matching", scanMatching);
@@ -0,0 +1,103 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include "benchmark.h"
+#include <pcl/point_types.h>
+#include <pcl/registration/icp.h>
+#include <pcl/registration/ndt.h>
+#include <pcl/registration/gicp.h>
+
+namespace
+{
+  typedef pcl::PointXYZ PointT;
+  typedef pcl::PointCloud<PointT> Cloud;
+
+  /** \brief Load the two bunny scans registered by the benchmarks. */
+  bool
+  loadBunnies (benchmark::Benchmark &b, Cloud &source, Cloud &target)
+  {
+    return (b.loadCloud ("bun0.pcd", source) && b.loadCloud ("bun4.pcd", target));
+  }
+
+  /** \brief Align bun0 on bun4 with \a reg, with the parameters of the registration tests. */
+  template <typename Registration> void
+  align (benchmark::Benchmark &b, Registration &reg)
+  {
+    Cloud::Ptr source (new Cloud), target (new Cloud);
+    if (!loadBunnies (b, *source, *target))
+      return;
+    reg.setInputCloud (source);
+    reg.setInputTarget (target);
+    reg.setMaximumIterations (50);
+    reg.setTransformationEpsilon (1e-8);
+    Cloud output;
+    while (b.keepRunning ())
+      reg.align (output);
+    b.setItemsPerIteration (source->points.size ());
+  }
+
+  void
+  icp (benchmark::Benchmark &b)
+  {
+    pcl::IterativeClosestPoint<PointT, PointT> reg;
+    reg.setMaxCorrespondenceDistance (0.05);
+    align (b, reg);
+  }
+
+  void
+  ndt (benchmark::Benchmark &b)
+  {
+    pcl::NormalDistributionsTransform<PointT, PointT> reg;
+    reg.setStepSize (0.05);
+    reg.setResolution (0.025f);
+    align (b, reg);
+  }
+
+  void
+  gicp (benchmark::Benchmark &b)
+  {
+    pcl::GeneralizedIterativeClosestPoint<PointT, PointT> reg;
+    reg.setMaxCorrespondenceDistance (0.05);
+    align (b, reg);
+  }
+}
+
+PCL_BENCHMARK ("registration/IterativeClosestPoint_bun0_bun4", icp);
+PCL_BENCHMARK ("registration/NormalDistributionsTransform_bun0_bun4", ndt);
+PCL_BENCHMARK ("registration/GeneralizedIterativeClosestPoint_bun0_bun4", gicp);
@@ -0,0 +1,172 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include "benchmark.h"
+#include <pcl/point_types.h>
+#include <pcl/kdtree/kdtree_flann.h>
+#include <pcl/octree/octree.h>
+
+namespace
+{
+  typedef pcl::PointXYZ PointT;
+  typedef pcl::PointCloud<PointT> Cloud;
+
+  /** \brief The number of queries of the search benchmarks. */
+  const size_t nr_queries = 10000;
+
+  /** \brief Take every n-th point of \a cloud as a query point. */
+  void
+  getQueries (const Cloud &cloud, std::vector<PointT, Eigen::aligned_allocator<PointT> > &queries)
+  {
+    const size_t step = std::max<size_t> (cloud.points.size () / nr_queries, 1);
+    queries.clear ();
+    for (size_t i = 0; i < cloud.points.size () && queries.size () < nr_queries; i += step)
+      queries.push_back (cloud.points[i]);
+  }
+
+  void
+  kdtreeBuild (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    while (b.keepRunning ())
+    {
+      pcl::KdTreeFLANN<PointT> tree;
+      tree.setInputCloud (cloud);
+    }
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+
+  void
+  kdtreeNearestK (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    pcl::KdTreeFLANN<PointT> tree;
+    tree.setInputCloud (cloud);
+    std::vector<PointT, Eigen::aligned_allocator<PointT> > queries;
+    getQueries (*cloud, queries);
+    std::vector<int> indices;
+    std::vector<float> distances;
+    while (b.keepRunning ())
+      for (size_t i = 0; i < queries.size (); ++i)
+        tree.nearestKSearch (queries[i], 10, indices, distances);
+    b.setItemsPerIteration (queries.size ());
+  }
+
+  void
+  kdtreeRadius (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    pcl::KdTreeFLANN<PointT> tree;
+    tree.setInputCloud (cloud);
+    std::vector<PointT, Eigen::aligned_allocator<PointT> > queries;
+    getQueries (*cloud, queries);
+    std::vector<int> indices;
+    std::vector<float> distances;
+    while (b.keepRunning ())
+      for (size_t i = 0; i < queries.size (); ++i)
+        tree.radiusSearch (queries[i], 0.01, indices, distances);
+    b.setItemsPerIteration (queries.size ());
+  }
+
+  void
+  octreeBuild (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    while (b.keepRunning ())
+    {
+      pcl::octree::OctreePointCloudSearch<PointT> octree (0.01);
+      octree.setInputCloud (cloud);
+      octree.addPointsFromInputCloud ();
+    }
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+
+  void
+  octreeNearestK (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    pcl::octree::OctreePointCloudSearch<PointT> octree (0.01);
+    octree.setInputCloud (cloud);
+    octree.addPointsFromInputCloud ();
+    std::vector<PointT, Eigen::aligned_allocator<PointT> > queries;
+    getQueries (*cloud, queries);
+    std::vector<int> indices;
+    std::vector<float> distances;
+    while (b.keepRunning ())
+      for (size_t i = 0; i < queries.size (); ++i)
+        octree.nearestKSearch (queries[i], 10, indices, distances);
+    b.setItemsPerIteration (queries.size ());
+  }
+
+  void
+  octreeRadius (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *cloud))
+      return;
+    pcl::octree::OctreePointCloudSearch<PointT> octree (0.01);
+    octree.setInputCloud (cloud);
+    octree.addPointsFromInputCloud ();
+    std::vector<PointT, Eigen::aligned_allocator<PointT> > queries;
+    getQueries (*cloud, queries);
+    std::vector<int> indices;
+    std::vector<float> distances;
+    while (b.keepRunning ())
+      for (size_t i = 0; i < queries.size (); ++i)
+        octree.radiusSearch (queries[i], 0.01, indices, distances);
+    b.setItemsPerIteration (queries.size ());
+  }
+}
+
+PCL_BENCHMARK ("search/KdTreeFLANN/build", kdtreeBuild);
+PCL_BENCHMARK ("search/KdTreeFLANN/nearestKSearch_k10", kdtreeNearestK);
+PCL_BENCHMARK ("search/KdTreeFLANN/radiusSearch_1cm", kdtreeRadius);
+PCL_BENCHMARK ("search/OctreePointCloudSearch/build", octreeBuild);
+PCL_BENCHMARK ("search/OctreePointCloudSearch/nearestKSearch_k10", octreeNearestK);
+PCL_BENCHMARK ("search/OctreePointCloudSearch/radiusSearch_1cm", octreeRadius);
@@ -0,0 +1,124 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include "benchmark.h"
+#include <pcl/point_types.h>
+#include <pcl/filters/voxel_grid.h>
+#include <pcl/filters/extract_indices.h>
+#include <pcl/segmentation/sac_segmentation.h>
+#include <pcl/segmentation/extract_clusters.h>
+#include <pcl/search/kdtree.h>
+
+namespace
+{
+  typedef pcl::PointXYZ PointT;
+  typedef pcl::PointCloud<PointT> Cloud;
+
+  /** \brief Load the table scene, downsampled to 5 mm. */
+  bool
+  loadScene (benchmark::Benchmark &b, Cloud::Ptr &cloud)
+  {
+    Cloud::Ptr input (new Cloud);
+    if (!b.loadCloud ("table_scene_mug_stereo_textured.pcd", *input))
+      return (false);
+    pcl::VoxelGrid<PointT> grid;
+    grid.setInputCloud (input);
+    grid.setLeafSize (0.005f, 0.005f, 0.005f);
+    cloud.reset (new Cloud);
+    grid.filter (*cloud);
+    return (true);
+  }
+
+  void
+  sacPlane (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud;
+    if (!loadScene (b, cloud))
+      return;
+    pcl::SACSegmentation<PointT> seg;
+    seg.setInputCloud (cloud);
+    seg.setModelType (pcl::SACMODEL_PLANE);
+    seg.setMethodType (pcl::SAC_RANSAC);
+    seg.setDistanceThreshold (0.01);
+    seg.setOptimizeCoefficients (true);
+    pcl::PointIndices inliers;
+    pcl::ModelCoefficients coefficients;
+    while (b.keepRunning ())
+      seg.segment (inliers, coefficients);
+    b.setItemsPerIteration (cloud->points.size ());
+  }
+
+  void
+  euclideanClusters (benchmark::Benchmark &b)
+  {
+    Cloud::Ptr cloud;
+    if (!loadScene (b, cloud))
+      return;
+
+    // cluster the objects above the table
+    pcl::SACSegmentation<PointT> seg;
+    seg.setInputCloud (cloud);
+    seg.setModelType (pcl::SACMODEL_PLANE);
+    seg.setMethodType (pcl::SAC_RANSAC);
+    seg.setDistanceThreshold (0.01);
+    pcl::PointIndices::Ptr inliers (new pcl::PointIndices);
+    pcl::ModelCoefficients coefficients;
+    seg.segment (*inliers, coefficients);
+    pcl::ExtractIndices<PointT> extract;
+    extract.setInputCloud (cloud);
+    extract.setIndices (inliers);
+    extract.setNegative (true);
+    Cloud::Ptr objects (new Cloud);
+    extract.filter (*objects);
+
+    pcl::EuclideanClusterExtraction<PointT> ec;
+    ec.setInputCloud (objects);
+    ec.setSearchMethod (pcl::search::KdTree<PointT>::Ptr (new pcl::search::KdTree<PointT>));
+    ec.setClusterTolerance (0.02);
+    ec.setMinClusterSize (50);
+    ec.setMaxClusterSize (100000);
+    std::vector<pcl::PointIndices> clusters;
+    while (b.keepRunning ())
+      ec.extract (clusters);
+    b.setItemsPerIteration (objects->points.size ());
+  }
+}
+
+PCL_BENCHMARK ("segmentation/SACSegmentation_plane", sacPlane);
+PCL_BENCHMARK ("segmentation/EuclideanClusterExtraction_2cm", euclideanClusters);
@@ -22,3 +22,7 @@ mark_as_advanced(PCL_SHARED_LIBS)
 option(PCL_ONLY_CORE_POINT_TYPES "Compile explicitly only for a small subset of point types (e.g., pcl::PointXYZ instead of PCL_XYZ_POINT_TYPES)." OFF)
 mark_as_advanced(PCL_ONLY_CORE_POINT_TYPES)
 
+
+# Compile out the scopes and counters of pcl::Profiler.
+option(PCL_NO_PROFILING "Compile out the profiling scopes and counters (see pcl/common/profiler.h)." OFF)
+mark_as_advanced(PCL_NO_PROFILING)
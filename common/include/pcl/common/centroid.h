@@ -40,6 +40,7 @@
 #define PCL_COMMON_CENTROID_H_
 
 #include <pcl/point_cloud.h>
+#include <pcl/point_cloud_soa.h>
 #include <pcl/point_traits.h>
 #include <pcl/PointIndices.h>
 #include <pcl/cloud_iterator.h>
@@ -75,6 +76,16 @@ namespace pcl
   compute3DCentroid (const pcl::PointCloud<PointT> &cloud, 
                      Eigen::Matrix<Scalar, 4, 1> &centroid);
 
+  /** \brief Compute the 3D (X-Y-Z) centroid of a structure of arrays (SSE version).
+    * \param[in] cloud the input point cloud
+    * \param[out] centroid the output centroid
+    * \return number of valid point used to determine the centroid. In case of dense point clouds, this is the same as the size of input cloud.
+    * \note if return value is 0, the centroid is not changed, thus not valid.
+    * \ingroup common
+    */
+  PCL_EXPORTS unsigned int
+  compute3DCentroid (const pcl::PointCloudSoA &cloud, Eigen::Vector4f &centroid);
+
   /** \brief Compute the 3D (X-Y-Z) centroid of a set of points using their indices and
     * return it as a 3D vector.
     * \param[in] cloud the input point cloud
@@ -222,7 +233,7 @@ namespace pcl
     * Normalized means that every entry has been divided by the number of entries in indices.
     * For small number of points, or if you want explicitely the sample-variance, scale the covariance matrix
     * with n / (n-1), where n is the number of points used to calculate the covariance matrix and is returned by this function.
-    * \note This method is theoretically exact. However using float for internal calculations reduces the accuracy but increases the efficiency.
+    * \note The points are accumulated with a MeanAndCovarianceAccumulator, which stays accurate for points far from the origin.
     * \param[in] cloud the input point cloud
     * \param[out] covariance_matrix the resultant 3x3 covariance matrix
     * \param[out] centroid the centroid of the set of points in the cloud
@@ -239,7 +250,7 @@ namespace pcl
     * Normalized means that every entry has been divided by the number of entries in indices.
     * For small number of points, or if you want explicitely the sample-variance, scale the covariance matrix
     * with n / (n-1), where n is the number of points used to calculate the covariance matrix and is returned by this function.
-    * \note This method is theoretically exact. However using float for internal calculations reduces the accuracy but increases the efficiency.
+    * \note The points are accumulated with a MeanAndCovarianceAccumulator, which stays accurate for points far from the origin.
     * \param[in] cloud the input point cloud
     * \param[in] indices subset of points given by their indices
     * \param[out] covariance_matrix the resultant 3x3 covariance matrix
@@ -258,7 +269,7 @@ namespace pcl
     * Normalized means that every entry has been divided by the number of entries in indices.
     * For small number of points, or if you want explicitely the sample-variance, scale the covariance matrix
     * with n / (n-1), where n is the number of points used to calculate the covariance matrix and is returned by this function.
-    * \note This method is theoretically exact. However using float for internal calculations reduces the accuracy but increases the efficiency.
+    * \note The points are accumulated with a MeanAndCovarianceAccumulator, which stays accurate for points far from the origin.
     * \param[in] cloud the input point cloud
     * \param[in] indices subset of points given by their indices
     * \param[out] centroid the centroid of the set of points in the cloud
@@ -273,6 +284,153 @@ namespace pcl
                                   Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
                                   Eigen::Matrix<Scalar, 4, 1> &centroid);
 
+  /** \brief Single pass accumulator of the centroid and of the covariance matrix of a set of points.
+    *
+    * The points are accumulated by blocks: the sums of a block are computed in single precision
+    * and vectorized by Eigen, relative to the first point of the block. This avoids the cancellation
+    * of the E[x x^T] - E[x] E[x]^T formula for points far from the origin. The blocks are then merged
+    * in double precision with the pairwise update of Chan et al.
+    *
+    * Accumulators can be merged, e.g. to combine the results of several threads or tiles. Large
+    * clouds are split into chunks of fixed size, which are accumulated in parallel and merged by a
+    * tree reduction, so that the result does not depend on the number of threads.
+    * \code
+    * pcl::MeanAndCovarianceAccumulator accumulator;
+    * accumulator.add (cloud, indices);
+    * Eigen::Vector4f centroid;
+    * Eigen::Matrix3f covariance_matrix;
+    * accumulator.getCentroid (centroid);
+    * accumulator.getCovarianceMatrix (covariance_matrix);
+    * \endcode
+    * \ingroup common
+    */
+  class MeanAndCovarianceAccumulator
+  {
+    public:
+      /** \brief Empty constructor. */
+      MeanAndCovarianceAccumulator () : nr_points_ (0), mean_ (Eigen::Vector3d::Zero ()), scatter_ (Eigen::Matrix3d::Zero ()) {}
+
+      /** \brief Remove all the points. */
+      inline void
+      clear ()
+      {
+        nr_points_ = 0;
+        mean_.setZero ();
+        scatter_.setZero ();
+      }
+
+      /** \brief Add a single point, which must be finite.
+        * \param[in] point the point to add
+        */
+      template <typename PointT> inline void
+      add (const PointT &point)
+      {
+        merge (1, Eigen::Vector3d (point.x, point.y, point.z), Eigen::Matrix3d::Zero ());
+      }
+
+      /** \brief Add the finite points of a point cloud.
+        * \param[in] cloud the input point cloud
+        * \param[in] nr_threads the number of threads to use (1 by default, 0 for automatic)
+        */
+      template <typename PointT> inline void
+      add (const pcl::PointCloud<PointT> &cloud, unsigned int nr_threads = 1)
+      {
+        addPoints (cloud, NULL, nr_threads);
+      }
+
+      /** \brief Add the finite points of a subset of a point cloud.
+        * \param[in] cloud the input point cloud
+        * \param[in] indices subset of points given by their indices
+        * \param[in] nr_threads the number of threads to use (1 by default, 0 for automatic)
+        */
+      template <typename PointT> inline void
+      add (const pcl::PointCloud<PointT> &cloud, const std::vector<int> &indices, unsigned int nr_threads = 1)
+      {
+        addPoints (cloud, &indices, nr_threads);
+      }
+
+      /** \brief Add the finite points of a subset of a point cloud.
+        * \param[in] cloud the input point cloud
+        * \param[in] indices subset of points given by their indices
+        * \param[in] nr_threads the number of threads to use (1 by default, 0 for automatic)
+        */
+      template <typename PointT> inline void
+      add (const pcl::PointCloud<PointT> &cloud, const pcl::PointIndices &indices, unsigned int nr_threads = 1)
+      {
+        addPoints (cloud, &indices.indices, nr_threads);
+      }
+
+      /** \brief Add the points of another accumulator.
+        * \param[in] other the accumulator to merge into this one
+        */
+      inline void
+      merge (const MeanAndCovarianceAccumulator &other)
+      {
+        merge (other.nr_points_, other.mean_, other.scatter_);
+      }
+
+      /** \brief Get the number of points accumulated. */
+      inline size_t
+      getNumberOfPoints () const
+      {
+        return (nr_points_);
+      }
+
+      /** \brief Get the centroid of the points, with a 4th component set to 0.
+        * \param[out] centroid the centroid of the points (0 if there are none)
+        */
+      template <typename Scalar> inline void
+      getCentroid (Eigen::Matrix<Scalar, 4, 1> &centroid) const
+      {
+        centroid << static_cast<Scalar> (mean_[0]), static_cast<Scalar> (mean_[1]), static_cast<Scalar> (mean_[2]), 0;
+      }
+
+      /** \brief Get the covariance matrix of the points, normalized by their number as in
+        * computeMeanAndCovarianceMatrix. Scale it by n / (n - 1) to get the sample covariance.
+        * \param[out] covariance_matrix the covariance matrix of the points (0 if there are none)
+        */
+      template <typename Scalar> inline void
+      getCovarianceMatrix (Eigen::Matrix<Scalar, 3, 3> &covariance_matrix) const
+      {
+        if (nr_points_ == 0)
+          covariance_matrix.setZero ();
+        else
+          covariance_matrix = (scatter_ / static_cast<double> (nr_points_)).cast<Scalar> ();
+      }
+
+    protected:
+      /** \brief Add the finite points of a cloud (or of a subset of it), in parallel chunks. */
+      template <typename PointT> void
+      addPoints (const pcl::PointCloud<PointT> &cloud, const std::vector<int> *indices, unsigned int nr_threads);
+
+      /** \brief Add the finite points in [begin, end[ of a cloud (or of a subset of it), by blocks. */
+      template <typename PointT> void
+      addRange (const pcl::PointCloud<PointT> &cloud, const std::vector<int> *indices, size_t begin, size_t end);
+
+      /** \brief Merge the statistics of a set of points.
+        * \param[in] nr_points the number of points of the set
+        * \param[in] mean the centroid of the set
+        * \param[in] scatter the sum of the outer products of the deviations of the points from \a mean
+        */
+      void
+      merge (size_t nr_points, const Eigen::Vector3d &mean, const Eigen::Matrix3d &scatter);
+
+      /** \brief The number of points accumulated. */
+      size_t nr_points_;
+
+      /** \brief The centroid of the points. */
+      Eigen::Vector3d mean_;
+
+      /** \brief The sum of the outer products of the deviations of the points from their centroid. */
+      Eigen::Matrix3d scatter_;
+
+      /** \brief The number of points whose sums are computed in single precision. */
+      static const size_t block_size_ = 256;
+
+      /** \brief The number of points accumulated by a parallel task. */
+      static const size_t chunk_size_ = 65536;
+  };
+
 
   /** \brief Compute the normalized 3x3 covariance matrix for a already demeaned point cloud.
     * Normalized means that every entry has been divided by the number of entries in indices.
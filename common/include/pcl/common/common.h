@@ -39,6 +39,7 @@
 #define PCL_COMMON_H_
 
 #include <pcl/pcl_base.h>
+#include <pcl/point_cloud_soa.h>
 #include <cfloat>
 
 /**
@@ -72,73 +73,88 @@ namespace pcl
     * \param cloud the point cloud data message
     * \param min_pt the minimum bounds
     * \param max_pt the maximum bounds
-    * \param indices the resultant set of point indices residing in the box
+    * \param indices the resultant set of point indices residing in the box, sorted
+    * \param nr_threads the number of threads to use (0 for automatic, 1 by default)
+    * \note The bounds are inclusive. Non finite points are never in the box.
     * \ingroup common
     */
   template <typename PointT> inline void 
   getPointsInBox (const pcl::PointCloud<PointT> &cloud, Eigen::Vector4f &min_pt,
-                  Eigen::Vector4f &max_pt, std::vector<int> &indices);
+                  Eigen::Vector4f &max_pt, std::vector<int> &indices, unsigned int nr_threads = 1);
 
   /** \brief Get the point at maximum distance from a given point and a given pointcloud
     * \param cloud the point cloud data message
     * \param pivot_pt the point from where to compute the distance
-    * \param max_pt the point in cloud that is the farthest point away from pivot_pt
+    * \param max_pt the point in cloud that is the farthest point away from pivot_pt (NaN if there are no finite points)
+    * \param nr_threads the number of threads to use (0 for automatic, 1 by default)
+    * \note The distance is 3D. If several points are the farthest, the first one is returned.
     * \ingroup common
     */
   template<typename PointT> inline void
-  getMaxDistance (const pcl::PointCloud<PointT> &cloud, const Eigen::Vector4f &pivot_pt, Eigen::Vector4f &max_pt);
+  getMaxDistance (const pcl::PointCloud<PointT> &cloud, const Eigen::Vector4f &pivot_pt, Eigen::Vector4f &max_pt,
+                  unsigned int nr_threads = 1);
 
   /** \brief Get the point at maximum distance from a given point and a given pointcloud
     * \param cloud the point cloud data message
     * \param pivot_pt the point from where to compute the distance
     * \param indices the vector of point indices to use from \a cloud
-    * \param max_pt the point in cloud that is the farthest point away from pivot_pt
+    * \param max_pt the point in cloud that is the farthest point away from pivot_pt (NaN if there are no finite points)
+    * \param nr_threads the number of threads to use (0 for automatic, 1 by default)
+    * \note The distance is 3D. If several points are the farthest, the first one in \a indices is returned.
     * \ingroup common
     */
   template<typename PointT> inline void
   getMaxDistance (const pcl::PointCloud<PointT> &cloud, const std::vector<int> &indices, 
-                  const Eigen::Vector4f &pivot_pt, Eigen::Vector4f &max_pt);
+                  const Eigen::Vector4f &pivot_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads = 1);
 
   /** \brief Get the minimum and maximum values on each of the 3 (x-y-z) dimensions in a given pointcloud
     * \param cloud the point cloud data message
     * \param min_pt the resultant minimum bounds
     * \param max_pt the resultant maximum bounds
+    * \param nr_threads the number of threads to use (0 for automatic, 1 by default)
+    * \note Non finite points are skipped, unless the cloud is dense.
     * \ingroup common
     */
   template <typename PointT> inline void 
-  getMinMax3D (const pcl::PointCloud<PointT> &cloud, PointT &min_pt, PointT &max_pt);
+  getMinMax3D (const pcl::PointCloud<PointT> &cloud, PointT &min_pt, PointT &max_pt, unsigned int nr_threads = 1);
   
   /** \brief Get the minimum and maximum values on each of the 3 (x-y-z) dimensions in a given pointcloud
     * \param cloud the point cloud data message
     * \param min_pt the resultant minimum bounds
     * \param max_pt the resultant maximum bounds
+    * \param nr_threads the number of threads to use (0 for automatic, 1 by default)
+    * \note Non finite points are skipped, unless the cloud is dense.
     * \ingroup common
     */
   template <typename PointT> inline void 
   getMinMax3D (const pcl::PointCloud<PointT> &cloud, 
-               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt);
+               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads = 1);
 
   /** \brief Get the minimum and maximum values on each of the 3 (x-y-z) dimensions in a given pointcloud
     * \param cloud the point cloud data message
     * \param indices the vector of point indices to use from \a cloud
     * \param min_pt the resultant minimum bounds
     * \param max_pt the resultant maximum bounds
+    * \param nr_threads the number of threads to use (0 for automatic, 1 by default)
+    * \note Non finite points are skipped, unless the cloud is dense.
     * \ingroup common
     */
   template <typename PointT> inline void 
   getMinMax3D (const pcl::PointCloud<PointT> &cloud, const std::vector<int> &indices, 
-               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt);
+               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads = 1);
 
   /** \brief Get the minimum and maximum values on each of the 3 (x-y-z) dimensions in a given pointcloud
     * \param cloud the point cloud data message
     * \param indices the vector of point indices to use from \a cloud
     * \param min_pt the resultant minimum bounds
     * \param max_pt the resultant maximum bounds
+    * \param nr_threads the number of threads to use (0 for automatic, 1 by default)
+    * \note Non finite points are skipped, unless the cloud is dense.
     * \ingroup common
     */
   template <typename PointT> inline void 
   getMinMax3D (const pcl::PointCloud<PointT> &cloud, const pcl::PointIndices &indices, 
-               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt);
+               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads = 1);
 
   /** \brief Compute the radius of a circumscribed circle for a triangle formed of three points pa, pb, and pc
     * \param pa the first point
@@ -181,6 +197,16 @@ namespace pcl
   PCL_EXPORTS void
   getMeanStdDev (const std::vector<float> &values, double &mean, double &stddev);
 
+  /** \brief Get the minimum and maximum values on each of the 3 (x-y-z) dimensions
+    * in a given structure of arrays (SSE version)
+    * \param[in] cloud the point cloud data
+    * \param[out] min_pt the resultant minimum bounds
+    * \param[out] max_pt the resultant maximum bounds
+    * \ingroup common
+    */
+  PCL_EXPORTS void
+  getMinMax3D (const pcl::PointCloudSoA &cloud, Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt);
+
 }
 /*@}*/
 #include <pcl/common/impl/common.hpp>
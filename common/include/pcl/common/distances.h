@@ -59,6 +59,28 @@ namespace pcl
   lineToLineSegment (const Eigen::VectorXf &line_a, const Eigen::VectorXf &line_b, 
                      Eigen::Vector4f &pt1_seg, Eigen::Vector4f &pt2_seg);
 
+  /** \brief Get the distances from all the points of a structure of arrays to
+    * a plane (SSE version), as computed by SampleConsensusModelPlane.
+    * \param[in] cloud the point cloud data
+    * \param[in] plane_coefficients the plane coefficients (a, b, c, d), with a unit normal (a, b, c)
+    * \param[out] distances the resultant absolute distances, NaN for the non finite points
+    * \ingroup common
+    */
+  PCL_EXPORTS void
+  getPlaneDistances (const pcl::PointCloudSoA &cloud, const Eigen::Vector4f &plane_coefficients,
+                     std::vector<float> &distances);
+
+  /** \brief Get the squared distances from all the points of a structure of
+    * arrays to a given point (SSE version).
+    * \param[in] cloud the point cloud data
+    * \param[in] pivot_pt the point from where to compute the distances
+    * \param[out] distances the resultant squared distances, NaN for the non finite points
+    * \ingroup common
+    */
+  PCL_EXPORTS void
+  getSquaredDistances (const pcl::PointCloudSoA &cloud, const Eigen::Vector3f &pivot_pt,
+                       std::vector<float> &distances);
+
   /** \brief Get the square distance from a point to a line (represented by a point and a direction)
     * \param pt a point
     * \param line_pt a point on the line (make sure that line_pt[3] = 0 as there are no internal checks!)
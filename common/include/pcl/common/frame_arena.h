@@ -0,0 +1,226 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_COMMON_FRAME_ARENA_H_
+#define PCL_COMMON_FRAME_ARENA_H_
+
+#include <pcl/pcl_macros.h>
+#include <pcl/point_cloud.h>
+#include <pcl/PointIndices.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+
+#include <map>
+#include <typeinfo>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief Pool of the temporary objects of a processing pipeline (point clouds, indices, search
+    * results), reused from one frame to the next so that their buffers are not reallocated.
+    *
+    * An object given by the arena is in use as long as a shared pointer to it exists. Once all of them
+    * are released, the object is given again by the next request for the same type, emptied but with
+    * its capacity. After the first frames, a pipeline which takes its temporaries from the arena does
+    * not allocate them anymore, as the stages only resize their outputs.
+    *
+    * \ref reset starts a new frame: the objects which were not requested during the last frame are
+    * freed, so that the memory follows the working set of the pipeline.
+    * \code
+    * pcl::FrameArena arena;
+    * while (grabbing)
+    * {
+    *   arena.reset ();
+    *   pcl::PointCloud<pcl::PointXYZ>::Ptr filtered = arena.getPointCloud<pcl::PointXYZ> ();
+    *   pass.filter (*filtered);
+    *   ...
+    * }
+    * \endcode
+    * \note The arena is thread safe. It does not change the allocator of the objects: it only keeps
+    * them, so that they can be used with all the PCL classes.
+    * \ingroup common
+    */
+  class PCL_EXPORTS FrameArena
+  {
+    public:
+      typedef boost::shared_ptr<FrameArena> Ptr;
+      typedef boost::shared_ptr<const FrameArena> ConstPtr;
+
+      /** \brief Empty constructor. */
+      FrameArena () : pools_ (), nr_allocations_ (0), nr_reuses_ (0), mutex_ () {}
+
+      /** \brief Get an empty object of any type from the arena. The type needs a default constructor,
+        * and an overload of pcl::detail::clearForReuse if the default one (assignment of a default
+        * constructed object) would free its buffers.
+        */
+      template <typename T> boost::shared_ptr<T>
+      get ();
+
+      /** \brief Get an empty point cloud from the arena. */
+      template <typename PointT> inline typename PointCloud<PointT>::Ptr
+      getPointCloud ()
+      {
+        return (get<PointCloud<PointT> > ());
+      }
+
+      /** \brief Get an empty set of point indices from the arena. */
+      inline PointIndices::Ptr
+      getPointIndices ()
+      {
+        return (get<PointIndices> ());
+      }
+
+      /** \brief Get an empty vector of indices from the arena, e.g. for the k_indices of a search. */
+      inline boost::shared_ptr<std::vector<int> >
+      getIndices ()
+      {
+        return (get<std::vector<int> > ());
+      }
+
+      /** \brief Get an empty vector of distances from the arena, e.g. for the k_distances of a search. */
+      inline boost::shared_ptr<std::vector<float> >
+      getDistances ()
+      {
+        return (get<std::vector<float> > ());
+      }
+
+      /** \brief Start a new frame: free the objects which are not used and were not requested during
+        * the last frame, and reset the statistics.
+        */
+      void
+      reset ();
+
+      /** \brief Free all the objects which are not used. */
+      void
+      clear ();
+
+      /** \brief Get the number of objects created since the last \ref reset. */
+      size_t
+      getNumberOfAllocations () const;
+
+      /** \brief Get the number of objects reused since the last \ref reset. */
+      size_t
+      getNumberOfReuses () const;
+
+      /** \brief Get the number of objects kept by the arena, used or not. */
+      size_t
+      getNumberOfObjects () const;
+
+    protected:
+      /** \brief An object of the arena. */
+      struct Slot
+      {
+        Slot () : object (), requested (false) {}
+
+        /** \brief The object, unique when it is not used. */
+        boost::shared_ptr<void> object;
+        /** \brief Set to true when the object is requested, and to false by \ref reset. */
+        bool requested;
+      };
+
+      /** \brief Order the types by std::type_info::before, as their addresses may differ between libraries. */
+      struct TypeInfoLess
+      {
+        bool
+        operator () (const std::type_info* a, const std::type_info* b) const
+        {
+          return (a->before (*b) != 0);
+        }
+      };
+
+      typedef std::map<const std::type_info*, std::vector<Slot>, TypeInfoLess> Pools;
+
+      /** \brief The objects of the arena, per type. */
+      Pools pools_;
+
+      /** \brief The number of objects created since the last reset. */
+      size_t nr_allocations_;
+
+      /** \brief The number of objects reused since the last reset. */
+      size_t nr_reuses_;
+
+      /** \brief Protects the pools and the statistics. */
+      mutable boost::mutex mutex_;
+
+    private:
+      FrameArena (const FrameArena&);
+      FrameArena& operator = (const FrameArena&);
+  };
+
+  namespace detail
+  {
+    /** \brief Empty an object of a FrameArena before it is reused. */
+    template <typename T> inline void
+    clearForReuse (T &object)
+    {
+      object = T ();
+    }
+
+    /** \brief Empty a vector, keeping its capacity. */
+    template <typename T, typename Allocator> inline void
+    clearForReuse (std::vector<T, Allocator> &vector)
+    {
+      vector.clear ();
+    }
+
+    /** \brief Empty a point cloud, keeping the capacity of its points. */
+    template <typename PointT> inline void
+    clearForReuse (PointCloud<PointT> &cloud)
+    {
+      cloud.header = std_msgs::Header ();
+      cloud.points.clear ();
+      cloud.width = cloud.height = 0;
+      cloud.is_dense = true;
+      cloud.sensor_origin_ = Eigen::Vector4f::Zero ();
+      cloud.sensor_orientation_ = Eigen::Quaternionf::Identity ();
+    }
+
+    /** \brief Empty a set of point indices, keeping its capacity. */
+    inline void
+    clearForReuse (PointIndices &indices)
+    {
+      indices.header = std_msgs::Header ();
+      indices.indices.clear ();
+    }
+  }
+}
+
+#include <pcl/common/impl/frame_arena.hpp>
+
+#endif  // PCL_COMMON_FRAME_ARENA_H_
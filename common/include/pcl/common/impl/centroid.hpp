@@ -490,63 +490,14 @@ pcl::computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
                                      Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
                                      Eigen::Matrix<Scalar, 4, 1> &centroid)
 {
-  // create the buffer on the stack which is much faster than using cloud[indices[i]] and centroid as a buffer
-  Eigen::Matrix<Scalar, 1, 9, Eigen::RowMajor> accu = Eigen::Matrix<Scalar, 1, 9, Eigen::RowMajor>::Zero ();
-  size_t point_count;
-  if (cloud.is_dense)
+  MeanAndCovarianceAccumulator accumulator;
+  accumulator.add (cloud);
+  if (accumulator.getNumberOfPoints () != 0)
   {
-    point_count = cloud.size ();
-    // For each point in the cloud
-    for (size_t i = 0; i < point_count; ++i)
-    {
-      accu [0] += cloud[i].x * cloud[i].x;
-      accu [1] += cloud[i].x * cloud[i].y;
-      accu [2] += cloud[i].x * cloud[i].z;
-      accu [3] += cloud[i].y * cloud[i].y; // 4
-      accu [4] += cloud[i].y * cloud[i].z; // 5
-      accu [5] += cloud[i].z * cloud[i].z; // 8
-      accu [6] += cloud[i].x;
-      accu [7] += cloud[i].y;
-      accu [8] += cloud[i].z;
-    }
+    accumulator.getCentroid (centroid);
+    accumulator.getCovarianceMatrix (covariance_matrix);
   }
-  else
-  {
-    point_count = 0;
-    for (size_t i = 0; i < cloud.size (); ++i)
-    {
-      if (!isFinite (cloud[i]))
-        continue;
-
-      accu [0] += cloud[i].x * cloud[i].x;
-      accu [1] += cloud[i].x * cloud[i].y;
-      accu [2] += cloud[i].x * cloud[i].z;
-      accu [3] += cloud[i].y * cloud[i].y;
-      accu [4] += cloud[i].y * cloud[i].z;
-      accu [5] += cloud[i].z * cloud[i].z;
-      accu [6] += cloud[i].x;
-      accu [7] += cloud[i].y;
-      accu [8] += cloud[i].z;
-      ++point_count;
-    }
-  }
-  accu /= static_cast<Scalar> (point_count);
-  if (point_count != 0)
-  {
-    //centroid.head<3> () = accu.tail<3> ();    -- does not compile with Clang 3.0
-    centroid[0] = accu[6]; centroid[1] = accu[7]; centroid[2] = accu[8];
-    centroid[3] = 0;
-    covariance_matrix.coeffRef (0) = accu [0] - accu [6] * accu [6];
-    covariance_matrix.coeffRef (1) = accu [1] - accu [6] * accu [7];
-    covariance_matrix.coeffRef (2) = accu [2] - accu [6] * accu [8];
-    covariance_matrix.coeffRef (4) = accu [3] - accu [7] * accu [7];
-    covariance_matrix.coeffRef (5) = accu [4] - accu [7] * accu [8];
-    covariance_matrix.coeffRef (8) = accu [5] - accu [8] * accu [8];
-    covariance_matrix.coeffRef (3) = covariance_matrix.coeff (1);
-    covariance_matrix.coeffRef (6) = covariance_matrix.coeff (2);
-    covariance_matrix.coeffRef (7) = covariance_matrix.coeff (5);
-  }
-  return (static_cast<unsigned int> (point_count));
+  return (static_cast<unsigned int> (accumulator.getNumberOfPoints ()));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -556,64 +507,14 @@ pcl::computeMeanAndCovarianceMatrix (const pcl::PointCloud<PointT> &cloud,
                                      Eigen::Matrix<Scalar, 3, 3> &covariance_matrix,
                                      Eigen::Matrix<Scalar, 4, 1> &centroid)
 {
-  // create the buffer on the stack which is much faster than using cloud[indices[i]] and centroid as a buffer
-  Eigen::Matrix<Scalar, 1, 9, Eigen::RowMajor> accu = Eigen::Matrix<Scalar, 1, 9, Eigen::RowMajor>::Zero ();
-  size_t point_count;
-  if (cloud.is_dense)
+  MeanAndCovarianceAccumulator accumulator;
+  accumulator.add (cloud, indices);
+  if (accumulator.getNumberOfPoints () != 0)
   {
-    point_count = indices.size ();
-    for (std::vector<int>::const_iterator iIt = indices.begin (); iIt != indices.end (); ++iIt)
-    {
-      //const PointT& point = cloud[*iIt];
-      accu [0] += cloud[*iIt].x * cloud[*iIt].x;
-      accu [1] += cloud[*iIt].x * cloud[*iIt].y;
-      accu [2] += cloud[*iIt].x * cloud[*iIt].z;
-      accu [3] += cloud[*iIt].y * cloud[*iIt].y;
-      accu [4] += cloud[*iIt].y * cloud[*iIt].z;
-      accu [5] += cloud[*iIt].z * cloud[*iIt].z;
-      accu [6] += cloud[*iIt].x;
-      accu [7] += cloud[*iIt].y;
-      accu [8] += cloud[*iIt].z;
-    }
+    accumulator.getCentroid (centroid);
+    accumulator.getCovarianceMatrix (covariance_matrix);
   }
-  else
-  {
-    point_count = 0;
-    for (std::vector<int>::const_iterator iIt = indices.begin (); iIt != indices.end (); ++iIt)
-    {
-      if (!isFinite (cloud[*iIt]))
-        continue;
-
-      ++point_count;
-      accu [0] += cloud[*iIt].x * cloud[*iIt].x;
-      accu [1] += cloud[*iIt].x * cloud[*iIt].y;
-      accu [2] += cloud[*iIt].x * cloud[*iIt].z;
-      accu [3] += cloud[*iIt].y * cloud[*iIt].y; // 4
-      accu [4] += cloud[*iIt].y * cloud[*iIt].z; // 5
-      accu [5] += cloud[*iIt].z * cloud[*iIt].z; // 8
-      accu [6] += cloud[*iIt].x;
-      accu [7] += cloud[*iIt].y;
-      accu [8] += cloud[*iIt].z;
-    }
-  }
-
-  accu /= static_cast<Scalar> (point_count);
-  //Eigen::Vector3f vec = accu.tail<3> ();
-  //centroid.head<3> () = vec;//= accu.tail<3> ();
-  //centroid.head<3> () = accu.tail<3> ();    -- does not compile with Clang 3.0
-  centroid[0] = accu[6]; centroid[1] = accu[7]; centroid[2] = accu[8];
-  centroid[3] = 0;
-  covariance_matrix.coeffRef (0) = accu [0] - accu [6] * accu [6];
-  covariance_matrix.coeffRef (1) = accu [1] - accu [6] * accu [7];
-  covariance_matrix.coeffRef (2) = accu [2] - accu [6] * accu [8];
-  covariance_matrix.coeffRef (4) = accu [3] - accu [7] * accu [7];
-  covariance_matrix.coeffRef (5) = accu [4] - accu [7] * accu [8];
-  covariance_matrix.coeffRef (8) = accu [5] - accu [8] * accu [8];
-  covariance_matrix.coeffRef (3) = covariance_matrix.coeff (1);
-  covariance_matrix.coeffRef (6) = covariance_matrix.coeff (2);
-  covariance_matrix.coeffRef (7) = covariance_matrix.coeff (5);
-
-  return (static_cast<unsigned int> (point_count));
+  return (static_cast<unsigned int> (accumulator.getNumberOfPoints ()));
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -858,5 +759,108 @@ pcl::computeNDCentroid (const pcl::PointCloud<PointT> &cloud,
   return (pcl::computeNDCentroid (cloud, indices.indices, centroid));
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+inline void
+pcl::MeanAndCovarianceAccumulator::merge (size_t nr_points,
+                                          const Eigen::Vector3d &mean,
+                                          const Eigen::Matrix3d &scatter)
+{
+  if (nr_points == 0)
+    return;
+  if (nr_points_ == 0)
+  {
+    nr_points_ = nr_points;
+    mean_ = mean;
+    scatter_ = scatter;
+    return;
+  }
+  // Pairwise update (Chan, Golub and LeVeque)
+  const double n_a = static_cast<double> (nr_points_);
+  const double n_b = static_cast<double> (nr_points);
+  const Eigen::Vector3d delta = mean - mean_;
+  mean_ += delta * (n_b / (n_a + n_b));
+  scatter_ += scatter + delta * delta.transpose () * (n_a * n_b / (n_a + n_b));
+  nr_points_ += nr_points;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::MeanAndCovarianceAccumulator::addRange (const pcl::PointCloud<PointT> &cloud,
+                                             const std::vector<int> *indices,
+                                             size_t begin, size_t end)
+{
+  size_t i = begin;
+  while (i < end)
+  {
+    const size_t block_end = (end - i > block_size_) ? i + block_size_ : end;
+
+    // Sums of the deviations from the first point of the block, and of their outer products (by
+    // columns). Only the first 3 components are meaningful.
+    Eigen::Vector4f shift = Eigen::Vector4f::Zero ();
+    Eigen::Vector4f sum = Eigen::Vector4f::Zero ();
+    Eigen::Vector4f sum_x = Eigen::Vector4f::Zero ();
+    Eigen::Vector4f sum_y = Eigen::Vector4f::Zero ();
+    Eigen::Vector4f sum_z = Eigen::Vector4f::Zero ();
+    size_t count = 0;
+    for (; i < block_end; ++i)
+    {
+      const PointT &point = cloud.points[indices ? (*indices)[i] : i];
+      if (!cloud.is_dense && !isFinite (point))
+        continue;
+      const Eigen::Vector4f pt = pcl::detail::loadXYZ (point).matrix ();
+      if (count == 0)
+        shift = pt;
+      const Eigen::Vector4f d = pt - shift;
+      sum += d;
+      sum_x += d * d[0];
+      sum_y += d * d[1];
+      sum_z += d * d[2];
+      ++count;
+    }
+    if (count == 0)
+      continue;
+
+    const double n = static_cast<double> (count);
+    const Eigen::Vector3d s = sum.head<3> ().cast<double> ();
+    Eigen::Matrix3d scatter;
+    scatter.col (0) = sum_x.head<3> ().cast<double> ();
+    scatter.col (1) = sum_y.head<3> ().cast<double> ();
+    scatter.col (2) = sum_z.head<3> ().cast<double> ();
+    scatter -= s * s.transpose () / n;
+    merge (count, shift.head<3> ().cast<double> () + s / n, scatter);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::MeanAndCovarianceAccumulator::addPoints (const pcl::PointCloud<PointT> &cloud,
+                                              const std::vector<int> *indices,
+                                              unsigned int nr_threads)
+{
+  const size_t nr_points = indices ? indices->size () : cloud.points.size ();
+  if (nr_points <= chunk_size_)
+  {
+    addRange (cloud, indices, 0, nr_points);
+    return;
+  }
+
+  // The chunks do not depend on the number of threads, nor does the order of the merges
+  const int nr_chunks = static_cast<int> ((nr_points + chunk_size_ - 1) / chunk_size_);
+  std::vector<MeanAndCovarianceAccumulator> chunks (nr_chunks);
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nr_threads) if (nr_threads != 1)
+  for (int c = 0; c < nr_chunks; ++c)
+  {
+    const size_t begin = static_cast<size_t> (c) * chunk_size_;
+    const size_t end = (nr_points - begin > chunk_size_) ? begin + chunk_size_ : nr_points;
+    chunks[c].addRange (cloud, indices, begin, end);
+  }
+
+  // Tree reduction
+  for (size_t stride = 1; stride < chunks.size (); stride *= 2)
+    for (size_t c = 0; c + stride < chunks.size (); c += 2 * stride)
+      chunks[c].merge (chunks[c + stride]);
+  merge (chunks[0]);
+}
+
 #endif  //#ifndef PCL_COMMON_IMPL_CENTROID_H_
 
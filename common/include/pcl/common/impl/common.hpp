@@ -39,6 +39,11 @@
 #define PCL_COMMON_IMPL_H_
 
 #include <pcl/point_types.h>
+#include <algorithm>
+#include <limits>
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 inline double
@@ -67,291 +72,299 @@ pcl::getMeanStd (const std::vector<float> &values, double &mean, double &stddev)
   stddev = sqrt (variance);
 }
 
-//////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> inline void
-pcl::getPointsInBox (const pcl::PointCloud<PointT> &cloud, 
-                     Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt,
-                     std::vector<int> &indices)
+namespace pcl
 {
-  indices.resize (cloud.points.size ());
-  int l = 0;
-
-  // If the data is dense, we don't need to check for NaN
-  if (cloud.is_dense)
+  namespace detail
   {
-    for (size_t i = 0; i < cloud.points.size (); ++i)
+    /** \brief Check if the first 3 components of an array are finite. */
+    inline bool
+    isFiniteXYZ (const Eigen::Array4f &pt)
     {
-      // Check if the point is inside bounds
-      if (cloud.points[i].x < min_pt[0] || cloud.points[i].y < min_pt[1] || cloud.points[i].z < min_pt[2])
-        continue;
-      if (cloud.points[i].x > max_pt[0] || cloud.points[i].y > max_pt[1] || cloud.points[i].z > max_pt[2])
-        continue;
-      indices[l++] = int (i);
+#ifdef __SSE__
+      const __m128 p = _mm_load_ps (pt.data ());
+      // p - p is 0 for the finite values, and NaN otherwise
+      return ((_mm_movemask_ps (_mm_cmpeq_ps (_mm_sub_ps (p, p), _mm_setzero_ps ())) & 7) == 7);
+#else
+      return (pcl_isfinite (pt[0]) && pcl_isfinite (pt[1]) && pcl_isfinite (pt[2]));
+#endif
     }
-  }
-  // NaN or Inf values could exist => check for them
-  else
-  {
-    for (size_t i = 0; i < cloud.points.size (); ++i)
+
+    /** \brief Check if the first 3 components of an array are within bounds (false for NaN). */
+    inline bool
+    isInBoxXYZ (const Eigen::Array4f &pt, const Eigen::Array4f &min_p, const Eigen::Array4f &max_p)
     {
-      // Check if the point is invalid
-      if (!pcl_isfinite (cloud.points[i].x) || 
-          !pcl_isfinite (cloud.points[i].y) || 
-          !pcl_isfinite (cloud.points[i].z))
-        continue;
-      // Check if the point is inside bounds
-      if (cloud.points[i].x < min_pt[0] || cloud.points[i].y < min_pt[1] || cloud.points[i].z < min_pt[2])
-        continue;
-      if (cloud.points[i].x > max_pt[0] || cloud.points[i].y > max_pt[1] || cloud.points[i].z > max_pt[2])
-        continue;
-      indices[l++] = int (i);
+#ifdef __SSE__
+      const __m128 p = _mm_load_ps (pt.data ());
+      const __m128 inside = _mm_and_ps (_mm_cmpge_ps (p, _mm_load_ps (min_p.data ())),
+                                        _mm_cmple_ps (p, _mm_load_ps (max_p.data ())));
+      return ((_mm_movemask_ps (inside) & 7) == 7);
+#else
+      return (pt[0] >= min_p[0] && pt[1] >= min_p[1] && pt[2] >= min_p[2] &&
+              pt[0] <= max_p[0] && pt[1] <= max_p[1] && pt[2] <= max_p[2]);
+#endif
     }
-  }
-  indices.resize (l);
-}
 
-//////////////////////////////////////////////////////////////////////////////////////////////
-template<typename PointT> inline void
-pcl::getMaxDistance (const pcl::PointCloud<PointT> &cloud, const Eigen::Vector4f &pivot_pt, Eigen::Vector4f &max_pt)
-{
-  float max_dist = -FLT_MAX;
-  int max_idx = -1;
-  float dist;
+    /** \brief The number of points processed by a parallel task in the functions below. */
+    const size_t common_chunk_size = 65536;
 
-  // If the data is dense, we don't need to check for NaN
-  if (cloud.is_dense)
-  {
-    for (size_t i = 0; i < cloud.points.size (); ++i)
+    /** \brief Update the bounds of the points in [begin, end[ of a cloud (or of a subset of it). */
+    template <typename PointT> inline void
+    getMinMax3D (const pcl::PointCloud<PointT> &cloud, const std::vector<int> *indices,
+                 size_t begin, size_t end, Eigen::Array4f &min_pt, Eigen::Array4f &max_pt)
     {
-      pcl::Vector4fMapConst pt = cloud.points[i].getVector4fMap ();
-      dist = (pivot_pt - pt).norm ();
-      if (dist > max_dist)
+      // Local copies, which the compiler can keep in registers
+      Eigen::Array4f min_p = min_pt, max_p = max_pt;
+      // If the data is dense, we don't need to check for NaN
+      if (cloud.is_dense)
       {
-        max_idx = int (i);
-        max_dist = dist;
+        for (size_t i = begin; i < end; ++i)
+        {
+          const Eigen::Array4f pt = loadXYZ (cloud.points[indices ? (*indices)[i] : i]);
+          min_p = min_p.min (pt);
+          max_p = max_p.max (pt);
+        }
       }
-    }
-  }
-  // NaN or Inf values could exist => check for them
-  else
-  {
-    for (size_t i = 0; i < cloud.points.size (); ++i)
-    {
-      // Check if the point is invalid
-      if (!pcl_isfinite (cloud.points[i].x) || !pcl_isfinite (cloud.points[i].y) || !pcl_isfinite (cloud.points[i].z))
-        continue;
-      pcl::Vector4fMapConst pt = cloud.points[i].getVector4fMap ();
-      dist = (pivot_pt - pt).norm ();
-      if (dist > max_dist)
+      // NaN or Inf values could exist => check for them
+      else
       {
-        max_idx = int (i);
-        max_dist = dist;
+        for (size_t i = begin; i < end; ++i)
+        {
+          const Eigen::Array4f pt = loadXYZ (cloud.points[indices ? (*indices)[i] : i]);
+          if (!isFiniteXYZ (pt))
+            continue;
+          min_p = min_p.min (pt);
+          max_p = max_p.max (pt);
+        }
       }
+      min_pt = min_p;
+      max_pt = max_p;
     }
-  }
 
-  if(max_idx != -1)
-    max_pt = cloud.points[max_idx].getVector4fMap ();
-  else
-    max_pt = Eigen::Vector4f(std::numeric_limits<float>::quiet_NaN(),std::numeric_limits<float>::quiet_NaN(),std::numeric_limits<float>::quiet_NaN(),std::numeric_limits<float>::quiet_NaN());
-}
+    /** \brief Get the bounds of a cloud (or of a subset of it), on \a nr_threads threads. */
+    template <typename PointT> void
+    getMinMax3D (const pcl::PointCloud<PointT> &cloud, const std::vector<int> *indices,
+                 Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads)
+    {
+      Eigen::Array4f min_p, max_p;
+      min_p.setConstant (FLT_MAX);
+      max_p.setConstant (-FLT_MAX);
 
-//////////////////////////////////////////////////////////////////////////////////////////////
-template<typename PointT> inline void
-pcl::getMaxDistance (const pcl::PointCloud<PointT> &cloud, const std::vector<int> &indices,
-                     const Eigen::Vector4f &pivot_pt, Eigen::Vector4f &max_pt)
-{
-  float max_dist = -FLT_MAX;
-  int max_idx = -1;
-  float dist;
+      const size_t nr_points = indices ? indices->size () : cloud.points.size ();
+      const int nr_chunks = static_cast<int> ((nr_points + common_chunk_size - 1) / common_chunk_size);
+      if (nr_threads == 1 || nr_chunks <= 1)
+        getMinMax3D (cloud, indices, 0, nr_points, min_p, max_p);
+      else
+      {
+#pragma omp parallel num_threads(nr_threads)
+        {
+          Eigen::Array4f local_min_p, local_max_p;
+          local_min_p.setConstant (FLT_MAX);
+          local_max_p.setConstant (-FLT_MAX);
+#pragma omp for schedule(static) nowait
+          for (int c = 0; c < nr_chunks; ++c)
+          {
+            const size_t begin = static_cast<size_t> (c) * common_chunk_size;
+            getMinMax3D (cloud, indices, begin, std::min (begin + common_chunk_size, nr_points), local_min_p, local_max_p);
+          }
+#pragma omp critical (pcl_getMinMax3D)
+          {
+            min_p = min_p.min (local_min_p);
+            max_p = max_p.max (local_max_p);
+          }
+        }
+      }
+      min_pt = min_p;
+      max_pt = max_p;
+    }
 
-  // If the data is dense, we don't need to check for NaN
-  if (cloud.is_dense)
-  {
-    for (size_t i = 0; i < indices.size (); ++i)
+    /** \brief Find the farthest point from \a pivot among the points in [begin, end[ of a
+      * cloud (or of a subset of it). \a max_idx is the position in [begin, end[, or -1.
+      */
+    template <typename PointT> inline void
+    getMaxDistance (const pcl::PointCloud<PointT> &cloud, const std::vector<int> *indices,
+                    size_t begin, size_t end, const Eigen::Array4f &pivot, float &max_distance, int &max_index)
     {
-      pcl::Vector4fMapConst pt = cloud.points[indices[i]].getVector4fMap ();
-      dist = (pivot_pt - pt).norm ();
-      if (dist > max_dist)
+      // Local copies, which the compiler can keep in registers
+      const Eigen::Array4f p = pivot;
+      float max_dist = max_distance;
+      int max_idx = max_index;
+      // If the data is dense, we don't need to check for NaN
+      if (cloud.is_dense)
+      {
+        for (size_t i = begin; i < end; ++i)
+        {
+          const Eigen::Array4f d = loadXYZ (cloud.points[indices ? (*indices)[i] : i]) - p;
+          const float dist = (d * d).head<3> ().sum ();
+          if (dist > max_dist)
+          {
+            max_idx = static_cast<int> (i);
+            max_dist = dist;
+          }
+        }
+      }
+      // NaN or Inf values could exist => check for them
+      else
       {
-        max_idx = static_cast<int> (i);
-        max_dist = dist;
+        for (size_t i = begin; i < end; ++i)
+        {
+          const Eigen::Array4f pt = loadXYZ (cloud.points[indices ? (*indices)[i] : i]);
+          if (!isFiniteXYZ (pt))
+            continue;
+          const Eigen::Array4f d = pt - p;
+          const float dist = (d * d).head<3> ().sum ();
+          if (dist > max_dist)
+          {
+            max_idx = static_cast<int> (i);
+            max_dist = dist;
+          }
+        }
       }
+      max_distance = max_dist;
+      max_index = max_idx;
     }
-  }
-  // NaN or Inf values could exist => check for them
-  else
-  {
-    for (size_t i = 0; i < indices.size (); ++i)
+
+    /** \brief Get the farthest point from \a pivot_pt in a cloud (or in a subset of it), on \a nr_threads threads. */
+    template <typename PointT> void
+    getMaxDistance (const pcl::PointCloud<PointT> &cloud, const std::vector<int> *indices,
+                    const Eigen::Vector4f &pivot_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads)
     {
-      // Check if the point is invalid
-      if (!pcl_isfinite (cloud.points[indices[i]].x) || !pcl_isfinite (cloud.points[indices[i]].y)
-          ||
-          !pcl_isfinite (cloud.points[indices[i]].z))
-        continue;
+      const Eigen::Array4f pivot = pivot_pt.array ();
+      float max_dist = -FLT_MAX;
+      int max_idx = -1;
 
-      pcl::Vector4fMapConst pt = cloud.points[indices[i]].getVector4fMap ();
-      dist = (pivot_pt - pt).norm ();
-      if (dist > max_dist)
+      const size_t nr_points = indices ? indices->size () : cloud.points.size ();
+      const int nr_chunks = static_cast<int> ((nr_points + common_chunk_size - 1) / common_chunk_size);
+      if (nr_threads == 1 || nr_chunks <= 1)
+        getMaxDistance (cloud, indices, 0, nr_points, pivot, max_dist, max_idx);
+      else
       {
-        max_idx = static_cast<int> (i);
-        max_dist = dist;
+#pragma omp parallel num_threads(nr_threads)
+        {
+          float local_max_dist = -FLT_MAX;
+          int local_max_idx = -1;
+#pragma omp for schedule(static) nowait
+          for (int c = 0; c < nr_chunks; ++c)
+          {
+            const size_t begin = static_cast<size_t> (c) * common_chunk_size;
+            getMaxDistance (cloud, indices, begin, std::min (begin + common_chunk_size, nr_points), pivot, local_max_dist, local_max_idx);
+          }
+          // The first of the farthest points wins, as in the serial version
+#pragma omp critical (pcl_getMaxDistance)
+          if (local_max_idx != -1 &&
+              (local_max_dist > max_dist || (local_max_dist == max_dist && local_max_idx < max_idx)))
+          {
+            max_dist = local_max_dist;
+            max_idx = local_max_idx;
+          }
+        }
       }
+
+      if (max_idx != -1)
+        max_pt = loadXYZ (cloud.points[indices ? (*indices)[max_idx] : max_idx]).matrix ();
+      else
+        max_pt = Eigen::Vector4f(std::numeric_limits<float>::quiet_NaN(),std::numeric_limits<float>::quiet_NaN(),std::numeric_limits<float>::quiet_NaN(),std::numeric_limits<float>::quiet_NaN());
     }
-  }
 
-  if(max_idx != -1)
-    max_pt = cloud.points[max_idx].getVector4fMap ();
-  else
-    max_pt = Eigen::Vector4f(std::numeric_limits<float>::quiet_NaN(),std::numeric_limits<float>::quiet_NaN(),std::numeric_limits<float>::quiet_NaN(),std::numeric_limits<float>::quiet_NaN());
+    /** \brief Append the indices of the points in [begin, end[ of a cloud which are in a box. */
+    template <typename PointT> inline void
+    getPointsInBox (const pcl::PointCloud<PointT> &cloud, size_t begin, size_t end,
+                    const Eigen::Array4f &min_p, const Eigen::Array4f &max_p, std::vector<int> &indices)
+    {
+      for (size_t i = begin; i < end; ++i)
+      {
+        const Eigen::Array4f pt = loadXYZ (cloud.points[i]);
+        // NaN are never in the box, but Inf could be if the box is not bounded
+        if (!isInBoxXYZ (pt, min_p, max_p) || (!cloud.is_dense && !isFiniteXYZ (pt)))
+          continue;
+        indices.push_back (static_cast<int> (i));
+      }
+    }
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> inline void
-pcl::getMinMax3D (const pcl::PointCloud<PointT> &cloud, PointT &min_pt, PointT &max_pt)
+pcl::getPointsInBox (const pcl::PointCloud<PointT> &cloud, 
+                     Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt,
+                     std::vector<int> &indices, unsigned int nr_threads)
 {
-  Eigen::Array4f min_p, max_p;
-  min_p.setConstant (FLT_MAX);
-  max_p.setConstant (-FLT_MAX);
-
-  // If the data is dense, we don't need to check for NaN
-  if (cloud.is_dense)
+  const Eigen::Array4f min_p = min_pt.array (), max_p = max_pt.array ();
+  const size_t nr_points = cloud.points.size ();
+  const int nr_chunks = static_cast<int> ((nr_points + detail::common_chunk_size - 1) / detail::common_chunk_size);
+  indices.clear ();
+  if (nr_threads == 1 || nr_chunks <= 1)
   {
-    for (size_t i = 0; i < cloud.points.size (); ++i)
-    {
-      pcl::Array4fMapConst pt = cloud.points[i].getArray4fMap ();
-      min_p = min_p.min (pt);
-      max_p = max_p.max (pt);
-    }
+    indices.reserve (nr_points);
+    detail::getPointsInBox (cloud, 0, nr_points, min_p, max_p, indices);
+    return;
   }
-  // NaN or Inf values could exist => check for them
-  else
+
+  // The chunks are concatenated in order, so that the indices are sorted as in the serial version
+  std::vector<std::vector<int> > chunks (nr_chunks);
+#pragma omp parallel for schedule(static) num_threads(nr_threads)
+  for (int c = 0; c < nr_chunks; ++c)
   {
-    for (size_t i = 0; i < cloud.points.size (); ++i)
-    {
-      // Check if the point is invalid
-      if (!pcl_isfinite (cloud.points[i].x) || 
-          !pcl_isfinite (cloud.points[i].y) || 
-          !pcl_isfinite (cloud.points[i].z))
-        continue;
-      pcl::Array4fMapConst pt = cloud.points[i].getArray4fMap ();
-      min_p = min_p.min (pt);
-      max_p = max_p.max (pt);
-    }
+    const size_t begin = static_cast<size_t> (c) * detail::common_chunk_size;
+    const size_t end = std::min (begin + detail::common_chunk_size, nr_points);
+    chunks[c].reserve (end - begin);
+    detail::getPointsInBox (cloud, begin, end, min_p, max_p, chunks[c]);
   }
+  size_t nr_indices = 0;
+  for (int c = 0; c < nr_chunks; ++c)
+    nr_indices += chunks[c].size ();
+  indices.reserve (nr_indices);
+  for (int c = 0; c < nr_chunks; ++c)
+    indices.insert (indices.end (), chunks[c].begin (), chunks[c].end ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> inline void
+pcl::getMaxDistance (const pcl::PointCloud<PointT> &cloud, const Eigen::Vector4f &pivot_pt, Eigen::Vector4f &max_pt,
+                     unsigned int nr_threads)
+{
+  detail::getMaxDistance (cloud, NULL, pivot_pt, max_pt, nr_threads);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointT> inline void
+pcl::getMaxDistance (const pcl::PointCloud<PointT> &cloud, const std::vector<int> &indices,
+                     const Eigen::Vector4f &pivot_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads)
+{
+  detail::getMaxDistance (cloud, &indices, pivot_pt, max_pt, nr_threads);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> inline void
+pcl::getMinMax3D (const pcl::PointCloud<PointT> &cloud, PointT &min_pt, PointT &max_pt, unsigned int nr_threads)
+{
+  Eigen::Vector4f min_p, max_p;
+  detail::getMinMax3D (cloud, NULL, min_p, max_p, nr_threads);
   min_pt.x = min_p[0]; min_pt.y = min_p[1]; min_pt.z = min_p[2];
   max_pt.x = max_p[0]; max_pt.y = max_p[1]; max_pt.z = max_p[2];
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> inline void
-pcl::getMinMax3D (const pcl::PointCloud<PointT> &cloud, Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt)
+pcl::getMinMax3D (const pcl::PointCloud<PointT> &cloud, Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt,
+                  unsigned int nr_threads)
 {
-  Eigen::Array4f min_p, max_p;
-  min_p.setConstant (FLT_MAX);
-  max_p.setConstant (-FLT_MAX);
-
-  // If the data is dense, we don't need to check for NaN
-  if (cloud.is_dense)
-  {
-    for (size_t i = 0; i < cloud.points.size (); ++i)
-    {
-      pcl::Array4fMapConst pt = cloud.points[i].getArray4fMap ();
-      min_p = min_p.min (pt);
-      max_p = max_p.max (pt);
-    }
-  }
-  // NaN or Inf values could exist => check for them
-  else
-  {
-    for (size_t i = 0; i < cloud.points.size (); ++i)
-    {
-      // Check if the point is invalid
-      if (!pcl_isfinite (cloud.points[i].x) || 
-          !pcl_isfinite (cloud.points[i].y) || 
-          !pcl_isfinite (cloud.points[i].z))
-        continue;
-      pcl::Array4fMapConst pt = cloud.points[i].getArray4fMap ();
-      min_p = min_p.min (pt);
-      max_p = max_p.max (pt);
-    }
-  }
-  min_pt = min_p;
-  max_pt = max_p;
+  detail::getMinMax3D (cloud, NULL, min_pt, max_pt, nr_threads);
 }
 
-
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> inline void
 pcl::getMinMax3D (const pcl::PointCloud<PointT> &cloud, const pcl::PointIndices &indices,
-                  Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt)
+                  Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads)
 {
-  Eigen::Array4f min_p, max_p;
-  min_p.setConstant (FLT_MAX);
-  max_p.setConstant (-FLT_MAX);
-
-  // If the data is dense, we don't need to check for NaN
-  if (cloud.is_dense)
-  {
-    for (size_t i = 0; i < indices.indices.size (); ++i)
-    {
-      pcl::Array4fMapConst pt = cloud.points[indices.indices[i]].getArray4fMap ();
-      min_p = min_p.min (pt);
-      max_p = max_p.max (pt);
-    }
-  }
-  // NaN or Inf values could exist => check for them
-  else
-  {
-    for (size_t i = 0; i < indices.indices.size (); ++i)
-    {
-      // Check if the point is invalid
-      if (!pcl_isfinite (cloud.points[indices.indices[i]].x) || 
-          !pcl_isfinite (cloud.points[indices.indices[i]].y) || 
-          !pcl_isfinite (cloud.points[indices.indices[i]].z))
-        continue;
-      pcl::Array4fMapConst pt = cloud.points[indices.indices[i]].getArray4fMap ();
-      min_p = min_p.min (pt);
-      max_p = max_p.max (pt);
-    }
-  }
-  min_pt = min_p;
-  max_pt = max_p;
+  detail::getMinMax3D (cloud, &indices.indices, min_pt, max_pt, nr_threads);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> inline void
 pcl::getMinMax3D (const pcl::PointCloud<PointT> &cloud, const std::vector<int> &indices,
-                  Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt)
+                  Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads)
 {
-  min_pt.setConstant (FLT_MAX);
-  max_pt.setConstant (-FLT_MAX);
-
-  // If the data is dense, we don't need to check for NaN
-  if (cloud.is_dense)
-  {
-    for (size_t i = 0; i < indices.size (); ++i)
-    {
-      pcl::Array4fMapConst pt = cloud.points[indices[i]].getArray4fMap ();
-      min_pt = min_pt.array ().min (pt);
-      max_pt = max_pt.array ().max (pt);
-    }
-  }
-  // NaN or Inf values could exist => check for them
-  else
-  {
-    for (size_t i = 0; i < indices.size (); ++i)
-    {
-      // Check if the point is invalid
-      if (!pcl_isfinite (cloud.points[indices[i]].x) || 
-          !pcl_isfinite (cloud.points[indices[i]].y) || 
-          !pcl_isfinite (cloud.points[indices[i]].z))
-        continue;
-      pcl::Array4fMapConst pt = cloud.points[indices[i]].getArray4fMap ();
-      min_pt = min_pt.array ().min (pt);
-      max_pt = max_pt.array ().max (pt);
-    }
-  }
+  detail::getMinMax3D (cloud, &indices, min_pt, max_pt, nr_threads);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
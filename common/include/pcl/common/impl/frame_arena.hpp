@@ -0,0 +1,72 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_COMMON_IMPL_FRAME_ARENA_HPP_
+#define PCL_COMMON_IMPL_FRAME_ARENA_HPP_
+
+#include <pcl/common/frame_arena.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T> boost::shared_ptr<T>
+pcl::FrameArena::get ()
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  std::vector<Slot> &slots = pools_[&typeid (T)];
+
+  // An object is not used anymore when the arena holds the only reference to it
+  for (size_t i = 0; i < slots.size (); ++i)
+  {
+    if (!slots[i].object.unique ())
+      continue;
+    slots[i].requested = true;
+    ++nr_reuses_;
+    boost::shared_ptr<T> object = boost::static_pointer_cast<T> (slots[i].object);
+    detail::clearForReuse (*object);
+    return (object);
+  }
+
+  boost::shared_ptr<T> object (new T);
+  slots.push_back (Slot ());
+  slots.back ().object = object;
+  slots.back ().requested = true;
+  ++nr_allocations_;
+  return (object);
+}
+
+#endif  // PCL_COMMON_IMPL_FRAME_ARENA_HPP_
@@ -0,0 +1,123 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef PCL_COMMON_IMPL_QUANTIZATION_H_
+#define PCL_COMMON_IMPL_QUANTIZATION_H_
+
+#include <pcl/console/print.h>
+#include <cmath>
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> size_t
+pcl::quantizePointCloud (const pcl::PointCloud<PointT> &cloud_in,
+                         const Eigen::Vector3f &origin, float step,
+                         pcl::PointCloud<pcl::PointXYZQuantized> &cloud_out)
+{
+  cloud_out.header = cloud_in.header;
+  cloud_out.sensor_origin_ = cloud_in.sensor_origin_;
+  cloud_out.sensor_orientation_ = cloud_in.sensor_orientation_;
+  cloud_out.is_dense = true;
+
+  if (step <= 0.0f)
+  {
+    PCL_ERROR ("[pcl::quantizePointCloud] Invalid quantization step %f!\n", step);
+    cloud_out.points.clear ();
+    cloud_out.width = cloud_out.height = 0;
+    return (cloud_in.points.size ());
+  }
+
+  const float inv_step = 1.0f / step;
+  cloud_out.points.resize (cloud_in.points.size ());
+  size_t nr_points = 0;
+  for (size_t i = 0; i < cloud_in.points.size (); ++i)
+  {
+    const PointT &p = cloud_in.points[i];
+    // Non finite coordinates fail the range check below
+    const float qx = floorf ((p.x - origin[0]) * inv_step + 0.5f);
+    const float qy = floorf ((p.y - origin[1]) * inv_step + 0.5f);
+    const float qz = floorf ((p.z - origin[2]) * inv_step + 0.5f);
+    if (!(qx >= -32768.0f && qx <= 32767.0f &&
+          qy >= -32768.0f && qy <= 32767.0f &&
+          qz >= -32768.0f && qz <= 32767.0f))
+      continue;
+
+    pcl::PointXYZQuantized &q = cloud_out.points[nr_points++];
+    q.x = static_cast<int16_t> (qx);
+    q.y = static_cast<int16_t> (qy);
+    q.z = static_cast<int16_t> (qz);
+  }
+  cloud_out.points.resize (nr_points);
+
+  if (nr_points == cloud_in.points.size ())
+  {
+    cloud_out.width = cloud_in.width;
+    cloud_out.height = cloud_in.height;
+  }
+  else
+  {
+    cloud_out.width = static_cast<uint32_t> (nr_points);
+    cloud_out.height = 1;
+  }
+  return (cloud_in.points.size () - nr_points);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::dequantizePointCloud (const pcl::PointCloud<pcl::PointXYZQuantized> &cloud_in,
+                           const Eigen::Vector3f &origin, float step,
+                           pcl::PointCloud<PointT> &cloud_out)
+{
+  cloud_out.header = cloud_in.header;
+  cloud_out.width = cloud_in.width;
+  cloud_out.height = cloud_in.height;
+  cloud_out.is_dense = true;
+  cloud_out.sensor_origin_ = cloud_in.sensor_origin_;
+  cloud_out.sensor_orientation_ = cloud_in.sensor_orientation_;
+
+  cloud_out.points.resize (cloud_in.points.size ());
+  for (size_t i = 0; i < cloud_in.points.size (); ++i)
+  {
+    const pcl::PointXYZQuantized &q = cloud_in.points[i];
+    PointT &p = cloud_out.points[i];
+    p.x = origin[0] + static_cast<float> (q.x) * step;
+    p.y = origin[1] + static_cast<float> (q.y) * step;
+    p.z = origin[2] + static_cast<float> (q.z) * step;
+  }
+}
+
+#endif  //#ifndef PCL_COMMON_IMPL_QUANTIZATION_H_
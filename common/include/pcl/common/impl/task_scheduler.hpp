@@ -0,0 +1,193 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_COMMON_IMPL_TASK_SCHEDULER_HPP_
+#define PCL_COMMON_IMPL_TASK_SCHEDULER_HPP_
+
+#include <pcl/common/task_scheduler.h>
+#include <Eigen/StdVector>
+
+#include <algorithm>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief The sub-ranges of a parallel loop, taken in turn by the threads running it. */
+    class RangeSplitter
+    {
+      public:
+        RangeSplitter (int begin, int end, int grain_size)
+          : begin_ (begin), end_ (end), grain_size_ (grain_size)
+          , nr_ranges_ ((end - begin) / grain_size + ((end - begin) % grain_size != 0 ? 1 : 0))
+          , next_ (0)
+        {}
+
+        /** \brief Take the next sub-range.
+          * \return false if all the sub-ranges are taken
+          */
+        inline bool
+        next (int &begin, int &end)
+        {
+          const long range = ++next_ - 1;
+          if (range >= nr_ranges_)
+            return (false);
+          begin = begin_ + static_cast<int> (range) * grain_size_;
+          end = (end_ - begin > grain_size_) ? begin + grain_size_ : end_;
+          return (true);
+        }
+
+      private:
+        const int begin_;
+        const int end_;
+        const int grain_size_;
+        const long nr_ranges_;
+        boost::detail::atomic_count next_;
+    };
+
+    /** \brief Compute the grain size of a parallel loop, and the number of threads worth running it. */
+    inline unsigned int
+    getNumberOfLoopThreads (int begin, int end, int &grain_size, unsigned int nr_threads)
+    {
+      unsigned int nr_loop_threads = TaskScheduler::getInstance ().getNumberOfThreads ();
+      if (nr_threads > 0 && nr_threads < nr_loop_threads)
+        nr_loop_threads = nr_threads;
+      const int nr_iterations = end - begin;
+      if (grain_size <= 0)
+        grain_size = std::max (1, nr_iterations / static_cast<int> (8 * nr_loop_threads));
+      const int nr_ranges = nr_iterations / grain_size + (nr_iterations % grain_size != 0 ? 1 : 0);
+      return (std::min (nr_loop_threads, static_cast<unsigned int> (nr_ranges)));
+    }
+
+    /** \brief Task running the sub-ranges of a parallel_for. */
+    template <typename Body>
+    class ParallelForTask : public Task
+    {
+      public:
+        ParallelForTask (const Body &body, RangeSplitter &splitter) : body_ (&body), splitter_ (&splitter) {}
+
+        void
+        execute ()
+        {
+          int begin, end;
+          while (splitter_->next (begin, end))
+            (*body_) (begin, end);
+        }
+
+      private:
+        const Body *body_;
+        RangeSplitter *splitter_;
+    };
+
+    /** \brief Task running the sub-ranges of a parallel_reduce on its own copy of the body. */
+    template <typename Body>
+    class ParallelReduceTask : public Task
+    {
+      public:
+        ParallelReduceTask (const Body &body, RangeSplitter &splitter) : body (body), splitter_ (&splitter) {}
+
+        void
+        execute ()
+        {
+          int begin, end;
+          while (splitter_->next (begin, end))
+            body (begin, end);
+        }
+
+        /** \brief The partial result of the task. */
+        Body body;
+
+      private:
+        RangeSplitter *splitter_;
+    };
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename Body> void
+pcl::parallel_for (int begin, int end, const Body &body, int grain_size, unsigned int nr_threads)
+{
+  if (end <= begin)
+    return;
+  const unsigned int nr_loop_threads = detail::getNumberOfLoopThreads (begin, end, grain_size, nr_threads);
+  if (nr_loop_threads <= 1)
+  {
+    body (begin, end);
+    return;
+  }
+
+  detail::RangeSplitter splitter (begin, end, grain_size);
+  std::vector<detail::ParallelForTask<Body> > tasks (nr_loop_threads, detail::ParallelForTask<Body> (body, splitter));
+  TaskGroup group;
+  for (size_t i = 1; i < tasks.size (); ++i)
+    group.spawn (tasks[i]);
+  tasks[0].execute ();
+  group.wait ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename Body> void
+pcl::parallel_reduce (int begin, int end, Body &body, int grain_size, unsigned int nr_threads)
+{
+  if (end <= begin)
+    return;
+  const unsigned int nr_loop_threads = detail::getNumberOfLoopThreads (begin, end, grain_size, nr_threads);
+  if (nr_loop_threads <= 1)
+  {
+    body (begin, end);
+    return;
+  }
+
+  // The copies are made before the calling thread accumulates into body
+  detail::RangeSplitter splitter (begin, end, grain_size);
+  std::vector<detail::ParallelReduceTask<Body>, Eigen::aligned_allocator<detail::ParallelReduceTask<Body> > >
+    tasks (nr_loop_threads - 1, detail::ParallelReduceTask<Body> (body, splitter));
+  TaskGroup group;
+  for (size_t i = 0; i < tasks.size (); ++i)
+    group.spawn (tasks[i]);
+  int range_begin, range_end;
+  while (splitter.next (range_begin, range_end))
+    body (range_begin, range_end);
+  group.wait ();
+
+  for (size_t i = 0; i < tasks.size (); ++i)
+    body.join (tasks[i].body);
+}
+
+#endif  // PCL_COMMON_IMPL_TASK_SCHEDULER_HPP_
@@ -34,227 +34,284 @@
  *
  */
 
-//////////////////////////////////////////////////////////////////////////////////////////////
-template <typename PointT> void
-pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
-                          pcl::PointCloud<PointT> &cloud_out,
-                          const Eigen::Affine3f &transform)
+#include <boost/type_traits/integral_constant.hpp>
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+namespace pcl
 {
-  if (&cloud_in != &cloud_out)
+  namespace detail
   {
-    // Note: could be replaced by cloud_out = cloud_in
-    cloud_out.header   = cloud_in.header;
-    cloud_out.is_dense = cloud_in.is_dense;
-    cloud_out.width    = cloud_in.width;
-    cloud_out.height   = cloud_in.height;
-    cloud_out.points.reserve (cloud_out.points.size ());
-    cloud_out.points.assign (cloud_in.points.begin (), cloud_in.points.end ());
-  }
+    /** \brief Applies an affine transformation to the coordinates and to the
+      * normals of points. The padded coordinates and normals are transformed
+      * with SSE, the 4th float being kept; the other ones go through Eigen.
+      */
+    class Transformer
+    {
+      public:
+        /** \brief Constructor.
+          * \param[in] transform the affine transformation to apply to the points
+          * \param[in] rotation the rotation to apply to the normals
+          */
+        Transformer (const Eigen::Affine3f &transform, const Eigen::Matrix3f &rotation) :
+          transform_ (transform), rotation_ (rotation)
+        {
+#ifdef __SSE__
+          const Eigen::Matrix4f &m = transform.matrix ();
+          c0_ = _mm_setr_ps (m (0, 0), m (1, 0), m (2, 0), 0.0f);
+          c1_ = _mm_setr_ps (m (0, 1), m (1, 1), m (2, 1), 0.0f);
+          c2_ = _mm_setr_ps (m (0, 2), m (1, 2), m (2, 2), 0.0f);
+          c3_ = _mm_setr_ps (m (0, 3), m (1, 3), m (2, 3), 0.0f);
+          r0_ = _mm_setr_ps (rotation (0, 0), rotation (1, 0), rotation (2, 0), 0.0f);
+          r1_ = _mm_setr_ps (rotation (0, 1), rotation (1, 1), rotation (2, 1), 0.0f);
+          r2_ = _mm_setr_ps (rotation (0, 2), rotation (1, 2), rotation (2, 2), 0.0f);
+#endif
+        }
 
-  if (cloud_in.is_dense)
-  {
-    // If the dataset is dense, simply transform it!
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-      cloud_out.points[i].getVector3fMap () = transform * 
-                                              cloud_in.points[i].getVector3fMap ();
-  }
-  else
-  {
-    // Dataset might contain NaNs and Infs, so check for them first,
-    // otherwise we get errors during the multiplication (?)
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
+        /** \brief Transform the coordinates of \a src into \a tgt (which may be \a src). */
+        template <typename PointT> inline void
+        transformPoint (const PointT &src, PointT &tgt) const
+        {
+          transformXYZ (src, tgt, boost::integral_constant<bool, pcl::traits::has_padded_xyz<PointT>::value> ());
+        }
+
+        /** \brief Transform the coordinates and rotate the normal of \a src into \a tgt (which may be \a src). */
+        template <typename PointT> inline void
+        transformPointWithNormal (const PointT &src, PointT &tgt) const
+        {
+          transformXYZ (src, tgt, boost::integral_constant<bool, pcl::traits::has_padded_xyz<PointT>::value> ());
+          transformNormal (src, tgt, boost::integral_constant<bool, pcl::traits::has_padded_normal<PointT>::value> ());
+        }
+
+        /** \brief Call transformPoint (false_type) or transformPointWithNormal (true_type). */
+        template <typename PointT> inline void
+        transform (const PointT &src, PointT &tgt, boost::false_type) const
+        {
+          transformPoint (src, tgt);
+        }
+
+        template <typename PointT> inline void
+        transform (const PointT &src, PointT &tgt, boost::true_type) const
+        {
+          transformPointWithNormal (src, tgt);
+        }
+
+      private:
+#ifdef __SSE__
+        /** \brief Store the first 3 floats of \a r and the 4th float of \a p to \a tgt. */
+        static inline void
+        store (const __m128 r, const __m128 p, float *tgt)
+        {
+          // (r2, r2, p3, p3), then (r0, r1, r2, p3)
+          const __m128 high = _mm_shuffle_ps (r, p, _MM_SHUFFLE (3, 3, 2, 2));
+          _mm_storeu_ps (tgt, _mm_shuffle_ps (r, high, _MM_SHUFFLE (2, 0, 1, 0)));
+        }
+
+        /** \brief Rotate the 4 floats (a normal) at \a src into \a tgt, keeping the 4th one. */
+        inline void
+        so3 (const float *src, float *tgt) const
+        {
+          const __m128 p = _mm_loadu_ps (src);
+          __m128 r = _mm_mul_ps (r0_, _mm_shuffle_ps (p, p, _MM_SHUFFLE (0, 0, 0, 0)));
+          r = _mm_add_ps (r, _mm_mul_ps (r1_, _mm_shuffle_ps (p, p, _MM_SHUFFLE (1, 1, 1, 1))));
+          r = _mm_add_ps (r, _mm_mul_ps (r2_, _mm_shuffle_ps (p, p, _MM_SHUFFLE (2, 2, 2, 2))));
+          store (r, p, tgt);
+        }
+
+        /** \brief Transform the 4 floats at \a src into \a tgt, keeping the 4th one. */
+        inline void
+        se3 (const float *src, float *tgt) const
+        {
+          const __m128 p = _mm_loadu_ps (src);
+          __m128 r = _mm_add_ps (c3_, _mm_mul_ps (c0_, _mm_shuffle_ps (p, p, _MM_SHUFFLE (0, 0, 0, 0))));
+          r = _mm_add_ps (r, _mm_mul_ps (c1_, _mm_shuffle_ps (p, p, _MM_SHUFFLE (1, 1, 1, 1))));
+          r = _mm_add_ps (r, _mm_mul_ps (c2_, _mm_shuffle_ps (p, p, _MM_SHUFFLE (2, 2, 2, 2))));
+          store (r, p, tgt);
+        }
+
+        template <typename PointT> inline void
+        transformXYZ (const PointT &src, PointT &tgt, boost::true_type) const
+        {
+          se3 (src.data, tgt.data);
+        }
+
+        template <typename PointT> inline void
+        transformNormal (const PointT &src, PointT &tgt, boost::true_type) const
+        {
+          so3 (src.data_n, tgt.data_n);
+        }
+#else
+        template <typename PointT> inline void
+        transformXYZ (const PointT &src, PointT &tgt, boost::true_type) const
+        {
+          transformXYZ (src, tgt, boost::false_type ());
+        }
+
+        template <typename PointT> inline void
+        transformNormal (const PointT &src, PointT &tgt, boost::true_type) const
+        {
+          transformNormal (src, tgt, boost::false_type ());
+        }
+#endif
+
+        template <typename PointT> inline void
+        transformXYZ (const PointT &src, PointT &tgt, boost::false_type) const
+        {
+          tgt.getVector3fMap () = transform_ * src.getVector3fMap ();
+        }
+
+        template <typename PointT> inline void
+        transformNormal (const PointT &src, PointT &tgt, boost::false_type) const
+        {
+          tgt.getNormalVector3fMap () = rotation_ * src.getNormalVector3fMap ();
+        }
+
+        /** \brief The transformation, for the points which are not padded. */
+        const Eigen::Affine3f transform_;
+        /** \brief The rotation of the normals, for the normals which are not padded. */
+        const Eigen::Matrix3f rotation_;
+#ifdef __SSE__
+        /** \brief The columns of the transformation, with a null 4th component. */
+        __m128 c0_, c1_, c2_, c3_;
+        /** \brief The columns of the rotation of the normals, with a null 4th component. */
+        __m128 r0_, r1_, r2_;
+#endif
+      public:
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+    };
+
+    /** \brief Transform the points of \a cloud_in (or the ones given by \a
+      * indices) into \a cloud_out, which may be \a cloud_in if \a indices is NULL.
+      * The normals are rotated by \a rotation if \a with_normals is true. The
+      * non finite points are copied unchanged.
+      */
+    template <typename PointT, bool with_normals> void
+    transformPointCloud (const pcl::PointCloud<PointT> &cloud_in,
+                         const std::vector<int> *indices,
+                         pcl::PointCloud<PointT> &cloud_out,
+                         const Eigen::Affine3f &transform,
+                         const Eigen::Matrix3f &rotation,
+                         unsigned int nr_threads)
     {
-      if (!pcl_isfinite (cloud_in.points[i].x) || 
-          !pcl_isfinite (cloud_in.points[i].y) || 
-          !pcl_isfinite (cloud_in.points[i].z))
-        continue;
-      cloud_out.points[i].getVector3fMap () = transform * 
-                                              cloud_in.points[i].getVector3fMap ();
+      const bool in_place = (&cloud_in == &cloud_out);
+      if (in_place && indices)
+      {
+        // The points are moved around, so work on a copy of the input
+        const pcl::PointCloud<PointT> cloud_copy (cloud_in);
+        transformPointCloud<PointT, with_normals> (cloud_copy, indices, cloud_out, transform, rotation, nr_threads);
+        return;
+      }
+
+      const int nr_points = static_cast<int> (indices ? indices->size () : cloud_in.points.size ());
+      if (!in_place)
+      {
+        cloud_out.header   = cloud_in.header;
+        cloud_out.is_dense = cloud_in.is_dense;
+        cloud_out.width    = indices ? nr_points : cloud_in.width;
+        cloud_out.height   = indices ? 1 : cloud_in.height;
+        // The points are copied while being transformed, and resize keeps the memory of cloud_out
+        cloud_out.points.resize (nr_points);
+      }
+
+      const Transformer transformer (transform, rotation);
+      const bool check_finite = !cloud_in.is_dense;
+#pragma omp parallel for num_threads(nr_threads) if (nr_threads != 1)
+      for (int i = 0; i < nr_points; ++i)
+      {
+        const PointT &src = cloud_in.points[indices ? (*indices)[i] : i];
+        PointT &tgt = cloud_out.points[i];
+        if (!in_place)
+          tgt = src;
+        // Dataset might contain NaNs and Infs, which are left unchanged
+        if (check_finite && (!pcl_isfinite (src.x) || !pcl_isfinite (src.y) || !pcl_isfinite (src.z)))
+          continue;
+        transformer.transform (src, tgt, boost::integral_constant<bool, with_normals> ());
+      }
     }
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
+                          pcl::PointCloud<PointT> &cloud_out,
+                          const Eigen::Affine3f &transform,
+                          unsigned int nr_threads)
+{
+  pcl::detail::transformPointCloud<PointT, false> (cloud_in, NULL, cloud_out, transform, transform.linear (), nr_threads);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::transformPointCloud (pcl::PointCloud<PointT> &cloud,
+                          const Eigen::Affine3f &transform,
+                          unsigned int nr_threads)
+{
+  pcl::detail::transformPointCloud<PointT, false> (cloud, NULL, cloud, transform, transform.linear (), nr_threads);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                           const std::vector<int> &indices, 
                           pcl::PointCloud<PointT> &cloud_out,
-                          const Eigen::Affine3f &transform)
+                          const Eigen::Affine3f &transform,
+                          unsigned int nr_threads)
 {
-  size_t npts = indices.size ();
-  // In order to transform the data, we need to remove NaNs
-  cloud_out.is_dense = cloud_in.is_dense;
-  cloud_out.header   = cloud_in.header;
-  cloud_out.width    = npts;
-  cloud_out.height   = 1;
-  cloud_out.points.resize (npts);
-
-  if (cloud_in.is_dense)
-  {
-    // If the dataset is dense, simply transform it!
-    for (size_t i = 0; i < npts; ++i)
-    {
-      // Copy fields first, then transform xyz data
-      cloud_out.points[i] = cloud_in.points[indices[i]]; 
-      cloud_out.points[i].getVector3fMap () = transform*cloud_out.points[i].getVector3fMap ();
-    }
-  }
-  else
-  {
-    // Dataset might contain NaNs and Infs, so check for them first,
-    // otherwise we get errors during the multiplication (?)
-    for (size_t i = 0; i < npts; ++i)
-    {
-      if (!pcl_isfinite (cloud_in.points[indices[i]].x) || 
-          !pcl_isfinite (cloud_in.points[indices[i]].y) || 
-          !pcl_isfinite (cloud_in.points[indices[i]].z))
-        continue;
-      cloud_out.points[i] = cloud_in.points[indices[i]]; 
-      cloud_out.points[i].getVector3fMap () = transform*cloud_out.points[i].getVector3fMap ();
-    }
-  }
+  pcl::detail::transformPointCloud<PointT, false> (cloud_in, &indices, cloud_out, transform, transform.linear (), nr_threads);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                      pcl::PointCloud<PointT> &cloud_out,
-                                     const Eigen::Affine3f &transform)
+                                     const Eigen::Affine3f &transform,
+                                     unsigned int nr_threads)
 {
-  if (&cloud_in != &cloud_out)
-  {
-    // Note: could be replaced by cloud_out = cloud_in
-    cloud_out.header   = cloud_in.header;
-    cloud_out.width    = cloud_in.width;
-    cloud_out.height   = cloud_in.height;
-    cloud_out.is_dense = cloud_in.is_dense;
-    cloud_out.points.reserve (cloud_out.points.size ());
-    cloud_out.points.assign (cloud_in.points.begin (), cloud_in.points.end ());
-  }
+  pcl::detail::transformPointCloud<PointT, true> (cloud_in, NULL, cloud_out, transform, transform.rotation (), nr_threads);
+}
 
-  // If the data is dense, we don't need to check for NaN
-  if (cloud_in.is_dense)
-  {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-    {
-      cloud_out.points[i].getVector3fMap() = transform * 
-                                             cloud_in.points[i].getVector3fMap ();
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::transformPointCloudWithNormals (pcl::PointCloud<PointT> &cloud,
+                                     const Eigen::Affine3f &transform,
+                                     unsigned int nr_threads)
+{
+  pcl::detail::transformPointCloud<PointT, true> (cloud, NULL, cloud, transform, transform.rotation (), nr_threads);
+}
 
-      // Rotate normals
-      cloud_out.points[i].getNormalVector3fMap() = transform.rotation () * 
-                                                   cloud_in.points[i].getNormalVector3fMap ();
-    }
-  }
-  // Dataset might contain NaNs and Infs, so check for them first.
-  else
-  {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-    {
-      if (!pcl_isfinite (cloud_in.points[i].x) || 
-          !pcl_isfinite (cloud_in.points[i].y) || 
-          !pcl_isfinite (cloud_in.points[i].z))
-        continue;
-      cloud_out.points[i].getVector3fMap() = transform * 
-                                             cloud_in.points[i].getVector3fMap ();
-
-      // Rotate normals
-      cloud_out.points[i].getNormalVector3fMap() = transform.rotation () * 
-                                                   cloud_in.points[i].getNormalVector3fMap ();
-    }
-  }
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
+                                     const std::vector<int> &indices, 
+                                     pcl::PointCloud<PointT> &cloud_out,
+                                     const Eigen::Affine3f &transform,
+                                     unsigned int nr_threads)
+{
+  pcl::detail::transformPointCloud<PointT, true> (cloud_in, &indices, cloud_out, transform, transform.rotation (), nr_threads);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                           pcl::PointCloud<PointT> &cloud_out,
-                          const Eigen::Matrix4f &transform)
+                          const Eigen::Matrix4f &transform,
+                          unsigned int nr_threads)
 {
-  if (&cloud_in != &cloud_out)
-  {
-    // Note: could be replaced by cloud_out = cloud_in
-    cloud_out.header   = cloud_in.header;
-    cloud_out.width    = cloud_in.width;
-    cloud_out.height   = cloud_in.height;
-    cloud_out.is_dense = cloud_in.is_dense;
-    cloud_out.points.reserve (cloud_out.points.size ());
-    cloud_out.points.assign (cloud_in.points.begin (), cloud_in.points.end ());
-  }
-
-  Eigen::Matrix3f rot   = transform.block<3, 3> (0, 0);
-  Eigen::Vector3f trans = transform.block<3, 1> (0, 3);
-  // If the data is dense, we don't need to check for NaN
-  if (cloud_in.is_dense)
-  {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-      cloud_out.points[i].getVector3fMap () = rot * 
-                                              cloud_in.points[i].getVector3fMap () + trans;
-  }
-  // Dataset might contain NaNs and Infs, so check for them first.
-  else
-  {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-    {
-      if (!pcl_isfinite (cloud_in.points[i].x) || 
-          !pcl_isfinite (cloud_in.points[i].y) || 
-          !pcl_isfinite (cloud_in.points[i].z))
-        continue;
-      cloud_out.points[i].getVector3fMap () = rot * 
-                                              cloud_in.points[i].getVector3fMap () + trans;
-    }
-  }
+  const Eigen::Affine3f t (transform);
+  pcl::detail::transformPointCloud<PointT, false> (cloud_in, NULL, cloud_out, t, t.linear (), nr_threads);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                      pcl::PointCloud<PointT> &cloud_out,
-                                     const Eigen::Matrix4f &transform)
+                                     const Eigen::Matrix4f &transform,
+                                     unsigned int nr_threads)
 {
-  if (&cloud_in != &cloud_out)
-  {
-    // Note: could be replaced by cloud_out = cloud_in
-    cloud_out.header   = cloud_in.header;
-    cloud_out.width    = cloud_in.width;
-    cloud_out.height   = cloud_in.height;
-    cloud_out.is_dense = cloud_in.is_dense;
-    cloud_out.points.reserve (cloud_out.points.size ());
-    cloud_out.points.assign (cloud_in.points.begin (), cloud_in.points.end ());
-  }
-
-  Eigen::Matrix3f rot   = transform.block<3, 3> (0, 0);
-  Eigen::Vector3f trans = transform.block<3, 1> (0, 3);
-
-  // If the data is dense, we don't need to check for NaN
-  if (cloud_in.is_dense)
-  {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-    {
-      cloud_out.points[i].getVector3fMap () = rot * 
-                                              cloud_in.points[i].getVector3fMap () + trans;
-
-      // Rotate normals
-      cloud_out.points[i].getNormalVector3fMap() = rot * 
-                                                   cloud_in.points[i].getNormalVector3fMap ();
-    }
-  }
-  // Dataset might contain NaNs and Infs, so check for them first.
-  else
-  {
-    for (size_t i = 0; i < cloud_out.points.size (); ++i)
-    {
-      if (!pcl_isfinite (cloud_in.points[i].x) || 
-          !pcl_isfinite (cloud_in.points[i].y) || 
-          !pcl_isfinite (cloud_in.points[i].z))
-        continue;
-      cloud_out.points[i].getVector3fMap () = rot * 
-                                              cloud_in.points[i].getVector3fMap () + trans;
-
-      // Rotate normals
-      cloud_out.points[i].getNormalVector3fMap() = rot * 
-                                                   cloud_in.points[i].getNormalVector3fMap ();
-    }
-  }
+  const Eigen::Affine3f t (transform);
+  pcl::detail::transformPointCloud<PointT, true> (cloud_in, NULL, cloud_out, t, t.linear (), nr_threads);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
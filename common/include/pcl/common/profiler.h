@@ -0,0 +1,282 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+#ifndef PCL_COMMON_PROFILER_H_
+#define PCL_COMMON_PROFILER_H_
+
+#include <pcl/pcl_macros.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/tss.hpp>
+#include <boost/date_time/posix_time/posix_time_types.hpp>
+
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief Hierarchical, thread aware profiler of named scopes and counters.
+    *
+    * The profiler is disabled by default, and the instrumented code then costs a test of a boolean per
+    * scope. Once enabled with \ref setEnabled, every thread records a tree of the scopes it goes
+    * through (nested scopes are children of the enclosing one), with the number of calls and the time
+    * spent in them, and the counters (points processed, neighbors visited, ...) added while they are
+    * open. The trees of all the threads are merged by \ref writeReport and \ref writeJSON, and the
+    * individual scopes can be exported as a trace for chrome://tracing with \ref writeChromeTrace.
+    *
+    * Scopes and counters are usually added with the macros, which are compiled out when
+    * PCL_NO_PROFILING is defined:
+    * \code
+    * void
+    * compute (const pcl::PointCloud<pcl::PointXYZ> &cloud)
+    * {
+    *   PCL_PROFILE_SCOPE ("compute");
+    *   PCL_PROFILE_COUNTER ("points", cloud.points.size ());
+    *   ...
+    * }
+    *
+    * pcl::Profiler::getInstance ().setEnabled (true);
+    * compute (cloud);
+    * pcl::Profiler::getInstance ().writeReport (std::cout);
+    * \endcode
+    *
+    * \note The scopes are nested per thread: in a parallel region, the scopes opened by the worker threads
+    * are at the top level of their tree, where the scopes of the other threads with the same name are merged.
+    * \note Counter names are expected to be string literals, or at least to outlive the profiler data.
+    * \ingroup common
+    */
+  class PCL_EXPORTS Profiler
+  {
+    public:
+      /** \brief Get the profiler of the process. */
+      static Profiler&
+      getInstance ();
+
+      /** \brief Return true if the scopes and counters are recorded. */
+      static inline bool
+      isEnabled ()
+      {
+        return (enabled_);
+      }
+
+      /** \brief Enable or disable the recording of scopes and counters.
+        * \param[in] enabled true to start recording
+        */
+      void
+      setEnabled (bool enabled);
+
+      /** \brief Enable or disable the recording of the individual scopes exported by \ref writeChromeTrace (default: true).
+        * \param[in] enabled false to only record the aggregated statistics
+        */
+      void
+      setTraceEnabled (bool enabled);
+
+      /** \brief Return true if the individual scopes are recorded. */
+      bool
+      isTraceEnabled () const;
+
+      /** \brief Set the maximum number of individual scopes recorded per thread (default: 1048576).
+        * The scopes closed once the limit is reached are only aggregated.
+        * \param[in] max_events the maximum number of scopes per thread
+        */
+      void
+      setMaxTraceEvents (size_t max_events);
+
+      /** \brief Drop everything recorded so far. Must not be called while scopes are open. */
+      void
+      reset ();
+
+      /** \brief Open a scope on the calling thread.
+        * \param[in] name the name of the scope
+        */
+      void
+      beginScope (const char* name);
+
+      /** \brief Open a scope named "<prefix>::<name>" on the calling thread, e.g. for the methods of a class.
+        * \param[in] prefix the prefix of the name, e.g. the name of the class
+        * \param[in] name the name of the scope
+        */
+      void
+      beginScope (const std::string &prefix, const char* name);
+
+      /** \brief Close the innermost scope of the calling thread. */
+      void
+      endScope ();
+
+      /** \brief Add a value to a counter of the innermost scope of the calling thread. The counters
+        * added outside of any scope are reported at the top level.
+        * \param[in] name the name of the counter
+        * \param[in] value the value added to the counter
+        */
+      void
+      addCounter (const char* name, double value);
+
+      /** \brief Write the merged scope tree of all the threads as indented text.
+        * \param[out] os the output stream
+        */
+      void
+      writeReport (std::ostream &os) const;
+
+      /** \brief Write the merged scope tree of all the threads as JSON. Times are given in milliseconds.
+        * \param[out] os the output stream
+        */
+      void
+      writeJSON (std::ostream &os) const;
+
+      /** \brief Write the recorded scopes in the Trace Event Format, which can be loaded in
+        * chrome://tracing. Counters are given as arguments of the scopes.
+        * \param[out] os the output stream
+        */
+      void
+      writeChromeTrace (std::ostream &os) const;
+
+      /** \brief Save the JSON report (see \ref writeJSON) to a file.
+        * \param[in] file_name the name of the file
+        * \return false if the file could not be written
+        */
+      bool
+      saveJSON (const std::string &file_name) const;
+
+      /** \brief Save the Chrome trace (see \ref writeChromeTrace) to a file.
+        * \param[in] file_name the name of the file
+        * \return false if the file could not be written
+        */
+      bool
+      saveChromeTrace (const std::string &file_name) const;
+
+    protected:
+      struct ThreadData;
+
+      Profiler ();
+
+      /** \brief Get the data of the calling thread, created on first use. */
+      ThreadData&
+      getThreadData ();
+
+      /** \brief Get the time since \a epoch_, in microseconds. */
+      double
+      getTimestamp () const;
+
+      /** \brief True when the scopes and counters are recorded. */
+      static bool enabled_;
+
+      /** \brief The data of all the threads which have used the profiler. */
+      std::vector<boost::shared_ptr<ThreadData> > threads_;
+
+      /** \brief The origin of the timestamps. */
+      boost::posix_time::ptime epoch_;
+
+      /** \brief True if the individual scopes are recorded. */
+      bool trace_enabled_;
+
+      /** \brief The maximum number of individual scopes recorded per thread. */
+      size_t max_trace_events_;
+
+      /** \brief Protects the list of threads and the settings. */
+      mutable boost::mutex mutex_;
+
+      /** \brief The data of the calling thread, shared with \a threads_. */
+      boost::thread_specific_ptr<boost::shared_ptr<ThreadData> > thread_data_;
+
+    private:
+      Profiler (const Profiler&);
+      Profiler& operator = (const Profiler&);
+  };
+
+  /** \brief Open a profiler scope in its constructor and close it in its destructor, if the
+    * profiler is enabled. Usually created with the PCL_PROFILE_SCOPE macros.
+    * \ingroup common
+    */
+  class ProfileScope
+  {
+    public:
+      /** \brief Open the scope \a name. */
+      explicit inline
+      ProfileScope (const char* name) : active_ (Profiler::isEnabled ())
+      {
+        if (active_)
+          Profiler::getInstance ().beginScope (name);
+      }
+
+      /** \brief Open the scope "<prefix>::<name>". */
+      inline
+      ProfileScope (const std::string &prefix, const char* name) : active_ (Profiler::isEnabled ())
+      {
+        if (active_)
+          Profiler::getInstance ().beginScope (prefix, name);
+      }
+
+      inline
+      ~ProfileScope ()
+      {
+        if (active_)
+          Profiler::getInstance ().endScope ();
+      }
+
+    private:
+      /** \brief True if the scope was opened, even if the profiler was disabled since. */
+      bool active_;
+
+      ProfileScope (const ProfileScope&);
+      ProfileScope& operator = (const ProfileScope&);
+  };
+}
+
+#define PCL_PROFILE_JOIN_(a, b) a ## b
+#define PCL_PROFILE_JOIN(a, b) PCL_PROFILE_JOIN_(a, b)
+
+#ifdef PCL_NO_PROFILING
+#  define PCL_PROFILE_SCOPE(name)
+#  define PCL_PROFILE_METHOD_SCOPE(class_name, method)
+#  define PCL_PROFILE_COUNTER(name, value)
+#else
+/** \brief Profile the enclosing scope under \a name (a string literal). */
+#  define PCL_PROFILE_SCOPE(name) \
+  ::pcl::ProfileScope PCL_PROFILE_JOIN (pcl_profile_scope_, __LINE__) (name)
+/** \brief Profile the enclosing scope under "<class_name>::<method>", e.g. with getClassName ().
+  * \a class_name is only evaluated if the profiler is enabled. */
+#  define PCL_PROFILE_METHOD_SCOPE(class_name, method) \
+  ::pcl::ProfileScope PCL_PROFILE_JOIN (pcl_profile_scope_, __LINE__) ( \
+    ::pcl::Profiler::isEnabled () ? std::string (class_name) : std::string (), method)
+/** \brief Add \a value to the counter \a name of the innermost scope. \a value is only evaluated if the profiler is enabled. */
+#  define PCL_PROFILE_COUNTER(name, value) \
+  do { if (::pcl::Profiler::isEnabled ()) ::pcl::Profiler::getInstance ().addCounter (name, static_cast<double> (value)); } while (0)
+#endif
+
+#endif  // PCL_COMMON_PROFILER_H_
@@ -0,0 +1,87 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef PCL_COMMON_QUANTIZATION_H_
+#define PCL_COMMON_QUANTIZATION_H_
+
+#include <pcl/point_cloud.h>
+#include <pcl/point_types.h>
+
+/**
+  * \file pcl/common/quantization.h
+  * Define methods for the conversion between metric and quantized point coordinates
+  * \ingroup common
+  */
+
+/*@{*/
+namespace pcl
+{
+  /** \brief Quantize the xyz coordinates of a point cloud on 16 bits per axis,
+    * relative to the origin of a tile. A coordinate c is stored as the integer
+    * nearest to (c - origin) / step, so that the tile spans 65536 steps per axis.
+    * \param[in] cloud_in the input point cloud
+    * \param[in] origin the origin of the tile
+    * \param[in] step the quantization step, in meters
+    * \param[out] cloud_out the quantized point cloud
+    * \return the number of points which could not be quantized (non finite, or
+    * outside of the tile), and were dropped. The output cloud is organized like
+    * the input cloud if no point was dropped.
+    * \ingroup common
+    */
+  template <typename PointT> size_t
+  quantizePointCloud (const pcl::PointCloud<PointT> &cloud_in,
+                      const Eigen::Vector3f &origin, float step,
+                      pcl::PointCloud<pcl::PointXYZQuantized> &cloud_out);
+
+  /** \brief Convert quantized xyz coordinates back to metric coordinates. The
+    * other fields of the output points are default constructed.
+    * \param[in] cloud_in the quantized point cloud
+    * \param[in] origin the origin of the tile, as given to quantizePointCloud
+    * \param[in] step the quantization step, as given to quantizePointCloud
+    * \param[out] cloud_out the output point cloud
+    * \ingroup common
+    */
+  template <typename PointT> void
+  dequantizePointCloud (const pcl::PointCloud<pcl::PointXYZQuantized> &cloud_in,
+                        const Eigen::Vector3f &origin, float step,
+                        pcl::PointCloud<PointT> &cloud_out);
+}
+/*@}*/
+#include <pcl/common/impl/quantization.hpp>
+
+#endif  //#ifndef PCL_COMMON_QUANTIZATION_H_
@@ -0,0 +1,346 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_COMMON_TASK_SCHEDULER_H_
+#define PCL_COMMON_TASK_SCHEDULER_H_
+
+#include <pcl/pcl_macros.h>
+#include <boost/detail/atomic_count.hpp>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/condition_variable.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/tss.hpp>
+
+#include <deque>
+#include <vector>
+
+namespace pcl
+{
+  /** \brief A unit of work run by the \ref TaskScheduler.
+    * \ingroup common
+    */
+  class PCL_EXPORTS Task
+  {
+    public:
+      /** \brief Empty destructor. */
+      virtual ~Task () {}
+
+      /** \brief Run the task. It must not throw: as with OpenMP, an exception escaping a task which
+        * runs on a worker thread terminates the program.
+        */
+      virtual void
+      execute () = 0;
+  };
+
+  /** \brief A set of tasks spawned together and waited for together.
+    *
+    * The tasks are not owned by the group: they must stay valid until \ref wait returns.
+    * \ingroup common
+    */
+  class PCL_EXPORTS TaskGroup
+  {
+    public:
+      /** \brief Empty constructor. */
+      TaskGroup () : pending_ (0) {}
+
+      /** \brief Destructor. Waits for the tasks which are still running. */
+      ~TaskGroup ();
+
+      /** \brief Queue a task on the scheduler. */
+      void
+      spawn (Task &task);
+
+      /** \brief Wait until all the spawned tasks are done, running queued tasks in the meantime. */
+      void
+      wait ();
+
+    private:
+      /** \brief The number of tasks which are spawned but not done. */
+      boost::detail::atomic_count pending_;
+
+      TaskGroup (const TaskGroup&);
+      TaskGroup& operator = (const TaskGroup&);
+
+      friend class TaskScheduler;
+  };
+
+  /** \brief Work-stealing thread pool shared by the parallel algorithms of PCL.
+    *
+    * The scheduler owns \ref getNumberOfThreads - 1 worker threads, which are started on first use. Every
+    * worker has its own queue of tasks: it runs the tasks it spawns last in first out, and steals the oldest
+    * tasks of the other queues when its own one is empty. The threads which are not workers (the threads of
+    * the application) spawn their tasks in a shared queue.
+    *
+    * A thread which waits for tasks (\ref TaskGroup::wait) runs queued tasks instead of blocking. Nested
+    * parallel loops therefore run on the same threads as the outer loop, and several application threads
+    * which run parallel PCL algorithms concurrently share the workers: the number of running threads is
+    * bounded by the number of workers plus the number of application threads, whereas every OpenMP parallel
+    * region starts its own team of threads.
+    *
+    * Most code uses \ref parallel_for and \ref parallel_reduce rather than the scheduler itself:
+    * \code
+    * pcl::TaskScheduler::getInstance ().setNumberOfThreads (4);   // optional, once at startup
+    * pcl::parallel_for (0, n, body);
+    * \endcode
+    * \ingroup common
+    */
+  class PCL_EXPORTS TaskScheduler
+  {
+    public:
+      /** \brief Get the scheduler of the process. */
+      static TaskScheduler&
+      getInstance ();
+
+      /** \brief Destructor. Stops the worker threads. */
+      ~TaskScheduler ();
+
+      /** \brief Set the number of threads which run the parallel algorithms, including the calling thread.
+        * \note Must not be called while tasks are running.
+        * \param[in] nr_threads the number of threads (0 sets the value back to the number of cores)
+        */
+      void
+      setNumberOfThreads (unsigned int nr_threads = 0);
+
+      /** \brief Get the number of threads which run the parallel algorithms, including the calling thread. */
+      inline unsigned int
+      getNumberOfThreads () const
+      {
+        return (nr_threads_);
+      }
+
+      /** \brief Return true if the calling thread is a worker of the scheduler. */
+      bool
+      isWorkerThread () const;
+
+    protected:
+      /** \brief A queued task, and the group waiting for it. */
+      struct Item
+      {
+        Item () : task (), group () {}
+        Item (Task *t, TaskGroup *g) : task (t), group (g) {}
+
+        Task *task;
+        TaskGroup *group;
+      };
+
+      /** \brief The queue of a worker, or the shared queue of the other threads. */
+      struct Queue
+      {
+        Queue () : items (), mutex () {}
+
+        std::deque<Item> items;
+        boost::mutex mutex;
+      };
+
+      /** \brief Constructor, for \ref getInstance. */
+      TaskScheduler ();
+
+      /** \brief Queue a task in the queue of the calling thread, and wake up a worker. */
+      void
+      spawn (Task &task, TaskGroup &group);
+
+      /** \brief Run one queued task: the newest one of the queue of the calling thread, or else the oldest
+        * one of another queue.
+        * \return false if all the queues are empty
+        */
+      bool
+      runOneTask ();
+
+      /** \brief Start the workers, if they are not running. */
+      void
+      start ();
+
+      /** \brief Stop and join the workers. */
+      void
+      stop ();
+
+      /** \brief Main loop of a worker thread. */
+      void
+      runWorker (size_t index);
+
+      /** \brief The index of the queue of the calling thread. */
+      size_t
+      getQueueIndex () const;
+
+      /** \brief The number of threads, including the calling thread. */
+      unsigned int nr_threads_;
+
+      /** \brief One queue per worker, followed by the shared queue. */
+      std::vector<boost::shared_ptr<Queue> > queues_;
+
+      /** \brief The worker threads. */
+      std::vector<boost::shared_ptr<boost::thread> > workers_;
+
+      /** \brief The index of the queue of the worker threads, not set for the other threads. */
+      boost::thread_specific_ptr<size_t> worker_index_;
+
+      /** \brief The number of queued tasks, which the workers wait for. */
+      boost::detail::atomic_count nr_queued_;
+
+      /** \brief Set to true to make the workers exit. */
+      bool stopping_;
+
+      /** \brief Protects the sleep of the workers, and the start and stop of the pool. */
+      boost::mutex mutex_;
+
+      /** \brief Signaled when a task is queued or the workers are stopped. */
+      boost::condition_variable wake_;
+
+      friend class TaskGroup;
+
+    private:
+      TaskScheduler (const TaskScheduler&);
+      TaskScheduler& operator = (const TaskScheduler&);
+  };
+
+  /** \brief Run \a body on sub-ranges of [begin, end) on the threads of the \ref TaskScheduler.
+    *
+    * \a body is a functor with a <tt>void operator () (int begin, int end) const</tt>, called concurrently on
+    * disjoint sub-ranges of grain_size iterations, which are given to the threads dynamically. The calling
+    * thread takes part in the loop, and nested calls are allowed.
+    * \code
+    * struct Scale
+    * {
+    *   void operator () (int begin, int end) const { for (int i = begin; i < end; ++i) data[i] *= s; }
+    *   float *data;
+    *   float s;
+    * };
+    * pcl::parallel_for (0, n, scale);
+    * \endcode
+    * \param[in] begin the first iteration
+    * \param[in] end the iteration after the last one
+    * \param[in] body the functor run on the sub-ranges
+    * \param[in] grain_size the number of iterations of the sub-ranges (0 picks about 8 sub-ranges per thread)
+    * \param[in] nr_threads the maximum number of threads running the loop (0 for all the threads of the scheduler)
+    * \ingroup common
+    */
+  template <typename Body> void
+  parallel_for (int begin, int end, const Body &body, int grain_size = 0, unsigned int nr_threads = 0);
+
+  /** \brief Run \a body on sub-ranges of [begin, end) on the threads of the \ref TaskScheduler, and combine
+    * the partial results into \a body.
+    *
+    * \a body is a functor with a <tt>void operator () (int begin, int end)</tt> which accumulates the
+    * iterations of a sub-range, and a <tt>void join (const Body &other)</tt> which adds the result of another
+    * copy. Every thread taking part in the loop accumulates into a copy of \a body made before the loop starts,
+    * so \a body must be the identity of the reduction when it is passed. The copies are joined into \a body in
+    * the order of the threads, and the sub-ranges are given to the threads dynamically: floating point
+    * reductions may differ in the last bits from one run to the next.
+    * \param[in] begin the first iteration
+    * \param[in] end the iteration after the last one
+    * \param[in,out] body the functor run on the sub-ranges, which holds the result
+    * \param[in] grain_size the number of iterations of the sub-ranges (0 picks about 8 sub-ranges per thread)
+    * \param[in] nr_threads the maximum number of threads running the loop (0 for all the threads of the scheduler)
+    * \ingroup common
+    */
+  template <typename Body> void
+  parallel_reduce (int begin, int end, Body &body, int grain_size = 0, unsigned int nr_threads = 0);
+
+  /** \brief Body of \ref parallel_for which calls <tt>(object.*method) (begin, end, arg)</tt>, so that a class
+    * runs one of its methods in parallel without writing a functor. Built with \ref makeRangeMethod.
+    * \ingroup common
+    */
+  template <typename Class, typename Arg>
+  class RangeMethod
+  {
+    public:
+      typedef void (Class::*Method) (int, int, Arg&);
+
+      RangeMethod (Class &object, Method method, Arg &arg) : object_ (&object), method_ (method), arg_ (&arg) {}
+
+      inline void
+      operator () (int begin, int end) const
+      {
+        (object_->*method_) (begin, end, *arg_);
+      }
+
+    private:
+      Class *object_;
+      Method method_;
+      Arg *arg_;
+  };
+
+  /** \brief Body of \ref parallel_for which calls the const method <tt>(object.*method) (begin, end, arg)</tt>.
+    * Built with \ref makeRangeMethod.
+    * \ingroup common
+    */
+  template <typename Class, typename Arg>
+  class ConstRangeMethod
+  {
+    public:
+      typedef void (Class::*Method) (int, int, Arg&) const;
+
+      ConstRangeMethod (const Class &object, Method method, Arg &arg) : object_ (&object), method_ (method), arg_ (&arg) {}
+
+      inline void
+      operator () (int begin, int end) const
+      {
+        (object_->*method_) (begin, end, *arg_);
+      }
+
+    private:
+      const Class *object_;
+      Method method_;
+      Arg *arg_;
+  };
+
+  /** \brief Build a \ref RangeMethod body, e.g.
+    * <tt>pcl::parallel_for (0, n, pcl::makeRangeMethod (*this, &MyClass::computeRange, output))</tt>
+    * \ingroup common
+    */
+  template <typename Class, typename Arg> inline RangeMethod<Class, Arg>
+  makeRangeMethod (Class &object, void (Class::*method) (int, int, Arg&), Arg &arg)
+  {
+    return (RangeMethod<Class, Arg> (object, method, arg));
+  }
+
+  /** \brief Build a \ref ConstRangeMethod body.
+    * \ingroup common
+    */
+  template <typename Class, typename Arg> inline ConstRangeMethod<Class, Arg>
+  makeRangeMethod (const Class &object, void (Class::*method) (int, int, Arg&) const, Arg &arg)
+  {
+    return (ConstRangeMethod<Class, Arg> (object, method, arg));
+  }
+}
+
+#include <pcl/common/impl/task_scheduler.hpp>
+
+#endif  // PCL_COMMON_TASK_SCHEDULER_H_
@@ -41,6 +41,7 @@
 #include <cmath>
 #include <string>
 #include <pcl/common/boost.h>
+#include <pcl/common/profiler.h>
 
 /**
   * \file pcl/common/time.h
@@ -105,6 +106,9 @@ namespace pcl
     * }
     * \endcode
     *
+    * When pcl::Profiler is enabled, the scope is recorded by the profiler, which reports it together
+    * with the scopes of the library, instead of being printed (unless PCL_NO_PROFILING is defined).
+    *
     * \ingroup common
     */
   class ScopeTime : public StopWatch
@@ -112,24 +116,37 @@ namespace pcl
     public:
       inline ScopeTime (const char* title) : 
         title_ (std::string (title))
+#ifndef PCL_NO_PROFILING
+        , profile_scope_ (title)
+#endif
       {
         start_time_ = boost::posix_time::microsec_clock::local_time ();
       }
 
       inline ScopeTime () :
         title_ (std::string (""))
+#ifndef PCL_NO_PROFILING
+        , profile_scope_ ("ScopeTime")
+#endif
       {
         start_time_ = boost::posix_time::microsec_clock::local_time ();
       }
 
       inline ~ScopeTime ()
       {
+#ifndef PCL_NO_PROFILING
+        if (Profiler::isEnabled ())
+          return;
+#endif
         double val = this->getTime ();
         std::cerr << title_ << " took " << val << "ms.\n";
       }
 
     private:
       std::string title_;
+#ifndef PCL_NO_PROFILING
+      ProfileScope profile_scope_;
+#endif
   };
 
 
@@ -37,6 +37,7 @@
 #define PCL_TRANSFORMS_H_
 
 #include <pcl/point_cloud.h>
+#include <pcl/point_cloud_soa.h>
 #include <pcl/point_types.h>
 #include <pcl/common/centroid.h>
 #include <pcl/common/eigen.h>
@@ -47,12 +48,39 @@ namespace pcl
     * \param cloud_in the input point cloud
     * \param cloud_out the resultant output point cloud
     * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (1 by default, 0 for automatic)
     * \note Can be used with cloud_in equal to cloud_out
+    * \note The point types with padded coordinates (PCL_ADD_POINT4D) are transformed with SSE
     * \ingroup common
     */
   template <typename PointT> void 
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        pcl::PointCloud<PointT> &cloud_out, 
+                       const Eigen::Affine3f &transform,
+                       unsigned int nr_threads = 1);
+
+  /** \brief Apply an affine transform defined by an Eigen Transform to a point cloud, in place
+    * \param cloud the point cloud to transform
+    * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (1 by default, 0 for automatic)
+    * \ingroup common
+    */
+  template <typename PointT> void 
+  transformPointCloud (pcl::PointCloud<PointT> &cloud, 
+                       const Eigen::Affine3f &transform,
+                       unsigned int nr_threads = 1);
+
+  /** \brief Apply an affine transform defined by an Eigen Transform to a
+    * structure of arrays (SSE version). The channels are copied unchanged.
+    * \param[in] cloud_in the input point cloud
+    * \param[out] cloud_out the resultant output point cloud
+    * \param[in] transform an affine transformation (typically a rigid transformation)
+    * \note Can be used with cloud_in equal to cloud_out
+    * \ingroup common
+    */
+  PCL_EXPORTS void
+  transformPointCloud (const pcl::PointCloudSoA &cloud_in,
+                       pcl::PointCloudSoA &cloud_out,
                        const Eigen::Affine3f &transform);
 
   /** \brief Apply an affine transform defined by an Eigen Transform
@@ -60,6 +88,7 @@ namespace pcl
     * \param indices the set of point indices to use from the input point cloud
     * \param cloud_out the resultant output point cloud
     * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (1 by default, 0 for automatic)
     * \note Can be used with cloud_in equal to cloud_out
     * \ingroup common
     */
@@ -67,42 +96,75 @@ namespace pcl
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        const std::vector<int> &indices, 
                        pcl::PointCloud<PointT> &cloud_out, 
-                       const Eigen::Affine3f &transform);
+                       const Eigen::Affine3f &transform,
+                       unsigned int nr_threads = 1);
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
     * \param cloud_in the input point cloud
     * \param cloud_out the resultant output point cloud
     * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (1 by default, 0 for automatic)
+    * \note Can be used with cloud_in equal to cloud_out
+    * \note The points and the normals are transformed in a single pass, with SSE for the padded ones
+    */
+  template <typename PointT> void 
+  transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
+                                  pcl::PointCloud<PointT> &cloud_out, 
+                                  const Eigen::Affine3f &transform,
+                                  unsigned int nr_threads = 1);
+
+  /** \brief Transform a point cloud and rotate its normals using an Eigen transform, in place.
+    * \param cloud the point cloud to transform
+    * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (1 by default, 0 for automatic)
+    */
+  template <typename PointT> void 
+  transformPointCloudWithNormals (pcl::PointCloud<PointT> &cloud, 
+                                  const Eigen::Affine3f &transform,
+                                  unsigned int nr_threads = 1);
+
+  /** \brief Transform a subset of a point cloud and rotate its normals using an Eigen transform.
+    * \param cloud_in the input point cloud
+    * \param indices the set of point indices to use from the input point cloud
+    * \param cloud_out the resultant output point cloud
+    * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (1 by default, 0 for automatic)
     * \note Can be used with cloud_in equal to cloud_out
     */
   template <typename PointT> void 
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
+                                  const std::vector<int> &indices, 
                                   pcl::PointCloud<PointT> &cloud_out, 
-                                  const Eigen::Affine3f &transform);
+                                  const Eigen::Affine3f &transform,
+                                  unsigned int nr_threads = 1);
 
   /** \brief Apply an affine transform defined by an Eigen Transform
     * \param cloud_in the input point cloud
     * \param cloud_out the resultant output point cloud
     * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (1 by default, 0 for automatic)
     * \note Can be used with cloud_in equal to cloud_out
     * \ingroup common
     */
   template <typename PointT> void 
   transformPointCloud (const pcl::PointCloud<PointT> &cloud_in, 
                        pcl::PointCloud<PointT> &cloud_out, 
-                       const Eigen::Matrix4f &transform);
+                       const Eigen::Matrix4f &transform,
+                       unsigned int nr_threads = 1);
 
   /** \brief Transform a point cloud and rotate its normals using an Eigen transform.
     * \param cloud_in the input point cloud
     * \param cloud_out the resultant output point cloud
     * \param transform an affine transformation (typically a rigid transformation)
+    * \param nr_threads the number of threads to use (1 by default, 0 for automatic)
     * \note Can be used with cloud_in equal to cloud_out
     * \ingroup common
     */
   template <typename PointT> void 
   transformPointCloudWithNormals (const pcl::PointCloud<PointT> &cloud_in, 
                                   pcl::PointCloud<PointT> &cloud_out, 
-                                  const Eigen::Matrix4f &transform);
+                                  const Eigen::Matrix4f &transform,
+                                  unsigned int nr_threads = 1);
 
   /** \brief Apply a rigid transform defined by a 3D offset and a quaternion
     * \param cloud_in the input point cloud
@@ -0,0 +1,145 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef PCL_IMPL_POINT_CLOUD_SOA_HPP_
+#define PCL_IMPL_POINT_CLOUD_SOA_HPP_
+
+#include <pcl/point_traits.h>
+#include <pcl/for_each_type.h>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Find the offset of a float field of a point type, or -1. */
+    template <typename PointT>
+    struct FloatFieldOffset
+    {
+      FloatFieldOffset (const std::string &name, int &offset) : name_ (name), offset_ (offset)
+      {
+        offset_ = -1;
+      }
+
+      template <typename Key> inline void
+      operator () ()
+      {
+        if (name_ == pcl::traits::name<PointT, Key>::value &&
+            pcl::traits::datatype<PointT, Key>::value == sensor_msgs::PointField::FLOAT32 &&
+            pcl::traits::datatype<PointT, Key>::size == 1)
+          offset_ = pcl::traits::offset<PointT, Key>::value;
+      }
+
+      const std::string &name_;
+      int &offset_;
+    };
+
+    template <typename PointT> inline int
+    getFloatFieldOffset (const std::string &name)
+    {
+      typedef typename pcl::traits::fieldList<PointT>::type FieldList;
+      int offset;
+      pcl::for_each_type<FieldList> (FloatFieldOffset<PointT> (name, offset));
+      return (offset);
+    }
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::copyPointCloud (const pcl::PointCloud<PointT> &cloud_in, pcl::PointCloudSoA &cloud_out)
+{
+  cloud_out.header = cloud_in.header;
+  cloud_out.resize (cloud_in.points.size ());
+  cloud_out.width = cloud_in.width;
+  cloud_out.height = cloud_in.height;
+  cloud_out.is_dense = cloud_in.is_dense;
+
+  const size_t nr_points = cloud_in.points.size ();
+  for (size_t i = 0; i < nr_points; ++i)
+  {
+    cloud_out.x[i] = cloud_in.points[i].x;
+    cloud_out.y[i] = cloud_in.points[i].y;
+    cloud_out.z[i] = cloud_in.points[i].z;
+  }
+
+  const std::vector<std::string> names = cloud_out.getChannelNames ();
+  for (size_t c = 0; c < names.size (); ++c)
+  {
+    const int offset = detail::getFloatFieldOffset<PointT> (names[c]);
+    if (offset < 0)
+    {
+      cloud_out.removeChannel (names[c]);
+      continue;
+    }
+    pcl::PointCloudSoA::Channel &channel = *cloud_out.getChannel (names[c]);
+    for (size_t i = 0; i < nr_points; ++i)
+      memcpy (&channel[i], reinterpret_cast<const uint8_t*> (&cloud_in.points[i]) + offset, sizeof (float));
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::copyPointCloud (const pcl::PointCloudSoA &cloud_in, pcl::PointCloud<PointT> &cloud_out)
+{
+  cloud_out.header = cloud_in.header;
+  cloud_out.points.resize (cloud_in.size ());
+  cloud_out.width = cloud_in.width;
+  cloud_out.height = cloud_in.height;
+  cloud_out.is_dense = cloud_in.is_dense;
+
+  const size_t nr_points = cloud_in.size ();
+  for (size_t i = 0; i < nr_points; ++i)
+  {
+    cloud_out.points[i].x = cloud_in.x[i];
+    cloud_out.points[i].y = cloud_in.y[i];
+    cloud_out.points[i].z = cloud_in.z[i];
+  }
+
+  const std::vector<std::string> names = cloud_in.getChannelNames ();
+  for (size_t c = 0; c < names.size (); ++c)
+  {
+    const int offset = detail::getFloatFieldOffset<PointT> (names[c]);
+    if (offset < 0)
+      continue;
+    const pcl::PointCloudSoA::Channel &channel = *cloud_in.getChannel (names[c]);
+    for (size_t i = 0; i < nr_points; ++i)
+      memcpy (reinterpret_cast<uint8_t*> (&cloud_out.points[i]) + offset, &channel[i], sizeof (float));
+  }
+}
+
+#endif  //#ifndef PCL_IMPL_POINT_CLOUD_SOA_HPP_
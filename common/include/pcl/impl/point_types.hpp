@@ -135,6 +135,15 @@
   (pcl::BRISKSignature512)      \
   (pcl::Narf36)
 
+// Define all compact point types, which have no SSE padding. They are kept out
+// of PCL_POINT_TYPES and PCL_XYZ_POINT_TYPES, as most algorithms use the
+// aligned getVector4fMap () of the padded types.
+#define PCL_COMPACT_POINT_TYPES   \
+  (pcl::PointXYZPacked)           \
+  (pcl::PointXYZRGBPacked)        \
+  (pcl::PointXYZRGBNormalPacked)  \
+  (pcl::PointXYZQuantized)
+
 namespace pcl
 {
 
@@ -173,6 +182,32 @@ namespace pcl
   inline Eigen::Map<Eigen::Vector4f, Eigen::Aligned> getNormalVector4fMap () { return (Eigen::Vector4f::MapAligned (data_n)); } \
   inline const Eigen::Map<const Eigen::Vector4f, Eigen::Aligned> getNormalVector4fMap () const { return (Eigen::Vector4f::MapAligned (data_n)); }
 
+#define PCL_ADD_POINT3D \
+  union { \
+    float data[3]; \
+    struct { \
+      float x; \
+      float y; \
+      float z; \
+    }; \
+  }; \
+  inline Eigen::Map<Eigen::Vector3f> getVector3fMap () { return (Eigen::Vector3f::Map (data)); } \
+  inline const Eigen::Map<const Eigen::Vector3f> getVector3fMap () const { return (Eigen::Vector3f::Map (data)); } \
+  inline Eigen::Map<Eigen::Array3f> getArray3fMap () { return (Eigen::Array3f::Map (data)); } \
+  inline const Eigen::Map<const Eigen::Array3f> getArray3fMap () const { return (Eigen::Array3f::Map (data)); }
+
+#define PCL_ADD_NORMAL3D \
+  union { \
+    float normal[3]; \
+    struct { \
+      float normal_x; \
+      float normal_y; \
+      float normal_z; \
+    }; \
+  }; \
+  inline Eigen::Map<Eigen::Vector3f> getNormalVector3fMap () { return (Eigen::Vector3f::Map (normal)); } \
+  inline const Eigen::Map<const Eigen::Vector3f> getNormalVector3fMap () const { return (Eigen::Vector3f::Map (normal)); }
+
 #define PCL_ADD_RGB \
   union \
   { \
@@ -1554,6 +1589,144 @@ namespace pcl
     return (os);
   }
 
+  /** \brief A point structure representing Euclidean xyz coordinates, without
+    * the SSE padding of PointXYZ (12 bytes instead of 16).
+    * \ingroup common
+    */
+  struct _PointXYZPacked
+  {
+    PCL_ADD_POINT3D; // This adds the members x,y,z which can also be accessed using the point (which is float[3])
+  };
+
+  struct PointXYZPacked : public _PointXYZPacked
+  {
+    inline PointXYZPacked (const _PointXYZPacked &p)
+    {
+      x = p.x; y = p.y; z = p.z;
+    }
+
+    inline PointXYZPacked ()
+    {
+      x = y = z = 0.0f;
+    }
+
+    inline PointXYZPacked (float _x, float _y, float _z)
+    {
+      x = _x; y = _y; z = _z;
+    }
+  };
+
+  inline std::ostream& operator << (std::ostream& os, const PointXYZPacked& p)
+  {
+    os << "(" << p.x << "," << p.y << "," << p.z << ")";
+    return (os);
+  }
+
+  /** \brief A point structure representing Euclidean xyz coordinates and the
+    * RGB color, without the SSE padding of PointXYZRGB (16 bytes instead of 32).
+    * \ingroup common
+    */
+  struct _PointXYZRGBPacked
+  {
+    PCL_ADD_POINT3D; // This adds the members x,y,z which can also be accessed using the point (which is float[3])
+    PCL_ADD_RGB;
+  };
+
+  struct PointXYZRGBPacked : public _PointXYZRGBPacked
+  {
+    inline PointXYZRGBPacked (const _PointXYZRGBPacked &p)
+    {
+      x = p.x; y = p.y; z = p.z;
+      rgba = p.rgba;
+    }
+
+    inline PointXYZRGBPacked ()
+    {
+      x = y = z = 0.0f;
+      r = g = b = 0;
+      a = 255;
+    }
+  };
+
+  inline std::ostream& operator << (std::ostream& os, const PointXYZRGBPacked& p)
+  {
+    os << "(" << p.x << "," << p.y << "," << p.z << " - "
+      << static_cast<int>(p.r) << ","
+      << static_cast<int>(p.g) << ","
+      << static_cast<int>(p.b) << ")";
+    return (os);
+  }
+
+  /** \brief A point structure representing Euclidean xyz coordinates, the RGB
+    * color, the normal coordinates and the surface curvature estimate, without
+    * the SSE padding of PointXYZRGBNormal (32 bytes instead of 48).
+    * \ingroup common
+    */
+  struct _PointXYZRGBNormalPacked
+  {
+    PCL_ADD_POINT3D; // This adds the members x,y,z which can also be accessed using the point (which is float[3])
+    PCL_ADD_RGB;
+    PCL_ADD_NORMAL3D; // This adds the member normal[3]
+    float curvature;
+  };
+
+  struct PointXYZRGBNormalPacked : public _PointXYZRGBNormalPacked
+  {
+    inline PointXYZRGBNormalPacked (const _PointXYZRGBNormalPacked &p)
+    {
+      x = p.x; y = p.y; z = p.z;
+      rgba = p.rgba;
+      normal_x = p.normal_x; normal_y = p.normal_y; normal_z = p.normal_z;
+      curvature = p.curvature;
+    }
+
+    inline PointXYZRGBNormalPacked ()
+    {
+      x = y = z = 0.0f;
+      r = g = b = 0;
+      a = 255;
+      normal_x = normal_y = normal_z = 0.0f;
+      curvature = 0.0f;
+    }
+  };
+
+  inline std::ostream& operator << (std::ostream& os, const PointXYZRGBNormalPacked& p)
+  {
+    os << "(" << p.x << "," << p.y << "," << p.z << " - "
+      << static_cast<int>(p.r) << ","
+      << static_cast<int>(p.g) << ","
+      << static_cast<int>(p.b) << " - "
+      << p.normal_x << "," << p.normal_y << "," << p.normal_z << " - " << p.curvature << ")";
+    return (os);
+  }
+
+  /** \brief A point structure representing xyz coordinates quantized on 16 bits
+    * per axis (6 bytes), relative to the origin of a tile and in units of a
+    * quantization step, which are kept by the application.
+    *
+    * See pcl::quantizePointCloud and pcl::dequantizePointCloud in
+    * pcl/common/quantization.h for the conversion from and to metric coordinates.
+    * The algorithms instantiated for PointXYZQuantized (VoxelGrid,
+    * KdTreeFLANN) work in quantization steps.
+    * \ingroup common
+    */
+  struct PointXYZQuantized
+  {
+    int16_t x;
+    int16_t y;
+    int16_t z;
+
+    inline PointXYZQuantized () : x (0), y (0), z (0) {}
+
+    inline PointXYZQuantized (int16_t _x, int16_t _y, int16_t _z) : x (_x), y (_y), z (_z) {}
+  };
+
+  inline std::ostream& operator << (std::ostream& os, const PointXYZQuantized& p)
+  {
+    os << "(" << p.x << "," << p.y << "," << p.z << ")";
+    return (os);
+  }
+
 } // End namespace
 
 // Preserve API for PCL users < 1.4
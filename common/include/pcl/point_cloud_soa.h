@@ -0,0 +1,174 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#ifndef PCL_POINT_CLOUD_SOA_H_
+#define PCL_POINT_CLOUD_SOA_H_
+
+#include <pcl/point_cloud.h>
+#include <string>
+#include <vector>
+#include <utility>
+
+namespace pcl
+{
+  /** \brief PointCloudSoA stores a point cloud as a structure of arrays: one
+    * contiguous array per coordinate, plus optional attribute arrays
+    * (channels) named after the float fields of the point types.
+    *
+    * Unlike the array of structures of pcl::PointCloud<PointT>, the kernels
+    * operating on a PointCloudSoA load 4 consecutive x (or y, z) with a single
+    * aligned SSE load. The arrays are 16 bytes aligned.
+    *
+    * Conversions from and to pcl::PointCloud<PointT> are done with
+    * pcl::copyPointCloud. The SIMD kernels are overloads of the common
+    * functions: pcl::getMinMax3D, pcl::compute3DCentroid,
+    * pcl::transformPointCloud, pcl::getPlaneDistances and
+    * pcl::getSquaredDistances.
+    * \ingroup common
+    */
+  class PCL_EXPORTS PointCloudSoA
+  {
+    public:
+      /** \brief An aligned array of floats, holding one value per point. */
+      typedef std::vector<float, Eigen::aligned_allocator<float> > Channel;
+
+      PointCloudSoA () : header (), x (), y (), z (), width (0), height (0), is_dense (true), channels_ ()
+      {}
+
+      /** \brief The point cloud header. */
+      std_msgs::Header header;
+
+      /** \brief The x coordinates of the points. */
+      Channel x;
+      /** \brief The y coordinates of the points. */
+      Channel y;
+      /** \brief The z coordinates of the points. */
+      Channel z;
+
+      /** \brief The point cloud width (if organized as an image-structure). */
+      uint32_t width;
+      /** \brief The point cloud height (if organized as an image-structure). */
+      uint32_t height;
+
+      /** \brief True if no points are invalid (e.g., have NaN or Inf values). */
+      bool is_dense;
+
+      /** \brief Return the number of points. */
+      inline size_t
+      size () const { return (x.size ()); }
+
+      /** \brief Return true if the cloud has no point. */
+      inline bool
+      empty () const { return (x.empty ()); }
+
+      /** \brief Resize the coordinate arrays and all the channels. The cloud
+        * becomes unorganized (height = 1).
+        * \param[in] n the new number of points
+        */
+      void
+      resize (size_t n);
+
+      /** \brief Remove all the points, keeping the channels. */
+      inline void
+      clear () { resize (0); }
+
+      /** \brief Add a channel, sized to the number of points. Does nothing if
+        * the channel exists already.
+        * \param[in] name the name of the channel, e.g. "intensity"
+        * \return the channel
+        */
+      Channel&
+      addChannel (const std::string &name);
+
+      /** \brief Get a channel.
+        * \param[in] name the name of the channel
+        * \return the channel, or NULL if it does not exist
+        */
+      Channel*
+      getChannel (const std::string &name);
+
+      /** \brief Get a channel.
+        * \param[in] name the name of the channel
+        * \return the channel, or NULL if it does not exist
+        */
+      const Channel*
+      getChannel (const std::string &name) const;
+
+      /** \brief Remove a channel.
+        * \param[in] name the name of the channel
+        */
+      void
+      removeChannel (const std::string &name);
+
+      /** \brief Get the names of the channels. */
+      std::vector<std::string>
+      getChannelNames () const;
+
+      /** \brief Swap the content of two clouds. */
+      void
+      swap (PointCloudSoA &cloud);
+
+    protected:
+      /** \brief The channels, by name. A vector, as there are a few of them. */
+      std::vector<std::pair<std::string, Channel> > channels_;
+  };
+
+  /** \brief Convert a point cloud to a structure of arrays. The coordinates
+    * are always copied. The channels of \a cloud_out which match a float field
+    * of \a PointT are filled, the others are removed.
+    * \param[in] cloud_in the input point cloud
+    * \param[out] cloud_out the output structure of arrays, with the channels to fill
+    * \ingroup common
+    */
+  template <typename PointT> void
+  copyPointCloud (const pcl::PointCloud<PointT> &cloud_in, pcl::PointCloudSoA &cloud_out);
+
+  /** \brief Convert a structure of arrays to a point cloud. The coordinates
+    * and the channels matching a float field of \a PointT are copied, the
+    * other fields of the output points are default constructed.
+    * \param[in] cloud_in the input structure of arrays
+    * \param[out] cloud_out the output point cloud
+    * \ingroup common
+    */
+  template <typename PointT> void
+  copyPointCloud (const pcl::PointCloudSoA &cloud_in, pcl::PointCloud<PointT> &cloud_out);
+}
+
+#include <pcl/impl/point_cloud_soa.hpp>
+
+#endif  //#ifndef PCL_POINT_CLOUD_SOA_H_
@@ -374,6 +374,27 @@ namespace pcl
       }
   };
 
+  //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+  /** \brief The coordinates of a PointXYZQuantized, in quantization steps. */
+  template <>
+  class DefaultPointRepresentation <PointXYZQuantized> : public  PointRepresentation <PointXYZQuantized>
+  {
+    public:
+      DefaultPointRepresentation ()
+      {
+        nr_dimensions_ = 3;
+        trivial_ = false;
+      }
+
+      virtual void
+      copyToFloatArray (const PointXYZQuantized &p, float * out) const
+      {
+        out[0] = p.x;
+        out[1] = p.y;
+        out[2] = p.z;
+      }
+  };
+
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   template <>
   class DefaultPointRepresentation <PFHSignature125> : public DefaultFeatureRepresentation <PFHSignature125>
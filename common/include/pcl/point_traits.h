@@ -49,6 +49,7 @@
 #include <boost/type_traits/is_same.hpp>
 #include <boost/mpl/assert.hpp>
 #include <boost/mpl/bool.hpp>
+#include <boost/utility/enable_if.hpp>
 
 namespace pcl
 {
@@ -156,6 +157,28 @@ namespace pcl
                            POINT_TYPE_NOT_PROPERLY_REGISTERED, (PointT&));
     };
 
+    // padding: true if the coordinates (resp. the normal) are padded to 4 floats, as with
+    // PCL_ADD_POINT4D (resp. PCL_ADD_NORMAL4D), so that they can be loaded as a whole
+    template<typename PointT>
+    struct has_padded_xyz
+    {
+      template<typename U> static char
+      check (typename boost::enable_if_c<sizeof (static_cast<U*> (0)->data) == 4 * sizeof (float)>::type*);
+      template<typename U> static long
+      check (...);
+      static const bool value = sizeof (check<PointT> (0)) == sizeof (char);
+    };
+
+    template<typename PointT>
+    struct has_padded_normal
+    {
+      template<typename U> static char
+      check (typename boost::enable_if_c<sizeof (static_cast<U*> (0)->data_n) == 4 * sizeof (float)>::type*);
+      template<typename U> static long
+      check (...);
+      static const bool value = sizeof (check<PointT> (0)) == sizeof (char);
+    };
+
     /*
       At least on GCC 4.4.3, but not later versions, some valid usages of the above traits for
       non-POD (but registered) point types fail with:
@@ -42,6 +42,7 @@
 #include <pcl/pcl_macros.h>
 #include <pcl/common/eigen.h>
 #include <bitset>
+#include <boost/type_traits/integral_constant.hpp>
 #include <vector>
 #include <pcl/ros/register_point_struct.h>
 
@@ -303,6 +304,51 @@ namespace pcl
     * \ingroup common
     */
   struct PointSurfel;
+
+  /** \brief Members: float x, y, z (without padding)
+    * \ingroup common
+    */
+  struct PointXYZPacked;
+
+  /** \brief Members: float x, y, z, rgb (without padding)
+    * \ingroup common
+    */
+  struct PointXYZRGBPacked;
+
+  /** \brief Members: float x, y, z, rgb, normal[3], curvature (without padding)
+    * \ingroup common
+    */
+  struct PointXYZRGBNormalPacked;
+
+  /** \brief Members: int16_t x, y, z
+    * \ingroup common
+    */
+  struct PointXYZQuantized;
+
+  namespace detail
+  {
+    /** \brief Load the coordinates of a point into the first 3 components of an array. The point
+      * types with padded coordinates (PCL_ADD_POINT4D) are loaded with a single instruction, and
+      * the 4th component is their padding; it is 1 for the other point types.
+      */
+    template <typename PointT> inline Eigen::Array4f
+    loadXYZ (const PointT &point, boost::true_type)
+    {
+      return (Eigen::Map<const Eigen::Array4f> (point.data));
+    }
+
+    template <typename PointT> inline Eigen::Array4f
+    loadXYZ (const PointT &point, boost::false_type)
+    {
+      return (Eigen::Array4f (point.x, point.y, point.z, 1.0f));
+    }
+
+    template <typename PointT> inline Eigen::Array4f
+    loadXYZ (const PointT &point)
+    {
+      return (loadXYZ (point, boost::integral_constant<bool, traits::has_padded_xyz<PointT>::value> ()));
+    }
+  }
 }
 
 /** @} */
@@ -591,6 +637,39 @@ POINT_CLOUD_REGISTER_POINT_STRUCT (pcl::_ReferenceFrame,
 )
 POINT_CLOUD_REGISTER_POINT_WRAPPER(pcl::ReferenceFrame, pcl::_ReferenceFrame)
 
+POINT_CLOUD_REGISTER_POINT_STRUCT (pcl::_PointXYZPacked,
+    (float, x, x)
+    (float, y, y)
+    (float, z, z)
+)
+POINT_CLOUD_REGISTER_POINT_WRAPPER(pcl::PointXYZPacked, pcl::_PointXYZPacked)
+
+POINT_CLOUD_REGISTER_POINT_STRUCT (pcl::_PointXYZRGBPacked,
+    (float, x, x)
+    (float, y, y)
+    (float, z, z)
+    (float, rgb, rgb)
+)
+POINT_CLOUD_REGISTER_POINT_WRAPPER(pcl::PointXYZRGBPacked, pcl::_PointXYZRGBPacked)
+
+POINT_CLOUD_REGISTER_POINT_STRUCT (pcl::_PointXYZRGBNormalPacked,
+    (float, x, x)
+    (float, y, y)
+    (float, z, z)
+    (float, rgb, rgb)
+    (float, normal_x, normal_x)
+    (float, normal_y, normal_y)
+    (float, normal_z, normal_z)
+    (float, curvature, curvature)
+)
+POINT_CLOUD_REGISTER_POINT_WRAPPER(pcl::PointXYZRGBNormalPacked, pcl::_PointXYZRGBNormalPacked)
+
+POINT_CLOUD_REGISTER_POINT_STRUCT (pcl::PointXYZQuantized,
+    (int16_t, x, x)
+    (int16_t, y, y)
+    (int16_t, z, z)
+)
+
 namespace pcl 
 {
   // Allow float 'rgb' data to match to the newer uint32 'rgba' tag. This is so
@@ -234,88 +234,164 @@ RangeImage::doZBuffer (const PointCloudType& point_cloud, float noise_level, flo
   
   top=height; right=-1; bottom=-1; left=width;
   
-  float x_real, y_real, range_of_current_point;
-  int x, y;
-  for (typename pcl::PointCloud<PointType2>::VectorType::const_iterator it=points2.begin (); it!=points2.end (); ++it)
+  const int nr_points = static_cast<int> (points2.size ());
+  const int chunk_size = 16384;
+  const int nr_chunks = (nr_points + chunk_size - 1) / chunk_size;
+  if (max_no_of_threads == 1 || nr_chunks <= 1 || height < 2)
   {
-    if (!isFinite (*it))  // Check for NAN etc
-      continue;
-    Vector3fMapConst current_point = it->getVector3fMap ();
-    
-    this->getImagePoint (current_point, x_real, y_real, range_of_current_point);
-    this->real2DToInt2D (x_real, y_real, x, y);
-    
-    if (range_of_current_point < min_range|| !isInImage (x, y))
-      continue;
-    //std::cout << " ("<<current_point[0]<<", "<<current_point[1]<<", "<<current_point[2]<<") falls into pixel "<<x<<","<<y<<".\n";
-    
-    // Do some minor interpolation by checking the three closest neighbors to the point, that are not filled yet.
-    int floor_x = pcl_lrint (floor (x_real)), floor_y = pcl_lrint (floor (y_real)),
-        ceil_x  = pcl_lrint (ceil (x_real)),  ceil_y  = pcl_lrint (ceil (y_real));
-    
-    int neighbor_x[4], neighbor_y[4];
-    neighbor_x[0]=floor_x; neighbor_y[0]=floor_y;
-    neighbor_x[1]=floor_x; neighbor_y[1]=ceil_y;
-    neighbor_x[2]=ceil_x;  neighbor_y[2]=floor_y;
-    neighbor_x[3]=ceil_x;  neighbor_y[3]=ceil_y;
-    //std::cout << x_real<<","<<y_real<<": ";
-    
-    for (int i=0; i<4; ++i)
+    ProjectedPoint projected;
+    for (int i = 0; i < nr_points; ++i)
     {
-      int n_x=neighbor_x[i], n_y=neighbor_y[i];
-      //std::cout << n_x<<","<<n_y<<" ";
-      if (n_x==x && n_y==y)
+      projectPoint (points2[i], min_range, projected);
+      if (projected.x >= 0)
+        addToZBuffer (projected, noise_level, counters, 0, height-1, top, right, bottom, left);
+    }
+    delete[] counters;
+    return;
+  }
+  
+  // A point only updates the rows floor (y_real) and ceil (y_real). The rows are split in bands, and every
+  // chunk of points lists the points of each band, so that a band is updated in the order of the points.
+  const int nr_bands = (std::min) (static_cast<int> (height), 64);
+  const int band_height = (static_cast<int> (height) + nr_bands - 1) / nr_bands;
+  std::vector<ProjectedPoint> projected (nr_points);
+  std::vector<std::vector<int> > band_points (nr_chunks*nr_bands);
+  
+# pragma omp parallel for num_threads (max_no_of_threads) default (shared) schedule (dynamic, 1)
+  for (int chunk=0; chunk<nr_chunks; ++chunk)
+  {
+    std::vector<int>* chunk_band_points = &band_points[chunk*nr_bands];
+    for (int i=chunk*chunk_size; i<(std::min) ((chunk+1)*chunk_size, nr_points); ++i)
+    {
+      ProjectedPoint& point = projected[i];
+      projectPoint (points2[i], min_range, point);
+      if (point.x < 0)
         continue;
-      if (isInImage (n_x, n_y))
-      {
-        int neighbor_array_pos = n_y*width + n_x;
-        if (counters[neighbor_array_pos]==0)
-        {
-          float& neighbor_range = points[neighbor_array_pos].range;
-          neighbor_range = (pcl_isinf (neighbor_range) ? range_of_current_point : (std::min) (neighbor_range, range_of_current_point));
-          top= (std::min) (top, n_y); right= (std::max) (right, n_x); bottom= (std::max) (bottom, n_y); left= (std::min) (left, n_x);
-        }
-      }
+      int first_band = (std::max) (pcl_lrint (floor (point.y_real)), 0L) / band_height,
+          last_band  = (std::min) (pcl_lrint (ceil (point.y_real)), static_cast<long> (height-1)) / band_height;
+      for (int band=first_band; band<=last_band; ++band)
+        chunk_band_points[band].push_back (i);
     }
-    //std::cout <<std::endl;
-    
-    // The point itself
-    int arrayPos = y*width + x;
-    float& range_at_image_point = points[arrayPos].range;
-    int& counter = counters[arrayPos];
-    bool addCurrentPoint=false, replace_with_current_point=false;
-    
-    if (counter==0)
+  }
+  
+# pragma omp parallel for num_threads (max_no_of_threads) default (shared) schedule (dynamic, 1)
+  for (int band=0; band<nr_bands; ++band)
+  {
+    int band_top=height, band_right=-1, band_bottom=-1, band_left=width;
+    for (int chunk=0; chunk<nr_chunks; ++chunk)
     {
-      replace_with_current_point = true;
+      const std::vector<int>& chunk_band_points = band_points[chunk*nr_bands + band];
+      for (size_t i=0; i<chunk_band_points.size (); ++i)
+        addToZBuffer (projected[chunk_band_points[i]], noise_level, counters, band*band_height,
+                      (std::min) ((band+1)*band_height, static_cast<int> (height))-1,
+                      band_top, band_right, band_bottom, band_left);
     }
-    else
+#   pragma omp critical (pcl_range_image_z_buffer)
     {
-      if (range_of_current_point < range_at_image_point-noise_level)
-      {
-        replace_with_current_point = true;
-      }
-      else if (fabs (range_of_current_point-range_at_image_point)<=noise_level)
+      top= (std::min) (top, band_top); right= (std::max) (right, band_right);
+      bottom= (std::max) (bottom, band_bottom); left= (std::min) (left, band_left);
+    }
+  }
+  
+  delete[] counters;
+}
+
+/////////////////////////////////////////////////////////////////////////
+template <typename PointType2> void
+RangeImage::projectPoint (const PointType2& point, float min_range, ProjectedPoint& projected) const
+{
+  projected.x = -1;
+  if (!isFinite (point))  // Check for NAN etc
+    return;
+  Vector3fMapConst current_point = point.getVector3fMap ();
+  
+  int x, y;
+  this->getImagePoint (current_point, projected.x_real, projected.y_real, projected.range);
+  this->real2DToInt2D (projected.x_real, projected.y_real, x, y);
+  
+  if (projected.range < min_range|| !isInImage (x, y))
+    return;
+  projected.x = x;
+  projected.y = y;
+}
+
+/////////////////////////////////////////////////////////////////////////
+void
+RangeImage::addToZBuffer (const ProjectedPoint& point, float noise_level, int* counters, int min_y, int max_y,
+                          int& top, int& right, int& bottom, int& left)
+{
+  const float x_real = point.x_real, y_real = point.y_real, range_of_current_point = point.range;
+  const int x = point.x, y = point.y;
+  
+  // Do some minor interpolation by checking the three closest neighbors to the point, that are not filled yet.
+  int floor_x = pcl_lrint (floor (x_real)), floor_y = pcl_lrint (floor (y_real)),
+      ceil_x  = pcl_lrint (ceil (x_real)),  ceil_y  = pcl_lrint (ceil (y_real));
+  
+  int neighbor_x[4], neighbor_y[4];
+  neighbor_x[0]=floor_x; neighbor_y[0]=floor_y;
+  neighbor_x[1]=floor_x; neighbor_y[1]=ceil_y;
+  neighbor_x[2]=ceil_x;  neighbor_y[2]=floor_y;
+  neighbor_x[3]=ceil_x;  neighbor_y[3]=ceil_y;
+  //std::cout << x_real<<","<<y_real<<": ";
+  
+  for (int i=0; i<4; ++i)
+  {
+    int n_x=neighbor_x[i], n_y=neighbor_y[i];
+    //std::cout << n_x<<","<<n_y<<" ";
+    if (n_x==x && n_y==y)
+      continue;
+    if (n_y < min_y || n_y > max_y)
+      continue;
+    if (isInImage (n_x, n_y))
+    {
+      int neighbor_array_pos = n_y*width + n_x;
+      if (counters[neighbor_array_pos]==0)
       {
-        addCurrentPoint = true;
+        float& neighbor_range = points[neighbor_array_pos].range;
+        neighbor_range = (pcl_isinf (neighbor_range) ? range_of_current_point : (std::min) (neighbor_range, range_of_current_point));
+        top= (std::min) (top, n_y); right= (std::max) (right, n_x); bottom= (std::max) (bottom, n_y); left= (std::min) (left, n_x);
       }
     }
-    
-    if (replace_with_current_point)
+  }
+  //std::cout <<std::endl;
+  
+  if (y < min_y || y > max_y)
+    return;
+  
+  // The point itself
+  int arrayPos = y*width + x;
+  float& range_at_image_point = points[arrayPos].range;
+  int& counter = counters[arrayPos];
+  bool addCurrentPoint=false, replace_with_current_point=false;
+  
+  if (counter==0)
+  {
+    replace_with_current_point = true;
+  }
+  else
+  {
+    if (range_of_current_point < range_at_image_point-noise_level)
     {
-      counter = 1;
-      range_at_image_point = range_of_current_point;
-      top= (std::min) (top, y); right= (std::max) (right, x); bottom= (std::max) (bottom, y); left= (std::min) (left, x);
-      //std::cout << "Adding point "<<x<<","<<y<<"\n";
+      replace_with_current_point = true;
     }
-    else if (addCurrentPoint)
+    else if (fabs (range_of_current_point-range_at_image_point)<=noise_level)
     {
-      ++counter;
-      range_at_image_point += (range_of_current_point-range_at_image_point)/counter;
+      addCurrentPoint = true;
     }
   }
   
-  delete[] counters;
+  if (replace_with_current_point)
+  {
+    counter = 1;
+    range_at_image_point = range_of_current_point;
+    top= (std::min) (top, y); right= (std::max) (right, x); bottom= (std::max) (bottom, y); left= (std::min) (left, x);
+    //std::cout << "Adding point "<<x<<","<<y<<"\n";
+  }
+  else if (addCurrentPoint)
+  {
+    ++counter;
+    range_at_image_point += (range_of_current_point-range_at_image_point)/counter;
+  }
 }
 
 /////////////////////////////////////////////////////////////////////////
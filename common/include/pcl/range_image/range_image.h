@@ -75,7 +75,8 @@ namespace pcl
       PCL_EXPORTS ~RangeImage ();
       
       // =====STATIC VARIABLES=====
-      /** The maximum number of openmp threads that can be used in this class */
+      /** The maximum number of openmp threads that can be used in this class, e.g. to create a range image
+        * from a point cloud. The result does not depend on the number of threads. */
       static int max_no_of_threads;
       
       // =====STATIC METHODS=====
@@ -308,6 +309,8 @@ namespace pcl
         * \param bottom returns the maximum y pixel position in the image where a point was added
         * \param top returns the minimum y position in the image where a point was added
         * \param left   returns the minimum x pixel position in the image where a point was added
+        * \note Uses max_no_of_threads threads. The points are projected in parallel, and the image rows are
+        *       split in bands, each one updated by a single thread in the order of the points.
         */
       template <typename PointCloudType> void
       doZBuffer (const PointCloudType& point_cloud, float noise_level,
@@ -778,7 +781,36 @@ namespace pcl
                                                 *   a reference to a non-existing point */
       
       // =====PROTECTED METHODS=====
+      /** \brief A point projected into the image by doZBuffer */
+      struct ProjectedPoint
+      {
+        float x_real, y_real;  /**< The image position */
+        float range;           /**< The range of the point */
+        int x, y;              /**< The closest pixel, x is -1 if the point is not visible */
+      };
 
+      /** \brief Project a point into the image for doZBuffer.
+        * \param point the point, in world coordinates
+        * \param min_range the minimum visible range
+        * \param projected the resultant projected point
+        */
+      template <typename PointType2> void
+      projectPoint (const PointType2& point, float min_range, ProjectedPoint& projected) const;
+
+      /** \brief Add a projected point to the z-buffer of doZBuffer, only updating the rows in [min_y, max_y].
+        * \param point the projected point
+        * \param noise_level see doZBuffer
+        * \param counters the number of points averaged per pixel
+        * \param min_y the first row to update
+        * \param max_y the last row to update
+        * \param top    the minimum y pixel position in the image where a point was added
+        * \param right  the maximum x pixel position in the image where a point was added
+        * \param bottom the maximum y pixel position in the image where a point was added
+        * \param left   the minimum x pixel position in the image where a point was added
+        */
+      inline void
+      addToZBuffer (const ProjectedPoint& point, float noise_level, int* counters, int min_y, int max_y,
+                    int& top, int& right, int& bottom, int& left);
 
       // =====STATIC PROTECTED=====
       static const int lookup_table_size;
@@ -0,0 +1,328 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_ROS_CONVERSION_PLAN_H_
+#define PCL_ROS_CONVERSION_PLAN_H_
+
+#include <pcl/ros/conversions.h>
+#include <algorithm>
+#include <cstring>
+
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Copy a run of \a size bytes. The common run sizes are spelled
+      * out, so that the compiler can replace memcpy by a few moves.
+      */
+    inline void
+    copyFieldRun (uint8_t *dst, const uint8_t *src, size_t size)
+    {
+      switch (size)
+      {
+        case 4:  memcpy (dst, src, 4); break;
+        case 8:  memcpy (dst, src, 8); break;
+        case 12: memcpy (dst, src, 12); break;
+        case 16: memcpy (dst, src, 16); break;
+        case 32: memcpy (dst, src, 32); break;
+        default: memcpy (dst, src, size); break;
+      }
+    }
+
+    /** \brief Copy \a size bytes in parallel blocks of (at least) \a block_size bytes. */
+    inline void
+    parallelCopy (uint8_t *dst, const uint8_t *src, size_t size, size_t block_size, unsigned int threads)
+    {
+      const int nr_blocks = static_cast<int> ((size + block_size - 1) / block_size);
+      if (nr_blocks < 2)
+      {
+        memcpy (dst, src, size);
+        return;
+      }
+#pragma omp parallel for num_threads(threads)
+      for (int b = 0; b < nr_blocks; ++b)
+      {
+        const size_t begin = static_cast<size_t> (b) * block_size;
+        memcpy (dst + begin, src + begin, std::min (block_size, size - begin));
+      }
+    }
+  }
+
+  /** \brief A reusable plan for converting between sensor_msgs::PointCloud2
+    * blobs and pcl::PointCloud<PointT> objects.
+    *
+    * \a fromROSMsg (msg, cloud) creates a new MsgFieldMap on every call. A
+    * ConversionPlan keeps the field map of the last layout (fields and
+    * point_step) it saw, and only rebuilds it when the layout changes, which
+    * makes it a good fit for streams of clouds coming from the same source.
+    * Adjacent fields are coalesced into the largest possible memcpy runs, a
+    * layout identical to PointT is copied at once, and large clouds are
+    * converted in parallel.
+    *
+    * \code
+    * pcl::ConversionPlan<pcl::PointXYZRGBA> plan;
+    * while (grab (msg))
+    * {
+    *   plan.fromROSMsg (msg, cloud);
+    *   process (cloud);
+    * }
+    * \endcode
+    *
+    * \note A plan caches state, so it should not be shared by several
+    * threads without external locking.
+    * \ingroup common
+    */
+  template <typename PointT>
+  class ConversionPlan
+  {
+    public:
+      /** \brief Empty constructor. */
+      ConversionPlan ()
+        : is_prepared_ (false)
+        , fields_ ()
+        , point_step_ (0)
+        , field_map_ ()
+        , is_identity_ (false)
+        , out_fields_ ()
+        , threads_ (0)
+        , parallel_threshold_ (1 << 16)
+      {
+      }
+
+      /** \brief Set the number of threads used for large conversions.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
+      /** \brief Set the minimum number of points for a conversion to run in parallel.
+        * \param[in] nr_points the number of points (default: 65536)
+        */
+      inline void
+      setParallelThreshold (size_t nr_points)
+      {
+        parallel_threshold_ = nr_points;
+      }
+
+      /** \brief Prepare the plan for messages having the layout of \a msg.
+        * Nothing is done if the layout is the one of the previous call.
+        * \param[in] msg the PointCloud2 message (only the fields and point_step are used)
+        * \return true if the field map had to be (re)built
+        */
+      bool
+      prepare (const sensor_msgs::PointCloud2 &msg)
+      {
+        if (is_prepared_ && msg.point_step == point_step_ && sameFields (msg.fields))
+          return (false);
+
+        is_prepared_ = true;
+        fields_ = msg.fields;
+        point_step_ = msg.point_step;
+        field_map_.clear ();
+        createMapping<PointT> (fields_, field_map_);
+        is_identity_ = (field_map_.size () == 1 &&
+                        field_map_[0].serialized_offset == 0 &&
+                        field_map_[0].struct_offset == 0 &&
+                        point_step_ == sizeof (PointT));
+        return (true);
+      }
+
+      /** \brief Get the field map of the last prepared layout. */
+      inline const MsgFieldMap&
+      getFieldMap () const
+      {
+        return (field_map_);
+      }
+
+      /** \brief Return true if the last prepared layout can be copied with a single memcpy per row. */
+      inline bool
+      isIdentity () const
+      {
+        return (is_identity_);
+      }
+
+      /** \brief Convert a PointCloud2 binary data blob into a pcl::PointCloud<T> object.
+        * \param[in] msg the PointCloud2 binary blob
+        * \param[out] cloud the resultant pcl::PointCloud<T>
+        */
+      void
+      fromROSMsg (const sensor_msgs::PointCloud2 &msg, pcl::PointCloud<PointT> &cloud)
+      {
+        prepare (msg);
+
+        // Copy info fields
+        cloud.header   = msg.header;
+        cloud.width    = msg.width;
+        cloud.height   = msg.height;
+        cloud.is_dense = msg.is_dense == 1;
+
+        const size_t nr_points = static_cast<size_t> (msg.width) * msg.height;
+        cloud.points.resize (nr_points);
+        if (nr_points == 0)
+          return;
+        uint8_t *cloud_data = reinterpret_cast<uint8_t*> (&cloud.points[0]);
+        const uint8_t *msg_data = &msg.data[0];
+        const size_t cloud_row_step = sizeof (PointT) * msg.width;
+        const bool parallel = nr_points >= parallel_threshold_;
+        if (field_map_.empty ())
+          return;
+
+        if (is_identity_ && msg.row_step == cloud_row_step)
+        {
+          // A single block, possibly copied in parallel
+          if (parallel)
+            detail::parallelCopy (cloud_data, msg_data, nr_points * sizeof (PointT), 1 << 20, threads_);
+          else
+            memcpy (cloud_data, msg_data, nr_points * sizeof (PointT));
+          return;
+        }
+
+        const int height = static_cast<int> (msg.height);
+        const size_t width = msg.width, row_step = msg.row_step, nr_runs = field_map_.size ();
+        const detail::FieldMapping *runs = &field_map_[0];
+        if (is_identity_)
+        {
+          // One memcpy per row
+#pragma omp parallel for num_threads(threads_) if (parallel)
+          for (int row = 0; row < height; ++row)
+            memcpy (cloud_data + row * cloud_row_step, msg_data + row * row_step, cloud_row_step);
+          return;
+        }
+
+        // One memcpy per run of adjacent fields
+#pragma omp parallel for num_threads(threads_) if (parallel)
+        for (int row = 0; row < height; ++row)
+        {
+          const uint8_t *src = msg_data + row * row_step;
+          uint8_t *dst = cloud_data + row * cloud_row_step;
+          for (size_t col = 0; col < width; ++col, src += point_step_, dst += sizeof (PointT))
+            for (size_t r = 0; r < nr_runs; ++r)
+              detail::copyFieldRun (dst + runs[r].struct_offset, src + runs[r].serialized_offset, runs[r].size);
+        }
+      }
+
+      /** \brief Convert a pcl::PointCloud<T> object to a PointCloud2 binary data blob.
+        * \param[in] cloud the input pcl::PointCloud<T>
+        * \param[out] msg the resultant PointCloud2 binary blob
+        */
+      void
+      toROSMsg (const pcl::PointCloud<PointT> &cloud, sensor_msgs::PointCloud2 &msg)
+      {
+        // Ease the user's burden on specifying width/height for unorganized datasets
+        if (cloud.width == 0 && cloud.height == 0)
+        {
+          msg.width  = static_cast<uint32_t> (cloud.points.size ());
+          msg.height = 1;
+        }
+        else
+        {
+          assert (cloud.points.size () == cloud.width * cloud.height);
+          msg.height = cloud.height;
+          msg.width  = cloud.width;
+        }
+
+        // Fill point cloud binary data (padding and all)
+        size_t data_size = sizeof (PointT) * cloud.points.size ();
+        msg.data.resize (data_size);
+        if (data_size > 0)
+        {
+          const uint8_t *cloud_data = reinterpret_cast<const uint8_t*> (&cloud.points[0]);
+          if (cloud.points.size () >= parallel_threshold_)
+            detail::parallelCopy (&msg.data[0], cloud_data, data_size, 1 << 20, threads_);
+          else
+            memcpy (&msg.data[0], cloud_data, data_size);
+        }
+
+        // Fill fields metadata, computed once
+        if (out_fields_.empty ())
+          for_each_type<typename traits::fieldList<PointT>::type> (detail::FieldAdder<PointT> (out_fields_));
+        msg.fields     = out_fields_;
+
+        msg.header     = cloud.header;
+        msg.point_step = sizeof (PointT);
+        msg.row_step   = static_cast<uint32_t> (sizeof (PointT) * msg.width);
+        msg.is_dense   = cloud.is_dense;
+      }
+
+    private:
+      /** \brief Return true if \a fields matches the fields of the prepared layout. */
+      bool
+      sameFields (const std::vector<sensor_msgs::PointField> &fields) const
+      {
+        if (fields.size () != fields_.size ())
+          return (false);
+        for (size_t i = 0; i < fields.size (); ++i)
+        {
+          if (fields[i].offset != fields_[i].offset || fields[i].datatype != fields_[i].datatype ||
+              fields[i].count != fields_[i].count || fields[i].name != fields_[i].name)
+            return (false);
+        }
+        return (true);
+      }
+
+      /** \brief Set to true once a layout has been prepared. */
+      bool is_prepared_;
+
+      /** \brief The fields of the prepared layout. */
+      std::vector<sensor_msgs::PointField> fields_;
+
+      /** \brief The point step of the prepared layout. */
+      uint32_t point_step_;
+
+      /** \brief The coalesced field map of the prepared layout. */
+      MsgFieldMap field_map_;
+
+      /** \brief True if the prepared layout is the one of PointT. */
+      bool is_identity_;
+
+      /** \brief The fields of PointT, for toROSMsg. */
+      std::vector<sensor_msgs::PointField> out_fields_;
+
+      /** \brief The number of threads used for large conversions. */
+      unsigned int threads_;
+
+      /** \brief The minimum number of points for a conversion to run in parallel. */
+      size_t parallel_threshold_;
+  };
+}
+
+#endif  //#ifndef PCL_ROS_CONVERSION_PLAN_H_
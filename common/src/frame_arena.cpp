@@ -0,0 +1,105 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <pcl/common/frame_arena.h>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::FrameArena::reset ()
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  for (Pools::iterator it = pools_.begin (); it != pools_.end (); ++it)
+  {
+    std::vector<Slot> &slots = it->second;
+    size_t nr_slots = 0;
+    for (size_t i = 0; i < slots.size (); ++i)
+    {
+      if (!slots[i].requested && slots[i].object.unique ())
+        continue;
+      slots[nr_slots] = slots[i];
+      slots[nr_slots].requested = false;
+      ++nr_slots;
+    }
+    slots.resize (nr_slots);
+  }
+  nr_allocations_ = nr_reuses_ = 0;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::FrameArena::clear ()
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  for (Pools::iterator it = pools_.begin (); it != pools_.end (); ++it)
+  {
+    std::vector<Slot> &slots = it->second;
+    size_t nr_slots = 0;
+    for (size_t i = 0; i < slots.size (); ++i)
+      if (!slots[i].object.unique ())
+        slots[nr_slots++] = slots[i];
+    slots.resize (nr_slots);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+size_t
+pcl::FrameArena::getNumberOfAllocations () const
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  return (nr_allocations_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+size_t
+pcl::FrameArena::getNumberOfReuses () const
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  return (nr_reuses_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+size_t
+pcl::FrameArena::getNumberOfObjects () const
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  size_t nr_objects = 0;
+  for (Pools::const_iterator it = pools_.begin (); it != pools_.end (); ++it)
+    nr_objects += it->second.size ();
+  return (nr_objects);
+}
@@ -0,0 +1,410 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+
+#include <pcl/point_cloud_soa.h>
+#include <pcl/common/common.h>
+#include <pcl/common/centroid.h>
+#include <pcl/common/transforms.h>
+#include <pcl/common/distances.h>
+#include <cfloat>
+#include <cmath>
+#ifdef __SSE__
+#include <xmmintrin.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PointCloudSoA::resize (size_t n)
+{
+  x.resize (n);
+  y.resize (n);
+  z.resize (n);
+  for (size_t c = 0; c < channels_.size (); ++c)
+    channels_[c].second.resize (n);
+  width = static_cast<uint32_t> (n);
+  height = 1;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::PointCloudSoA::Channel&
+pcl::PointCloudSoA::addChannel (const std::string &name)
+{
+  Channel *channel = getChannel (name);
+  if (channel)
+    return (*channel);
+  channels_.push_back (std::make_pair (name, Channel (x.size ())));
+  return (channels_.back ().second);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::PointCloudSoA::Channel*
+pcl::PointCloudSoA::getChannel (const std::string &name)
+{
+  for (size_t c = 0; c < channels_.size (); ++c)
+    if (channels_[c].first == name)
+      return (&channels_[c].second);
+  return (NULL);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+const pcl::PointCloudSoA::Channel*
+pcl::PointCloudSoA::getChannel (const std::string &name) const
+{
+  for (size_t c = 0; c < channels_.size (); ++c)
+    if (channels_[c].first == name)
+      return (&channels_[c].second);
+  return (NULL);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PointCloudSoA::removeChannel (const std::string &name)
+{
+  for (size_t c = 0; c < channels_.size (); ++c)
+    if (channels_[c].first == name)
+    {
+      channels_.erase (channels_.begin () + c);
+      return;
+    }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+std::vector<std::string>
+pcl::PointCloudSoA::getChannelNames () const
+{
+  std::vector<std::string> names (channels_.size ());
+  for (size_t c = 0; c < channels_.size (); ++c)
+    names[c] = channels_[c].first;
+  return (names);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PointCloudSoA::swap (PointCloudSoA &cloud)
+{
+  std::swap (header, cloud.header);
+  x.swap (cloud.x);
+  y.swap (cloud.y);
+  z.swap (cloud.z);
+  std::swap (width, cloud.width);
+  std::swap (height, cloud.height);
+  std::swap (is_dense, cloud.is_dense);
+  channels_.swap (cloud.channels_);
+}
+
+#ifdef __SSE__
+namespace
+{
+  /** \brief All bits set in the lanes where x, y and z are finite: v - v is 0
+    * for finite values, and NaN for NaN or Inf.
+    */
+  inline __m128
+  finiteMask (__m128 x, __m128 y, __m128 z)
+  {
+    const __m128 zero = _mm_setzero_ps ();
+    return (_mm_and_ps (_mm_and_ps (_mm_cmpeq_ps (_mm_sub_ps (x, x), zero),
+                                    _mm_cmpeq_ps (_mm_sub_ps (y, y), zero)),
+                        _mm_cmpeq_ps (_mm_sub_ps (z, z), zero)));
+  }
+
+  /** \brief a in the lanes set in mask, b in the others. */
+  inline __m128
+  select (__m128 mask, __m128 a, __m128 b)
+  {
+    return (_mm_or_ps (_mm_and_ps (mask, a), _mm_andnot_ps (mask, b)));
+  }
+
+  inline float
+  horizontalMin (__m128 v)
+  {
+    v = _mm_min_ps (v, _mm_movehl_ps (v, v));
+    v = _mm_min_ss (v, _mm_shuffle_ps (v, v, 1));
+    return (_mm_cvtss_f32 (v));
+  }
+
+  inline float
+  horizontalMax (__m128 v)
+  {
+    v = _mm_max_ps (v, _mm_movehl_ps (v, v));
+    v = _mm_max_ss (v, _mm_shuffle_ps (v, v, 1));
+    return (_mm_cvtss_f32 (v));
+  }
+
+  inline float
+  horizontalSum (__m128 v)
+  {
+    v = _mm_add_ps (v, _mm_movehl_ps (v, v));
+    v = _mm_add_ss (v, _mm_shuffle_ps (v, v, 1));
+    return (_mm_cvtss_f32 (v));
+  }
+
+  /** \brief The number of bits set in a 4 bits mask. */
+  const int mask_bit_count[16] = {0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4};
+}
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::getMinMax3D (const pcl::PointCloudSoA &cloud, Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt)
+{
+  const size_t nr_points = cloud.size ();
+  float min_x = FLT_MAX, min_y = FLT_MAX, min_z = FLT_MAX;
+  float max_x = -FLT_MAX, max_y = -FLT_MAX, max_z = -FLT_MAX;
+  size_t i = 0;
+
+#ifdef __SSE__
+  if (nr_points >= 4)
+  {
+    const float *px = &cloud.x[0], *py = &cloud.y[0], *pz = &cloud.z[0];
+    const __m128 flt_max = _mm_set1_ps (FLT_MAX), flt_min = _mm_set1_ps (-FLT_MAX);
+    __m128 vmin_x = flt_max, vmin_y = flt_max, vmin_z = flt_max;
+    __m128 vmax_x = flt_min, vmax_y = flt_min, vmax_z = flt_min;
+    // If the data is dense, we don't need to check for NaN
+    if (cloud.is_dense)
+    {
+      for (; i + 4 <= nr_points; i += 4)
+      {
+        const __m128 x = _mm_load_ps (px + i), y = _mm_load_ps (py + i), z = _mm_load_ps (pz + i);
+        vmin_x = _mm_min_ps (vmin_x, x); vmax_x = _mm_max_ps (vmax_x, x);
+        vmin_y = _mm_min_ps (vmin_y, y); vmax_y = _mm_max_ps (vmax_y, y);
+        vmin_z = _mm_min_ps (vmin_z, z); vmax_z = _mm_max_ps (vmax_z, z);
+      }
+    }
+    else
+    {
+      for (; i + 4 <= nr_points; i += 4)
+      {
+        const __m128 x = _mm_load_ps (px + i), y = _mm_load_ps (py + i), z = _mm_load_ps (pz + i);
+        const __m128 valid = finiteMask (x, y, z);
+        vmin_x = _mm_min_ps (vmin_x, select (valid, x, flt_max)); vmax_x = _mm_max_ps (vmax_x, select (valid, x, flt_min));
+        vmin_y = _mm_min_ps (vmin_y, select (valid, y, flt_max)); vmax_y = _mm_max_ps (vmax_y, select (valid, y, flt_min));
+        vmin_z = _mm_min_ps (vmin_z, select (valid, z, flt_max)); vmax_z = _mm_max_ps (vmax_z, select (valid, z, flt_min));
+      }
+    }
+    min_x = horizontalMin (vmin_x); max_x = horizontalMax (vmax_x);
+    min_y = horizontalMin (vmin_y); max_y = horizontalMax (vmax_y);
+    min_z = horizontalMin (vmin_z); max_z = horizontalMax (vmax_z);
+  }
+#endif
+
+  for (; i < nr_points; ++i)
+  {
+    const float x = cloud.x[i], y = cloud.y[i], z = cloud.z[i];
+    if (!cloud.is_dense && (!pcl_isfinite (x) || !pcl_isfinite (y) || !pcl_isfinite (z)))
+      continue;
+    min_x = std::min (min_x, x); max_x = std::max (max_x, x);
+    min_y = std::min (min_y, y); max_y = std::max (max_y, y);
+    min_z = std::min (min_z, z); max_z = std::max (max_z, z);
+  }
+
+  min_pt = Eigen::Vector4f (min_x, min_y, min_z, 1.0f);
+  max_pt = Eigen::Vector4f (max_x, max_y, max_z, 1.0f);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned int
+pcl::compute3DCentroid (const pcl::PointCloudSoA &cloud, Eigen::Vector4f &centroid)
+{
+  const size_t nr_points = cloud.size ();
+  float sum_x = 0.0f, sum_y = 0.0f, sum_z = 0.0f;
+  size_t count = 0, i = 0;
+
+#ifdef __SSE__
+  if (nr_points >= 4)
+  {
+    const float *px = &cloud.x[0], *py = &cloud.y[0], *pz = &cloud.z[0];
+    __m128 vsum_x = _mm_setzero_ps (), vsum_y = _mm_setzero_ps (), vsum_z = _mm_setzero_ps ();
+    if (cloud.is_dense)
+    {
+      for (; i + 4 <= nr_points; i += 4)
+      {
+        vsum_x = _mm_add_ps (vsum_x, _mm_load_ps (px + i));
+        vsum_y = _mm_add_ps (vsum_y, _mm_load_ps (py + i));
+        vsum_z = _mm_add_ps (vsum_z, _mm_load_ps (pz + i));
+      }
+      count = i;
+    }
+    else
+    {
+      for (; i + 4 <= nr_points; i += 4)
+      {
+        const __m128 x = _mm_load_ps (px + i), y = _mm_load_ps (py + i), z = _mm_load_ps (pz + i);
+        const __m128 valid = finiteMask (x, y, z);
+        vsum_x = _mm_add_ps (vsum_x, _mm_and_ps (valid, x));
+        vsum_y = _mm_add_ps (vsum_y, _mm_and_ps (valid, y));
+        vsum_z = _mm_add_ps (vsum_z, _mm_and_ps (valid, z));
+        count += mask_bit_count[_mm_movemask_ps (valid)];
+      }
+    }
+    sum_x = horizontalSum (vsum_x);
+    sum_y = horizontalSum (vsum_y);
+    sum_z = horizontalSum (vsum_z);
+  }
+#endif
+
+  for (; i < nr_points; ++i)
+  {
+    const float x = cloud.x[i], y = cloud.y[i], z = cloud.z[i];
+    if (!cloud.is_dense && (!pcl_isfinite (x) || !pcl_isfinite (y) || !pcl_isfinite (z)))
+      continue;
+    sum_x += x; sum_y += y; sum_z += z;
+    ++count;
+  }
+
+  if (count == 0)
+    return (0);
+  const float inv_count = 1.0f / static_cast<float> (count);
+  centroid = Eigen::Vector4f (sum_x * inv_count, sum_y * inv_count, sum_z * inv_count, 0.0f);
+  return (static_cast<unsigned int> (count));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::transformPointCloud (const pcl::PointCloudSoA &cloud_in,
+                          pcl::PointCloudSoA &cloud_out,
+                          const Eigen::Affine3f &transform)
+{
+  const size_t nr_points = cloud_in.size ();
+  if (&cloud_in != &cloud_out)
+  {
+    // Copy the channels, the coordinates are overwritten below
+    const std::vector<std::string> names_out = cloud_out.getChannelNames ();
+    for (size_t c = 0; c < names_out.size (); ++c)
+      if (!cloud_in.getChannel (names_out[c]))
+        cloud_out.removeChannel (names_out[c]);
+    const std::vector<std::string> names_in = cloud_in.getChannelNames ();
+    for (size_t c = 0; c < names_in.size (); ++c)
+      cloud_out.addChannel (names_in[c]) = *cloud_in.getChannel (names_in[c]);
+
+    cloud_out.header = cloud_in.header;
+    cloud_out.resize (nr_points);
+    cloud_out.width = cloud_in.width;
+    cloud_out.height = cloud_in.height;
+    cloud_out.is_dense = cloud_in.is_dense;
+  }
+
+  const Eigen::Matrix4f &m = transform.matrix ();
+  size_t i = 0;
+
+#ifdef __SSE__
+  if (nr_points >= 4)
+  {
+    const float *px = &cloud_in.x[0], *py = &cloud_in.y[0], *pz = &cloud_in.z[0];
+    float *qx = &cloud_out.x[0], *qy = &cloud_out.y[0], *qz = &cloud_out.z[0];
+    const __m128 m00 = _mm_set1_ps (m (0, 0)), m01 = _mm_set1_ps (m (0, 1)), m02 = _mm_set1_ps (m (0, 2)), m03 = _mm_set1_ps (m (0, 3));
+    const __m128 m10 = _mm_set1_ps (m (1, 0)), m11 = _mm_set1_ps (m (1, 1)), m12 = _mm_set1_ps (m (1, 2)), m13 = _mm_set1_ps (m (1, 3));
+    const __m128 m20 = _mm_set1_ps (m (2, 0)), m21 = _mm_set1_ps (m (2, 1)), m22 = _mm_set1_ps (m (2, 2)), m23 = _mm_set1_ps (m (2, 3));
+    for (; i + 4 <= nr_points; i += 4)
+    {
+      // All the coordinates are loaded before storing, so that cloud_in can be cloud_out
+      const __m128 x = _mm_load_ps (px + i), y = _mm_load_ps (py + i), z = _mm_load_ps (pz + i);
+      _mm_store_ps (qx + i, _mm_add_ps (_mm_add_ps (_mm_mul_ps (m00, x), _mm_mul_ps (m01, y)), _mm_add_ps (_mm_mul_ps (m02, z), m03)));
+      _mm_store_ps (qy + i, _mm_add_ps (_mm_add_ps (_mm_mul_ps (m10, x), _mm_mul_ps (m11, y)), _mm_add_ps (_mm_mul_ps (m12, z), m13)));
+      _mm_store_ps (qz + i, _mm_add_ps (_mm_add_ps (_mm_mul_ps (m20, x), _mm_mul_ps (m21, y)), _mm_add_ps (_mm_mul_ps (m22, z), m23)));
+    }
+  }
+#endif
+
+  for (; i < nr_points; ++i)
+  {
+    const float x = cloud_in.x[i], y = cloud_in.y[i], z = cloud_in.z[i];
+    cloud_out.x[i] = m (0, 0) * x + m (0, 1) * y + m (0, 2) * z + m (0, 3);
+    cloud_out.y[i] = m (1, 0) * x + m (1, 1) * y + m (1, 2) * z + m (1, 3);
+    cloud_out.z[i] = m (2, 0) * x + m (2, 1) * y + m (2, 2) * z + m (2, 3);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::getPlaneDistances (const pcl::PointCloudSoA &cloud, const Eigen::Vector4f &plane_coefficients,
+                        std::vector<float> &distances)
+{
+  const size_t nr_points = cloud.size ();
+  distances.resize (nr_points);
+  const float a = plane_coefficients[0], b = plane_coefficients[1], c = plane_coefficients[2], d = plane_coefficients[3];
+  size_t i = 0;
+
+#ifdef __SSE__
+  if (nr_points >= 4)
+  {
+    const float *px = &cloud.x[0], *py = &cloud.y[0], *pz = &cloud.z[0];
+    const __m128 va = _mm_set1_ps (a), vb = _mm_set1_ps (b), vc = _mm_set1_ps (c), vd = _mm_set1_ps (d);
+    const __m128 sign = _mm_set1_ps (-0.0f);
+    for (; i + 4 <= nr_points; i += 4)
+    {
+      const __m128 dist = _mm_add_ps (_mm_add_ps (_mm_mul_ps (va, _mm_load_ps (px + i)), _mm_mul_ps (vb, _mm_load_ps (py + i))),
+                                      _mm_add_ps (_mm_mul_ps (vc, _mm_load_ps (pz + i)), vd));
+      _mm_storeu_ps (&distances[i], _mm_andnot_ps (sign, dist));
+    }
+  }
+#endif
+
+  for (; i < nr_points; ++i)
+    distances[i] = fabsf (a * cloud.x[i] + b * cloud.y[i] + c * cloud.z[i] + d);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::getSquaredDistances (const pcl::PointCloudSoA &cloud, const Eigen::Vector3f &pivot_pt,
+                          std::vector<float> &distances)
+{
+  const size_t nr_points = cloud.size ();
+  distances.resize (nr_points);
+  size_t i = 0;
+
+#ifdef __SSE__
+  if (nr_points >= 4)
+  {
+    const float *px = &cloud.x[0], *py = &cloud.y[0], *pz = &cloud.z[0];
+    const __m128 cx = _mm_set1_ps (pivot_pt[0]), cy = _mm_set1_ps (pivot_pt[1]), cz = _mm_set1_ps (pivot_pt[2]);
+    for (; i + 4 <= nr_points; i += 4)
+    {
+      const __m128 dx = _mm_sub_ps (_mm_load_ps (px + i), cx);
+      const __m128 dy = _mm_sub_ps (_mm_load_ps (py + i), cy);
+      const __m128 dz = _mm_sub_ps (_mm_load_ps (pz + i), cz);
+      _mm_storeu_ps (&distances[i], _mm_add_ps (_mm_add_ps (_mm_mul_ps (dx, dx), _mm_mul_ps (dy, dy)), _mm_mul_ps (dz, dz)));
+    }
+  }
+#endif
+
+  for (; i < nr_points; ++i)
+  {
+    const float dx = cloud.x[i] - pivot_pt[0], dy = cloud.y[i] - pivot_pt[1], dz = cloud.z[i] - pivot_pt[2];
+    distances[i] = dx * dx + dy * dy + dz * dz;
+  }
+}
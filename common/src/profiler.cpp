@@ -0,0 +1,523 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+#include <pcl/common/profiler.h>
+
+#include <cstring>
+#include <fstream>
+#include <iomanip>
+#include <limits>
+#include <list>
+#include <sstream>
+
+namespace
+{
+  /** \brief Counters of a scope, identified by their names. */
+  typedef std::vector<std::pair<const char*, double> > Counters;
+
+  void
+  addToCounters (Counters &counters, const char* name, double value)
+  {
+    for (size_t i = 0; i < counters.size (); ++i)
+    {
+      if (counters[i].first == name || std::strcmp (counters[i].first, name) == 0)
+      {
+        counters[i].second += value;
+        return;
+      }
+    }
+    counters.push_back (std::make_pair (name, value));
+  }
+
+  /** \brief Statistics of a scope in the tree of a thread. */
+  struct ScopeNode
+  {
+    ScopeNode (const std::string &node_name)
+      : name (node_name), calls (0), total (0.0)
+      , min (std::numeric_limits<double>::max ()), max (0.0), counters (), children ()
+    {
+    }
+
+    template <typename NameT> ScopeNode&
+    getChild (const NameT &child_name)
+    {
+      for (std::list<ScopeNode>::iterator it = children.begin (); it != children.end (); ++it)
+        if (it->name == child_name)
+          return (*it);
+      children.push_back (ScopeNode (child_name));
+      return (children.back ());
+    }
+
+    std::string name;
+    size_t calls;
+    /** \brief Times in microseconds. */
+    double total, min, max;
+    Counters counters;
+    /** \brief A list, so that the nodes do not move when children are added. */
+    std::list<ScopeNode> children;
+  };
+
+  /** \brief A scope opened by a thread. */
+  struct OpenScope
+  {
+    OpenScope () : node (NULL), start (0.0), counters () {}
+
+    ScopeNode* node;
+    double start;
+    /** \brief The counters added to this call of the scope, for the trace. */
+    Counters counters;
+  };
+
+  /** \brief A closed scope, for the trace. */
+  struct TraceEvent
+  {
+    const ScopeNode* node;
+    double start, duration;
+    Counters counters;
+  };
+
+  /** \brief Statistics of a scope, merged over all the threads. */
+  struct ReportNode
+  {
+    ReportNode (const std::string &node_name)
+      : name (node_name), calls (0), threads (0), total (0.0)
+      , min (std::numeric_limits<double>::max ()), max (0.0), counters (), children ()
+    {
+    }
+
+    void
+    merge (const ScopeNode &node)
+    {
+      if (node.calls > 0)
+      {
+        calls += node.calls;
+        ++threads;
+        total += node.total;
+        min = std::min (min, node.min);
+        max = std::max (max, node.max);
+      }
+      for (size_t i = 0; i < node.counters.size (); ++i)
+      {
+        size_t c = 0;
+        while (c < counters.size () && counters[c].first != node.counters[i].first)
+          ++c;
+        if (c == counters.size ())
+          counters.push_back (std::make_pair (std::string (node.counters[i].first), 0.0));
+        counters[c].second += node.counters[i].second;
+      }
+      for (std::list<ScopeNode>::const_iterator it = node.children.begin (); it != node.children.end (); ++it)
+      {
+        size_t c = 0;
+        while (c < children.size () && children[c].name != it->name)
+          ++c;
+        if (c == children.size ())
+          children.push_back (ReportNode (it->name));
+        children[c].merge (*it);
+      }
+    }
+
+    /** \brief The time spent in the scope and not in its children, in microseconds. */
+    double
+    getSelfTime () const
+    {
+      double self = total;
+      for (size_t c = 0; c < children.size (); ++c)
+        self -= children[c].total;
+      return (std::max (self, 0.0));
+    }
+
+    std::string name;
+    size_t calls;
+    int threads;
+    double total, min, max;
+    std::vector<std::pair<std::string, double> > counters;
+    std::vector<ReportNode> children;
+  };
+
+  std::string
+  escapeJSON (const std::string &str)
+  {
+    std::ostringstream os;
+    for (size_t i = 0; i < str.size (); ++i)
+    {
+      const unsigned char c = static_cast<unsigned char> (str[i]);
+      if (c == '"' || c == '\\')
+        os << '\\' << str[i];
+      else if (c < 0x20)
+        os << "\\u" << std::hex << std::setw (4) << std::setfill ('0') << static_cast<int> (c) << std::dec;
+      else
+        os << str[i];
+    }
+    return (os.str ());
+  }
+
+  void
+  writeJSONCounters (std::ostream &os, const std::vector<std::pair<std::string, double> > &counters)
+  {
+    os << "{";
+    for (size_t i = 0; i < counters.size (); ++i)
+      os << (i > 0 ? ", " : "") << "\"" << escapeJSON (counters[i].first) << "\": " << counters[i].second;
+    os << "}";
+  }
+
+  void
+  writeJSONNode (std::ostream &os, const ReportNode &node, int indent)
+  {
+    const std::string pad (indent, ' ');
+    os << pad << "{\n"
+       << pad << "  \"name\": \"" << escapeJSON (node.name) << "\",\n"
+       << pad << "  \"calls\": " << node.calls << ",\n"
+       << pad << "  \"threads\": " << node.threads << ",\n"
+       << pad << "  \"total_ms\": " << node.total * 1e-3 << ",\n"
+       << pad << "  \"self_ms\": " << node.getSelfTime () * 1e-3 << ",\n"
+       << pad << "  \"mean_ms\": " << (node.calls > 0 ? node.total * 1e-3 / static_cast<double> (node.calls) : 0.0) << ",\n"
+       << pad << "  \"min_ms\": " << (node.calls > 0 ? node.min * 1e-3 : 0.0) << ",\n"
+       << pad << "  \"max_ms\": " << node.max * 1e-3 << ",\n"
+       << pad << "  \"counters\": ";
+    writeJSONCounters (os, node.counters);
+    os << ",\n" << pad << "  \"children\": [";
+    for (size_t c = 0; c < node.children.size (); ++c)
+    {
+      os << (c > 0 ? ",\n" : "\n");
+      writeJSONNode (os, node.children[c], indent + 4);
+    }
+    os << (node.children.empty () ? "" : "\n" + pad + "  ") << "]\n" << pad << "}";
+  }
+
+  void
+  writeTextNode (std::ostream &os, const ReportNode &node, int depth)
+  {
+    os << std::string (2 * depth, ' ') << node.name
+       << "  calls " << node.calls
+       << "  total " << node.total * 1e-3 << " ms"
+       << "  self " << node.getSelfTime () * 1e-3 << " ms"
+       << "  min " << (node.calls > 0 ? node.min * 1e-3 : 0.0) << " ms"
+       << "  max " << node.max * 1e-3 << " ms";
+    if (node.threads > 1)
+      os << "  threads " << node.threads;
+    for (size_t i = 0; i < node.counters.size (); ++i)
+      os << (i == 0 ? "  [" : ", ") << node.counters[i].first << " " << node.counters[i].second
+         << (i + 1 == node.counters.size () ? "]" : "");
+    os << "\n";
+    for (size_t c = 0; c < node.children.size (); ++c)
+      writeTextNode (os, node.children[c], depth + 1);
+  }
+}
+
+/** \brief The scopes recorded by a thread. */
+struct pcl::Profiler::ThreadData
+{
+  ThreadData (int thread_id) : id (thread_id), root (""), stack (), depth (0), events (), mutex () {}
+
+  /** \brief The number of the thread, in the order of first use. */
+  int id;
+  /** \brief The top level of the scope tree. */
+  ScopeNode root;
+  /** \brief The open scopes, of which the first \a depth are used (the others keep their counters allocated). */
+  std::vector<OpenScope> stack;
+  size_t depth;
+  std::vector<TraceEvent> events;
+  /** \brief Taken by the thread while recording, and by the reports. */
+  boost::mutex mutex;
+};
+
+bool pcl::Profiler::enabled_ = false;
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::Profiler::Profiler ()
+  : threads_ ()
+  , epoch_ (boost::posix_time::microsec_clock::universal_time ())
+  , trace_enabled_ (true)
+  , max_trace_events_ (1 << 20)
+  , mutex_ ()
+  , thread_data_ ()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::Profiler&
+pcl::Profiler::getInstance ()
+{
+  static Profiler profiler;
+  return (profiler);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::setEnabled (bool enabled)
+{
+  getInstance ();
+  enabled_ = enabled;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::setTraceEnabled (bool enabled)
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  trace_enabled_ = enabled;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::Profiler::isTraceEnabled () const
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  return (trace_enabled_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::setMaxTraceEvents (size_t max_events)
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  max_trace_events_ = max_events;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::reset ()
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  for (size_t t = 0; t < threads_.size (); ++t)
+  {
+    ThreadData &data = *threads_[t];
+    boost::mutex::scoped_lock thread_lock (data.mutex);
+    data.root.children.clear ();
+    data.root.counters.clear ();
+    data.depth = 0;
+    data.events.clear ();
+  }
+  epoch_ = boost::posix_time::microsec_clock::universal_time ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::Profiler::ThreadData&
+pcl::Profiler::getThreadData ()
+{
+  boost::shared_ptr<ThreadData>* data = thread_data_.get ();
+  if (!data)
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    data = new boost::shared_ptr<ThreadData> (new ThreadData (static_cast<int> (threads_.size ())));
+    threads_.push_back (*data);
+    thread_data_.reset (data);
+  }
+  return (**data);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+double
+pcl::Profiler::getTimestamp () const
+{
+  return (static_cast<double> ((boost::posix_time::microsec_clock::universal_time () - epoch_).total_microseconds ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::beginScope (const char* name)
+{
+  ThreadData &data = getThreadData ();
+  boost::mutex::scoped_lock lock (data.mutex);
+  ScopeNode &parent = data.depth == 0 ? data.root : *data.stack[data.depth - 1].node;
+  if (data.depth == data.stack.size ())
+    data.stack.push_back (OpenScope ());
+  OpenScope &scope = data.stack[data.depth++];
+  scope.node = &parent.getChild (name);
+  scope.start = getTimestamp ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::beginScope (const std::string &prefix, const char* name)
+{
+  beginScope ((prefix + "::" + name).c_str ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::endScope ()
+{
+  const double end = getTimestamp ();
+  ThreadData &data = getThreadData ();
+  boost::mutex::scoped_lock lock (data.mutex);
+  // the scopes open during a reset are dropped
+  if (data.depth == 0)
+    return;
+  OpenScope &scope = data.stack[--data.depth];
+  ScopeNode &node = *scope.node;
+  const double duration = end - scope.start;
+  node.calls++;
+  node.total += duration;
+  node.min = std::min (node.min, duration);
+  node.max = std::max (node.max, duration);
+
+  if (trace_enabled_ && data.events.size () < max_trace_events_)
+  {
+    data.events.push_back (TraceEvent ());
+    TraceEvent &event = data.events.back ();
+    event.node = &node;
+    event.start = scope.start;
+    event.duration = duration;
+    event.counters = scope.counters;
+  }
+  scope.counters.clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::addCounter (const char* name, double value)
+{
+  ThreadData &data = getThreadData ();
+  boost::mutex::scoped_lock lock (data.mutex);
+  if (data.depth == 0)
+  {
+    addToCounters (data.root.counters, name, value);
+    return;
+  }
+  OpenScope &scope = data.stack[data.depth - 1];
+  addToCounters (scope.node->counters, name, value);
+  if (trace_enabled_)
+    addToCounters (scope.counters, name, value);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::writeReport (std::ostream &os) const
+{
+  ReportNode root ("");
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    for (size_t t = 0; t < threads_.size (); ++t)
+    {
+      boost::mutex::scoped_lock thread_lock (threads_[t]->mutex);
+      root.merge (threads_[t]->root);
+    }
+  }
+
+  std::ostringstream report;
+  report << std::setprecision (12);
+  for (size_t i = 0; i < root.counters.size (); ++i)
+    report << root.counters[i].first << " " << root.counters[i].second << "\n";
+  for (size_t c = 0; c < root.children.size (); ++c)
+    writeTextNode (report, root.children[c], 0);
+  os << report.str ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::writeJSON (std::ostream &os) const
+{
+  ReportNode root ("");
+  size_t nr_threads = 0;
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    nr_threads = threads_.size ();
+    for (size_t t = 0; t < threads_.size (); ++t)
+    {
+      boost::mutex::scoped_lock thread_lock (threads_[t]->mutex);
+      root.merge (threads_[t]->root);
+    }
+  }
+
+  std::ostringstream report;
+  report << std::setprecision (10);
+  report << "{\n  \"threads\": " << nr_threads << ",\n  \"counters\": ";
+  writeJSONCounters (report, root.counters);
+  report << ",\n  \"scopes\": [";
+  for (size_t c = 0; c < root.children.size (); ++c)
+  {
+    report << (c > 0 ? ",\n" : "\n");
+    writeJSONNode (report, root.children[c], 4);
+  }
+  report << (root.children.empty () ? "" : "\n  ") << "]\n}\n";
+  os << report.str ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::Profiler::writeChromeTrace (std::ostream &os) const
+{
+  std::ostringstream trace;
+  trace << std::setprecision (15);
+  trace << "{\"displayTimeUnit\": \"ms\", \"traceEvents\": [";
+  bool first = true;
+  boost::mutex::scoped_lock lock (mutex_);
+  for (size_t t = 0; t < threads_.size (); ++t)
+  {
+    ThreadData &data = *threads_[t];
+    boost::mutex::scoped_lock thread_lock (data.mutex);
+    trace << (first ? "\n" : ",\n")
+          << "{\"name\": \"thread_name\", \"ph\": \"M\", \"pid\": 0, \"tid\": " << data.id
+          << ", \"args\": {\"name\": \"thread " << data.id << "\"}}";
+    first = false;
+    for (size_t e = 0; e < data.events.size (); ++e)
+    {
+      const TraceEvent &event = data.events[e];
+      trace << ",\n{\"name\": \"" << escapeJSON (event.node->name) << "\", \"cat\": \"pcl\", \"ph\": \"X\", \"pid\": 0, \"tid\": " << data.id
+            << ", \"ts\": " << event.start << ", \"dur\": " << event.duration << ", \"args\": {";
+      for (size_t i = 0; i < event.counters.size (); ++i)
+        trace << (i > 0 ? ", " : "") << "\"" << escapeJSON (event.counters[i].first) << "\": " << event.counters[i].second;
+      trace << "}}";
+    }
+  }
+  trace << "\n]}\n";
+  os << trace.str ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::Profiler::saveJSON (const std::string &file_name) const
+{
+  std::ofstream file (file_name.c_str ());
+  if (!file.is_open ())
+    return (false);
+  writeJSON (file);
+  return (file.good ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::Profiler::saveChromeTrace (const std::string &file_name) const
+{
+  std::ofstream file (file_name.c_str ());
+  if (!file.is_open ())
+    return (false);
+  writeChromeTrace (file);
+  return (file.good ());
+}
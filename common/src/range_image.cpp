@@ -304,6 +304,7 @@ RangeImage::cropImage (int borderSize, int top, int right, int bottom, int left)
 void 
 RangeImage::recalculate3DPointPositions () 
 {
+  # pragma omp parallel for num_threads (max_no_of_threads) default (shared) schedule (static)
   for (int y = 0; y < static_cast<int> (height); ++y) 
   {
     for (int x = 0; x < static_cast<int> (width); ++x) 
@@ -137,6 +137,7 @@ namespace pcl
     center_y_ = static_cast<float> (di_center_y) / static_cast<float> (skip);
     points.resize (width * height);
     
+    # pragma omp parallel for num_threads (max_no_of_threads) default (shared) schedule (static)
     for (int y=0; y < static_cast<int> (height); ++y)
     {
       for (int x=0; x < static_cast<int> (width); ++x)
@@ -183,6 +184,7 @@ namespace pcl
     center_y_ = static_cast<float> (di_center_y) / static_cast<float> (skip);
     points.resize (width * height);
     
+    # pragma omp parallel for num_threads (max_no_of_threads) default (shared) schedule (static)
     for (int y = 0; y < static_cast<int> (height); ++y)
     {
       for (int x = 0; x < static_cast<int> (width); ++x)
@@ -0,0 +1,231 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <pcl/common/task_scheduler.h>
+#include <boost/bind.hpp>
+
+#include <algorithm>
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::TaskGroup::~TaskGroup ()
+{
+  wait ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::TaskGroup::spawn (Task &task)
+{
+  ++pending_;
+  TaskScheduler::getInstance ().spawn (task, *this);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::TaskGroup::wait ()
+{
+  TaskScheduler &scheduler = TaskScheduler::getInstance ();
+  while (pending_ != 0)
+  {
+    // Help with the queued tasks, which may be ours, and sleep once there are none left
+    if (scheduler.runOneTask ())
+      continue;
+    boost::mutex::scoped_lock lock (scheduler.mutex_);
+    if (pending_ != 0 && scheduler.nr_queued_ == 0)
+      scheduler.wake_.wait (lock);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::TaskScheduler&
+pcl::TaskScheduler::getInstance ()
+{
+  static TaskScheduler scheduler;
+  return (scheduler);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::TaskScheduler::TaskScheduler ()
+  : nr_threads_ (std::max (boost::thread::hardware_concurrency (), 1u))
+  , queues_ ()
+  , workers_ ()
+  , worker_index_ ()
+  , nr_queued_ (0)
+  , stopping_ (false)
+  , mutex_ ()
+  , wake_ ()
+{
+  start ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::TaskScheduler::~TaskScheduler ()
+{
+  stop ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::TaskScheduler::setNumberOfThreads (unsigned int nr_threads)
+{
+  if (nr_threads == 0)
+    nr_threads = std::max (boost::thread::hardware_concurrency (), 1u);
+  if (nr_threads == nr_threads_)
+    return;
+  stop ();
+  nr_threads_ = nr_threads;
+  start ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::TaskScheduler::isWorkerThread () const
+{
+  return (worker_index_.get () != NULL);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::TaskScheduler::start ()
+{
+  queues_.resize (nr_threads_);
+  for (size_t i = 0; i < queues_.size (); ++i)
+    queues_[i].reset (new Queue);
+  for (size_t i = 0; i + 1 < queues_.size (); ++i)
+    workers_.push_back (boost::shared_ptr<boost::thread> (new boost::thread (boost::bind (&TaskScheduler::runWorker, this, i))));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::TaskScheduler::stop ()
+{
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    stopping_ = true;
+    wake_.notify_all ();
+  }
+  for (size_t i = 0; i < workers_.size (); ++i)
+    workers_[i]->join ();
+  workers_.clear ();
+  queues_.clear ();
+  stopping_ = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+size_t
+pcl::TaskScheduler::getQueueIndex () const
+{
+  const size_t *index = worker_index_.get ();
+  return (index ? *index : queues_.size () - 1);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::TaskScheduler::spawn (Task &task, TaskGroup &group)
+{
+  Queue &queue = *queues_[getQueueIndex ()];
+  {
+    boost::mutex::scoped_lock lock (queue.mutex);
+    queue.items.push_back (Item (&task, &group));
+  }
+  ++nr_queued_;
+  boost::mutex::scoped_lock lock (mutex_);
+  wake_.notify_one ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::TaskScheduler::runOneTask ()
+{
+  if (nr_queued_ == 0)
+    return (false);
+
+  // The newest task of our own queue is the most likely to be in cache, the oldest task of
+  // another queue is the largest piece of work left by its owner
+  const size_t nr_queues = queues_.size ();
+  const size_t self = getQueueIndex ();
+  Item item;
+  {
+    Queue &queue = *queues_[self];
+    boost::mutex::scoped_lock lock (queue.mutex);
+    if (!queue.items.empty ())
+    {
+      item = queue.items.back ();
+      queue.items.pop_back ();
+    }
+  }
+  for (size_t i = 1; !item.task && i < nr_queues; ++i)
+  {
+    Queue &queue = *queues_[(self + i) % nr_queues];
+    boost::mutex::scoped_lock lock (queue.mutex);
+    if (!queue.items.empty ())
+    {
+      item = queue.items.front ();
+      queue.items.pop_front ();
+    }
+  }
+  if (!item.task)
+    return (false);
+  --nr_queued_;
+
+  item.task->execute ();
+  if (--item.group->pending_ == 0)
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    wake_.notify_all ();
+  }
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::TaskScheduler::runWorker (size_t index)
+{
+  worker_index_.reset (new size_t (index));
+  while (true)
+  {
+    if (runOneTask ())
+      continue;
+    boost::mutex::scoped_lock lock (mutex_);
+    if (stopping_)
+      break;
+    if (nr_queued_ == 0)
+      wake_.wait (lock);
+  }
+}
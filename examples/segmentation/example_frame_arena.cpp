@@ -0,0 +1,187 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ * Point Cloud Library (PCL) - www.pointclouds.org
+ * Copyright (c) 2012-, Open Perception, Inc.
+ *
+ * All rights reserved.
+ *
+ * Redistribution and use in source and binary forms, with or without
+ * modification, are permitted provided that the following conditions
+ * are met:
+ *
+ * * Redistributions of source code must retain the above copyright
+ *   notice, this list of conditions and the following disclaimer.
+ * * Redistributions in binary form must reproduce the above
+ *   copyright notice, this list of conditions and the following
+ *   disclaimer in the documentation and/or other materials provided
+ *   with the distribution.
+ * * Neither the name of Willow Garage, Inc. nor the names of its
+ *   contributors may be used to endorse or promote products derived
+ *   from this software without specific prior written permission.
+ *
+ * THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ * "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ * LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ * FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ * COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ * INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ * BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ * LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ * CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ * LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ * ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ * POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <iostream>
+#include <cstdlib>
+
+#include <pcl/io/pcd_io.h>
+#include <pcl/point_types.h>
+#include <pcl/common/frame_arena.h>
+#include <pcl/common/io.h>
+#include <pcl/common/time.h>
+#include <pcl/filters/passthrough.h>
+#include <pcl/filters/voxel_grid.h>
+#include <pcl/features/normal_3d.h>
+#include <pcl/search/kdtree.h>
+#include <pcl/segmentation/extract_clusters.h>
+
+typedef pcl::PointXYZ PointT;
+typedef pcl::PointCloud<PointT> Cloud;
+typedef pcl::PointCloud<pcl::Normal> Normals;
+
+// The calls to malloc, which is used by operator new and by Eigen for the points
+static size_t nr_allocator_calls = 0;
+static size_t nr_allocated_bytes = 0;
+
+#if defined (__GLIBC__)
+extern "C" void* __libc_malloc (size_t size);
+
+extern "C" void*
+malloc (size_t size)
+{
+  ++nr_allocator_calls;
+  nr_allocated_bytes += size;
+  return (__libc_malloc (size));
+}
+#endif
+
+// A typical per-frame pipeline, whose stages are kept from one frame to the next
+struct Pipeline
+{
+  Pipeline () : pass (), grid (), normal_estimation (), clustering (), tree (new pcl::search::KdTree<PointT>)
+  {
+    pass.setFilterFieldName ("z");
+    pass.setFilterLimits (0.0f, 1.5f);
+    grid.setLeafSize (0.01f, 0.01f, 0.01f);
+    normal_estimation.setSearchMethod (tree);
+    normal_estimation.setRadiusSearch (0.03);
+    clustering.setSearchMethod (tree);
+    clustering.setClusterTolerance (0.02);
+    clustering.setMinClusterSize (100);
+    clustering.setMaxClusterSize (25000);
+  }
+
+  // Get a temporary from the arena, or allocate it as usual without arena
+  template <typename T> static boost::shared_ptr<T>
+  getTemporary (pcl::FrameArena *arena)
+  {
+    return (arena ? arena->get<T> () : boost::shared_ptr<T> (new T));
+  }
+
+  // Process a frame, and return the number of clusters
+  size_t
+  process (const Cloud::ConstPtr &frame, pcl::FrameArena *arena)
+  {
+    Cloud::Ptr filtered = getTemporary<Cloud> (arena);
+    pass.setInputCloud (frame);
+    pass.filter (*filtered);
+
+    Cloud::Ptr downsampled = getTemporary<Cloud> (arena);
+    grid.setInputCloud (filtered);
+    grid.filter (*downsampled);
+
+    Normals::Ptr normals = getTemporary<Normals> (arena);
+    normal_estimation.setInputCloud (downsampled);
+    normal_estimation.compute (*normals);
+
+    boost::shared_ptr<std::vector<pcl::PointIndices> > clusters = getTemporary<std::vector<pcl::PointIndices> > (arena);
+    clustering.setInputCloud (downsampled);
+    clustering.extract (*clusters);
+
+    // Extract the points of every cluster, and the neighbors of their first point
+    for (size_t c = 0; c < clusters->size (); ++c)
+    {
+      Cloud::Ptr cluster = getTemporary<Cloud> (arena);
+      pcl::copyPointCloud (*downsampled, (*clusters)[c].indices, *cluster);
+
+      boost::shared_ptr<std::vector<int> > k_indices = getTemporary<std::vector<int> > (arena);
+      boost::shared_ptr<std::vector<float> > k_distances = getTemporary<std::vector<float> > (arena);
+      tree->nearestKSearch (cluster->points[0], 10, *k_indices, *k_distances);
+    }
+    return (clusters->size ());
+  }
+
+  pcl::PassThrough<PointT> pass;
+  pcl::VoxelGrid<PointT> grid;
+  pcl::NormalEstimation<PointT, pcl::Normal> normal_estimation;
+  pcl::EuclideanClusterExtraction<PointT> clustering;
+  pcl::search::KdTree<PointT>::Ptr tree;
+};
+
+int
+main (int argc, char** argv)
+{
+  if (argc < 2)
+  {
+    std::cerr << "Syntax is: " << argv[0] << " input.pcd [number of frames]" << std::endl;
+    return (-1);
+  }
+
+  Cloud::Ptr frame (new Cloud);
+  if (pcl::io::loadPCDFile<PointT> (argv[1], *frame) == -1)
+  {
+    PCL_ERROR ("Couldn't read file %s\n", argv[1]);
+    return (-1);
+  }
+  const int nr_frames = (argc > 2) ? (std::max) (atoi (argv[2]), 2) : 30;
+  std::cout << "Processing " << nr_frames << " times " << frame->points.size () << " points" << std::endl;
+#if !defined (__GLIBC__)
+  std::cout << "The allocator calls are only counted with glibc" << std::endl;
+#endif
+
+  Pipeline pipeline;
+  pcl::FrameArena arena;
+  for (int use_arena = 0; use_arena < 2; ++use_arena)
+  {
+    size_t nr_calls = 0, nr_bytes = 0, nr_clusters = 0;
+    double time = 0;
+    for (int f = 0; f < nr_frames; ++f)
+    {
+      if (use_arena)
+        arena.reset ();
+      const size_t nr_calls_before = nr_allocator_calls, nr_bytes_before = nr_allocated_bytes;
+      pcl::StopWatch watch;
+      nr_clusters = pipeline.process (frame, use_arena ? &arena : NULL);
+      // The first frame fills the arena
+      if (f == 0)
+        continue;
+      time += watch.getTime ();
+      nr_calls += nr_allocator_calls - nr_calls_before;
+      nr_bytes += nr_allocated_bytes - nr_bytes_before;
+    }
+    std::cout << (use_arena ? "With a frame arena:   " : "Without frame arena:  ")
+              << nr_calls / (nr_frames - 1) << " allocator calls ("
+              << nr_bytes / (nr_frames - 1) / 1024 << " KB) and "
+              << time / (nr_frames - 1) << " ms per frame, " << nr_clusters << " clusters" << std::endl;
+  }
+  std::cout << "The arena keeps " << arena.getNumberOfObjects () << " objects, "
+            << arena.getNumberOfReuses () << " reused during the last frame" << std::endl;
+
+  return (0);
+}
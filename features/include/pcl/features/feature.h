@@ -42,6 +42,7 @@
 
 // PCL includes
 #include <pcl/pcl_base.h>
+#include <pcl/common/profiler.h>
 #include <pcl/common/eigen.h>
 #include <pcl/common/centroid.h>
 #include <pcl/search/search.h>
@@ -271,7 +272,9 @@ namespace pcl
       searchForNeighbors (size_t index, double parameter,
                           std::vector<int> &indices, std::vector<float> &distances) const
       {
-        return (search_method_surface_ (*input_, index, parameter, indices, distances));
+        const int nr_neighbors = search_method_surface_ (*input_, index, parameter, indices, distances);
+        PCL_PROFILE_COUNTER ("neighbors visited", nr_neighbors);
+        return (nr_neighbors);
       }
 
       /** \brief Search for k-nearest neighbors using the spatial locator from
@@ -289,7 +292,9 @@ namespace pcl
       searchForNeighbors (const PointCloudIn &cloud, size_t index, double parameter,
                           std::vector<int> &indices, std::vector<float> &distances) const
       {
-        return (search_method_surface_ (cloud, index, parameter, indices, distances));
+        const int nr_neighbors = search_method_surface_ (cloud, index, parameter, indices, distances);
+        PCL_PROFILE_COUNTER ("neighbors visited", nr_neighbors);
+        return (nr_neighbors);
       }
 
     private:
@@ -40,11 +40,12 @@
 
 #include <pcl/features/feature.h>
 #include <pcl/features/fpfh.h>
+#include <pcl/common/task_scheduler.h>
 
 namespace pcl
 {
   /** \brief FPFHEstimationOMP estimates the Fast Point Feature Histogram (FPFH) descriptor for a given point cloud
-    * dataset containing points and normals, in parallel, using the OpenMP standard.
+    * dataset containing points and normals, in parallel, on the threads of the pcl::TaskScheduler.
     *
     * \note If you use this code in any academic work, please cite:
     *
@@ -90,12 +91,13 @@ namespace pcl
       /** \brief Initialize the scheduler and set the number of threads to use.
         * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
         */
-      FPFHEstimationOMP (unsigned int nr_threads = 0) : nr_bins_f1_ (11), nr_bins_f2_ (11), nr_bins_f3_ (11), threads_ (nr_threads)
+      FPFHEstimationOMP (unsigned int nr_threads = 0) : nr_bins_f1_ (11), nr_bins_f2_ (11), nr_bins_f3_ (11), threads_ (nr_threads),
+                                                         spfh_indices_ (), spfh_hist_lookup_ ()
       {
         feature_name_ = "FPFHEstimationOMP";
       }
 
-      /** \brief Initialize the scheduler and set the number of threads to use.
+      /** \brief Set the maximum number of threads of the pcl::TaskScheduler to use.
         * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
         */
       inline void 
@@ -110,6 +112,22 @@ namespace pcl
       void 
       computeFeature (PointCloudOut &output);
 
+      /** \brief Compute the SPFH signatures of the points [begin, end) of spfh_indices_, run in parallel by computeFeature.
+        * \param[in] begin the first index
+        * \param[in] end the index after the last one
+        * \param[out] spfh_hist_lookup the row of the signature of every point of the surface
+        */
+      void
+      computeSPFHRange (int begin, int end, std::vector<int> &spfh_hist_lookup);
+
+      /** \brief Compute the FPFH signatures of the points [begin, end) of the indices, run in parallel by computeFeature.
+        * \param[in] begin the first index
+        * \param[in] end the index after the last one
+        * \param[out] output the resultant point cloud, of the size of the indices
+        */
+      void
+      computeFPFHRange (int begin, int end, PointCloudOut &output);
+
     public:
       /** \brief The number of subdivisions for each angular feature interval. */
       int nr_bins_f1_, nr_bins_f2_, nr_bins_f3_;
@@ -117,6 +135,12 @@ namespace pcl
       /** \brief The number of threads the scheduler should use. */
       unsigned int threads_;
 
+      /** \brief The indices of the surface points which need a SPFH signature. */
+      std::vector<int> spfh_indices_;
+
+      /** \brief The row of the SPFH signature of every point of the surface. */
+      std::vector<int> spfh_hist_lookup_;
+
       /** \brief Make the computeFeature (&Eigen::MatrixXf); inaccessible from outside the class
         * \param[out] output the output point cloud 
         */
@@ -187,12 +187,14 @@ pcl::Feature<PointInT, PointOutT>::deinitCompute ()
 template <typename PointInT, typename PointOutT> void
 pcl::Feature<PointInT, PointOutT>::compute (PointCloudOut &output)
 {
+  PCL_PROFILE_METHOD_SCOPE (getClassName (), "compute");
   if (!initCompute ())
   {
     output.width = output.height = 0;
     output.points.clear ();
     return;
   }
+  PCL_PROFILE_COUNTER ("points", indices_->size ());
 
   // Copy the header
   output.header = input_->header;
@@ -223,12 +225,14 @@ pcl::Feature<PointInT, PointOutT>::compute (PointCloudOut &output)
 template <typename PointInT, typename PointOutT> void
 pcl::Feature<PointInT, PointOutT>::computeEigen (pcl::PointCloud<Eigen::MatrixXf> &output)
 {
+  PCL_PROFILE_METHOD_SCOPE (getClassName (), "computeEigen");
   if (!initCompute ())
   {
     output.width = output.height = 0;
     output.points.resize (0, 0);
     return;
   }
+  PCL_PROFILE_COUNTER ("points", indices_->size ());
 
   // Copy the properties
 //#ifndef USE_ROS
@@ -46,8 +46,8 @@
 template <typename PointInT, typename PointNT, typename PointOutT> void
 pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloudOut &output)
 {
-  std::vector<int> spfh_indices_vec;
-  std::vector<int> spfh_hist_lookup (surface_->points.size ());
+  spfh_indices_.clear ();
+  spfh_hist_lookup_.resize (surface_->points.size ());
 
   // Build a list of (unique) indices for which we will need to compute SPFH signatures
   // (We need an SPFH signature for every point that is a neighbor of any point in input_[indices_])
@@ -66,35 +66,45 @@ pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloud
       
       spfh_indices_set.insert (nn_indices.begin (), nn_indices.end ());
     }
-    spfh_indices_vec.resize (spfh_indices_set.size ());
-    std::copy (spfh_indices_set.begin (), spfh_indices_set.end (), spfh_indices_vec.begin ());
+    spfh_indices_.resize (spfh_indices_set.size ());
+    std::copy (spfh_indices_set.begin (), spfh_indices_set.end (), spfh_indices_.begin ());
   }
   else
   {
     // Special case: When a feature must be computed at every point, there is no need for a neighborhood search
-    spfh_indices_vec.resize (indices_->size ());
+    spfh_indices_.resize (indices_->size ());
     for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
-      spfh_indices_vec[idx] = idx;
+      spfh_indices_[idx] = idx;
   }
 
   // Initialize the arrays that will store the SPFH signatures
-  size_t data_size = spfh_indices_vec.size ();
+  size_t data_size = spfh_indices_.size ();
   hist_f1_.setZero (data_size, nr_bins_f1_);
   hist_f2_.setZero (data_size, nr_bins_f2_);
   hist_f3_.setZero (data_size, nr_bins_f3_);
 
+  // Compute SPFH signatures for every point that needs them
+  pcl::parallel_for (0, static_cast<int> (spfh_indices_.size ()),
+                     pcl::makeRangeMethod (*this, &FPFHEstimationOMP::computeSPFHRange, spfh_hist_lookup_),
+                     0, threads_);
+
+  // Iterate over the entire index vector
+  pcl::parallel_for (0, static_cast<int> (indices_->size ()),
+                     pcl::makeRangeMethod (*this, &FPFHEstimationOMP::computeFPFHRange, output),
+                     0, threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeSPFHRange (int begin, int end, std::vector<int> &spfh_hist_lookup)
+{
   std::vector<int> nn_indices (k_); // \note These resizes are irrelevant for a radiusSearch ().
   std::vector<float> nn_dists (k_); 
 
-  // Compute SPFH signatures for every point that needs them
-
-#ifdef _OPENMP
-#pragma omp parallel for shared (spfh_hist_lookup) private (nn_indices, nn_dists) num_threads(threads_)
-#endif
-  for (int i = 0; i < static_cast<int> (spfh_indices_vec.size ()); ++i)
+  for (int i = begin; i < end; ++i)
   {
     // Get the next point index
-    int p_idx = spfh_indices_vec[i];
+    int p_idx = spfh_indices_[i];
 
     // Find the neighborhood around p_idx
     if (this->searchForNeighbors (*surface_, p_idx, search_parameter_, nn_indices, nn_dists) == 0)
@@ -106,18 +116,19 @@ pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloud
     // Populate a lookup table for converting a point index to its corresponding row in the spfh_hist_* matrices
     spfh_hist_lookup[p_idx] = i;
   }
+}
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT> void
+pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFPFHRange (int begin, int end, PointCloudOut &output)
+{
   // Intialize the array that will store the FPFH signature
   int nr_bins = nr_bins_f1_ + nr_bins_f2_ + nr_bins_f3_;
 
-  nn_indices.clear();
-  nn_dists.clear();
+  std::vector<int> nn_indices;
+  std::vector<float> nn_dists;
 
-  // Iterate over the entire index vector
-#ifdef _OPENMP
-#pragma omp parallel for shared (output) private (nn_indices, nn_dists) num_threads(threads_)
-#endif
-  for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
+  for (int idx = begin; idx < end; ++idx)
   {
     // Find the indices of point idx's neighbors...
     if (!isFinite ((*input_)[(*indices_)[idx]]) ||
@@ -134,7 +145,7 @@ pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloud
     // ... and remap the nn_indices values so that they represent row indices in the spfh_hist_* matrices 
     // instead of indices into surface_->points
     for (size_t i = 0; i < nn_indices.size (); ++i)
-      nn_indices[i] = spfh_hist_lookup[nn_indices[i]];
+      nn_indices[i] = spfh_hist_lookup_[nn_indices[i]];
 
     // Compute the FPFH signature (i.e. compute a weighted combination of local SPFH signatures) ...
     Eigen::VectorXf fpfh_histogram = Eigen::VectorXf::Zero (nr_bins);
@@ -144,7 +155,6 @@ pcl::FPFHEstimationOMP<PointInT, PointNT, PointOutT>::computeFeature (PointCloud
     for (int d = 0; d < nr_bins; ++d)
       output.points[idx].histogram[d] = fpfh_histogram[d];
   }
-
 }
 
 #define PCL_INSTANTIATE_FPFHEstimationOMP(T,NT,OutT) template class PCL_EXPORTS pcl::FPFHEstimationOMP<T,NT,OutT>;
@@ -141,21 +141,28 @@ pcl::IntensityGradientEstimation <PointInT, PointNT, PointOutT, IntensitySelecto
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointNT, typename PointOutT, typename IntensitySelectorT> void
 pcl::IntensityGradientEstimation<PointInT, PointNT, PointOutT, IntensitySelectorT>::computeFeature (PointCloudOut &output)
+{
+  output.is_dense = true;
+
+  // Iterating over the entire index vector
+  pcl::parallel_for (0, static_cast<int> (indices_->size ()),
+                     pcl::makeRangeMethod (*this, &IntensityGradientEstimation::computeFeatureRange, output),
+                     0, threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT, typename IntensitySelectorT> void
+pcl::IntensityGradientEstimation<PointInT, PointNT, PointOutT, IntensitySelectorT>::computeFeatureRange (int begin, int end, PointCloudOut &output)
 {
   // Allocate enough space to hold the results
   // \note This resize is irrelevant for a radiusSearch ().
   std::vector<int> nn_indices (k_);
   std::vector<float> nn_dists (k_);
-  output.is_dense = true;
 
   // If the data is dense, we don't need to check for NaN
   if (surface_->is_dense)
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output) private (nn_indices, nn_dists) num_threads(threads_)
-#endif
-    // Iterating over the entire index vector
-    for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
+    for (int idx = begin; idx < end; ++idx)
     {
       PointOutT &p_out = output.points[idx];
 
@@ -189,11 +196,7 @@ pcl::IntensityGradientEstimation<PointInT, PointNT, PointOutT, IntensitySelector
   }
   else
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output) private (nn_indices, nn_dists) num_threads(threads_)
-#endif
-    // Iterating over the entire index vector
-    for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
+    for (int idx = begin; idx < end; ++idx)
     {
       PointOutT &p_out = output.points[idx];
       if (!isFinite ((*surface_) [(*indices_)[idx]]) ||
@@ -46,23 +46,29 @@
 template <typename PointInT> void
 pcl::NormalEstimationOMP<PointInT, Eigen::MatrixXf>::computeFeatureEigen (pcl::PointCloud<Eigen::MatrixXf> &output)
 {
-  float vpx, vpy, vpz;
-  getViewPoint (vpx, vpy, vpz);
   output.is_dense = true;
 
   // Resize the output dataset
   output.points.resize (indices_->size (), 4);
 
+  pcl::parallel_for (0, static_cast<int> (indices_->size ()),
+                     pcl::makeRangeMethod (*this, &NormalEstimationOMP::computeFeatureEigenRange, output),
+                     0, threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT> void
+pcl::NormalEstimationOMP<PointInT, Eigen::MatrixXf>::computeFeatureEigenRange (int begin, int end, pcl::PointCloud<Eigen::MatrixXf> &output)
+{
+  float vpx, vpy, vpz;
+  getViewPoint (vpx, vpy, vpz);
+
   // Allocate enough space to hold the results
   // \note This resize is irrelevant for a radiusSearch ().
   std::vector<int> nn_indices (k_);
   std::vector<float> nn_dists (k_);
 
-#ifdef _OPENMP
-#pragma omp parallel for shared (output) private (nn_indices, nn_dists) num_threads(threads_)
-#endif
-  // Iterating over the entire index vector
-  for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
+  for (int idx = begin; idx < end; ++idx)
   {
     if (!isFinite ((*input_)[(*indices_)[idx]]) ||
         this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
@@ -74,13 +80,10 @@ pcl::NormalEstimationOMP<PointInT, Eigen::MatrixXf>::computeFeatureEigen (pcl::P
 
     // 16-bytes aligned placeholder for the XYZ centroid of a surface patch
     Eigen::Vector4f xyz_centroid;
-    // Estimate the XYZ centroid
-    compute3DCentroid (*surface_, nn_indices, xyz_centroid);
-
     // Placeholder for the 3x3 covariance matrix at each surface patch
     EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
-    // Compute the 3x3 covariance matrix
-    computeCovarianceMatrix (*surface_, nn_indices, xyz_centroid, covariance_matrix);
+    // Estimate the XYZ centroid and compute the 3x3 covariance matrix in a single pass
+    computeMeanAndCovarianceMatrix (*surface_, nn_indices, covariance_matrix, xyz_centroid);
 
     // Get the plane normal and surface curvature
     solvePlaneParameters (covariance_matrix,
@@ -94,22 +97,27 @@ pcl::NormalEstimationOMP<PointInT, Eigen::MatrixXf>::computeFeatureEigen (pcl::P
 //////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT> void
 pcl::NormalEstimationOMP<PointInT, PointOutT>::computeFeature (PointCloudOut &output)
+{
+  output.is_dense = true;
+
+  pcl::parallel_for (0, static_cast<int> (indices_->size ()),
+                     pcl::makeRangeMethod (*this, &NormalEstimationOMP::computeFeatureRange, output),
+                     0, threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT> void
+pcl::NormalEstimationOMP<PointInT, PointOutT>::computeFeatureRange (int begin, int end, PointCloudOut &output)
 {
   float vpx, vpy, vpz;
   getViewPoint (vpx, vpy, vpz);
 
-  output.is_dense = true;
-
   // Allocate enough space to hold the results
   // \note This resize is irrelevant for a radiusSearch ().
   std::vector<int> nn_indices (k_);
   std::vector<float> nn_dists (k_);
 
-  // Iterating over the entire index vector
-#ifdef _OPENMP
-#pragma omp parallel for shared (output) private (nn_indices, nn_dists) num_threads(threads_)
-#endif
-  for (int idx = 0; idx < static_cast<int> (indices_->size ()); ++idx)
+  for (int idx = begin; idx < end; ++idx)
   {
     if (!isFinite ((*input_)[(*indices_)[idx]]) ||
         this->searchForNeighbors ((*indices_)[idx], search_parameter_, nn_indices, nn_dists) == 0)
@@ -122,13 +130,10 @@ pcl::NormalEstimationOMP<PointInT, PointOutT>::computeFeature (PointCloudOut &ou
 
     // 16-bytes aligned placeholder for the XYZ centroid of a surface patch
     Eigen::Vector4f xyz_centroid;
-    // Estimate the XYZ centroid
-    compute3DCentroid (*surface_, nn_indices, xyz_centroid);
-
     // Placeholder for the 3x3 covariance matrix at each surface patch
     EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
-    // Compute the 3x3 covariance matrix
-    computeCovarianceMatrix (*surface_, nn_indices, xyz_centroid, covariance_matrix);
+    // Estimate the XYZ centroid and compute the 3x3 covariance matrix in a single pass
+    computeMeanAndCovarianceMatrix (*surface_, nn_indices, covariance_matrix, xyz_centroid);
 
     // Get the plane normal and surface curvature
     solvePlaneParameters (covariance_matrix,
@@ -56,10 +56,16 @@ pcl::SHOTLocalReferenceFrameEstimationOMP<PointInT, PointOutT>::computeFeature (
   tree_->setSortedResults (true);
 
   int data_size = static_cast<int> (indices_->size ());
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads_)
-#endif
-  for (int i = 0; i < data_size; ++i)
+  pcl::parallel_for (0, data_size,
+                     pcl::makeRangeMethod (*this, &SHOTLocalReferenceFrameEstimationOMP::computeFeatureRange, output),
+                     0, threads_);
+}
+
+template<typename PointInT, typename PointOutT>
+void
+pcl::SHOTLocalReferenceFrameEstimationOMP<PointInT, PointOutT>::computeFeatureRange (int begin, int end, PointCloudOut &output)
+{
+  for (int i = begin; i < end; ++i)
   {
     // point result
     Eigen::Matrix3f rf;
@@ -112,10 +118,16 @@ pcl::SHOTLocalReferenceFrameEstimationOMP<PointInT, PointOutT>::computeFeatureEi
   //output.points.resize (indices_->size (), 10);
   output.points.resize (data_size, 9);
 
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads_)
-#endif
-  for (int i = 0; i < data_size; ++i)
+  pcl::parallel_for (0, data_size,
+                     pcl::makeRangeMethod (*this, &SHOTLocalReferenceFrameEstimationOMP::computeFeatureEigenRange, output),
+                     0, threads_);
+}
+
+template<typename PointInT, typename PointOutT>
+void
+pcl::SHOTLocalReferenceFrameEstimationOMP<PointInT, PointOutT>::computeFeatureEigenRange (int begin, int end, pcl::PointCloud<Eigen::MatrixXf> &output)
+{
+  for (int i = begin; i < end; ++i)
   {
     // point result
     Eigen::Matrix3f rf;
@@ -133,10 +133,16 @@ pcl::SHOTEstimationOMP<PointInT, PointNT, PointOutT, PointRFT>::computeFeature (
 
   output.is_dense = true;
   // Iterating over the entire index vector
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads_)
-#endif
-  for (int idx = 0; idx < data_size; ++idx)
+  pcl::parallel_for (0, data_size,
+                     pcl::makeRangeMethod (*this, &SHOTEstimationOMP::computeFeatureRange, output),
+                     0, threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template<typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
+pcl::SHOTEstimationOMP<PointInT, PointNT, PointOutT, PointRFT>::computeFeatureRange (int begin, int end, PointCloudOut &output)
+{
+  for (int idx = begin; idx < end; ++idx)
   {
 
     Eigen::VectorXf shot;
@@ -207,10 +213,16 @@ pcl::SHOTColorEstimationOMP<PointInT, PointNT, PointOutT, PointRFT>::computeFeat
 
   output.is_dense = true;
   // Iterating over the entire index vector
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads_)
-#endif
-  for (int idx = 0; idx < data_size; ++idx)
+  pcl::parallel_for (0, data_size,
+                     pcl::makeRangeMethod (*this, &SHOTColorEstimationOMP::computeFeatureRange, output),
+                     0, threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointNT, typename PointOutT, typename PointRFT> void
+pcl::SHOTColorEstimationOMP<PointInT, PointNT, PointOutT, PointRFT>::computeFeatureRange (int begin, int end, PointCloudOut &output)
+{
+  for (int idx = begin; idx < end; ++idx)
   {
     Eigen::VectorXf shot;
     shot.setZero (descLength_);
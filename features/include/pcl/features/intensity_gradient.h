@@ -41,6 +41,7 @@
 
 #include <pcl/features/feature.h>
 #include <pcl/common/intensity.h>
+#include <pcl/common/task_scheduler.h>
 
 namespace pcl
 {
@@ -71,7 +72,7 @@ namespace pcl
         feature_name_ = "IntensityGradientEstimation";
       };
 
-      /** \brief Initialize the scheduler and set the number of threads to use.
+      /** \brief Set the maximum number of threads of the pcl::TaskScheduler to use.
         * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
         */
       inline void
@@ -85,6 +86,13 @@ namespace pcl
       void
       computeFeature (PointCloudOut &output);
 
+      /** \brief Estimate the intensity gradients of the points [begin, end) of the indices, run in parallel by
+        * computeFeature.
+        * \param output the resultant point cloud, of the size of the indices
+        */
+      void
+      computeFeatureRange (int begin, int end, PointCloudOut &output);
+
       /** \brief Estimate the intensity gradient around a given point based on its spatial neighborhood of points
         * \param cloud a point cloud dataset containing XYZI coordinates (Cartesian coordinates + intensity)
         * \param indices the indices of the neighoring points in the dataset
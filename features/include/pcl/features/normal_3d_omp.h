@@ -41,11 +41,12 @@
 #define PCL_NORMAL_3D_OMP_H_
 
 #include <pcl/features/normal_3d.h>
+#include <pcl/common/task_scheduler.h>
 
 namespace pcl
 {
   /** \brief NormalEstimationOMP estimates local surface properties at each 3D point, such as surface normals and
-    * curvatures, in parallel, using the OpenMP standard.
+    * curvatures, in parallel, on the threads of the pcl::TaskScheduler.
     * \author Radu Bogdan Rusu
     * \ingroup features
     */
@@ -73,7 +74,7 @@ namespace pcl
         feature_name_ = "NormalEstimationOMP";
       }
 
-      /** \brief Initialize the scheduler and set the number of threads to use.
+      /** \brief Set the maximum number of threads of the pcl::TaskScheduler to use.
         * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
         */
       inline void 
@@ -83,6 +84,14 @@ namespace pcl
       /** \brief The number of threads the scheduler should use. */
       unsigned int threads_;
 
+      /** \brief Estimate the normals of the points [begin, end) of the indices, run in parallel by computeFeature.
+        * \param[in] begin the first index
+        * \param[in] end the index after the last one
+        * \param[out] output the resultant point cloud, of the size of the indices
+        */
+      void
+      computeFeatureRange (int begin, int end, PointCloudOut &output);
+
     private:
       /** \brief Estimate normals for all points given in <setInputCloud (), setIndices ()> using the surface in
         * setSearchSurface () and the spatial locator in setSearchMethod ()
@@ -99,7 +108,7 @@ namespace pcl
   };
 
   /** \brief NormalEstimationOMP estimates local surface properties at each 3D point, such as surface normals and
-    * curvatures, in parallel, using the OpenMP standard.
+    * curvatures, in parallel, on the threads of the pcl::TaskScheduler.
     * \author Radu Bogdan Rusu
     * \ingroup features
     */
@@ -133,6 +142,10 @@ namespace pcl
       void 
       computeFeatureEigen (pcl::PointCloud<Eigen::MatrixXf> &output);
 
+      /** \brief Estimate the normals of the points [begin, end) of the indices, run in parallel by computeFeatureEigen. */
+      void
+      computeFeatureEigenRange (int begin, int end, pcl::PointCloud<Eigen::MatrixXf> &output);
+
       /** \brief Make the compute (&PointCloudOut); inaccessible from outside the class
         * \param[out] output the output point cloud 
         */
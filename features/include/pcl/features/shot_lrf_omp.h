@@ -42,11 +42,12 @@
 #include <pcl/point_types.h>
 #include <pcl/features/feature.h>
 #include <pcl/features/shot_lrf.h>
+#include <pcl/common/task_scheduler.h>
 
 namespace pcl
 {
   /** \brief SHOTLocalReferenceFrameEstimation estimates the Local Reference Frame used in the calculation
-    * of the (SHOT) descriptor.
+    * of the (SHOT) descriptor, in parallel, on the threads of the pcl::TaskScheduler.
     *
     * \note If you use this code in any academic work, please cite:
     *
@@ -72,7 +73,7 @@ namespace pcl
         feature_name_ = "SHOTLocalReferenceFrameEstimationOMP";
       }
 
-    /** \brief Initialize the scheduler and set the number of threads to use.
+    /** \brief Set the maximum number of threads of the pcl::TaskScheduler to use.
      * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
      */
      inline void
@@ -103,6 +104,14 @@ namespace pcl
       virtual void
       computeFeatureEigen (pcl::PointCloud<Eigen::MatrixXf> &output);
 
+      /** \brief Estimate the frames of the points [begin, end) of the indices, run in parallel by computeFeature. */
+      void
+      computeFeatureRange (int begin, int end, PointCloudOut &output);
+
+      /** \brief Estimate the frames of the points [begin, end) of the indices, run in parallel by computeFeatureEigen. */
+      void
+      computeFeatureEigenRange (int begin, int end, pcl::PointCloud<Eigen::MatrixXf> &output);
+
       /** \brief The number of threads the scheduler should use. */
       unsigned int threads_;
 
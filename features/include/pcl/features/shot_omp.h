@@ -40,11 +40,12 @@
 #include <pcl/point_types.h>
 #include <pcl/features/feature.h>
 #include <pcl/features/shot.h>
+#include <pcl/common/task_scheduler.h>
 
 namespace pcl
 {
   /** \brief SHOTEstimationOMP estimates the Signature of Histograms of OrienTations (SHOT) descriptor for a given point cloud dataset
-    * containing points and normals, in parallel, using the OpenMP standard.
+    * containing points and normals, in parallel, on the threads of the pcl::TaskScheduler.
     *
     * The suggested PointOutT is pcl::SHOT352.
     *
@@ -92,7 +93,7 @@ namespace pcl
       /** \brief Empty constructor. */
       SHOTEstimationOMP (unsigned int nr_threads = 0) : SHOTEstimation<PointInT, PointNT, PointOutT, PointRFT> (), threads_ (nr_threads)
       { };
-      /** \brief Initialize the scheduler and set the number of threads to use.
+      /** \brief Set the maximum number of threads of the pcl::TaskScheduler to use.
         * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
         */
       inline void
@@ -108,6 +109,14 @@ namespace pcl
       void
       computeFeature (PointCloudOut &output);
 
+      /** \brief Estimate the descriptors of the points [begin, end) of the indices, run in parallel by computeFeature.
+        * \param[in] begin the first index
+        * \param[in] end the index after the last one
+        * \param[out] output the resultant point cloud, of the size of the indices
+        */
+      void
+      computeFeatureRange (int begin, int end, PointCloudOut &output);
+
       /** \brief This method should get called before starting the actual computation. */
       bool
       initCompute ();
@@ -117,7 +126,7 @@ namespace pcl
   };
 
   /** \brief SHOTColorEstimationOMP estimates the Signature of Histograms of OrienTations (SHOT) descriptor for a given point cloud dataset
-    * containing points, normals and colors, in parallel, using the OpenMP standard.
+    * containing points, normals and colors, in parallel, on the threads of the pcl::TaskScheduler.
     *
     * The suggested PointOutT is pcl::SHOT1344.
     *
@@ -173,7 +182,7 @@ namespace pcl
       {
       }
 
-      /** \brief Initialize the scheduler and set the number of threads to use.
+      /** \brief Set the maximum number of threads of the pcl::TaskScheduler to use.
         * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
         */
       inline void
@@ -189,6 +198,14 @@ namespace pcl
       void
       computeFeature (PointCloudOut &output);
 
+      /** \brief Estimate the descriptors of the points [begin, end) of the indices, run in parallel by computeFeature.
+        * \param[in] begin the first index
+        * \param[in] end the index after the last one
+        * \param[out] output the resultant point cloud, of the size of the indices
+        */
+      void
+      computeFeatureRange (int begin, int end, PointCloudOut &output);
+
       /** \brief This method should get called before starting the actual computation. */
       bool
       initCompute ();
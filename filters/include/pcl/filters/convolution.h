@@ -45,6 +45,7 @@
 #include <pcl/point_cloud.h>
 #include <pcl/exceptions.h>
 #include <pcl/pcl_base.h>
+#include <pcl/common/task_scheduler.h>
 
 namespace pcl
 {
@@ -122,7 +123,7 @@ namespace pcl
         /// \return the distance threshold
         inline const float &
         getDistanceThreshold () const { return (distance_threshold_); }
-        /** \brief Initialize the scheduler and set the number of threads to use.
+        /** \brief Set the maximum number of threads of the pcl::TaskScheduler to use.
           * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
           */
         inline void
@@ -180,6 +181,24 @@ namespace pcl
         /// \brief convolve cols and duplicate borders
         void
         convolve_cols_duplicate (PointCloudOut& output);
+        /// \brief convolve the rows [begin, end) and ignore borders, run in parallel by convolve_rows
+        void
+        convolve_rows_range (int begin, int end, PointCloudOut& output);
+        /// \brief convolve the cols [begin, end) and ignore borders, run in parallel by convolve_cols
+        void
+        convolve_cols_range (int begin, int end, PointCloudOut& output);
+        /// \brief convolve the rows [begin, end) and mirror borders, run in parallel by convolve_rows_mirror
+        void
+        convolve_rows_mirror_range (int begin, int end, PointCloudOut& output);
+        /// \brief convolve the cols [begin, end) and mirror borders, run in parallel by convolve_cols_mirror
+        void
+        convolve_cols_mirror_range (int begin, int end, PointCloudOut& output);
+        /// \brief convolve the rows [begin, end) and duplicate borders, run in parallel by convolve_rows_duplicate
+        void
+        convolve_rows_duplicate_range (int begin, int end, PointCloudOut& output);
+        /// \brief convolve the cols [begin, end) and duplicate borders, run in parallel by convolve_cols_duplicate
+        void
+        convolve_cols_duplicate_range (int begin, int end, PointCloudOut& output);
         /** init compute is an internal method called before computation
           * \param[in] kernel convolution kernel to be used
           * \throw pcl::InitFailedException
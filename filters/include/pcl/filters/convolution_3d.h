@@ -43,6 +43,7 @@
 #include <pcl/pcl_base.h>
 #include <pcl/filters/boost.h>
 #include <pcl/search/pcl_search.h>
+#include <pcl/common/task_scheduler.h>
 
 namespace pcl
 {
@@ -216,7 +217,7 @@ namespace pcl
         /** \brief Empty destructor */
         ~Convolution3D () {}
 
-        /** \brief Initialize the scheduler and set the number of threads to use.
+        /** \brief Set the maximum number of threads of the pcl::TaskScheduler to use.
           * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
           */
         inline void
@@ -268,6 +269,10 @@ namespace pcl
         /** \brief initialize computation */
         bool initCompute ();
 
+        /** \brief Convolve the points [begin, end) of the surface, run in parallel by convolve. */
+        void
+        convolveRange (int begin, int end, PointCloudOut& output);
+
         /** \brief An input point cloud describing the surface that is to be used for nearest neighbors estimation. */
         PointCloudInConstPtr surface_;
 
@@ -41,6 +41,7 @@
 #define PCL_FILTER_H_
 
 #include <pcl/pcl_base.h>
+#include <pcl/common/profiler.h>
 #include <pcl/ros/conversions.h>
 #include <pcl/filters/boost.h>
 #include <cfloat>
@@ -113,8 +114,10 @@ namespace pcl
       inline void
       filter (PointCloud &output)
       {
+        PCL_PROFILE_METHOD_SCOPE (getClassName (), "filter");
         if (!initCompute ())
           return;
+        PCL_PROFILE_COUNTER ("points in", indices_->size ());
 
         // Resize the output dataset
         //if (output.points.size () != indices_->size ())
@@ -127,6 +130,7 @@ namespace pcl
 
         // Apply the actual filter
         applyFilter (output);
+        PCL_PROFILE_COUNTER ("points out", output.points.size ());
 
         deinitCompute ();
       }
@@ -402,18 +402,22 @@ namespace pcl
 
 template <typename PointIn, typename PointOut> void
 pcl::filters::Convolution<PointIn, PointOut>::convolve_rows (PointCloudOut& output)
+{
+  pcl::parallel_for (0, static_cast<int> (input_->height),
+                     pcl::makeRangeMethod (*this, &Convolution::convolve_rows_range, output),
+                     0, threads_);
+}
+
+template <typename PointIn, typename PointOut> void
+pcl::filters::Convolution<PointIn, PointOut>::convolve_rows_range (int begin, int end, PointCloudOut& output)
 {
   using namespace pcl::common;
 
   int width = input_->width;
-  int height = input_->height;
   int last = input_->width - half_width_;
   if (input_->is_dense)
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int j = 0; j < height; ++j)
+    for(int j = begin; j < end; ++j)
     {
       for (int i = 0; i < half_width_; ++i)
         makeInfinite (output (i,j));
@@ -427,10 +431,7 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_rows (PointCloudOut& outp
   }
   else
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int j = 0; j < height; ++j)
+    for(int j = begin; j < end; ++j)
     {
       for (int i = 0; i < half_width_; ++i)
         makeInfinite (output (i,j));
@@ -446,19 +447,23 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_rows (PointCloudOut& outp
 
 template <typename PointIn, typename PointOut> void
 pcl::filters::Convolution<PointIn, PointOut>::convolve_rows_duplicate (PointCloudOut& output)
+{
+  pcl::parallel_for (0, static_cast<int> (input_->height),
+                     pcl::makeRangeMethod (*this, &Convolution::convolve_rows_duplicate_range, output),
+                     0, threads_);
+}
+
+template <typename PointIn, typename PointOut> void
+pcl::filters::Convolution<PointIn, PointOut>::convolve_rows_duplicate_range (int begin, int end, PointCloudOut& output)
 {
   using namespace pcl::common;
 
   int width = input_->width;
-  int height = input_->height;
   int last = input_->width - half_width_;
   int w = last - 1;
   if (input_->is_dense)
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int j = 0; j < height; ++j)
+    for(int j = begin; j < end; ++j)
     {
       for (int i = half_width_; i < last; ++i)
         output (i,j) = convolveOneRowDense (i,j);
@@ -472,10 +477,7 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_rows_duplicate (PointClou
   }
   else
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int j = 0; j < height; ++j)
+    for(int j = begin; j < end; ++j)
     {
       for (int i = half_width_; i < last; ++i)
         output (i,j) = convolveOneRowNonDense (i,j);
@@ -491,19 +493,23 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_rows_duplicate (PointClou
 
 template <typename PointIn, typename PointOut> void
 pcl::filters::Convolution<PointIn, PointOut>::convolve_rows_mirror (PointCloudOut& output)
+{
+  pcl::parallel_for (0, static_cast<int> (input_->height),
+                     pcl::makeRangeMethod (*this, &Convolution::convolve_rows_mirror_range, output),
+                     0, threads_);
+}
+
+template <typename PointIn, typename PointOut> void
+pcl::filters::Convolution<PointIn, PointOut>::convolve_rows_mirror_range (int begin, int end, PointCloudOut& output)
 {
   using namespace pcl::common;
 
   int width = input_->width;
-  int height = input_->height;
   int last = input_->width - half_width_;
   int w = last - 1;
   if (input_->is_dense)
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int j = 0; j < height; ++j)
+    for(int j = begin; j < end; ++j)
     {
       for (int i = half_width_; i < last; ++i)
         output (i,j) = convolveOneRowDense (i,j);
@@ -517,10 +523,7 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_rows_mirror (PointCloudOu
   }
   else
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int j = 0; j < height; ++j)
+    for(int j = begin; j < end; ++j)
     {
       for (int i = half_width_; i < last; ++i)
         output (i,j) = convolveOneRowNonDense (i,j);
@@ -536,18 +539,22 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_rows_mirror (PointCloudOu
 
 template <typename PointIn, typename PointOut> void
 pcl::filters::Convolution<PointIn, PointOut>::convolve_cols (PointCloudOut& output)
+{
+  pcl::parallel_for (0, static_cast<int> (input_->width),
+                     pcl::makeRangeMethod (*this, &Convolution::convolve_cols_range, output),
+                     0, threads_);
+}
+
+template <typename PointIn, typename PointOut> void
+pcl::filters::Convolution<PointIn, PointOut>::convolve_cols_range (int begin, int end, PointCloudOut& output)
 {
   using namespace pcl::common;
 
-  int width = input_->width;
   int height = input_->height;
   int last = input_->height - half_width_;
   if (input_->is_dense)
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int i = 0; i < width; ++i)
+    for(int i = begin; i < end; ++i)
     {
       for (int j = 0; j < half_width_; ++j)
         makeInfinite (output (i,j));
@@ -561,10 +568,7 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_cols (PointCloudOut& outp
   }
   else
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int i = 0; i < width; ++i)
+    for(int i = begin; i < end; ++i)
     {
       for (int j = 0; j < half_width_; ++j)
         makeInfinite (output (i,j));
@@ -580,19 +584,23 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_cols (PointCloudOut& outp
 
 template <typename PointIn, typename PointOut> void
 pcl::filters::Convolution<PointIn, PointOut>::convolve_cols_duplicate (PointCloudOut& output)
+{
+  pcl::parallel_for (0, static_cast<int> (input_->width),
+                     pcl::makeRangeMethod (*this, &Convolution::convolve_cols_duplicate_range, output),
+                     0, threads_);
+}
+
+template <typename PointIn, typename PointOut> void
+pcl::filters::Convolution<PointIn, PointOut>::convolve_cols_duplicate_range (int begin, int end, PointCloudOut& output)
 {
   using namespace pcl::common;
 
-  int width = input_->width;
   int height = input_->height;
   int last = input_->height - half_width_;
   int h = last -1;
   if (input_->is_dense)
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int i = 0; i < width; ++i)
+    for(int i = begin; i < end; ++i)
     {
       for (int j = half_width_; j < last; ++j)
         output (i,j) = convolveOneColDense (i,j);
@@ -606,10 +614,7 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_cols_duplicate (PointClou
   }
   else
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int i = 0; i < width; ++i)
+    for(int i = begin; i < end; ++i)
     {
       for (int j = half_width_; j < last; ++j)
         output (i,j) = convolveOneColNonDense (i,j);
@@ -625,19 +630,23 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_cols_duplicate (PointClou
 
 template <typename PointIn, typename PointOut> void
 pcl::filters::Convolution<PointIn, PointOut>::convolve_cols_mirror (PointCloudOut& output)
+{
+  pcl::parallel_for (0, static_cast<int> (input_->width),
+                     pcl::makeRangeMethod (*this, &Convolution::convolve_cols_mirror_range, output),
+                     0, threads_);
+}
+
+template <typename PointIn, typename PointOut> void
+pcl::filters::Convolution<PointIn, PointOut>::convolve_cols_mirror_range (int begin, int end, PointCloudOut& output)
 {
   using namespace pcl::common;
 
-  int width = input_->width;
   int height = input_->height;
   int last = input_->height - half_width_;
   int h = last -1;
   if (input_->is_dense)
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int i = 0; i < width; ++i)
+    for(int i = begin; i < end; ++i)
     {
       for (int j = half_width_; j < last; ++j)
         output (i,j) = convolveOneColDense (i,j);
@@ -651,10 +660,7 @@ pcl::filters::Convolution<PointIn, PointOut>::convolve_cols_mirror (PointCloudOu
   }
   else
   {
-#ifdef _OPENMP
-#pragma omp parallel for shared (output, last) num_threads (threads_)
-#endif
-    for(int i = 0; i < width; ++i)
+    for(int i = begin; i < end; ++i)
     {
       for (int j = half_width_; j < last; ++j)
         output (i,j) = convolveOneColNonDense (i,j);
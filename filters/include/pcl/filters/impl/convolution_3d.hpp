@@ -234,13 +234,19 @@ pcl::filters::Convolution3D<PointInT, PointOutT, KernelT>::convolve (PointCloudO
   output.width = surface_->width;
   output.height = surface_->height;
   output.is_dense = surface_->is_dense;
+  pcl::parallel_for (0, static_cast<int> (surface_->size ()),
+                     pcl::makeRangeMethod (*this, &Convolution3D::convolveRange, output),
+                     0, threads_);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename KernelT> void
+pcl::filters::Convolution3D<PointInT, PointOutT, KernelT>::convolveRange (int begin, int end, PointCloudOut& output)
+{
   std::vector<int> nn_indices;
   std::vector<float> nn_distances;
 
-#ifdef _OPENMP
-#pragma omp parallel for shared (output) private (nn_indices, nn_distances) num_threads (threads_)
-#endif
-  for (std::size_t point_idx = 0; point_idx < surface_->size (); ++point_idx)
+  for (int point_idx = begin; point_idx < end; ++point_idx)
   {
     const PointInT& point_in = surface_->points [point_idx];
     PointOutT& point_out = output [point_idx];
@@ -40,6 +40,7 @@
 
 #include <pcl/common/common.h>
 #include <pcl/filters/voxel_grid.h>
+#include <limits>
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
@@ -47,6 +48,8 @@ pcl::getMinMax3D (const typename pcl::PointCloud<PointT>::ConstPtr &cloud,
                   const std::string &distance_field_name, float min_distance, float max_distance,
                   Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, bool limit_negative)
 {
+  // The coordinates are read by name rather than through getArray4fMap (), so
+  // that the compact point types without SSE padding are supported too
   Eigen::Array4f min_p, max_p;
   min_p.setConstant (FLT_MAX);
   max_p.setConstant (-FLT_MAX);
@@ -78,7 +81,7 @@ pcl::getMinMax3D (const typename pcl::PointCloud<PointT>::ConstPtr &cloud,
           continue;
       }
       // Create the point structure and get the min/max
-      pcl::Array4fMapConst pt = cloud->points[i].getArray4fMap ();
+      Eigen::Array4f pt (cloud->points[i].x, cloud->points[i].y, cloud->points[i].z, 1.0f);
       min_p = min_p.min (pt);
       max_p = max_p.max (pt);
     }
@@ -110,7 +113,7 @@ pcl::getMinMax3D (const typename pcl::PointCloud<PointT>::ConstPtr &cloud,
           !pcl_isfinite (cloud->points[i].z))
         continue;
       // Create the point structure and get the min/max
-      pcl::Array4fMapConst pt = cloud->points[i].getArray4fMap ();
+      Eigen::Array4f pt (cloud->points[i].x, cloud->points[i].y, cloud->points[i].z, 1.0f);
       min_p = min_p.min (pt);
       max_p = max_p.max (pt);
     }
@@ -128,6 +131,53 @@ struct cloud_point_index_idx
   bool operator < (const cloud_point_index_idx &p) const { return (idx < p.idx); }
 };
 
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Store an averaged value into a point field. Integer fields, such as the
+      * coordinates of PointXYZQuantized, are rounded to nearest and clamped, since
+      * truncation would bias the centroids toward zero.
+      */
+    template <typename T> inline void
+    storeCentroidValue (float value, T &field)
+    {
+      if (!std::numeric_limits<T>::is_integer)
+      {
+        field = static_cast<T> (value);
+        return;
+      }
+      double rounded = floor (static_cast<double> (value) + 0.5);
+      rounded = std::max (rounded, static_cast<double> (std::numeric_limits<T>::min ()));
+      rounded = std::min (rounded, static_cast<double> (std::numeric_limits<T>::max ()));
+      field = static_cast<T> (rounded);
+    }
+
+    /** \brief Copy a centroid into a point, like NdCopyEigenPointFunctor, through storeCentroidValue. */
+    template <typename PointOutT>
+    struct NdCopyCentroidPointFunctor
+    {
+      typedef typename traits::POD<PointOutT>::type Pod;
+
+      NdCopyCentroidPointFunctor (const Eigen::VectorXf &p1, PointOutT &p2)
+        : p1_ (p1), p2_ (reinterpret_cast<Pod&>(p2)), f_idx_ (0) {}
+
+      template<typename Key> inline void
+      operator() ()
+      {
+        typedef typename pcl::traits::datatype<PointOutT, Key>::type T;
+        uint8_t* data_ptr = reinterpret_cast<uint8_t*>(&p2_) + pcl::traits::offset<PointOutT, Key>::value;
+        storeCentroidValue (p1_[f_idx_++], *reinterpret_cast<T*>(data_ptr));
+      }
+
+      private:
+        const Eigen::VectorXf &p1_;
+        Pod &p2_;
+        int f_idx_;
+    };
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> void
 pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
@@ -369,13 +419,13 @@ pcl::VoxelGrid<PointT>::applyFilter (PointCloud &output)
     // Do we need to process all the fields?
     if (!downsample_all_data_) 
     {
-      output.points[index].x = centroid[0];
-      output.points[index].y = centroid[1];
-      output.points[index].z = centroid[2];
+      pcl::detail::storeCentroidValue (centroid[0], output.points[index].x);
+      pcl::detail::storeCentroidValue (centroid[1], output.points[index].y);
+      pcl::detail::storeCentroidValue (centroid[2], output.points[index].z);
     }
     else 
     {
-      pcl::for_each_type<FieldList> (pcl::NdCopyEigenPointFunctor <PointT> (centroid, output.points[index]));
+      pcl::for_each_type<FieldList> (pcl::detail::NdCopyCentroidPointFunctor <PointT> (centroid, output.points[index]));
       // ---[ RGB special case
       if (rgba_index >= 0) 
       {
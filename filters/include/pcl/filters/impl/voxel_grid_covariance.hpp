@@ -157,11 +157,8 @@ pcl::VoxelGridCovariance<PointT>::applyFilter (PointCloud &output)
         leaf.centroid.setZero ();
       }
 
-      Eigen::Vector3d pt3d (input_->points[cp].x, input_->points[cp].y, input_->points[cp].z);
-      // Accumulate point sum for centroid calculation
-      leaf.mean_ += pt3d;
-      // Accumulate x*xT for single pass covariance calculation
-      leaf.cov_ += pt3d * pt3d.transpose ();
+      // Accumulate the mean and covariance in a single pass
+      leaf.accumulator_.add (input_->points[cp]);
 
       // Do we need to process all the fields?
       if (!downsample_all_data_)
@@ -217,11 +214,8 @@ pcl::VoxelGridCovariance<PointT>::applyFilter (PointCloud &output)
         leaf.centroid.setZero ();
       }
 
-      Eigen::Vector3d pt3d (input_->points[cp].x, input_->points[cp].y, input_->points[cp].z);
-      // Accumulate point sum for centroid calculation
-      leaf.mean_ += pt3d;
-      // Accumulate x*xT for single pass covariance calculation
-      leaf.cov_ += pt3d * pt3d.transpose ();
+      // Accumulate the mean and covariance in a single pass
+      leaf.accumulator_.add (input_->points[cp]);
 
       // Do we need to process all the fields?
       if (!downsample_all_data_)
@@ -261,7 +255,7 @@ pcl::VoxelGridCovariance<PointT>::applyFilter (PointCloud &output)
   // Eigen values and vectors calculated to prevent near singluar matrices
   Eigen::SelfAdjointEigenSolver<Eigen::Matrix3d> eigensolver;
   Eigen::Matrix3d eigen_val;
-  Eigen::Vector3d pt_sum;
+  Eigen::Vector4d mean;
 
   // Eigen values less than a threshold of max eigen value are inflated to a set fraction of the max eigen value.
   double min_covar_eigvalue;
@@ -274,10 +268,8 @@ pcl::VoxelGridCovariance<PointT>::applyFilter (PointCloud &output)
 
     // Normalize the centroid
     leaf.centroid /= static_cast<float> (leaf.nr_points);
-    // Point sum used for single pass covariance calculation
-    pt_sum = leaf.mean_;
-    // Normalize mean
-    leaf.mean_ /= leaf.nr_points;
+    leaf.accumulator_.getCentroid (mean);
+    leaf.mean_ = mean.head<3> ();
 
     // If the voxel contains sufficient points, its covariance is calculated and is added to the voxel centroids and output clouds.
     // Points with less than the minimum points will have a can not be accuratly approximated using a normal distribution.
@@ -312,8 +304,8 @@ pcl::VoxelGridCovariance<PointT>::applyFilter (PointCloud &output)
       if (searchable_)
         voxel_centroids_leaf_indices_.push_back (static_cast<int> (it->first));
 
-      // Single pass covariance calculation
-      leaf.cov_ = (leaf.cov_ - 2 * (pt_sum * leaf.mean_.transpose ())) / leaf.nr_points + leaf.mean_ * leaf.mean_.transpose ();
+      // Single pass covariance calculation, without the cancellation of E[xx^T] - E[x]E[x]^T far from the origin
+      leaf.accumulator_.getCovarianceMatrix (leaf.cov_);
       leaf.cov_ *= (leaf.nr_points - 1.0) / leaf.nr_points;
 
       //Normalize Eigen Val such that max no more than 100x min.
@@ -53,10 +53,12 @@ namespace pcl
     * \param[in] z_idx the index of the Z channel
     * \param[out] min_pt the minimum data point 
     * \param[out] max_pt the maximum data point
+    * \param[in] nr_threads the number of threads to use (0 for automatic, 1 by default)
+    * \note Non finite points are skipped, unless the cloud is dense.
     */
   PCL_EXPORTS void 
   getMinMax3D (const sensor_msgs::PointCloud2ConstPtr &cloud, int x_idx, int y_idx, int z_idx, 
-               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt);
+               Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads = 1);
 
   /** \brief Obtain the maximum and minimum points in 3D from a given point cloud. 
     * \note Performs internal data filtering as well.
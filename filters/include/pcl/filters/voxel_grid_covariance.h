@@ -40,6 +40,7 @@
 
 #include <pcl/filters/boost.h>
 #include <pcl/filters/voxel_grid.h>
+#include <pcl/common/centroid.h>
 #include <map>
 #include <pcl/point_types.h>
 #include <pcl/kdtree/kdtree_flann.h>
@@ -92,6 +93,7 @@ namespace pcl
          */
         Leaf () :
           nr_points (0),
+          accumulator_ (),
           mean_ (Eigen::Vector3d::Zero ()),
           centroid (),
           cov_ (Eigen::Matrix3d::Identity ()),
@@ -160,6 +162,9 @@ namespace pcl
         /** \brief Number of points contained by voxel */
         int nr_points;
 
+        /** \brief Single pass, numerically stable accumulator of the mean and covariance of the voxel points */
+        MeanAndCovarianceAccumulator accumulator_;
+
         /** \brief 3D voxel centroid */
         Eigen::Vector3d mean_;
 
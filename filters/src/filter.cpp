@@ -62,8 +62,10 @@
 void
 pcl::Filter<sensor_msgs::PointCloud2>::filter (PointCloud2 &output)
 {
+  PCL_PROFILE_METHOD_SCOPE (getClassName (), "filter");
   if (!initCompute ())
     return;
+  PCL_PROFILE_COUNTER ("points in", indices_->size ());
 
   // Copy fields and header at a minimum
   output.header = input_->header;
@@ -71,6 +73,7 @@ pcl::Filter<sensor_msgs::PointCloud2>::filter (PointCloud2 &output)
 
   // Apply the actual filter
   applyFilter (output);
+  PCL_PROFILE_COUNTER ("points out", output.width * output.height);
 
   deinitCompute ();
 }
@@ -42,10 +42,35 @@
 #include <pcl/filters/voxel_grid.h>
 #include <pcl/filters/impl/voxel_grid.hpp>
 
+namespace
+{
+  /** \brief Update the bounds with the points in [begin, end[ of a PointCloud2 dataset. */
+  void
+  getMinMax3D (const sensor_msgs::PointCloud2 &cloud, const int xyz_offset[3], int begin, int end,
+               Eigen::Array4f &min_p, Eigen::Array4f &max_p)
+  {
+    const uint8_t *data = &cloud.data[0] + static_cast<size_t> (begin) * cloud.point_step;
+    Eigen::Array4f pt = Eigen::Array4f::Zero ();
+    for (int cp = begin; cp < end; ++cp, data += cloud.point_step)
+    {
+      // The fields x, y, z may be in any order
+      memcpy (&pt[0], data + xyz_offset[0], sizeof (float));
+      memcpy (&pt[1], data + xyz_offset[1], sizeof (float));
+      memcpy (&pt[2], data + xyz_offset[2], sizeof (float));
+      // If the data is dense, we don't need to check for NaN
+      if (!cloud.is_dense &&
+          (!pcl_isfinite (pt[0]) || !pcl_isfinite (pt[1]) || !pcl_isfinite (pt[2])))
+        continue;
+      min_p = (min_p.min) (pt);
+      max_p = (max_p.max) (pt);
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 void
 pcl::getMinMax3D (const sensor_msgs::PointCloud2ConstPtr &cloud, int x_idx, int y_idx, int z_idx,
-                  Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt)
+                  Eigen::Vector4f &min_pt, Eigen::Vector4f &max_pt, unsigned int nr_threads)
 {
   // @todo fix this
   if (cloud->fields[x_idx].datatype != sensor_msgs::PointField::FLOAT32 || 
@@ -60,28 +85,35 @@ pcl::getMinMax3D (const sensor_msgs::PointCloud2ConstPtr &cloud, int x_idx, int
   min_p.setConstant (FLT_MAX);
   max_p.setConstant (-FLT_MAX);
 
-  int nr_points = cloud->width * cloud->height;
-
-  Eigen::Array4f pt = Eigen::Array4f::Zero ();
-  Eigen::Array4i xyz_offset (cloud->fields[x_idx].offset, cloud->fields[y_idx].offset, cloud->fields[z_idx].offset, 0);
+  const int nr_points = cloud->width * cloud->height;
+  const int xyz_offset[3] = { static_cast<int> (cloud->fields[x_idx].offset),
+                              static_cast<int> (cloud->fields[y_idx].offset),
+                              static_cast<int> (cloud->fields[z_idx].offset) };
 
-  for (int cp = 0; cp < nr_points; ++cp)
+  // The same chunks as the templated getMinMax3D, so that both reductions stay alike
+  const int chunk_size = static_cast<int> (pcl::detail::common_chunk_size);
+  const int nr_chunks = (nr_points + chunk_size - 1) / chunk_size;
+  if (nr_threads == 1 || nr_chunks <= 1)
   {
-    // Unoptimized memcpys: assume fields x, y, z are in random order
-    memcpy (&pt[0], &cloud->data[xyz_offset[0]], sizeof (float));
-    memcpy (&pt[1], &cloud->data[xyz_offset[1]], sizeof (float));
-    memcpy (&pt[2], &cloud->data[xyz_offset[2]], sizeof (float));
-    // Check if the point is invalid
-    if (!pcl_isfinite (pt[0]) || 
-        !pcl_isfinite (pt[1]) || 
-        !pcl_isfinite (pt[2]))
+    if (nr_points > 0)
+      ::getMinMax3D (*cloud, xyz_offset, 0, nr_points, min_p, max_p);
+  }
+  else
+  {
+#pragma omp parallel num_threads(nr_threads)
     {
-      xyz_offset += cloud->point_step;
-      continue;
+      Eigen::Array4f local_min_p, local_max_p;
+      local_min_p.setConstant (FLT_MAX);
+      local_max_p.setConstant (-FLT_MAX);
+#pragma omp for schedule(static) nowait
+      for (int c = 0; c < nr_chunks; ++c)
+        ::getMinMax3D (*cloud, xyz_offset, c * chunk_size, std::min ((c + 1) * chunk_size, nr_points), local_min_p, local_max_p);
+#pragma omp critical (pcl_getMinMax3D)
+      {
+        min_p = (min_p.min) (local_min_p);
+        max_p = (max_p.max) (local_max_p);
+      }
     }
-    xyz_offset += cloud->point_step;
-    min_p = (min_p.min) (pt);
-    max_p = (max_p.max) (pt);
   }
   min_pt = min_p;
   max_pt = max_p;
@@ -524,4 +556,6 @@ pcl::VoxelGrid<sensor_msgs::PointCloud2>::applyFilter (PointCloud2 &output)
 // Instantiations of specific point types
 PCL_INSTANTIATE(getMinMax3D, PCL_XYZ_POINT_TYPES)
 PCL_INSTANTIATE(VoxelGrid, PCL_XYZ_POINT_TYPES)
+PCL_INSTANTIATE(getMinMax3D, PCL_COMPACT_POINT_TYPES)
+PCL_INSTANTIATE(VoxelGrid, PCL_COMPACT_POINT_TYPES)
 
@@ -0,0 +1,250 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#ifndef __PCL_IO_DEPTH_IMAGE_CODEC__
+#define __PCL_IO_DEPTH_IMAGE_CODEC__
+
+#include <pcl/pcl_macros.h>
+#include <pcl/compression/entropy_range_coder.h>
+
+#include <string>
+#include <vector>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief @b DepthImageCodec is a lossless codec for 16-bit depth/disparity
+      * images and 8-bit RGB images, an alternative to PNG for streaming.
+      *
+      * Every pixel is predicted from its left, upper and upper-left neighbors
+      * (median edge detector), and the prediction residuals are entropy coded
+      * with the rANS StaticRangeCoder, one frequency table per channel and
+      * local activity class. The image is cut into horizontal bands, coded
+      * independently and in parallel.
+      *
+      * With temporal prediction enabled, the encoder also predicts every band
+      * from the difference to the previous frame, and keeps whichever of the
+      * two predictions gives the smaller residuals. The decoder must then see
+      * all the frames in order, from the last key frame on. The codec keeps
+      * state, so that depth and color streams need one instance each.
+      * \ingroup io
+      */
+    class PCL_EXPORTS DepthImageCodec
+    {
+      public:
+        /** \brief Constructor. */
+        DepthImageCodec ();
+
+        /** \brief Empty destructor. */
+        virtual
+        ~DepthImageCodec () {}
+
+        /** \brief Set the number of threads used to code the bands.
+          * \param[in] nrThreads_arg the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        inline void
+        setNumberOfThreads (unsigned int nrThreads_arg = 0)
+        {
+          threads_ = nrThreads_arg;
+        }
+
+        /** \brief Set the number of horizontal bands the images are cut into.
+          * \param[in] nrBands_arg the number of bands (default: 8)
+          */
+        inline void
+        setNumberOfBands (unsigned int nrBands_arg)
+        {
+          bands_ = nrBands_arg > 0 ? nrBands_arg : 1;
+        }
+
+        /** \brief Get the number of horizontal bands the images are cut into. */
+        inline unsigned int
+        getNumberOfBands () const
+        {
+          return (bands_);
+        }
+
+        /** \brief Enable or disable the temporal prediction.
+          * \param[in] enable_arg true to predict the frames from the previous one
+          * \param[in] keyFramePeriod_arg a key frame, coded without temporal prediction, is inserted every keyFramePeriod_arg frames (0: only the first frame)
+          */
+        void
+        setTemporalPrediction (bool enable_arg, unsigned int keyFramePeriod_arg = 30);
+
+        /** \brief Return true if the temporal prediction is enabled. */
+        inline bool
+        getTemporalPrediction () const
+        {
+          return (temporal_);
+        }
+
+        /** \brief Forget the previous frames, the next frame is coded as a key frame. */
+        void
+        reset ();
+
+        /** \brief Encode a 16-bit mono image.
+          * \param[in] image_arg input image data
+          * \param[in] width_arg image width
+          * \param[in] height_arg image height
+          * \param[out] compressedData_arg compressed image data
+          */
+        void
+        encodeMonoImage (const std::vector<uint16_t>& image_arg,
+                         size_t width_arg,
+                         size_t height_arg,
+                         std::vector<uint8_t>& compressedData_arg);
+
+        /** \brief Encode an 8-bit RGB image.
+          * \param[in] image_arg input image data
+          * \param[in] width_arg image width
+          * \param[in] height_arg image height
+          * \param[out] compressedData_arg compressed image data
+          */
+        void
+        encodeRGBImage (const std::vector<uint8_t>& image_arg,
+                        size_t width_arg,
+                        size_t height_arg,
+                        std::vector<uint8_t>& compressedData_arg);
+
+        /** \brief Decode an image to 16-bit samples.
+          * \param[in] compressedData_arg compressed image data
+          * \param[out] image_arg image output data
+          * \param[out] width_arg image width
+          * \param[out] height_arg image height
+          * \param[out] channels_arg number of channels
+          * \return false if the data is invalid, or refers to a previous frame which was not decoded
+          */
+        bool
+        decodeImage (const std::vector<uint8_t>& compressedData_arg,
+                     std::vector<uint16_t>& image_arg,
+                     size_t& width_arg,
+                     size_t& height_arg,
+                     unsigned int& channels_arg);
+
+        /** \brief Decode an image to 8-bit samples.
+          * \param[in] compressedData_arg compressed image data
+          * \param[out] image_arg image output data
+          * \param[out] width_arg image width
+          * \param[out] height_arg image height
+          * \param[out] channels_arg number of channels
+          * \return false if the data is invalid, or refers to a previous frame which was not decoded
+          */
+        bool
+        decodeImage (const std::vector<uint8_t>& compressedData_arg,
+                     std::vector<uint8_t>& image_arg,
+                     size_t& width_arg,
+                     size_t& height_arg,
+                     unsigned int& channels_arg);
+
+        /** \brief Return true if \a data_arg was written by a DepthImageCodec (and not, e.g., by libpng). */
+        static bool
+        isEncodedImage (const std::vector<uint8_t>& data_arg);
+
+      protected:
+        /** \brief Encode an image of interleaved 16-bit samples. */
+        void
+        encodeImage (const uint16_t* image_arg, size_t width_arg, size_t height_arg, unsigned int channels_arg,
+                     std::vector<uint8_t>& compressedData_arg);
+
+        /** \brief Decode an image of interleaved 16-bit samples to \a previousDecoded_. */
+        bool
+        decodeImage (const std::vector<uint8_t>& compressedData_arg,
+                     size_t& width_arg, size_t& height_arg, unsigned int& channels_arg);
+
+        /** \brief Predict the rows [firstRow_arg, endRow_arg) of an image, and entropy code the residuals.
+          * \return the mode of the band (temporal prediction and color decorrelation flags)
+          */
+        uint8_t
+        encodeBand (const uint16_t* image_arg, const uint16_t* previous_arg, size_t width_arg, unsigned int channels_arg,
+                    size_t firstRow_arg, size_t endRow_arg, StaticRangeCoder& coder_arg, std::string& bandData_arg) const;
+
+        /** \brief Entropy decode and reconstruct the rows [firstRow_arg, endRow_arg) of an image.
+          * \param[in] mode_arg the mode of the band, as returned by \a encodeBand
+          * \param[in] previous_arg the previous frame, or NULL for an intra band
+          */
+        bool
+        decodeBand (const char* data_arg, size_t size_arg, uint8_t mode_arg, const uint16_t* previous_arg,
+                    size_t width_arg, unsigned int channels_arg, size_t firstRow_arg, size_t endRow_arg,
+                    StaticRangeCoder& coder_arg, uint16_t* image_arg) const;
+
+        /** \brief The number of threads used to code the bands. */
+        unsigned int threads_;
+
+        /** \brief The number of horizontal bands. */
+        unsigned int bands_;
+
+        /** \brief Set to true to predict the frames from the previous one. */
+        bool temporal_;
+
+        /** \brief The period of the key frames. */
+        unsigned int keyFramePeriod_;
+
+        /** \brief The number of frames encoded since the last key frame. */
+        unsigned int framesSinceKeyFrame_;
+
+        /** \brief The id of the next encoded frame. */
+        uint32_t encoderFrameID_;
+
+        /** \brief The previous encoded frame (temporal prediction only). */
+        std::vector<uint16_t> previousEncoded_;
+
+        /** \brief Width, height and channels of the previous encoded frame. */
+        size_t previousEncodedSize_[3];
+
+        /** \brief The frame being decoded. */
+        std::vector<uint16_t> decoded_;
+
+        /** \brief The last decoded frame, reference of the temporal prediction. */
+        std::vector<uint16_t> previousDecoded_;
+
+        /** \brief Width, height and channels of the previous decoded frame. */
+        size_t previousDecodedSize_[3];
+
+        /** \brief The id of the last decoded frame. */
+        uint32_t decoderFrameID_;
+
+        /** \brief Set to true once a frame was decoded. */
+        bool hasDecodedFrame_;
+
+        /** \brief One entropy coder per band. */
+        std::vector<StaticRangeCoder> coders_;
+
+        /** \brief The compressed data of every band. */
+        std::vector<std::string> bandData_;
+    };
+  }
+}
+
+#endif
@@ -112,15 +112,28 @@ namespace pcl
    *  \note This class provides static range coding functionality.
    *  \note Its symbol probability/frequency table is precomputed and encoded to the output stream
    *  \note
+   *  \note Two bitstream versions exist: the original carry-less range coder, and a
+   *  \note table-driven rANS coder with two interleaved states (the default), whose
+   *  \note decoder needs a single table lookup per symbol. Every encoded vector starts
+   *  \note with a tag identifying its version, so that both versions are decoded.
+   *  \note
    *  \author Julius Kammerl (julius@kammerl.de)
    */
   //////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
   class StaticRangeCoder
   {
     public:
+      /** \brief Bitstream versions written by the encoder. */
+      enum BitstreamVersion
+      {
+        RANGE_CODER_BITSTREAM = 0, // carry-less range coder, readable by all versions of the decoder
+        RANS_BITSTREAM = 1         // table-driven rANS coder with two interleaved states
+      };
+
       /** \brief Constructor. */
       StaticRangeCoder () :
-        cFreqTable_ (65537), outputCharVector_ ()
+        cFreqTable_ (65537), outputCharVector_ (), version_ (RANS_BITSTREAM),
+        symbolTable_ (), symbolFreq_ (), symbolStart_ (), rankTable_ (), ransBuffer_ ()
       {
       }
 
@@ -130,6 +143,22 @@ namespace pcl
       {
       }
 
+      /** \brief Set the bitstream version written by the encoder. The decoder detects the version by itself.
+        * \param[in] version_arg the bitstream version (default: RANS_BITSTREAM)
+        */
+      inline void
+      setBitstreamVersion (BitstreamVersion version_arg)
+      {
+        version_ = version_arg;
+      }
+
+      /** \brief Get the bitstream version written by the encoder. */
+      inline BitstreamVersion
+      getBitstreamVersion () const
+      {
+        return (version_);
+      }
+
       /** \brief Encode integer vector to output stream
         * \param[in] inputIntVector_arg input vector
         * \param[out] outputByterStream_arg output stream containing compressed data
@@ -175,6 +204,55 @@ namespace pcl
         return log (n_arg) / log (2.0);
       }
 
+      /** \brief Range coder version of \a encodeIntVectorToStream. */
+      unsigned long
+      encodeIntVectorToStreamV0 (std::vector<unsigned int>& inputIntVector_arg, std::ostream& outputByteStream_arg);
+
+      /** \brief Range coder version of \a decodeStreamToIntVector.
+       * \param frequencyTableSize_arg the first word of the stream, already read by the caller
+       */
+      unsigned long
+      decodeStreamToIntVectorV0 (uint64_t frequencyTableSize_arg, std::istream& inputByteStream_arg,
+                                 std::vector<unsigned int>& outputIntVector_arg);
+
+      /** \brief Range coder version of \a encodeCharVectorToStream. */
+      unsigned long
+      encodeCharVectorToStreamV0 (const std::vector<char>& inputByteVector_arg, std::ostream& outputByteStream_arg);
+
+      /** \brief Range coder version of \a decodeStreamToCharVector.
+       * \param firstFrequency_arg the first word of the stream, already read by the caller
+       */
+      unsigned long
+      decodeStreamToCharVectorV0 (DWord firstFrequency_arg, std::istream& inputByteStream_arg,
+                                  std::vector<char>& outputByteVector_arg);
+
+      /** \brief Build the normalized rANS frequency table of the symbols in \a symbolTable_, whose
+       * occurrences are given in \a symbolFreq_, and choose the precision of the coder.
+       * \param inputSize_arg amount of symbols in the input vector
+       * \param scaleBits_arg the resultant precision (log2 of the sum of the frequencies)
+       * \return false if there are too many distinct symbols for the rANS coder
+       */
+      bool
+      normalizeFrequencies (std::size_t inputSize_arg, uint8_t& scaleBits_arg);
+
+      /** \brief Append the rANS frequency table and the encoded symbols to \a outputCharVector_.
+       * \param input_arg the input symbols
+       * \param inputSize_arg amount of symbols
+       * \param rankTable_arg index in \a symbolTable_ of every symbol value, or NULL if the input symbols are these indices
+       * \param scaleBits_arg precision of the coder
+       */
+      template <typename SymbolT> void
+      encodeRANS (const SymbolT* input_arg, std::size_t inputSize_arg, const DWord* rankTable_arg, uint8_t scaleBits_arg);
+
+      /** \brief Read a rANS frequency table and payload (the part following the tag) and decode it.
+       * \param inputByteStream_arg input stream of compressed data
+       * \param outputVector_arg pointer to the decompressed symbols
+       * \param outputSize_arg amount of symbols to decode
+       * \return amount of bytes read from input stream
+       */
+      template <typename SymbolT> unsigned long
+      decodeRANS (std::istream& inputByteStream_arg, SymbolT* outputVector_arg, std::size_t outputSize_arg);
+
     private:
       /** \brief Vector containing cumulative symbol frequency table. */
       std::vector<uint64_t> cFreqTable_;
@@ -182,6 +260,24 @@ namespace pcl
       /** \brief Vector containing compressed data. */
       std::vector<char> outputCharVector_;
 
+      /** \brief Bitstream version written by the encoder. */
+      BitstreamVersion version_;
+
+      /** \brief Distinct symbols of the rANS coder, in increasing order. */
+      std::vector<unsigned int> symbolTable_;
+
+      /** \brief Occurrences, then normalized frequencies of the symbols of \a symbolTable_. */
+      std::vector<DWord> symbolFreq_;
+
+      /** \brief Cumulative normalized frequencies of the symbols of \a symbolTable_. */
+      std::vector<DWord> symbolStart_;
+
+      /** \brief Symbol to rank table (encoding), or slot to rank table (decoding). */
+      std::vector<DWord> rankTable_;
+
+      /** \brief Buffer the rANS payload is written to backwards. */
+      std::vector<char> ransBuffer_;
+
   };
 }
 
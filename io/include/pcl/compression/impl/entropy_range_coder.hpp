@@ -43,6 +43,7 @@
 #define __PCL_IO_RANGECODING__HPP
 
 #include <pcl/compression/entropy_range_coder.h>
+#include <pcl/console/print.h>
 #include <map>
 #include <iostream>
 #include <vector>
@@ -50,14 +51,179 @@
 #include <algorithm>
 #include <stdio.h>
 
+namespace pcl
+{
+  namespace detail
+  {
+    /** \brief Read a byte through the stream buffer of \a stream_arg, bypassing the per call cost of istream::read. */
+    inline uint8_t
+    readCoderByte (std::istream& stream_arg, std::streambuf* buffer_arg)
+    {
+      int ch = buffer_arg->sbumpc ();
+      if (ch == std::char_traits<char>::eof ())
+      {
+        stream_arg.setstate (std::ios::eofbit | std::ios::failbit);
+        return (0);
+      }
+      return (static_cast<uint8_t> (ch));
+    }
+
+    /** \brief Append \a value_arg to \a vector_arg as a little endian base 128 varint. */
+    inline void
+    appendVarint (std::vector<char>& vector_arg, uint64_t value_arg)
+    {
+      while (value_arg >= 0x80)
+      {
+        vector_arg.push_back (static_cast<char> ((value_arg & 0x7F) | 0x80));
+        value_arg >>= 7;
+      }
+      vector_arg.push_back (static_cast<char> (value_arg));
+    }
+
+    /** \brief Read a varint written by appendVarint.
+     * \return amount of bytes read
+     */
+    inline unsigned long
+    readVarint (std::istream& stream_arg, std::streambuf* buffer_arg, uint64_t& value_arg)
+    {
+      unsigned long byteCount = 0;
+      value_arg = 0;
+      for (unsigned int shift = 0; shift < 64; shift += 7)
+      {
+        uint8_t ch = readCoderByte (stream_arg, buffer_arg);
+        byteCount++;
+        value_arg |= static_cast<uint64_t> (ch & 0x7F) << shift;
+        if (!(ch & 0x80) || !stream_arg)
+          break;
+      }
+      return (byteCount);
+    }
+
+    /** \brief Adaptive frequency table of the 256 byte symbols, kept in a Fenwick tree so
+     * that cumulative frequencies are read and updated in O(log) instead of O(256).
+     * It gives the exact same cumulative frequencies as the original linear table.
+     */
+    class AdaptiveFrequencyTable
+    {
+      public:
+        typedef uint32_t DWord;
+
+        /** \brief Constructor, every symbol starts with a frequency of 1. */
+        AdaptiveFrequencyTable () : total_ (256)
+        {
+          for (unsigned int i = 0; i < 256; i++)
+            count_[i] = 1;
+          build ();
+        }
+
+        /** \brief Sum of the frequencies of the symbols lower than \a symbol_arg. */
+        inline DWord
+        cumulative (unsigned int symbol_arg) const
+        {
+          DWord sum = 0;
+          for (unsigned int i = symbol_arg; i > 0; i -= i & (~i + 1))
+            sum += tree_[i];
+          return (sum);
+        }
+
+        /** \brief Frequency of \a symbol_arg. */
+        inline DWord
+        frequency (unsigned int symbol_arg) const
+        {
+          return (count_[symbol_arg]);
+        }
+
+        /** \brief Sum of all the frequencies. */
+        inline DWord
+        total () const
+        {
+          return (total_);
+        }
+
+        /** \brief Find the symbol whose cumulative frequency range contains \a target_arg. */
+        inline unsigned int
+        find (DWord target_arg) const
+        {
+          unsigned int pos = 0;
+          for (unsigned int step = 256; step > 0; step >>= 1)
+          {
+            if (pos + step <= 256 && tree_[pos + step] <= target_arg)
+            {
+              pos += step;
+              target_arg -= tree_[pos];
+            }
+          }
+          return (pos);
+        }
+
+        /** \brief Increment the frequency of \a symbol_arg, and rescale the table when \a maxRange_arg is reached. */
+        inline void
+        update (unsigned int symbol_arg, DWord maxRange_arg)
+        {
+          count_[symbol_arg]++;
+          total_++;
+          for (unsigned int i = symbol_arg + 1; i <= 256; i += i & (~i + 1))
+            tree_[i]++;
+
+          if (total_ >= maxRange_arg)
+          {
+            // rescale the cumulative frequencies the way the linear table does
+            DWord freq[257];
+            freq[0] = 0;
+            for (unsigned int f = 1; f <= 256; f++)
+              freq[f] = freq[f - 1] + count_[f - 1];
+            for (unsigned int f = 1; f <= 256; f++)
+            {
+              freq[f] /= 2;
+              if (freq[f] <= freq[f - 1])
+                freq[f] = freq[f - 1] + 1;
+            }
+            for (unsigned int f = 0; f < 256; f++)
+              count_[f] = freq[f + 1] - freq[f];
+            total_ = freq[256];
+            build ();
+          }
+        }
+
+      private:
+        /** \brief Build the Fenwick tree from the symbol frequencies. */
+        void
+        build ()
+        {
+          tree_[0] = 0;
+          for (unsigned int i = 1; i <= 256; i++)
+            tree_[i] = count_[i - 1];
+          for (unsigned int i = 1; i <= 256; i++)
+          {
+            unsigned int parent = i + (i & (~i + 1));
+            if (parent <= 256)
+              tree_[parent] += tree_[i];
+          }
+        }
+
+        DWord count_[256];
+        DWord tree_[257];
+        DWord total_;
+    };
+
+    /** \brief Lower bound of the rANS state. */
+    const uint32_t ransLowerBound = static_cast<uint32_t> (1) << 23;
+
+    /** \brief Tag starting the rANS encoded char vectors (range coded ones start with a zero frequency). */
+    const uint32_t ransCharStreamTag = 0x31534E41;
+
+    /** \brief Tag starting the rANS encoded integer vectors (range coded ones start with a small table size). */
+    const uint64_t ransIntStreamTag = (static_cast<uint64_t> (1) << 63) | 1;
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 unsigned long
 pcl::AdaptiveRangeCoder::encodeCharVectorToStream (const std::vector<char>& inputByteVector_arg,
                                                    std::ostream& outputByteStream_arg)
 {
-  DWord freq[257];
   uint8_t ch;
-  unsigned int i, j, f;
+  unsigned int i;
   char out;
 
   // define limits
@@ -82,8 +248,7 @@ pcl::AdaptiveRangeCoder::encodeCharVectorToStream (const std::vector<char>& inpu
   range = static_cast<DWord> (-1);
 
   // initialize cumulative frequency table
-  for (i = 0; i < 257; i++)
-    freq[i] = i;
+  detail::AdaptiveFrequencyTable freq;
 
   // scan input
   while (readPos < input_size)
@@ -93,8 +258,8 @@ pcl::AdaptiveRangeCoder::encodeCharVectorToStream (const std::vector<char>& inpu
     ch = inputByteVector_arg[readPos++];
 
     // map range
-    low += freq[ch] * (range /= freq[256]);
-    range *= freq[ch + 1] - freq[ch];
+    low += freq.cumulative (ch) * (range /= freq.total ());
+    range *= freq.frequency (ch);
 
     // check range limits
     while ((low ^ (low + range)) < top || ((range < bottom) && ((range = -int (low) & (bottom - 1)), 1)))
@@ -105,22 +270,8 @@ pcl::AdaptiveRangeCoder::encodeCharVectorToStream (const std::vector<char>& inpu
       outputCharVector_.push_back (out);
     }
 
-    // update frequency table
-    for (j = ch + 1; j < 257; j++)
-      freq[j]++;
-
-    // detect overflow
-    if (freq[256] >= maxRange)
-    {
-      // rescale
-      for (f = 1; f <= 256; f++)
-      {
-        freq[f] /= 2;
-        if (freq[f] <= freq[f - 1])
-          freq[f] = freq[f - 1] + 1;
-      }
-    }
-
+    // update frequency table, rescale on overflow
+    freq.update (ch, maxRange);
   }
 
   // flush remaining data
@@ -143,9 +294,7 @@ unsigned long
 pcl::AdaptiveRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream_arg,
                                                    std::vector<char>& outputByteVector_arg)
 {
-  uint8_t ch;
-  DWord freq[257];
-  unsigned int i, j, f;
+  unsigned int i;
 
   // define limits
   const DWord top = static_cast<DWord> (1) << 24;
@@ -160,6 +309,8 @@ pcl::AdaptiveRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream
 
   unsigned long streamByteCount;
 
+  std::streambuf* inputBuffer = inputByteStream_arg.rdbuf ();
+
   streamByteCount = 0;
 
   outputBufPos = 0;
@@ -171,66 +322,40 @@ pcl::AdaptiveRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream
   // init decoding
   for (i = 0; i < 4; i++)
   {
-    inputByteStream_arg.read (reinterpret_cast<char*> (&ch), sizeof(char));
+    code = (code << 8) | detail::readCoderByte (inputByteStream_arg, inputBuffer);
     streamByteCount += sizeof(char);
-    code = (code << 8) | ch;
   }
 
   // init cumulative frequency table
-  for (i = 0; i <= 256; i++)
-    freq[i] = i;
+  detail::AdaptiveFrequencyTable freq;
 
   // decoding loop
   for (i = 0; i < output_size; i++)
   {
-    uint8_t symbol = 0;
-    uint8_t sSize = 256 / 2;
-
     // map code to range
-    DWord count = (code - low) / (range /= freq[256]);
+    DWord count = (code - low) / (range /= freq.total ());
 
     // find corresponding symbol
-    while (sSize > 0)
-    {
-      if (freq[symbol + sSize] <= count)
-      {
-        symbol = static_cast<uint8_t> (symbol + sSize);
-      }
-      sSize /= 2;
-    }
+    unsigned int symbol = freq.find (count);
 
     // output symbol
-    outputByteVector_arg[outputBufPos++] = symbol;
+    outputByteVector_arg[outputBufPos++] = static_cast<char> (symbol);
 
     // update range limits
-    low += freq[symbol] * range;
-    range *= freq[symbol + 1] - freq[symbol];
+    low += freq.cumulative (symbol) * range;
+    range *= freq.frequency (symbol);
 
     // decode range limits
     while ((low ^ (low + range)) < top || ((range < bottom) && ((range = -int (low) & (bottom - 1)), 1)))
     {
-      inputByteStream_arg.read (reinterpret_cast<char*> (&ch), sizeof(char));
+      code = code << 8 | detail::readCoderByte (inputByteStream_arg, inputBuffer);
       streamByteCount += sizeof(char);
-      code = code << 8 | ch;
       range <<= 8;
       low <<= 8;
     }
 
-    // update cumulative frequency table
-    for (j = symbol + 1; j < 257; j++)
-      freq[j]++;
-
-    // detect overflow
-    if (freq[256] >= maxRange)
-    {
-      // rescale
-      for (f = 1; f <= 256; f++)
-      {
-        freq[f] /= 2;
-        if (freq[f] <= freq[f - 1])
-          freq[f] = freq[f - 1] + 1;
-      }
-    }
+    // update cumulative frequency table, rescale on overflow
+    freq.update (symbol, maxRange);
   }
 
   return (streamByteCount);
@@ -239,8 +364,8 @@ pcl::AdaptiveRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 unsigned long
-pcl::StaticRangeCoder::encodeIntVectorToStream (std::vector<unsigned int>& inputIntVector_arg,
-                                                std::ostream& outputByteStream_arg)
+pcl::StaticRangeCoder::encodeIntVectorToStreamV0 (std::vector<unsigned int>& inputIntVector_arg,
+                                                  std::ostream& outputByteStream_arg)
 {
 
   unsigned int inputsymbol;
@@ -387,10 +512,10 @@ pcl::StaticRangeCoder::encodeIntVectorToStream (std::vector<unsigned int>& input
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 unsigned long
-pcl::StaticRangeCoder::decodeStreamToIntVector (std::istream& inputByteStream_arg,
-                                                std::vector<unsigned int>& outputIntVector_arg)
+pcl::StaticRangeCoder::decodeStreamToIntVectorV0 (uint64_t frequencyTableSize_arg,
+                                                  std::istream& inputByteStream_arg,
+                                                  std::vector<unsigned int>& outputIntVector_arg)
 {
-  uint8_t ch;
   unsigned int i, f;
 
   // define range limits
@@ -403,21 +528,22 @@ pcl::StaticRangeCoder::decodeStreamToIntVector (std::istream& inputByteStream_ar
   unsigned int outputBufPos;
   unsigned long output_size;
 
-  uint64_t frequencyTableSize;
+  uint64_t frequencyTableSize = frequencyTableSize_arg;
   unsigned char frequencyTableByteSize;
 
   unsigned long streamByteCount;
 
+  std::streambuf* inputBuffer = inputByteStream_arg.rdbuf ();
+
   streamByteCount = 0;
 
   outputBufPos = 0;
   output_size = static_cast<unsigned long> (outputIntVector_arg.size ());
 
-  // read size of cumulative frequency table from stream
-  inputByteStream_arg.read (reinterpret_cast<char*> (&frequencyTableSize), sizeof(frequencyTableSize));
+  // size of cumulative frequency table already read by the caller
   inputByteStream_arg.read (reinterpret_cast<char*> (&frequencyTableByteSize), sizeof(frequencyTableByteSize));
 
-  streamByteCount += sizeof(frequencyTableSize) + sizeof(frequencyTableByteSize);
+  streamByteCount += sizeof(frequencyTableByteSize);
 
   // check size of frequency table vector
   if (cFreqTable_.size () < frequencyTableSize)
@@ -443,9 +569,8 @@ pcl::StaticRangeCoder::decodeStreamToIntVector (std::istream& inputByteStream_ar
   // init code vector
   for (i = 0; i < 8; i++)
   {
-    inputByteStream_arg.read (reinterpret_cast<char*> (&ch), sizeof(char));
+    code = (code << 8) | detail::readCoderByte (inputByteStream_arg, inputBuffer);
     streamByteCount += sizeof(char);
-    code = (code << 8) | ch;
   }
 
   // decoding
@@ -475,9 +600,8 @@ pcl::StaticRangeCoder::decodeStreamToIntVector (std::istream& inputByteStream_ar
     // check range limits
     while ((low ^ (low + range)) < top || ((range < bottom) && ((range = -low & (bottom - 1)), 1)))
     {
-      inputByteStream_arg.read (reinterpret_cast<char*> (&ch), sizeof(char));
+      code = code << 8 | detail::readCoderByte (inputByteStream_arg, inputBuffer);
       streamByteCount += sizeof(char);
-      code = code << 8 | ch;
       range <<= 8;
       low <<= 8;
     }
@@ -489,8 +613,8 @@ pcl::StaticRangeCoder::decodeStreamToIntVector (std::istream& inputByteStream_ar
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 unsigned long
-pcl::StaticRangeCoder::encodeCharVectorToStream (const std::vector<char>& inputByteVector_arg,
-                                                 std::ostream& outputByteStream_arg)
+pcl::StaticRangeCoder::encodeCharVectorToStreamV0 (const std::vector<char>& inputByteVector_arg,
+                                                   std::ostream& outputByteStream_arg)
 {
   DWord freq[257];
   uint8_t ch;
@@ -598,10 +722,10 @@ pcl::StaticRangeCoder::encodeCharVectorToStream (const std::vector<char>& inputB
 
 //////////////////////////////////////////////////////////////////////////////////////////////
 unsigned long
-pcl::StaticRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream_arg,
-                                                 std::vector<char>& outputByteVector_arg)
+pcl::StaticRangeCoder::decodeStreamToCharVectorV0 (DWord firstFrequency_arg,
+                                                   std::istream& inputByteStream_arg,
+                                                   std::vector<char>& outputByteVector_arg)
 {
-  uint8_t ch;
   DWord freq[257];
   unsigned int i;
 
@@ -617,15 +741,18 @@ pcl::StaticRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream_a
 
   unsigned long streamByteCount;
 
+  std::streambuf* inputBuffer = inputByteStream_arg.rdbuf ();
+
   streamByteCount = 0;
 
   output_size = static_cast<unsigned int> (outputByteVector_arg.size ());
 
   outputBufPos = 0;
 
-  // read cumulative frequency table
-  inputByteStream_arg.read (reinterpret_cast<char*> (&freq[0]), sizeof(freq));
-  streamByteCount += sizeof(freq);
+  // read cumulative frequency table, its first entry is already read by the caller
+  freq[0] = firstFrequency_arg;
+  inputByteStream_arg.read (reinterpret_cast<char*> (&freq[1]), sizeof(freq) - sizeof(DWord));
+  streamByteCount += sizeof(freq) - sizeof(DWord);
 
   code = 0;
   low = 0;
@@ -634,9 +761,8 @@ pcl::StaticRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream_a
   // init code
   for (i = 0; i < 4; i++)
   {
-    inputByteStream_arg.read (reinterpret_cast<char*> (&ch), sizeof(char));
+    code = (code << 8) | detail::readCoderByte (inputByteStream_arg, inputBuffer);
     streamByteCount += sizeof(char);
-    code = (code << 8) | ch;
   }
 
   // decoding
@@ -666,9 +792,8 @@ pcl::StaticRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream_a
     // check range limits
     while ((low ^ (low + range)) < top || ((range < bottom) && ((range = -int (low) & (bottom - 1)), 1)))
     {
-      inputByteStream_arg.read (reinterpret_cast<char*> (&ch), sizeof(char));
+      code = code << 8 | detail::readCoderByte (inputByteStream_arg, inputBuffer);
       streamByteCount += sizeof(char);
-      code = code << 8 | ch;
       range <<= 8;
       low <<= 8;
     }
@@ -678,5 +803,358 @@ pcl::StaticRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream_a
   return (streamByteCount);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::StaticRangeCoder::encodeIntVectorToStream (std::vector<unsigned int>& inputIntVector_arg,
+                                                std::ostream& outputByteStream_arg)
+{
+  if (version_ == RANGE_CODER_BITSTREAM)
+    return (encodeIntVectorToStreamV0 (inputIntVector_arg, outputByteStream_arg));
+
+  const std::size_t input_size = inputIntVector_arg.size ();
+  const unsigned int* input = input_size ? &inputIntVector_arg[0] : NULL;
+  unsigned int maxSymbol = 0;
+  for (std::size_t i = 0; i < input_size; i++)
+    maxSymbol = std::max (maxSymbol, input[i]);
+
+  // count the symbols, in a table indexed by value if the alphabet is small enough
+  symbolTable_.clear ();
+  symbolFreq_.clear ();
+  std::vector<DWord> ranks;
+  const bool denseAlphabet = maxSymbol < (1u << 20);
+  if (denseAlphabet)
+  {
+    rankTable_.assign (static_cast<std::size_t> (maxSymbol) + 1, 0);
+    for (std::size_t i = 0; i < input_size; i++)
+      rankTable_[input[i]]++;
+    for (unsigned int symbol = 0; symbol <= maxSymbol; symbol++)
+    {
+      if (rankTable_[symbol])
+      {
+        symbolTable_.push_back (symbol);
+        symbolFreq_.push_back (rankTable_[symbol]);
+        rankTable_[symbol] = static_cast<DWord> (symbolTable_.size () - 1);
+      }
+    }
+  }
+  else
+  {
+    std::vector<unsigned int> sorted (inputIntVector_arg);
+    std::sort (sorted.begin (), sorted.end ());
+    for (std::size_t i = 0; i < input_size; i++)
+    {
+      if (i == 0 || sorted[i] != sorted[i - 1])
+      {
+        symbolTable_.push_back (sorted[i]);
+        symbolFreq_.push_back (0);
+      }
+      symbolFreq_.back ()++;
+    }
+    ranks.resize (input_size);
+    for (std::size_t i = 0; i < input_size; i++)
+      ranks[i] = static_cast<DWord> (std::lower_bound (symbolTable_.begin (), symbolTable_.end (), input[i]) - symbolTable_.begin ());
+  }
+
+  // too many distinct symbols for the precision of the rANS coder
+  uint8_t scaleBits;
+  if (!normalizeFrequencies (input_size, scaleBits))
+    return (encodeIntVectorToStreamV0 (inputIntVector_arg, outputByteStream_arg));
+
+  outputCharVector_.clear ();
+  outputCharVector_.insert (outputCharVector_.end (), reinterpret_cast<const char*> (&detail::ransIntStreamTag),
+                            reinterpret_cast<const char*> (&detail::ransIntStreamTag) + sizeof (detail::ransIntStreamTag));
+  if (denseAlphabet)
+    encodeRANS (input, input_size, &rankTable_[0], scaleBits);
+  else
+    encodeRANS (input_size ? &ranks[0] : static_cast<const DWord*> (NULL), input_size, static_cast<const DWord*> (NULL), scaleBits);
+
+  outputByteStream_arg.write (&outputCharVector_[0], outputCharVector_.size ());
+  return (static_cast<unsigned long> (outputCharVector_.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::StaticRangeCoder::decodeStreamToIntVector (std::istream& inputByteStream_arg,
+                                                std::vector<unsigned int>& outputIntVector_arg)
+{
+  uint64_t tag = 0;
+  inputByteStream_arg.read (reinterpret_cast<char*> (&tag), sizeof (tag));
+
+  if (tag == detail::ransIntStreamTag)
+    return (sizeof (tag) + decodeRANS (inputByteStream_arg, outputIntVector_arg.empty () ? NULL : &outputIntVector_arg[0],
+                                       outputIntVector_arg.size ()));
+
+  if (tag >> 63)
+  {
+    PCL_ERROR ("[pcl::StaticRangeCoder::decodeStreamToIntVector] Unknown bitstream version %u!\n",
+               static_cast<unsigned int> (tag & 0xFF));
+    return (sizeof (tag));
+  }
+
+  // range coded vectors start with the size of their frequency table
+  return (sizeof (tag) + decodeStreamToIntVectorV0 (tag, inputByteStream_arg, outputIntVector_arg));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::StaticRangeCoder::encodeCharVectorToStream (const std::vector<char>& inputByteVector_arg,
+                                                 std::ostream& outputByteStream_arg)
+{
+  if (version_ == RANGE_CODER_BITSTREAM)
+    return (encodeCharVectorToStreamV0 (inputByteVector_arg, outputByteStream_arg));
+
+  const std::size_t input_size = inputByteVector_arg.size ();
+  const uint8_t* input = input_size ? reinterpret_cast<const uint8_t*> (&inputByteVector_arg[0]) : NULL;
+
+  // calculate frequency table
+  DWord freqHist[256];
+  memset (freqHist, 0, sizeof (freqHist));
+  for (std::size_t i = 0; i < input_size; i++)
+    freqHist[input[i]]++;
+
+  symbolTable_.clear ();
+  symbolFreq_.clear ();
+  rankTable_.resize (256);
+  for (unsigned int symbol = 0; symbol < 256; symbol++)
+  {
+    if (freqHist[symbol])
+    {
+      rankTable_[symbol] = static_cast<DWord> (symbolTable_.size ());
+      symbolTable_.push_back (symbol);
+      symbolFreq_.push_back (freqHist[symbol]);
+    }
+  }
+
+  // 256 symbols always fit
+  uint8_t scaleBits;
+  normalizeFrequencies (input_size, scaleBits);
+
+  outputCharVector_.clear ();
+  outputCharVector_.insert (outputCharVector_.end (), reinterpret_cast<const char*> (&detail::ransCharStreamTag),
+                            reinterpret_cast<const char*> (&detail::ransCharStreamTag) + sizeof (detail::ransCharStreamTag));
+  encodeRANS (input, input_size, &rankTable_[0], scaleBits);
+
+  outputByteStream_arg.write (&outputCharVector_[0], outputCharVector_.size ());
+  return (static_cast<unsigned long> (outputCharVector_.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+unsigned long
+pcl::StaticRangeCoder::decodeStreamToCharVector (std::istream& inputByteStream_arg,
+                                                 std::vector<char>& outputByteVector_arg)
+{
+  DWord tag = 0;
+  inputByteStream_arg.read (reinterpret_cast<char*> (&tag), sizeof (tag));
+
+  // range coded vectors start with a zero cumulative frequency
+  if (tag == 0)
+    return (sizeof (tag) + decodeStreamToCharVectorV0 (tag, inputByteStream_arg, outputByteVector_arg));
+
+  if (tag != detail::ransCharStreamTag)
+  {
+    PCL_ERROR ("[pcl::StaticRangeCoder::decodeStreamToCharVector] Unknown bitstream tag 0x%08x!\n", tag);
+    return (sizeof (tag));
+  }
+
+  return (sizeof (tag) + decodeRANS (inputByteStream_arg, outputByteVector_arg.empty () ? NULL : &outputByteVector_arg[0],
+                                     outputByteVector_arg.size ()));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::StaticRangeCoder::normalizeFrequencies (std::size_t inputSize_arg, uint8_t& scaleBits_arg)
+{
+  const std::size_t symbolCount = symbolTable_.size ();
+
+  // the precision grows with the input size, and must leave room for all the symbols
+  unsigned int scaleBits = 10;
+  while (scaleBits < 14 && (static_cast<std::size_t> (1) << scaleBits) < inputSize_arg)
+    scaleBits++;
+  while (scaleBits < 16 && (static_cast<std::size_t> (1) << scaleBits) < std::min (inputSize_arg, 16 * symbolCount))
+    scaleBits++;
+  while ((static_cast<std::size_t> (1) << scaleBits) < 2 * symbolCount)
+    scaleBits++;
+  if (scaleBits > 16)
+    return (false);
+  scaleBits_arg = static_cast<uint8_t> (scaleBits);
+
+  const DWord totalFreq = static_cast<DWord> (1) << scaleBits;
+  symbolStart_.resize (symbolCount + 1);
+  if (symbolCount == 0)
+  {
+    symbolStart_[0] = 0;
+    return (true);
+  }
+
+  // scale the occurrences, keeping every symbol
+  uint64_t sum = 0;
+  std::size_t maxRank = 0;
+  for (std::size_t r = 0; r < symbolCount; r++)
+  {
+    if (symbolFreq_[r] > symbolFreq_[maxRank])
+      maxRank = r;
+    DWord freq = static_cast<DWord> (static_cast<uint64_t> (symbolFreq_[r]) * totalFreq / inputSize_arg);
+    symbolFreq_[r] = std::max (freq, static_cast<DWord> (1));
+    sum += symbolFreq_[r];
+  }
+
+  // give the rounding error to the most frequent symbols
+  if (sum < totalFreq)
+    symbolFreq_[maxRank] += static_cast<DWord> (totalFreq - sum);
+  else if (sum > totalFreq)
+  {
+    std::vector<std::pair<DWord, std::size_t> > order (symbolCount);
+    for (std::size_t r = 0; r < symbolCount; r++)
+      order[r] = std::make_pair (symbolFreq_[r], r);
+    std::sort (order.begin (), order.end ());
+    uint64_t excess = sum - totalFreq;
+    for (std::size_t o = symbolCount; o-- > 0 && excess > 0;)
+    {
+      DWord& freq = symbolFreq_[order[o].second];
+      DWord take = static_cast<DWord> (std::min<uint64_t> (freq - 1, excess));
+      freq -= take;
+      excess -= take;
+    }
+  }
+
+  symbolStart_[0] = 0;
+  for (std::size_t r = 0; r < symbolCount; r++)
+    symbolStart_[r + 1] = symbolStart_[r] + symbolFreq_[r];
+
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename SymbolT> void
+pcl::StaticRangeCoder::encodeRANS (const SymbolT* input_arg, std::size_t inputSize_arg,
+                                   const DWord* rankTable_arg, uint8_t scaleBits_arg)
+{
+  const DWord lowerBound = detail::ransLowerBound;
+
+  // header: precision and frequency table, the symbols are delta coded
+  outputCharVector_.push_back (static_cast<char> (scaleBits_arg));
+  detail::appendVarint (outputCharVector_, symbolTable_.size ());
+  for (std::size_t r = 0; r < symbolTable_.size (); r++)
+  {
+    detail::appendVarint (outputCharVector_, r ? symbolTable_[r] - symbolTable_[r - 1] - 1 : symbolTable_[r]);
+    detail::appendVarint (outputCharVector_, symbolFreq_[r]);
+  }
+
+  // every symbol writes at most two bytes, the two states are flushed with 8 bytes
+  ransBuffer_.resize (2 * inputSize_arg + 8);
+  char* bufferEnd = &ransBuffer_[0] + ransBuffer_.size ();
+  char* ptr = bufferEnd;
+
+  // encode backwards, even symbols with the first state and odd symbols with the second one
+  DWord state[2] = {lowerBound, lowerBound};
+  for (std::size_t i = inputSize_arg; i-- > 0;)
+  {
+    const DWord rank = rankTable_arg ? rankTable_arg[input_arg[i]] : static_cast<DWord> (input_arg[i]);
+    const DWord freq = symbolFreq_[rank];
+    DWord& x = state[i & 1];
+
+    // renormalize
+    const DWord xMax = ((lowerBound >> scaleBits_arg) << 8) * freq;
+    while (x >= xMax)
+    {
+      *--ptr = static_cast<char> (x & 0xFF);
+      x >>= 8;
+    }
+
+    x = ((x / freq) << scaleBits_arg) + (x % freq) + symbolStart_[rank];
+  }
+
+  // flush the states, the first one ends up in front
+  for (int s = 1; s >= 0; s--)
+  {
+    ptr -= 4;
+    for (int b = 0; b < 4; b++)
+      ptr[b] = static_cast<char> (state[s] >> (8 * b));
+  }
+
+  detail::appendVarint (outputCharVector_, static_cast<uint64_t> (bufferEnd - ptr));
+  outputCharVector_.insert (outputCharVector_.end (), ptr, bufferEnd);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+template <typename SymbolT> unsigned long
+pcl::StaticRangeCoder::decodeRANS (std::istream& inputByteStream_arg, SymbolT* outputVector_arg,
+                                   std::size_t outputSize_arg)
+{
+  const DWord lowerBound = detail::ransLowerBound;
+  std::streambuf* inputBuffer = inputByteStream_arg.rdbuf ();
+  unsigned long streamByteCount = 0;
+
+  // read precision and frequency table
+  uint8_t scaleBits = detail::readCoderByte (inputByteStream_arg, inputBuffer);
+  streamByteCount++;
+  uint64_t symbolCount, value;
+  streamByteCount += detail::readVarint (inputByteStream_arg, inputBuffer, symbolCount);
+  if (scaleBits > 16 || symbolCount > (static_cast<uint64_t> (1) << scaleBits) || !inputByteStream_arg)
+  {
+    PCL_ERROR ("[pcl::StaticRangeCoder::decodeRANS] Invalid frequency table!\n");
+    return (streamByteCount);
+  }
+
+  const DWord totalFreq = static_cast<DWord> (1) << scaleBits;
+  symbolTable_.resize (static_cast<std::size_t> (symbolCount));
+  symbolFreq_.resize (static_cast<std::size_t> (symbolCount));
+  symbolStart_.resize (static_cast<std::size_t> (symbolCount) + 1);
+  symbolStart_[0] = 0;
+  for (std::size_t r = 0; r < symbolTable_.size (); r++)
+  {
+    streamByteCount += detail::readVarint (inputByteStream_arg, inputBuffer, value);
+    symbolTable_[r] = static_cast<unsigned int> (r ? symbolTable_[r - 1] + 1 + value : value);
+    streamByteCount += detail::readVarint (inputByteStream_arg, inputBuffer, value);
+    symbolFreq_[r] = static_cast<DWord> (std::min<uint64_t> (value, totalFreq));
+    symbolStart_[r + 1] = symbolStart_[r] + symbolFreq_[r];
+  }
+  if (!inputByteStream_arg || (symbolCount > 0 && symbolStart_.back () != totalFreq) ||
+      (symbolCount == 0 && outputSize_arg > 0))
+  {
+    PCL_ERROR ("[pcl::StaticRangeCoder::decodeRANS] Invalid frequency table!\n");
+    return (streamByteCount);
+  }
+
+  // slot to symbol lookup table
+  rankTable_.resize (totalFreq);
+  for (std::size_t r = 0; r < symbolTable_.size (); r++)
+    std::fill (rankTable_.begin () + symbolStart_[r], rankTable_.begin () + symbolStart_[r + 1], static_cast<DWord> (r));
+
+  // read the payload at once, zero padded so that reading the states never overflows
+  uint64_t payloadSize;
+  streamByteCount += detail::readVarint (inputByteStream_arg, inputBuffer, payloadSize);
+  ransBuffer_.assign (static_cast<std::size_t> (payloadSize) + 8, 0);
+  inputByteStream_arg.read (&ransBuffer_[0], static_cast<std::streamsize> (payloadSize));
+  streamByteCount += static_cast<unsigned long> (payloadSize);
+
+  const uint8_t* ptr = reinterpret_cast<const uint8_t*> (&ransBuffer_[0]);
+  const uint8_t* end = ptr + payloadSize;
+  DWord state[2];
+  for (int s = 0; s < 2; s++, ptr += 4)
+    state[s] = static_cast<DWord> (ptr[0]) | (static_cast<DWord> (ptr[1]) << 8) |
+               (static_cast<DWord> (ptr[2]) << 16) | (static_cast<DWord> (ptr[3]) << 24);
+
+  const DWord mask = totalFreq - 1;
+  const DWord* rankTable = &rankTable_[0];
+  const DWord* freqTable = symbolFreq_.empty () ? NULL : &symbolFreq_[0];
+  const DWord* startTable = &symbolStart_[0];
+  const unsigned int* symbolTable = symbolTable_.empty () ? NULL : &symbolTable_[0];
+  for (std::size_t i = 0; i < outputSize_arg; i++)
+  {
+    DWord& x = state[i & 1];
+    const DWord slot = x & mask;
+    const DWord rank = rankTable[slot];
+    outputVector_arg[i] = static_cast<SymbolT> (symbolTable[rank]);
+    x = freqTable[rank] * (x >> scaleBits) + slot - startTable[rank];
+
+    // renormalize
+    while (x < lowerBound && ptr < end)
+      x = (x << 8) | *ptr++;
+  }
+
+  return (streamByteCount);
+}
+
 #endif
 
@@ -43,6 +43,7 @@
 
 #include <iterator>
 #include <iostream>
+#include <sstream>
 #include <vector>
 #include <string.h>
 #include <iostream>
@@ -59,6 +60,48 @@ namespace pcl
         PointT, LeafT, BranchT, OctreeT>::encodePointCloud (
         const PointCloudConstPtr &cloud_arg,
         std::ostream& compressedTreeDataOut_arg)
+    {
+      FrameData frame;
+
+      // build and serialize octree
+      if (!serializePointCloud (cloud_arg, frame))
+        return;
+
+      // write frame header information to stream
+      compressedTreeDataOut_arg.write (frame.header.data (), frame.header.size ());
+
+      // apply entropy coding to the content of all data vectors and send data to output stream
+      encodeFrameData (frame, entropyCoder_, compressedTreeDataOut_arg, compressedPointDataLen_, compressedColorDataLen_);
+
+      if (bShowStatistics)
+      {
+        float bytesPerXYZ = static_cast<float> (compressedPointDataLen_) / static_cast<float> (pointCount_);
+        float bytesPerColor = static_cast<float> (compressedColorDataLen_) / static_cast<float> (pointCount_);
+
+        PCL_INFO ("*** POINTCLOUD ENCODING ***\n");
+        PCL_INFO ("Frame ID: %d\n", frameID_);
+        if (frame.iFrame)
+          PCL_INFO ("Encoding Frame: Intra frame\n");
+        else
+          PCL_INFO ("Encoding Frame: Prediction frame\n");
+        PCL_INFO ("Number of encoded points: %ld\n", pointCount_);
+        PCL_INFO ("XYZ compression percentage: %f%%\n", bytesPerXYZ / (3.0f * sizeof(float)) * 100.0f);
+        PCL_INFO ("XYZ bytes per point: %f bytes\n", bytesPerXYZ);
+        PCL_INFO ("Color compression percentage: %f%%\n", bytesPerColor / (sizeof (int)) * 100.0f);
+        PCL_INFO ("Color bytes per point: %f bytes\n", bytesPerColor);
+        PCL_INFO ("Size of uncompressed point cloud: %f kBytes\n", static_cast<float> (pointCount_) * (sizeof (int) + 3.0f  * sizeof (float)) / 1024);
+        PCL_INFO ("Size of compressed point cloud: %d kBytes\n", (compressedPointDataLen_ + compressedColorDataLen_) / (1024));
+        PCL_INFO ("Total bytes per point: %f\n", bytesPerXYZ + bytesPerColor);
+        PCL_INFO ("Total compression percentage: %f\n", (bytesPerXYZ + bytesPerColor) / (sizeof (int) + 3.0f * sizeof(float)) * 100.0f);
+        PCL_INFO ("Compression ratio: %f\n\n", static_cast<float> (sizeof (int) + 3.0f * sizeof (float)) / static_cast<float> (bytesPerXYZ + bytesPerColor));
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> bool OctreePointCloudCompression<
+        PointT, LeafT, BranchT, OctreeT>::serializePointCloud (
+        const PointCloudConstPtr &cloud_arg,
+        FrameData &frame_arg)
     {
       unsigned char recentTreeDepth =
           static_cast<unsigned char> (this->getTreeDepth ());
@@ -70,104 +113,152 @@ namespace pcl
       this->addPointsFromInputCloud ();
 
       // make sure cloud contains points
-      if (this->leafCount_>0) {
+      if (this->leafCount_ == 0)
+      {
+        if (bShowStatistics)
+          PCL_INFO ("Info: Dropping empty point cloud\n");
+        this->deleteTree();
+        iFrameCounter_ = 0;
+        iFrame_ = true;
+        return (false);
+      }
 
+      // color field analysis
+      cloudWithColor_ = false;
+      std::vector<sensor_msgs::PointField> fields;
+      int rgba_index = -1;
+      rgba_index = pcl::getFieldIndex (*this->input_, "rgb", fields);
+      if (rgba_index == -1)
+      {
+        rgba_index = pcl::getFieldIndex (*this->input_, "rgba", fields);
+      }
+      if (rgba_index >= 0)
+      {
+        pointColorOffset_ = static_cast<unsigned char> (fields[rgba_index].offset);
+        cloudWithColor_ = true;
+      }
 
-        // color field analysis
-        cloudWithColor_ = false;
-        std::vector<sensor_msgs::PointField> fields;
-        int rgba_index = -1;
-        rgba_index = pcl::getFieldIndex (*this->input_, "rgb", fields);
-        if (rgba_index == -1)
-        {
-          rgba_index = pcl::getFieldIndex (*this->input_, "rgba", fields);
-        }
-        if (rgba_index >= 0)
-        {
-          pointColorOffset_ = static_cast<unsigned char> (fields[rgba_index].offset);
-          cloudWithColor_ = true;
-        }
+      // apply encoding configuration
+      cloudWithColor_ &= doColorEncoding_;
 
-        // apply encoding configuration
-        cloudWithColor_ &= doColorEncoding_;
 
+      // if octree depth changed, we enforce I-frame encoding
+      iFrame_ |= (recentTreeDepth != this->getTreeDepth ());// | !(iFrameCounter%10);
 
-        // if octree depth changed, we enforce I-frame encoding
-        iFrame_ |= (recentTreeDepth != this->getTreeDepth ());// | !(iFrameCounter%10);
+      // enable I-frame rate
+      if (iFrameCounter_++==iFrameRate_)
+      {
+        iFrameCounter_ =0;
+        iFrame_ = true;
+      }
 
-        // enable I-frame rate
-        if (iFrameCounter_++==iFrameRate_)
-        {
-          iFrameCounter_ =0;
-          iFrame_ = true;
-        }
+      // increase frameID
+      frameID_++;
 
-        // increase frameID
-        frameID_++;
+      // do octree encoding
+      if (!doVoxelGridEnDecoding_)
+      {
+        pointCountDataVector_.clear ();
+        pointCountDataVector_.reserve (cloud_arg->points.size ());
+      }
 
-        // do octree encoding
-        if (!doVoxelGridEnDecoding_)
-        {
-          pointCountDataVector_.clear ();
-          pointCountDataVector_.reserve (cloud_arg->points.size ());
-        }
+      // initialize color encoding
+      colorCoder_.initializeEncoding ();
+      colorCoder_.setPointCount (static_cast<unsigned int> (cloud_arg->points.size ()));
+      colorCoder_.setVoxelCount (static_cast<unsigned int> (this->leafCount_));
 
-        // initialize color encoding
-        colorCoder_.initializeEncoding ();
-        colorCoder_.setPointCount (static_cast<unsigned int> (cloud_arg->points.size ()));
-        colorCoder_.setVoxelCount (static_cast<unsigned int> (this->leafCount_));
+      // initialize point encoding
+      pointCoder_.initializeEncoding ();
+      pointCoder_.setPointCount (static_cast<unsigned int> (cloud_arg->points.size ()));
 
-        // initialize point encoding
-        pointCoder_.initializeEncoding ();
-        pointCoder_.setPointCount (static_cast<unsigned int> (cloud_arg->points.size ()));
+      // serialize octree
+      if (iFrame_)
+        // i-frame encoding - encode tree structure without referencing previous buffer
+        this->serializeTree (binaryTreeDataVector_, false);
+      else
+        // p-frame encoding - XOR encoded tree structure
+        this->serializeTree (binaryTreeDataVector_, true);
+
+      // write frame header information
+      std::ostringstream header;
+      this->writeFrameHeader (header);
+      frame_arg.header = header.str ();
+      frame_arg.withColor = cloudWithColor_;
+      frame_arg.voxelGrid = doVoxelGridEnDecoding_;
+      frame_arg.iFrame = iFrame_;
+      frame_arg.pointCount = pointCount_;
+
+      // hand the data vectors over to the frame
+      frame_arg.binaryTreeData.swap (binaryTreeDataVector_);
+      frame_arg.avgColorData.swap (colorCoder_.getAverageDataVector ());
+      frame_arg.pointCountData.swap (pointCountDataVector_);
+      frame_arg.pointDiffData.swap (pointCoder_.getDifferentialDataVector ());
+      frame_arg.pointDiffColorData.swap (colorCoder_.getDifferentialDataVector ());
+
+      // prepare for next frame
+      this->switchBuffers ();
+      iFrame_ = false;
+      return (true);
+    }
 
-        // serialize octree
-        if (iFrame_)
-          // i-frame encoding - encode tree structure without referencing previous buffer
-          this->serializeTree (binaryTreeDataVector_, false);
-        else
-          // p-frame encoding - XOR encoded tree structure
-          this->serializeTree (binaryTreeDataVector_, true);
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
+    OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::encodeFrameData (
+        FrameData &frame_arg, StaticRangeCoder &entropyCoder_arg,
+        std::ostream& compressedTreeDataOut_arg,
+        uint64_t &compressedPointDataLen_arg, uint64_t &compressedColorDataLen_arg)
+    {
+      uint64_t binaryTreeDataVector_size;
+      uint64_t pointAvgColorDataVector_size;
 
-        // write frame header information to stream
-        this->writeFrameHeader (compressedTreeDataOut_arg);
+      compressedPointDataLen_arg = 0;
+      compressedColorDataLen_arg = 0;
 
-        // apply entropy coding to the content of all data vectors and send data to output stream
-        this->entropyEncoding (compressedTreeDataOut_arg);
+      // encode binary octree structure
+      binaryTreeDataVector_size = frame_arg.binaryTreeData.size ();
+      compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&binaryTreeDataVector_size), sizeof (binaryTreeDataVector_size));
+      compressedPointDataLen_arg += entropyCoder_arg.encodeCharVectorToStream (frame_arg.binaryTreeData,
+                                                                               compressedTreeDataOut_arg);
 
-        // prepare for next frame
-        this->switchBuffers ();
-        iFrame_ = false;
+      if (frame_arg.withColor)
+      {
+        // encode averaged voxel color information
+        pointAvgColorDataVector_size = frame_arg.avgColorData.size ();
+        compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&pointAvgColorDataVector_size),
+                                         sizeof (pointAvgColorDataVector_size));
+        compressedColorDataLen_arg += entropyCoder_arg.encodeCharVectorToStream (frame_arg.avgColorData,
+                                                                                 compressedTreeDataOut_arg);
+      }
 
-        if (bShowStatistics)
+      if (!frame_arg.voxelGrid)
+      {
+        uint64_t pointCountDataVector_size;
+        uint64_t pointDiffDataVector_size;
+        uint64_t pointDiffColorDataVector_size;
+
+        // encode amount of points per voxel
+        pointCountDataVector_size = frame_arg.pointCountData.size ();
+        compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&pointCountDataVector_size), sizeof (pointCountDataVector_size));
+        compressedPointDataLen_arg += entropyCoder_arg.encodeIntVectorToStream (frame_arg.pointCountData,
+                                                                                compressedTreeDataOut_arg);
+
+        // encode differential point information
+        pointDiffDataVector_size = frame_arg.pointDiffData.size ();
+        compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&pointDiffDataVector_size), sizeof (pointDiffDataVector_size));
+        compressedPointDataLen_arg += entropyCoder_arg.encodeCharVectorToStream (frame_arg.pointDiffData,
+                                                                                 compressedTreeDataOut_arg);
+        if (frame_arg.withColor)
         {
-          float bytesPerXYZ = static_cast<float> (compressedPointDataLen_) / static_cast<float> (pointCount_);
-          float bytesPerColor = static_cast<float> (compressedColorDataLen_) / static_cast<float> (pointCount_);
-
-          PCL_INFO ("*** POINTCLOUD ENCODING ***\n");
-          PCL_INFO ("Frame ID: %d\n", frameID_);
-          if (iFrame_)
-            PCL_INFO ("Encoding Frame: Intra frame\n");
-          else
-            PCL_INFO ("Encoding Frame: Prediction frame\n");
-          PCL_INFO ("Number of encoded points: %ld\n", pointCount_);
-          PCL_INFO ("XYZ compression percentage: %f%%\n", bytesPerXYZ / (3.0f * sizeof(float)) * 100.0f);
-          PCL_INFO ("XYZ bytes per point: %f bytes\n", bytesPerXYZ);
-          PCL_INFO ("Color compression percentage: %f%%\n", bytesPerColor / (sizeof (int)) * 100.0f);
-          PCL_INFO ("Color bytes per point: %f bytes\n", bytesPerColor);
-          PCL_INFO ("Size of uncompressed point cloud: %f kBytes\n", static_cast<float> (pointCount_) * (sizeof (int) + 3.0f  * sizeof (float)) / 1024);
-          PCL_INFO ("Size of compressed point cloud: %d kBytes\n", (compressedPointDataLen_ + compressedColorDataLen_) / (1024));
-          PCL_INFO ("Total bytes per point: %f\n", bytesPerXYZ + bytesPerColor);
-          PCL_INFO ("Total compression percentage: %f\n", (bytesPerXYZ + bytesPerColor) / (sizeof (int) + 3.0f * sizeof(float)) * 100.0f);
-          PCL_INFO ("Compression ratio: %f\n\n", static_cast<float> (sizeof (int) + 3.0f * sizeof (float)) / static_cast<float> (bytesPerXYZ + bytesPerColor));
+          // encode differential color information
+          pointDiffColorDataVector_size = frame_arg.pointDiffColorData.size ();
+          compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&pointDiffColorDataVector_size),
+                                           sizeof (pointDiffColorDataVector_size));
+          compressedColorDataLen_arg += entropyCoder_arg.encodeCharVectorToStream (frame_arg.pointDiffColorData,
+                                                                                   compressedTreeDataOut_arg);
         }
-      } else {
-        if (bShowStatistics)
-        PCL_INFO ("Info: Dropping empty point cloud\n");
-        this->deleteTree();
-        iFrameCounter_ = 0;
-        iFrame_ = true;
       }
+      // flush output stream
+      compressedTreeDataOut_arg.flush ();
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -251,60 +342,23 @@ namespace pcl
     template<typename PointT, typename LeafT, typename BranchT, typename OctreeT> void
     OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeT>::entropyEncoding (std::ostream& compressedTreeDataOut_arg)
     {
-      uint64_t binaryTreeDataVector_size;
-      uint64_t pointAvgColorDataVector_size;
-
-      compressedPointDataLen_ = 0;
-      compressedColorDataLen_ = 0;
-
-      // encode binary octree structure
-      binaryTreeDataVector_size = binaryTreeDataVector_.size ();
-      compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&binaryTreeDataVector_size), sizeof (binaryTreeDataVector_size));
-      compressedPointDataLen_ += entropyCoder_.encodeCharVectorToStream (binaryTreeDataVector_,
-                                                                         compressedTreeDataOut_arg);
-
-      if (cloudWithColor_)
-      {
-        // encode averaged voxel color information
-        std::vector<char>& pointAvgColorDataVector = colorCoder_.getAverageDataVector ();
-        pointAvgColorDataVector_size = pointAvgColorDataVector.size ();
-        compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&pointAvgColorDataVector_size),
-                                         sizeof (pointAvgColorDataVector_size));
-        compressedColorDataLen_ += entropyCoder_.encodeCharVectorToStream (pointAvgColorDataVector,
-                                                                           compressedTreeDataOut_arg);
-      }
-
-      if (!doVoxelGridEnDecoding_)
-      {
-        uint64_t pointCountDataVector_size;
-        uint64_t pointDiffDataVector_size;
-        uint64_t pointDiffColorDataVector_size;
-
-        // encode amount of points per voxel
-        pointCountDataVector_size = pointCountDataVector_.size ();
-        compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&pointCountDataVector_size), sizeof (pointCountDataVector_size));
-        compressedPointDataLen_ += entropyCoder_.encodeIntVectorToStream (pointCountDataVector_,
-                                                                          compressedTreeDataOut_arg);
-
-        // encode differential point information
-        std::vector<char>& pointDiffDataVector = pointCoder_.getDifferentialDataVector ();
-        pointDiffDataVector_size = pointDiffDataVector.size ();
-        compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&pointDiffDataVector_size), sizeof (pointDiffDataVector_size));
-        compressedPointDataLen_ += entropyCoder_.encodeCharVectorToStream (pointDiffDataVector,
-                                                                           compressedTreeDataOut_arg);
-        if (cloudWithColor_)
-        {
-          // encode differential color information
-          std::vector<char>& pointDiffColorDataVector = colorCoder_.getDifferentialDataVector ();
-          pointDiffColorDataVector_size = pointDiffColorDataVector.size ();
-          compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&pointDiffColorDataVector_size),
-                                           sizeof (pointDiffColorDataVector_size));
-          compressedColorDataLen_ += entropyCoder_.encodeCharVectorToStream (pointDiffColorDataVector,
-                                                                             compressedTreeDataOut_arg);
-        }
-      }
-      // flush output stream
-      compressedTreeDataOut_arg.flush ();
+      // borrow the data vectors for the time of the encoding
+      FrameData frame;
+      frame.withColor = cloudWithColor_;
+      frame.voxelGrid = doVoxelGridEnDecoding_;
+      frame.binaryTreeData.swap (binaryTreeDataVector_);
+      frame.avgColorData.swap (colorCoder_.getAverageDataVector ());
+      frame.pointCountData.swap (pointCountDataVector_);
+      frame.pointDiffData.swap (pointCoder_.getDifferentialDataVector ());
+      frame.pointDiffColorData.swap (colorCoder_.getDifferentialDataVector ());
+
+      encodeFrameData (frame, entropyCoder_, compressedTreeDataOut_arg, compressedPointDataLen_, compressedColorDataLen_);
+
+      frame.binaryTreeData.swap (binaryTreeDataVector_);
+      frame.avgColorData.swap (colorCoder_.getAverageDataVector ());
+      frame.pointCountData.swap (pointCountDataVector_);
+      frame.pointDiffData.swap (pointCoder_.getDifferentialDataVector ());
+      frame.pointDiffColorData.swap (colorCoder_.getDifferentialDataVector ());
     }
 
     //////////////////////////////////////////////////////////////////////////////////////////////
@@ -0,0 +1,405 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef OCTREE_POINTCLOUD_SEQUENCE_HPP
+#define OCTREE_POINTCLOUD_SEQUENCE_HPP
+
+#include <pcl/compression/octree_pointcloud_sequence.h>
+
+#include <sstream>
+#include <string.h>
+
+namespace pcl
+{
+  namespace io
+  {
+    namespace detail
+    {
+      /** \brief File magic of the sequence files. */
+      const char octreeSequenceMagic[8] = {'P', 'C', 'L', 'O', 'C', 'S', 'E', 'Q'};
+      const uint32_t octreeSequenceVersion = 1;
+      /** \brief Magic of a frame record, and of the index. */
+      const uint32_t octreeSequenceRecordMagic = 0x52515350; // "PSQR"
+      const uint32_t octreeSequenceIndexMagic = 0x49515350;  // "PSQI"
+      /** \brief Size of the file header: magic, version, reserved word, index offset. */
+      const uint64_t octreeSequenceHeaderSize = sizeof (octreeSequenceMagic) + 2 * sizeof (uint32_t) + sizeof (uint64_t);
+      /** \brief Offset of the index offset in the file header. */
+      const uint64_t octreeSequenceIndexOffsetPos = sizeof (octreeSequenceMagic) + 2 * sizeof (uint32_t);
+      /** \brief Frame record flags. */
+      const uint8_t octreeSequenceKeyFrame = 1;
+
+      template <typename T> inline void
+      writeSequenceValue (std::ostream &stream_arg, const T &value_arg)
+      {
+        stream_arg.write (reinterpret_cast<const char*> (&value_arg), sizeof (T));
+      }
+
+      template <typename T> inline bool
+      readSequenceValue (std::istream &stream_arg, T &value_arg)
+      {
+        stream_arg.read (reinterpret_cast<char*> (&value_arg), sizeof (T));
+        return (stream_arg.good ());
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+    OctreePointCloudSequenceWriter<PointT>::OctreePointCloudSequenceWriter (
+        compression_Profiles_e compressionProfile_arg,
+        const double pointResolution_arg,
+        const double octreeResolution_arg,
+        bool doVoxelGridDownDownSampling_arg,
+        const unsigned int keyFrameRate_arg,
+        bool doColorEncoding_arg,
+        const unsigned char colorBitResolution_arg) :
+      encoder_ (), entropyCoder_ (), file_ (), frames_ (), fileSize_ (0),
+      selectedProfile_ (compressionProfile_arg), pointResolution_ (pointResolution_arg),
+      octreeResolution_ (octreeResolution_arg), doVoxelGridEnDecoding_ (doVoxelGridDownDownSampling_arg),
+      keyFrameRate_ (keyFrameRate_arg), doColorEncoding_ (doColorEncoding_arg),
+      colorBitResolution_ (colorBitResolution_arg)
+    {
+      entropyCoder_.setBitstreamVersion (StaticRangeCoder::RANS_BITSTREAM);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+    OctreePointCloudSequenceWriter<PointT>::~OctreePointCloudSequenceWriter ()
+    {
+      if (isOpen ())
+        close ();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> bool
+    OctreePointCloudSequenceWriter<PointT>::open (const std::string &fileName_arg)
+    {
+      if (isOpen ())
+        close ();
+
+      file_.clear ();
+      file_.open (fileName_arg.c_str (), std::ios::out | std::ios::binary | std::ios::trunc);
+      if (!file_.is_open ())
+      {
+        PCL_ERROR ("[pcl::io::OctreePointCloudSequenceWriter::open] Could not create file %s!\n", fileName_arg.c_str ());
+        return (false);
+      }
+
+      // the index offset is written by close
+      file_.write (detail::octreeSequenceMagic, sizeof (detail::octreeSequenceMagic));
+      detail::writeSequenceValue (file_, detail::octreeSequenceVersion);
+      detail::writeSequenceValue (file_, uint32_t (0));
+      detail::writeSequenceValue (file_, uint64_t (0));
+      fileSize_ = detail::octreeSequenceHeaderSize;
+      frames_.clear ();
+
+      // a new encoder, so that the file starts with a key frame
+      encoder_.reset (new FrameCompression (selectedProfile_, false, pointResolution_, octreeResolution_,
+                                            doVoxelGridEnDecoding_, keyFrameRate_, doColorEncoding_,
+                                            colorBitResolution_));
+      return (file_.good ());
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> bool
+    OctreePointCloudSequenceWriter<PointT>::writeFrame (const PointCloudConstPtr &cloud_arg)
+    {
+      if (!isOpen ())
+      {
+        PCL_ERROR ("[pcl::io::OctreePointCloudSequenceWriter::writeFrame] No file is open!\n");
+        return (false);
+      }
+
+      // compress the point cloud; empty point clouds are not encoded, and reset the encoder
+      typename FrameCompression::FrameData frameData;
+      std::ostringstream payload;
+      const bool nonEmpty = encoder_->serializePointCloud (cloud_arg, frameData);
+      if (nonEmpty)
+      {
+        uint64_t pointDataLen, colorDataLen;
+        payload.write (frameData.header.data (), frameData.header.size ());
+        FrameCompression::encodeFrameData (frameData, entropyCoder_, payload, pointDataLen, colorDataLen);
+      }
+      const std::string data = payload.str ();
+
+      OctreePointCloudSequenceFrame frame;
+      frame.offset = fileSize_;
+      frame.size = data.size ();
+      frame.stamp = cloud_arg->header.stamp;
+      frame.seq = cloud_arg->header.seq;
+      frame.keyFrame = !nonEmpty || frameData.iFrame;
+
+      const std::string &frameID = cloud_arg->header.frame_id;
+      detail::writeSequenceValue (file_, detail::octreeSequenceRecordMagic);
+      detail::writeSequenceValue (file_, uint8_t (frame.keyFrame ? detail::octreeSequenceKeyFrame : 0));
+      detail::writeSequenceValue (file_, frame.size);
+      detail::writeSequenceValue (file_, frame.stamp);
+      detail::writeSequenceValue (file_, frame.seq);
+      detail::writeSequenceValue (file_, static_cast<uint32_t> (frameID.size ()));
+      file_.write (frameID.data (), frameID.size ());
+      file_.write (data.data (), data.size ());
+      if (!file_.good ())
+      {
+        PCL_ERROR ("[pcl::io::OctreePointCloudSequenceWriter::writeFrame] Could not write frame %zu!\n", frames_.size ());
+        return (false);
+      }
+
+      fileSize_ += 2 * sizeof (uint32_t) + 1 + 2 * sizeof (uint64_t) + sizeof (uint32_t) + frameID.size () + data.size ();
+      frames_.push_back (frame);
+      return (true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> bool
+    OctreePointCloudSequenceWriter<PointT>::close ()
+    {
+      if (!isOpen ())
+        return (false);
+
+      // append the index, and point the file header to it
+      detail::writeSequenceValue (file_, detail::octreeSequenceIndexMagic);
+      detail::writeSequenceValue (file_, static_cast<uint64_t> (frames_.size ()));
+      for (size_t i = 0; i < frames_.size (); ++i)
+      {
+        detail::writeSequenceValue (file_, frames_[i].offset);
+        detail::writeSequenceValue (file_, frames_[i].size);
+        detail::writeSequenceValue (file_, frames_[i].stamp);
+        detail::writeSequenceValue (file_, frames_[i].seq);
+        detail::writeSequenceValue (file_, uint8_t (frames_[i].keyFrame ? detail::octreeSequenceKeyFrame : 0));
+      }
+      file_.seekp (detail::octreeSequenceIndexOffsetPos);
+      detail::writeSequenceValue (file_, fileSize_);
+
+      const bool success = file_.good ();
+      file_.close ();
+      if (!success)
+        PCL_ERROR ("[pcl::io::OctreePointCloudSequenceWriter::close] Could not write the frame index!\n");
+      return (success);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+    OctreePointCloudSequenceReader<PointT>::OctreePointCloudSequenceReader () :
+      decoder_ (), file_ (), frames_ (), lastDecoded_ (-1), buffer_ ()
+    {
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> bool
+    OctreePointCloudSequenceReader<PointT>::open (const std::string &fileName_arg)
+    {
+      close ();
+      file_.clear ();
+      file_.open (fileName_arg.c_str (), std::ios::in | std::ios::binary);
+      if (!file_.is_open ())
+      {
+        PCL_ERROR ("[pcl::io::OctreePointCloudSequenceReader::open] Could not open file %s!\n", fileName_arg.c_str ());
+        return (false);
+      }
+
+      file_.seekg (0, std::ios::end);
+      const uint64_t fileSize = static_cast<uint64_t> (file_.tellg ());
+      file_.seekg (0, std::ios::beg);
+
+      char magic[sizeof (detail::octreeSequenceMagic)];
+      uint32_t version, reserved;
+      uint64_t indexOffset;
+      file_.read (magic, sizeof (magic));
+      if (!file_.good () || memcmp (magic, detail::octreeSequenceMagic, sizeof (magic)) != 0 ||
+          !detail::readSequenceValue (file_, version) || !detail::readSequenceValue (file_, reserved) ||
+          !detail::readSequenceValue (file_, indexOffset) || version != detail::octreeSequenceVersion)
+      {
+        PCL_ERROR ("[pcl::io::OctreePointCloudSequenceReader::open] %s is not a point cloud sequence file!\n", fileName_arg.c_str ());
+        close ();
+        return (false);
+      }
+
+      if (indexOffset != 0)
+      {
+        // read the index
+        uint32_t indexMagic;
+        uint64_t frameCount;
+        file_.seekg (indexOffset);
+        if (!detail::readSequenceValue (file_, indexMagic) || indexMagic != detail::octreeSequenceIndexMagic ||
+            !detail::readSequenceValue (file_, frameCount) || frameCount > fileSize)
+        {
+          PCL_ERROR ("[pcl::io::OctreePointCloudSequenceReader::open] Invalid frame index in %s!\n", fileName_arg.c_str ());
+          close ();
+          return (false);
+        }
+        frames_.resize (static_cast<size_t> (frameCount));
+        for (size_t i = 0; i < frames_.size (); ++i)
+        {
+          uint8_t flags = 0;
+          detail::readSequenceValue (file_, frames_[i].offset);
+          detail::readSequenceValue (file_, frames_[i].size);
+          detail::readSequenceValue (file_, frames_[i].stamp);
+          detail::readSequenceValue (file_, frames_[i].seq);
+          file_.read (reinterpret_cast<char*> (&flags), sizeof (flags));
+          frames_[i].keyFrame = (flags & detail::octreeSequenceKeyFrame) != 0;
+        }
+        if (file_.fail ())
+        {
+          PCL_ERROR ("[pcl::io::OctreePointCloudSequenceReader::open] Truncated frame index in %s!\n", fileName_arg.c_str ());
+          close ();
+          return (false);
+        }
+      }
+      else
+      {
+        // the file was not closed: rebuild the index from the complete frame records
+        uint64_t offset = detail::octreeSequenceHeaderSize;
+        for (;;)
+        {
+          OctreePointCloudSequenceFrame frame;
+          uint32_t recordMagic, frameIDSize;
+          uint8_t flags;
+          file_.seekg (offset);
+          if (!detail::readSequenceValue (file_, recordMagic) || recordMagic != detail::octreeSequenceRecordMagic ||
+              !detail::readSequenceValue (file_, flags) || !detail::readSequenceValue (file_, frame.size) ||
+              !detail::readSequenceValue (file_, frame.stamp) || !detail::readSequenceValue (file_, frame.seq) ||
+              !detail::readSequenceValue (file_, frameIDSize))
+            break;
+          const uint64_t recordEnd = static_cast<uint64_t> (file_.tellg ()) + frameIDSize + frame.size;
+          if (recordEnd > fileSize)
+            break;
+          frame.offset = offset;
+          frame.keyFrame = (flags & detail::octreeSequenceKeyFrame) != 0;
+          frames_.push_back (frame);
+          offset = recordEnd;
+        }
+        file_.clear ();
+        PCL_WARN ("[pcl::io::OctreePointCloudSequenceReader::open] %s has no frame index, found %zu frames.\n",
+                  fileName_arg.c_str (), frames_.size ());
+      }
+      return (true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    OctreePointCloudSequenceReader<PointT>::close ()
+    {
+      if (file_.is_open ())
+        file_.close ();
+      frames_.clear ();
+      decoder_.reset ();
+      lastDecoded_ = -1;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> size_t
+    OctreePointCloudSequenceReader<PointT>::getKeyFrame (size_t index_arg) const
+    {
+      while (index_arg > 0 && !frames_[index_arg].keyFrame)
+        --index_arg;
+      return (index_arg);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> bool
+    OctreePointCloudSequenceReader<PointT>::readFrame (size_t index_arg, PointCloudPtr &cloud_arg)
+    {
+      if (index_arg >= frames_.size ())
+      {
+        PCL_ERROR ("[pcl::io::OctreePointCloudSequenceReader::readFrame] Frame %zu is out of range (%zu frames)!\n",
+                   index_arg, frames_.size ());
+        return (false);
+      }
+
+      // continue from the last decoded frame if it lies between the key frame and the frame
+      const long keyFrame = static_cast<long> (getKeyFrame (index_arg));
+      long first = keyFrame;
+      if (lastDecoded_ >= keyFrame && lastDecoded_ < static_cast<long> (index_arg))
+        first = lastDecoded_ + 1;
+      else
+        decoder_.reset (new FrameCompression ());
+
+      if (!cloud_arg)
+        cloud_arg.reset (new PointCloud);
+      for (long i = first; i <= static_cast<long> (index_arg); ++i)
+      {
+        if (!decodeFrame (static_cast<size_t> (i), cloud_arg))
+        {
+          PCL_ERROR ("[pcl::io::OctreePointCloudSequenceReader::readFrame] Could not decode frame %ld!\n", i);
+          lastDecoded_ = -1;
+          return (false);
+        }
+        lastDecoded_ = i;
+      }
+      return (true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> bool
+    OctreePointCloudSequenceReader<PointT>::decodeFrame (size_t index_arg, PointCloudPtr &cloud_arg)
+    {
+      const OctreePointCloudSequenceFrame &frame = frames_[index_arg];
+      uint32_t recordMagic, seq, frameIDSize;
+      uint64_t size, stamp;
+      uint8_t flags;
+      file_.clear ();
+      file_.seekg (frame.offset);
+      if (!detail::readSequenceValue (file_, recordMagic) || recordMagic != detail::octreeSequenceRecordMagic ||
+          !detail::readSequenceValue (file_, flags) || !detail::readSequenceValue (file_, size) ||
+          !detail::readSequenceValue (file_, stamp) || !detail::readSequenceValue (file_, seq) ||
+          !detail::readSequenceValue (file_, frameIDSize) || size != frame.size)
+        return (false);
+
+      std::string frameID (frameIDSize, '\0');
+      buffer_.resize (static_cast<size_t> (size));
+      if (frameIDSize)
+        file_.read (&frameID[0], frameIDSize);
+      if (size)
+        file_.read (&buffer_[0], buffer_.size ());
+      if (file_.fail ())
+        return (false);
+
+      cloud_arg->points.clear ();
+      cloud_arg->width = cloud_arg->height = 0;
+      if (size)
+      {
+        std::istringstream payload (buffer_);
+        decoder_->decodePointCloud (payload, cloud_arg);
+      }
+      cloud_arg->header.stamp = stamp;
+      cloud_arg->header.seq = seq;
+      cloud_arg->header.frame_id = frameID;
+      return (true);
+    }
+  }
+}
+
+#endif
@@ -109,7 +109,7 @@ namespace pcl
       OrganizedConversion<PointT>::convert (*cloud_arg, focalLength, disparityShift, disparityScale, disparityData, rgbData);
 
       // Compress disparity information
-      encodeMonoImageToPNG (disparityData, cloud_width, cloud_height, compressedDisparity, pngLevel_arg);
+      encodeDisparity (disparityData, cloud_width, cloud_height, compressedDisparity, pngLevel_arg);
 
       compressedDisparitySize = static_cast<uint32_t>(compressedDisparity.size());
       // Encode size of compressed disparity image data
@@ -119,7 +119,7 @@ namespace pcl
 
       // Compress color information
       if (CompressionPointTraits<PointT>::hasColor && doColorEncoding)
-        encodeRGBImageToPNG (rgbData, cloud_width, cloud_height, compressedRGB, 1 /*Z_BEST_SPEED*/);
+        encodeColor (rgbData, cloud_width, cloud_height, compressedRGB);
 
       compressedRGBSize = static_cast<uint32_t>(compressedRGB.size ());
       // Encode size of compressed RGB image data
@@ -202,7 +202,7 @@ namespace pcl
        }
 
        // Compress disparity information
-       encodeMonoImageToPNG (disparityMap_arg, width_arg, height_arg, compressedDisparity, pngLevel_arg);
+       encodeDisparity (disparityMap_arg, width_arg, height_arg, compressedDisparity, pngLevel_arg);
 
        compressedDisparitySize = static_cast<uint32_t>(compressedDisparity.size());
        // Encode size of compressed disparity image data
@@ -213,8 +213,7 @@ namespace pcl
        // Compress color information
        if (colorImage_arg.size() && doColorEncoding)
        {
-         encodeRGBImageToPNG (colorImage_arg, width_arg, height_arg, compressedRGB, 1 /*Z_BEST_SPEED*/);
-
+         encodeColor (colorImage_arg, width_arg, height_arg, compressedRGB);
        }
 
        compressedRGBSize = static_cast<uint32_t>(compressedRGB.size ());
@@ -303,11 +302,30 @@ namespace pcl
         compressedRGB.resize (compressedRGBSize);
         compressedDataIn_arg.read (reinterpret_cast<char*> (&compressedRGB[0]), compressedRGBSize * sizeof(uint8_t));
 
-        // decode PNG compressed disparity data
-        decodePNGToImage (compressedDisparity, disparityData, png_width, png_height, png_channels);
+        // decode disparity data, compressed by PNG or by the predictive codec
+        if (DepthImageCodec::isEncodedImage (compressedDisparity))
+        {
+          // frames which cannot be decoded give clouds of invalid points
+          if (!disparityCodec_.decodeImage (compressedDisparity, disparityData, png_width, png_height, png_channels))
+          {
+            disparityData.assign (cloud_width * cloud_height, 0);
+            valid_stream = false;
+          }
+        }
+        else
+          decodePNGToImage (compressedDisparity, disparityData, png_width, png_height, png_channels);
 
-        // decode PNG compressed rgb data
-        decodePNGToImage (compressedRGB, rgbData, png_width, png_height, png_channels);
+        // decode rgb data, compressed by PNG or by the predictive codec
+        if (DepthImageCodec::isEncodedImage (compressedRGB))
+        {
+          if (!colorCodec_.decodeImage (compressedRGB, rgbData, png_width, png_height, png_channels))
+          {
+            rgbData.clear ();
+            valid_stream = false;
+          }
+        }
+        else
+          decodePNGToImage (compressedRGB, rgbData, png_width, png_height, png_channels);
       }
 
       // reconstruct point cloud
@@ -337,6 +355,33 @@ namespace pcl
       return valid_stream;
     }
 
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    OrganizedPointCloudCompression<PointT>::encodeDisparity (std::vector<uint16_t>& disparityMap_arg,
+                                                             uint32_t width_arg,
+                                                             uint32_t height_arg,
+                                                             std::vector<uint8_t>& compressedDisparity_arg,
+                                                             int pngLevel_arg)
+    {
+      if (imageCodec_ == PREDICTIVE_IMAGE_CODEC)
+        disparityCodec_.encodeMonoImage (disparityMap_arg, width_arg, height_arg, compressedDisparity_arg);
+      else
+        encodeMonoImageToPNG (disparityMap_arg, width_arg, height_arg, compressedDisparity_arg, pngLevel_arg);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    OrganizedPointCloudCompression<PointT>::encodeColor (std::vector<uint8_t>& colorImage_arg,
+                                                         uint32_t width_arg,
+                                                         uint32_t height_arg,
+                                                         std::vector<uint8_t>& compressedRGB_arg)
+    {
+      if (imageCodec_ == PREDICTIVE_IMAGE_CODEC)
+        colorCodec_.encodeRGBImage (colorImage_arg, width_arg, height_arg, compressedRGB_arg);
+      else
+        encodeRGBImageToPNG (colorImage_arg, width_arg, height_arg, compressedRGB_arg, 1 /*Z_BEST_SPEED*/);
+    }
+
     //////////////////////////////////////////////////////////////////////////////////////////////
     template<typename PointT> void
     OrganizedPointCloudCompression<PointT>::analyzeOrganizedCloud (PointCloudConstPtr cloud_arg,
@@ -0,0 +1,438 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef TILED_OCTREE_COMPRESSION_HPP
+#define TILED_OCTREE_COMPRESSION_HPP
+
+#include <pcl/compression/tiled_octree_pointcloud_compression.h>
+#include <pcl/common/point_tests.h>
+#include <boost/bind.hpp>
+
+#include <algorithm>
+#include <limits>
+#include <sstream>
+#include <string.h>
+
+namespace pcl
+{
+  namespace io
+  {
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+    TiledOctreePointCloudCompression<PointT>::TiledOctreePointCloudCompression (
+        compression_Profiles_e compressionProfile_arg,
+        bool showStatistics_arg,
+        const double pointResolution_arg,
+        const double octreeResolution_arg,
+        bool doVoxelGridDownDownSampling_arg,
+        const unsigned int iFrameRate_arg,
+        bool doColorEncoding_arg,
+        const unsigned char colorBitResolution_arg) :
+      encoders_ (), decoders_ (), entropyCoders_ (), threads_ (0), frameID_ (0),
+      bShowStatistics (showStatistics_arg), selectedProfile_ (compressionProfile_arg),
+      pointResolution_ (pointResolution_arg), octreeResolution_ (octreeResolution_arg),
+      doVoxelGridEnDecoding_ (doVoxelGridDownDownSampling_arg), iFrameRate_ (iFrameRate_arg),
+      doColorEncoding_ (doColorEncoding_arg), colorBitResolution_ (colorBitResolution_arg),
+      pendingFrame_ (), hasPendingFrame_ (false), stopPipeline_ (false), pipelineRunning_ (false),
+      pipelineOut_ (NULL), pipelineMutex_ (), pipelineCondition_ (), pipelineThread_ ()
+    {
+      setNumberOfTiles (8);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT>
+    TiledOctreePointCloudCompression<PointT>::~TiledOctreePointCloudCompression ()
+    {
+      stopPipeline ();
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    TiledOctreePointCloudCompression<PointT>::setNumberOfTiles (unsigned int nrTiles_arg)
+    {
+      if (pipelineRunning_)
+      {
+        PCL_ERROR ("[pcl::io::TiledOctreePointCloudCompression::setNumberOfTiles] Cannot change the number of tiles while the pipeline is running!\n");
+        return;
+      }
+      if (nrTiles_arg == 0)
+        nrTiles_arg = 1;
+
+      // new encoders start with an intra frame
+      encoders_.resize (nrTiles_arg);
+      for (size_t t = 0; t < encoders_.size (); ++t)
+        encoders_[t] = createTileCompression ();
+      entropyCoders_.resize (nrTiles_arg);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> boost::shared_ptr<typename TiledOctreePointCloudCompression<PointT>::TileCompression>
+    TiledOctreePointCloudCompression<PointT>::createTileCompression () const
+    {
+      return (boost::shared_ptr<TileCompression> (new TileCompression (selectedProfile_, false,
+                                                                        pointResolution_, octreeResolution_,
+                                                                        doVoxelGridEnDecoding_, iFrameRate_,
+                                                                        doColorEncoding_, colorBitResolution_)));
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    TiledOctreePointCloudCompression<PointT>::encodePointCloud (
+        const PointCloudConstPtr &cloud_arg,
+        std::ostream& compressedTreeDataOut_arg)
+    {
+      if (pipelineRunning_)
+      {
+        PCL_ERROR ("[pcl::io::TiledOctreePointCloudCompression::encodePointCloud] The pipeline is running, use encodePointCloudAsync instead!\n");
+        return;
+      }
+
+      TiledFrame frame;
+      serializeFrame (cloud_arg, frame);
+      writeFrame (frame, compressedTreeDataOut_arg);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    TiledOctreePointCloudCompression<PointT>::splitPointCloud (
+        const PointCloudConstPtr &cloud_arg,
+        std::vector<PointCloudPtr> &tiles_arg) const
+    {
+      const unsigned int nrTiles = static_cast<unsigned int> (encoders_.size ());
+      const size_t nrPoints = cloud_arg->points.size ();
+
+      tiles_arg.resize (nrTiles);
+      for (unsigned int t = 0; t < nrTiles; ++t)
+      {
+        tiles_arg[t].reset (new PointCloud);
+        tiles_arg[t]->header = cloud_arg->header;
+      }
+
+      // bounding box of the finite points
+      float minPt[3], maxPt[3];
+      for (int d = 0; d < 3; ++d)
+      {
+        minPt[d] = std::numeric_limits<float>::max ();
+        maxPt[d] = -std::numeric_limits<float>::max ();
+      }
+      for (size_t i = 0; i < nrPoints; ++i)
+      {
+        const PointT &point = cloud_arg->points[i];
+        if (!pcl::isFinite (point))
+          continue;
+        minPt[0] = std::min (minPt[0], point.x); maxPt[0] = std::max (maxPt[0], point.x);
+        minPt[1] = std::min (minPt[1], point.y); maxPt[1] = std::max (maxPt[1], point.y);
+        minPt[2] = std::min (minPt[2], point.z); maxPt[2] = std::max (maxPt[2], point.z);
+      }
+      if (minPt[0] > maxPt[0])
+        return;
+
+      // slabs of equal width along the largest extent
+      int axis = 0;
+      for (int d = 1; d < 3; ++d)
+        if (maxPt[d] - minPt[d] > maxPt[axis] - minPt[axis])
+          axis = d;
+      const float extent = maxPt[axis] - minPt[axis];
+      const float scale = extent > 0.0f ? static_cast<float> (nrTiles) / extent : 0.0f;
+
+      std::vector<unsigned int> tileIdx (nrPoints, nrTiles);
+      for (size_t i = 0; i < nrPoints; ++i)
+      {
+        const PointT &point = cloud_arg->points[i];
+        if (!pcl::isFinite (point))
+          continue;
+        const float coordinate = (axis == 0) ? point.x : ((axis == 1) ? point.y : point.z);
+        tileIdx[i] = std::min (nrTiles - 1, static_cast<unsigned int> ((coordinate - minPt[axis]) * scale));
+      }
+
+#pragma omp parallel for num_threads(threads_)
+      for (int t = 0; t < static_cast<int> (nrTiles); ++t)
+      {
+        PointCloud &tile = *tiles_arg[t];
+        for (size_t i = 0; i < nrPoints; ++i)
+          if (tileIdx[i] == static_cast<unsigned int> (t))
+            tile.points.push_back (cloud_arg->points[i]);
+        tile.width = static_cast<uint32_t> (tile.points.size ());
+        tile.height = 1;
+        tile.is_dense = true;
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    TiledOctreePointCloudCompression<PointT>::serializeFrame (
+        const PointCloudConstPtr &cloud_arg,
+        TiledFrame &frame_arg)
+    {
+      std::vector<PointCloudPtr> tiles;
+      splitPointCloud (cloud_arg, tiles);
+
+      const int nrTiles = static_cast<int> (tiles.size ());
+      frame_arg.tiles.resize (nrTiles);
+      frame_arg.valid.assign (nrTiles, 0);
+
+      // build and serialize the tile octrees
+#pragma omp parallel for num_threads(threads_) schedule(dynamic)
+      for (int t = 0; t < nrTiles; ++t)
+        frame_arg.valid[t] = encoders_[t]->serializePointCloud (tiles[t], frame_arg.tiles[t]);
+
+      frameID_++;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    TiledOctreePointCloudCompression<PointT>::writeFrame (
+        TiledFrame &frame_arg,
+        std::ostream& compressedTreeDataOut_arg)
+    {
+      const int nrTiles = static_cast<int> (frame_arg.tiles.size ());
+      std::vector<std::string> payloads (nrTiles);
+      std::vector<uint64_t> pointDataLen (nrTiles, 0), colorDataLen (nrTiles, 0);
+
+      // entropy code the tiles
+#pragma omp parallel for num_threads(threads_) schedule(dynamic)
+      for (int t = 0; t < nrTiles; ++t)
+      {
+        if (!frame_arg.valid[t])
+          continue;
+        std::ostringstream tileOut;
+        tileOut.write (frame_arg.tiles[t].header.data (), frame_arg.tiles[t].header.size ());
+        TileCompression::encodeFrameData (frame_arg.tiles[t], entropyCoders_[t], tileOut,
+                                          pointDataLen[t], colorDataLen[t]);
+        payloads[t] = tileOut.str ();
+      }
+
+      // encode header identifier, tile count and tile sizes
+      uint32_t tileCount = static_cast<uint32_t> (nrTiles);
+      compressedTreeDataOut_arg.write (frameHeaderIdentifier_, strlen (frameHeaderIdentifier_));
+      compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&tileCount), sizeof (tileCount));
+      for (int t = 0; t < nrTiles; ++t)
+      {
+        uint64_t payloadSize = payloads[t].size ();
+        compressedTreeDataOut_arg.write (reinterpret_cast<const char*> (&payloadSize), sizeof (payloadSize));
+      }
+      for (int t = 0; t < nrTiles; ++t)
+        compressedTreeDataOut_arg.write (payloads[t].data (), payloads[t].size ());
+      compressedTreeDataOut_arg.flush ();
+
+      if (bShowStatistics)
+      {
+        uint64_t pointCount = 0, compressedPointDataLen = 0, compressedColorDataLen = 0;
+        for (int t = 0; t < nrTiles; ++t)
+        {
+          if (!frame_arg.valid[t])
+            continue;
+          pointCount += frame_arg.tiles[t].pointCount;
+          compressedPointDataLen += pointDataLen[t];
+          compressedColorDataLen += colorDataLen[t];
+        }
+        if (pointCount == 0)
+          return;
+        float bytesPerXYZ = static_cast<float> (compressedPointDataLen) / static_cast<float> (pointCount);
+        float bytesPerColor = static_cast<float> (compressedColorDataLen) / static_cast<float> (pointCount);
+
+        PCL_INFO ("*** TILED POINTCLOUD ENCODING ***\n");
+        PCL_INFO ("Number of tiles: %d\n", nrTiles);
+        PCL_INFO ("Number of encoded points: %ld\n", pointCount);
+        PCL_INFO ("XYZ bytes per point: %f bytes\n", bytesPerXYZ);
+        PCL_INFO ("Color bytes per point: %f bytes\n", bytesPerColor);
+        PCL_INFO ("Compression ratio: %f\n\n", static_cast<float> (sizeof (int) + 3.0f * sizeof (float)) / static_cast<float> (bytesPerXYZ + bytesPerColor));
+      }
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> bool
+    TiledOctreePointCloudCompression<PointT>::syncToHeader (std::istream& compressedTreeDataIn_arg)
+    {
+      // sync to frame header
+      unsigned int headerIdPos = 0;
+      while (headerIdPos < strlen (frameHeaderIdentifier_))
+      {
+        char readChar;
+        if (!compressedTreeDataIn_arg.read (static_cast<char*> (&readChar), sizeof (readChar)))
+          return (false);
+        if (readChar != frameHeaderIdentifier_[headerIdPos++])
+          headerIdPos = (frameHeaderIdentifier_[0]==readChar)?1:0;
+      }
+      return (true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    TiledOctreePointCloudCompression<PointT>::decodePointCloud (
+        std::istream& compressedTreeDataIn_arg,
+        PointCloudPtr &cloud_arg)
+    {
+      if (!cloud_arg)
+        cloud_arg.reset (new PointCloud);
+      cloud_arg->points.clear ();
+      cloud_arg->width = 0;
+      cloud_arg->height = 1;
+      cloud_arg->is_dense = false;
+
+      // read header from input stream
+      if (!syncToHeader (compressedTreeDataIn_arg))
+        return;
+      uint32_t tileCount = 0;
+      compressedTreeDataIn_arg.read (reinterpret_cast<char*> (&tileCount), sizeof (tileCount));
+      const int nrTiles = static_cast<int> (tileCount);
+      std::vector<uint64_t> payloadSizes (nrTiles);
+      for (int t = 0; t < nrTiles; ++t)
+        compressedTreeDataIn_arg.read (reinterpret_cast<char*> (&payloadSizes[t]), sizeof (payloadSizes[t]));
+
+      // a new tile layout starts with intra frames
+      if (decoders_.size () != tileCount)
+      {
+        decoders_.resize (tileCount);
+        for (size_t t = 0; t < decoders_.size (); ++t)
+          decoders_[t] = createTileCompression ();
+      }
+
+      std::vector<std::string> payloads (nrTiles);
+      for (int t = 0; t < nrTiles; ++t)
+      {
+        payloads[t].resize (static_cast<size_t> (payloadSizes[t]));
+        if (!payloads[t].empty ())
+          compressedTreeDataIn_arg.read (&payloads[t][0], payloads[t].size ());
+      }
+      if (!compressedTreeDataIn_arg)
+      {
+        PCL_ERROR ("[pcl::io::TiledOctreePointCloudCompression::decodePointCloud] Truncated frame!\n");
+        return;
+      }
+
+      // decode the tiles
+      std::vector<PointCloudPtr> tiles (nrTiles);
+#pragma omp parallel for num_threads(threads_) schedule(dynamic)
+      for (int t = 0; t < nrTiles; ++t)
+      {
+        tiles[t].reset (new PointCloud);
+        if (payloads[t].empty ())
+          continue;
+        std::istringstream tileIn (payloads[t]);
+        decoders_[t]->decodePointCloud (tileIn, tiles[t]);
+      }
+
+      // concatenate the tiles
+      size_t nrPoints = 0;
+      for (int t = 0; t < nrTiles; ++t)
+        nrPoints += tiles[t]->points.size ();
+      cloud_arg->points.reserve (nrPoints);
+      for (int t = 0; t < nrTiles; ++t)
+        cloud_arg->points.insert (cloud_arg->points.end (), tiles[t]->points.begin (), tiles[t]->points.end ());
+      cloud_arg->width = static_cast<uint32_t> (cloud_arg->points.size ());
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    TiledOctreePointCloudCompression<PointT>::startPipeline (std::ostream& compressedTreeDataOut_arg)
+    {
+      if (pipelineRunning_)
+        return;
+      stopPipeline_ = false;
+      hasPendingFrame_ = false;
+      pipelineOut_ = &compressedTreeDataOut_arg;
+      pipelineRunning_ = true;
+      pipelineThread_.reset (new boost::thread (boost::bind (&TiledOctreePointCloudCompression<PointT>::runPipeline, this)));
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> bool
+    TiledOctreePointCloudCompression<PointT>::encodePointCloudAsync (const PointCloudConstPtr &cloud_arg)
+    {
+      if (!pipelineRunning_)
+        return (false);
+
+      // first stage, overlapping with the coding of the previous frame
+      TiledFrame frame;
+      serializeFrame (cloud_arg, frame);
+
+      boost::mutex::scoped_lock lock (pipelineMutex_);
+      while (hasPendingFrame_)
+        pipelineCondition_.wait (lock);
+      pendingFrame_.tiles.swap (frame.tiles);
+      pendingFrame_.valid.swap (frame.valid);
+      hasPendingFrame_ = true;
+      pipelineCondition_.notify_all ();
+      return (true);
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    TiledOctreePointCloudCompression<PointT>::stopPipeline ()
+    {
+      if (!pipelineRunning_)
+        return;
+      {
+        boost::mutex::scoped_lock lock (pipelineMutex_);
+        stopPipeline_ = true;
+        pipelineCondition_.notify_all ();
+      }
+      pipelineThread_->join ();
+      pipelineThread_.reset ();
+      pipelineOut_ = NULL;
+      pipelineRunning_ = false;
+    }
+
+    //////////////////////////////////////////////////////////////////////////////////////////////
+    template<typename PointT> void
+    TiledOctreePointCloudCompression<PointT>::runPipeline ()
+    {
+      for (;;)
+      {
+        TiledFrame frame;
+        {
+          boost::mutex::scoped_lock lock (pipelineMutex_);
+          while (!hasPendingFrame_ && !stopPipeline_)
+            pipelineCondition_.wait (lock);
+          // the last frame is written before stopping
+          if (!hasPendingFrame_)
+            return;
+          frame.tiles.swap (pendingFrame_.tiles);
+          frame.valid.swap (pendingFrame_.valid);
+          hasPendingFrame_ = false;
+          pipelineCondition_.notify_all ();
+        }
+
+        // second stage
+        writeFrame (frame, *pipelineOut_);
+      }
+    }
+  }
+}
+
+#endif
@@ -85,6 +85,39 @@ namespace pcl
         typedef OctreePointCloudCompression<PointT, LeafT, BranchT, Octree2BufBase<int, LeafT, BranchT> > RealTimeStreamCompression;
         typedef OctreePointCloudCompression<PointT, LeafT, BranchT, OctreeBase<int, LeafT, BranchT> > SinglePointCloudCompressionLowMemory;
 
+        /** \brief A frame serialized by \a serializePointCloud: the frame header
+          * and the data vectors, before entropy coding.
+          */
+        struct FrameData
+        {
+          FrameData () :
+            header (), withColor (false), voxelGrid (false), iFrame (false), pointCount (0),
+            binaryTreeData (), avgColorData (), pointCountData (), pointDiffData (), pointDiffColorData ()
+          {
+          }
+
+          /** \brief The encoded frame header. */
+          std::string header;
+          /** \brief Set to true if the frame contains color information. */
+          bool withColor;
+          /** \brief Set to true if only voxel centers are encoded. */
+          bool voxelGrid;
+          /** \brief Set to true for an intra frame. */
+          bool iFrame;
+          /** \brief The number of encoded points. */
+          uint64_t pointCount;
+
+          /** \brief Binary tree structure. */
+          std::vector<char> binaryTreeData;
+          /** \brief Averaged voxel colors. */
+          std::vector<char> avgColorData;
+          /** \brief Points per voxel. */
+          std::vector<unsigned int> pointCountData;
+          /** \brief Differential point information. */
+          std::vector<char> pointDiffData;
+          /** \brief Differential color information. */
+          std::vector<char> pointDiffColorData;
+        };
 
         /** \brief Constructor
           * \param compressionProfile_arg:  define compression profile
@@ -188,6 +221,31 @@ namespace pcl
         void
         encodePointCloud (const PointCloudConstPtr &cloud_arg, std::ostream& compressedTreeDataOut_arg);
 
+        /** \brief First stage of \a encodePointCloud: build the octree of a point
+          * cloud and serialize it, without entropy coding. The data vectors are moved
+          * to \a frame_arg, so that \a encodeFrameData can run on another thread
+          * while the next point cloud is serialized.
+          * \param cloud_arg:  point cloud to be compressed
+          * \param frame_arg:  the resultant serialized frame
+          * \return false if the point cloud is empty, in which case no frame is written
+          */
+        bool
+        serializePointCloud (const PointCloudConstPtr &cloud_arg, FrameData &frame_arg);
+
+        /** \brief Second stage of \a encodePointCloud: entropy code a serialized
+          * frame and write it to the output stream. Only the given range coder is
+          * used, so that frames can be coded concurrently with separate coders.
+          * \param frame_arg:  frame serialized by \a serializePointCloud
+          * \param entropyCoder_arg:  range coder instance
+          * \param compressedTreeDataOut_arg:  binary output stream
+          * \param compressedPointDataLen_arg:  the number of bytes used by the point data
+          * \param compressedColorDataLen_arg:  the number of bytes used by the color data
+          */
+        static void
+        encodeFrameData (FrameData &frame_arg, StaticRangeCoder &entropyCoder_arg,
+                         std::ostream& compressedTreeDataOut_arg,
+                         uint64_t &compressedPointDataLen_arg, uint64_t &compressedColorDataLen_arg);
+
         /** \brief Decode point cloud from input stream
           * \param compressedTreeDataIn_arg: binary input stream containing compressed data
           * \param cloud_arg: reference to decoded point cloud
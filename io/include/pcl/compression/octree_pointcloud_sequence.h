@@ -0,0 +1,269 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef OCTREE_POINTCLOUD_SEQUENCE_H
+#define OCTREE_POINTCLOUD_SEQUENCE_H
+
+#include <pcl/compression/octree_pointcloud_compression.h>
+#include <boost/shared_ptr.hpp>
+
+#include <fstream>
+#include <string>
+#include <vector>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief Description of a frame of an octree point cloud sequence file. */
+    struct OctreePointCloudSequenceFrame
+    {
+      OctreePointCloudSequenceFrame () :
+        offset (0), size (0), stamp (0), seq (0), keyFrame (false)
+      {
+      }
+
+      /** \brief Position of the frame record in the file. */
+      uint64_t offset;
+      /** \brief Size of the compressed point cloud (0 for an empty point cloud). */
+      uint64_t size;
+      /** \brief Time stamp of the point cloud header. */
+      uint64_t stamp;
+      /** \brief Sequence number of the point cloud header. */
+      uint32_t seq;
+      /** \brief Set to true for a key frame, which can be decoded on its own. */
+      bool keyFrame;
+    };
+
+    /** \brief @b Octree point cloud sequence writer
+     *  \note Records a sequence of point clouds to a single file. Every point
+     *  cloud is compressed by OctreePointCloudCompression: key frames are
+     *  intra coded, the other frames only store the XOR difference of their
+     *  octree structure to the one of the previous frame (Octree2BufBase).
+     *  \note
+     *  \note The file starts with a header, followed by one record per frame,
+     *  and ends with an index of the frames, which gives random access to the
+     *  key frames. A file which was not closed has no index, and can still be
+     *  read back up to its last complete frame.
+     *  \note
+     *  \note The point coordinates are quantized to \a pointResolution_arg,
+     *  and the colors to \a colorBitResolution_arg bits per channel.
+     *  \note typename: PointT: type of point used in pointcloud
+     */
+    template<typename PointT>
+    class OctreePointCloudSequenceWriter
+    {
+      public:
+        // public typedefs
+        typedef pcl::PointCloud<PointT> PointCloud;
+        typedef typename PointCloud::ConstPtr PointCloudConstPtr;
+
+        typedef OctreePointCloudCompression<PointT> FrameCompression;
+
+        /** \brief Constructor
+          * \param compressionProfile_arg:  define compression profile
+          * \param pointResolution_arg:  precision of point coordinates
+          * \param octreeResolution_arg:  octree resolution at lowest octree level
+          * \param doVoxelGridDownDownSampling_arg:  voxel grid filtering
+          * \param keyFrameRate_arg:  number of difference frames between two key frames
+          * \param doColorEncoding_arg:  enable/disable color coding
+          * \param colorBitResolution_arg:  color bit depth
+          */
+        OctreePointCloudSequenceWriter (compression_Profiles_e compressionProfile_arg = MANUAL_CONFIGURATION,
+                                        const double pointResolution_arg = 0.001,
+                                        const double octreeResolution_arg = 0.01,
+                                        bool doVoxelGridDownDownSampling_arg = false,
+                                        const unsigned int keyFrameRate_arg = 30,
+                                        bool doColorEncoding_arg = true,
+                                        const unsigned char colorBitResolution_arg = 6);
+
+        /** \brief Destructor. Closes the file if needed. */
+        virtual
+        ~OctreePointCloudSequenceWriter ();
+
+        /** \brief Create a sequence file, replacing any existing file.
+          * \param fileName_arg:  the name of the file
+          * \return false if the file can not be created
+          */
+        bool
+        open (const std::string &fileName_arg);
+
+        /** \brief Compress a point cloud and append it to the sequence.
+          * \param cloud_arg:  point cloud to be recorded
+          * \return false if the file is not open or can not be written
+          */
+        bool
+        writeFrame (const PointCloudConstPtr &cloud_arg);
+
+        /** \brief Write the index of the frames and close the file.
+          * \return false if the index can not be written
+          */
+        bool
+        close ();
+
+        /** \brief Return true if a file is open. */
+        inline bool
+        isOpen () const
+        {
+          return (file_.is_open ());
+        }
+
+        /** \brief Get the number of frames written to the current file. */
+        inline size_t
+        getNumberOfFrames () const
+        {
+          return (frames_.size ());
+        }
+
+        /** \brief Get the number of bytes written to the current file. */
+        inline uint64_t
+        getFileSize () const
+        {
+          return (fileSize_);
+        }
+
+      protected:
+        /** \brief The frame encoder, created for every file. */
+        boost::shared_ptr<FrameCompression> encoder_;
+
+        /** \brief Range coder of the frame data. */
+        StaticRangeCoder entropyCoder_;
+
+        /** \brief The output file. */
+        std::ofstream file_;
+
+        /** \brief The frames written to the current file. */
+        std::vector<OctreePointCloudSequenceFrame> frames_;
+
+        /** \brief The number of bytes written to the current file. */
+        uint64_t fileSize_;
+
+        const compression_Profiles_e selectedProfile_;
+        const double pointResolution_;
+        const double octreeResolution_;
+        const bool doVoxelGridEnDecoding_;
+        const unsigned int keyFrameRate_;
+        const bool doColorEncoding_;
+        const unsigned char colorBitResolution_;
+    };
+
+    /** \brief @b Octree point cloud sequence reader
+     *  \note Reads the frames of a file written by OctreePointCloudSequenceWriter,
+     *  in any order. A frame is decoded from the last key frame before it,
+     *  unless the previously read frame is on the way, so that reading the
+     *  frames in order decodes every frame once.
+     *  \note typename: PointT: type of point used in pointcloud
+     */
+    template<typename PointT>
+    class OctreePointCloudSequenceReader
+    {
+      public:
+        // public typedefs
+        typedef pcl::PointCloud<PointT> PointCloud;
+        typedef typename PointCloud::Ptr PointCloudPtr;
+
+        typedef OctreePointCloudCompression<PointT> FrameCompression;
+
+        /** \brief Empty constructor. */
+        OctreePointCloudSequenceReader ();
+
+        /** \brief Open a sequence file and read its index. The index of a file
+          * which was not closed is rebuilt by scanning the frame records.
+          * \param fileName_arg:  the name of the file
+          * \return false if the file can not be read
+          */
+        bool
+        open (const std::string &fileName_arg);
+
+        /** \brief Close the file. */
+        void
+        close ();
+
+        /** \brief Get the number of frames of the sequence. */
+        inline size_t
+        getNumberOfFrames () const
+        {
+          return (frames_.size ());
+        }
+
+        /** \brief Get the description of a frame.
+          * \param index_arg:  the index of the frame
+          */
+        inline const OctreePointCloudSequenceFrame&
+        getFrame (size_t index_arg) const
+        {
+          return (frames_[index_arg]);
+        }
+
+        /** \brief Get the index of the key frame a frame is decoded from.
+          * \param index_arg:  the index of the frame
+          */
+        size_t
+        getKeyFrame (size_t index_arg) const;
+
+        /** \brief Decode a frame of the sequence.
+          * \param index_arg:  the index of the frame
+          * \param cloud_arg:  the resultant point cloud
+          * \return false if the frame can not be read
+          */
+        bool
+        readFrame (size_t index_arg, PointCloudPtr &cloud_arg);
+
+      protected:
+        /** \brief Read and decode the frame \a index_arg, which depends on the last decoded frame. */
+        bool
+        decodeFrame (size_t index_arg, PointCloudPtr &cloud_arg);
+
+        /** \brief The frame decoder, reset at every key frame read out of order. */
+        boost::shared_ptr<FrameCompression> decoder_;
+
+        /** \brief The input file. */
+        std::ifstream file_;
+
+        /** \brief The frames of the sequence. */
+        std::vector<OctreePointCloudSequenceFrame> frames_;
+
+        /** \brief The index of the last decoded frame, or -1. */
+        long lastDecoded_;
+
+        /** \brief Buffer of the compressed frames. */
+        std::string buffer_;
+    };
+  }
+}
+
+#endif
@@ -47,6 +47,8 @@
 #include <pcl/common/common.h>
 #include <pcl/common/io.h>
 
+#include <pcl/compression/depth_image_codec.h>
+
 #include <vector>
 
 namespace pcl
@@ -63,8 +65,18 @@ namespace pcl
         typedef boost::shared_ptr<PointCloud> PointCloudPtr;
         typedef boost::shared_ptr<const PointCloud> PointCloudConstPtr;
 
+        /** \brief Codecs of the disparity and color images. */
+        enum ImageCodec
+        {
+          PNG_IMAGE_CODEC,        // libpng
+          PREDICTIVE_IMAGE_CODEC  // DepthImageCodec: faster, parallel, optionally temporal
+        };
+
         /** \brief Empty Constructor. */
         OrganizedPointCloudCompression ()
+          : imageCodec_ (PNG_IMAGE_CODEC)
+          , disparityCodec_ ()
+          , colorCodec_ ()
         {
         }
 
@@ -73,6 +85,44 @@ namespace pcl
         {
         }
 
+        /** \brief Select the codec of the disparity and color images. The decoder detects it by itself.
+         * \param[in] imageCodec_arg: the image codec (default: PNG_IMAGE_CODEC)
+         */
+        inline void
+        setImageCodec (ImageCodec imageCodec_arg)
+        {
+          imageCodec_ = imageCodec_arg;
+        }
+
+        /** \brief Get the codec of the disparity and color images. */
+        inline ImageCodec
+        getImageCodec () const
+        {
+          return (imageCodec_);
+        }
+
+        /** \brief Set the number of threads of the predictive image codec.
+         * \param[in] nrThreads_arg: the number of hardware threads to use (0 sets the value back to automatic)
+         */
+        inline void
+        setNumberOfThreads (unsigned int nrThreads_arg = 0)
+        {
+          disparityCodec_.setNumberOfThreads (nrThreads_arg);
+          colorCodec_.setNumberOfThreads (nrThreads_arg);
+        }
+
+        /** \brief Enable the temporal prediction of the predictive image codec: the
+         * frames are then predicted from the previous one, and must be decoded in order.
+         * \param[in] enable_arg: true to enable the temporal prediction
+         * \param[in] keyFramePeriod_arg: a key frame is inserted every keyFramePeriod_arg frames (0: only the first frame)
+         */
+        inline void
+        setTemporalPrediction (bool enable_arg, unsigned int keyFramePeriod_arg = 30)
+        {
+          disparityCodec_.setTemporalPrediction (enable_arg, keyFramePeriod_arg);
+          colorCodec_.setTemporalPrediction (enable_arg, keyFramePeriod_arg);
+        }
+
         /** \brief Encode point cloud to output stream
          * \param[in] cloud_arg:  point cloud to be compressed
          * \param[out] compressedDataOut_arg:  binary output stream containing compressed data
@@ -132,6 +182,25 @@ namespace pcl
                                     float& maxDepth_arg,
                                     float& focalLength_arg) const;
 
+        /** \brief Compress a disparity map with the selected image codec. */
+        void
+        encodeDisparity (std::vector<uint16_t>& disparityMap_arg, uint32_t width_arg, uint32_t height_arg,
+                         std::vector<uint8_t>& compressedDisparity_arg, int pngLevel_arg);
+
+        /** \brief Compress an RGB image with the selected image codec. */
+        void
+        encodeColor (std::vector<uint8_t>& colorImage_arg, uint32_t width_arg, uint32_t height_arg,
+                     std::vector<uint8_t>& compressedRGB_arg);
+
+        /** \brief The codec of the disparity and color images. */
+        ImageCodec imageCodec_;
+
+        /** \brief Predictive codec of the disparity images, keeping the previous frame. */
+        DepthImageCodec disparityCodec_;
+
+        /** \brief Predictive codec of the color images, keeping the previous frame. */
+        DepthImageCodec colorCodec_;
+
       private:
         // frame header identifier
         static const char* frameHeaderIdentifier_;
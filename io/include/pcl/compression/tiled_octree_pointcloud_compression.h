@@ -0,0 +1,276 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#ifndef TILED_OCTREE_COMPRESSION_H
+#define TILED_OCTREE_COMPRESSION_H
+
+#include <pcl/compression/octree_pointcloud_compression.h>
+#include <boost/shared_ptr.hpp>
+#include <boost/thread/thread.hpp>
+#include <boost/thread/mutex.hpp>
+#include <boost/thread/condition_variable.hpp>
+
+#include <iostream>
+#include <vector>
+
+namespace pcl
+{
+  namespace io
+  {
+    /** \brief @b Tiled octree pointcloud compression class
+     *  \note Splits every point cloud into spatial tiles (slabs along the
+     *  largest extent of its bounding box), and compresses every tile with its
+     *  own OctreePointCloudCompression instance. The tiles are independent
+     *  streams, so that they are encoded and decoded in parallel.
+     *  \note
+     *  \note In addition to \a encodePointCloud, a pipelined mode is provided
+     *  (\a startPipeline, \a encodePointCloudAsync, \a stopPipeline): the
+     *  octrees of a frame are built and serialized on the calling thread while
+     *  the previous frame is entropy coded and written by a background thread.
+     *  \note
+     *  \note Each tile costs a few bytes of octree structure and header, so a
+     *  few tiles per hardware thread is usually the best trade-off.
+     *  \note typename: PointT: type of point used in pointcloud
+     */
+    template<typename PointT>
+    class TiledOctreePointCloudCompression
+    {
+      public:
+        // public typedefs
+        typedef pcl::PointCloud<PointT> PointCloud;
+        typedef typename PointCloud::Ptr PointCloudPtr;
+        typedef typename PointCloud::ConstPtr PointCloudConstPtr;
+
+        typedef OctreePointCloudCompression<PointT> TileCompression;
+        typedef typename TileCompression::FrameData FrameData;
+
+        /** \brief Constructor
+          * \param compressionProfile_arg:  define compression profile
+          * \param showStatistics_arg:  output compression statistics
+          * \param pointResolution_arg:  precision of point coordinates
+          * \param octreeResolution_arg:  octree resolution at lowest octree level
+          * \param doVoxelGridDownDownSampling_arg:  voxel grid filtering
+          * \param iFrameRate_arg:  i-frame encoding rate
+          * \param doColorEncoding_arg:  enable/disable color coding
+          * \param colorBitResolution_arg:  color bit depth
+          */
+        TiledOctreePointCloudCompression (compression_Profiles_e compressionProfile_arg = MED_RES_ONLINE_COMPRESSION_WITH_COLOR,
+                                          bool showStatistics_arg = false,
+                                          const double pointResolution_arg = 0.001,
+                                          const double octreeResolution_arg = 0.01,
+                                          bool doVoxelGridDownDownSampling_arg = false,
+                                          const unsigned int iFrameRate_arg = 30,
+                                          bool doColorEncoding_arg = true,
+                                          const unsigned char colorBitResolution_arg = 6);
+
+        /** \brief Destructor. Stops the pipeline if needed. */
+        virtual
+        ~TiledOctreePointCloudCompression ();
+
+        /** \brief Set the number of tiles the point clouds are split into. The
+          * next frame is encoded as an intra frame.
+          * \param nrTiles_arg:  the number of tiles (default: 8)
+          */
+        void
+        setNumberOfTiles (unsigned int nrTiles_arg);
+
+        /** \brief Get the number of tiles the point clouds are split into. */
+        inline unsigned int
+        getNumberOfTiles () const
+        {
+          return (static_cast<unsigned int> (encoders_.size ()));
+        }
+
+        /** \brief Set the number of threads used to encode and decode the tiles.
+          * \param nrThreads_arg:  the number of hardware threads to use (0 sets the value back to automatic)
+          */
+        inline void
+        setNumberOfThreads (unsigned int nrThreads_arg = 0)
+        {
+          threads_ = nrThreads_arg;
+        }
+
+        /** \brief Encode point cloud to output stream
+          * \param cloud_arg:  point cloud to be compressed
+          * \param compressedTreeDataOut_arg:  binary output stream containing compressed data
+          */
+        void
+        encodePointCloud (const PointCloudConstPtr &cloud_arg, std::ostream& compressedTreeDataOut_arg);
+
+        /** \brief Decode point cloud from input stream
+          * \param compressedTreeDataIn_arg: binary input stream containing compressed data
+          * \param cloud_arg: reference to decoded point cloud
+          */
+        void
+        decodePointCloud (std::istream& compressedTreeDataIn_arg, PointCloudPtr &cloud_arg);
+
+        /** \brief Start the pipelined mode: the frames given to \a encodePointCloudAsync
+          * are written to \a compressedTreeDataOut_arg by a background thread.
+          * \param compressedTreeDataOut_arg:  binary output stream, which must stay valid until \a stopPipeline
+          */
+        void
+        startPipeline (std::ostream& compressedTreeDataOut_arg);
+
+        /** \brief Build and serialize the octrees of a point cloud, and hand the
+          * frame to the background thread for entropy coding. Blocks while the
+          * background thread still has a frame waiting.
+          * \param cloud_arg:  point cloud to be compressed
+          * \return false if the pipeline is not running
+          */
+        bool
+        encodePointCloudAsync (const PointCloudConstPtr &cloud_arg);
+
+        /** \brief Wait for all the frames to be written, and stop the pipelined mode. */
+        void
+        stopPipeline ();
+
+        /** \brief Return true if the pipelined mode is running. */
+        inline bool
+        isPipelineRunning () const
+        {
+          return (pipelineRunning_);
+        }
+
+      protected:
+        /** \brief A frame made of serialized tiles. Empty tiles are not serialized. */
+        struct TiledFrame
+        {
+          TiledFrame () : tiles (), valid () {}
+
+          /** \brief The serialized tiles. */
+          std::vector<FrameData> tiles;
+          /** \brief Set to 1 for the tiles which contain points. */
+          std::vector<char> valid;
+        };
+
+        /** \brief Split a point cloud into tiles along the largest extent of its bounding box.
+          * \param cloud_arg:  point cloud to be split
+          * \param tiles_arg:  the resultant tiles (non finite points are dropped)
+          */
+        void
+        splitPointCloud (const PointCloudConstPtr &cloud_arg, std::vector<PointCloudPtr> &tiles_arg) const;
+
+        /** \brief Build and serialize the octrees of all the tiles of a point cloud (first stage).
+          * \param cloud_arg:  point cloud to be compressed
+          * \param frame_arg:  the resultant serialized frame
+          */
+        void
+        serializeFrame (const PointCloudConstPtr &cloud_arg, TiledFrame &frame_arg);
+
+        /** \brief Entropy code all the tiles of a frame and write it to the output stream (second stage).
+          * \param frame_arg:  the serialized frame
+          * \param compressedTreeDataOut_arg:  binary output stream
+          */
+        void
+        writeFrame (TiledFrame &frame_arg, std::ostream& compressedTreeDataOut_arg);
+
+        /** \brief Synchronize to the tiled frame header.
+          * \param compressedTreeDataIn_arg: binary input stream
+          * \return false if the end of the stream is reached first
+          */
+        bool
+        syncToHeader (std::istream& compressedTreeDataIn_arg);
+
+        /** \brief Create a compression instance with the configuration of this class. */
+        boost::shared_ptr<TileCompression>
+        createTileCompression () const;
+
+        /** \brief Background thread of the pipelined mode. */
+        void
+        runPipeline ();
+
+        /** \brief Tile encoders, keeping the octree of the previous frame of every tile. */
+        std::vector<boost::shared_ptr<TileCompression> > encoders_;
+
+        /** \brief Tile decoders, created from the number of tiles found in the stream. */
+        std::vector<boost::shared_ptr<TileCompression> > decoders_;
+
+        /** \brief One range coder per tile, used by the second stage. */
+        std::vector<StaticRangeCoder> entropyCoders_;
+
+        /** \brief The number of threads used to encode and decode the tiles. */
+        unsigned int threads_;
+
+        /** \brief The number of frames encoded. */
+        uint32_t frameID_;
+
+        //bool activating statistics
+        bool bShowStatistics;
+
+        const compression_Profiles_e selectedProfile_;
+        const double pointResolution_;
+        const double octreeResolution_;
+        const bool doVoxelGridEnDecoding_;
+        const unsigned int iFrameRate_;
+        const bool doColorEncoding_;
+        const unsigned char colorBitResolution_;
+
+        /** \brief The frame waiting for the background thread. */
+        TiledFrame pendingFrame_;
+
+        /** \brief Set to true when \a pendingFrame_ holds a frame. */
+        bool hasPendingFrame_;
+
+        /** \brief Set to true to make the background thread exit once the pending frame is written. */
+        bool stopPipeline_;
+
+        /** \brief Set to true while the pipelined mode is running. */
+        bool pipelineRunning_;
+
+        /** \brief The output stream of the pipelined mode. */
+        std::ostream* pipelineOut_;
+
+        /** \brief Protects the pending frame. */
+        boost::mutex pipelineMutex_;
+
+        /** \brief Signaled when a frame is pushed or taken. */
+        boost::condition_variable pipelineCondition_;
+
+        /** \brief The background thread of the pipelined mode. */
+        boost::shared_ptr<boost::thread> pipelineThread_;
+
+        // frame header identifier
+        static const char* frameHeaderIdentifier_;
+    };
+
+    // define frame identifier
+    template<typename PointT>
+      const char* TiledOctreePointCloudCompression<PointT>::frameHeaderIdentifier_ = "<PCL-OCT-TILED>";
+  }
+}
+
+#endif
@@ -0,0 +1,320 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_IO_ASYNC_PCD_WRITER_H_
+#define PCL_IO_ASYNC_PCD_WRITER_H_
+
+#include <pcl/point_cloud.h>
+#include <pcl/io/boost.h>
+#include <pcl/io/pcd_io.h>
+#include <boost/function.hpp>
+#include <deque>
+
+namespace pcl
+{
+  /** \brief Asynchronous PCD writer, meant for recording sensor streams.
+    *
+    * Clouds are passed by shared pointer (no copy is made) into a bounded
+    * queue, which a pool of writer threads empties to disk. The thread calling
+    * \a push (typically a grabber callback) therefore never waits for the
+    * disk, unless the queue is full and the overflow policy is BLOCK.
+    *
+    * Files are named <prefix><index>.pcd, where index is a zero padded
+    * sequence number given to the clouds in the order they leave the queue.
+    * The names are thus contiguous and follow the order of the \a push calls,
+    * even if some clouds are dropped, and even if several threads write at once.
+    *
+    * Example:
+    * \code
+    * pcl::AsyncPCDWriter writer ("/data/frame-", 200);
+    * writer.setNumberOfThreads (2);
+    * writer.setFormat (pcl::AsyncPCDWriter::BINARY_COMPRESSED);
+    * writer.start ();
+    * // in the grabber callback
+    * writer.push (cloud);
+    * // when done
+    * writer.stop ();
+    * \endcode
+    *
+    * \ingroup io
+    */
+  class PCL_EXPORTS AsyncPCDWriter
+  {
+    public:
+      /** \brief The PCD data formats that can be written. */
+      enum Format
+      {
+        BINARY,
+        BINARY_COMPRESSED,
+        BINARY_COMPRESSED_CHUNKED
+      };
+
+      /** \brief What \a push does when the queue is full. */
+      enum OverflowPolicy
+      {
+        /** \brief Wait until a writer thread takes a cloud out of the queue. */
+        BLOCK,
+        /** \brief Drop the cloud being pushed. */
+        DROP_NEWEST,
+        /** \brief Drop the oldest cloud in the queue to make room. */
+        DROP_OLDEST
+      };
+
+      /** \brief Counters describing the activity of the writer. */
+      struct Statistics
+      {
+        Statistics () : queued (0), max_queued (0), pushed (0), written (0), 
+                        failed (0), dropped (0), blocked (0), blocked_time (0.0) {}
+
+        /** \brief The number of clouds currently waiting in the queue. */
+        size_t queued;
+        /** \brief The largest number of clouds ever waiting in the queue. */
+        size_t max_queued;
+        /** \brief The number of clouds accepted by \a push. */
+        size_t pushed;
+        /** \brief The number of files successfully written. */
+        size_t written;
+        /** \brief The number of files that could not be written. */
+        size_t failed;
+        /** \brief The number of clouds dropped because the queue was full. */
+        size_t dropped;
+        /** \brief The number of \a push calls that found the queue full and had to wait (BLOCK policy). */
+        size_t blocked;
+        /** \brief The total time spent waiting in \a push, in seconds. */
+        double blocked_time;
+      };
+
+      /** \brief Constructor.
+        * \param[in] prefix the prefix of the file names, including the directory if any
+        * \param[in] capacity the maximum number of clouds waiting in the queue
+        */
+      AsyncPCDWriter (const std::string &prefix = "frame-", size_t capacity = 100);
+
+      /** \brief Destructor. Writes the queued clouds and stops the writer threads. */
+      ~AsyncPCDWriter ();
+
+      /** \brief Set the number of writer threads. Takes effect on the next call to \a start.
+        * \param[in] nr_threads the number of writer threads (default: 1)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads)
+      {
+        nr_threads_ = nr_threads > 0 ? nr_threads : 1;
+      }
+
+      /** \brief Set the format of the files written for the clouds pushed from now on.
+        * \param[in] format the PCD data format (default: BINARY)
+        */
+      void
+      setFormat (Format format);
+
+      /** \brief Set what happens when a cloud is pushed into a full queue.
+        * \param[in] policy the overflow policy (default: BLOCK)
+        */
+      void
+      setOverflowPolicy (OverflowPolicy policy);
+
+      /** \brief Set the number of digits of the sequence number in the file names.
+        * \param[in] digits the number of digits, the index is padded with zeros (default: 6)
+        */
+      inline void
+      setIndexWidth (int digits)
+      {
+        index_width_ = digits;
+      }
+
+      /** \brief Set the index of the next file to be written.
+        * \param[in] index the sequence number of the next file name (default: 0)
+        */
+      void
+      setNextIndex (size_t index);
+
+      /** \brief Get the name of the file a given sequence number is written to.
+        * \param[in] index the sequence number
+        */
+      std::string
+      getFileName (size_t index) const;
+
+      /** \brief Start the writer threads. Clouds pushed before \a start are kept in the queue. */
+      void
+      start ();
+
+      /** \brief Stop the writer threads.
+        * \param[in] flush if true (default), write all the queued clouds first,
+        * otherwise discard them (they are counted as dropped)
+        */
+      void
+      stop (bool flush = true);
+
+      /** \brief Return true if the writer threads are running. */
+      bool
+      isRunning () const;
+
+      /** \brief Block until the queue is empty and no file is being written. */
+      void
+      flush ();
+
+      /** \brief Get a snapshot of the writer statistics. */
+      Statistics
+      getStatistics () const;
+
+      /** \brief Queue a cloud for writing.
+        * \param[in] cloud the cloud to write, which must not be modified afterwards
+        * \param[in] origin the sensor acquisition origin
+        * \param[in] orientation the sensor acquisition orientation
+        * \return true if the cloud was queued, false if it was dropped
+        */
+      bool
+      push (const sensor_msgs::PointCloud2::ConstPtr &cloud,
+            const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (), 
+            const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
+
+      /** \brief Queue a cloud for writing.
+        * \param[in] cloud the cloud to write, which must not be modified afterwards
+        * \return true if the cloud was queued, false if it was dropped
+        */
+      template <typename PointT> bool
+      push (const boost::shared_ptr<const pcl::PointCloud<PointT> > &cloud)
+      {
+        return (enqueue (boost::bind (&AsyncPCDWriter::writeCloud<PointT>, _1, _2, cloud, _3)));
+      }
+
+    private:
+      /** \brief Writes a queued cloud: (writer, file name, format). */
+      typedef boost::function<int (pcl::PCDWriter &, const std::string &, Format)> WriteFunction;
+
+      /** \brief A queued cloud, with the format it must be written in. */
+      struct Job
+      {
+        Job () : write (), format (BINARY) {}
+        Job (const WriteFunction &w, Format f) : write (w), format (f) {}
+        WriteFunction write;
+        Format format;
+      };
+
+      /** \brief The sensor pose of a queued PointCloud2. */
+      struct Pose
+      {
+        Eigen::Vector4f origin;
+        Eigen::Quaternionf orientation;
+        EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+      };
+
+      template <typename PointT> static int
+      writeCloud (pcl::PCDWriter &writer, const std::string &file_name, 
+                  const typename pcl::PointCloud<PointT>::ConstPtr &cloud, Format format)
+      {
+        switch (format)
+        {
+          case BINARY_COMPRESSED:
+            return (writer.writeBinaryCompressed<PointT> (file_name, *cloud));
+          case BINARY_COMPRESSED_CHUNKED:
+            return (writer.writeBinaryCompressedChunked<PointT> (file_name, *cloud));
+          default:
+            return (writer.writeBinary<PointT> (file_name, *cloud));
+        }
+      }
+
+      static int
+      writeBlob (pcl::PCDWriter &writer, const std::string &file_name, 
+                 const sensor_msgs::PointCloud2::ConstPtr &cloud, 
+                 const boost::shared_ptr<const Pose> &pose, Format format);
+
+      /** \brief Add a job to the queue, applying the overflow policy. */
+      bool
+      enqueue (const WriteFunction &write);
+
+      /** \brief The loop run by every writer thread. */
+      void
+      run ();
+
+      /** \brief The file name prefix. */
+      std::string prefix_;
+
+      /** \brief The maximum number of queued clouds. */
+      size_t capacity_;
+
+      /** \brief The number of writer threads. */
+      unsigned int nr_threads_;
+
+      /** \brief The number of digits of the file indices. */
+      int index_width_;
+
+      /** \brief The format used for new jobs. */
+      Format format_;
+
+      /** \brief The overflow policy. */
+      OverflowPolicy policy_;
+
+      /** \brief The pending jobs. */
+      std::deque<Job> queue_;
+
+      /** \brief The index of the next file name. */
+      size_t next_index_;
+
+      /** \brief The number of jobs being written. */
+      size_t active_;
+
+      /** \brief Set to true to make the writer threads exit once the queue is empty. */
+      bool stop_;
+
+      /** \brief The writer statistics. */
+      Statistics stats_;
+
+      /** \brief Protects all the members above. */
+      mutable boost::mutex mutex_;
+
+      /** \brief Signaled when a job is queued, or when the threads must stop. */
+      boost::condition_variable not_empty_;
+
+      /** \brief Signaled when a job leaves the queue. */
+      boost::condition_variable not_full_;
+
+      /** \brief Signaled when the queue is empty and no job is being written. */
+      boost::condition_variable idle_;
+
+      /** \brief The writer threads. */
+      boost::thread_group threads_;
+
+      /** \brief Set to true once \a start has been called (and until \a stop). */
+      bool running_;
+  };
+}
+
+#endif  //#ifndef PCL_IO_ASYNC_PCD_WRITER_H_
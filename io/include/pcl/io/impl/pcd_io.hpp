@@ -449,6 +449,84 @@ pcl::PCDWriter::writeBinaryCompressed (const std::string &file_name,
   return (0);
 }
 
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::PCDWriter::writeBinaryCompressedChunked (const std::string &file_name, 
+                                              const pcl::PointCloud<PointT> &cloud)
+{
+  if (cloud.points.empty ())
+  {
+    throw pcl::IOException ("[pcl::PCDWriter::writeBinaryCompressedChunked] Input point cloud has no data!");
+    return (-1);
+  }
+  std::ostringstream oss;
+  oss << generateHeader<PointT> (cloud) << "DATA binary_compressed_chunked\n";
+
+  std::vector<sensor_msgs::PointField> fields;
+  size_t fsize = 0;
+  size_t nri = 0;
+  pcl::getFields (cloud, fields);
+  std::vector<int> fields_sizes (fields.size ());
+  // Compute the total size of the fields
+  for (size_t i = 0; i < fields.size (); ++i)
+  {
+    if (fields[i].name == "_")
+      continue;
+    
+    fields_sizes[nri] = fields[i].count * pcl::getFieldSize (fields[i].datatype);
+    fsize += fields_sizes[nri];
+    fields[nri] = fields[i];
+    ++nri;
+  }
+  fields_sizes.resize (nri);
+  fields.resize (nri);
+
+  // Convert the XYZRGBXYZRGB structure to XXYYZZRGBRGB, exactly as for binary_compressed
+  const size_t nr_points = cloud.points.size ();
+  std::vector<char> only_valid_data (nr_points * fsize);
+  std::vector<size_t> plane_offsets (fields.size ());
+  size_t toff = 0;
+  for (size_t j = 0; j < fields.size (); ++j)
+  {
+    plane_offsets[j] = toff;
+    toff += fields_sizes[j] * nr_points;
+  }
+
+#pragma omp parallel for num_threads(threads_)
+  for (int i = 0; i < static_cast<int> (nr_points); ++i)
+  {
+    const char *point = reinterpret_cast<const char*> (&cloud.points[i]);
+    for (size_t j = 0; j < fields.size (); ++j)
+      memcpy (&only_valid_data[plane_offsets[j] + static_cast<size_t> (i) * fields_sizes[j]], point + fields[j].offset, fields_sizes[j]);
+  }
+
+  int res = writeCompressedChunkedData (file_name, oss.str (), &only_valid_data[0], only_valid_data.size ());
+  if (res != 0)
+    throw pcl::IOException ("[pcl::PCDWriter::writeBinaryCompressedChunked] Error writing compressed data!");
+  return (res);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::PCDWriter::writeColumnar (const std::string &file_name, 
+                               const pcl::PointCloud<PointT> &cloud)
+{
+  if (cloud.points.empty ())
+  {
+    throw pcl::IOException ("[pcl::PCDWriter::writeColumnar] Input point cloud has no data!");
+    return (-1);
+  }
+  std::vector<sensor_msgs::PointField> fields;
+  pcl::getFields (cloud, fields);
+
+  int res = writeColumnarData (file_name, generateHeader<PointT> (cloud), 
+                               reinterpret_cast<const unsigned char*> (&cloud.points[0]), 
+                               cloud.points.size (), sizeof (PointT), fields);
+  if (res != 0)
+    throw pcl::IOException ("[pcl::PCDWriter::writeColumnar] Error writing columnar data!");
+  return (res);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointT> int
 pcl::PCDWriter::writeASCII (const std::string &file_name, const pcl::PointCloud<PointT> &cloud, 
@@ -488,120 +566,142 @@ pcl::PCDWriter::writeASCII (const std::string &file_name, const pcl::PointCloud<
   // Write the header information
   fs << generateHeader<PointT> (cloud) << "DATA ascii\n";
 
-  std::ostringstream stream;
-  stream.precision (precision);
-  stream.imbue (std::locale::classic ());
-  // Iterate through the points
-  for (size_t i = 0; i < cloud.points.size (); ++i)
+  // Format blocks of points in parallel, and write them to disk in order
+  const int nr_points = static_cast<int> (cloud.points.size ());
+  const int block_size = 4096, nr_blocks = (nr_points + block_size - 1) / block_size;
+  std::vector<std::string> blocks (64);
+  for (int first_block = 0; first_block < nr_blocks; first_block += static_cast<int> (blocks.size ()))
   {
-    for (size_t d = 0; d < fields.size (); ++d)
+    int batch_size = std::min (static_cast<int> (blocks.size ()), nr_blocks - first_block);
+#pragma omp parallel for num_threads(threads_) schedule(dynamic)
+    for (int b = 0; b < batch_size; ++b)
     {
-      // Ignore invalid padded dimensions that are inherited from binary data
-      if (fields[d].name == "_")
-        continue;
-
-      int count = fields[d].count;
-      if (count == 0) 
-        count = 1;          // we simply cannot tolerate 0 counts (coming from older converter code)
-
-      for (int c = 0; c < count; ++c)
+      std::ostringstream stream, line;
+      stream.imbue (std::locale::classic ());
+      line.imbue (std::locale::classic ());
+      line.precision (precision);
+
+      int end_point = std::min (nr_points, (first_block + b + 1) * block_size);
+      // Iterate through the points
+      for (int i = (first_block + b) * block_size; i < end_point; ++i)
       {
-        switch (fields[d].datatype)
+        for (size_t d = 0; d < fields.size (); ++d)
         {
-          case sensor_msgs::PointField::INT8:
-          {
-            int8_t value;
-            memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (int8_t), sizeof (int8_t));
-            if (pcl_isnan (value))
-              stream << "nan";
-            else
-              stream << boost::numeric_cast<uint32_t>(value);
-            break;
-          }
-          case sensor_msgs::PointField::UINT8:
-          {
-            uint8_t value;
-            memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (uint8_t), sizeof (uint8_t));
-            if (pcl_isnan (value))
-              stream << "nan";
-            else
-              stream << boost::numeric_cast<uint32_t>(value);
-            break;
-          }
-          case sensor_msgs::PointField::INT16:
-          {
-            int16_t value;
-            memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (int16_t), sizeof (int16_t));
-            if (pcl_isnan (value))
-              stream << "nan";
-            else
-              stream << boost::numeric_cast<int16_t>(value);
-            break;
-          }
-          case sensor_msgs::PointField::UINT16:
-          {
-            uint16_t value;
-            memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (uint16_t), sizeof (uint16_t));
-            if (pcl_isnan (value))
-              stream << "nan";
-            else
-              stream << boost::numeric_cast<uint16_t>(value);
-            break;
-          }
-          case sensor_msgs::PointField::INT32:
-          {
-            int32_t value;
-            memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (int32_t), sizeof (int32_t));
-            if (pcl_isnan (value))
-              stream << "nan";
-            else
-              stream << boost::numeric_cast<int32_t>(value);
-            break;
-          }
-          case sensor_msgs::PointField::UINT32:
-          {
-            uint32_t value;
-            memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (uint32_t), sizeof (uint32_t));
-            if (pcl_isnan (value))
-              stream << "nan";
-            else
-              stream << boost::numeric_cast<uint32_t>(value);
-            break;
-          }
-          case sensor_msgs::PointField::FLOAT32:
-          {
-            float value;
-            memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (float), sizeof (float));
-            if (pcl_isnan (value))
-              stream << "nan";
-            else
-              stream << boost::numeric_cast<float>(value);
-            break;
-          }
-          case sensor_msgs::PointField::FLOAT64:
+          // Ignore invalid padded dimensions that are inherited from binary data
+          if (fields[d].name == "_")
+            continue;
+
+          int count = fields[d].count;
+          if (count == 0) 
+            count = 1;          // we simply cannot tolerate 0 counts (coming from older converter code)
+
+          for (int c = 0; c < count; ++c)
           {
-            double value;
-            memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (double), sizeof (double));
-            if (pcl_isnan (value))
-              stream << "nan";
-            else
-              stream << boost::numeric_cast<double>(value);
-            break;
+            switch (fields[d].datatype)
+            {
+              case sensor_msgs::PointField::INT8:
+              {
+                int8_t value;
+                memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (int8_t), sizeof (int8_t));
+                if (pcl_isnan (value))
+                  line << "nan";
+                else
+                  line << boost::numeric_cast<int>(value);
+                break;
+              }
+              case sensor_msgs::PointField::UINT8:
+              {
+                uint8_t value;
+                memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (uint8_t), sizeof (uint8_t));
+                if (pcl_isnan (value))
+                  line << "nan";
+                else
+                  line << boost::numeric_cast<uint32_t>(value);
+                break;
+              }
+              case sensor_msgs::PointField::INT16:
+              {
+                int16_t value;
+                memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (int16_t), sizeof (int16_t));
+                if (pcl_isnan (value))
+                  line << "nan";
+                else
+                  line << boost::numeric_cast<int16_t>(value);
+                break;
+              }
+              case sensor_msgs::PointField::UINT16:
+              {
+                uint16_t value;
+                memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (uint16_t), sizeof (uint16_t));
+                if (pcl_isnan (value))
+                  line << "nan";
+                else
+                  line << boost::numeric_cast<uint16_t>(value);
+                break;
+              }
+              case sensor_msgs::PointField::INT32:
+              {
+                int32_t value;
+                memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (int32_t), sizeof (int32_t));
+                if (pcl_isnan (value))
+                  line << "nan";
+                else
+                  line << boost::numeric_cast<int32_t>(value);
+                break;
+              }
+              case sensor_msgs::PointField::UINT32:
+              {
+                uint32_t value;
+                memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (uint32_t), sizeof (uint32_t));
+                if (pcl_isnan (value))
+                  line << "nan";
+                else
+                  line << boost::numeric_cast<uint32_t>(value);
+                break;
+              }
+              case sensor_msgs::PointField::FLOAT32:
+              {
+                if (precision == ROUND_TRIP_PRECISION)
+                  line.precision (std::numeric_limits<float>::digits10 + 3);
+                float value;
+                memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (float), sizeof (float));
+                if (pcl_isnan (value))
+                  line << "nan";
+                else
+                  line << boost::numeric_cast<float>(value);
+                break;
+              }
+              case sensor_msgs::PointField::FLOAT64:
+              {
+                if (precision == ROUND_TRIP_PRECISION)
+                  line.precision (std::numeric_limits<double>::digits10 + 2);
+                double value;
+                memcpy (&value, reinterpret_cast<const char*> (&cloud.points[i]) + fields[d].offset + c * sizeof (double), sizeof (double));
+                if (pcl_isnan (value))
+                  line << "nan";
+                else
+                  line << boost::numeric_cast<double>(value);
+                break;
+              }
+              default:
+                PCL_WARN ("[pcl::PCDWriter::writeASCII] Incorrect field data type specified (%d)!\n", fields[d].datatype);
+                break;
+            }
+
+            if (d < fields.size () - 1 || c < static_cast<int> (fields[d].count - 1))
+              line << " ";
           }
-          default:
-            PCL_WARN ("[pcl::PCDWriter::writeASCII] Incorrect field data type specified (%d)!\n", fields[d].datatype);
-            break;
         }
-
-        if (d < fields.size () - 1 || c < static_cast<int> (fields[d].count - 1))
-          stream << " ";
+        // Copy the line, trim it, and append it to the block
+        std::string result = line.str ();
+        boost::trim (result);
+        line.str ("");
+        stream << result << "\n";
       }
+      blocks[b] = stream.str ();
     }
-    // Copy the stream, trim it, and write it to disk
-    std::string result = stream.str ();
-    boost::trim (result);
-    stream.str ("");
-    fs << result << "\n";
+    for (int b = 0; b < batch_size; ++b)
+      fs << blocks[b];
   }
   fs.close ();              // Close file
   resetLockingPermissions (file_name, file_lock);
@@ -0,0 +1,122 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_IO_PCD_MAPPED_CLOUD_IMPL_H_
+#define PCL_IO_PCD_MAPPED_CLOUD_IMPL_H_
+
+#include <pcl/common/io.h>
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> int
+pcl::PCDMappedCloud<PointT>::open (const std::string &file_name)
+{
+  close ();
+  if (PCDMappedFile::open (file_name) < 0)
+    return (-1);
+
+  width_  = header_.width;
+  height_ = header_.height;
+
+  // Use the points in place if their layout (and alignment) is the one of PointT
+  if (getData () && layoutMatches () && reinterpret_cast<size_t> (getData ()) % 16 == 0)
+  {
+    points_ = reinterpret_cast<const PointT*> (getData ());
+    is_dense_ = false;
+    return (0);
+  }
+
+  // Fall back to a private copy
+  PCDMappedFile::close ();
+  pcl::PCDReader reader;
+  if (reader.read (file_name, copy_) < 0)
+    return (-1);
+  width_    = copy_.width;
+  height_   = copy_.height;
+  is_dense_ = copy_.is_dense;
+  points_   = copy_.points.empty () ? NULL : &copy_.points[0];
+  return (0);
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PCDMappedCloud<PointT>::close ()
+{
+  PCDMappedFile::close ();
+  copy_ = pcl::PointCloud<PointT> ();
+  points_ = NULL;
+  width_ = height_ = 0;
+  is_dense_ = false;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> void
+pcl::PCDMappedCloud<PointT>::toPointCloud (pcl::PointCloud<PointT> &cloud) const
+{
+  cloud.points.assign (begin (), end ());
+  cloud.width    = width_;
+  cloud.height   = height_;
+  cloud.is_dense = is_dense_;
+  cloud.sensor_origin_      = origin_;
+  cloud.sensor_orientation_ = orientation_;
+}
+
+/////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointT> bool
+pcl::PCDMappedCloud<PointT>::layoutMatches () const
+{
+  if (header_.point_step != sizeof (PointT))
+    return (false);
+
+  std::vector<sensor_msgs::PointField> fields;
+  pcl::getFields<PointT> (fields);
+  for (size_t i = 0; i < fields.size (); ++i)
+  {
+    if (fields[i].name == "_")
+      continue;
+    int d = pcl::getFieldIndex (header_, fields[i].name);
+    if (d == -1 ||
+        header_.fields[d].offset   != fields[i].offset ||
+        header_.fields[d].datatype != fields[i].datatype ||
+        header_.fields[d].count    != fields[i].count)
+      return (false);
+  }
+  return (true);
+}
+
+#endif  //#ifndef PCL_IO_PCD_MAPPED_CLOUD_IMPL_H_
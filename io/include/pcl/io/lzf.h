@@ -39,6 +39,7 @@
 #define PCL_IO_LZF_H
 
 #include <pcl/pcl_macros.h>
+#include <vector>
 
 namespace pcl
 {
@@ -86,6 +87,54 @@ namespace pcl
   PCL_EXPORTS unsigned int 
   lzfDecompress (const void *const in_data,  unsigned int in_len,
                  void             *out_data, unsigned int out_len);
+
+  /** \brief Compress \a in_len bytes stored at \a in_data as a sequence of
+    * independent LZF blocks of (at most) \a block_size bytes each. The blocks
+    * are compressed in parallel, and can be decompressed in parallel by
+    * \a lzfDecompressChunked.
+    *
+    * The output stream has the following layout (all values are 32-bit unsigned):
+    *   - number of blocks (N)
+    *   - uncompressed block size
+    *   - total uncompressed size (\a in_len)
+    *   - N compressed block sizes
+    *   - the N compressed blocks, one after the other
+    *
+    * Blocks that LZF cannot shrink are stored verbatim, and are recognized by
+    * having a compressed size equal to their uncompressed size.
+    *
+    * \param[in] in_data the input uncompressed buffer
+    * \param[in] in_len the length of the input buffer
+    * \param[out] out_data the output buffer where the compressed stream will be stored
+    * \param[in] block_size the uncompressed size of each block (default: 1MB)
+    * \param[in] nr_threads the number of threads to use (0 sets the value back to automatic)
+    * \return the number of bytes written to \a out_data, or 0 on error
+    */
+  PCL_EXPORTS unsigned int
+  lzfCompressChunked (const void *const in_data, unsigned int in_len,
+                      std::vector<char> &out_data,
+                      unsigned int block_size = 1048576,
+                      unsigned int nr_threads = 0);
+
+  /** \brief Decompress a stream created with \a lzfCompressChunked and
+    * stored at location \a in_data and length \a in_len. The result will be
+    * stored at \a out_data up to a maximum of \a out_len characters.
+    *
+    * If the block table is inconsistent or any block fails to decompress, a
+    * 0 is returned and errno is set to EINVAL or E2BIG. Otherwise the number
+    * of decompressed bytes (i.e. the original length of the data) is
+    * returned.
+    *
+    * \param[in] in_data the input compressed stream
+    * \param[in] in_len the length of the input stream
+    * \param[out] out_data the output buffer (must be resized to \a out_len)
+    * \param[in] out_len the length of the output buffer
+    * \param[in] nr_threads the number of threads to use (0 sets the value back to automatic)
+    */
+  PCL_EXPORTS unsigned int
+  lzfDecompressChunked (const void *const in_data, unsigned int in_len,
+                        void             *out_data, unsigned int out_len,
+                        unsigned int nr_threads = 0);
 }
 
 #endif  /* PCL_IO_LZF */
@@ -0,0 +1,191 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_IO_NUMBER_PARSER_H_
+#define PCL_IO_NUMBER_PARSER_H_
+
+#include <pcl/pcl_macros.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+
+namespace pcl
+{
+  namespace io
+  {
+    namespace detail
+    {
+      /** \brief Split a decimal number ([+-]digits[.digits][(e|E)[+-]digits]) into
+        * sign, mantissa and base 10 exponent, independently of the locale.
+        * \return false if the token has a different form, or more than 19 significant digits
+        */
+      inline bool
+      splitDecimal (const char *p, const char *end, bool &negative, uint64_t &mantissa, int &exponent, bool &integer)
+      {
+        negative = false;
+        if (p != end && (*p == '-' || *p == '+'))
+          negative = (*p++ == '-');
+        mantissa = 0;
+        exponent = 0;
+        integer = true;
+        int digits = 0;
+        bool any = false;
+        for (; p != end && *p >= '0' && *p <= '9'; ++p, any = true)
+        {
+          if (digits == 19)
+            return (false);
+          mantissa = mantissa * 10 + (*p - '0');
+          if (mantissa != 0)
+            ++digits;
+        }
+        if (p != end && *p == '.')
+        {
+          integer = false;
+          for (++p; p != end && *p >= '0' && *p <= '9'; ++p, any = true)
+          {
+            if (digits == 19)
+              return (false);
+            mantissa = mantissa * 10 + (*p - '0');
+            if (mantissa != 0)
+              ++digits;
+            --exponent;
+          }
+        }
+        if (!any)
+          return (false);
+        if (p != end && (*p == 'e' || *p == 'E'))
+        {
+          integer = false;
+          ++p;
+          bool exponent_negative = false;
+          if (p != end && (*p == '-' || *p == '+'))
+            exponent_negative = (*p++ == '-');
+          if (p == end)
+            return (false);
+          int e = 0;
+          for (; p != end && *p >= '0' && *p <= '9'; ++p)
+            if (e < 10000)
+              e = e * 10 + (*p - '0');
+          exponent += exponent_negative ? -e : e;
+        }
+        return (p == end);
+      }
+
+      /** \brief Exact conversion of mantissa * 10^exponent to double, for the cases
+        * where a single correctly rounded operation suffices.
+        */
+      inline bool
+      decimalToDouble (bool negative, uint64_t mantissa, int exponent, double &value)
+      {
+        static const double powers[] = { 1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+                                         1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19, 1e20, 1e21, 1e22 };
+        if (mantissa > (static_cast<uint64_t> (1) << 53))
+          return (false);
+        double d = static_cast<double> (mantissa);
+        if (mantissa == 0)
+          d = 0.0;
+        else if (exponent > 0 && exponent <= 22)
+          d *= powers[exponent];
+        else if (exponent < 0 && exponent >= -22)
+          d /= powers[-exponent];
+        else if (exponent != 0)
+          return (false);
+        value = negative ? -d : d;
+        return (true);
+      }
+    }
+
+    /** \brief Locale independent, exact parsing of the number in [begin, end).
+      *
+      * Only handles the common forms: integers within the range of T, and
+      * decimals which can be converted with a single correctly rounded
+      * operation (up to 19 significant digits and exponents within +-22).
+      * Callers fall back to a stream based parser when false is returned.
+      * \param[in] begin the first character of the token
+      * \param[in] end one past the last character of the token
+      * \param[out] value the parsed value
+      * \return true if the token was parsed, false otherwise
+      * \ingroup io
+      */
+    template <typename T> inline bool
+    parseNumber (const char *begin, const char *end, T &value)
+    {
+      bool negative, integer;
+      uint64_t mantissa;
+      int exponent;
+      if (!detail::splitDecimal (begin, end, negative, mantissa, exponent, integer) || !integer)
+        return (false);
+      if (negative ? (mantissa > static_cast<uint64_t> (-static_cast<int64_t> (std::numeric_limits<T>::min ()))) :
+                     (mantissa > static_cast<uint64_t> (std::numeric_limits<T>::max ())))
+        return (false);
+      value = negative ? static_cast<T> (-static_cast<int64_t> (mantissa)) : static_cast<T> (mantissa);
+      return (true);
+    }
+
+    template <> inline bool
+    parseNumber<double> (const char *begin, const char *end, double &value)
+    {
+      bool negative, integer;
+      uint64_t mantissa;
+      int exponent;
+      return (detail::splitDecimal (begin, end, negative, mantissa, exponent, integer) &&
+              detail::decimalToDouble (negative, mantissa, exponent, value));
+    }
+
+    template <> inline bool
+    parseNumber<float> (const char *begin, const char *end, float &value)
+    {
+      double d;
+      if (!parseNumber<double> (begin, end, d))
+        return (false);
+      // Rounding the exact double to float is exact too, unless the double lies
+      // exactly half way between two floats, or outside of the normal range
+      if (d != 0.0 && (std::fabs (d) < std::numeric_limits<float>::min () || std::fabs (d) > std::numeric_limits<float>::max ()))
+        return (false);
+      uint64_t bits;
+      memcpy (&bits, &d, sizeof (double));
+      if ((bits & 0x1FFFFFFF) == 0x10000000)
+        return (false);
+      value = static_cast<float> (d);
+      return (true);
+    }
+  }
+}
+
+#endif  //#ifndef PCL_IO_NUMBER_PARSER_H_
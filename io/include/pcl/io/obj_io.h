@@ -39,10 +39,94 @@
 #define OBJ_IO_H_
 #include <pcl/pcl_macros.h>
 #include <pcl/TextureMesh.h>
+#include <pcl/PolygonMesh.h>
 namespace pcl
 {
+  /** \brief Wavefront OBJ file reader.
+    *
+    * The file is loaded at once and split into line aligned chunks, which are
+    * processed in two passes: a first one counting the vertices, normals,
+    * texture coordinates and faces of every chunk, and a second one parsing
+    * every chunk directly into its slice of the (presized) output arrays.
+    * Both passes run in parallel with OpenMP.
+    *
+    * Supported statements are \a v, \a vn, \a vt, \a f (including negative,
+    * i.e. relative, indices), \a usemtl and \a mtllib; all others are ignored.
+    * The cloud holds PointXYZ data, or PointNormal data if the file has one
+    * normal per vertex.
+    * \ingroup io
+    */
+  class PCL_EXPORTS OBJReader
+  {
+    public:
+      /** \brief Empty constructor. */
+      OBJReader () : threads_ (0) {}
+
+      /** \brief Set the number of threads to use when parsing the file.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
+      /** \brief Read a polygonal mesh from an OBJ file. Materials and texture
+        * coordinates are ignored.
+        * \param[in] file_name the name of the file to read
+        * \param[out] mesh the resultant polygonal mesh
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      read (const std::string &file_name, pcl::PolygonMesh &mesh);
+
+      /** \brief Read a textured mesh from an OBJ file. Every \a usemtl
+        * statement starts a new sub mesh, whose material is looked up in the
+        * \a mtllib files (relative to the directory of the OBJ file). The
+        * texture coordinates of every sub mesh are stored once per face vertex,
+        * in the order of the faces, as written by \a pcl::io::saveOBJFile.
+        * \param[in] file_name the name of the file to read
+        * \param[out] mesh the resultant textured mesh
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      read (const std::string &file_name, pcl::TextureMesh &mesh);
+
+    private:
+      /** \brief The number of threads to use, 0 for automatic. */
+      unsigned int threads_;
+  };
+
   namespace io
   {
+    /** \brief Load a polygonal mesh from an OBJ file.
+      * \param[in] file_name the name of the file to read
+      * \param[out] mesh the resultant polygonal mesh
+      * \ingroup io
+      */
+    inline int
+    loadOBJFile (const std::string &file_name, pcl::PolygonMesh &mesh)
+    {
+      pcl::OBJReader reader;
+      return (reader.read (file_name, mesh));
+    }
+
+    /** \brief Load a textured mesh from an OBJ file.
+      * \param[in] file_name the name of the file to read
+      * \param[out] mesh the resultant textured mesh
+      * \ingroup io
+      */
+    inline int
+    loadOBJFile (const std::string &file_name, pcl::TextureMesh &mesh)
+    {
+      pcl::OBJReader reader;
+      return (reader.read (file_name, mesh));
+    }
+
     /** \brief Saves a TextureMesh in ascii OBJ format.
       * \param[in] file_name the name of the file to write to disk
       * \param[in] tex_mesh the texture mesh to save
@@ -45,6 +45,7 @@
 #include <string>
 #include <vector>
 #include <pcl/ros/conversions.h>
+#include <pcl/ros/conversion_plan.h>
 
 #ifdef HAVE_OPENNI
 #include <pcl/io/openni_camera/openni_depth_image.h>
@@ -127,6 +128,40 @@ namespace pcl
       bool 
       isRepeatOn () const;
 
+      /** \brief Returns the number of frames that can be played, i.e. the
+        * number of PCD files, counting every PCD file stored in a TAR archive.
+        *
+        * TAR archives are indexed once, when the grabber is created. The index
+        * is cached next to the archive (in <archive>.idx) and reused as long as
+        * the archive is not modified, so large recordings are not scanned again.
+        */
+      size_t 
+      getNumberOfFrames () const;
+
+      /** \brief Returns the index of the next frame to be published. */
+      size_t 
+      getCurrentFrame () const;
+
+      /** \brief Sets the next frame to be published. Random access is O(1),
+        * TAR archives included.
+        * \param[in] frame the index of the frame, in [0, getNumberOfFrames ())
+        * \return false if the frame index is out of range
+        */
+      bool 
+      seek (size_t frame);
+
+      /** \brief Sets the number of frames decoded ahead of time by a background
+        * thread, so that publishing a frame does not have to wait for the disk.
+        * \param[in] nr_frames the size of the look-ahead window, 0 (default)
+        * disables prefetching and reads every frame when it is published
+        */
+      void 
+      setPrefetchWindow (size_t nr_frames);
+
+      /** \brief Returns the number of frames decoded ahead of time. */
+      size_t 
+      getPrefetchWindow () const;
+
     private:
       virtual void 
       publish (const sensor_msgs::PointCloud2& blob, const Eigen::Vector4f& origin, const Eigen::Quaternionf& orientation) const = 0;
@@ -149,6 +184,9 @@ namespace pcl
       
       boost::signals2::signal<void (const boost::shared_ptr<const pcl::PointCloud<PointT> >&)>* signal_;
 
+      /** \brief Conversion plan reused for all the frames, which usually share the same layout. */
+      mutable pcl::ConversionPlan<PointT> conversion_plan_;
+
 #ifdef HAVE_OPENNI
       boost::signals2::signal<void (const boost::shared_ptr<openni_wrapper::DepthImage>&)>*     depth_image_signal_;
 #endif
@@ -181,7 +219,7 @@ namespace pcl
   PCDGrabber<PointT>::publish (const sensor_msgs::PointCloud2& blob, const Eigen::Vector4f& origin, const Eigen::Quaternionf& orientation) const
   {
     typename pcl::PointCloud<PointT>::Ptr cloud (new pcl::PointCloud<PointT> ());
-    pcl::fromROSMsg (blob, *cloud);
+    conversion_plan_.fromROSMsg (blob, *cloud);
     cloud->sensor_origin_ = origin;
     cloud->sensor_orientation_ = orientation;
 
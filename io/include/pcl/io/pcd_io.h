@@ -53,9 +53,51 @@ namespace pcl
   {
     public:
       /** Empty constructor */      
-      PCDReader () : FileReader () {}
+      PCDReader () : FileReader (), threads_ (0) {}
       /** Empty destructor */      
       ~PCDReader () {}
+
+      /** \brief Set the number of threads used to decompress and unpack
+        * binary_compressed data, and to parse ascii data.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
+      /** \brief Only read the given fields (e.g., "x", "y" and "z") from now on.
+        *
+        * The resultant clouds only contain the requested fields which are
+        * present in the file. For columnar files (see \a PCDWriter::writeColumnar)
+        * the other columns are never read from disk; for all other data types
+        * the file is read as a whole and the requested fields are extracted.
+        * \param[in] fields the names of the fields to read, or an empty list (default) to read all of them
+        */
+      inline void
+      setFieldSubset (const std::vector<std::string> &fields)
+      {
+        field_subset_ = fields;
+      }
+
+      /** \brief Get the names of the fields to read (empty if all of them are read). */
+      inline const std::vector<std::string>&
+      getFieldSubset () const
+      {
+        return (field_subset_);
+      }
+
+      /** \brief Get the offsets of the field columns, relative to the start of
+        * the data, found by the last call to \a readHeader on a columnar file.
+        * There is one offset per field, padding fields excluded.
+        */
+      inline const std::vector<size_t>&
+      getColumnOffsets () const
+      {
+        return (column_offsets_);
+      }
+
       /** \brief Various PCD file versions.
         *
         * PCD_V6 represents PCD files with version 0.6, which contain the following fields:
@@ -97,7 +139,7 @@ namespace pcl
         * \param[out] origin the sensor acquisition origin (only for > PCD_V7 - null if not present)
         * \param[out] orientation the sensor acquisition orientation (only for > PCD_V7 - identity if not present)
         * \param[out] pcd_version the PCD version of the file (i.e., PCD_V6, PCD_V7)
-        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed) 
+        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed, 3 = Binary compressed chunked, 4 = Columnar)
         * \param[out] data_idx the offset of cloud data within the file
         * \param[in] offset the offset of where to expect the PCD Header in the
         * file (optional parameter). One usage example for setting the offset
@@ -153,7 +195,7 @@ namespace pcl
         * \param[in] file_name the name of the file to load
         * \param[out] cloud the resultant point cloud dataset (only the properties will be filled)
         * \param[out] pcd_version the PCD version of the file (either PCD_V6 or PCD_V7)
-        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed) 
+        * \param[out] data_type the type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed, 3 = Binary compressed chunked, 4 = Columnar)
         * \param[out] data_idx the offset of cloud data within the file
         * \param[in] offset the offset of where to expect the PCD Header in the
         * file (optional parameter). One usage example for setting the offset
@@ -234,8 +276,21 @@ namespace pcl
       {
         sensor_msgs::PointCloud2 blob;
         int pcd_version;
-        int res = read (file_name, blob, cloud.sensor_origin_, cloud.sensor_orientation_, 
-                        pcd_version, offset);
+        int res;
+        if (field_subset_.empty ())
+        {
+          // Columnar files only need to provide the fields of PointT
+          std::vector<sensor_msgs::PointField> point_fields;
+          pcl::getFields<PointT> (point_fields);
+          std::vector<std::string> fields (point_fields.size ());
+          for (size_t i = 0; i < point_fields.size (); ++i)
+            fields[i] = point_fields[i].name;
+          res = readFields (file_name, blob, cloud.sensor_origin_, cloud.sensor_orientation_, 
+                            pcd_version, offset, fields, false);
+        }
+        else
+          res = read (file_name, blob, cloud.sensor_origin_, cloud.sensor_orientation_, 
+                      pcd_version, offset);
 
         // If no error, convert the data
         if (res == 0)
@@ -266,6 +321,31 @@ namespace pcl
     
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
 
+    private:
+      /** \brief Read a point cloud, restricted to the given fields.
+        * \param[in] file_name the name of the file containing the actual PointCloud data
+        * \param[out] cloud the resultant PointCloud message read from disk
+        * \param[out] origin the sensor acquisition origin
+        * \param[out] orientation the sensor acquisition orientation
+        * \param[out] pcd_version the PCD version of the file
+        * \param[in] offset the offset of where to expect the PCD Header in the file
+        * \param[in] fields the names of the fields to read, all of them if empty
+        * \param[in] extract whether to drop the other fields for data types
+        * which store whole points (the columnar data type always drops them)
+        */
+      int
+      readFields (const std::string &file_name, sensor_msgs::PointCloud2 &cloud, 
+                  Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, int &pcd_version, 
+                  const int offset, const std::vector<std::string> &fields, bool extract);
+
+      /** \brief The number of threads used for decompression. */
+      unsigned int threads_;
+
+      /** \brief The names of the fields to read, all of them if empty. */
+      std::vector<std::string> field_subset_;
+
+      /** \brief The column offsets of the last columnar file header read. */
+      std::vector<size_t> column_offsets_;
   };
 
   /** \brief Point Cloud Data (PCD) file format writer.
@@ -275,9 +355,16 @@ namespace pcl
   class PCL_EXPORTS PCDWriter : public FileWriter
   {
     public:
-      PCDWriter() : FileWriter(), map_synchronization_(false) {}
+      PCDWriter() : FileWriter(), map_synchronization_(false), threads_ (0), compression_block_size_ (1048576) {}
       ~PCDWriter() {}
 
+      enum
+      {
+        /** \brief Precision for \a writeASCII writing floats with 9 and doubles with 17 significant
+          * digits, the minimum for which reading the file back gives exactly the same values. */
+        ROUND_TRIP_PRECISION = 0
+      };
+
       /** \brief Set whether mmap() synchornization via msync() is desired before munmap() calls. 
         * Setting this to true could prevent NFS data loss (see
         * http://www.pcl-developers.org/PCD-IO-consistency-on-NFS-msync-needed-td4885942.html).
@@ -292,6 +379,28 @@ namespace pcl
         map_synchronization_ = sync;
       }
 
+      /** \brief Set the number of threads used to compress binary_compressed_chunked data
+        * and to format ascii data.
+        * \param[in] nr_threads the number of hardware threads to use (0 sets the value back to automatic)
+        */
+      inline void
+      setNumberOfThreads (unsigned int nr_threads = 0)
+      {
+        threads_ = nr_threads;
+      }
+
+      /** \brief Set the uncompressed size of the independent LZF blocks written
+        * by \a writeBinaryCompressedChunked. Smaller blocks expose more
+        * parallelism at the cost of a slightly worse compression ratio.
+        * Default: 1MB
+        * \param[in] block_size the size of a block in bytes
+        */
+      inline void
+      setCompressionBlockSize (unsigned int block_size)
+      {
+        compression_block_size_ = block_size;
+      }
+
       /** \brief Generate the header of a PCD file format
         * \param[in] cloud the point cloud data message
         * \param[in] origin the sensor acquisition origin
@@ -349,7 +458,8 @@ namespace pcl
         * \param[in] cloud the point cloud data message
         * \param[in] origin the sensor acquisition origin
         * \param[in] orientation the sensor acquisition orientation
-        * \param[in] precision the specified output numeric stream precision (default: 8)
+        * \param[in] precision the specified output numeric stream precision (default: 8), or
+        * ROUND_TRIP_PRECISION
         *
         * Caution: PointCloud structures containing an RGB field have
         * traditionally used packed float values to store RGB data. Storing a
@@ -388,6 +498,42 @@ namespace pcl
                              const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (), 
                              const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
 
+      /** \brief Save point cloud data to a PCD file containing n-D points, in BINARY_COMPRESSED_CHUNKED format.
+        *
+        * The data is laid out exactly as for BINARY_COMPRESSED (one plane per
+        * field), but is compressed as a sequence of independent LZF blocks (see
+        * \a setCompressionBlockSize) listed in a block table, which allows both
+        * compression and decompression to run on all available cores.
+        *
+        * \param[in] file_name the output file name
+        * \param[in] cloud the point cloud data message
+        * \param[in] origin the sensor acquisition origin
+        * \param[in] orientation the sensor acquisition orientation
+        */
+      int 
+      writeBinaryCompressedChunked (const std::string &file_name, const sensor_msgs::PointCloud2 &cloud,
+                                    const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (), 
+                                    const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
+
+      /** \brief Save point cloud data to a PCD file containing n-D points, in COLUMNAR format.
+        *
+        * Every field is stored as a contiguous, uncompressed column (XXX..YYY..ZZZ..),
+        * starting on a 16 byte boundary. The column offsets are listed on the
+        * DATA line, so that readers can load a subset of the fields (see
+        * \a PCDReader::setFieldSubset) without touching the other columns.
+        * \note Readers which predate this format do not know the columnar keyword
+        * and parse these files as ASCII. \a PCDReader::readEigen refuses them.
+        *
+        * \param[in] file_name the output file name
+        * \param[in] cloud the point cloud data message
+        * \param[in] origin the sensor acquisition origin
+        * \param[in] orientation the sensor acquisition orientation
+        */
+      int 
+      writeColumnar (const std::string &file_name, const sensor_msgs::PointCloud2 &cloud,
+                     const Eigen::Vector4f &origin = Eigen::Vector4f::Zero (), 
+                     const Eigen::Quaternionf &orientation = Eigen::Quaternionf::Identity ());
+
       /** \brief Save point cloud data to a PCD file containing n-D points
         * \param[in] file_name the output file name
         * \param[in] cloud the point cloud data message
@@ -469,6 +615,23 @@ namespace pcl
       writeBinaryCompressed (const std::string &file_name, 
                              const pcl::PointCloud<PointT> &cloud);
 
+      /** \brief Save point cloud data to a binary compressed PCD file, using
+        * independent LZF blocks that are compressed in parallel.
+        * \param[in] file_name the output file name
+        * \param[in] cloud the point cloud data message
+        */
+      template <typename PointT> int 
+      writeBinaryCompressedChunked (const std::string &file_name, 
+                                    const pcl::PointCloud<PointT> &cloud);
+
+      /** \brief Save point cloud data to a PCD file containing n-D points, in COLUMNAR format
+        * \param[in] file_name the output file name
+        * \param[in] cloud the point cloud data message
+        */
+      template <typename PointT> int 
+      writeColumnar (const std::string &file_name, 
+                     const pcl::PointCloud<PointT> &cloud);
+
       /** \brief Save point cloud data to a binary comprssed PCD file.
         * \note This version is specialized for PointCloud<Eigen::MatrixXf> data types. 
         * \attention The PCD data is \b always stored in ROW major format! The
@@ -494,7 +657,8 @@ namespace pcl
       /** \brief Save point cloud data to a PCD file containing n-D points, in ASCII format
         * \param[in] file_name the output file name
         * \param[in] cloud the point cloud data message
-        * \param[in] precision the specified output numeric stream precision (default: 8)
+        * \param[in] precision the specified output numeric stream precision (default: 8), or
+        * ROUND_TRIP_PRECISION
         */
       template <typename PointT> int 
       writeASCII (const std::string &file_name, 
@@ -594,10 +758,42 @@ namespace pcl
       resetLockingPermissions (const std::string &file_name,
                                boost::interprocess::file_lock &lock);
 
+      /** \brief Compress already transposed (one plane per field) point data
+        * into independent LZF blocks and write it to disk, as the body of a
+        * binary_compressed_chunked PCD file.
+        * \param[in] file_name the output file name
+        * \param[in] header the PCD header, including the DATA line
+        * \param[in] data the transposed point data
+        * \param[in] data_size the size of \a data in bytes
+        */
+      int
+      writeCompressedChunkedData (const std::string &file_name, const std::string &header,
+                                  const char *data, size_t data_size);
+
+      /** \brief Write points to disk, one column per field, as the body of a
+        * columnar PCD file.
+        * \param[in] file_name the output file name
+        * \param[in] header the PCD header, without the DATA line
+        * \param[in] points the point data, \a point_step bytes per point
+        * \param[in] nr_points the number of points
+        * \param[in] point_step the size of a point in bytes
+        * \param[in] fields the fields to write (padding fields are skipped)
+        */
+      int
+      writeColumnarData (const std::string &file_name, const std::string &header,
+                         const unsigned char *points, size_t nr_points, size_t point_step,
+                         const std::vector<sensor_msgs::PointField> &fields);
+
     private:
       /** \brief Set to true if msync() should be called before munmap(). Prevents data loss on NFS systems. */
       bool map_synchronization_;
 
+      /** \brief The number of threads used for compression. */
+      unsigned int threads_;
+
+      /** \brief The uncompressed size of a binary_compressed_chunked block. */
+      unsigned int compression_block_size_;
+
       typedef std::pair<std::string, pcl::ChannelProperties> pair_channel_properties;
       /** \brief Internal structure used to sort the ChannelProperties in the
         * cloud.channels map based on their offset. 
@@ -0,0 +1,272 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_IO_PCD_MAPPED_CLOUD_H_
+#define PCL_IO_PCD_MAPPED_CLOUD_H_
+
+#include <pcl/point_cloud.h>
+#include <pcl/io/pcd_io.h>
+#include <boost/noncopyable.hpp>
+
+namespace pcl
+{
+  /** \brief Read-only memory mapping of the point data of a binary PCD file.
+    * This is the type independent part of \a PCDMappedCloud.
+    * \ingroup io
+    */
+  class PCL_EXPORTS PCDMappedFile : boost::noncopyable
+  {
+    public:
+      /** \brief Empty constructor. */
+      PCDMappedFile ();
+
+      /** \brief Destructor. Unmaps the file if needed. */
+      virtual ~PCDMappedFile ();
+
+      /** \brief Parse the header of a PCD file, and map its point data if
+        * the data is stored uncompressed (DATA binary).
+        * \param[in] file_name the name of the file to map
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success (the file might still not be mapped, see \a getData)
+        */
+      int
+      open (const std::string &file_name);
+
+      /** \brief Unmap the file. */
+      void
+      close ();
+
+      /** \brief Get the header of the file (\a data is always empty). */
+      inline const sensor_msgs::PointCloud2&
+      getHeader () const
+      {
+        return (header_);
+      }
+
+      /** \brief Get the type of data in the file (see \a PCDReader::readHeader). */
+      inline int
+      getDataType () const
+      {
+        return (data_type_);
+      }
+
+      /** \brief Get a pointer to the mapped point data, or NULL if the file is
+        * not mapped (e.g., ascii or compressed data).
+        */
+      inline const char*
+      getData () const
+      {
+        return (map_ ? map_ + data_idx_ : NULL);
+      }
+
+    protected:
+      /** \brief The name of the mapped file. */
+      std::string file_name_;
+
+      /** \brief The file header (no data). */
+      sensor_msgs::PointCloud2 header_;
+
+      /** \brief The sensor acquisition origin. */
+      Eigen::Vector4f origin_;
+
+      /** \brief The sensor acquisition orientation. */
+      Eigen::Quaternionf orientation_;
+
+      /** \brief The type of data (see \a PCDReader::readHeader). */
+      int data_type_;
+
+      /** \brief The offset of the point data in the file. */
+      size_t data_idx_;
+
+      /** \brief The start of the mapped region, or NULL. */
+      char *map_;
+
+      /** \brief The size of the mapped region. */
+      size_t map_size_;
+
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+
+  /** \brief Read-only, zero-copy view of the points stored in a PCD file.
+    *
+    * When the file holds binary data whose layout matches the memory layout
+    * of \a PointT exactly (same point_step and the same offset, type and count
+    * for every field of \a PointT), the points are accessed in place in the
+    * memory mapped file: opening the file costs no copy and no allocation, and
+    * the pages are shared with every other process mapping the same file.
+    * Otherwise (ascii or compressed data, different layouts, misaligned data)
+    * the file is read through \a PCDReader into a private copy.
+    *
+    * Files written with \a PCDWriter::writeBinary from a sensor_msgs::PointCloud2
+    * obtained via \a toROSMsg (PointCloud<PointT>) keep the padding of \a PointT and
+    * start their data on a 16 byte boundary, and are therefore mapped directly.
+    *
+    * \code
+    * pcl::PCDMappedCloud<pcl::PointXYZ> tile;
+    * tile.open ("tile.pcd");
+    * for (size_t i = 0; i < tile.size (); ++i)
+    *   sum += tile[i].getVector3fMap ();
+    * \endcode
+    * \ingroup io
+    */
+  template <typename PointT>
+  class PCDMappedCloud : public PCDMappedFile
+  {
+    public:
+      typedef const PointT* const_iterator;
+
+      /** \brief Empty constructor. */
+      PCDMappedCloud () : points_ (NULL), width_ (0), height_ (0), is_dense_ (false), copy_ () {}
+
+      /** \brief Open a PCD file, mapping its points if possible and reading them otherwise.
+        * \param[in] file_name the name of the file to open
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      open (const std::string &file_name);
+
+      /** \brief Release the mapping or the copy of the points. */
+      void
+      close ();
+
+      /** \brief Return true if the points are accessed in place, false if they were copied. */
+      inline bool
+      isMapped () const
+      {
+        return (points_ != NULL && copy_.points.empty ());
+      }
+
+      /** \brief Get a pointer to the first point. */
+      inline const PointT*
+      data () const
+      {
+        return (points_);
+      }
+
+      inline const_iterator begin () const { return (points_); }
+      inline const_iterator end ()   const { return (points_ + size ()); }
+
+      /** \brief The number of points. */
+      inline size_t
+      size () const
+      {
+        return (static_cast<size_t> (width_) * height_);
+      }
+
+      inline bool
+      empty () const
+      {
+        return (size () == 0);
+      }
+
+      inline uint32_t width ()  const { return (width_); }
+      inline uint32_t height () const { return (height_); }
+
+      /** \brief Return whether the dataset is organized (e.g., arranged in a structured grid). */
+      inline bool
+      isOrganized () const
+      {
+        return (height_ != 1);
+      }
+
+      /** \brief True if no points are invalid (e.g., have NaN or Inf values).
+        * Mapped clouds are always reported as not dense, as checking would
+        * touch every page of the file.
+        */
+      inline bool
+      isDense () const
+      {
+        return (is_dense_);
+      }
+
+      inline const PointT&
+      operator[] (size_t n) const
+      {
+        return (points_[n]);
+      }
+
+      /** \brief Organized point access (column \a u, row \a v). */
+      inline const PointT&
+      at (int u, int v) const
+      {
+        return (points_[v * width_ + u]);
+      }
+
+      inline const Eigen::Vector4f&
+      getSensorOrigin () const
+      {
+        return (origin_);
+      }
+
+      inline const Eigen::Quaternionf&
+      getSensorOrientation () const
+      {
+        return (orientation_);
+      }
+
+      /** \brief Copy the points into a regular point cloud, e.g. to hand them
+        * over to algorithms expecting a pcl::PointCloud.
+        * \param[out] cloud the resultant point cloud
+        */
+      void
+      toPointCloud (pcl::PointCloud<PointT> &cloud) const;
+
+    private:
+      /** \brief Check that the fields of the file match the memory layout of PointT. */
+      bool
+      layoutMatches () const;
+
+      /** \brief The points, either in the mapped file or in \a copy_. */
+      const PointT *points_;
+
+      uint32_t width_, height_;
+      bool is_dense_;
+
+      /** \brief The fallback copy, used when the file cannot be mapped as PointT. */
+      pcl::PointCloud<PointT> copy_;
+  };
+}
+
+#include <pcl/io/impl/pcd_mapped_cloud.hpp>
+
+#endif  //#ifndef PCL_IO_PCD_MAPPED_CLOUD_H_
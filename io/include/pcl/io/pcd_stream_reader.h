@@ -0,0 +1,276 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_IO_PCD_STREAM_READER_H_
+#define PCL_IO_PCD_STREAM_READER_H_
+
+#include <pcl/point_cloud.h>
+#include <pcl/io/pcd_io.h>
+#include <boost/function.hpp>
+#include <fstream>
+#include <map>
+
+namespace pcl
+{
+  /** \brief Incremental Point Cloud Data (PCD) file reader.
+    *
+    * Instead of materializing the whole dataset like \a PCDReader::read,
+    * PCDStreamReader hands out consecutive batches of at most N points,
+    * either one at a time (\a readBlock) or through a callback (\a readBlocks).
+    * The memory used is proportional to the batch size, independently of the
+    * size of the file, for ascii, binary, binary_compressed_chunked and columnar data.
+    *
+    * \note binary_compressed files store the whole cloud as a single LZF
+    * stream, which has to be decompressed at once the first time a batch is
+    * requested. Use \a PCDWriter::writeBinaryCompressedChunked to get bounded
+    * memory on compressed data as well.
+    *
+    * Example:
+    * \code
+    * pcl::PCDStreamReader reader;
+    * reader.open ("huge.pcd");
+    * pcl::PointCloud<pcl::PointXYZ> block;
+    * while (reader.readBlock (block, 100000) > 0)
+    *   process (block);
+    * \endcode
+    *
+    * \ingroup io
+    */
+  class PCL_EXPORTS PCDStreamReader
+  {
+    public:
+      /** \brief Empty constructor. */
+      PCDStreamReader ();
+
+      /** \brief Destructor. Closes the file if needed. */
+      ~PCDStreamReader ();
+
+      /** \brief Open a PCD file and parse its header. No point data is read.
+        * \param[in] file_name the name of the file to read
+        * \param[in] offset the offset of where to expect the PCD Header in the
+        * file (optional parameter, see \a PCDReader::readHeader)
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      int
+      open (const std::string &file_name, const int offset = 0);
+
+      /** \brief Close the file and release all buffers. */
+      void
+      close ();
+
+      /** \brief Return true if a file is currently open. */
+      inline bool
+      isOpen () const
+      {
+        return (is_open_);
+      }
+
+      /** \brief Get the header of the file being read (fields, width,
+        * height and point_step). The \a data member is always empty.
+        */
+      inline const sensor_msgs::PointCloud2&
+      getHeader () const
+      {
+        return (header_);
+      }
+
+      /** \brief Get the sensor acquisition origin stored in the file. */
+      inline const Eigen::Vector4f&
+      getOrigin () const
+      {
+        return (origin_);
+      }
+
+      /** \brief Get the sensor acquisition orientation stored in the file. */
+      inline const Eigen::Quaternionf&
+      getOrientation () const
+      {
+        return (orientation_);
+      }
+
+      /** \brief Get the type of data in the file (see \a PCDReader::readHeader). */
+      inline int
+      getDataType () const
+      {
+        return (data_type_);
+      }
+
+      /** \brief Get the total number of points in the file. */
+      inline size_t
+      getNumberOfPoints () const
+      {
+        return (nr_points_);
+      }
+
+      /** \brief Get the number of points already returned. */
+      inline size_t
+      getNumberOfPointsRead () const
+      {
+        return (current_point_);
+      }
+
+      /** \brief Read the next batch of points.
+        * \param[out] block the resultant batch, as an unorganized (height = 1) cloud
+        * \param[in] max_points the maximum number of points in the batch
+        * \return the number of points read, 0 once all points have been read, or -1 on error
+        */
+      int
+      readBlock (sensor_msgs::PointCloud2 &block, unsigned int max_points);
+
+      /** \brief Read the next batch of points, and convert it to the given template format.
+        * \param[out] block the resultant batch, as an unorganized (height = 1) cloud
+        * \param[in] max_points the maximum number of points in the batch
+        * \return the number of points read, 0 once all points have been read, or -1 on error
+        */
+      template <typename PointT> int
+      readBlock (pcl::PointCloud<PointT> &block, unsigned int max_points)
+      {
+        int res = readBlock (blob_, max_points);
+        if (res > 0)
+        {
+          pcl::fromROSMsg (blob_, block);
+          block.sensor_origin_ = origin_;
+          block.sensor_orientation_ = orientation_;
+        }
+        return (res);
+      }
+
+      /** \brief Read all the remaining points, and pass them to \a callback in
+        * batches of (at most) \a block_size points. The batch passed to the
+        * callback is reused, so it must be copied if it needs to be kept.
+        * \param[in] block_size the maximum number of points in a batch
+        * \param[in] callback the function to call for every batch
+        * \return
+        *  * < 0 (-1) on error
+        *  * == 0 on success
+        */
+      template <typename PointT> int
+      readBlocks (unsigned int block_size,
+                  const boost::function<void (const pcl::PointCloud<PointT> &)> &callback)
+      {
+        pcl::PointCloud<PointT> block;
+        int res;
+        while ((res = readBlock (block, block_size)) > 0)
+          callback (block);
+        return (res);
+      }
+
+    private:
+      /** \brief Copy \a len bytes starting at absolute file position \a pos into \a out. */
+      bool
+      readRange (size_t pos, size_t len, char *out);
+
+      /** \brief Read the next batch of an ascii file. */
+      int
+      readBlockASCII (sensor_msgs::PointCloud2 &block, unsigned int nr_points);
+
+      /** \brief Read the next batch of a binary file. */
+      int
+      readBlockBinary (sensor_msgs::PointCloud2 &block, unsigned int nr_points);
+
+      /** \brief Read the next batch of a binary_compressed, binary_compressed_chunked or columnar file. */
+      int
+      readBlockCompressed (sensor_msgs::PointCloud2 &block, unsigned int nr_points);
+
+      /** \brief Copy the plane range [\a begin, \a begin + \a len) of the
+        * decompressed data to \a out, decompressing the needed chunks (columnar
+        * files are read directly). */
+      bool
+      copyDecompressedRange (size_t begin, size_t len, char *out);
+
+      /** \brief The name of the file being read. */
+      std::string file_name_;
+
+      /** \brief Set to true if a file is open. */
+      bool is_open_;
+
+      /** \brief The file header (no data). */
+      sensor_msgs::PointCloud2 header_;
+
+      /** \brief The sensor acquisition origin. */
+      Eigen::Vector4f origin_;
+
+      /** \brief The sensor acquisition orientation. */
+      Eigen::Quaternionf orientation_;
+
+      /** \brief The type of data (0 = ASCII, 1 = Binary, 2 = Binary compressed, 3 = Binary compressed chunked, 4 = Columnar). */
+      int data_type_;
+
+      /** \brief The offset of the point data in the file. */
+      size_t data_idx_;
+
+      /** \brief The size of the file in bytes. */
+      size_t file_size_;
+
+      /** \brief The total number of points. */
+      size_t nr_points_;
+
+      /** \brief The index of the next point to read. */
+      size_t current_point_;
+
+      /** \brief The ascii input stream. */
+      std::ifstream fs_;
+
+      /** \brief Byte size and offset in the decompressed (or columnar) data of every (non padding) field plane. */
+      std::vector<size_t> plane_sizes_, plane_offsets_;
+
+      /** \brief The whole decompressed data, for binary_compressed files. */
+      std::vector<char> decompressed_;
+
+      /** \brief The uncompressed block size of binary_compressed_chunked files. */
+      size_t chunk_size_;
+
+      /** \brief The compressed size and absolute file offset of every chunk. */
+      std::vector<unsigned int> chunk_sizes_;
+      std::vector<size_t> chunk_offsets_;
+
+      /** \brief The decompressed chunks used by the current batch. */
+      std::map<size_t, std::vector<char> > chunk_cache_;
+
+      /** \brief Intermediate storage used by the templated readBlock. */
+      sensor_msgs::PointCloud2 blob_;
+
+    public:
+      EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+}
+
+#endif  //#ifndef PCL_IO_PCD_STREAM_READER_H_
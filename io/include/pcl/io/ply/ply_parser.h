@@ -97,6 +97,23 @@ namespace pcl
           typedef boost::function<void ()> end_element_callback_type;
           typedef boost::tuple<begin_element_callback_type, end_element_callback_type> element_callbacks_type;
           typedef boost::function<element_callbacks_type (const std::string&, std::size_t)> element_definition_callback_type;
+
+          /** \brief Name, offset and size (in bytes) of a property in the records of a fixed size element. */
+          struct property_layout
+          {
+            property_layout (const std::string& name, std::size_t offset, std::size_t size)
+              : name (name), offset (offset), size (size) {}
+            std::string name;
+            std::size_t offset;
+            std::size_t size;
+          };
+          /** \brief Called with (element name, format, element count, record size, property layouts, stream)
+            * before the data of a binary element made of scalar properties only. Returning true means the
+            * callback consumed the count * record size bytes of the element from the stream itself, and
+            * that the property callbacks are not to be called for this element.
+            */
+          typedef boost::function<bool (const std::string&, format_type, std::size_t, std::size_t,
+                                        const std::vector<property_layout>&, std::istream&)> fixed_size_element_callback_type;
          
           template <typename ScalarType>
           struct scalar_property_callback_type
@@ -301,12 +318,15 @@ namespace pcl
           inline void
           end_header_callback (const end_header_callback_type& end_header_callback);
 
+          inline void
+          fixed_size_element_callback (const fixed_size_element_callback_type& fixed_size_element_callback);
+
           typedef int flags_type;
           enum flags { };
 
           ply_parser (flags_type flags = 0) : 
             flags_ (flags), 
-            comment_callback_ (), obj_info_callback_ (), end_header_callback_ (), 
+            comment_callback_ (), obj_info_callback_ (), end_header_callback_ (), fixed_size_element_callback_ (), 
             line_number_ (0), current_element_ ()
           {}
               
@@ -320,6 +340,8 @@ namespace pcl
             property (const std::string& name) : name (name) {}
             virtual ~property () {}
             virtual bool parse (class ply_parser& ply_parser, format_type format, std::istream& istream) = 0;
+            /** \brief Size of the property in a binary record, or 0 if it is not fixed. */
+            virtual std::size_t fixed_size () const = 0;
             std::string name;
           };
             
@@ -338,6 +360,7 @@ namespace pcl
             { 
               return ply_parser.parse_scalar_property<scalar_type> (format, istream, callback); 
             }
+            std::size_t fixed_size () const { return (sizeof (scalar_type)); }
             callback_type callback;
           };
 
@@ -368,6 +391,7 @@ namespace pcl
                                                                              element_callback,
                                                                              end_callback);
             }
+            std::size_t fixed_size () const { return (0); }
             begin_callback_type begin_callback;
             element_callback_type element_callback;
             end_callback_type end_callback;
@@ -406,6 +430,7 @@ namespace pcl
           comment_callback_type comment_callback_;
           obj_info_callback_type obj_info_callback_;
           end_header_callback_type end_header_callback_;
+          fixed_size_element_callback_type fixed_size_element_callback_;
           
           template <typename ScalarType> inline void 
           parse_scalar_property_definition (const std::string& property_name);
@@ -493,6 +518,11 @@ inline void pcl::io::ply::ply_parser::end_header_callback (const end_header_call
   end_header_callback_ = end_header_callback;
 }
 
+inline void pcl::io::ply::ply_parser::fixed_size_element_callback (const fixed_size_element_callback_type& fixed_size_element_callback)
+{
+  fixed_size_element_callback_ = fixed_size_element_callback;
+}
+
 template <typename ScalarType>
 inline void pcl::io::ply::ply_parser::parse_scalar_property_definition (const std::string& property_name)
 {
@@ -96,6 +96,8 @@ namespace pcl
         , range_count_ (0)
         , range_grid_vertex_indices_element_index_ (0)
         , rgb_offset_before_ (0)
+        , r_ (0), g_ (0), b_ (0)
+        , vertex_copies_ ()
       {}
 
       PLYReader (const PLYReader &p)
@@ -111,6 +113,8 @@ namespace pcl
         , range_count_ (0)
         , range_grid_vertex_indices_element_index_ (0)
         , rgb_offset_before_ (0)
+        , r_ (0), g_ (0), b_ (0)
+        , vertex_copies_ ()
       {
         *this = p;
       }
@@ -431,6 +435,39 @@ namespace pcl
       void
       objInfoCallback (const std::string& line);
 
+      /** Callback function reading all the vertices at once when they are
+        * stored in binary, with scalar properties only. Every record is
+        * converted with \a vertex_copies_, instead of calling a callback per
+        * property, and the records are read directly into the cloud when
+        * they already have its layout.
+        * \return true if the vertices were read, false to fall back to the
+        * per property callbacks
+        */
+      bool
+      fixedSizeElementCallback (const std::string& element_name, pcl::io::ply::format_type format,
+                                std::size_t count, std::size_t record_size,
+                                const std::vector<pcl::io::ply::ply_parser::property_layout>& layout,
+                                std::istream& istream);
+
+      /** \brief Where and how a vertex property read by the callbacks is stored in the cloud. */
+      struct VertexPropertyCopy
+      {
+        enum Type
+        {
+          FLOAT32,            // float property copied as is
+          UINT8_TO_FLOAT32,   // uchar property (intensity) converted to float
+          RGB                 // red, green and blue uchar properties packed in a float
+        };
+
+        VertexPropertyCopy (Type type, const std::string &name, uint32_t cloud_offset)
+          : type (type), names (1, name), cloud_offset (cloud_offset) {}
+
+        Type type;
+        /** \brief The names of the source properties (red, green, blue for RGB). */
+        std::vector<std::string> names;
+        uint32_t cloud_offset;
+      };
+
       /// origin
       Eigen::Vector4f origin_;
 
@@ -445,6 +482,9 @@ namespace pcl
       std::vector<std::vector <int> > *range_grid_;
       size_t range_count_, range_grid_vertex_indices_element_index_;
       size_t rgb_offset_before_;
+      int32_t r_, g_, b_;
+      //bulk vertex reading
+      std::vector<VertexPropertyCopy> vertex_copies_;
       
     public:
       EIGEN_MAKE_ALIGNED_OPERATOR_NEW
@@ -0,0 +1,290 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <pcl/io/async_pcd_writer.h>
+#include <pcl/common/time.h>
+#include <pcl/console/print.h>
+#include <pcl/exceptions.h>
+#include <iomanip>
+#include <sstream>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::AsyncPCDWriter::AsyncPCDWriter (const std::string &prefix, size_t capacity)
+  : prefix_ (prefix)
+  , capacity_ (capacity > 0 ? capacity : 1)
+  , nr_threads_ (1)
+  , index_width_ (6)
+  , format_ (BINARY)
+  , policy_ (BLOCK)
+  , queue_ ()
+  , next_index_ (0)
+  , active_ (0)
+  , stop_ (false)
+  , stats_ ()
+  , mutex_ ()
+  , not_empty_ ()
+  , not_full_ ()
+  , idle_ ()
+  , threads_ ()
+  , running_ (false)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::AsyncPCDWriter::~AsyncPCDWriter ()
+{
+  if (running_)
+    stop (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::AsyncPCDWriter::setFormat (Format format)
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  format_ = format;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::AsyncPCDWriter::setOverflowPolicy (OverflowPolicy policy)
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  policy_ = policy;
+  // Blocked producers must re-evaluate the policy
+  not_full_.notify_all ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::AsyncPCDWriter::setNextIndex (size_t index)
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  next_index_ = index;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+std::string
+pcl::AsyncPCDWriter::getFileName (size_t index) const
+{
+  std::ostringstream ss;
+  ss << prefix_ << std::setfill ('0') << std::setw (index_width_) << index << ".pcd";
+  return (ss.str ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::AsyncPCDWriter::start ()
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  if (running_)
+    return;
+  stop_ = false;
+  running_ = true;
+  for (unsigned int i = 0; i < nr_threads_; ++i)
+    threads_.create_thread (boost::bind (&AsyncPCDWriter::run, this));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::AsyncPCDWriter::stop (bool flush)
+{
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    if (!running_)
+      return;
+    if (!flush)
+    {
+      stats_.dropped += queue_.size ();
+      queue_.clear ();
+      stats_.queued = 0;
+    }
+    stop_ = true;
+    not_empty_.notify_all ();
+    not_full_.notify_all ();
+  }
+  threads_.join_all ();
+
+  boost::mutex::scoped_lock lock (mutex_);
+  running_ = false;
+  idle_.notify_all ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::AsyncPCDWriter::isRunning () const
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  return (running_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::AsyncPCDWriter::flush ()
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  // Without writer threads the queue would never drain
+  while (running_ && (!queue_.empty () || active_ > 0))
+    idle_.wait (lock);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::AsyncPCDWriter::Statistics
+pcl::AsyncPCDWriter::getStatistics () const
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  return (stats_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::AsyncPCDWriter::push (const sensor_msgs::PointCloud2::ConstPtr &cloud,
+                           const Eigen::Vector4f &origin, const Eigen::Quaternionf &orientation)
+{
+  boost::shared_ptr<Pose> pose (new Pose);
+  pose->origin = origin;
+  pose->orientation = orientation;
+  return (enqueue (boost::bind (&AsyncPCDWriter::writeBlob, _1, _2, cloud, 
+                                boost::shared_ptr<const Pose> (pose), _3)));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::AsyncPCDWriter::writeBlob (pcl::PCDWriter &writer, const std::string &file_name, 
+                                const sensor_msgs::PointCloud2::ConstPtr &cloud, 
+                                const boost::shared_ptr<const Pose> &pose, Format format)
+{
+  switch (format)
+  {
+    case BINARY_COMPRESSED:
+      return (writer.writeBinaryCompressed (file_name, *cloud, pose->origin, pose->orientation));
+    case BINARY_COMPRESSED_CHUNKED:
+      return (writer.writeBinaryCompressedChunked (file_name, *cloud, pose->origin, pose->orientation));
+    default:
+      return (writer.writeBinary (file_name, *cloud, pose->origin, pose->orientation));
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::AsyncPCDWriter::enqueue (const WriteFunction &write)
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  if (queue_.size () >= capacity_)
+  {
+    // Nothing would ever make room before start ()
+    if (policy_ == BLOCK && running_ && !stop_)
+    {
+      ++stats_.blocked;
+      double start = pcl::getTime ();
+      while (queue_.size () >= capacity_ && policy_ == BLOCK && !stop_)
+        not_full_.wait (lock);
+      stats_.blocked_time += pcl::getTime () - start;
+    }
+    if (queue_.size () >= capacity_)
+    {
+      ++stats_.dropped;
+      if (policy_ != DROP_OLDEST)
+        return (false);
+      queue_.pop_front ();
+    }
+  }
+
+  queue_.push_back (Job (write, format_));
+  ++stats_.pushed;
+  stats_.queued = queue_.size ();
+  stats_.max_queued = std::max (stats_.max_queued, stats_.queued);
+  not_empty_.notify_one ();
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::AsyncPCDWriter::run ()
+{
+  pcl::PCDWriter writer;
+  // With several writer threads, files are already compressed in parallel
+  writer.setNumberOfThreads (nr_threads_ > 1 ? 1 : 0);
+  while (true)
+  {
+    Job job;
+    size_t index;
+    {
+      boost::mutex::scoped_lock lock (mutex_);
+      while (queue_.empty () && !stop_)
+        not_empty_.wait (lock);
+      if (queue_.empty ())
+        break;
+      job = queue_.front ();
+      queue_.pop_front ();
+      // Numbering at dequeue keeps the names contiguous and in push order
+      index = next_index_++;
+      ++active_;
+      stats_.queued = queue_.size ();
+      not_full_.notify_one ();
+    }
+
+    std::string file_name = getFileName (index);
+    int res = -1;
+    // An exception escaping the worker thread would terminate the process
+    try
+    {
+      res = job.write (writer, file_name, job.format);
+      if (res < 0)
+        PCL_ERROR ("[pcl::AsyncPCDWriter] Error writing %s!\n", file_name.c_str ());
+    }
+    catch (const pcl::IOException &e)
+    {
+      PCL_ERROR ("[pcl::AsyncPCDWriter] Error writing %s: %s\n", file_name.c_str (), e.detailedMessage ().c_str ());
+    }
+    catch (const std::exception &e)
+    {
+      PCL_ERROR ("[pcl::AsyncPCDWriter] Error writing %s: %s\n", file_name.c_str (), e.what ());
+    }
+
+    boost::mutex::scoped_lock lock (mutex_);
+    --active_;
+    if (res < 0)
+      ++stats_.failed;
+    else
+      ++stats_.written;
+    if (queue_.empty () && active_ == 0)
+      idle_.notify_all ();
+  }
+}
@@ -52,6 +52,23 @@ template class PCL_EXPORTS pcl::io::OctreePointCloudCompression<pcl::PointXYZ>;
 template class PCL_EXPORTS pcl::io::OctreePointCloudCompression<pcl::PointXYZRGB>;
 template class PCL_EXPORTS pcl::io::OctreePointCloudCompression<pcl::PointXYZRGBA>;
 
+#include <pcl/compression/tiled_octree_pointcloud_compression.h>
+#include <pcl/compression/impl/tiled_octree_pointcloud_compression.hpp>
+
+template class PCL_EXPORTS pcl::io::TiledOctreePointCloudCompression<pcl::PointXYZ>;
+template class PCL_EXPORTS pcl::io::TiledOctreePointCloudCompression<pcl::PointXYZRGB>;
+template class PCL_EXPORTS pcl::io::TiledOctreePointCloudCompression<pcl::PointXYZRGBA>;
+
+#include <pcl/compression/octree_pointcloud_sequence.h>
+#include <pcl/compression/impl/octree_pointcloud_sequence.hpp>
+
+template class PCL_EXPORTS pcl::io::OctreePointCloudSequenceWriter<pcl::PointXYZ>;
+template class PCL_EXPORTS pcl::io::OctreePointCloudSequenceWriter<pcl::PointXYZRGB>;
+template class PCL_EXPORTS pcl::io::OctreePointCloudSequenceWriter<pcl::PointXYZRGBA>;
+template class PCL_EXPORTS pcl::io::OctreePointCloudSequenceReader<pcl::PointXYZ>;
+template class PCL_EXPORTS pcl::io::OctreePointCloudSequenceReader<pcl::PointXYZRGB>;
+template class PCL_EXPORTS pcl::io::OctreePointCloudSequenceReader<pcl::PointXYZRGBA>;
+
 #ifdef HAVE_PNG
 #include <pcl/compression/organized_pointcloud_compression.h>
 #include <pcl/compression/impl/organized_pointcloud_compression.hpp>
@@ -0,0 +1,575 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ */
+
+#include <pcl/compression/depth_image_codec.h>
+#include <pcl/console/print.h>
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <cstdlib>
+#include <sstream>
+
+namespace
+{
+  const char depthCodecMagic[4] = {'P', 'D', 'I', 'C'};
+  const uint8_t depthCodecVersion = 1;
+
+  /** \brief Size of the header: magic, version, channels, two reserved bytes, width, height, frame id, band count. */
+  const size_t depthCodecHeaderSize = 4 + 4 + 4 * sizeof (uint32_t);
+
+  /** \brief Median edge detector of LOCO-I: predict a sample from its left (a), upper (b) and upper left (c) neighbors. */
+  inline int
+  predictMED (int a, int b, int c)
+  {
+    const int min_ab = std::min (a, b);
+    const int max_ab = std::max (a, b);
+    if (c >= max_ab)
+      return (min_ab);
+    if (c <= min_ab)
+      return (max_ab);
+    return (a + b - c);
+  }
+
+  /** \brief Map a residual modulo 2^16 to an unsigned value, small magnitudes first. */
+  inline unsigned int
+  zigzag (int residual)
+  {
+    const int16_t r = static_cast<int16_t> (residual);
+    return (static_cast<uint16_t> ((r << 1) ^ (r >> 15)));
+  }
+
+  /** \brief Inverse of zigzag. */
+  inline int
+  unzigzag (unsigned int value)
+  {
+    return (static_cast<int> (value >> 1) ^ -static_cast<int> (value & 1));
+  }
+
+  /** \brief Predict the sample \a idx of a band from the already coded samples of \a signal_arg.
+    * \param[in] signal_arg the (intra or temporal) signal
+    * \param[in] idx index of the sample
+    * \param[in] x column of the sample
+    * \param[in] first_row true for the first row of the band
+    * \param[in] stride number of samples per row
+    * \param[in] channels number of samples per pixel
+    */
+  inline int
+  predictSample (const int* signal_arg, size_t idx, size_t x, bool first_row, size_t stride, unsigned int channels)
+  {
+    if (first_row)
+      return (x > 0 ? signal_arg[idx - channels] : 0);
+    if (x == 0)
+      return (signal_arg[idx - stride]);
+    return (predictMED (signal_arg[idx - channels], signal_arg[idx - stride], signal_arg[idx - stride - channels]));
+  }
+
+  /** \brief Number of activity classes of the context model. */
+  const unsigned int depthCodecActivityClasses = 6;
+
+  /** \brief Classify the local activity (gradient magnitude) around the sample \a idx of a band.
+    * The residuals of every class and channel are coded with their own frequency table.
+    */
+  inline unsigned int
+  activityClass (const int* signal_arg, size_t idx, size_t x, bool first_row, size_t stride, unsigned int channels)
+  {
+    if (first_row || x == 0)
+      return (0);
+    const int c = signal_arg[idx - stride - channels];
+    const int activity = std::abs (signal_arg[idx - channels] - c) + std::abs (signal_arg[idx - stride] - c);
+    if (activity == 0)
+      return (0);
+    if (activity < 3)
+      return (1);
+    if (activity < 8)
+      return (2);
+    if (activity < 24)
+      return (3);
+    if (activity < 64)
+      return (4);
+    return (5);
+  }
+
+  /** \brief Band mode flags. */
+  enum BandMode
+  {
+    TEMPORAL_BAND = 1,   // predicted from the difference to the previous frame
+    RED_MINUS_GREEN = 2, // the green prediction error is removed from the red one
+    BLUE_MINUS_GREEN = 4 // the green prediction error is removed from the blue one
+  };
+
+  /** \brief Order-0 entropy (in bits) of the errors of \a channel, with the green error removed or not.
+    * Large residuals share one histogram bin, which is good enough to compare two choices.
+    */
+  inline double
+  channelEntropy (const std::vector<int>& errors_arg, unsigned int channel, bool minus_green)
+  {
+    std::vector<unsigned int> histogram (1024, 0);
+    size_t count = 0;
+    for (size_t i = 0; i + 2 < errors_arg.size (); i += 3, ++count)
+    {
+      const int error = minus_green ? errors_arg[i + channel] - errors_arg[i + 1] : errors_arg[i + channel];
+      histogram[std::min (zigzag (error), 1023u)]++;
+    }
+    double bits = 0;
+    for (size_t v = 0; v < histogram.size (); ++v)
+      if (histogram[v])
+        bits -= histogram[v] * std::log (static_cast<double> (histogram[v]) / static_cast<double> (count));
+    return (bits / std::log (2.0));
+  }
+
+  template <typename T> inline void
+  writeValue (std::vector<uint8_t>& data, size_t& pos, T value)
+  {
+    memcpy (&data[pos], &value, sizeof (T));
+    pos += sizeof (T);
+  }
+
+  template <typename T> inline T
+  readValue (const std::vector<uint8_t>& data, size_t& pos)
+  {
+    T value;
+    memcpy (&value, &data[pos], sizeof (T));
+    pos += sizeof (T);
+    return (value);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+pcl::io::DepthImageCodec::DepthImageCodec ()
+  : threads_ (0)
+  , bands_ (8)
+  , temporal_ (false)
+  , keyFramePeriod_ (30)
+  , framesSinceKeyFrame_ (0)
+  , encoderFrameID_ (0)
+  , previousEncoded_ ()
+  , decoded_ ()
+  , previousDecoded_ ()
+  , decoderFrameID_ (0)
+  , hasDecodedFrame_ (false)
+  , coders_ ()
+  , bandData_ ()
+{
+  std::fill (previousEncodedSize_, previousEncodedSize_ + 3, 0);
+  std::fill (previousDecodedSize_, previousDecodedSize_ + 3, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::DepthImageCodec::setTemporalPrediction (bool enable_arg, unsigned int keyFramePeriod_arg)
+{
+  temporal_ = enable_arg;
+  keyFramePeriod_ = keyFramePeriod_arg;
+  framesSinceKeyFrame_ = 0;
+  previousEncoded_.clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::DepthImageCodec::reset ()
+{
+  framesSinceKeyFrame_ = 0;
+  previousEncoded_.clear ();
+  previousDecoded_.clear ();
+  hasDecodedFrame_ = false;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::DepthImageCodec::isEncodedImage (const std::vector<uint8_t>& data_arg)
+{
+  return (data_arg.size () >= depthCodecHeaderSize && memcmp (&data_arg[0], depthCodecMagic, sizeof (depthCodecMagic)) == 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::DepthImageCodec::encodeMonoImage (const std::vector<uint16_t>& image_arg,
+                                           size_t width_arg,
+                                           size_t height_arg,
+                                           std::vector<uint8_t>& compressedData_arg)
+{
+  if (image_arg.size () != width_arg * height_arg)
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCodec::encodeMonoImage] Image size does not match %zux%zu!\n", width_arg, height_arg);
+    compressedData_arg.clear ();
+    return;
+  }
+  encodeImage (image_arg.empty () ? NULL : &image_arg[0], width_arg, height_arg, 1, compressedData_arg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::DepthImageCodec::encodeRGBImage (const std::vector<uint8_t>& image_arg,
+                                          size_t width_arg,
+                                          size_t height_arg,
+                                          std::vector<uint8_t>& compressedData_arg)
+{
+  if (image_arg.size () != width_arg * height_arg * 3)
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCodec::encodeRGBImage] Image size does not match %zux%zu!\n", width_arg, height_arg);
+    compressedData_arg.clear ();
+    return;
+  }
+  std::vector<uint16_t> image (image_arg.begin (), image_arg.end ());
+  encodeImage (image.empty () ? NULL : &image[0], width_arg, height_arg, 3, compressedData_arg);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::io::DepthImageCodec::encodeImage (const uint16_t* image_arg, size_t width_arg, size_t height_arg,
+                                       unsigned int channels_arg, std::vector<uint8_t>& compressedData_arg)
+{
+  const size_t size = width_arg * height_arg * channels_arg;
+
+  // temporal prediction needs a previous frame of the same size
+  bool key_frame = !temporal_ || previousEncoded_.size () != size ||
+                   previousEncodedSize_[0] != width_arg || previousEncodedSize_[1] != height_arg ||
+                   previousEncodedSize_[2] != channels_arg ||
+                   (keyFramePeriod_ > 0 && framesSinceKeyFrame_ >= keyFramePeriod_);
+  if (key_frame)
+    framesSinceKeyFrame_ = 0;
+  framesSinceKeyFrame_++;
+  const uint16_t* previous = key_frame ? NULL : &previousEncoded_[0];
+
+  const int nr_bands = static_cast<int> (std::max<size_t> (1, std::min<size_t> (bands_, height_arg)));
+  if (coders_.size () < static_cast<size_t> (nr_bands))
+    coders_.resize (nr_bands);
+  for (int b = 0; b < nr_bands; ++b)
+    coders_[b].setBitstreamVersion (StaticRangeCoder::RANS_BITSTREAM);
+  bandData_.resize (nr_bands);
+  std::vector<uint8_t> band_modes (nr_bands, 0);
+
+#pragma omp parallel for num_threads(threads_) schedule(dynamic)
+  for (int b = 0; b < nr_bands; ++b)
+  {
+    const size_t first_row = height_arg * b / nr_bands;
+    const size_t end_row = height_arg * (b + 1) / nr_bands;
+    band_modes[b] = encodeBand (image_arg, previous, width_arg, channels_arg, first_row, end_row,
+                                coders_[b], bandData_[b]);
+  }
+
+  // header, band table and band data
+  size_t total_size = depthCodecHeaderSize + nr_bands * (1 + sizeof (uint32_t));
+  for (int b = 0; b < nr_bands; ++b)
+    total_size += bandData_[b].size ();
+  compressedData_arg.resize (total_size);
+
+  size_t pos = 0;
+  memcpy (&compressedData_arg[0], depthCodecMagic, sizeof (depthCodecMagic));
+  pos += sizeof (depthCodecMagic);
+  writeValue<uint8_t> (compressedData_arg, pos, depthCodecVersion);
+  writeValue<uint8_t> (compressedData_arg, pos, static_cast<uint8_t> (channels_arg));
+  writeValue<uint8_t> (compressedData_arg, pos, 0);
+  writeValue<uint8_t> (compressedData_arg, pos, 0);
+  writeValue<uint32_t> (compressedData_arg, pos, static_cast<uint32_t> (width_arg));
+  writeValue<uint32_t> (compressedData_arg, pos, static_cast<uint32_t> (height_arg));
+  writeValue<uint32_t> (compressedData_arg, pos, encoderFrameID_++);
+  writeValue<uint32_t> (compressedData_arg, pos, static_cast<uint32_t> (nr_bands));
+  for (int b = 0; b < nr_bands; ++b)
+  {
+    writeValue<uint8_t> (compressedData_arg, pos, band_modes[b]);
+    writeValue<uint32_t> (compressedData_arg, pos, static_cast<uint32_t> (bandData_[b].size ()));
+  }
+  for (int b = 0; b < nr_bands; ++b)
+  {
+    if (!bandData_[b].empty ())
+      memcpy (&compressedData_arg[pos], bandData_[b].data (), bandData_[b].size ());
+    pos += bandData_[b].size ();
+  }
+
+  // keep the reference of the next frame
+  if (temporal_)
+  {
+    previousEncoded_.assign (image_arg, image_arg + size);
+    previousEncodedSize_[0] = width_arg;
+    previousEncodedSize_[1] = height_arg;
+    previousEncodedSize_[2] = channels_arg;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+uint8_t
+pcl::io::DepthImageCodec::encodeBand (const uint16_t* image_arg, const uint16_t* previous_arg, size_t width_arg,
+                                      unsigned int channels_arg, size_t firstRow_arg, size_t endRow_arg,
+                                      StaticRangeCoder& coder_arg, std::string& bandData_arg) const
+{
+  const size_t stride = width_arg * channels_arg;
+  const size_t begin = firstRow_arg * stride;
+  const size_t size = (endRow_arg - firstRow_arg) * stride;
+
+  // intra signal, and temporal signal (difference to the previous frame)
+  std::vector<int> intra (size), temporal (previous_arg ? size : 0);
+  for (size_t i = 0; i < size; ++i)
+    intra[i] = image_arg[begin + i];
+  for (size_t i = 0; i < temporal.size (); ++i)
+    temporal[i] = static_cast<int> (image_arg[begin + i]) - static_cast<int> (previous_arg[begin + i]);
+
+  std::vector<int> intra_errors (size), temporal_errors (temporal.size ());
+  std::vector<uint8_t> intra_classes (size), temporal_classes (temporal.size ());
+  size_t idx = 0;
+  for (size_t y = firstRow_arg; y < endRow_arg; ++y)
+  {
+    const bool first_row = (y == firstRow_arg);
+    for (size_t x = 0; x < width_arg; ++x)
+    {
+      for (unsigned int c = 0; c < channels_arg; ++c, ++idx)
+      {
+        intra_errors[idx] = intra[idx] - predictSample (&intra[0], idx, x, first_row, stride, channels_arg);
+        intra_classes[idx] = static_cast<uint8_t> (activityClass (&intra[0], idx, x, first_row, stride, channels_arg));
+        if (previous_arg)
+        {
+          temporal_errors[idx] = temporal[idx] - predictSample (&temporal[0], idx, x, first_row, stride, channels_arg);
+          temporal_classes[idx] = static_cast<uint8_t> (activityClass (&temporal[0], idx, x, first_row, stride, channels_arg));
+        }
+      }
+    }
+  }
+
+  uint64_t intra_cost = 0, temporal_cost = 0;
+  for (size_t i = 0; i < size; ++i)
+    intra_cost += zigzag (intra_errors[i]);
+  for (size_t i = 0; i < temporal_errors.size (); ++i)
+    temporal_cost += zigzag (temporal_errors[i]);
+  const bool use_temporal = previous_arg && temporal_cost < intra_cost;
+  std::vector<int>& errors = use_temporal ? temporal_errors : intra_errors;
+  const std::vector<uint8_t>& classes = use_temporal ? temporal_classes : intra_classes;
+  uint8_t mode = use_temporal ? TEMPORAL_BAND : 0;
+
+  // the errors of the color channels are usually correlated, remove the green one where it pays off
+  if (channels_arg == 3)
+  {
+    if (channelEntropy (errors, 0, true) < channelEntropy (errors, 0, false))
+      mode |= RED_MINUS_GREEN;
+    if (channelEntropy (errors, 2, true) < channelEntropy (errors, 2, false))
+      mode |= BLUE_MINUS_GREEN;
+    for (size_t i = 0; i + 2 < size; i += 3)
+    {
+      if (mode & RED_MINUS_GREEN)
+        errors[i] -= errors[i + 1];
+      if (mode & BLUE_MINUS_GREEN)
+        errors[i + 2] -= errors[i + 1];
+    }
+  }
+
+  // one residual stream per channel and activity class, each preceded by its length
+  std::vector<std::vector<unsigned int> > residuals (channels_arg * depthCodecActivityClasses);
+  for (size_t i = 0; i < size; ++i)
+    residuals[(i % channels_arg) * depthCodecActivityClasses + classes[i]].push_back (zigzag (errors[i]));
+
+  std::ostringstream band_stream;
+  for (size_t k = 0; k < residuals.size (); ++k)
+  {
+    const uint32_t count = static_cast<uint32_t> (residuals[k].size ());
+    band_stream.write (reinterpret_cast<const char*> (&count), sizeof (count));
+    if (count)
+      coder_arg.encodeIntVectorToStream (residuals[k], band_stream);
+  }
+  bandData_arg = band_stream.str ();
+  return (mode);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::DepthImageCodec::decodeImage (const std::vector<uint8_t>& compressedData_arg,
+                                       size_t& width_arg, size_t& height_arg, unsigned int& channels_arg)
+{
+  if (!isEncodedImage (compressedData_arg))
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCodec::decodeImage] Invalid image data!\n");
+    return (false);
+  }
+
+  size_t pos = sizeof (depthCodecMagic);
+  const uint8_t version = readValue<uint8_t> (compressedData_arg, pos);
+  channels_arg = readValue<uint8_t> (compressedData_arg, pos);
+  pos += 2;
+  width_arg = readValue<uint32_t> (compressedData_arg, pos);
+  height_arg = readValue<uint32_t> (compressedData_arg, pos);
+  const uint32_t frame_id = readValue<uint32_t> (compressedData_arg, pos);
+  const int nr_bands = static_cast<int> (readValue<uint32_t> (compressedData_arg, pos));
+  if (version != depthCodecVersion || (channels_arg != 1 && channels_arg != 3) || nr_bands <= 0 ||
+      compressedData_arg.size () < pos + nr_bands * (1 + sizeof (uint32_t)))
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCodec::decodeImage] Unsupported image data (version %u)!\n", version);
+    return (false);
+  }
+
+  std::vector<uint8_t> band_modes (nr_bands);
+  std::vector<size_t> band_offsets (nr_bands + 1);
+  bool temporal = false;
+  for (int b = 0; b < nr_bands; ++b)
+  {
+    band_modes[b] = readValue<uint8_t> (compressedData_arg, pos);
+    band_offsets[b + 1] = band_offsets[b] + readValue<uint32_t> (compressedData_arg, pos);
+    temporal |= ((band_modes[b] & TEMPORAL_BAND) != 0);
+  }
+  if (compressedData_arg.size () < pos + band_offsets[nr_bands])
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCodec::decodeImage] Truncated image data!\n");
+    return (false);
+  }
+
+  const size_t size = width_arg * height_arg * channels_arg;
+  if (temporal && (!hasDecodedFrame_ || decoderFrameID_ + 1 != frame_id || previousDecoded_.size () != size ||
+                   previousDecodedSize_[0] != width_arg || previousDecodedSize_[1] != height_arg ||
+                   previousDecodedSize_[2] != channels_arg))
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCodec::decodeImage] Frame %u is predicted from a frame which was not decoded!\n", frame_id);
+    return (false);
+  }
+
+  decoded_.resize (size);
+  if (coders_.size () < static_cast<size_t> (nr_bands))
+    coders_.resize (nr_bands);
+
+  const char* data = reinterpret_cast<const char*> (&compressedData_arg[0]) + pos;
+  bool valid = true;
+#pragma omp parallel for num_threads(threads_) schedule(dynamic) reduction(&&:valid)
+  for (int b = 0; b < nr_bands; ++b)
+  {
+    const size_t first_row = height_arg * b / nr_bands;
+    const size_t end_row = height_arg * (b + 1) / nr_bands;
+    const uint16_t* previous = (band_modes[b] & TEMPORAL_BAND) ? &previousDecoded_[0] : NULL;
+    valid = decodeBand (data + band_offsets[b], band_offsets[b + 1] - band_offsets[b], band_modes[b], previous,
+                        width_arg, channels_arg, first_row, end_row, coders_[b],
+                        decoded_.empty () ? NULL : &decoded_[0]) && valid;
+  }
+  if (!valid)
+  {
+    PCL_ERROR ("[pcl::io::DepthImageCodec::decodeImage] Invalid band data!\n");
+    return (false);
+  }
+
+  // the decoded frame becomes the reference of the next one
+  previousDecoded_.swap (decoded_);
+  previousDecodedSize_[0] = width_arg;
+  previousDecodedSize_[1] = height_arg;
+  previousDecodedSize_[2] = channels_arg;
+  decoderFrameID_ = frame_id;
+  hasDecodedFrame_ = true;
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::DepthImageCodec::decodeBand (const char* data_arg, size_t size_arg, uint8_t mode_arg,
+                                      const uint16_t* previous_arg, size_t width_arg, unsigned int channels_arg,
+                                      size_t firstRow_arg, size_t endRow_arg, StaticRangeCoder& coder_arg,
+                                      uint16_t* image_arg) const
+{
+  const size_t stride = width_arg * channels_arg;
+  const size_t begin = firstRow_arg * stride;
+  const size_t size = (endRow_arg - firstRow_arg) * stride;
+
+  std::istringstream band_stream (std::string (data_arg, size_arg));
+  std::vector<std::vector<unsigned int> > residuals (channels_arg * depthCodecActivityClasses);
+  size_t total_count = 0;
+  for (size_t k = 0; k < residuals.size (); ++k)
+  {
+    uint32_t count = 0;
+    band_stream.read (reinterpret_cast<char*> (&count), sizeof (count));
+    total_count += count;
+    if (!band_stream || total_count > size)
+      return (false);
+    residuals[k].resize (count);
+    if (count)
+      coder_arg.decodeStreamToIntVector (band_stream, residuals[k]);
+  }
+  if (!band_stream || total_count != size)
+    return (false);
+
+  // reconstruct the signal, then the samples, pixel by pixel
+  std::vector<int> signal (size);
+  std::vector<size_t> positions (residuals.size (), 0);
+  int errors[3];
+  size_t idx = 0;
+  for (size_t y = firstRow_arg; y < endRow_arg; ++y)
+  {
+    const bool first_row = (y == firstRow_arg);
+    for (size_t x = 0; x < width_arg; ++x, idx += channels_arg)
+    {
+      for (unsigned int c = 0; c < channels_arg; ++c)
+      {
+        const size_t k = c * depthCodecActivityClasses + activityClass (&signal[0], idx + c, x, first_row, stride, channels_arg);
+        if (positions[k] >= residuals[k].size ())
+          return (false);
+        errors[c] = unzigzag (residuals[k][positions[k]++]);
+      }
+      if (mode_arg & RED_MINUS_GREEN)
+        errors[0] += errors[1];
+      if (mode_arg & BLUE_MINUS_GREEN)
+        errors[2] += errors[1];
+      for (unsigned int c = 0; c < channels_arg; ++c)
+      {
+        const int prediction = predictSample (&signal[0], idx + c, x, first_row, stride, channels_arg);
+        const int reference = previous_arg ? previous_arg[begin + idx + c] : 0;
+        const uint16_t sample = static_cast<uint16_t> (reference + prediction + errors[c]);
+        image_arg[begin + idx + c] = sample;
+        signal[idx + c] = static_cast<int> (sample) - reference;
+      }
+    }
+  }
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::DepthImageCodec::decodeImage (const std::vector<uint8_t>& compressedData_arg,
+                                       std::vector<uint16_t>& image_arg,
+                                       size_t& width_arg,
+                                       size_t& height_arg,
+                                       unsigned int& channels_arg)
+{
+  if (!decodeImage (compressedData_arg, width_arg, height_arg, channels_arg))
+    return (false);
+  image_arg = previousDecoded_;
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::io::DepthImageCodec::decodeImage (const std::vector<uint8_t>& compressedData_arg,
+                                       std::vector<uint8_t>& image_arg,
+                                       size_t& width_arg,
+                                       size_t& height_arg,
+                                       unsigned int& channels_arg)
+{
+  if (!decodeImage (compressedData_arg, width_arg, height_arg, channels_arg))
+    return (false);
+  image_arg.resize (previousDecoded_.size ());
+  for (size_t i = 0; i < previousDecoded_.size (); ++i)
+    image_arg[i] = static_cast<uint8_t> (previousDecoded_[i]);
+  return (true);
+}
@@ -38,6 +38,7 @@
 #include <pcl/io/lzf.h>
 #include <cstring>
 #include <climits>
+#include <algorithm>
 #include <pcl/console/print.h>
 #include <errno.h>
 
@@ -392,3 +393,130 @@ pcl::lzfDecompress (const void *const in_data,  unsigned int in_len,
   return (static_cast<unsigned int> (op - static_cast<unsigned char*> (out_data)));
 }
 
+
+///////////////////////////////////////////////////////////////////////////////////////////
+unsigned int
+pcl::lzfCompressChunked (const void *const in_data, unsigned int in_len,
+                         std::vector<char> &out_data,
+                         unsigned int block_size, unsigned int nr_threads)
+{
+  out_data.clear ();
+  if (!in_len || !block_size)
+    return (0);
+
+  const unsigned char *in = static_cast<const unsigned char *> (in_data);
+  const unsigned int nr_blocks = (in_len - 1) / block_size + 1;
+  const size_t table_size = (3 + nr_blocks) * sizeof (unsigned int);
+
+  // Each block gets a slot of block_size bytes, so that all blocks can be
+  // compressed independently. The slots are compacted afterwards.
+  out_data.resize (table_size + static_cast<size_t> (in_len));
+  std::vector<unsigned int> block_sizes (nr_blocks);
+
+#pragma omp parallel for num_threads(nr_threads)
+  for (int b = 0; b < static_cast<int> (nr_blocks); ++b)
+  {
+    const size_t in_off = static_cast<size_t> (b) * block_size;
+    const unsigned int len = std::min (block_size, static_cast<unsigned int> (in_len - in_off));
+    unsigned char *slot = reinterpret_cast<unsigned char *> (&out_data[table_size + in_off]);
+
+    // LZF output can exceed its input by ~3% for incompressible data, so compress
+    // into a scratch buffer and store the block verbatim if it did not shrink
+    std::vector<unsigned char> scratch (len + len / 16 + 64);
+    unsigned int compressed_size = pcl::lzfCompress (&in[in_off], len, &scratch[0], static_cast<unsigned int> (scratch.size ()));
+    if (compressed_size == 0 || compressed_size >= len)
+    {
+      memcpy (slot, &in[in_off], len);
+      compressed_size = len;
+    }
+    else
+      memcpy (slot, &scratch[0], compressed_size);
+    block_sizes[b] = compressed_size;
+  }
+
+  // Compact the blocks (every block is at most as large as its slot, so this never overlaps forward)
+  size_t out_off = table_size;
+  for (unsigned int b = 0; b < nr_blocks; ++b)
+  {
+    const size_t slot_off = table_size + static_cast<size_t> (b) * block_size;
+    if (slot_off != out_off)
+      memmove (&out_data[out_off], &out_data[slot_off], block_sizes[b]);
+    out_off += block_sizes[b];
+  }
+  out_data.resize (out_off);
+
+  const unsigned int header[3] = {nr_blocks, block_size, in_len};
+  memcpy (&out_data[0], header, sizeof (header));
+  memcpy (&out_data[sizeof (header)], &block_sizes[0], nr_blocks * sizeof (unsigned int));
+
+  return (static_cast<unsigned int> (out_off));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+unsigned int
+pcl::lzfDecompressChunked (const void *const in_data, unsigned int in_len,
+                           void             *out_data, unsigned int out_len,
+                           unsigned int nr_threads)
+{
+  const unsigned char *in = static_cast<const unsigned char *> (in_data);
+  unsigned char      *out = static_cast<unsigned char *> (out_data);
+
+  if (in_len < 3 * sizeof (unsigned int))
+  {
+    errno = EINVAL;
+    return (0);
+  }
+
+  unsigned int header[3];
+  memcpy (header, in, sizeof (header));
+  const unsigned int nr_blocks = header[0], block_size = header[1], total_len = header[2];
+
+  if (total_len > out_len)
+  {
+    errno = E2BIG;
+    return (0);
+  }
+  if (!block_size || !total_len || nr_blocks != (total_len - 1) / block_size + 1 ||
+      in_len < (3 + static_cast<size_t> (nr_blocks)) * sizeof (unsigned int))
+  {
+    errno = EINVAL;
+    return (0);
+  }
+
+  // Compute the position of every block in the input stream
+  std::vector<unsigned int> block_sizes (nr_blocks);
+  memcpy (&block_sizes[0], &in[3 * sizeof (unsigned int)], nr_blocks * sizeof (unsigned int));
+  std::vector<size_t> block_offsets (nr_blocks);
+  size_t in_off = (3 + nr_blocks) * sizeof (unsigned int);
+  for (unsigned int b = 0; b < nr_blocks; ++b)
+  {
+    block_offsets[b] = in_off;
+    in_off += block_sizes[b];
+  }
+  if (in_off > in_len)
+  {
+    errno = EINVAL;
+    return (0);
+  }
+
+  bool failed = false;
+#pragma omp parallel for num_threads(nr_threads)
+  for (int b = 0; b < static_cast<int> (nr_blocks); ++b)
+  {
+    const size_t out_off = static_cast<size_t> (b) * block_size;
+    const unsigned int len = std::min (block_size, static_cast<unsigned int> (total_len - out_off));
+    if (block_sizes[b] > len)
+      failed = true;
+    else if (block_sizes[b] == len)
+      memcpy (&out[out_off], &in[block_offsets[b]], len);
+    else if (pcl::lzfDecompress (&in[block_offsets[b]], block_sizes[b], &out[out_off], len) != len)
+      failed = true;
+  }
+
+  if (failed)
+  {
+    errno = EINVAL;
+    return (0);
+  }
+  return (total_len);
+}
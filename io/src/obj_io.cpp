@@ -37,9 +37,17 @@
  *
  */
 #include <pcl/io/obj_io.h>
+#include <pcl/io/number_parser.h>
+#include <algorithm>
 #include <fstream>
 #include <iostream>
+#include <sstream>
+#include <locale>
+#include <map>
 #include <pcl/common/io.h>
+#include <pcl/point_types.h>
+#include <pcl/ros/conversions.h>
+#include <boost/filesystem.hpp>
 
 int
 pcl::io::saveOBJFile (const std::string &file_name,
@@ -376,3 +384,473 @@ pcl::io::saveOBJFile (const std::string &file_name,
   fs.close ();  
   return 0;
 }
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+  /** \brief The statements understood by OBJReader. */
+  enum OBJStatement
+  {
+    OBJ_OTHER, OBJ_VERTEX, OBJ_NORMAL, OBJ_TEX_COORD, OBJ_FACE, OBJ_USEMTL, OBJ_MTLLIB
+  };
+
+  /** \brief Number of vertices, normals, texture coordinates, faces and face vertices. */
+  struct OBJCounts
+  {
+    OBJCounts () : v (0), vn (0), vt (0), f (0), refs (0) {}
+    size_t v, vn, vt, f, refs;
+  };
+
+  /** \brief What the counting pass finds in a chunk of the file. */
+  struct OBJChunk
+  {
+    OBJChunk () : counts (), materials (), libraries () {}
+    OBJCounts counts;
+    /** \brief The usemtl names, with the (chunk local) index of the next face. */
+    std::vector<std::pair<size_t, std::string> > materials;
+    std::vector<std::string> libraries;
+  };
+
+  /** \brief The flattened contents of an OBJ file. */
+  struct OBJData
+  {
+    OBJData () : vertices (), normals (), tex_coords (), face_begin (), face_vertices (), face_tex_coords (), materials (), libraries () {}
+    /** \brief 3 floats per vertex and normal, 2 per texture coordinate. */
+    std::vector<float> vertices, normals, tex_coords;
+    /** \brief Offset of the first face vertex of every face (plus the total, at the end). */
+    std::vector<size_t> face_begin;
+    /** \brief Vertex and texture coordinate (-1 if none) index of every face vertex. */
+    std::vector<uint32_t> face_vertices;
+    std::vector<int> face_tex_coords;
+    /** \brief The usemtl names, with the index of the next face. */
+    std::vector<std::pair<size_t, std::string> > materials;
+    std::vector<std::string> libraries;
+  };
+
+  inline bool
+  isOBJSpace (char c)
+  {
+    return (c == ' ' || c == '\t' || c == '\r');
+  }
+
+  inline const char*
+  skipSpaces (const char *p, const char *end)
+  {
+    while (p != end && isOBJSpace (*p))
+      ++p;
+    return (p);
+  }
+
+  inline const char*
+  skipToken (const char *p, const char *end)
+  {
+    while (p != end && !isOBJSpace (*p))
+      ++p;
+    return (p);
+  }
+
+  /** \brief Parse a number, falling back to a stream (in the classic locale) for uncommon forms. */
+  template <typename T> bool
+  parseOBJNumber (const char *begin, const char *end, T &value)
+  {
+    if (begin == end)
+      return (false);
+    if (pcl::io::parseNumber (begin, end, value))
+      return (true);
+    std::istringstream is (std::string (begin, end));
+    is.imbue (std::locale::classic ());
+    is >> value;
+    return (!is.fail ());
+  }
+
+  /** \brief Get the statement type of the line starting at \a p, and move \a p past the keyword. */
+  OBJStatement
+  parseOBJKeyword (const char *&p, const char *end)
+  {
+    p = skipSpaces (p, end);
+    const char *keyword = p;
+    p = skipToken (p, end);
+    size_t len = p - keyword;
+    if (len == 1 && keyword[0] == 'v')
+      return (OBJ_VERTEX);
+    if (len == 1 && keyword[0] == 'f')
+      return (OBJ_FACE);
+    if (len == 2 && keyword[0] == 'v' && keyword[1] == 'n')
+      return (OBJ_NORMAL);
+    if (len == 2 && keyword[0] == 'v' && keyword[1] == 't')
+      return (OBJ_TEX_COORD);
+    if (len == 6 && memcmp (keyword, "usemtl", 6) == 0)
+      return (OBJ_USEMTL);
+    if (len == 6 && memcmp (keyword, "mtllib", 6) == 0)
+      return (OBJ_MTLLIB);
+    return (OBJ_OTHER);
+  }
+
+  /** \brief Return the rest of the line, without the surrounding spaces. */
+  std::string
+  getOBJArgument (const char *p, const char *end)
+  {
+    p = skipSpaces (p, end);
+    while (end != p && isOBJSpace (*(end - 1)))
+      --end;
+    return (std::string (p, end));
+  }
+
+  /** \brief First pass: count the statements in [begin, end), and record the materials. */
+  void
+  countOBJChunk (const char *begin, const char *end, OBJChunk &chunk)
+  {
+    while (begin < end)
+    {
+      const char *line_end = static_cast<const char*> (memchr (begin, '\n', end - begin));
+      if (!line_end)
+        line_end = end;
+      const char *p = begin;
+      switch (parseOBJKeyword (p, line_end))
+      {
+        case OBJ_VERTEX: ++chunk.counts.v; break;
+        case OBJ_NORMAL: ++chunk.counts.vn; break;
+        case OBJ_TEX_COORD: ++chunk.counts.vt; break;
+        case OBJ_FACE:
+        {
+          ++chunk.counts.f;
+          for (p = skipSpaces (p, line_end); p != line_end; p = skipSpaces (skipToken (p, line_end), line_end))
+            ++chunk.counts.refs;
+          break;
+        }
+        case OBJ_USEMTL:
+        {
+          chunk.materials.push_back (std::make_pair (chunk.counts.f, getOBJArgument (p, line_end)));
+          break;
+        }
+        case OBJ_MTLLIB:
+        {
+          for (p = skipSpaces (p, line_end); p != line_end; p = skipSpaces (p, line_end))
+          {
+            const char *token = p;
+            p = skipToken (p, line_end);
+            chunk.libraries.push_back (std::string (token, p));
+          }
+          break;
+        }
+        default: break;
+      }
+      begin = line_end + 1;
+    }
+  }
+
+  /** \brief Parse at least \a min_values and at most \a max_values numbers from [p, end) into \a values. */
+  bool
+  parseOBJValues (const char *p, const char *end, int min_values, int max_values, float *values)
+  {
+    int nr_values = 0;
+    for (p = skipSpaces (p, end); p != end && nr_values < max_values; p = skipSpaces (p, end))
+    {
+      const char *token = p;
+      p = skipToken (p, end);
+      if (!parseOBJNumber (token, p, values[nr_values++]))
+        return (false);
+    }
+    for (int i = nr_values; i < max_values; ++i)
+      values[i] = 0.0f;
+    return (nr_values >= min_values);
+  }
+
+  /** \brief Convert a (1-based or negative, i.e. relative) OBJ index to a 0-based one. */
+  inline bool
+  resolveOBJIndex (const char *begin, const char *end, size_t nr_defined, size_t nr_total, int &index)
+  {
+    if (!parseOBJNumber (begin, end, index) || index == 0)
+      return (false);
+    index = index < 0 ? static_cast<int> (nr_defined) + index : index - 1;
+    return (index >= 0 && static_cast<size_t> (index) < nr_total);
+  }
+
+  /** \brief Second pass: parse [begin, end) into \a data, knowing the counts of all the preceding chunks. */
+  bool
+  parseOBJChunk (const char *begin, const char *end, const OBJCounts &first, OBJData &data)
+  {
+    OBJCounts c = first;
+    const size_t nr_vertices = data.vertices.size () / 3, nr_tex_coords = data.tex_coords.size () / 2;
+    while (begin < end)
+    {
+      const char *line_end = static_cast<const char*> (memchr (begin, '\n', end - begin));
+      if (!line_end)
+        line_end = end;
+      const char *p = begin;
+      switch (parseOBJKeyword (p, line_end))
+      {
+        case OBJ_VERTEX:
+        {
+          if (!parseOBJValues (p, line_end, 3, 3, &data.vertices[3 * c.v++]))
+            return (false);
+          break;
+        }
+        case OBJ_NORMAL:
+        {
+          if (!parseOBJValues (p, line_end, 3, 3, &data.normals[3 * c.vn++]))
+            return (false);
+          break;
+        }
+        case OBJ_TEX_COORD:
+        {
+          if (!parseOBJValues (p, line_end, 1, 2, &data.tex_coords[2 * c.vt++]))
+            return (false);
+          break;
+        }
+        case OBJ_FACE:
+        {
+          // v, v/vt, v//vn or v/vt/vn
+          for (p = skipSpaces (p, line_end); p != line_end; p = skipSpaces (p, line_end), ++c.refs)
+          {
+            const char *token = p;
+            p = skipToken (p, line_end);
+            const char *slash = std::find (token, p, '/');
+            int vertex, tex_coord = -1;
+            if (!resolveOBJIndex (token, slash, c.v, nr_vertices, vertex))
+              return (false);
+            if (slash != p)
+            {
+              const char *tex_end = std::find (slash + 1, p, '/');
+              if (tex_end != slash + 1 && !resolveOBJIndex (slash + 1, tex_end, c.vt, nr_tex_coords, tex_coord))
+                return (false);
+            }
+            data.face_vertices[c.refs] = static_cast<uint32_t> (vertex);
+            data.face_tex_coords[c.refs] = tex_coord;
+          }
+          data.face_begin[++c.f] = c.refs;
+          break;
+        }
+        default: break;
+      }
+      begin = line_end + 1;
+    }
+    return (true);
+  }
+
+  /** \brief Load and parse an OBJ file, filling \a data with the faces and \a cloud with the vertices. */
+  int
+  parseOBJFile (const std::string &file_name, unsigned int threads, OBJData &data, sensor_msgs::PointCloud2 &cloud)
+  {
+    std::ifstream fs;
+    fs.open (file_name.c_str (), std::ios::binary);
+    if (!fs.is_open () || fs.fail ())
+    {
+      PCL_ERROR ("[pcl::OBJReader::read] Could not open file %s.\n", file_name.c_str ());
+      return (-1);
+    }
+    fs.seekg (0, std::ios::end);
+    size_t text_size = static_cast<size_t> (fs.tellg ());
+    std::vector<char> text (text_size + 1, '\n');
+    fs.seekg (0);
+    if (text_size > 0)
+      fs.read (&text[0], text_size);
+    fs.close ();
+
+    // Split the text into line aligned chunks
+    int nr_chunks = static_cast<int> (std::min<size_t> (256, text_size / 65536 + 1));
+    std::vector<size_t> chunk_begin (nr_chunks + 1, text_size);
+    chunk_begin[0] = 0;
+    for (int k = 1; k < nr_chunks; ++k)
+    {
+      size_t pos = std::max (chunk_begin[k - 1], text_size / nr_chunks * k);
+      while (pos < text_size && text[pos] != '\n')
+        ++pos;
+      chunk_begin[k] = std::min (pos + 1, text_size);
+    }
+
+    // Count the elements of every chunk, to know where each chunk starts in the output arrays
+    std::vector<OBJChunk> chunks (nr_chunks);
+#pragma omp parallel for num_threads(threads)
+    for (int k = 0; k < nr_chunks; ++k)
+      countOBJChunk (&text[chunk_begin[k]], &text[chunk_begin[k + 1]], chunks[k]);
+
+    std::vector<OBJCounts> first (nr_chunks + 1);
+    for (int k = 0; k < nr_chunks; ++k)
+    {
+      first[k + 1].v = first[k].v + chunks[k].counts.v;
+      first[k + 1].vn = first[k].vn + chunks[k].counts.vn;
+      first[k + 1].vt = first[k].vt + chunks[k].counts.vt;
+      first[k + 1].f = first[k].f + chunks[k].counts.f;
+      first[k + 1].refs = first[k].refs + chunks[k].counts.refs;
+      for (size_t i = 0; i < chunks[k].materials.size (); ++i)
+        data.materials.push_back (std::make_pair (first[k].f + chunks[k].materials[i].first, chunks[k].materials[i].second));
+      data.libraries.insert (data.libraries.end (), chunks[k].libraries.begin (), chunks[k].libraries.end ());
+    }
+    const OBJCounts &total = first[nr_chunks];
+    data.vertices.resize (3 * total.v);
+    data.normals.resize (3 * total.vn);
+    data.tex_coords.resize (2 * total.vt);
+    data.face_begin.resize (total.f + 1, 0);
+    data.face_vertices.resize (total.refs);
+    data.face_tex_coords.resize (total.refs);
+
+    // Parse the chunks in parallel
+    std::vector<char> chunk_valid (nr_chunks, 1);
+#pragma omp parallel for num_threads(threads) schedule(dynamic)
+    for (int k = 0; k < nr_chunks; ++k)
+      chunk_valid[k] = parseOBJChunk (&text[chunk_begin[k]], &text[chunk_begin[k + 1]], first[k], data);
+    if (std::find (chunk_valid.begin (), chunk_valid.end (), 0) != chunk_valid.end ())
+    {
+      PCL_ERROR ("[pcl::OBJReader::read] Malformed statement or invalid index in %s!\n", file_name.c_str ());
+      return (-1);
+    }
+
+    // Normals are only kept if there is exactly one per vertex
+    int nr_points = static_cast<int> (total.v);
+    if (total.vn == total.v && total.v > 0)
+    {
+      pcl::PointCloud<pcl::PointNormal> points;
+      points.resize (nr_points);
+#pragma omp parallel for num_threads(threads)
+      for (int i = 0; i < nr_points; ++i)
+      {
+        points[i].x = data.vertices[3 * i];
+        points[i].y = data.vertices[3 * i + 1];
+        points[i].z = data.vertices[3 * i + 2];
+        points[i].normal_x = data.normals[3 * i];
+        points[i].normal_y = data.normals[3 * i + 1];
+        points[i].normal_z = data.normals[3 * i + 2];
+        points[i].curvature = 0.0f;
+      }
+      pcl::toROSMsg (points, cloud);
+    }
+    else
+    {
+      pcl::PointCloud<pcl::PointXYZ> points;
+      points.resize (nr_points);
+#pragma omp parallel for num_threads(threads)
+      for (int i = 0; i < nr_points; ++i)
+      {
+        points[i].x = data.vertices[3 * i];
+        points[i].y = data.vertices[3 * i + 1];
+        points[i].z = data.vertices[3 * i + 2];
+      }
+      pcl::toROSMsg (points, cloud);
+    }
+    return (0);
+  }
+
+  /** \brief Read the materials of a Wavefront material (.mtl) file. */
+  bool
+  readOBJMaterials (const std::string &file_name, std::map<std::string, pcl::TexMaterial> &materials)
+  {
+    std::ifstream fs (file_name.c_str ());
+    if (!fs.is_open () || fs.fail ())
+      return (false);
+    fs.imbue (std::locale::classic ());
+
+    pcl::TexMaterial *material = NULL;
+    std::string line;
+    while (std::getline (fs, line))
+    {
+      std::istringstream is (line);
+      is.imbue (std::locale::classic ());
+      std::string keyword;
+      if (!(is >> keyword))
+        continue;
+      if (keyword == "newmtl")
+      {
+        const char *p = line.c_str () + line.find ("newmtl") + 6;
+        std::string name = getOBJArgument (p, line.c_str () + line.size ());
+        material = &materials[name];
+        material->tex_name = name;
+      }
+      else if (!material)
+        continue;
+      else if (keyword == "Ka")
+        is >> material->tex_Ka.r >> material->tex_Ka.g >> material->tex_Ka.b;
+      else if (keyword == "Kd")
+        is >> material->tex_Kd.r >> material->tex_Kd.g >> material->tex_Kd.b;
+      else if (keyword == "Ks")
+        is >> material->tex_Ks.r >> material->tex_Ks.g >> material->tex_Ks.b;
+      else if (keyword == "d")
+        is >> material->tex_d;
+      else if (keyword == "Ns")
+        is >> material->tex_Ns;
+      else if (keyword == "illum")
+        is >> material->tex_illum;
+      else if (keyword == "map_Kd")
+        is >> material->tex_file;
+    }
+    return (true);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::OBJReader::read (const std::string &file_name, pcl::PolygonMesh &mesh)
+{
+  OBJData data;
+  if (parseOBJFile (file_name, threads_, data, mesh.cloud) < 0)
+    return (-1);
+
+  int nr_faces = static_cast<int> (data.face_begin.size ()) - 1;
+  mesh.polygons.resize (nr_faces);
+#pragma omp parallel for num_threads(threads_)
+  for (int i = 0; i < nr_faces; ++i)
+    mesh.polygons[i].vertices.assign (data.face_vertices.begin () + data.face_begin[i],
+                                      data.face_vertices.begin () + data.face_begin[i + 1]);
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::OBJReader::read (const std::string &file_name, pcl::TextureMesh &mesh)
+{
+  OBJData data;
+  if (parseOBJFile (file_name, threads_, data, mesh.cloud) < 0)
+    return (-1);
+
+  // Every usemtl starts a new sub mesh. Faces preceding the first one get a default material.
+  size_t nr_faces = data.face_begin.size () - 1;
+  std::vector<std::pair<size_t, std::string> > groups;
+  if (data.materials.empty () || data.materials[0].first > 0)
+    groups.push_back (std::make_pair (size_t (0), std::string ()));
+  groups.insert (groups.end (), data.materials.begin (), data.materials.end ());
+  groups.push_back (std::make_pair (nr_faces, std::string ()));
+
+  int nr_meshes = static_cast<int> (groups.size ()) - 1;
+  mesh.tex_polygons.resize (nr_meshes);
+  mesh.tex_coordinates.resize (nr_meshes);
+#pragma omp parallel for num_threads(threads_)
+  for (int m = 0; m < nr_meshes; ++m)
+  {
+    size_t f_begin = groups[m].first, f_end = groups[m + 1].first;
+    std::vector<pcl::Vertices> &polygons = mesh.tex_polygons[m];
+    std::vector<Eigen::Vector2f> &coordinates = mesh.tex_coordinates[m];
+    polygons.resize (f_end - f_begin);
+    coordinates.clear ();
+    coordinates.reserve (data.face_begin[f_end] - data.face_begin[f_begin]);
+    for (size_t i = f_begin; i < f_end; ++i)
+    {
+      polygons[i - f_begin].vertices.assign (data.face_vertices.begin () + data.face_begin[i],
+                                             data.face_vertices.begin () + data.face_begin[i + 1]);
+      for (size_t j = data.face_begin[i]; j < data.face_begin[i + 1]; ++j)
+        if (data.face_tex_coords[j] >= 0)
+          coordinates.push_back (Eigen::Vector2f (data.tex_coords[2 * data.face_tex_coords[j]],
+                                                  data.tex_coords[2 * data.face_tex_coords[j] + 1]));
+    }
+  }
+
+  // Look up the materials in the material libraries
+  std::map<std::string, pcl::TexMaterial> materials;
+  boost::filesystem::path directory = boost::filesystem::path (file_name).parent_path ();
+  for (size_t i = 0; i < data.libraries.size (); ++i)
+    if (!readOBJMaterials ((directory / data.libraries[i]).string (), materials))
+      PCL_WARN ("[pcl::OBJReader::read] Could not read material library %s.\n", data.libraries[i].c_str ());
+
+  mesh.tex_materials.resize (nr_meshes);
+  for (int m = 0; m < nr_meshes; ++m)
+  {
+    std::map<std::string, pcl::TexMaterial>::const_iterator it = materials.find (groups[m].second);
+    if (it != materials.end ())
+      mesh.tex_materials[m] = it->second;
+    else
+    {
+      mesh.tex_materials[m] = pcl::TexMaterial ();
+      mesh.tex_materials[m].tex_name = groups[m].second;
+    }
+  }
+  return (0);
+}
@@ -41,52 +41,73 @@
 #include <pcl/point_types.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/io/tar.h>
-
-#ifdef _WIN32
-# include <io.h>
-# include <windows.h>
-# define pcl_open                    _open
-# define pcl_close(fd)               _close(fd)
-# define pcl_lseek(fd,offset,origin) _lseek(fd,offset,origin)
-#else
-# include <sys/mman.h>
-# define pcl_open                    open
-# define pcl_close(fd)               close(fd)
-# define pcl_lseek(fd,offset,origin) lseek(fd,offset,origin)
-#endif
+#include <boost/filesystem.hpp>
+#include <ctime>
+#include <fstream>
+#include <limits>
+#include <locale>
+#include <map>
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 //////////////////////// GrabberImplementation //////////////////////
 struct pcl::PCDGrabberBase::PCDGrabberImpl
 {
+  /** \brief Where a frame is stored: a PCD file, or a PCD file inside a TAR archive. */
+  struct FrameLocation
+  {
+    FrameLocation (const std::string &file, std::streamoff offset) : file_name (file), data_offset (offset) {}
+    std::string file_name;
+    std::streamoff data_offset;
+  };
+
+  /** \brief A decoded frame. */
+  struct Frame
+  {
+    Frame () : cloud (), origin (), orientation (), valid (false) {}
+    sensor_msgs::PointCloud2 cloud;
+    Eigen::Vector4f origin;
+    Eigen::Quaternionf orientation;
+    bool valid;
+    EIGEN_MAKE_ALIGNED_OPERATOR_NEW
+  };
+  typedef boost::shared_ptr<Frame> FramePtr;
+
   PCDGrabberImpl (pcl::PCDGrabberBase& grabber, const std::string& pcd_path, float frames_per_second, bool repeat);
   PCDGrabberImpl (pcl::PCDGrabberBase& grabber, const std::vector<std::string>& pcd_files, float frames_per_second, bool repeat);
+  ~PCDGrabberImpl ();
   void trigger ();
-  void readAhead ();
-  
-  // TAR reading I/O
-  int openTARFile (const std::string &file_name);
-  void closeTARFile ();
-  bool readTARHeader ();
+
+  // Frame index
+  void buildIndex ();
+  bool indexTARFile (const std::string &file_name);
+  bool loadTARIndex (const std::string &file_name, size_t file_size, std::time_t mtime);
+  void saveTARIndex (const std::string &file_name, size_t file_size, std::time_t mtime, size_t first_frame) const;
+  FramePtr readFrame (size_t frame) const;
+
+  // Prefetching
+  size_t nextFrame (size_t frame) const;
+  bool inWindow (size_t frame) const;
+  void startPrefetching ();
+  void stopPrefetching ();
+  void prefetch ();
 
   pcl::PCDGrabberBase& grabber_;
   float frames_per_second_;
   bool repeat_;
   bool running_;
   std::vector<std::string> pcd_files_;
-  std::vector<std::string>::iterator pcd_iterator_;
   TimeTrigger time_trigger_;
 
-  sensor_msgs::PointCloud2 next_cloud_;
-  Eigen::Vector4f origin_;
-  Eigen::Quaternionf orientation_;
-  bool valid_;
+  std::vector<FrameLocation> frames_;
+  size_t current_frame_;
 
-  // TAR reading I/O
-  int tar_fd_;
-  int tar_offset_;
-  std::string tar_file_;
-  pcl::io::TARHeader tar_header_;
+  size_t prefetch_window_;
+  std::map<size_t, FramePtr> cache_;
+  bool stop_prefetching_;
+  boost::thread prefetch_thread_;
+  mutable boost::mutex mutex_;
+  boost::condition_variable frame_ready_;
+  boost::condition_variable window_changed_;
 
   EIGEN_MAKE_ALIGNED_OPERATOR_NEW 
 };
@@ -98,19 +119,19 @@ pcl::PCDGrabberBase::PCDGrabberImpl::PCDGrabberImpl (pcl::PCDGrabberBase& grabbe
   , repeat_ (repeat)
   , running_ (false)
   , pcd_files_ ()
-  , pcd_iterator_ ()
   , time_trigger_ (1.0 / static_cast<double> (std::max (frames_per_second, 0.001f)), boost::bind (&PCDGrabberImpl::trigger, this))
-  , next_cloud_ ()
-  , origin_ ()
-  , orientation_ ()
-  , valid_ (false)
-  , tar_fd_ (-1)
-  , tar_offset_ (0)
-  , tar_file_ ()
-  , tar_header_ ()
+  , frames_ ()
+  , current_frame_ (0)
+  , prefetch_window_ (0)
+  , cache_ ()
+  , stop_prefetching_ (false)
+  , prefetch_thread_ ()
+  , mutex_ ()
+  , frame_ready_ ()
+  , window_changed_ ()
 {
   pcd_files_.push_back (pcd_path);
-  pcd_iterator_ = pcd_files_.begin ();
+  buildIndex ();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -120,145 +141,271 @@ pcl::PCDGrabberBase::PCDGrabberImpl::PCDGrabberImpl (pcl::PCDGrabberBase& grabbe
   , repeat_ (repeat)
   , running_ (false)
   , pcd_files_ ()
-  , pcd_iterator_ ()
   , time_trigger_ (1.0 / static_cast<double> (std::max (frames_per_second, 0.001f)), boost::bind (&PCDGrabberImpl::trigger, this))
-  , next_cloud_ ()
-  , origin_ ()
-  , orientation_ ()
-  , valid_ (false)
-  , tar_fd_ (-1)
-  , tar_offset_ (0)
-  , tar_file_ ()
-  , tar_header_ ()
+  , frames_ ()
+  , current_frame_ (0)
+  , prefetch_window_ (0)
+  , cache_ ()
+  , stop_prefetching_ (false)
+  , prefetch_thread_ ()
+  , mutex_ ()
+  , frame_ready_ ()
+  , window_changed_ ()
 {
   pcd_files_ = pcd_files;
-  pcd_iterator_ = pcd_files_.begin ();
+  buildIndex ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::PCDGrabberBase::PCDGrabberImpl::~PCDGrabberImpl ()
+{
+  stopPrefetching ();
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 void 
-pcl::PCDGrabberBase::PCDGrabberImpl::readAhead ()
+pcl::PCDGrabberBase::PCDGrabberImpl::buildIndex ()
 {
-  PCDReader reader;
-  int pcd_version;
+  frames_.clear ();
+  for (size_t i = 0; i < pcd_files_.size (); ++i)
+  {
+    // TAR archives are recognized by their first header, anything else is assumed to be a PCD file
+    if (!indexTARFile (pcd_files_[i]))
+      frames_.push_back (FrameLocation (pcd_files_[i], 0));
+  }
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PCDGrabberBase::PCDGrabberImpl::indexTARFile (const std::string &file_name)
+{
+  std::ifstream fs (file_name.c_str (), std::ios::binary);
+  if (!fs.is_open ())
+    return (false);
+
+  pcl::io::TARHeader header;
+  if (!fs.read (reinterpret_cast<char*> (&header), 512) || std::string (header.ustar, 5) != "ustar")
+    return (false);
 
-  // Check if we're still reading files from a TAR file
-  if (tar_fd_ != -1)
+  size_t file_size = 0;
+  std::time_t mtime = 0;
+  try
   {
-    if (!readTARHeader ())
-      return;
-    valid_ = (reader.read (tar_file_, next_cloud_, origin_, orientation_, pcd_version, tar_offset_) == 0);
-    if (!valid_)
-      closeTARFile ();
-    else
-    {
-      tar_offset_ += (tar_header_.getFileSize ()) + (512 - tar_header_.getFileSize () % 512);
-      int result = static_cast<int> (pcl_lseek (tar_fd_, tar_offset_, SEEK_SET));
-      if (result < 0)
-        closeTARFile ();
-    }
+    file_size = static_cast<size_t> (boost::filesystem::file_size (file_name));
+    mtime = boost::filesystem::last_write_time (file_name);
   }
-  // We're not still reading from a TAR file, so check if there are other PCD/TAR files in the list
-  else
+  catch (const boost::filesystem::filesystem_error &)
   {
-    if (pcd_iterator_ != pcd_files_.end ())
-    {
-      // Try to read in the file as a PCD first
-      valid_ = (reader.read (*pcd_iterator_, next_cloud_, origin_, orientation_, pcd_version) == 0);
-
-      // Has an error occured? Check if we can interpret the file as a TAR file first before going onto the next
-      if (!valid_ && openTARFile (*pcd_iterator_) >= 0 && readTARHeader ())
-      {
-        tar_file_ = *pcd_iterator_;
-        valid_ = (reader.read (tar_file_, next_cloud_, origin_, orientation_, pcd_version, tar_offset_) == 0);
-        if (!valid_)
-          closeTARFile ();
-        else
-        {
-          tar_offset_ += (tar_header_.getFileSize ()) + (512 - tar_header_.getFileSize () % 512);
-          int result = static_cast<int> (pcl_lseek (tar_fd_, tar_offset_, SEEK_SET));
-          if (result < 0)
-            closeTARFile ();
-        }
-      }
+  }
+  if (loadTARIndex (file_name, file_size, mtime))
+    return (true);
 
-      if (++pcd_iterator_ == pcd_files_.end () && repeat_)
-        pcd_iterator_ = pcd_files_.begin ();
+  // Walk over the headers, skipping the data
+  size_t first_frame = frames_.size ();
+  std::streamoff offset = 0;
+  while (true)
+  {
+    // We only support regular files in USTAR version 0 files for now.
+    // Addional file types in TAR include: hard links, symbolic links, device/special files, block devices, 
+    // directories, and named pipes.
+    if ((header.file_type[0] != '0' && header.file_type[0] != '\0') ||
+        std::string (header.ustar, 5) != "ustar" || header.getFileSize () == 0)
+      break;
+
+    // PCDReader takes the data offset as an int
+    if (offset + 512 > std::numeric_limits<int>::max ())
+    {
+      PCL_ERROR ("[pcl::PCDGrabber] %s is larger than 2 GiB, only its first %lu frames can be read!\n",
+                 file_name.c_str (), static_cast<unsigned long> (frames_.size () - first_frame));
+      break;
     }
-    else
-      valid_ = false;
+    frames_.push_back (FrameLocation (file_name, offset + 512));
+    offset += 512 + (static_cast<std::streamoff> (header.getFileSize ()) + 511) / 512 * 512;
+    fs.seekg (offset);
+    if (!fs.read (reinterpret_cast<char*> (&header), 512))
+      break;
   }
+  saveTARIndex (file_name, file_size, mtime, first_frame);
+  return (true);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 bool
-pcl::PCDGrabberBase::PCDGrabberImpl::readTARHeader ()
+pcl::PCDGrabberBase::PCDGrabberImpl::loadTARIndex (const std::string &file_name, size_t file_size, std::time_t mtime)
 {
-  // Read in the header
-  int result = static_cast<int> (::read (tar_fd_, reinterpret_cast<char*> (&tar_header_), 512));
-  if (result == -1)
-  {
-    closeTARFile ();
+  std::ifstream fs ((file_name + ".idx").c_str ());
+  if (!fs.is_open ())
     return (false);
-  }
-
-  // We only support regular files for now. 
-  // Addional file types in TAR include: hard links, symbolic links, device/special files, block devices, 
-  // directories, and named pipes.
-  if (tar_header_.file_type[0] != '0' && tar_header_.file_type[0] != '\0')
-  {
-    closeTARFile ();
+  fs.imbue (std::locale::classic ());
+
+  // The index is only valid for the archive it was built from
+  std::string magic;
+  size_t index_file_size, nr_frames;
+  std::time_t index_mtime;
+  fs >> magic >> index_file_size >> index_mtime >> nr_frames;
+  if (!fs || magic != "PCD_TAR_INDEX_V1" || index_file_size != file_size || index_mtime != mtime)
     return (false);
-  }
 
-  // We only support USTAR version 0 files for now
-  if (std::string (tar_header_.ustar).substr (0, 5) != "ustar")
+  std::vector<FrameLocation> frames;
+  frames.reserve (nr_frames);
+  for (size_t i = 0; i < nr_frames; ++i)
   {
-    closeTARFile ();
-    return (false);
+    std::streamoff offset;
+    if (!(fs >> offset) || offset < 0 || offset > std::numeric_limits<int>::max ())
+      return (false);
+    frames.push_back (FrameLocation (file_name, offset));
   }
+  frames_.insert (frames_.end (), frames.begin (), frames.end ());
+  return (true);
+}
 
-  if (tar_header_.getFileSize () == 0)
-  {
-    closeTARFile ();
-    return (false);
-  }
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDGrabberBase::PCDGrabberImpl::saveTARIndex (const std::string &file_name, size_t file_size, std::time_t mtime, size_t first_frame) const
+{
+  // Not being able to cache the index (e.g., read-only media) only costs a rescan next time
+  std::ofstream fs ((file_name + ".idx").c_str ());
+  if (!fs.is_open ())
+    return;
+  fs.imbue (std::locale::classic ());
+  fs << "PCD_TAR_INDEX_V1\n" << file_size << " " << mtime << "\n" << frames_.size () - first_frame << "\n";
+  for (size_t i = first_frame; i < frames_.size (); ++i)
+    fs << frames_[i].data_offset << "\n";
+}
 
-  tar_offset_ += 512;
+///////////////////////////////////////////////////////////////////////////////////////////
+pcl::PCDGrabberBase::PCDGrabberImpl::FramePtr
+pcl::PCDGrabberBase::PCDGrabberImpl::readFrame (size_t frame) const
+{
+  FramePtr result (new Frame);
+  PCDReader reader;
+  int pcd_version;
+  result->valid = (reader.read (frames_[frame].file_name, result->cloud, result->origin, result->orientation, 
+                                pcd_version, static_cast<int> (frames_[frame].data_offset)) == 0);
+  return (result);
+}
 
-  return (true);
+///////////////////////////////////////////////////////////////////////////////////////////
+size_t
+pcl::PCDGrabberBase::PCDGrabberImpl::nextFrame (size_t frame) const
+{
+  if (++frame == frames_.size () && repeat_)
+    frame = 0;
+  return (frame);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PCDGrabberBase::PCDGrabberImpl::inWindow (size_t frame) const
+{
+  size_t distance = frame >= current_frame_ ? frame - current_frame_ : 
+                                              (repeat_ ? frame + frames_.size () - current_frame_ : frames_.size ());
+  return (distance < prefetch_window_);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 void
-pcl::PCDGrabberBase::PCDGrabberImpl::closeTARFile ()
+pcl::PCDGrabberBase::PCDGrabberImpl::startPrefetching ()
 {
-  pcl_close (tar_fd_);
-  tar_fd_ = -1;
-  tar_offset_ = 0;
-  memset (&tar_header_.file_name[0], 0, 512);
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    stop_prefetching_ = false;
+  }
+  prefetch_thread_ = boost::thread (&PCDGrabberImpl::prefetch, this);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
-int
-pcl::PCDGrabberBase::PCDGrabberImpl::openTARFile (const std::string &file_name)
+void
+pcl::PCDGrabberBase::PCDGrabberImpl::stopPrefetching ()
 {
-  tar_fd_ = pcl_open (file_name.c_str (), O_RDONLY);
-  if (tar_fd_ == -1)
-    return (-1);
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    stop_prefetching_ = true;
+    window_changed_.notify_all ();
+    frame_ready_.notify_all ();
+  }
+  if (prefetch_thread_.joinable ())
+    prefetch_thread_.join ();
+  boost::mutex::scoped_lock lock (mutex_);
+  cache_.clear ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDGrabberBase::PCDGrabberImpl::prefetch ()
+{
+  boost::mutex::scoped_lock lock (mutex_);
+  while (!stop_prefetching_)
+  {
+    // Forget the frames that fell out of the window
+    for (std::map<size_t, FramePtr>::iterator it = cache_.begin (); it != cache_.end ();)
+    {
+      if (inWindow (it->first))
+        ++it;
+      else
+        cache_.erase (it++);
+    }
+
+    // Decode the first missing frame of the window
+    size_t frame = current_frame_;
+    for (size_t i = 0; i < prefetch_window_ && frame < frames_.size () && cache_.count (frame) != 0; ++i)
+      frame = nextFrame (frame);
+    if (frame >= frames_.size () || cache_.count (frame) != 0 || !inWindow (frame))
+    {
+      window_changed_.wait (lock);
+      continue;
+    }
 
-  return (0);
+    lock.unlock ();
+    FramePtr decoded = readFrame (frame);
+    lock.lock ();
+    // The window may have moved (seek) while decoding
+    if (inWindow (frame))
+    {
+      cache_[frame] = decoded;
+      frame_ready_.notify_all ();
+    }
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
 void 
 pcl::PCDGrabberBase::PCDGrabberImpl::trigger ()
 {
-  if (valid_)
-    grabber_.publish (next_cloud_,origin_,orientation_);
+  size_t frame;
+  FramePtr decoded;
+  {
+    boost::mutex::scoped_lock lock (mutex_);
+    while (true)
+    {
+      frame = current_frame_;
+      if (frame >= frames_.size () || prefetch_window_ == 0 || stop_prefetching_)
+        break;
+      std::map<size_t, FramePtr>::iterator it = cache_.find (frame);
+      if (it != cache_.end ())
+      {
+        decoded = it->second;
+        break;
+      }
+      window_changed_.notify_all ();
+      frame_ready_.wait (lock);
+    }
+    if (frame >= frames_.size ())
+      return;
+  }
 
-  // use remaining time, if there is time left!
-  readAhead ();
+  if (!decoded)
+    decoded = readFrame (frame);
+  if (decoded->valid)
+    grabber_.publish (decoded->cloud, decoded->origin, decoded->orientation);
+
+  boost::mutex::scoped_lock lock (mutex_);
+  // Do not override a seek which happened while publishing
+  if (current_frame_ == frame)
+  {
+    current_frame_ = nextFrame (frame);
+    window_changed_.notify_all ();
+  }
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -332,7 +479,7 @@ pcl::PCDGrabberBase::getName () const
 void 
 pcl::PCDGrabberBase::rewind ()
 {
-  impl_->pcd_iterator_ = impl_->pcd_files_.begin ();
+  seek (0);
 }
 
 ///////////////////////////////////////////////////////////////////////////////////////////
@@ -349,3 +496,50 @@ pcl::PCDGrabberBase::isRepeatOn () const
   return (impl_->repeat_);
 }
 
+
+///////////////////////////////////////////////////////////////////////////////////////////
+size_t
+pcl::PCDGrabberBase::getNumberOfFrames () const
+{
+  return (impl_->frames_.size ());
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+size_t
+pcl::PCDGrabberBase::getCurrentFrame () const
+{
+  boost::mutex::scoped_lock lock (impl_->mutex_);
+  return (impl_->current_frame_);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PCDGrabberBase::seek (size_t frame)
+{
+  if (frame >= impl_->frames_.size () && frame != 0)
+    return (false);
+  boost::mutex::scoped_lock lock (impl_->mutex_);
+  impl_->current_frame_ = frame;
+  impl_->window_changed_.notify_all ();
+  return (true);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDGrabberBase::setPrefetchWindow (size_t nr_frames)
+{
+  impl_->stopPrefetching ();
+  {
+    boost::mutex::scoped_lock lock (impl_->mutex_);
+    impl_->prefetch_window_ = nr_frames;
+  }
+  if (nr_frames > 0)
+    impl_->startPrefetching ();
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////
+size_t
+pcl::PCDGrabberBase::getPrefetchWindow () const
+{
+  return (impl_->prefetch_window_);
+}
@@ -45,9 +45,13 @@
 #include <pcl/common/io.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/io/lzf.h>
+#include <pcl/io/number_parser.h>
 
+#include <algorithm>
+#include <cmath>
 #include <cstring>
 #include <cerrno>
+#include <limits>
 
 #ifdef _WIN32
 # include <io.h>
@@ -115,6 +119,7 @@ pcl::PCDReader::readHeader (const std::string &file_name, sensor_msgs::PointClou
   orientation = Eigen::Quaternionf::Identity ();
   cloud.width = cloud.height = cloud.point_step = cloud.row_step = 0;
   cloud.data.clear ();
+  column_offsets_.clear ();
 
   // By default, assume that there are _no_ invalid (e.g., NaN) points
   //cloud.is_dense = true;
@@ -317,8 +322,6 @@ pcl::PCDReader::readHeader (const std::string &file_name, sensor_msgs::PointClou
       if (line_type.substr (0, 6) == "POINTS")
       {
         sstream >> nr_points;
-        // Need to allocate: N * point_step
-        cloud.data.resize (nr_points * cloud.point_step);
         continue;
       }
 
@@ -326,7 +329,19 @@ pcl::PCDReader::readHeader (const std::string &file_name, sensor_msgs::PointClou
       if (line_type.substr (0, 4) == "DATA")
       {
         data_idx = static_cast<int> (fs.tellg ());
-        if (st.at (1).substr (0, 17) == "binary_compressed")
+        if (st.at (1) == "columnar")
+        {
+          // The offsets of the columns follow the data type
+          data_type = 4;
+          std::string columnar;
+          size_t column_offset;
+          sstream >> columnar;
+          while (sstream >> column_offset)
+            column_offsets_.push_back (column_offset);
+        }
+        else if (st.at (1).substr (0, 25) == "binary_compressed_chunked")
+          data_type = 3;
+        else if (st.at (1).substr (0, 17) == "binary_compressed")
          data_type = 2;
         else
           if (st.at (1).substr (0, 6) == "binary")
@@ -593,8 +608,6 @@ pcl::PCDReader::readHeader (const std::string &file_name, sensor_msgs::PointClou
       if (line_type.substr (0, 6) == "POINTS")
       {
         sstream >> nr_points;
-        // Need to allocate: N * point_step
-        cloud.data.resize (nr_points * cloud.point_step);
         continue;
       }
       break;
@@ -668,6 +681,7 @@ pcl::PCDReader::readHeaderEigen (const std::string &file_name, pcl::PointCloud<E
   cloud.properties.sensor_orientation = Eigen::Quaternionf::Identity ();
   cloud.width = cloud.height = 0;
   cloud.points.resize (0, 0);
+  column_offsets_.clear ();
 
   // By default, assume that there are _no_ invalid (e.g., NaN) points
   //cloud.is_dense = true;
@@ -862,7 +876,19 @@ pcl::PCDReader::readHeaderEigen (const std::string &file_name, pcl::PointCloud<E
       if (line_type.substr (0, 4) == "DATA")
       {
         data_idx = static_cast<int> (fs.tellg ());
-        if (st.at (1).substr (0, 17) == "binary_compressed")
+        if (st.at (1) == "columnar")
+        {
+          // The offsets of the columns follow the data type
+          data_type = 4;
+          std::string columnar;
+          size_t column_offset;
+          sstream >> columnar;
+          while (sstream >> column_offset)
+            column_offsets_.push_back (column_offset);
+        }
+        else if (st.at (1).substr (0, 25) == "binary_compressed_chunked")
+          data_type = 3;
+        else if (st.at (1).substr (0, 17) == "binary_compressed")
          data_type = 2;
         else
           if (st.at (1).substr (0, 6) == "binary")
@@ -919,151 +945,337 @@ pcl::PCDReader::readHeaderEigen (const std::string &file_name, pcl::PointCloud<E
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
-int
-pcl::PCDReader::read (const std::string &file_name, sensor_msgs::PointCloud2 &cloud,
-                      Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, int &pcd_version, 
-                      const int offset)
+namespace
 {
-  int data_type;
-  unsigned int data_idx;
-
-  int res = readHeader (file_name, cloud, origin, orientation, pcd_version, data_type, data_idx, offset);
-
-  if (res < 0)
-    return (res);
-
-  unsigned int idx = 0;
-
-  // Get the number of points the cloud should have
-  unsigned int nr_points = cloud.width * cloud.height;
-
-  // Setting the is_dense property to true by default
-  cloud.is_dense = true;
-
-  if (file_name == "" || !boost::filesystem::exists (file_name))
+  inline bool
+  isASCIISpace (char c)
   {
-    PCL_ERROR ("[pcl::PCDReader::read] Could not find file '%s'.\n", file_name.c_str ());
-    return (-1);
+    return (c == ' ' || c == '\t' || c == '\r');
   }
-  
-  // if ascii
-  if (data_type == 0)
+
+  /** \brief Parse one ascii value of type T. Uncommon forms go through copyStringValue. */
+  template <typename T> void
+  parseASCIIValue (const char *begin, const char *end, sensor_msgs::PointCloud2 &cloud,
+                   unsigned int point_index, unsigned int field_idx, unsigned int fields_count, bool &is_dense)
   {
-    // Re-open the file (readHeader closes it)
-    std::ifstream fs;
-    fs.open (file_name.c_str ());
-    if (!fs.is_open () || fs.fail ())
+    T value;
+    if (end - begin == 3 && begin[0] == 'n' && begin[1] == 'a' && begin[2] == 'n')
     {
-      PCL_ERROR ("[pcl::PCDReader::read] Could not open file %s.\n", file_name.c_str ());
-      return (-1);
+      value = std::numeric_limits<T>::quiet_NaN ();
+      is_dense = false;
     }
+    else if (!pcl::io::parseNumber (begin, end, value))
+    {
+      pcl::copyStringValue<T> (std::string (begin, end), cloud, point_index, field_idx, fields_count);
+      return;
+    }
+    memcpy (&cloud.data[point_index * cloud.point_step + 
+                        cloud.fields[field_idx].offset + 
+                        fields_count * sizeof (T)], reinterpret_cast<char*> (&value), sizeof (T));
+  }
 
-    fs.seekg (data_idx);
-
-    std::string line;
-    std::vector<std::string> st;
+  /** \brief Count the non empty lines in [begin, end). */
+  unsigned int
+  countASCIILines (const char *begin, const char *end)
+  {
+    unsigned int nr_lines = 0;
+    bool empty = true;
+    for (const char *p = begin; p != end; ++p)
+    {
+      if (*p == '\n')
+      {
+        if (!empty)
+          ++nr_lines;
+        empty = true;
+      }
+      else if (!isASCIISpace (*p))
+        empty = false;
+    }
+    return (nr_lines + (empty ? 0 : 1));
+  }
 
-    // Read the rest of the file
-    try
+  /** \brief Parse the non empty lines in [begin, end) as the points starting at
+    * \a point_index. Lines beyond the size of the cloud are ignored.
+    * \return false if a line has fewer values than the fields require
+    */
+  bool
+  parseASCIILines (const char *begin, const char *end, unsigned int point_index,
+                   sensor_msgs::PointCloud2 &cloud, bool &is_dense)
+  {
+    const unsigned int nr_points = cloud.width * cloud.height;
+    const char *p = begin;
+    while (p != end && point_index < nr_points)
     {
-      while (idx < nr_points && !fs.eof ())
+      const char *line_end = p;
+      while (line_end != end && *line_end != '\n')
+        ++line_end;
+      const char *token = p;
+      while (token != line_end && isASCIISpace (*token))
+        ++token;
+      if (token == line_end)
       {
-        getline (fs, line);
-        // Ignore empty lines
-        if (line == "")
-          continue;
+        p = (line_end == end) ? end : line_end + 1;
+        continue;
+      }
 
-        // Tokenize the line
-        boost::trim (line);
-        boost::split (st, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
-        
-        if (idx >= nr_points)
+      for (unsigned int d = 0; d < static_cast<unsigned int> (cloud.fields.size ()); ++d)
+      {
+        for (unsigned int c = 0; c < cloud.fields[d].count; ++c)
         {
-          PCL_WARN ("[pcl::PCDReader::read] input file %s has more points (%d) than advertised (%d)!\n", file_name.c_str (), idx, nr_points);
-          break;
-        }
+          while (token != line_end && isASCIISpace (*token))
+            ++token;
+          if (token == line_end)
+            return (false);
+          const char *token_end = token;
+          while (token_end != line_end && !isASCIISpace (*token_end))
+            ++token_end;
 
-        size_t total = 0;
-        // Copy data
-        for (unsigned int d = 0; d < static_cast<unsigned int> (cloud.fields.size ()); ++d)
-        {
           // Ignore invalid padded dimensions that are inherited from binary data
-          if (cloud.fields[d].name == "_")
-          {
-            total += cloud.fields[d].count; // jump over this many elements in the string token
-            continue;
-          }
-          for (unsigned int c = 0; c < cloud.fields[d].count; ++c)
+          if (cloud.fields[d].name != "_")
           {
             switch (cloud.fields[d].datatype)
             {
               case sensor_msgs::PointField::INT8:
-              {
-                copyStringValue<pcl::traits::asType<sensor_msgs::PointField::INT8>::type> (
-                    st.at (total + c), cloud, idx, d, c);
+                parseASCIIValue<pcl::traits::asType<sensor_msgs::PointField::INT8>::type> (token, token_end, cloud, point_index, d, c, is_dense);
                 break;
-              }
               case sensor_msgs::PointField::UINT8:
-              {
-                copyStringValue<pcl::traits::asType<sensor_msgs::PointField::UINT8>::type> (
-                    st.at (total + c), cloud, idx, d, c);
+                parseASCIIValue<pcl::traits::asType<sensor_msgs::PointField::UINT8>::type> (token, token_end, cloud, point_index, d, c, is_dense);
                 break;
-              }
               case sensor_msgs::PointField::INT16:
-              {
-                copyStringValue<pcl::traits::asType<sensor_msgs::PointField::INT16>::type> (
-                    st.at (total + c), cloud, idx, d, c);
+                parseASCIIValue<pcl::traits::asType<sensor_msgs::PointField::INT16>::type> (token, token_end, cloud, point_index, d, c, is_dense);
                 break;
-              }
               case sensor_msgs::PointField::UINT16:
-              {
-                copyStringValue<pcl::traits::asType<sensor_msgs::PointField::UINT16>::type> (
-                    st.at (total + c), cloud, idx, d, c);
+                parseASCIIValue<pcl::traits::asType<sensor_msgs::PointField::UINT16>::type> (token, token_end, cloud, point_index, d, c, is_dense);
                 break;
-              }
               case sensor_msgs::PointField::INT32:
-              {
-                copyStringValue<pcl::traits::asType<sensor_msgs::PointField::INT32>::type> (
-                    st.at (total + c), cloud, idx, d, c);
+                parseASCIIValue<pcl::traits::asType<sensor_msgs::PointField::INT32>::type> (token, token_end, cloud, point_index, d, c, is_dense);
                 break;
-              }
               case sensor_msgs::PointField::UINT32:
-              {
-                copyStringValue<pcl::traits::asType<sensor_msgs::PointField::UINT32>::type> (
-                    st.at (total + c), cloud, idx, d, c);
+                parseASCIIValue<pcl::traits::asType<sensor_msgs::PointField::UINT32>::type> (token, token_end, cloud, point_index, d, c, is_dense);
                 break;
-              }
               case sensor_msgs::PointField::FLOAT32:
-              {
-                copyStringValue<pcl::traits::asType<sensor_msgs::PointField::FLOAT32>::type> (
-                    st.at (total + c), cloud, idx, d, c);
+                parseASCIIValue<pcl::traits::asType<sensor_msgs::PointField::FLOAT32>::type> (token, token_end, cloud, point_index, d, c, is_dense);
                 break;
-              }
               case sensor_msgs::PointField::FLOAT64:
-              {
-                copyStringValue<pcl::traits::asType<sensor_msgs::PointField::FLOAT64>::type> (
-                    st.at (total + c), cloud, idx, d, c);
+                parseASCIIValue<pcl::traits::asType<sensor_msgs::PointField::FLOAT64>::type> (token, token_end, cloud, point_index, d, c, is_dense);
                 break;
-              }
               default:
                 PCL_WARN ("[pcl::PCDReader::read] Incorrect field data type specified (%d)!\n",cloud.fields[d].datatype);
                 break;
             }
           }
-          total += cloud.fields[d].count; // jump over this many elements in the string token
+          token = token_end;
         }
-        idx++;
       }
+      ++point_index;
+      p = (line_end == end) ? end : line_end + 1;
     }
-    catch (const char *exception)
+    return (true);
+  }
+
+  /** \brief A column of a columnar file, and where it goes in the points. */
+  struct ColumnCopy
+  {
+    /** \brief The offset of the column, relative to the start of the data. */
+    size_t column_offset;
+    /** \brief The size of one value of the column (field size * count). */
+    size_t size;
+    /** \brief The offset of the field in the resultant points. */
+    size_t point_offset;
+  };
+
+  /** \brief Restrict the fields of a columnar cloud header to \a fields (all
+    * of them if empty) and repack them, computing the columns to read.
+    * \return false if the number of offsets does not match the number of fields
+    */
+  bool
+  selectColumns (sensor_msgs::PointCloud2 &cloud, const std::vector<size_t> &offsets,
+                 const std::vector<std::string> &fields, std::vector<ColumnCopy> &columns, size_t &columns_end)
+  {
+    const size_t nr_points = static_cast<size_t> (cloud.width) * cloud.height;
+    std::vector<sensor_msgs::PointField> kept_fields;
+    size_t column = 0, point_step = 0;
+    columns.clear ();
+    columns_end = 0;
+    for (size_t d = 0; d < cloud.fields.size (); ++d)
     {
-      PCL_ERROR ("[pcl::PCDReader::read] %s\n", exception);
-      fs.close ();
+      if (cloud.fields[d].name == "_")
+        continue;
+      if (column >= offsets.size ())
+        return (false);
+      ColumnCopy copy;
+      copy.column_offset = offsets[column++];
+      copy.size = cloud.fields[d].count * pcl::getFieldSize (cloud.fields[d].datatype);
+      copy.point_offset = point_step;
+      if (!fields.empty () && std::find (fields.begin (), fields.end (), cloud.fields[d].name) == fields.end ())
+        continue;
+      columns.push_back (copy);
+      columns_end = std::max (columns_end, copy.column_offset + copy.size * nr_points);
+      kept_fields.push_back (cloud.fields[d]);
+      kept_fields.back ().offset = static_cast<uint32_t> (point_step);
+      point_step += copy.size;
+    }
+    if (column != offsets.size ())
+      return (false);
+
+    cloud.fields = kept_fields;
+    cloud.point_step = static_cast<uint32_t> (point_step);
+    cloud.row_step = cloud.point_step * cloud.width;
+    return (true);
+  }
+
+  /** \brief Only keep the given \a fields (all of them if empty) of a cloud,
+    * repacking the point data. */
+  void
+  extractFields (sensor_msgs::PointCloud2 &cloud, const std::vector<std::string> &fields)
+  {
+    if (fields.empty ())
+      return;
+
+    std::vector<sensor_msgs::PointField> kept_fields;
+    std::vector<size_t> sizes, old_offsets;
+    size_t point_step = 0;
+    for (size_t d = 0; d < cloud.fields.size (); ++d)
+    {
+      if (std::find (fields.begin (), fields.end (), cloud.fields[d].name) == fields.end ())
+        continue;
+      sizes.push_back (cloud.fields[d].count * pcl::getFieldSize (cloud.fields[d].datatype));
+      old_offsets.push_back (cloud.fields[d].offset);
+      kept_fields.push_back (cloud.fields[d]);
+      kept_fields.back ().offset = static_cast<uint32_t> (point_step);
+      point_step += sizes.back ();
+    }
+    if (kept_fields.size () == cloud.fields.size ())
+      return;
+
+    const size_t nr_points = static_cast<size_t> (cloud.width) * cloud.height;
+    std::vector<pcl::uint8_t> data (nr_points * point_step);
+    for (size_t i = 0; i < nr_points; ++i)
+      for (size_t d = 0; d < kept_fields.size (); ++d)
+        memcpy (&data[i * point_step + kept_fields[d].offset], 
+                &cloud.data[i * cloud.point_step + old_offsets[d]], sizes[d]);
+
+    cloud.data.swap (data);
+    cloud.fields = kept_fields;
+    cloud.point_step = static_cast<uint32_t> (point_step);
+    cloud.row_step = cloud.point_step * cloud.width;
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDReader::read (const std::string &file_name, sensor_msgs::PointCloud2 &cloud,
+                      Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, int &pcd_version, 
+                      const int offset)
+{
+  return (readFields (file_name, cloud, origin, orientation, pcd_version, offset, field_subset_, true));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDReader::readFields (const std::string &file_name, sensor_msgs::PointCloud2 &cloud,
+                            Eigen::Vector4f &origin, Eigen::Quaternionf &orientation, int &pcd_version, 
+                            const int offset, const std::vector<std::string> &fields, bool extract)
+{
+  int data_type;
+  unsigned int data_idx;
+
+  int res = readHeader (file_name, cloud, origin, orientation, pcd_version, data_type, data_idx, offset);
+
+  if (res < 0)
+    return (res);
+
+  // Columnar files: only keep the requested fields, the other columns are never read
+  std::vector<ColumnCopy> columns;
+  size_t columns_end = 0;
+  if (data_type == 4)
+  {
+    if (!selectColumns (cloud, column_offsets_, fields, columns, columns_end) || 
+        boost::filesystem::file_size (file_name) < data_idx + columns_end)
+    {
+      PCL_ERROR ("[pcl::PCDReader::read] Invalid column offsets in %s!\n", file_name.c_str ());
       return (-1);
     }
+  }
 
-    // Close file
+  unsigned int idx = 0;
+
+  // Get the number of points the cloud should have
+  unsigned int nr_points = cloud.width * cloud.height;
+
+  // Need to allocate: N * point_step
+  cloud.data.resize (static_cast<size_t> (nr_points) * cloud.point_step);
+
+  // Setting the is_dense property to true by default
+  cloud.is_dense = true;
+
+  if (file_name == "" || !boost::filesystem::exists (file_name))
+  {
+    PCL_ERROR ("[pcl::PCDReader::read] Could not find file '%s'.\n", file_name.c_str ());
+    return (-1);
+  }
+  
+  // if ascii
+  if (data_type == 0)
+  {
+    // Re-open the file (readHeader closes it), and load the text at once
+    std::ifstream fs;
+    fs.open (file_name.c_str (), std::ios::binary);
+    if (!fs.is_open () || fs.fail ())
+    {
+      PCL_ERROR ("[pcl::PCDReader::read] Could not open file %s.\n", file_name.c_str ());
+      return (-1);
+    }
+    fs.seekg (0, std::ios::end);
+    size_t text_size = static_cast<size_t> (fs.tellg ()) - data_idx;
+    std::vector<char> text (text_size + 1, '\n');
+    fs.seekg (data_idx);
+    if (text_size > 0)
+      fs.read (&text[0], text_size);
     fs.close ();
+
+    // Split the text into line aligned chunks
+    int nr_chunks = static_cast<int> (std::min<size_t> (256, text_size / 65536 + 1));
+    std::vector<size_t> chunk_begin (nr_chunks + 1, text_size);
+    chunk_begin[0] = 0;
+    for (int k = 1; k < nr_chunks; ++k)
+    {
+      size_t pos = std::max (chunk_begin[k - 1], text_size / nr_chunks * k);
+      while (pos < text_size && text[pos] != '\n')
+        ++pos;
+      chunk_begin[k] = std::min (pos + 1, text_size);
+    }
+
+    // Count the points in every chunk, to know where each chunk starts in the cloud
+    std::vector<unsigned int> chunk_points (nr_chunks + 1, 0);
+#pragma omp parallel for num_threads(threads_)
+    for (int k = 0; k < nr_chunks; ++k)
+      chunk_points[k + 1] = countASCIILines (&text[chunk_begin[k]], &text[chunk_begin[k + 1]]);
+    for (int k = 0; k < nr_chunks; ++k)
+      chunk_points[k + 1] += chunk_points[k];
+    idx = std::min (chunk_points[nr_chunks], nr_points);
+    if (chunk_points[nr_chunks] > nr_points)
+      PCL_WARN ("[pcl::PCDReader::read] input file %s has more points (%u) than advertised (%u)!\n", file_name.c_str (), chunk_points[nr_chunks], nr_points);
+
+    // Parse the chunks in parallel
+    std::vector<char> chunk_dense (nr_chunks, 1), chunk_valid (nr_chunks, 1);
+#pragma omp parallel for num_threads(threads_) schedule(dynamic)
+    for (int k = 0; k < nr_chunks; ++k)
+    {
+      bool is_dense = true;
+      chunk_valid[k] = parseASCIILines (&text[chunk_begin[k]], &text[chunk_begin[k + 1]], chunk_points[k], cloud, is_dense);
+      chunk_dense[k] = is_dense;
+    }
+    for (int k = 0; k < nr_chunks; ++k)
+    {
+      if (!chunk_valid[k])
+      {
+        PCL_ERROR ("[pcl::PCDReader::read] Not enough values on a line of %s!\n", file_name.c_str ());
+        return (-1);
+      }
+      if (!chunk_dense[k])
+        cloud.is_dense = false;
+    }
   }
   else 
   /// ---[ Binary mode only
@@ -1086,7 +1298,7 @@ pcl::PCDReader::read (const std::string &file_name, sensor_msgs::PointCloud2 &cl
       return (-1);
     }
     
-    size_t data_size = data_idx + cloud.data.size ();
+    size_t data_size = data_idx + (data_type == 4 ? columns_end : cloud.data.size ());
     // Prepare the map
 #ifdef _WIN32
     // map te whole file
@@ -1114,7 +1326,7 @@ pcl::PCDReader::read (const std::string &file_name, sensor_msgs::PointCloud2 &cl
 #endif
 
     /// ---[ Binary compressed mode only
-    if (data_type == 2)
+    if (data_type == 2 || data_type == 3)
     {
       // Uncompress the data first
       unsigned int compressed_size, uncompressed_size;
@@ -1122,16 +1334,16 @@ pcl::PCDReader::read (const std::string &file_name, sensor_msgs::PointCloud2 &cl
       memcpy (&uncompressed_size, &map[data_idx + 4], sizeof (unsigned int));
       PCL_DEBUG ("[pcl::PCDReader::read] Read a binary compressed file with %u bytes compressed and %u original.\n", compressed_size, uncompressed_size);
       // For all those weird situations where the compressed data is actually LARGER than the uncompressed one
-      // (we really ought to check this in the compressor and copy the original data in those cases)
-      if (data_size < compressed_size)
+      // (chunked files store incompressible blocks verbatim, plus a block table)
+      if (data_size < data_idx + 8 + compressed_size)
       {
 #if _WIN32
         UnmapViewOfFile (map);
-        data_size = compressed_size;
+        data_size = data_idx + 8 + compressed_size;
         map = static_cast<char*>(MapViewOfFile (fm, FILE_MAP_READ, 0, 0, data_size));
 #else
         munmap (map, data_size);
-        data_size = compressed_size;
+        data_size = data_idx + 8 + compressed_size;
         map = static_cast<char*> (mmap (0, data_size, PROT_READ, MAP_SHARED, fd, 0));
 #endif
       }
@@ -1143,11 +1355,20 @@ pcl::PCDReader::read (const std::string &file_name, sensor_msgs::PointCloud2 &cl
         cloud.data.resize (uncompressed_size);
       }
 
-      char *buf = static_cast<char*> (malloc (data_size));
+      char *buf = static_cast<char*> (malloc (uncompressed_size));
       // The size of the uncompressed data better be the same as what we stored in the header
-      if (pcl::lzfDecompress (&map[data_idx + 8], compressed_size, buf, static_cast<unsigned int> (data_size)) != uncompressed_size)
+      unsigned int decompressed_size = (data_type == 3) ?
+        pcl::lzfDecompressChunked (&map[data_idx + 8], compressed_size, buf, uncompressed_size, threads_) :
+        pcl::lzfDecompress (&map[data_idx + 8], compressed_size, buf, uncompressed_size);
+      if (decompressed_size != uncompressed_size)
       {
         free (buf);
+#if _WIN32
+        UnmapViewOfFile (map);
+        CloseHandle (fm);
+#else
+        munmap (map, data_size);
+#endif
         pcl_close (fd);
         PCL_ERROR ("[pcl::PCDReader::read] Size of decompressed lzf data does not match value stored in PCD header\n");
         return (-1);
@@ -1170,27 +1391,40 @@ pcl::PCDReader::read (const std::string &file_name, sensor_msgs::PointCloud2 &cl
       fields_sizes.resize (nri);
 
       // Unpack the xxyyzz to xyz
-      std::vector<char*> pters (fields.size ());
-      int toff = 0;
-      for (size_t i = 0; i < pters.size (); ++i)
+      std::vector<size_t> plane_offsets (fields.size ());
+      size_t toff = 0;
+      for (size_t i = 0; i < plane_offsets.size (); ++i)
       {
-        pters[i] = &buf[toff];
-        toff += fields_sizes[i] * cloud.width * cloud.height;
+        plane_offsets[i] = toff;
+        toff += static_cast<size_t> (fields_sizes[i]) * cloud.width * cloud.height;
       }
       // Copy it to the cloud
-      for (size_t i = 0; i < cloud.width * cloud.height; ++i)
+#pragma omp parallel for num_threads(threads_)
+      for (int i = 0; i < static_cast<int> (cloud.width * cloud.height); ++i)
       {
-        for (size_t j = 0; j < pters.size (); ++j)
-        {
-          memcpy (&cloud.data[i * fsize + fields[j].offset], pters[j], fields_sizes[j]);
-          // Increment the pointer
-          pters[j] += fields_sizes[j];
-        }
+        for (size_t j = 0; j < plane_offsets.size (); ++j)
+          memcpy (&cloud.data[static_cast<size_t> (i) * fsize + fields[j].offset], 
+                  &buf[plane_offsets[j] + static_cast<size_t> (i) * fields_sizes[j]], fields_sizes[j]);
       }
       //memcpy (&cloud.data[0], &buf[0], uncompressed_size);
 
       free (buf);
     }
+    /// ---[ Columnar mode only
+    else if (data_type == 4)
+    {
+      // Scatter the XXYYZZ columns to XYZ points
+      const int nr_points_int = static_cast<int> (nr_points);
+      for (size_t c = 0; c < columns.size (); ++c)
+      {
+        const char *column = &map[data_idx + columns[c].column_offset];
+        const size_t size = columns[c].size, point_offset = columns[c].point_offset;
+#pragma omp parallel for num_threads(threads_)
+        for (int i = 0; i < nr_points_int; ++i)
+          memcpy (&cloud.data[static_cast<size_t> (i) * cloud.point_step + point_offset], 
+                  column + static_cast<size_t> (i) * size, size);
+      }
+    }
     else
       // Copy the data
       memcpy (&cloud.data[0], &map[0] + data_idx, cloud.data.size ());
@@ -1218,7 +1452,11 @@ pcl::PCDReader::read (const std::string &file_name, sensor_msgs::PointCloud2 &cl
 
   // No need to do any extra checks if the data type is ASCII
   if (data_type == 0)
+  {
+    if (extract)
+      extractFields (cloud, fields);
     return (0);
+  }
 
   int point_size = static_cast<int> (cloud.data.size () / (cloud.height * cloud.width));
   // Once copied, we need to go over each field and check if it has NaN/Inf values and assign cloud.is_dense to true or false
@@ -1283,6 +1521,8 @@ pcl::PCDReader::read (const std::string &file_name, sensor_msgs::PointCloud2 &cl
     }
   }
 
+  if (extract)
+    extractFields (cloud, fields);
   return (0);
 }
 
@@ -1299,6 +1539,12 @@ pcl::PCDReader::readEigen (const std::string &file_name, pcl::PointCloud<Eigen::
   if (res < 0)
     return (res);
 
+  if (data_type == 4)
+  {
+    PCL_ERROR ("[pcl::PCDReader::readEigen] PCD columnar mode not implemented for Eigen::MatrixXf, use read instead (%s)!\n", file_name.c_str ());
+    return (-1);
+  }
+
   int idx = 0;
 
   // Get the number of points the cloud should have
@@ -1419,7 +1665,7 @@ pcl::PCDReader::readEigen (const std::string &file_name, pcl::PointCloud<Eigen::
 #endif
 
     /// ---[ Binary compressed mode only
-    if (data_type == 2)
+    if (data_type == 2 || data_type == 3)
       throw pcl::IOException ("[pcl::PCDReader::readEigen] PCD binary_compressed mode not implemented for Eigen::MatrixXf!");
     else
     {
@@ -1758,81 +2004,101 @@ pcl::PCDWriter::writeASCII (const std::string &file_name, const sensor_msgs::Poi
   // Write the header information
   fs << generateHeaderASCII (cloud, origin, orientation) << "DATA ascii\n";
 
-  std::ostringstream stream;
-  stream.precision (precision);
-  stream.imbue (std::locale::classic ());
-
-  // Iterate through the points
-  for (int i = 0; i < nr_points; ++i)
+  // Format blocks of points in parallel, and write them to disk in order
+  const int block_size = 4096, nr_blocks = (nr_points + block_size - 1) / block_size;
+  std::vector<std::string> blocks (64);
+  for (int first_block = 0; first_block < nr_blocks; first_block += static_cast<int> (blocks.size ()))
   {
-    for (unsigned int d = 0; d < static_cast<unsigned int> (cloud.fields.size ()); ++d)
+    int batch_size = std::min (static_cast<int> (blocks.size ()), nr_blocks - first_block);
+#pragma omp parallel for num_threads(threads_) schedule(dynamic)
+    for (int b = 0; b < batch_size; ++b)
     {
-      // Ignore invalid padded dimensions that are inherited from binary data
-      if (cloud.fields[d].name == "_")
-        continue;
-
-      int count = cloud.fields[d].count;
-      if (count == 0) 
-        count = 1;          // we simply cannot tolerate 0 counts (coming from older converter code)
-
-      for (int c = 0; c < count; ++c)
+      std::ostringstream stream, line;
+      stream.imbue (std::locale::classic ());
+      line.imbue (std::locale::classic ());
+      line.precision (precision);
+
+      int end_point = std::min (nr_points, (first_block + b + 1) * block_size);
+      // Iterate through the points
+      for (int i = (first_block + b) * block_size; i < end_point; ++i)
       {
-        switch (cloud.fields[d].datatype)
+        for (unsigned int d = 0; d < static_cast<unsigned int> (cloud.fields.size ()); ++d)
         {
-          case sensor_msgs::PointField::INT8:
-          {
-            copyValueString<pcl::traits::asType<sensor_msgs::PointField::INT8>::type>(cloud, i, point_size, d, c, stream);
-            break;
-          }
-          case sensor_msgs::PointField::UINT8:
-          {
-            copyValueString<pcl::traits::asType<sensor_msgs::PointField::UINT8>::type>(cloud, i, point_size, d, c, stream);
-            break;
-          }
-          case sensor_msgs::PointField::INT16:
-          {
-            copyValueString<pcl::traits::asType<sensor_msgs::PointField::INT16>::type>(cloud, i, point_size, d, c, stream);
-            break;
-          }
-          case sensor_msgs::PointField::UINT16:
-          {
-            copyValueString<pcl::traits::asType<sensor_msgs::PointField::UINT16>::type>(cloud, i, point_size, d, c, stream);
-            break;
-          }
-          case sensor_msgs::PointField::INT32:
-          {
-            copyValueString<pcl::traits::asType<sensor_msgs::PointField::INT32>::type>(cloud, i, point_size, d, c, stream);
-            break;
-          }
-          case sensor_msgs::PointField::UINT32:
-          {
-            copyValueString<pcl::traits::asType<sensor_msgs::PointField::UINT32>::type>(cloud, i, point_size, d, c, stream);
-            break;
-          }
-          case sensor_msgs::PointField::FLOAT32:
-          {
-            copyValueString<pcl::traits::asType<sensor_msgs::PointField::FLOAT32>::type>(cloud, i, point_size, d, c, stream);
-            break;
-          }
-          case sensor_msgs::PointField::FLOAT64:
+          // Ignore invalid padded dimensions that are inherited from binary data
+          if (cloud.fields[d].name == "_")
+            continue;
+
+          int count = cloud.fields[d].count;
+          if (count == 0) 
+            count = 1;          // we simply cannot tolerate 0 counts (coming from older converter code)
+
+          for (int c = 0; c < count; ++c)
           {
-            copyValueString<pcl::traits::asType<sensor_msgs::PointField::FLOAT64>::type>(cloud, i, point_size, d, c, stream);
-            break;
+            switch (cloud.fields[d].datatype)
+            {
+              case sensor_msgs::PointField::INT8:
+              {
+                copyValueString<pcl::traits::asType<sensor_msgs::PointField::INT8>::type>(cloud, i, point_size, d, c, line);
+                break;
+              }
+              case sensor_msgs::PointField::UINT8:
+              {
+                copyValueString<pcl::traits::asType<sensor_msgs::PointField::UINT8>::type>(cloud, i, point_size, d, c, line);
+                break;
+              }
+              case sensor_msgs::PointField::INT16:
+              {
+                copyValueString<pcl::traits::asType<sensor_msgs::PointField::INT16>::type>(cloud, i, point_size, d, c, line);
+                break;
+              }
+              case sensor_msgs::PointField::UINT16:
+              {
+                copyValueString<pcl::traits::asType<sensor_msgs::PointField::UINT16>::type>(cloud, i, point_size, d, c, line);
+                break;
+              }
+              case sensor_msgs::PointField::INT32:
+              {
+                copyValueString<pcl::traits::asType<sensor_msgs::PointField::INT32>::type>(cloud, i, point_size, d, c, line);
+                break;
+              }
+              case sensor_msgs::PointField::UINT32:
+              {
+                copyValueString<pcl::traits::asType<sensor_msgs::PointField::UINT32>::type>(cloud, i, point_size, d, c, line);
+                break;
+              }
+              case sensor_msgs::PointField::FLOAT32:
+              {
+                if (precision == ROUND_TRIP_PRECISION)
+                  line.precision (std::numeric_limits<float>::digits10 + 3);
+                copyValueString<pcl::traits::asType<sensor_msgs::PointField::FLOAT32>::type>(cloud, i, point_size, d, c, line);
+                break;
+              }
+              case sensor_msgs::PointField::FLOAT64:
+              {
+                if (precision == ROUND_TRIP_PRECISION)
+                  line.precision (std::numeric_limits<double>::digits10 + 2);
+                copyValueString<pcl::traits::asType<sensor_msgs::PointField::FLOAT64>::type>(cloud, i, point_size, d, c, line);
+                break;
+              }
+              default:
+                PCL_WARN ("[pcl::PCDWriter::writeASCII] Incorrect field data type specified (%d)!\n", cloud.fields[d].datatype);
+                break;
+            }
+
+            if (d < cloud.fields.size () - 1 || c < static_cast<int> (cloud.fields[d].count) - 1)
+              line << " ";
           }
-          default:
-            PCL_WARN ("[pcl::PCDWriter::writeASCII] Incorrect field data type specified (%d)!\n", cloud.fields[d].datatype);
-            break;
         }
-
-        if (d < cloud.fields.size () - 1 || c < static_cast<int> (cloud.fields[d].count) - 1)
-          stream << " ";
+        // Copy the line, trim it, and append it to the block
+        std::string result = line.str ();
+        boost::trim (result);
+        line.str ("");
+        stream << result << "\n";
       }
+      blocks[b] = stream.str ();
     }
-    // Copy the stream, trim it, and write it to disk
-    std::string result = stream.str ();
-    boost::trim (result);
-    stream.str ("");
-    fs << result << "\n";
+    for (int b = 0; b < batch_size; ++b)
+      fs << blocks[b];
   }
   fs.close ();              // Close file
   resetLockingPermissions (file_name, file_lock);
@@ -1853,7 +2119,15 @@ pcl::PCDWriter::writeBinary (const std::string &file_name, const sensor_msgs::Po
   std::ostringstream oss;
   oss.imbue (std::locale::classic ());
 
-  oss << generateHeaderBinary (cloud, origin, orientation) << "DATA binary\n";
+  oss << generateHeaderBinary (cloud, origin, orientation);
+  // Pad the header with a comment line so that the data starts on a 16 byte
+  // boundary, which allows PCDMappedCloud to use the points in place
+  int padding = (16 - (static_cast<int> (oss.tellp ()) + 12) % 16) % 16;   // 12 = strlen ("DATA binary\n")
+  if (padding == 1)
+    padding += 16;
+  if (padding > 0)
+    oss << "#" << std::string (padding - 2, ' ') << "\n";
+  oss << "DATA binary\n";
   oss.flush();
   data_idx = static_cast<unsigned int> (oss.tellp ());
 
@@ -2142,6 +2416,337 @@ pcl::PCDWriter::writeBinaryCompressed (const std::string &file_name, const senso
   return (0);
 }
 
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDWriter::writeBinaryCompressedChunked (const std::string &file_name, const sensor_msgs::PointCloud2 &cloud,
+                                              const Eigen::Vector4f &origin, const Eigen::Quaternionf &orientation)
+{
+  if (cloud.data.empty ())
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Input point cloud has no data!\n");
+    return (-1);
+  }
+  std::ostringstream oss;
+  oss.imbue (std::locale::classic ());
+
+  oss << generateHeaderBinaryCompressed (cloud, origin, orientation) << "DATA binary_compressed_chunked\n";
+
+  size_t fsize = 0;
+  size_t nri = 0;
+  std::vector<sensor_msgs::PointField> fields (cloud.fields.size ());
+  std::vector<int> fields_sizes (cloud.fields.size ());
+  // Compute the total size of the fields
+  for (size_t i = 0; i < cloud.fields.size (); ++i)
+  {
+    if (cloud.fields[i].name == "_")
+      continue;
+    
+    fields_sizes[nri] = cloud.fields[i].count * pcl::getFieldSize (cloud.fields[i].datatype);
+    fsize += fields_sizes[nri];
+    fields[nri] = cloud.fields[i];
+    ++nri;
+  }
+  fields_sizes.resize (nri);
+  fields.resize (nri);
+
+  // Convert the XYZRGBXYZRGB structure to XXYYZZRGBRGB, exactly as for binary_compressed
+  const size_t nr_points = static_cast<size_t> (cloud.width) * cloud.height;
+  std::vector<char> only_valid_data (nr_points * fsize);
+  std::vector<size_t> plane_offsets (fields.size ());
+  size_t toff = 0;
+  for (size_t j = 0; j < fields.size (); ++j)
+  {
+    plane_offsets[j] = toff;
+    toff += fields_sizes[j] * nr_points;
+  }
+
+#pragma omp parallel for num_threads(threads_)
+  for (int i = 0; i < static_cast<int> (nr_points); ++i)
+  {
+    const unsigned char *point = &cloud.data[static_cast<size_t> (i) * cloud.point_step];
+    for (size_t j = 0; j < fields.size (); ++j)
+      memcpy (&only_valid_data[plane_offsets[j] + static_cast<size_t> (i) * fields_sizes[j]], point + fields[j].offset, fields_sizes[j]);
+  }
+
+  return (writeCompressedChunkedData (file_name, oss.str (), &only_valid_data[0], only_valid_data.size ()));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDWriter::writeCompressedChunkedData (const std::string &file_name, const std::string &header,
+                                            const char *data, size_t data_size)
+{
+  if (data_size > std::numeric_limits<unsigned int>::max ())
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Data too large for a binary compressed PCD file!\n");
+    return (-1);
+  }
+
+  // Compress the field planes in independent blocks. The first 8 bytes are
+  // reserved for the compressed and uncompressed sizes, as for binary_compressed.
+  std::vector<char> chunks;
+  unsigned int compressed_size = pcl::lzfCompressChunked (data, static_cast<unsigned int> (data_size), chunks, 
+                                                          compression_block_size_, threads_);
+  if (compressed_size == 0)
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Error during compression!\n");
+    return (-1);
+  }
+  unsigned int uncompressed_size = static_cast<unsigned int> (data_size);
+  const size_t data_idx = header.size ();
+  const size_t file_size = data_idx + 8 + compressed_size;
+
+#if _WIN32
+  HANDLE h_native_file = CreateFile (file_name.c_str (), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (h_native_file == INVALID_HANDLE_VALUE)
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Error during CreateFile (%s)!\n", file_name.c_str ());
+    return (-1);
+  }
+#else
+  int fd = pcl_open (file_name.c_str (), O_RDWR | O_CREAT | O_TRUNC, static_cast<mode_t> (0600));
+  if (fd < 0)
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Error during open (%s)!\n", file_name.c_str());
+    return (-1);
+  }
+#endif
+  // Mandatory lock file
+  boost::interprocess::file_lock file_lock;
+  setLockingPermissions (file_name, file_lock);
+
+#if !_WIN32
+  // Stretch the file size to the size of the data
+  int result = static_cast<int> (pcl_lseek (fd, file_size - 1, SEEK_SET));
+  if (result < 0)
+  {
+    pcl_close (fd);
+    resetLockingPermissions (file_name, file_lock);
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Error during lseek ()!\n");
+    return (-1);
+  }
+  // Write a bogus entry so that the new file size comes in effect
+  result = static_cast<int> (::write (fd, "", 1));
+  if (result != 1)
+  {
+    pcl_close (fd);
+    resetLockingPermissions (file_name, file_lock);
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Error during write ()!\n");
+    return (-1);
+  }
+#endif
+
+  // Prepare the map
+#ifdef _WIN32
+  HANDLE fm = CreateFileMapping (h_native_file, NULL, PAGE_READWRITE, 0, (DWORD) file_size, NULL);
+  char *map = static_cast<char*> (MapViewOfFile (fm, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, file_size));
+  CloseHandle (fm);
+
+#else
+  char *map = static_cast<char*> (mmap (0, file_size, PROT_WRITE, MAP_SHARED, fd, 0));
+  if (map == reinterpret_cast<char*> (-1))    // MAP_FAILED
+  {
+    pcl_close (fd);
+    resetLockingPermissions (file_name, file_lock);
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Error during mmap ()!\n");
+    return (-1);
+  }
+#endif
+
+  // Copy the header, the sizes and the compressed blocks
+  memcpy (&map[0], header.c_str (), data_idx);
+  memcpy (&map[data_idx + 0], &compressed_size, sizeof (unsigned int));
+  memcpy (&map[data_idx + 4], &uncompressed_size, sizeof (unsigned int));
+  memcpy (&map[data_idx + 8], &chunks[0], compressed_size);
+
+#if !_WIN32
+  // If the user set the synchronization flag on, call msync
+  if (map_synchronization_)
+    msync (map, file_size, MS_SYNC);
+#endif
+
+  // Unmap the pages of memory
+#if _WIN32
+    UnmapViewOfFile (map);
+#else
+  if (munmap (map, file_size) == -1)
+  {
+    pcl_close (fd);
+    resetLockingPermissions (file_name, file_lock);
+    PCL_ERROR ("[pcl::PCDWriter::writeBinaryCompressedChunked] Error during munmap ()!\n");
+    return (-1);
+  }
+#endif
+  // Close file
+#if _WIN32
+  CloseHandle (h_native_file);
+#else
+  pcl_close (fd);
+#endif
+  resetLockingPermissions (file_name, file_lock);
+  return (0);
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDWriter::writeColumnar (const std::string &file_name, const sensor_msgs::PointCloud2 &cloud,
+                               const Eigen::Vector4f &origin, const Eigen::Quaternionf &orientation)
+{
+  if (cloud.data.empty ())
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeColumnar] Input point cloud has no data!\n");
+    return (-1);
+  }
+  return (writeColumnarData (file_name, generateHeaderBinaryCompressed (cloud, origin, orientation),
+                             &cloud.data[0], static_cast<size_t> (cloud.width) * cloud.height, 
+                             cloud.point_step, cloud.fields));
+}
+
+///////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDWriter::writeColumnarData (const std::string &file_name, const std::string &header,
+                                   const unsigned char *points, size_t nr_points, size_t point_step,
+                                   const std::vector<sensor_msgs::PointField> &fields)
+{
+  if (header.empty ())
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeColumnar] Invalid header!\n");
+    return (-1);
+  }
+
+  // Lay out one column per (non padding) field, each starting on a 16 byte
+  // boundary relative to the start of the data
+  std::vector<size_t> point_offsets, sizes, column_offsets;
+  size_t data_size = 0;
+  for (size_t d = 0; d < fields.size (); ++d)
+  {
+    if (fields[d].name == "_")
+      continue;
+    point_offsets.push_back (fields[d].offset);
+    sizes.push_back (fields[d].count * pcl::getFieldSize (fields[d].datatype));
+    data_size = (data_size + 15) / 16 * 16;
+    column_offsets.push_back (data_size);
+    data_size += sizes.back () * nr_points;
+  }
+
+  std::ostringstream data_line;
+  data_line.imbue (std::locale::classic ());
+  data_line << "DATA columnar";
+  for (size_t c = 0; c < column_offsets.size (); ++c)
+    data_line << " " << column_offsets[c];
+  data_line << "\n";
+
+  // Pad the header with a comment line so that the data starts on a 16 byte boundary
+  std::ostringstream oss;
+  oss << header;
+  int padding = static_cast<int> ((16 - (header.size () + data_line.str ().size ()) % 16) % 16);
+  if (padding == 1)
+    padding += 16;
+  if (padding > 0)
+    oss << "#" << std::string (padding - 2, ' ') << "\n";
+  oss << data_line.str ();
+  const std::string full_header = oss.str ();
+  const size_t data_idx = full_header.size ();
+  const size_t file_size = data_idx + data_size;
+
+#if _WIN32
+  HANDLE h_native_file = CreateFile (file_name.c_str (), GENERIC_READ | GENERIC_WRITE, 0, NULL, CREATE_ALWAYS, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (h_native_file == INVALID_HANDLE_VALUE)
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeColumnar] Error during CreateFile (%s)!\n", file_name.c_str ());
+    return (-1);
+  }
+#else
+  int fd = pcl_open (file_name.c_str (), O_RDWR | O_CREAT | O_TRUNC, static_cast<mode_t> (0600));
+  if (fd < 0)
+  {
+    PCL_ERROR ("[pcl::PCDWriter::writeColumnar] Error during open (%s)!\n", file_name.c_str());
+    return (-1);
+  }
+#endif
+  // Mandatory lock file
+  boost::interprocess::file_lock file_lock;
+  setLockingPermissions (file_name, file_lock);
+
+#if !_WIN32
+  // Stretch the file size to the size of the data
+  int result = static_cast<int> (pcl_lseek (fd, file_size - 1, SEEK_SET));
+  if (result < 0)
+  {
+    pcl_close (fd);
+    resetLockingPermissions (file_name, file_lock);
+    PCL_ERROR ("[pcl::PCDWriter::writeColumnar] Error during lseek ()!\n");
+    return (-1);
+  }
+  // Write a bogus entry so that the new file size comes in effect
+  result = static_cast<int> (::write (fd, "", 1));
+  if (result != 1)
+  {
+    pcl_close (fd);
+    resetLockingPermissions (file_name, file_lock);
+    PCL_ERROR ("[pcl::PCDWriter::writeColumnar] Error during write ()!\n");
+    return (-1);
+  }
+#endif
+
+  // Prepare the map
+#ifdef _WIN32
+  HANDLE fm = CreateFileMapping (h_native_file, NULL, PAGE_READWRITE, 0, (DWORD) file_size, NULL);
+  char *map = static_cast<char*> (MapViewOfFile (fm, FILE_MAP_READ | FILE_MAP_WRITE, 0, 0, file_size));
+  CloseHandle (fm);
+
+#else
+  char *map = static_cast<char*> (mmap (0, file_size, PROT_WRITE, MAP_SHARED, fd, 0));
+  if (map == reinterpret_cast<char*> (-1))    // MAP_FAILED
+  {
+    pcl_close (fd);
+    resetLockingPermissions (file_name, file_lock);
+    PCL_ERROR ("[pcl::PCDWriter::writeColumnar] Error during mmap ()!\n");
+    return (-1);
+  }
+#endif
+
+  // Copy the header, and gather the XYZ points into XXYYZZ columns
+  memcpy (&map[0], full_header.c_str (), data_idx);
+  const int nr_points_int = static_cast<int> (nr_points);
+  for (size_t c = 0; c < column_offsets.size (); ++c)
+  {
+    char *column = &map[data_idx + column_offsets[c]];
+    const size_t size = sizes[c], point_offset = point_offsets[c];
+#pragma omp parallel for num_threads(threads_)
+    for (int i = 0; i < nr_points_int; ++i)
+      memcpy (column + static_cast<size_t> (i) * size, 
+              points + static_cast<size_t> (i) * point_step + point_offset, size);
+  }
+
+#if !_WIN32
+  // If the user set the synchronization flag on, call msync
+  if (map_synchronization_)
+    msync (map, file_size, MS_SYNC);
+#endif
+
+  // Unmap the pages of memory
+#if _WIN32
+    UnmapViewOfFile (map);
+#else
+  if (munmap (map, file_size) == -1)
+  {
+    pcl_close (fd);
+    resetLockingPermissions (file_name, file_lock);
+    PCL_ERROR ("[pcl::PCDWriter::writeColumnar] Error during munmap ()!\n");
+    return (-1);
+  }
+#endif
+  // Close file
+#if _WIN32
+  CloseHandle (h_native_file);
+#else
+  pcl_close (fd);
+#endif
+  resetLockingPermissions (file_name, file_lock);
+  return (0);
+}
+
 /////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 std::string
 pcl::PCDWriter::generateHeaderEigen (const pcl::PointCloud<Eigen::MatrixXf> &cloud, 
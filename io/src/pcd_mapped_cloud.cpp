@@ -0,0 +1,151 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <fcntl.h>
+#include <pcl/io/boost.h>
+#include <pcl/io/pcd_mapped_cloud.h>
+
+#ifdef _WIN32
+# include <io.h>
+# include <windows.h>
+#else
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::PCDMappedFile::PCDMappedFile ()
+  : file_name_ ()
+  , header_ ()
+  , origin_ (Eigen::Vector4f::Zero ())
+  , orientation_ (Eigen::Quaternionf::Identity ())
+  , data_type_ (0)
+  , data_idx_ (0)
+  , map_ (NULL)
+  , map_size_ (0)
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::PCDMappedFile::~PCDMappedFile ()
+{
+  close ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDMappedFile::open (const std::string &file_name)
+{
+  close ();
+
+  pcl::PCDReader reader;
+  int pcd_version;
+  unsigned int data_idx;
+  if (reader.readHeader (file_name, header_, origin_, orientation_, pcd_version, data_type_, data_idx) < 0)
+    return (-1);
+  file_name_ = file_name;
+  data_idx_  = data_idx;
+
+  // Only uncompressed binary data can be used in place
+  if (data_type_ != 1)
+    return (0);
+
+  size_t data_size = static_cast<size_t> (header_.width) * header_.height * header_.point_step;
+  map_size_ = data_idx_ + data_size;
+  if (data_size == 0 || boost::filesystem::file_size (file_name) < map_size_)
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::open] File %s is too small for the point data announced in its header!\n", file_name.c_str ());
+    map_size_ = 0;
+    return (-1);
+  }
+
+#ifdef _WIN32
+  HANDLE h_native_file = CreateFileA (file_name.c_str (), GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+  if (h_native_file == INVALID_HANDLE_VALUE)
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::open] Failure to open file %s\n", file_name.c_str ());
+    return (-1);
+  }
+  HANDLE fm = CreateFileMapping (h_native_file, NULL, PAGE_READONLY, 0, 0, NULL);
+  map_ = static_cast<char*> (MapViewOfFile (fm, FILE_MAP_READ, 0, 0, map_size_));
+  CloseHandle (fm);
+  CloseHandle (h_native_file);
+  if (map_ == NULL)
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::open] Error mapping view of file, %s\n", file_name.c_str ());
+    map_size_ = 0;
+    return (-1);
+  }
+#else
+  int fd = ::open (file_name.c_str (), O_RDONLY);
+  if (fd == -1)
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::open] Failure to open file %s\n", file_name.c_str ());
+    map_size_ = 0;
+    return (-1);
+  }
+  char *map = static_cast<char*> (mmap (0, map_size_, PROT_READ, MAP_SHARED, fd, 0));
+  // The mapping stays valid after the descriptor is closed
+  ::close (fd);
+  if (map == reinterpret_cast<char*> (-1))    // MAP_FAILED
+  {
+    PCL_ERROR ("[pcl::PCDMappedFile::open] Error preparing mmap for binary PCD file %s.\n", file_name.c_str ());
+    map_size_ = 0;
+    return (-1);
+  }
+  map_ = map;
+#endif
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDMappedFile::close ()
+{
+  if (map_)
+  {
+#ifdef _WIN32
+    UnmapViewOfFile (map_);
+#else
+    munmap (map_, map_size_);
+#endif
+  }
+  map_ = NULL;
+  map_size_ = 0;
+}
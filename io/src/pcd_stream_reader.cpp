@@ -0,0 +1,528 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <fcntl.h>
+#include <cstring>
+#include <pcl/io/boost.h>
+#include <pcl/io/pcd_stream_reader.h>
+#include <pcl/io/lzf.h>
+
+#ifdef _WIN32
+# include <io.h>
+#else
+# include <sys/mman.h>
+# include <unistd.h>
+#endif
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+namespace
+{
+  /** \brief Parse one ascii token into the field \a d, element \a c of point \a idx. */
+  void
+  copyASCIIValue (const std::string &st, sensor_msgs::PointCloud2 &cloud,
+                  unsigned int idx, unsigned int d, unsigned int c)
+  {
+    switch (cloud.fields[d].datatype)
+    {
+      case sensor_msgs::PointField::INT8:
+        pcl::copyStringValue<pcl::traits::asType<sensor_msgs::PointField::INT8>::type> (st, cloud, idx, d, c);
+        break;
+      case sensor_msgs::PointField::UINT8:
+        pcl::copyStringValue<pcl::traits::asType<sensor_msgs::PointField::UINT8>::type> (st, cloud, idx, d, c);
+        break;
+      case sensor_msgs::PointField::INT16:
+        pcl::copyStringValue<pcl::traits::asType<sensor_msgs::PointField::INT16>::type> (st, cloud, idx, d, c);
+        break;
+      case sensor_msgs::PointField::UINT16:
+        pcl::copyStringValue<pcl::traits::asType<sensor_msgs::PointField::UINT16>::type> (st, cloud, idx, d, c);
+        break;
+      case sensor_msgs::PointField::INT32:
+        pcl::copyStringValue<pcl::traits::asType<sensor_msgs::PointField::INT32>::type> (st, cloud, idx, d, c);
+        break;
+      case sensor_msgs::PointField::UINT32:
+        pcl::copyStringValue<pcl::traits::asType<sensor_msgs::PointField::UINT32>::type> (st, cloud, idx, d, c);
+        break;
+      case sensor_msgs::PointField::FLOAT32:
+        pcl::copyStringValue<pcl::traits::asType<sensor_msgs::PointField::FLOAT32>::type> (st, cloud, idx, d, c);
+        break;
+      case sensor_msgs::PointField::FLOAT64:
+        pcl::copyStringValue<pcl::traits::asType<sensor_msgs::PointField::FLOAT64>::type> (st, cloud, idx, d, c);
+        break;
+      default:
+        PCL_WARN ("[pcl::PCDStreamReader::readBlock] Incorrect field data type specified (%d)!\n", cloud.fields[d].datatype);
+        break;
+    }
+  }
+
+  /** \brief Return false if any floating point value in the cloud is NaN/Inf. */
+  bool
+  isDense (const sensor_msgs::PointCloud2 &cloud)
+  {
+    const size_t nr_points = static_cast<size_t> (cloud.width) * cloud.height;
+    for (size_t d = 0; d < cloud.fields.size (); ++d)
+    {
+      const sensor_msgs::PointField &field = cloud.fields[d];
+      if (field.name == "_")
+        continue;
+      for (size_t i = 0; i < nr_points; ++i)
+      {
+        for (uint32_t c = 0; c < field.count; ++c)
+        {
+          if (field.datatype == sensor_msgs::PointField::FLOAT32)
+          {
+            float value;
+            memcpy (&value, &cloud.data[i * cloud.point_step + field.offset + c * sizeof (float)], sizeof (float));
+            if (!pcl_isfinite (value))
+              return (false);
+          }
+          else if (field.datatype == sensor_msgs::PointField::FLOAT64)
+          {
+            double value;
+            memcpy (&value, &cloud.data[i * cloud.point_step + field.offset + c * sizeof (double)], sizeof (double));
+            if (!pcl_isfinite (value))
+              return (false);
+          }
+        }
+      }
+    }
+    return (true);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::PCDStreamReader::PCDStreamReader ()
+  : file_name_ ()
+  , is_open_ (false)
+  , header_ ()
+  , origin_ (Eigen::Vector4f::Zero ())
+  , orientation_ (Eigen::Quaternionf::Identity ())
+  , data_type_ (0)
+  , data_idx_ (0)
+  , file_size_ (0)
+  , nr_points_ (0)
+  , current_point_ (0)
+  , fs_ ()
+  , plane_sizes_ ()
+  , plane_offsets_ ()
+  , decompressed_ ()
+  , chunk_size_ (0)
+  , chunk_sizes_ ()
+  , chunk_offsets_ ()
+  , chunk_cache_ ()
+  , blob_ ()
+{
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+pcl::PCDStreamReader::~PCDStreamReader ()
+{
+  close ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamReader::open (const std::string &file_name, const int offset)
+{
+  close ();
+
+  pcl::PCDReader reader;
+  int pcd_version;
+  unsigned int data_idx;
+  if (reader.readHeader (file_name, header_, origin_, orientation_, pcd_version, data_type_, data_idx, offset) < 0)
+    return (-1);
+
+  file_name_     = file_name;
+  data_idx_      = data_idx;
+  file_size_     = static_cast<size_t> (boost::filesystem::file_size (file_name));
+  nr_points_     = static_cast<size_t> (header_.width) * header_.height;
+  current_point_ = 0;
+
+  if (data_type_ == 0)
+  {
+    fs_.open (file_name.c_str ());
+    if (!fs_.is_open () || fs_.fail ())
+    {
+      PCL_ERROR ("[pcl::PCDStreamReader::open] Could not open file %s.\n", file_name.c_str ());
+      return (-1);
+    }
+    fs_.seekg (data_idx_);
+  }
+  else if (data_type_ == 4)
+  {
+    // The columns are stored uncompressed, at the offsets listed in the header
+    plane_offsets_ = reader.getColumnOffsets ();
+    for (size_t d = 0; d < header_.fields.size (); ++d)
+    {
+      if (header_.fields[d].name != "_")
+        plane_sizes_.push_back (header_.fields[d].count * pcl::getFieldSize (header_.fields[d].datatype));
+    }
+    if (plane_sizes_.size () != plane_offsets_.size ())
+    {
+      PCL_ERROR ("[pcl::PCDStreamReader::open] Invalid column offsets in %s!\n", file_name.c_str ());
+      return (-1);
+    }
+  }
+  else if (data_type_ >= 2)
+  {
+    // Compute the layout of the field planes in the decompressed data
+    size_t toff = 0;
+    for (size_t d = 0; d < header_.fields.size (); ++d)
+    {
+      if (header_.fields[d].name == "_")
+        continue;
+      size_t plane_size = header_.fields[d].count * pcl::getFieldSize (header_.fields[d].datatype);
+      plane_sizes_.push_back (plane_size);
+      plane_offsets_.push_back (toff);
+      toff += plane_size * nr_points_;
+    }
+
+    unsigned int sizes[2];
+    if (!readRange (data_idx_, sizeof (sizes), reinterpret_cast<char*> (sizes)))
+      return (-1);
+    if (sizes[1] != toff)
+    {
+      PCL_ERROR ("[pcl::PCDStreamReader::open] The estimated data size (%zu) is different than the saved uncompressed value (%u) in %s!\n",
+                 toff, sizes[1], file_name.c_str ());
+      return (-1);
+    }
+
+    // Read the chunk table, so that chunks can be located and decompressed independently
+    if (data_type_ == 3)
+    {
+      unsigned int chunk_header[3];
+      if (!readRange (data_idx_ + 8, sizeof (chunk_header), reinterpret_cast<char*> (chunk_header)))
+        return (-1);
+      chunk_size_ = chunk_header[1];
+      chunk_sizes_.resize (chunk_header[0]);
+      if (chunk_sizes_.empty () || chunk_size_ == 0 ||
+          !readRange (data_idx_ + 8 + sizeof (chunk_header), chunk_sizes_.size () * sizeof (unsigned int),
+                      reinterpret_cast<char*> (&chunk_sizes_[0])))
+      {
+        PCL_ERROR ("[pcl::PCDStreamReader::open] Invalid chunk table in %s!\n", file_name.c_str ());
+        return (-1);
+      }
+      chunk_offsets_.resize (chunk_sizes_.size ());
+      size_t chunk_offset = data_idx_ + 8 + sizeof (chunk_header) + chunk_sizes_.size () * sizeof (unsigned int);
+      for (size_t b = 0; b < chunk_sizes_.size (); ++b)
+      {
+        chunk_offsets_[b] = chunk_offset;
+        chunk_offset += chunk_sizes_[b];
+      }
+    }
+  }
+
+  is_open_ = true;
+  return (0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+pcl::PCDStreamReader::close ()
+{
+  if (fs_.is_open ())
+    fs_.close ();
+  fs_.clear ();
+  is_open_ = false;
+  nr_points_ = current_point_ = 0;
+  header_ = sensor_msgs::PointCloud2 ();
+  plane_sizes_.clear ();
+  plane_offsets_.clear ();
+  std::vector<char> ().swap (decompressed_);
+  chunk_sizes_.clear ();
+  chunk_offsets_.clear ();
+  chunk_cache_.clear ();
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamReader::readBlock (sensor_msgs::PointCloud2 &block, unsigned int max_points)
+{
+  if (!is_open_)
+  {
+    PCL_ERROR ("[pcl::PCDStreamReader::readBlock] No file open!\n");
+    return (-1);
+  }
+  if (current_point_ >= nr_points_)
+    return (0);
+
+  unsigned int nr_points = static_cast<unsigned int> (std::min<size_t> (max_points, nr_points_ - current_point_));
+
+  block.header     = header_.header;
+  block.fields     = header_.fields;
+  block.point_step = header_.point_step;
+  block.width      = nr_points;
+  block.height     = 1;
+  block.row_step   = block.point_step * nr_points;
+  block.is_bigendian = false;
+  block.is_dense   = true;
+  block.data.resize (static_cast<size_t> (nr_points) * block.point_step);
+
+  int res;
+  if (data_type_ == 0)
+    res = readBlockASCII (block, nr_points);
+  else if (data_type_ == 1)
+    res = readBlockBinary (block, nr_points);
+  else
+    res = readBlockCompressed (block, nr_points);
+
+  if (res < 0)
+    return (res);
+  if (data_type_ != 0)
+    block.is_dense = isDense (block);
+
+  current_point_ += res;
+  return (res);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamReader::readBlockASCII (sensor_msgs::PointCloud2 &block, unsigned int nr_points)
+{
+  std::string line;
+  std::vector<std::string> st;
+  unsigned int idx = 0;
+
+  while (idx < nr_points && !fs_.eof ())
+  {
+    getline (fs_, line);
+    // Ignore empty lines
+    if (line == "")
+      continue;
+
+    // Tokenize the line
+    boost::trim (line);
+    boost::split (st, line, boost::is_any_of ("\t\r "), boost::token_compress_on);
+
+    size_t total = 0;
+    try
+    {
+      for (unsigned int d = 0; d < static_cast<unsigned int> (block.fields.size ()); ++d)
+      {
+        // Ignore invalid padded dimensions that are inherited from binary data
+        if (block.fields[d].name != "_")
+        {
+          for (unsigned int c = 0; c < block.fields[d].count; ++c)
+            copyASCIIValue (st.at (total + c), block, idx, d, c);
+        }
+        total += block.fields[d].count; // jump over this many elements in the string token
+      }
+    }
+    catch (const std::out_of_range &)
+    {
+      PCL_ERROR ("[pcl::PCDStreamReader::readBlock] Not enough values on line %zu of %s!\n",
+                 current_point_ + idx, file_name_.c_str ());
+      return (-1);
+    }
+    ++idx;
+  }
+
+  if (idx != nr_points)
+  {
+    PCL_ERROR ("[pcl::PCDStreamReader::readBlock] Number of points read (%zu) is different than expected (%zu)\n",
+               current_point_ + idx, nr_points_);
+    return (-1);
+  }
+  return (static_cast<int> (idx));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamReader::readBlockBinary (sensor_msgs::PointCloud2 &block, unsigned int nr_points)
+{
+  if (!readRange (data_idx_ + current_point_ * header_.point_step, block.data.size (),
+                  reinterpret_cast<char*> (&block.data[0])))
+    return (-1);
+  return (static_cast<int> (nr_points));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+int
+pcl::PCDStreamReader::readBlockCompressed (sensor_msgs::PointCloud2 &block, unsigned int nr_points)
+{
+  if (data_type_ == 2 && decompressed_.empty ())
+  {
+    // A single LZF stream: it can only be decompressed as a whole
+    unsigned int sizes[2];
+    if (!readRange (data_idx_, sizeof (sizes), reinterpret_cast<char*> (sizes)))
+      return (-1);
+    std::vector<char> compressed (sizes[0]);
+    if (!readRange (data_idx_ + 8, compressed.size (), &compressed[0]))
+      return (-1);
+    decompressed_.resize (sizes[1]);
+    if (pcl::lzfDecompress (&compressed[0], sizes[0], &decompressed_[0], sizes[1]) != sizes[1])
+    {
+      PCL_ERROR ("[pcl::PCDStreamReader::readBlock] Size of decompressed lzf data does not match value stored in PCD header\n");
+      return (-1);
+    }
+  }
+
+  if (data_type_ == 3)
+  {
+    // Only keep the chunks spanned by this batch
+    std::map<size_t, std::vector<char> > needed;
+    for (size_t j = 0; j < plane_sizes_.size (); ++j)
+    {
+      size_t begin = plane_offsets_[j] + current_point_ * plane_sizes_[j];
+      size_t end = begin + nr_points * plane_sizes_[j];
+      for (size_t b = begin / chunk_size_; b <= (end - 1) / chunk_size_; ++b)
+      {
+        std::map<size_t, std::vector<char> >::iterator it = chunk_cache_.find (b);
+        if (it != chunk_cache_.end ())
+          needed[b].swap (it->second);
+        else
+          needed[b];
+      }
+    }
+    chunk_cache_.swap (needed);
+  }
+
+  std::vector<char> plane;
+  for (size_t d = 0, j = 0; d < block.fields.size (); ++d)
+  {
+    if (block.fields[d].name == "_")
+      continue;
+
+    plane.resize (nr_points * plane_sizes_[j]);
+    if (!copyDecompressedRange (plane_offsets_[j] + current_point_ * plane_sizes_[j], plane.size (), &plane[0]))
+      return (-1);
+
+    // Unpack the xxyyzz to xyz
+    for (size_t i = 0; i < nr_points; ++i)
+      memcpy (&block.data[i * block.point_step + block.fields[d].offset], &plane[i * plane_sizes_[j]], plane_sizes_[j]);
+    ++j;
+  }
+  return (static_cast<int> (nr_points));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PCDStreamReader::copyDecompressedRange (size_t begin, size_t len, char *out)
+{
+  if (data_type_ == 4)
+    return (readRange (data_idx_ + begin, len, out));
+
+  if (data_type_ == 2)
+  {
+    if (begin + len > decompressed_.size ())
+      return (false);
+    memcpy (out, &decompressed_[begin], len);
+    return (true);
+  }
+
+  std::vector<char> compressed;
+  while (len > 0)
+  {
+    size_t b = begin / chunk_size_;
+    if (b >= chunk_sizes_.size ())
+    {
+      PCL_ERROR ("[pcl::PCDStreamReader::readBlock] Chunk %zu out of range in %s!\n", b, file_name_.c_str ());
+      return (false);
+    }
+
+    std::vector<char> &chunk = chunk_cache_[b];
+    if (chunk.empty ())
+    {
+      // Decompress the chunk on first use
+      size_t chunk_len = std::min (chunk_size_, plane_offsets_.empty () ? 0 :
+                                   (plane_offsets_.back () + plane_sizes_.back () * nr_points_) - b * chunk_size_);
+      chunk.resize (chunk_len);
+      compressed.resize (chunk_sizes_[b]);
+      if (!readRange (chunk_offsets_[b], compressed.size (), &compressed[0]))
+        return (false);
+      if (chunk_sizes_[b] == chunk_len)
+        memcpy (&chunk[0], &compressed[0], chunk_len);
+      else if (pcl::lzfDecompress (&compressed[0], chunk_sizes_[b], &chunk[0], static_cast<unsigned int> (chunk_len)) != chunk_len)
+      {
+        PCL_ERROR ("[pcl::PCDStreamReader::readBlock] Error decompressing chunk %zu of %s!\n", b, file_name_.c_str ());
+        chunk.clear ();
+        return (false);
+      }
+    }
+
+    size_t chunk_begin = begin - b * chunk_size_;
+    size_t n = std::min (len, chunk.size () - chunk_begin);
+    memcpy (out, &chunk[chunk_begin], n);
+    out += n;
+    begin += n;
+    len -= n;
+  }
+  return (true);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+bool
+pcl::PCDStreamReader::readRange (size_t pos, size_t len, char *out)
+{
+  if (pos + len > file_size_)
+  {
+    PCL_ERROR ("[pcl::PCDStreamReader::readRange] Attempting to read past the end of %s!\n", file_name_.c_str ());
+    return (false);
+  }
+  if (len == 0)
+    return (true);
+
+#ifdef _WIN32
+  std::ifstream fs (file_name_.c_str (), std::ios::binary);
+  fs.seekg (pos);
+  fs.read (out, len);
+  return (!fs.fail ());
+#else
+  // Map only the pages spanned by the requested range
+  int fd = ::open (file_name_.c_str (), O_RDONLY);
+  if (fd == -1)
+  {
+    PCL_ERROR ("[pcl::PCDStreamReader::readRange] Failure to open file %s\n", file_name_.c_str ());
+    return (false);
+  }
+  size_t page_size = static_cast<size_t> (getpagesize ());
+  size_t map_begin = (pos / page_size) * page_size;
+  size_t map_len = pos + len - map_begin;
+  char *map = static_cast<char*> (mmap (0, map_len, PROT_READ, MAP_SHARED, fd, static_cast<off_t> (map_begin)));
+  if (map == reinterpret_cast<char*> (-1))    // MAP_FAILED
+  {
+    ::close (fd);
+    PCL_ERROR ("[pcl::PCDStreamReader::readRange] Error preparing mmap for %s.\n", file_name_.c_str ());
+    return (false);
+  }
+  memcpy (out, map + (pos - map_begin), len);
+  munmap (map, map_len);
+  ::close (fd);
+  return (true);
+#endif
+}
@@ -573,6 +573,35 @@ bool pcl::io::ply::ply_parser::parse (const std::string& filename)
          ++element_iterator)
     {
       struct element& element = *(element_iterator->get ());
+
+      // Elements made of scalar properties only have fixed size records, which
+      // can be handed over in bulk instead of property by property
+      if (fixed_size_element_callback_)
+      {
+        std::vector<property_layout> layout;
+        std::size_t record_size = 0;
+        std::vector< boost::shared_ptr<property> >::const_iterator property_iterator;
+        for (property_iterator = element.properties.begin (); property_iterator != element.properties.end (); ++property_iterator)
+        {
+          std::size_t size = (*property_iterator)->fixed_size ();
+          if (size == 0)
+            break;
+          layout.push_back (property_layout ((*property_iterator)->name, record_size, size));
+          record_size += size;
+        }
+        if (property_iterator == element.properties.end () && record_size > 0 &&
+            fixed_size_element_callback_ (element.name, format, element.count, record_size, layout, istream))
+        {
+          if (!istream)
+          {
+            if (error_callback_)
+              error_callback_ (line_number_, "parse error");
+            return false;
+          }
+          continue;
+        }
+      }
+
       for (std::size_t element_index = 0; element_index < element.count; ++element_index)
       {
         if (element.begin_element_callback) {
@@ -35,6 +35,7 @@
  *
  */
 
+#include <algorithm>
 #include <fstream>
 #include <fcntl.h>
 #include <string>
@@ -63,6 +64,7 @@ pcl::PLYReader::elementDefinitionCallback (const std::string& element_name, std:
     cloud_->point_step = 0;
     cloud_->row_step = 0;
     vertex_count_ = 0;
+    vertex_copies_.clear ();
     return (boost::tuple<boost::function<void ()>, boost::function<void ()> > (
               boost::bind (&pcl::PLYReader::vertexBeginCallback, this),
               boost::bind (&pcl::PLYReader::vertexEndCallback, this)));
@@ -119,6 +121,7 @@ namespace pcl
   {
     if (element_name == "vertex")
     {
+      vertex_copies_.push_back (VertexPropertyCopy (VertexPropertyCopy::FLOAT32, property_name, cloud_->point_step));
       appendFloatProperty (property_name, 1);
       return (boost::bind (&pcl::PLYReader::vertexFloatPropertyCallback, this, _1));
     }
@@ -192,11 +195,17 @@ namespace pcl
           (property_name == "diffuse_red") || (property_name == "diffuse_green") || (property_name == "diffuse_blue") )
       {
         if ((property_name == "red") || (property_name == "diffuse_red"))
+        {
+          vertex_copies_.push_back (VertexPropertyCopy (VertexPropertyCopy::RGB, property_name, cloud_->point_step));
           appendFloatProperty ("rgb");
+        }
+        else if (!vertex_copies_.empty () && vertex_copies_.back ().type == VertexPropertyCopy::RGB)
+          vertex_copies_.back ().names.push_back (property_name);
         return boost::bind (&pcl::PLYReader::vertexColorCallback, this, property_name, _1);
       }
       else if (property_name == "intensity")
       {
+        vertex_copies_.push_back (VertexPropertyCopy (VertexPropertyCopy::UINT8_TO_FLOAT32, property_name, cloud_->point_step));
         appendFloatProperty (property_name);
         return boost::bind (&pcl::PLYReader::vertexIntensityCallback, this, _1);
       }
@@ -265,20 +274,19 @@ pcl::PLYReader::vertexFloatPropertyCallback (pcl::io::ply::float32 value)
 void
 pcl::PLYReader::vertexColorCallback (const std::string& color_name, pcl::io::ply::uint8 color)
 {
-  static int32_t r, g, b;
   if ((color_name == "red") || (color_name == "diffuse_red"))
   {
-    r = int32_t (color);
+    r_ = int32_t (color);
     rgb_offset_before_ = vertex_offset_before_;
   }
   if ((color_name == "green") || (color_name == "diffuse_green"))
   {
-    g = int32_t (color);
+    g_ = int32_t (color);
   }
   if ((color_name == "blue") || (color_name == "diffuse_blue"))
   {
-    b = int32_t (color);
-    int32_t rgb = r << 16 | g << 8 | b;
+    b_ = int32_t (color);
+    int32_t rgb = r_ << 16 | g_ << 8 | b_;
     memcpy (&cloud_->data[vertex_count_ * cloud_->point_step + rgb_offset_before_],
             &rgb,
             sizeof (int32_t));
@@ -331,6 +339,98 @@ pcl::PLYReader::rangeGridEndCallback ()
   ++range_count_;
 }
 
+bool
+pcl::PLYReader::fixedSizeElementCallback (const std::string& element_name, pcl::io::ply::format_type format,
+                                           std::size_t count, std::size_t record_size,
+                                           const std::vector<pcl::io::ply::ply_parser::property_layout>& layout,
+                                           std::istream& istream)
+{
+  if (element_name != "vertex" || vertex_copies_.empty () ||
+      count * cloud_->point_step > cloud_->data.size ())
+    return (false);
+
+  // Locate the properties stored in the cloud in the file records
+  std::vector<std::vector<size_t> > file_offsets (vertex_copies_.size ());
+  bool same_layout = (record_size == cloud_->point_step);
+  for (size_t i = 0; i < vertex_copies_.size (); ++i)
+  {
+    const VertexPropertyCopy &copy = vertex_copies_[i];
+    // Colors are only written once the blue component is known
+    if (copy.type == VertexPropertyCopy::RGB && copy.names.size () != 3)
+      return (false);
+    for (size_t n = 0; n < copy.names.size (); ++n)
+    {
+      size_t j = 0;
+      while (j < layout.size () && layout[j].name != copy.names[n])
+        ++j;
+      if (j == layout.size ())
+        return (false);
+      file_offsets[i].push_back (layout[j].offset);
+    }
+    if (copy.type != VertexPropertyCopy::FLOAT32 || file_offsets[i][0] != copy.cloud_offset)
+      same_layout = false;
+  }
+
+  bool swap = ((format == pcl::io::ply::binary_big_endian_format) && (pcl::io::ply::host_byte_order == pcl::io::ply::little_endian_byte_order)) ||
+              ((format == pcl::io::ply::binary_little_endian_format) && (pcl::io::ply::host_byte_order == pcl::io::ply::big_endian_byte_order));
+
+  // The records are laid out exactly like the points: read them in place
+  if (same_layout && !swap)
+  {
+    istream.read (reinterpret_cast<char*> (&cloud_->data[0]), count * record_size);
+    vertex_count_ = count;
+    return (true);
+  }
+
+  // Otherwise read a batch of records at a time, and scatter their properties
+  const size_t batch_size = std::max<size_t> (1, (1 << 22) / record_size);
+  std::vector<char> records (std::min (count, batch_size) * record_size);
+  for (size_t begin = 0; begin < count; begin += batch_size)
+  {
+    size_t nr_records = std::min (count - begin, batch_size);
+    if (!istream.read (&records[0], nr_records * record_size))
+      return (true);
+
+    for (size_t r = 0; r < nr_records; ++r)
+    {
+      const char *record = &records[r * record_size];
+      pcl::uint8_t *point = &cloud_->data[(begin + r) * cloud_->point_step];
+      for (size_t i = 0; i < vertex_copies_.size (); ++i)
+      {
+        const VertexPropertyCopy &copy = vertex_copies_[i];
+        switch (copy.type)
+        {
+          case VertexPropertyCopy::FLOAT32:
+          {
+            pcl::io::ply::float32 value;
+            memcpy (&value, record + file_offsets[i][0], sizeof (pcl::io::ply::float32));
+            if (swap)
+              pcl::io::ply::swap_byte_order (value);
+            memcpy (point + copy.cloud_offset, &value, sizeof (pcl::io::ply::float32));
+            break;
+          }
+          case VertexPropertyCopy::UINT8_TO_FLOAT32:
+          {
+            pcl::io::ply::float32 value (static_cast<pcl::io::ply::uint8> (record[file_offsets[i][0]]));
+            memcpy (point + copy.cloud_offset, &value, sizeof (pcl::io::ply::float32));
+            break;
+          }
+          case VertexPropertyCopy::RGB:
+          {
+            int32_t rgb = int32_t (static_cast<pcl::io::ply::uint8> (record[file_offsets[i][0]])) << 16 |
+                          int32_t (static_cast<pcl::io::ply::uint8> (record[file_offsets[i][1]])) << 8 |
+                          int32_t (static_cast<pcl::io::ply::uint8> (record[file_offsets[i][2]]));
+            memcpy (point + copy.cloud_offset, &rgb, sizeof (int32_t));
+            break;
+          }
+        }
+      }
+    }
+  }
+  vertex_count_ = count;
+  return (true);
+}
+
 void
 pcl::PLYReader::objInfoCallback (const std::string& line)
 {
@@ -367,6 +467,7 @@ pcl::PLYReader::parse (const std::string& istream_filename)
   ply_parser.obj_info_callback (boost::bind (&pcl::PLYReader::objInfoCallback, this, _1));
   ply_parser.element_definition_callback (boost::bind (&pcl::PLYReader::elementDefinitionCallback, this, _1, _2));
   ply_parser.end_header_callback (boost::bind (&pcl::PLYReader::endHeaderCallback, this));
+  ply_parser.fixed_size_element_callback (boost::bind (&pcl::PLYReader::fixedSizeElementCallback, this, _1, _2, _3, _4, _5, _6));
 
   pcl::io::ply::ply_parser::scalar_property_definition_callbacks_type scalar_property_definition_callbacks;
   pcl::io::ply::at<pcl::io::ply::float32> (scalar_property_definition_callbacks) = boost::bind (&pcl::PLYReader::scalarPropertyDefinitionCallback<pcl::io::ply::float32>, this, _1, _2);
@@ -42,4 +42,5 @@
 
 // Instantiations of specific point types
 PCL_INSTANTIATE(KdTreeFLANN, PCL_POINT_TYPES)
+PCL_INSTANTIATE(KdTreeFLANN, PCL_COMPACT_POINT_TYPES)
 
@@ -39,6 +39,7 @@
 #define PCL_HARRIS_KEYPOINT_3D_H_
 
 #include <pcl/keypoints/keypoint.h>
+#include <pcl/common/task_scheduler.h>
 
 namespace pcl
 {
@@ -138,7 +139,7 @@ namespace pcl
       virtual void
       setSearchSurface (const PointCloudInConstPtr &cloud) { surface_ = cloud; normals_.reset(); }
 
-      /** \brief Initialize the scheduler and set the number of threads to use.
+      /** \brief Set the maximum number of threads of the pcl::TaskScheduler to use.
         * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
         */
       inline void
@@ -154,6 +155,23 @@ namespace pcl
       void responseTomasi (PointCloudOut &output) const;
       void responseCurvature (PointCloudOut &output) const;
       void refineCorners (PointCloudOut &corners) const;
+
+      /** \brief The corner responses and the local maxima found among them. */
+      struct NonMaxima
+      {
+        const PointCloudOut *response;
+        std::vector<char> is_maximum;
+      };
+
+      /** \brief Flag the local maxima of the points [begin, end) of the response, run in parallel by detectKeypoints. */
+      void nonMaxSuppressionRange (int begin, int end, NonMaxima &maxima) const;
+      /** \brief gets the corner response of the points [begin, end), run in parallel by the response methods */
+      void responseHarrisRange (int begin, int end, PointCloudOut &output) const;
+      void responseNobleRange (int begin, int end, PointCloudOut &output) const;
+      void responseLoweRange (int begin, int end, PointCloudOut &output) const;
+      void responseTomasiRange (int begin, int end, PointCloudOut &output) const;
+      /** \brief refines the corners [begin, end), run in parallel by refineCorners */
+      void refineCornersRange (int begin, int end, PointCloudOut &corners) const;
       /** \brief calculates the upper triangular part of unnormalized covariance matrix over the normals given by the indices.*/
       void calculateNormalCovar (const std::vector<int>& neighbors, float* coefficients) const;
     private:
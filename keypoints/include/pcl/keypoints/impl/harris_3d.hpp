@@ -260,31 +260,16 @@ pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloud
     output.points.clear ();
     output.points.reserve (response->points.size());
 
-#ifdef _OPENMP
-#pragma omp parallel for shared (output) num_threads(threads_)   
-#endif
-    for (int idx = 0; idx < static_cast<int> (response->points.size ()); ++idx)
-    {
-      if (!isFinite (response->points[idx]) || response->points[idx].intensity < threshold_)
-        continue;
-		  std::vector<int> nn_indices;
-		  std::vector<float> nn_dists;
-      tree_->radiusSearch (idx, search_radius_, nn_indices, nn_dists);
-      bool is_maxima = true;
-      for (std::vector<int>::const_iterator iIt = nn_indices.begin(); iIt != nn_indices.end(); ++iIt)
-      {
-        if (response->points[idx].intensity < response->points[*iIt].intensity)
-        {
-          is_maxima = false;
-          break;
-        }
-      }
-      if (is_maxima)
-#ifdef _OPENMP
-#pragma omp critical
-#endif
+    // The maxima are flagged in parallel and collected in the order of the points
+    NonMaxima maxima;
+    maxima.response = response.get ();
+    maxima.is_maximum.resize (response->points.size (), 0);
+    pcl::parallel_for (0, static_cast<int> (response->points.size ()),
+                       pcl::makeRangeMethod (*this, &HarrisKeypoint3D::nonMaxSuppressionRange, maxima),
+                       0, threads_);
+    for (size_t idx = 0; idx < response->points.size (); ++idx)
+      if (maxima.is_maximum[idx])
         output.points.push_back (response->points[idx]);
-    }
 
     if (refine_)
       refineCorners (output);
@@ -297,16 +282,49 @@ pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::detectKeypoints (PointCloud
   output.is_dense = input_->is_dense;
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename NormalT> void
+pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::nonMaxSuppressionRange (int begin, int end, NonMaxima &maxima) const
+{
+  const PointCloudOut &response = *maxima.response;
+  for (int idx = begin; idx < end; ++idx)
+  {
+    if (!isFinite (response.points[idx]) || response.points[idx].intensity < threshold_)
+      continue;
+    std::vector<int> nn_indices;
+    std::vector<float> nn_dists;
+    tree_->radiusSearch (idx, search_radius_, nn_indices, nn_dists);
+    bool is_maxima = true;
+    for (std::vector<int>::const_iterator iIt = nn_indices.begin(); iIt != nn_indices.end(); ++iIt)
+    {
+      if (response.points[idx].intensity < response.points[*iIt].intensity)
+      {
+        is_maxima = false;
+        break;
+      }
+    }
+    maxima.is_maximum[idx] = is_maxima;
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT, typename NormalT> void
 pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseHarris (PointCloudOut &output) const
 {
-  PCL_ALIGN (16) float covar [8];
   output.resize (input_->size ());
-#ifdef _OPENMP
-  #pragma omp parallel for shared (output) private (covar) num_threads(threads_)
-#endif
-  for (int pIdx = 0; pIdx < static_cast<int> (input_->size ()); ++pIdx)
+  pcl::parallel_for (0, static_cast<int> (input_->size ()),
+                     pcl::makeRangeMethod (*this, &HarrisKeypoint3D::responseHarrisRange, output),
+                     0, threads_);
+  output.height = input_->height;
+  output.width = input_->width;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename NormalT> void
+pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseHarrisRange (int begin, int end, PointCloudOut &output) const
+{
+  PCL_ALIGN (16) float covar [8];
+  for (int pIdx = begin; pIdx < end; ++pIdx)
   {
     const PointInT& pointIn = input_->points [pIdx];
     output [pIdx].intensity = 0.0; //std::numeric_limits<float>::quiet_NaN ();
@@ -332,20 +350,26 @@ pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseHarris (PointCloudO
     output [pIdx].y = pointIn.y;
     output [pIdx].z = pointIn.z;
   }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename NormalT> void
+pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseNoble (PointCloudOut &output) const
+{
+  output.resize (input_->size ());
+  pcl::parallel_for (0, static_cast<int> (input_->size ()),
+                     pcl::makeRangeMethod (*this, &HarrisKeypoint3D::responseNobleRange, output),
+                     0, threads_);
   output.height = input_->height;
   output.width = input_->width;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT, typename NormalT> void
-pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseNoble (PointCloudOut &output) const
+pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseNobleRange (int begin, int end, PointCloudOut &output) const
 {
   PCL_ALIGN (16) float covar [8];
-  output.resize (input_->size ());
-#ifdef _OPENMP
-  #pragma omp parallel for shared (output) private (covar) num_threads(threads_)
-#endif
-  for (int pIdx = 0; pIdx < static_cast<int> (input_->size ()); ++pIdx)
+  for (int pIdx = begin; pIdx < end; ++pIdx)
   {
     const PointInT& pointIn = input_->points [pIdx];
     output [pIdx].intensity = 0.0;
@@ -370,20 +394,26 @@ pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseNoble (PointCloudOu
     output [pIdx].y = pointIn.y;
     output [pIdx].z = pointIn.z;
   }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename NormalT> void
+pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseLowe (PointCloudOut &output) const
+{
+  output.resize (input_->size ());
+  pcl::parallel_for (0, static_cast<int> (input_->size ()),
+                     pcl::makeRangeMethod (*this, &HarrisKeypoint3D::responseLoweRange, output),
+                     0, threads_);
   output.height = input_->height;
   output.width = input_->width;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT, typename NormalT> void
-pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseLowe (PointCloudOut &output) const
+pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseLoweRange (int begin, int end, PointCloudOut &output) const
 {
   PCL_ALIGN (16) float covar [8];
-  output.resize (input_->size ());
-#ifdef _OPENMP
-  #pragma omp parallel for shared (output) private (covar) num_threads(threads_)
-#endif
-  for (int pIdx = 0; pIdx < static_cast<int> (input_->size ()); ++pIdx)
+  for (int pIdx = begin; pIdx < end; ++pIdx)
   {
     const PointInT& pointIn = input_->points [pIdx];
     output [pIdx].intensity = 0.0;
@@ -408,8 +438,6 @@ pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseLowe (PointCloudOut
     output [pIdx].y = pointIn.y;
     output [pIdx].z = pointIn.z;
   }
-  output.height = input_->height;
-  output.width = input_->width;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -433,14 +461,22 @@ pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseCurvature (PointClo
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT, typename NormalT> void
 pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseTomasi (PointCloudOut &output) const
+{
+  output.resize (input_->size ());
+  pcl::parallel_for (0, static_cast<int> (input_->size ()),
+                     pcl::makeRangeMethod (*this, &HarrisKeypoint3D::responseTomasiRange, output),
+                     0, threads_);
+  output.height = input_->height;
+  output.width = input_->width;
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename NormalT> void
+pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseTomasiRange (int begin, int end, PointCloudOut &output) const
 {
   PCL_ALIGN (16) float covar [8];
   Eigen::Matrix3f covariance_matrix;
-  output.resize (input_->size ());
-#ifdef _OPENMP
-  #pragma omp parallel for shared (output) private (covar, covariance_matrix) num_threads(threads_)
-#endif
-  for (int pIdx = 0; pIdx < static_cast<int> (input_->size ()); ++pIdx)
+  for (int pIdx = begin; pIdx < end; ++pIdx)
   {
     const PointInT& pointIn = input_->points [pIdx];
     output [pIdx].intensity = 0.0;
@@ -469,13 +505,20 @@ pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::responseTomasi (PointCloudO
     output [pIdx].y = pointIn.y;
     output [pIdx].z = pointIn.z;
   }
-  output.height = input_->height;
-  output.width = input_->width;
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 template <typename PointInT, typename PointOutT, typename NormalT> void
 pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::refineCorners (PointCloudOut &corners) const
+{
+  pcl::parallel_for (0, static_cast<int> (corners.size ()),
+                     pcl::makeRangeMethod (*this, &HarrisKeypoint3D::refineCornersRange, corners),
+                     0, threads_);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename PointInT, typename PointOutT, typename NormalT> void
+pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::refineCornersRange (int begin, int end, PointCloudOut &corners) const
 {
   Eigen::Matrix3f nnT;
   Eigen::Matrix3f NNT;
@@ -483,10 +526,7 @@ pcl::HarrisKeypoint3D<PointInT, PointOutT, NormalT>::refineCorners (PointCloudOu
   Eigen::Vector3f NNTp;
   float diff;
   const unsigned max_iterations = 10;
-#ifdef _OPENMP
-  #pragma omp parallel for shared (corners) private (nnT, NNT, NNTInv, NNTp, diff) num_threads(threads_)
-#endif
-  for (int cIdx = 0; cIdx < static_cast<int> (corners.size ()); ++cIdx)
+  for (int cIdx = begin; cIdx < end; ++cIdx)
   {
     unsigned iterations = 0;
     do {
@@ -119,6 +119,7 @@ pcl::Registration<PointSource, PointTarget>::align (PointCloudSource &output)
 template <typename PointSource, typename PointTarget> inline void
 pcl::Registration<PointSource, PointTarget>::align (PointCloudSource &output, const Eigen::Matrix4f& guess)
 {
+  PCL_PROFILE_METHOD_SCOPE (getClassName (), "align");
   if (!initCompute ()) return;
 
   if (!target_)
@@ -162,7 +163,10 @@ pcl::Registration<PointSource, PointTarget>::align (PointCloudSource &output, co
   for (size_t i = 0; i < indices_->size (); ++i)
     output.points[i].data[3] = 1.0;
 
+  PCL_PROFILE_COUNTER ("source points", indices_->size ());
+  PCL_PROFILE_COUNTER ("target points", target_->points.size ());
   computeTransformation (output, guess);
+  PCL_PROFILE_COUNTER ("iterations", nr_iterations_);
 
   deinitCompute ();
 }
@@ -42,6 +42,7 @@
 
 // PCL includes
 #include <pcl/pcl_base.h>
+#include <pcl/common/profiler.h>
 #include <pcl/common/transforms.h>
 #include <pcl/pcl_macros.h>
 #include <pcl/kdtree/kdtree_flann.h>
@@ -199,9 +199,8 @@ pcl::SampleConsensusModelLine<PointT>::optimizeModelCoefficients (
 
   // Compute the 3x3 covariance matrix
   Eigen::Vector4f centroid;
-  compute3DCentroid (*input_, inliers, centroid);
   Eigen::Matrix3f covariance_matrix;
-  computeCovarianceMatrix (*input_, inliers, centroid, covariance_matrix);
+  computeMeanAndCovarianceMatrix (*input_, inliers, covariance_matrix, centroid);
   optimized_coefficients[0] = centroid[0];
   optimized_coefficients[1] = centroid[1];
   optimized_coefficients[2] = centroid[2];
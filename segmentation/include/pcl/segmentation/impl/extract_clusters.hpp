@@ -58,13 +58,16 @@ pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
 
   std::vector<int> nn_indices;
   std::vector<float> nn_distances;
+  // The queue keeps its capacity from one cluster to the next
+  std::vector<int> seed_queue;
+  size_t nr_neighbors = 0;
   // Process all points in the indices vector
   for (int i = 0; i < static_cast<int> (cloud.points.size ()); ++i)
   {
     if (processed[i])
       continue;
 
-    std::vector<int> seed_queue;
+    seed_queue.clear ();
     int sq_idx = 0;
     seed_queue.push_back (i);
 
@@ -79,6 +82,7 @@ pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
         continue;
       }
 
+      nr_neighbors += nn_indices.size ();
       for (size_t j = 1; j < nn_indices.size (); ++j)             // nn_indices[0] should be sq_idx
       {
         if (nn_indices[j] == -1 || processed[nn_indices[j]])        // Has this point been processed before ?
@@ -95,19 +99,19 @@ pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
     // If this queue is satisfactory, add to the clusters
     if (seed_queue.size () >= min_pts_per_cluster && seed_queue.size () <= max_pts_per_cluster)
     {
-      pcl::PointIndices r;
-      r.indices.resize (seed_queue.size ());
-      for (size_t j = 0; j < seed_queue.size (); ++j)
-        r.indices[j] = seed_queue[j];
+      // Work directly in the vector, to avoid a copy of the indices
+      clusters.push_back (pcl::PointIndices ());
+      pcl::PointIndices &r = clusters.back ();
+      r.indices.assign (seed_queue.begin (), seed_queue.end ());
 
       // These two lines should not be needed: (can anyone confirm?) -FF
       std::sort (r.indices.begin (), r.indices.end ());
       r.indices.erase (std::unique (r.indices.begin (), r.indices.end ()), r.indices.end ());
 
       r.header = cloud.header;
-      clusters.push_back (r);   // We could avoid a copy by working directly in the vector
     }
   }
+  PCL_PROFILE_COUNTER ("neighbors visited", nr_neighbors);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -138,13 +142,16 @@ pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
 
   std::vector<int> nn_indices;
   std::vector<float> nn_distances;
+  // The queue keeps its capacity from one cluster to the next
+  std::vector<int> seed_queue;
+  size_t nr_neighbors = 0;
   // Process all points in the indices vector
   for (int i = 0; i < static_cast<int> (indices.size ()); ++i)
   {
     if (processed[indices[i]])
       continue;
 
-    std::vector<int> seed_queue;
+    seed_queue.clear ();
     int sq_idx = 0;
     seed_queue.push_back (indices[i]);
 
@@ -165,6 +172,7 @@ pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
         continue;
       }
 
+      nr_neighbors += nn_indices.size ();
       for (size_t j = 1; j < nn_indices.size (); ++j)             // nn_indices[0] should be sq_idx
       {
         if (nn_indices[j] == -1 || processed[nn_indices[j]])        // Has this point been processed before ?
@@ -181,21 +189,19 @@ pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
     // If this queue is satisfactory, add to the clusters
     if (seed_queue.size () >= min_pts_per_cluster && seed_queue.size () <= max_pts_per_cluster)
     {
-      pcl::PointIndices r;
-      r.indices.resize (seed_queue.size ());
-      for (size_t j = 0; j < seed_queue.size (); ++j)
-        // This is the only place where indices come into play
-        r.indices[j] = seed_queue[j];
+      // Work directly in the vector, to avoid a copy of the indices
+      clusters.push_back (pcl::PointIndices ());
+      pcl::PointIndices &r = clusters.back ();
+      r.indices.assign (seed_queue.begin (), seed_queue.end ());
 
       // These two lines should not be needed: (can anyone confirm?) -FF
-      //r.indices.assign(seed_queue.begin(), seed_queue.end());
       std::sort (r.indices.begin (), r.indices.end ());
       r.indices.erase (std::unique (r.indices.begin (), r.indices.end ()), r.indices.end ());
 
       r.header = cloud.header;
-      clusters.push_back (r);   // We could avoid a copy by working directly in the vector
     }
   }
+  PCL_PROFILE_COUNTER ("neighbors visited", nr_neighbors);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////
@@ -205,6 +211,7 @@ pcl::extractEuclideanClusters (const PointCloud<PointT> &cloud,
 template <typename PointT> void 
 pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clusters)
 {
+  PCL_PROFILE_METHOD_SCOPE (getClassName (), "extract");
   if (!initCompute () || 
       (input_ != 0   && input_->points.empty ()) ||
       (indices_ != 0 && indices_->empty ()))
@@ -222,6 +229,8 @@ pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clu
       tree_.reset (new pcl::search::KdTree<PointT> (false));
   }
 
+  PCL_PROFILE_COUNTER ("points", indices_->size ());
+
   // Send the input dataset to the spatial locator
   tree_->setInputCloud (input_, indices_);
   extractEuclideanClusters (*input_, *indices_, tree_, static_cast<float> (cluster_tolerance_), clusters, min_pts_per_cluster_, max_pts_per_cluster_);
@@ -231,6 +240,7 @@ pcl::EuclideanClusterExtraction<PointT>::extract (std::vector<PointIndices> &clu
 
   // Sort the clusters based on their size (largest one first)
   std::sort (clusters.rbegin (), clusters.rend (), comparePointClusters);
+  PCL_PROFILE_COUNTER ("clusters", clusters.size ());
 
   deinitCompute ();
 }
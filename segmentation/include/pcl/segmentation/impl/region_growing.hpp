@@ -260,6 +260,7 @@ pcl::RegionGrowing<PointT, NormalT>::setInputNormals (const NormalPtr& norm)
 template <typename PointT, typename NormalT> void
 pcl::RegionGrowing<PointT, NormalT>::extract (std::vector <pcl::PointIndices>& clusters)
 {
+  PCL_PROFILE_SCOPE ("RegionGrowing::extract");
   clusters_.clear ();
   clusters.clear ();
   point_neighbours_.clear ();
@@ -281,8 +282,15 @@ pcl::RegionGrowing<PointT, NormalT>::extract (std::vector <pcl::PointIndices>& c
     return;
   }
 
-  findPointNeighbours ();
-  applySmoothRegionGrowingAlgorithm ();
+  PCL_PROFILE_COUNTER ("points", indices_->size ());
+  {
+    PCL_PROFILE_SCOPE ("findPointNeighbours");
+    findPointNeighbours ();
+  }
+  {
+    PCL_PROFILE_SCOPE ("applySmoothRegionGrowingAlgorithm");
+    applySmoothRegionGrowingAlgorithm ();
+  }
   assembleRegions ();
 
   std::vector<pcl::PointIndices>::iterator cluster_iter = clusters_.begin ();
@@ -70,6 +70,7 @@
 template <typename PointT> void
 pcl::SACSegmentation<PointT>::segment (PointIndices &inliers, ModelCoefficients &model_coefficients)
 {
+  PCL_PROFILE_METHOD_SCOPE (getClassName (), "segment");
   // Copy the header information
   inliers.header = model_coefficients.header = input_->header;
 
@@ -78,6 +79,7 @@ pcl::SACSegmentation<PointT>::segment (PointIndices &inliers, ModelCoefficients
     inliers.indices.clear (); model_coefficients.values.clear ();
     return;
   }
+  PCL_PROFILE_COUNTER ("points", indices_->size ());
 
   // Initialize the Sample Consensus model and set its parameters
   if (!initSACModel (model_type_))
@@ -120,6 +122,7 @@ pcl::SACSegmentation<PointT>::segment (PointIndices &inliers, ModelCoefficients
     model_coefficients.values.resize (coeff.size ());
     memcpy (&model_coefficients.values[0], &coeff[0], coeff.size () * sizeof (float));
   }
+  PCL_PROFILE_COUNTER ("inliers", inliers.indices.size ());
 
   deinitCompute ();
 }
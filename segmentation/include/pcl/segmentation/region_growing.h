@@ -41,6 +41,7 @@
 #define PCL_REGION_GROWING_H_
 
 #include <pcl/pcl_base.h>
+#include <pcl/common/profiler.h>
 #include <pcl/search/search.h>
 #include <pcl/point_cloud.h>
 #include <pcl/point_types.h>
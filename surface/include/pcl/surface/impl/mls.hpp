@@ -161,12 +161,8 @@ pcl::MovingLeastSquares<PointInT, PointOutT>::computeMLSPointNormal (int index,
   EIGEN_ALIGN16 Eigen::Matrix3f covariance_matrix;
   Eigen::Vector4f xyz_centroid;
 
-  // Estimate the XYZ centroid
-  pcl::compute3DCentroid (input, nn_indices, xyz_centroid);
-  //pcl::compute3DCentroid (input, nn_indices, xyz_centroid);
-
-  pcl::computeCovarianceMatrix (input, nn_indices, xyz_centroid, covariance_matrix);
-  // Compute the 3x3 covariance matrix
+  // Estimate the XYZ centroid and compute the 3x3 covariance matrix in a single pass
+  pcl::computeMeanAndCovarianceMatrix (input, nn_indices, covariance_matrix, xyz_centroid);
 
   EIGEN_ALIGN16 Eigen::Vector3f::Scalar eigen_value;
   EIGEN_ALIGN16 Eigen::Vector3f eigen_vector;
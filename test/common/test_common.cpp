@@ -47,6 +47,13 @@
 #include <pcl/point_cloud.h>
 
 #include <pcl/common/centroid.h>
+#include <pcl/common/frame_arena.h>
+#include <pcl/common/profiler.h>
+#include <pcl/common/time.h>
+#include <pcl/common/quantization.h>
+#include <pcl/common/transforms.h>
+#include <pcl/point_cloud_soa.h>
+#include <pcl/range_image/range_image_planar.h>
 
 using namespace pcl;
 
@@ -144,6 +151,109 @@ TEST (PCL, Common)
   EXPECT_NEAR (point2line_disance, sqrt(2.0)/2, 1e-4);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, BoundingBox)
+{
+  // Large enough to be split into several parallel chunks
+  PointCloud<PointXYZ> cloud;
+  cloud.width = 300007;
+  cloud.height = 1;
+  cloud.points.resize (cloud.width);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud.points[i].x = static_cast<float> (i % 1001) * 0.01f - 5.0f;
+    cloud.points[i].y = static_cast<float> ((i * 13) % 777) * 0.02f;
+    cloud.points[i].z = static_cast<float> ((i * 7) % 501) * -0.03f;
+  }
+  // The farthest point from the origin, twice
+  cloud.points[200000].x = cloud.points[250000].x = 100.0f;
+  cloud.points[200000].y = cloud.points[250000].y = 0.0f;
+  cloud.points[200000].z = cloud.points[250000].z = 0.0f;
+
+  Eigen::Vector4f min_pt, max_pt;
+  for (unsigned int nr_threads = 1; nr_threads <= 4; nr_threads += 3)
+  {
+    getMinMax3D (cloud, min_pt, max_pt, nr_threads);
+    EXPECT_EQ (min_pt[0], -5.0f);
+    EXPECT_EQ (max_pt[0], 100.0f);
+    EXPECT_EQ (min_pt[1], 0.0f);
+    EXPECT_EQ (max_pt[1], 776 * 0.02f);
+    EXPECT_EQ (min_pt[2], 500 * -0.03f);
+    EXPECT_EQ (max_pt[2], 0.0f);
+
+    getMaxDistance (cloud, Eigen::Vector4f::Zero (), max_pt, nr_threads);
+    EXPECT_EQ (max_pt[0], 100.0f);
+
+    // Ties go to the first point in the indices
+    std::vector<int> indices;
+    indices.push_back (250000);
+    indices.push_back (3);
+    indices.push_back (200000);
+    cloud.points[250000].y = 1.0f;
+    cloud.points[200000].y = -1.0f;
+    getMaxDistance (cloud, indices, Eigen::Vector4f::Zero (), max_pt, nr_threads);
+    EXPECT_EQ (max_pt[1], 1.0f);
+    getMinMax3D (cloud, indices, min_pt, max_pt, nr_threads);
+    EXPECT_EQ (min_pt[1], -1.0f);
+    EXPECT_EQ (max_pt[1], 1.0f);
+    cloud.points[250000].y = cloud.points[200000].y = 0.0f;
+
+    Eigen::Vector4f box_min (-1.0f, -1.0f, -0.5f, 0.0f), box_max (1.0f, 1.0f, 0.0f, 0.0f);
+    std::vector<int> in_box;
+    getPointsInBox (cloud, box_min, box_max, in_box, nr_threads);
+    std::vector<int> expected;
+    for (int i = 0; i < static_cast<int> (cloud.points.size ()); ++i)
+    {
+      const PointXYZ &p = cloud.points[i];
+      if (p.x >= -1.0f && p.x <= 1.0f && p.y >= -1.0f && p.y <= 1.0f && p.z >= -0.5f && p.z <= 0.0f)
+        expected.push_back (i);
+    }
+    EXPECT_FALSE (expected.empty ());
+    EXPECT_TRUE (in_box == expected);
+  }
+
+  // Non finite points are skipped
+  cloud.is_dense = false;
+  cloud.points[10].x = std::numeric_limits<float>::quiet_NaN ();
+  cloud.points[11].y = -std::numeric_limits<float>::infinity ();
+  cloud.points[12].x = cloud.points[12].y = cloud.points[12].z = 0.0f;
+  cloud.points[12].z = std::numeric_limits<float>::infinity ();
+  for (unsigned int nr_threads = 1; nr_threads <= 4; nr_threads += 3)
+  {
+    getMinMax3D (cloud, min_pt, max_pt, nr_threads);
+    EXPECT_EQ (min_pt[0], -5.0f);
+    EXPECT_EQ (min_pt[1], 0.0f);
+    EXPECT_EQ (max_pt[2], 0.0f);
+
+    getMaxDistance (cloud, Eigen::Vector4f::Zero (), max_pt, nr_threads);
+    EXPECT_EQ (max_pt[0], 100.0f);
+
+    Eigen::Vector4f box_min (-1.0f, -1.0f, -1.0f, 0.0f);
+    Eigen::Vector4f box_max (1.0f, 1.0f, std::numeric_limits<float>::infinity (), 0.0f);
+    std::vector<int> in_box;
+    getPointsInBox (cloud, box_min, box_max, in_box, nr_threads);
+    EXPECT_TRUE (std::find (in_box.begin (), in_box.end (), 10) == in_box.end ());
+    EXPECT_TRUE (std::find (in_box.begin (), in_box.end (), 12) == in_box.end ());
+  }
+
+  // Only non finite points
+  PointCloud<PointXYZ> invalid;
+  invalid.points.resize (2);
+  invalid.points[0].x = invalid.points[1].y = std::numeric_limits<float>::quiet_NaN ();
+  invalid.is_dense = false;
+  getMaxDistance (invalid, Eigen::Vector4f::Zero (), max_pt);
+  EXPECT_FALSE (pcl_isfinite (max_pt[0]));
+
+  // Unpadded point types
+  PointCloud<PointXYZPacked> packed;
+  copyPointCloud (cloud, packed);
+  getMinMax3D (packed, min_pt, max_pt, 4);
+  EXPECT_EQ (min_pt[0], -5.0f);
+  EXPECT_EQ (max_pt[0], 100.0f);
+  getMaxDistance (packed, Eigen::Vector4f::Zero (), max_pt, 4);
+  EXPECT_EQ (max_pt[0], 100.0f);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, Eigen)
 {
@@ -295,6 +405,218 @@ TEST (PCL, PointTypes)
   EXPECT_EQ (__alignof (PointNormal), 16);
   EXPECT_EQ (sizeof (PointXYZRGBNormal), 48);
   EXPECT_EQ (__alignof (PointXYZRGBNormal), 16);
+
+  EXPECT_EQ (sizeof (PointXYZPacked), 12);
+  EXPECT_EQ (sizeof (PointXYZRGBPacked), 16);
+  EXPECT_EQ (sizeof (PointXYZRGBNormalPacked), 32);
+  EXPECT_EQ (sizeof (PointXYZQuantized), 6);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, CompactPointTypes)
+{
+  PointCloud<PointXYZRGBNormal> cloud, cloud2;
+  cloud.width = 4;
+  cloud.height = 2;
+  cloud.points.resize (cloud.width * cloud.height);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud.points[i].x = static_cast<float> (i);
+    cloud.points[i].y = static_cast<float> (i) * 2.0f;
+    cloud.points[i].z = static_cast<float> (i) * -3.0f;
+    cloud.points[i].r = static_cast<uint8_t> (i);
+    cloud.points[i].g = static_cast<uint8_t> (i + 1);
+    cloud.points[i].b = static_cast<uint8_t> (i + 2);
+    cloud.points[i].normal_x = 1.0f;
+    cloud.points[i].curvature = static_cast<float> (i) * 0.5f;
+  }
+
+  // Padded -> packed -> padded
+  PointCloud<PointXYZRGBNormalPacked> packed;
+  copyPointCloud (cloud, packed);
+  EXPECT_EQ (packed.width, cloud.width);
+  EXPECT_EQ (packed.height, cloud.height);
+  EXPECT_EQ (packed.points[3].getVector3fMap (), cloud.points[3].getVector3fMap ());
+  EXPECT_EQ (packed.points[3].getNormalVector3fMap (), cloud.points[3].getNormalVector3fMap ());
+  copyPointCloud (packed, cloud2);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    EXPECT_EQ (cloud2.points[i].x, cloud.points[i].x);
+    EXPECT_EQ (cloud2.points[i].y, cloud.points[i].y);
+    EXPECT_EQ (cloud2.points[i].z, cloud.points[i].z);
+    EXPECT_EQ (cloud2.points[i].rgba, cloud.points[i].rgba);
+    EXPECT_EQ (cloud2.points[i].normal_x, cloud.points[i].normal_x);
+    EXPECT_EQ (cloud2.points[i].curvature, cloud.points[i].curvature);
+  }
+
+  PointCloud<PointXYZRGBPacked> packed_rgb;
+  copyPointCloud (cloud, packed_rgb);
+  EXPECT_EQ (packed_rgb.points[5].r, 5);
+  EXPECT_EQ (packed_rgb.points[5].b, 7);
+  EXPECT_EQ (packed_rgb.points[5].z, -15.0f);
+
+  // Bounding box by name
+  PointCloud<PointXYZPacked> packed_xyz;
+  copyPointCloud (cloud, packed_xyz);
+  Eigen::Vector4f min_pt, max_pt;
+  getMinMax3D (packed_xyz, min_pt, max_pt);
+  EXPECT_EQ (min_pt[0], 0.0f);
+  EXPECT_EQ (max_pt[1], 14.0f);
+  EXPECT_EQ (min_pt[2], -21.0f);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, Quantization)
+{
+  const Eigen::Vector3f origin (100.0f, -50.0f, 0.0f);
+  const float step = 0.001f;
+
+  PointCloud<PointXYZ> cloud, cloud2;
+  cloud.width = 3;
+  cloud.height = 2;
+  cloud.points.resize (cloud.width * cloud.height);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud.points[i].x = origin[0] + static_cast<float> (i) * 1.2345f;
+    cloud.points[i].y = origin[1] - static_cast<float> (i) * 3.21f;
+    cloud.points[i].z = origin[2] + 32.0f;
+  }
+
+  PointCloud<PointXYZQuantized> quantized;
+  EXPECT_EQ (quantizePointCloud (cloud, origin, step, quantized), 0);
+  EXPECT_EQ (quantized.width, cloud.width);
+  EXPECT_EQ (quantized.height, cloud.height);
+  EXPECT_EQ (quantized.points[2].z, 32000);
+
+  dequantizePointCloud (quantized, origin, step, cloud2);
+  ASSERT_EQ (cloud2.points.size (), cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    EXPECT_NEAR (cloud2.points[i].x, cloud.points[i].x, step);
+    EXPECT_NEAR (cloud2.points[i].y, cloud.points[i].y, step);
+    EXPECT_NEAR (cloud2.points[i].z, cloud.points[i].z, step);
+  }
+
+  // Non finite points and points outside of the tile are dropped
+  cloud.points[1].x = std::numeric_limits<float>::quiet_NaN ();
+  cloud.points[4].z = origin[2] + 40.0f;
+  EXPECT_EQ (quantizePointCloud (cloud, origin, step, quantized), 2);
+  EXPECT_EQ (quantized.width, 4);
+  EXPECT_EQ (quantized.height, 1);
+  EXPECT_EQ (quantized.points[1].x, 2469);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PointCloudSoA)
+{
+  // 103 points, so that the SSE kernels have a scalar tail
+  PointCloud<PointXYZI> cloud;
+  cloud.width = 103;
+  cloud.height = 1;
+  cloud.points.resize (cloud.width);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud.points[i].x = static_cast<float> (i % 7) - 3.5f;
+    cloud.points[i].y = static_cast<float> (i) * 0.25f;
+    cloud.points[i].z = 10.0f - static_cast<float> (i % 13);
+    cloud.points[i].intensity = static_cast<float> (i);
+  }
+
+  PointCloudSoA soa;
+  soa.addChannel ("intensity");
+  soa.addChannel ("curvature");
+  copyPointCloud (cloud, soa);
+  EXPECT_EQ (soa.size (), cloud.points.size ());
+  EXPECT_EQ (soa.width, cloud.width);
+  EXPECT_TRUE (soa.is_dense);
+  // PointXYZI has no curvature
+  EXPECT_TRUE (soa.getChannel ("curvature") == NULL);
+  ASSERT_TRUE (soa.getChannel ("intensity") != NULL);
+  EXPECT_EQ ((*soa.getChannel ("intensity"))[42], 42.0f);
+  EXPECT_EQ (soa.getChannelNames ().size (), 1);
+
+  PointCloud<PointXYZI> cloud2;
+  copyPointCloud (soa, cloud2);
+  ASSERT_EQ (cloud2.points.size (), cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    EXPECT_EQ (cloud2.points[i].x, cloud.points[i].x);
+    EXPECT_EQ (cloud2.points[i].y, cloud.points[i].y);
+    EXPECT_EQ (cloud2.points[i].z, cloud.points[i].z);
+    EXPECT_EQ (cloud2.points[i].intensity, cloud.points[i].intensity);
+  }
+
+  // Kernels against their array of structures versions
+  Eigen::Vector4f min_pt, max_pt, min_soa, max_soa;
+  getMinMax3D (cloud, min_pt, max_pt);
+  getMinMax3D (soa, min_soa, max_soa);
+  EXPECT_EQ (min_soa, min_pt);
+  EXPECT_EQ (max_soa, max_pt);
+
+  Eigen::Vector4f centroid, centroid_soa;
+  compute3DCentroid (cloud, centroid);
+  EXPECT_EQ (compute3DCentroid (soa, centroid_soa), 103);
+  for (int d = 0; d < 4; ++d)
+    EXPECT_NEAR (centroid_soa[d], centroid[d], 1e-4);
+
+  Eigen::Affine3f transform = Eigen::Affine3f::Identity ();
+  transform.rotate (Eigen::AngleAxisf (0.3f, Eigen::Vector3f (1.0f, 2.0f, 3.0f).normalized ()));
+  transform.translation () << 1.0f, -2.0f, 0.5f;
+  PointCloud<PointXYZI> cloud_t;
+  PointCloudSoA soa_t;
+  transformPointCloud (cloud, cloud_t, transform);
+  transformPointCloud (soa, soa_t, transform);
+  ASSERT_EQ (soa_t.size (), cloud_t.points.size ());
+  ASSERT_TRUE (soa_t.getChannel ("intensity") != NULL);
+  for (size_t i = 0; i < cloud_t.points.size (); ++i)
+  {
+    EXPECT_NEAR (soa_t.x[i], cloud_t.points[i].x, 1e-4);
+    EXPECT_NEAR (soa_t.y[i], cloud_t.points[i].y, 1e-4);
+    EXPECT_NEAR (soa_t.z[i], cloud_t.points[i].z, 1e-4);
+    EXPECT_EQ ((*soa_t.getChannel ("intensity"))[i], cloud_t.points[i].intensity);
+  }
+  // In place
+  transformPointCloud (soa, soa, transform);
+  EXPECT_EQ (soa.x, soa_t.x);
+  EXPECT_EQ (soa.z, soa_t.z);
+  copyPointCloud (cloud, soa);
+
+  const Eigen::Vector4f plane (0.0f, 0.6f, 0.8f, -1.0f);
+  const Eigen::Vector3f pivot (1.0f, 2.0f, 3.0f);
+  std::vector<float> plane_distances, distances;
+  getPlaneDistances (soa, plane, plane_distances);
+  getSquaredDistances (soa, pivot, distances);
+  ASSERT_EQ (plane_distances.size (), cloud.points.size ());
+  ASSERT_EQ (distances.size (), cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    Eigen::Vector4f pt (cloud.points[i].x, cloud.points[i].y, cloud.points[i].z, 1.0f);
+    EXPECT_NEAR (plane_distances[i], fabs (plane.dot (pt)), 1e-4);
+    EXPECT_NEAR (distances[i], (cloud.points[i].getVector3fMap () - pivot).squaredNorm (), 1e-3);
+  }
+
+  // Non finite points are skipped
+  cloud.is_dense = false;
+  cloud.points[5].x = std::numeric_limits<float>::quiet_NaN ();
+  cloud.points[101].z = std::numeric_limits<float>::infinity ();
+  copyPointCloud (cloud, soa);
+  EXPECT_FALSE (soa.is_dense);
+  getMinMax3D (cloud, min_pt, max_pt);
+  getMinMax3D (soa, min_soa, max_soa);
+  EXPECT_EQ (min_soa, min_pt);
+  EXPECT_EQ (max_soa, max_pt);
+  compute3DCentroid (cloud, centroid);
+  EXPECT_EQ (compute3DCentroid (soa, centroid_soa), 101);
+  for (int d = 0; d < 4; ++d)
+    EXPECT_NEAR (centroid_soa[d], centroid[d], 1e-4);
+  getPlaneDistances (soa, plane, plane_distances);
+  EXPECT_FALSE (pcl_isfinite (plane_distances[5]));
+  EXPECT_FALSE (pcl_isfinite (plane_distances[101]));
+  EXPECT_TRUE (pcl_isfinite (plane_distances[102]));
+
+  soa.clear ();
+  EXPECT_TRUE (soa.empty ());
+  EXPECT_EQ (compute3DCentroid (soa, centroid_soa), 0);
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1035,6 +1357,280 @@ TEST (PCL, computeMeanAndCovariance)
   EXPECT_EQ (covariance_matrix (2, 2), 1);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, MeanAndCovarianceAccumulator)
+{
+  // A small patch far from the origin, where E[x x^T] - E[x] E[x]^T cancels out in single precision
+  PointCloud<PointXYZ> cloud;
+  cloud.width = 200003;
+  cloud.height = 1;
+  cloud.points.resize (cloud.width);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud.points[i].x = 1000.0f + static_cast<float> (i % 101) * 0.001f;
+    cloud.points[i].y = -2000.0f + static_cast<float> (i % 37) * 0.002f;
+    cloud.points[i].z = 500.0f + static_cast<float> ((i * 7) % 53) * 0.0005f;
+  }
+
+  // Two pass reference, in double precision
+  Eigen::Vector3d mean = Eigen::Vector3d::Zero ();
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+    mean += cloud.points[i].getVector3fMap ().cast<double> ();
+  mean /= static_cast<double> (cloud.points.size ());
+  Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero ();
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    const Eigen::Vector3d d = cloud.points[i].getVector3fMap ().cast<double> () - mean;
+    covariance += d * d.transpose ();
+  }
+  covariance /= static_cast<double> (cloud.points.size ());
+
+  MeanAndCovarianceAccumulator accumulator;
+  accumulator.add (cloud);
+  EXPECT_EQ (accumulator.getNumberOfPoints (), cloud.points.size ());
+  Eigen::Vector4d centroid;
+  Eigen::Matrix3d covariance_matrix;
+  accumulator.getCentroid (centroid);
+  accumulator.getCovarianceMatrix (covariance_matrix);
+  EXPECT_EQ (centroid[3], 0);
+  for (int d = 0; d < 3; ++d)
+    EXPECT_NEAR (centroid[d], mean[d], 1e-6);
+  for (int d = 0; d < 9; ++d)
+    EXPECT_NEAR (covariance_matrix (d), covariance (d), 1e-8);
+
+  Eigen::Vector4f centroid_f;
+  Eigen::Matrix3f covariance_matrix_f;
+  EXPECT_EQ (computeMeanAndCovarianceMatrix (cloud, covariance_matrix_f, centroid_f), cloud.points.size ());
+  for (int d = 0; d < 9; ++d)
+    EXPECT_NEAR (covariance_matrix_f (d), covariance (d), 1e-8);
+
+  // The result does not depend on the number of threads
+  MeanAndCovarianceAccumulator accumulator_mt;
+  accumulator_mt.add (cloud, 4);
+  Eigen::Matrix3d covariance_matrix_mt;
+  accumulator_mt.getCovarianceMatrix (covariance_matrix_mt);
+  EXPECT_TRUE (covariance_matrix_mt == covariance_matrix);
+
+  // Merging the accumulators of two halves, and adding single points
+  std::vector<int> first_half, second_half;
+  for (int i = 0; i < static_cast<int> (cloud.points.size ()); ++i)
+    (i < 70000 ? first_half : second_half).push_back (i);
+  MeanAndCovarianceAccumulator accumulator_a, accumulator_b;
+  accumulator_a.add (cloud, first_half);
+  for (size_t i = 0; i < second_half.size (); ++i)
+    accumulator_b.add (cloud.points[second_half[i]]);
+  accumulator_a.merge (accumulator_b);
+  EXPECT_EQ (accumulator_a.getNumberOfPoints (), cloud.points.size ());
+  accumulator_a.getCentroid (centroid);
+  accumulator_a.getCovarianceMatrix (covariance_matrix);
+  for (int d = 0; d < 3; ++d)
+    EXPECT_NEAR (centroid[d], mean[d], 1e-6);
+  for (int d = 0; d < 9; ++d)
+    EXPECT_NEAR (covariance_matrix (d), covariance (d), 1e-8);
+
+  // Non finite points are skipped
+  cloud.is_dense = false;
+  cloud.points[3].x = std::numeric_limits<float>::quiet_NaN ();
+  accumulator.clear ();
+  EXPECT_EQ (accumulator.getNumberOfPoints (), 0);
+  accumulator.add (cloud, 0);
+  EXPECT_EQ (accumulator.getNumberOfPoints (), cloud.points.size () - 1);
+  accumulator.getCentroid (centroid);
+  EXPECT_TRUE (pcl_isfinite (centroid[0]));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, RangeImageThreads)
+{
+  // A noisy wall in front of the sensor, with several points per pixel from different chunks
+  PointCloud<PointXYZ> cloud;
+  cloud.width = 100000;
+  cloud.height = 1;
+  cloud.points.resize (cloud.width);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    const float angle = static_cast<float> (i % 499) * 0.002f;
+    const float radius = 3.0f + 0.05f * static_cast<float> ((i * 7919) % 101) / 101.0f;
+    cloud.points[i].x = radius * sinf (angle);
+    cloud.points[i].y = static_cast<float> ((i * 31) % 97) / 97.0f - 0.5f;
+    cloud.points[i].z = radius * cosf (angle);
+  }
+  cloud.points[5].x = std::numeric_limits<float>::quiet_NaN ();
+  cloud.is_dense = false;
+
+  // The points are averaged within the noise level, so that their order matters
+  const int max_no_of_threads = RangeImage::max_no_of_threads;
+  RangeImage serial, parallel;
+  RangeImage::max_no_of_threads = 1;
+  serial.createFromPointCloud (cloud, deg2rad (0.2f), deg2rad (360.0f), deg2rad (180.0f),
+                               Eigen::Affine3f::Identity (), RangeImage::CAMERA_FRAME, 0.02f, 0.0f, 1);
+  RangeImage::max_no_of_threads = 4;
+  parallel.createFromPointCloud (cloud, deg2rad (0.2f), deg2rad (360.0f), deg2rad (180.0f),
+                                 Eigen::Affine3f::Identity (), RangeImage::CAMERA_FRAME, 0.02f, 0.0f, 1);
+  ASSERT_EQ (parallel.width, serial.width);
+  ASSERT_EQ (parallel.height, serial.height);
+  int nr_valid = 0;
+  for (size_t i = 0; i < serial.points.size (); ++i)
+  {
+    if (!pcl_isfinite (serial.points[i].range))
+    {
+      EXPECT_EQ (serial.points[i].range, parallel.points[i].range);
+      continue;
+    }
+    ++nr_valid;
+    EXPECT_EQ (serial.points[i].range, parallel.points[i].range);
+    EXPECT_EQ (serial.points[i].x, parallel.points[i].x);
+    EXPECT_EQ (serial.points[i].z, parallel.points[i].z);
+  }
+  EXPECT_GT (nr_valid, 1000);
+
+  // Depth images
+  std::vector<float> depth_image (640*480);
+  for (size_t i = 0; i < depth_image.size (); ++i)
+    depth_image[i] = (i % 13 == 0) ? 0.0f : 1.0f + static_cast<float> (i % 641) * 0.001f;
+  RangeImagePlanar serial_planar, parallel_planar;
+  RangeImage::max_no_of_threads = 1;
+  serial_planar.setDepthImage (&depth_image[0], 640, 480, 319.5f, 239.5f, 525.0f, 525.0f);
+  RangeImage::max_no_of_threads = 4;
+  parallel_planar.setDepthImage (&depth_image[0], 640, 480, 319.5f, 239.5f, 525.0f, 525.0f);
+  RangeImage::max_no_of_threads = max_no_of_threads;
+  ASSERT_EQ (parallel_planar.points.size (), serial_planar.points.size ());
+  for (size_t i = 0; i < serial_planar.points.size (); ++i)
+  {
+    if (pcl_isfinite (serial_planar.points[i].range))
+    {
+      EXPECT_EQ (serial_planar.points[i].range, parallel_planar.points[i].range);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, FrameArena)
+{
+  FrameArena arena;
+  PointCloud<PointXYZ>::Ptr cloud = arena.getPointCloud<PointXYZ> ();
+  boost::shared_ptr<std::vector<int> > indices = arena.getIndices ();
+  cloud->points.resize (1000);
+  cloud->width = 1000;
+  cloud->height = 1;
+  cloud->is_dense = false;
+  indices->resize (500, 3);
+  const PointXYZ* points = &cloud->points[0];
+  const int* index_data = &(*indices)[0];
+  EXPECT_EQ (int (arena.getNumberOfAllocations ()), 2);
+  EXPECT_EQ (int (arena.getNumberOfReuses ()), 0);
+
+  // objects still in use are not handed out twice
+  boost::shared_ptr<std::vector<int> > other_indices = arena.getIndices ();
+  EXPECT_NE (other_indices.get (), indices.get ());
+  EXPECT_EQ (int (arena.getNumberOfObjects ()), 3);
+
+  // released objects come back empty, with their capacity
+  cloud.reset ();
+  indices.reset ();
+  other_indices.reset ();
+  arena.reset ();
+  cloud = arena.getPointCloud<PointXYZ> ();
+  indices = arena.getIndices ();
+  EXPECT_EQ (int (arena.getNumberOfAllocations ()), 0);
+  EXPECT_EQ (int (arena.getNumberOfReuses ()), 2);
+  EXPECT_TRUE (cloud->points.empty ());
+  EXPECT_EQ (int (cloud->width), 0);
+  EXPECT_EQ (int (cloud->height), 0);
+  EXPECT_TRUE (cloud->is_dense);
+  EXPECT_TRUE (indices->empty ());
+  EXPECT_GE (int (cloud->points.capacity ()), 1000);
+  cloud->points.resize (1000);
+  EXPECT_EQ (&cloud->points[0], points);
+  indices->resize (500);
+  EXPECT_EQ (&(*indices)[0], index_data);
+
+  // the objects not requested during a frame are released by the next reset
+  cloud.reset ();
+  indices.reset ();
+  arena.reset ();
+  EXPECT_EQ (int (arena.getNumberOfObjects ()), 2);
+  arena.reset ();
+  EXPECT_EQ (int (arena.getNumberOfObjects ()), 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+size_t
+countOccurrences (const std::string &str, const std::string &pattern)
+{
+  size_t count = 0;
+  for (size_t pos = str.find (pattern); pos != std::string::npos; pos = str.find (pattern, pos + 1))
+    ++count;
+  return (count);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, Profiler)
+{
+  Profiler &profiler = Profiler::getInstance ();
+  profiler.reset ();
+
+  // nothing is recorded while the profiler is disabled
+  {
+    PCL_PROFILE_SCOPE ("disabled");
+    PCL_PROFILE_COUNTER ("points", 1);
+  }
+  std::ostringstream disabled;
+  profiler.writeJSON (disabled);
+  EXPECT_EQ (disabled.str ().find ("disabled"), std::string::npos);
+
+  profiler.setEnabled (true);
+  int nr_workers = 0;
+  {
+    PCL_PROFILE_SCOPE ("outer");
+    PCL_PROFILE_COUNTER ("frames", 1);
+    for (int i = 0; i < 3; ++i)
+    {
+      PCL_PROFILE_METHOD_SCOPE (std::string ("Inner"), "compute");
+      PCL_PROFILE_COUNTER ("points", 10);
+    }
+    // without OpenMP, or with fewer threads granted, the region runs on fewer than 4 threads
+#pragma omp parallel num_threads(4)
+    {
+#pragma omp atomic
+      ++nr_workers;
+      PCL_PROFILE_SCOPE ("worker");
+      PCL_PROFILE_COUNTER ("points", 5);
+    }
+    ScopeTime scope_time ("scope time");
+  }
+  profiler.setEnabled (false);
+
+  std::ostringstream report;
+  profiler.writeReport (report);
+  EXPECT_NE (report.str ().find ("outer  calls 1"), std::string::npos);
+  EXPECT_NE (report.str ().find ("\n  Inner::compute  calls 3"), std::string::npos);
+  EXPECT_NE (report.str ().find ("[points 30]"), std::string::npos);
+  EXPECT_NE (report.str ().find ("\n  scope time  calls 1"), std::string::npos);
+
+  std::ostringstream json;
+  profiler.writeJSON (json);
+  EXPECT_EQ (countOccurrences (json.str (), "\"name\": \"outer\""), 1);
+  EXPECT_EQ (countOccurrences (json.str (), "\"name\": \"Inner::compute\""), 1);
+  EXPECT_NE (json.str ().find ("\"counters\": {\"frames\": 1}"), std::string::npos);
+  EXPECT_NE (json.str ().find ("\"counters\": {\"points\": 30}"), std::string::npos);
+  // the master thread opens its worker scope in the outer one, the other threads at the top level
+  EXPECT_GE (countOccurrences (json.str (), "\"name\": \"worker\""), 1);
+  EXPECT_LE (countOccurrences (json.str (), "\"name\": \"worker\""), 2);
+
+  std::ostringstream trace;
+  profiler.writeChromeTrace (trace);
+  EXPECT_EQ (countOccurrences (trace.str (), "\"ph\": \"X\""), 1 + 3 + nr_workers + 1);
+  EXPECT_EQ (countOccurrences (trace.str (), "\"name\": \"Inner::compute\""), 3);
+  EXPECT_EQ (countOccurrences (trace.str (), "\"args\": {\"points\": 10}"), 3);
+  EXPECT_EQ (countOccurrences (trace.str (), "\"args\": {\"points\": 5}"), nr_workers);
+
+  profiler.reset ();
+  std::ostringstream empty;
+  profiler.writeChromeTrace (empty);
+  EXPECT_EQ (countOccurrences (empty.str (), "\"ph\": \"X\""), 0);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, CopyIfFieldExists)
 {
@@ -0,0 +1,200 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <pcl/common/task_scheduler.h>
+#include <boost/thread/thread.hpp>
+
+#include <algorithm>
+#include <vector>
+
+using namespace pcl;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+struct CountVisits
+{
+  void
+  operator () (int begin, int end) const
+  {
+    for (int i = begin; i < end; ++i)
+      ++(*visits)[i];
+  }
+  std::vector<int> *visits;
+};
+
+struct SumRange
+{
+  SumRange () : sum (0) {}
+  void
+  operator () (int begin, int end)
+  {
+    for (int i = begin; i < end; ++i)
+      sum += i;
+  }
+  void
+  join (const SumRange &other)
+  {
+    sum += other.sum;
+  }
+  long long sum;
+};
+
+struct NestedLoop
+{
+  void
+  operator () (int begin, int end) const
+  {
+    for (int i = begin; i < end; ++i)
+    {
+      CountVisits inner;
+      inner.visits = &(*visits)[i];
+      pcl::parallel_for (0, static_cast<int> (inner.visits->size ()), inner, 1);
+    }
+  }
+  std::vector<std::vector<int> > *visits;
+};
+
+struct ReduceInThread
+{
+  void
+  operator () () const
+  {
+    for (int i = 0; i < 20; ++i)
+    {
+      SumRange sum;
+      pcl::parallel_reduce (0, 100000, sum, 100);
+      if (sum.sum != 4999950000LL)
+        ++(*errors);
+    }
+  }
+  int *errors;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (TaskScheduler, ParallelFor)
+{
+  // every iteration is run once, whatever the grain size and the number of threads
+  const int grain_sizes[] = {0, 1, 7, 1000, 20000};
+  for (int g = 0; g < 5; ++g)
+  {
+    for (unsigned int t = 0; t <= 5; ++t)
+    {
+      std::vector<int> visits (10007, 0);
+      CountVisits count;
+      count.visits = &visits;
+      pcl::parallel_for (3, 10007, count, grain_sizes[g], t);
+      EXPECT_EQ (std::count (visits.begin (), visits.begin () + 3, 0), 3);
+      EXPECT_EQ (std::count (visits.begin () + 3, visits.end (), 1), 10004);
+    }
+  }
+
+  // empty ranges
+  std::vector<int> none (1, 0);
+  CountVisits count_none;
+  count_none.visits = &none;
+  pcl::parallel_for (5, 5, count_none);
+  pcl::parallel_for (5, 0, count_none);
+  EXPECT_EQ (none[0], 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (TaskScheduler, ParallelReduce)
+{
+  SumRange sum;
+  pcl::parallel_reduce (0, 100000, sum);
+  EXPECT_EQ (sum.sum, 4999950000LL);
+  SumRange sum_single;
+  pcl::parallel_reduce (0, 100000, sum_single, 10, 1);
+  EXPECT_EQ (sum_single.sum, 4999950000LL);
+  SumRange sum_empty;
+  pcl::parallel_reduce (10, 10, sum_empty);
+  EXPECT_EQ (sum_empty.sum, 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (TaskScheduler, Nesting)
+{
+  // nested loops run on the same threads
+  std::vector<std::vector<int> > nested_visits (50, std::vector<int> (200, 0));
+  NestedLoop nested;
+  nested.visits = &nested_visits;
+  pcl::parallel_for (0, 50, nested, 1);
+  for (size_t i = 0; i < nested_visits.size (); ++i)
+    EXPECT_EQ (std::count (nested_visits[i].begin (), nested_visits[i].end (), 1), 200);
+
+  // application threads share the workers
+  int errors[4] = {0, 0, 0, 0};
+  boost::thread_group threads;
+  for (int i = 0; i < 4; ++i)
+  {
+    ReduceInThread reduce;
+    reduce.errors = &errors[i];
+    threads.create_thread (reduce);
+  }
+  threads.join_all ();
+  EXPECT_EQ (errors[0] + errors[1] + errors[2] + errors[3], 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (TaskScheduler, NumberOfThreads)
+{
+  TaskScheduler &scheduler = TaskScheduler::getInstance ();
+  EXPECT_FALSE (scheduler.isWorkerThread ());
+  EXPECT_EQ (scheduler.getNumberOfThreads (), 4u);
+
+  scheduler.setNumberOfThreads (1);
+  EXPECT_EQ (scheduler.getNumberOfThreads (), 1u);
+  SumRange serial_sum;
+  pcl::parallel_reduce (0, 100000, serial_sum);
+  EXPECT_EQ (serial_sum.sum, 4999950000LL);
+
+  scheduler.setNumberOfThreads (4);
+  EXPECT_EQ (scheduler.getNumberOfThreads (), 4u);
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  // several workers, even on a single core machine
+  TaskScheduler::getInstance ().setNumberOfThreads (4);
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
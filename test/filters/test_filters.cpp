@@ -57,6 +57,7 @@
 
 #include <pcl/common/transforms.h>
 #include <pcl/common/eigen.h>
+#include <pcl/common/quantization.h>
 
 using namespace pcl;
 using namespace pcl::io;
@@ -965,6 +966,107 @@ TEST (VoxelGrid_XYZNormal, Filters)
 
 #endif
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (VoxelGrid_Compact, Filters)
+{
+  PointCloud<PointXYZ> output;
+  VoxelGrid<PointXYZ> grid;
+  grid.setLeafSize (0.02f, 0.02f, 0.02f);
+  grid.setInputCloud (cloud);
+  grid.filter (output);
+
+  // Same centroids without the padding
+  PointCloud<PointXYZPacked>::Ptr packed (new PointCloud<PointXYZPacked>);
+  copyPointCloud (*cloud, *packed);
+  PointCloud<PointXYZPacked> output_packed;
+  VoxelGrid<PointXYZPacked> grid_packed;
+  grid_packed.setLeafSize (0.02f, 0.02f, 0.02f);
+  grid_packed.setInputCloud (packed);
+  grid_packed.filter (output_packed);
+
+  ASSERT_EQ (output_packed.points.size (), output.points.size ());
+  for (size_t i = 0; i < output.points.size (); ++i)
+  {
+    EXPECT_EQ (output_packed.points[i].x, output.points[i].x);
+    EXPECT_EQ (output_packed.points[i].y, output.points[i].y);
+    EXPECT_EQ (output_packed.points[i].z, output.points[i].z);
+  }
+
+  grid_packed.setFilterFieldName ("z");
+  grid_packed.setFilterLimits (0.05, 0.1);
+  grid_packed.filter (output_packed);
+  EXPECT_EQ (int (output_packed.points.size ()), 14);
+  EXPECT_NEAR (output_packed.points[0].x, -0.026125, 1e-4);
+  EXPECT_NEAR (output_packed.points[0].y, 0.039788, 1e-4);
+  EXPECT_NEAR (output_packed.points[0].z, 0.052827, 1e-4);
+
+  // Quantized coordinates, with a leaf size in quantization steps
+  PointCloud<PointXYZQuantized>::Ptr quantized (new PointCloud<PointXYZQuantized>);
+  EXPECT_EQ (int (quantizePointCloud (*cloud, Eigen::Vector3f::Zero (), 0.001f, *quantized)), 0);
+  PointCloud<PointXYZQuantized> output_quantized;
+  VoxelGrid<PointXYZQuantized> grid_quantized;
+  grid_quantized.setLeafSize (20.0f, 20.0f, 20.0f);
+  grid_quantized.setInputCloud (quantized);
+  grid_quantized.filter (output_quantized);
+  EXPECT_EQ (int (output_quantized.points.size ()), 99);
+  EXPECT_EQ (int (output_quantized.width), 99);
+
+  // The quantized centroids are rounded to nearest, on both sides of the origin
+  PointCloud<PointXYZQuantized>::Ptr leaf (new PointCloud<PointXYZQuantized>);
+  leaf->points.push_back (PointXYZQuantized (-5, 5, -1));
+  leaf->points.push_back (PointXYZQuantized (-6, 6, -1));
+  leaf->points.push_back (PointXYZQuantized (-6, 6, -2));
+  leaf->width = 3;
+  leaf->height = 1;
+  grid_quantized.setLeafSize (8.0f, 8.0f, 8.0f);
+  grid_quantized.setInputCloud (leaf);
+  for (int all_data = 0; all_data < 2; ++all_data)
+  {
+    grid_quantized.setDownsampleAllData (all_data == 1);
+    grid_quantized.filter (output_quantized);
+    ASSERT_EQ (int (output_quantized.points.size ()), 1);
+    EXPECT_EQ (output_quantized.points[0].x, -6);
+    EXPECT_EQ (output_quantized.points[0].y, 6);
+    EXPECT_EQ (output_quantized.points[0].z, -1);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (MinMax3D, Filters)
+{
+  // Enough copies of the dataset to split it into several parallel chunks
+  PointCloud<PointXYZ> large;
+  for (int c = 0; c < 400; ++c)
+    for (size_t i = 0; i < cloud->points.size (); ++i)
+    {
+      PointXYZ p = cloud->points[i];
+      p.x += static_cast<float> (c) * 0.01f;
+      large.points.push_back (p);
+    }
+  large.width = static_cast<uint32_t> (large.points.size ());
+  large.height = 1;
+  large.points[1000].y = std::numeric_limits<float>::quiet_NaN ();
+  large.is_dense = false;
+
+  PointCloud2::Ptr large_blob (new PointCloud2);
+  toROSMsg (large, *large_blob);
+  const int x_idx = getFieldIndex (*large_blob, "x");
+  const int y_idx = getFieldIndex (*large_blob, "y");
+  const int z_idx = getFieldIndex (*large_blob, "z");
+
+  Eigen::Vector4f min_pt, max_pt, min_blob, max_blob;
+  getMinMax3D (large, min_pt, max_pt);
+  for (unsigned int nr_threads = 1; nr_threads <= 4; nr_threads += 3)
+  {
+    getMinMax3D (large_blob, x_idx, y_idx, z_idx, min_blob, max_blob, nr_threads);
+    for (int d = 0; d < 3; ++d)
+    {
+      EXPECT_EQ (min_blob[d], min_pt[d]);
+      EXPECT_EQ (max_blob[d], max_pt[d]);
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (VoxelGridCovariance, Filters)
 {
@@ -1047,6 +1149,42 @@ TEST (VoxelGridCovariance, Filters)
   EXPECT_NEAR (leaves[2]->getMean ()[0], -0.00936106, 1e-4);
   EXPECT_NEAR (leaves[2]->getMean ()[1], 0.0516725, 1e-4);
   EXPECT_NEAR (leaves[2]->getMean ()[2], 0.0508024, 1e-4);
+
+  // The covariance of a voxel far from the origin is not lost to cancellation
+  PointCloud<PointXYZ>::Ptr far (new PointCloud<PointXYZ>);
+  for (int i = 0; i < 40; ++i)
+    far->points.push_back (PointXYZ (1e6f + 0.0625f * static_cast<float> ((i * 7) % 13),
+                                     1e6f + 0.0625f * static_cast<float> ((i * 5) % 11),
+                                     1e6f + 0.0625f * static_cast<float> ((i * 3) % 17)));
+  far->width = static_cast<uint32_t> (far->points.size ());
+  far->height = 1;
+  Eigen::Vector3d mean = Eigen::Vector3d::Zero ();
+  for (size_t i = 0; i < far->points.size (); ++i)
+    mean += far->points[i].getVector3fMap ().cast<double> ();
+  mean /= static_cast<double> (far->points.size ());
+  Eigen::Matrix3d covariance = Eigen::Matrix3d::Zero ();
+  for (size_t i = 0; i < far->points.size (); ++i)
+  {
+    Eigen::Vector3d d = far->points[i].getVector3fMap ().cast<double> () - mean;
+    covariance += d * d.transpose ();
+  }
+  // the sample covariance, with the (n - 1) / n factor of VoxelGridCovariance
+  const double n = static_cast<double> (far->points.size ());
+  covariance *= (n - 1.0) / (n * n);
+
+  VoxelGridCovariance<PointXYZ> far_grid;
+  far_grid.setLeafSize (2.0f, 2.0f, 2.0f);
+  far_grid.setInputCloud (far);
+  far_grid.filter (output);
+  ASSERT_EQ (int (output.points.size ()), 1);
+  VoxelGridCovariance<PointXYZ>::LeafConstPtr far_leaf = far_grid.getLeaf (far->points[0]);
+  ASSERT_TRUE (far_leaf != NULL);
+  for (int r = 0; r < 3; ++r)
+  {
+    EXPECT_NEAR (far_leaf->getMean ()[r], mean[r], 1e-6);
+    for (int c = 0; c < 3; ++c)
+      EXPECT_NEAR (far_leaf->getCov () (r, c), covariance (r, c), 1e-9);
+  }
 }
 
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
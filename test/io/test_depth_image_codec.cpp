@@ -0,0 +1,206 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <pcl/pcl_config.h>
+#include <pcl/point_types.h>
+#include <pcl/compression/depth_image_codec.h>
+#ifdef HAVE_PNG
+#include <pcl/compression/organized_pointcloud_compression.h>
+#endif
+
+#include <cmath>
+#include <sstream>
+#include <vector>
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** A smooth disparity ramp with noise, a moving box, and holes. */
+std::vector<uint16_t>
+createDisparityImage (size_t width, size_t height, int frame)
+{
+  std::vector<uint16_t> image (width * height);
+  for (size_t y = 0; y < height; ++y)
+    for (size_t x = 0; x < width; ++x)
+    {
+      int value = 400 + static_cast<int> (x + 2 * y) + rand () % 3;
+      if (x >= static_cast<size_t> (20 + 3 * frame) && x < static_cast<size_t> (60 + 3 * frame) && y > 10 && y < 40)
+        value = 1500;
+      if ((x * 7 + y * 13) % 97 == 0)
+        value = 0;
+      image[y * width + x] = static_cast<uint16_t> (value);
+    }
+  return (image);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, DepthImageCodecIntra)
+{
+  pcl::io::DepthImageCodec encoder, decoder;
+  std::vector<uint8_t> compressed;
+  size_t width, height;
+  unsigned int channels;
+
+  // heights below, equal to and not multiple of the number of bands
+  const size_t heights[] = {1, 5, 8, 61};
+  for (size_t h = 0; h < 4; ++h)
+  {
+    std::vector<uint16_t> image = createDisparityImage (83, heights[h], 0);
+    image[0] = 0xFFFF;
+    encoder.encodeMonoImage (image, 83, heights[h], compressed);
+    EXPECT_TRUE (pcl::io::DepthImageCodec::isEncodedImage (compressed));
+
+    std::vector<uint16_t> decoded;
+    ASSERT_TRUE (decoder.decodeImage (compressed, decoded, width, height, channels));
+    EXPECT_EQ (width, 83);
+    EXPECT_EQ (height, heights[h]);
+    EXPECT_EQ (channels, 1);
+    EXPECT_TRUE (image == decoded);
+  }
+
+  // rgb images
+  std::vector<uint8_t> rgb (64 * 48 * 3);
+  for (size_t i = 0; i < rgb.size (); ++i)
+    rgb[i] = static_cast<uint8_t> ((i / 3) % 64 * 4 + (i % 3) * 20 + rand () % 5);
+  encoder.setNumberOfBands (3);
+  encoder.encodeRGBImage (rgb, 64, 48, compressed);
+  EXPECT_LT (compressed.size (), rgb.size ());
+
+  std::vector<uint8_t> decoded_rgb;
+  ASSERT_TRUE (decoder.decodeImage (compressed, decoded_rgb, width, height, channels));
+  EXPECT_EQ (channels, 3);
+  EXPECT_TRUE (rgb == decoded_rgb);
+
+  // a PNG signature is not recognized
+  std::vector<uint8_t> png (compressed.begin (), compressed.end ());
+  png[0] = 0x89; png[1] = 'P'; png[2] = 'N'; png[3] = 'G';
+  EXPECT_FALSE (pcl::io::DepthImageCodec::isEncodedImage (png));
+  EXPECT_FALSE (decoder.decodeImage (png, decoded_rgb, width, height, channels));
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, DepthImageCodecTemporal)
+{
+  const size_t width = 128, height = 64;
+  pcl::io::DepthImageCodec intra_encoder, encoder, decoder, late_decoder;
+  encoder.setTemporalPrediction (true, 4);
+  EXPECT_TRUE (encoder.getTemporalPrediction ());
+  EXPECT_FALSE (intra_encoder.getTemporalPrediction ());
+
+  size_t intra_size = 0, temporal_size = 0;
+  std::vector<uint8_t> compressed, intra_compressed;
+  std::vector<uint16_t> base = createDisparityImage (width, height, 0);
+  for (int frame = 0; frame < 10; ++frame)
+  {
+    // the background is static, the box moves
+    std::vector<uint16_t> image = createDisparityImage (width, height, frame);
+    for (size_t i = 0; i < image.size (); ++i)
+      if (image[i] != 1500)
+        image[i] = base[i];
+
+    encoder.encodeMonoImage (image, width, height, compressed);
+    intra_encoder.encodeMonoImage (image, width, height, intra_compressed);
+    temporal_size += compressed.size ();
+    intra_size += intra_compressed.size ();
+
+    size_t w, h;
+    unsigned int channels;
+    std::vector<uint16_t> decoded;
+    ASSERT_TRUE (decoder.decodeImage (compressed, decoded, w, h, channels));
+    EXPECT_TRUE (image == decoded);
+
+    // a decoder joining the stream waits for the next key frame
+    bool late_result = late_decoder.decodeImage (compressed, decoded, w, h, channels);
+    if (frame < 5)
+      continue;
+    if (frame % 4 == 0)
+    {
+      EXPECT_TRUE (late_result);
+    }
+    if (frame > 8)
+    {
+      EXPECT_TRUE (late_result && image == decoded);
+    }
+  }
+  EXPECT_LT (temporal_size, intra_size);
+}
+
+#ifdef HAVE_PNG
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OrganizedCompressionPredictiveCodec)
+{
+  std::vector<uint16_t> disparity = createDisparityImage (64, 48, 0);
+  std::vector<uint8_t> rgb (64 * 48 * 3);
+  for (size_t i = 0; i < rgb.size (); ++i)
+    rgb[i] = static_cast<uint8_t> (i * 7);
+
+  pcl::io::OrganizedPointCloudCompression<pcl::PointXYZRGBA> png_coder, predictive_coder, decoder;
+  predictive_coder.setImageCodec (pcl::io::OrganizedPointCloudCompression<pcl::PointXYZRGBA>::PREDICTIVE_IMAGE_CODEC);
+  predictive_coder.setTemporalPrediction (true);
+
+  // both codecs are lossless, and the decoder detects the codec of every frame
+  std::stringstream stream;
+  for (int frame = 0; frame < 3; ++frame)
+  {
+    png_coder.encodeRawDisparityMapWithColorImage (disparity, rgb, 64, 48, stream, true, false);
+    predictive_coder.encodeRawDisparityMapWithColorImage (disparity, rgb, 64, 48, stream, true, false);
+  }
+
+  for (int frame = 0; frame < 3; ++frame)
+  {
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr png_cloud (new pcl::PointCloud<pcl::PointXYZRGBA>);
+    pcl::PointCloud<pcl::PointXYZRGBA>::Ptr predictive_cloud (new pcl::PointCloud<pcl::PointXYZRGBA>);
+    ASSERT_TRUE (decoder.decodePointCloud (stream, png_cloud, false));
+    ASSERT_TRUE (decoder.decodePointCloud (stream, predictive_cloud, false));
+    ASSERT_EQ (png_cloud->points.size (), predictive_cloud->points.size ());
+    for (size_t i = 0; i < png_cloud->points.size (); ++i)
+    {
+      const pcl::PointXYZRGBA &a = png_cloud->points[i], &b = predictive_cloud->points[i];
+      EXPECT_TRUE ((pcl_isnan (a.z) && pcl_isnan (b.z)) || (a.x == b.x && a.y == b.y && a.z == b.z));
+      EXPECT_EQ (a.rgba, b.rgba);
+    }
+  }
+}
+#endif
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
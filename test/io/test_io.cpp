@@ -45,6 +45,15 @@
 #include <pcl/console/print.h>
 #include <pcl/io/pcd_io.h>
 #include <pcl/io/ply_io.h>
+#include <pcl/io/lzf.h>
+#include <pcl/io/pcd_stream_reader.h>
+#include <pcl/io/pcd_mapped_cloud.h>
+#include <pcl/io/obj_io.h>
+#include <pcl/io/async_pcd_writer.h>
+#include <pcl/io/pcd_grabber.h>
+#include <pcl/io/tar.h>
+#include <pcl/ros/conversion_plan.h>
+#include <algorithm>
 #include <fstream>
 #include <locale>
 #include <stdexcept>
@@ -938,6 +947,96 @@ TEST (PCL, PLYReaderWriter)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+template <typename T> void
+writePLYValue (std::ofstream &fs, T value, bool big_endian)
+{
+  char bytes[sizeof (T)];
+  memcpy (bytes, &value, sizeof (T));
+  if (big_endian != (pcl::io::ply::host_byte_order == pcl::io::ply::big_endian_byte_order))
+    std::reverse (bytes, bytes + sizeof (T));
+  fs.write (bytes, sizeof (T));
+}
+
+TEST (PCL, PLYReaderBinary)
+{
+  const int nr_p = 1000;
+  for (int big_endian = 0; big_endian < 2; ++big_endian)
+  {
+    // Vertices mixing converted, skipped and copied properties, followed by a list element
+    {
+      std::ofstream fs ("test_pcl_io_binary.ply", std::ios::binary);
+      fs << "ply\nformat " << (big_endian ? "binary_big_endian" : "binary_little_endian") << " 1.0\n"
+            "element vertex " << nr_p << "\n"
+            "property float x\nproperty float y\nproperty float z\n"
+            "property double quality\n"
+            "property uchar red\nproperty uchar green\nproperty uchar blue\nproperty uchar alpha\n"
+            "property uchar intensity\n"
+            "element face 1\nproperty list uchar int vertex_indices\n"
+            "end_header\n";
+      for (int i = 0; i < nr_p; ++i)
+      {
+        writePLYValue (fs, static_cast<float> (i), big_endian);
+        writePLYValue (fs, static_cast<float> (2 * i), big_endian);
+        writePLYValue (fs, static_cast<float> (-i), big_endian);
+        writePLYValue (fs, static_cast<double> (i), big_endian);
+        writePLYValue (fs, static_cast<uint8_t> (i % 256), big_endian);
+        writePLYValue (fs, static_cast<uint8_t> ((i + 1) % 256), big_endian);
+        writePLYValue (fs, static_cast<uint8_t> ((i + 2) % 256), big_endian);
+        writePLYValue (fs, static_cast<uint8_t> (255), big_endian);
+        writePLYValue (fs, static_cast<uint8_t> ((3 * i) % 256), big_endian);
+      }
+      writePLYValue (fs, static_cast<uint8_t> (3), big_endian);
+      for (int i = 0; i < 3; ++i)
+        writePLYValue (fs, static_cast<int32_t> (i), big_endian);
+    }
+
+    PLYReader reader;
+    PointCloud<PointXYZRGB> cloud;
+    ASSERT_EQ (reader.read ("test_pcl_io_binary.ply", cloud), 0);
+    ASSERT_EQ (cloud.points.size (), static_cast<size_t> (nr_p));
+    for (int i = 0; i < nr_p; ++i)
+    {
+      ASSERT_EQ (cloud.points[i].x, static_cast<float> (i));
+      ASSERT_EQ (cloud.points[i].y, static_cast<float> (2 * i));
+      ASSERT_EQ (cloud.points[i].z, static_cast<float> (-i));
+      ASSERT_EQ (cloud.points[i].r, i % 256);
+      ASSERT_EQ (cloud.points[i].g, (i + 1) % 256);
+      ASSERT_EQ (cloud.points[i].b, (i + 2) % 256);
+    }
+    PointCloud<PointXYZI> cloud_i;
+    ASSERT_EQ (reader.read ("test_pcl_io_binary.ply", cloud_i), 0);
+    ASSERT_EQ (cloud_i.points.size (), static_cast<size_t> (nr_p));
+    for (int i = 0; i < nr_p; ++i)
+      ASSERT_EQ (cloud_i.points[i].intensity, static_cast<float> ((3 * i) % 256));
+
+    // Vertices already laid out like the cloud
+    {
+      std::ofstream fs ("test_pcl_io_binary.ply", std::ios::binary);
+      fs << "ply\nformat " << (big_endian ? "binary_big_endian" : "binary_little_endian") << " 1.0\n"
+            "element vertex " << nr_p << "\n"
+            "property float x\nproperty float y\nproperty float z\n"
+            "end_header\n";
+      for (int i = 0; i < nr_p; ++i)
+      {
+        writePLYValue (fs, static_cast<float> (i), big_endian);
+        writePLYValue (fs, static_cast<float> (i + 0.5f), big_endian);
+        writePLYValue (fs, static_cast<float> (i + 0.25f), big_endian);
+      }
+    }
+
+    PointCloud<PointXYZ> cloud_xyz;
+    ASSERT_EQ (reader.read ("test_pcl_io_binary.ply", cloud_xyz), 0);
+    ASSERT_EQ (cloud_xyz.points.size (), static_cast<size_t> (nr_p));
+    for (int i = 0; i < nr_p; ++i)
+    {
+      ASSERT_EQ (cloud_xyz.points[i].x, static_cast<float> (i));
+      ASSERT_EQ (cloud_xyz.points[i].y, static_cast<float> (i + 0.5f));
+      ASSERT_EQ (cloud_xyz.points[i].z, static_cast<float> (i + 0.25f));
+    }
+  }
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 
 struct PointXYZFPFH33
@@ -1079,6 +1178,109 @@ TEST (PCL, CopyPointCloud)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, ConversionPlan)
+{
+  PointCloud<PointXYZRGBNormal> cloud;
+  cloud.width  = 64;
+  cloud.height = 32;
+  cloud.points.resize (cloud.width * cloud.height);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud.points[i].x = static_cast<float> (i);
+    cloud.points[i].y = static_cast<float> (i) + 0.5f;
+    cloud.points[i].z = static_cast<float> (i) * 2.0f;
+    cloud.points[i].normal_x = static_cast<float> (i) * 3.0f;
+    cloud.points[i].curvature = static_cast<float> (i) * 4.0f;
+    cloud.points[i].rgba = static_cast<uint32_t> (i);
+  }
+
+  // toROSMsg gives the same blob as the free function
+  ConversionPlan<PointXYZRGBNormal> plan;
+  plan.setParallelThreshold (1);
+  sensor_msgs::PointCloud2 blob, blob_ref;
+  plan.toROSMsg (cloud, blob);
+  toROSMsg (cloud, blob_ref);
+  EXPECT_EQ (blob.width, blob_ref.width);
+  EXPECT_EQ (blob.height, blob_ref.height);
+  EXPECT_EQ (blob.point_step, blob_ref.point_step);
+  EXPECT_EQ (blob.row_step, blob_ref.row_step);
+  ASSERT_EQ (blob.fields.size (), blob_ref.fields.size ());
+  EXPECT_TRUE (blob.data == blob_ref.data);
+
+  // Identical layout: one copy, and the plan is only built once
+  PointCloud<PointXYZRGBNormal> cloud2;
+  EXPECT_TRUE (plan.prepare (blob));
+  EXPECT_TRUE (plan.isIdentity ());
+  EXPECT_FALSE (plan.prepare (blob));
+  plan.fromROSMsg (blob, cloud2);
+  EXPECT_EQ (cloud2.width, cloud.width);
+  EXPECT_EQ (cloud2.height, cloud.height);
+  ASSERT_EQ (cloud2.points.size (), cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    EXPECT_EQ (cloud2.points[i].x, cloud.points[i].x);
+    EXPECT_EQ (cloud2.points[i].normal_x, cloud.points[i].normal_x);
+    EXPECT_EQ (cloud2.points[i].curvature, cloud.points[i].curvature);
+    EXPECT_EQ (cloud2.points[i].rgba, cloud.points[i].rgba);
+  }
+
+  // Padded rows: one copy per row
+  sensor_msgs::PointCloud2 padded = blob;
+  padded.row_step = blob.row_step + 16;
+  padded.data.assign (padded.row_step * padded.height, 0);
+  for (uint32_t row = 0; row < blob.height; ++row)
+    memcpy (&padded.data[row * padded.row_step], &blob.data[row * blob.row_step], blob.row_step);
+  cloud2.points.clear ();
+  plan.fromROSMsg (padded, cloud2);
+  ASSERT_EQ (cloud2.points.size (), cloud.points.size ());
+  EXPECT_EQ (cloud2.points.back ().z, cloud.points.back ().z);
+  EXPECT_EQ (cloud2.points.back ().rgba, cloud.points.back ().rgba);
+
+  // A different point type: several runs, compared to the free function
+  ConversionPlan<PointXYZI> plan_xyzi;
+  plan_xyzi.setParallelThreshold (1);
+  sensor_msgs::PointCloud2 blob_xyzi;
+  PointCloud<PointXYZI> cloud_xyzi;
+  cloud_xyzi.width = cloud.width;
+  cloud_xyzi.height = cloud.height;
+  cloud_xyzi.points.resize (cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud_xyzi.points[i].x = cloud.points[i].x;
+    cloud_xyzi.points[i].y = cloud.points[i].y;
+    cloud_xyzi.points[i].z = cloud.points[i].z;
+    cloud_xyzi.points[i].intensity = cloud.points[i].curvature;
+  }
+  toROSMsg (cloud_xyzi, blob_xyzi);
+  PointCloud<PointXYZ> xyz, xyz_ref;
+  ConversionPlan<PointXYZ> plan_xyz;
+  plan_xyz.setParallelThreshold (1);
+  plan_xyz.fromROSMsg (blob, xyz);
+  EXPECT_FALSE (plan_xyz.isIdentity ());
+  fromROSMsg (blob, xyz_ref);
+  ASSERT_EQ (xyz.points.size (), xyz_ref.points.size ());
+  for (size_t i = 0; i < xyz.points.size (); ++i)
+  {
+    EXPECT_EQ (xyz.points[i].x, xyz_ref.points[i].x);
+    EXPECT_EQ (xyz.points[i].y, xyz_ref.points[i].y);
+    EXPECT_EQ (xyz.points[i].z, xyz_ref.points[i].z);
+  }
+
+  // Changing the layout rebuilds the plan
+  EXPECT_TRUE (plan_xyz.prepare (blob_xyzi));
+  plan_xyz.fromROSMsg (blob_xyzi, xyz);
+  ASSERT_EQ (xyz.points.size (), cloud.points.size ());
+  EXPECT_EQ (xyz.points.back ().z, cloud.points.back ().z);
+
+  PointCloud<PointXYZI> xyzi;
+  plan_xyzi.fromROSMsg (blob, xyzi);
+  EXPECT_FALSE (plan_xyzi.isIdentity ());
+  ASSERT_EQ (xyzi.points.size (), cloud.points.size ());
+  EXPECT_EQ (xyzi.points.back ().x, cloud.points.back ().x);
+  EXPECT_EQ (xyzi.points.back ().z, cloud.points.back ().z);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, LZF)
 {
@@ -1186,6 +1388,793 @@ TEST (PCL, LZFExtended)
   }
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, LZFChunked)
+{
+  PointCloud<PointXYZRGBNormal> cloud, cloud2;
+  cloud.width  = 640;
+  cloud.height = 480;
+  cloud.points.resize (cloud.width * cloud.height);
+  cloud.is_dense = true;
+
+  srand (static_cast<unsigned int> (time (NULL)));
+  size_t nr_p = cloud.points.size ();
+  // Randomly create a new point cloud
+  for (size_t i = 0; i < nr_p; ++i)
+  {
+    cloud.points[i].x = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].y = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].normal_x = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].normal_y = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].normal_z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].rgb = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+  }
+
+  // Random data does not compress, so most blocks will be stored verbatim
+  std::vector<char> chunks;
+  std::vector<char> raw (sizeof (PointXYZRGBNormal) * nr_p);
+  memcpy (&raw[0], &cloud.points[0], raw.size ());
+  unsigned int compressed_size = lzfCompressChunked (&raw[0], static_cast<unsigned int> (raw.size ()), chunks, 100000);
+  EXPECT_EQ (compressed_size, chunks.size ());
+  std::vector<char> raw2 (raw.size ());
+  EXPECT_EQ (lzfDecompressChunked (&chunks[0], compressed_size, &raw2[0], static_cast<unsigned int> (raw2.size ())), raw.size ());
+  EXPECT_TRUE (raw == raw2);
+  // A truncated stream must be rejected
+  EXPECT_EQ (lzfDecompressChunked (&chunks[0], compressed_size / 2, &raw2[0], static_cast<unsigned int> (raw2.size ())), 0);
+
+  PCDWriter writer;
+  writer.setCompressionBlockSize (65536);
+  int res = writer.writeBinaryCompressedChunked<PointXYZRGBNormal> ("test_pcl_io_compressed_chunked.pcd", cloud);
+  EXPECT_EQ (res, 0);
+
+  PCDReader reader;
+  sensor_msgs::PointCloud2 blob;
+  Eigen::Vector4f origin;
+  Eigen::Quaternionf orientation;
+  int pcd_version, data_type;
+  unsigned int data_idx;
+  reader.readHeader ("test_pcl_io_compressed_chunked.pcd", blob, origin, orientation, pcd_version, data_type, data_idx);
+  EXPECT_EQ (data_type, 3);
+
+  reader.read<PointXYZRGBNormal> ("test_pcl_io_compressed_chunked.pcd", cloud2);
+
+  EXPECT_EQ (cloud2.width, cloud.width);
+  EXPECT_EQ (cloud2.height, cloud.height);
+  EXPECT_EQ (cloud2.is_dense, cloud.is_dense);
+  EXPECT_EQ (cloud2.points.size (), cloud.points.size ());
+
+  for (size_t i = 0; i < cloud2.points.size (); ++i)
+  {
+    ASSERT_EQ (cloud2.points[i].x, cloud.points[i].x);
+    ASSERT_EQ (cloud2.points[i].y, cloud.points[i].y);
+    ASSERT_EQ (cloud2.points[i].z, cloud.points[i].z);
+    ASSERT_EQ (cloud2.points[i].normal_x, cloud.points[i].normal_x);
+    ASSERT_EQ (cloud2.points[i].normal_y, cloud.points[i].normal_y);
+    ASSERT_EQ (cloud2.points[i].normal_z, cloud.points[i].normal_z);
+    ASSERT_EQ (cloud2.points[i].rgb, cloud.points[i].rgb);
+  }
+
+  // Same data through the sensor_msgs::PointCloud2 interface, on a single thread
+  pcl::toROSMsg (cloud, blob);
+  writer.setNumberOfThreads (1);
+  res = writer.writeBinaryCompressedChunked ("test_pcl_io_compressed_chunked.pcd", blob);
+  EXPECT_EQ (res, 0);
+
+  reader.read<PointXYZRGBNormal> ("test_pcl_io_compressed_chunked.pcd", cloud2);
+
+  EXPECT_EQ (cloud2.width, blob.width);
+  EXPECT_EQ (cloud2.height, blob.height);
+  EXPECT_EQ (cloud2.points.size (), cloud.points.size ());
+
+  for (size_t i = 0; i < cloud2.points.size (); ++i)
+  {
+    ASSERT_EQ (cloud2.points[i].x, cloud.points[i].x);
+    ASSERT_EQ (cloud2.points[i].y, cloud.points[i].y);
+    ASSERT_EQ (cloud2.points[i].z, cloud.points[i].z);
+    ASSERT_EQ (cloud2.points[i].normal_x, cloud.points[i].normal_x);
+    ASSERT_EQ (cloud2.points[i].normal_y, cloud.points[i].normal_y);
+    ASSERT_EQ (cloud2.points[i].normal_z, cloud.points[i].normal_z);
+    ASSERT_EQ (cloud2.points[i].rgb, cloud.points[i].rgb);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PCDStreamReader)
+{
+  PointCloud<PointXYZRGBNormal> cloud;
+  cloud.width  = 320;
+  cloud.height = 240;
+  cloud.points.resize (cloud.width * cloud.height);
+  cloud.is_dense = true;
+
+  srand (static_cast<unsigned int> (time (NULL)));
+  size_t nr_p = cloud.points.size ();
+  // Randomly create a new point cloud
+  for (size_t i = 0; i < nr_p; ++i)
+  {
+    cloud.points[i].x = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].y = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].normal_x = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].normal_y = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].normal_z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].rgb = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+  }
+
+  PCDWriter writer;
+  writer.setCompressionBlockSize (4096);
+  for (int data_type = 0; data_type < 5; ++data_type)
+  {
+    switch (data_type)
+    {
+      case 0: writer.writeASCII<PointXYZRGBNormal> ("test_pcl_io_stream.pcd", cloud, 9); break;
+      case 1: writer.writeBinary<PointXYZRGBNormal> ("test_pcl_io_stream.pcd", cloud); break;
+      case 2: writer.writeBinaryCompressed<PointXYZRGBNormal> ("test_pcl_io_stream.pcd", cloud); break;
+      case 3: writer.writeBinaryCompressedChunked<PointXYZRGBNormal> ("test_pcl_io_stream.pcd", cloud); break;
+      case 4: writer.writeColumnar<PointXYZRGBNormal> ("test_pcl_io_stream.pcd", cloud); break;
+    }
+
+    PCDStreamReader reader;
+    ASSERT_EQ (reader.open ("test_pcl_io_stream.pcd"), 0);
+    EXPECT_EQ (reader.getDataType (), data_type);
+    EXPECT_EQ (reader.getNumberOfPoints (), nr_p);
+    EXPECT_TRUE (reader.getHeader ().data.empty ());
+
+    // Read in batches that do not divide the number of points
+    PointCloud<PointXYZRGBNormal> block, cloud2;
+    int res;
+    while ((res = reader.readBlock (block, 1000)) > 0)
+    {
+      EXPECT_LE (res, 1000);
+      EXPECT_EQ (block.points.size (), static_cast<size_t> (res));
+      cloud2 += block;
+    }
+    EXPECT_EQ (res, 0);
+    EXPECT_EQ (reader.getNumberOfPointsRead (), nr_p);
+    ASSERT_EQ (cloud2.points.size (), nr_p);
+
+    for (size_t i = 0; i < nr_p; ++i)
+    {
+      ASSERT_EQ (cloud2.points[i].x, cloud.points[i].x);
+      ASSERT_EQ (cloud2.points[i].y, cloud.points[i].y);
+      ASSERT_EQ (cloud2.points[i].z, cloud.points[i].z);
+      ASSERT_EQ (cloud2.points[i].normal_x, cloud.points[i].normal_x);
+      ASSERT_EQ (cloud2.points[i].normal_y, cloud.points[i].normal_y);
+      ASSERT_EQ (cloud2.points[i].normal_z, cloud.points[i].normal_z);
+      ASSERT_EQ (cloud2.points[i].rgb, cloud.points[i].rgb);
+    }
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PCDMappedCloud)
+{
+  PointCloud<PointXYZRGBA> cloud;
+  cloud.width  = 64;
+  cloud.height = 48;
+  cloud.points.resize (cloud.width * cloud.height);
+  cloud.is_dense = true;
+
+  srand (static_cast<unsigned int> (time (NULL)));
+  size_t nr_p = cloud.points.size ();
+  // Randomly create a new point cloud
+  for (size_t i = 0; i < nr_p; ++i)
+  {
+    cloud.points[i].x = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].y = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].rgba = static_cast<uint32_t> (rand ());
+  }
+
+  // Same layout as PointXYZRGBA: used in place
+  sensor_msgs::PointCloud2 blob;
+  pcl::toROSMsg (cloud, blob);
+  PCDWriter writer;
+  EXPECT_EQ (writer.writeBinary ("test_pcl_io_mapped.pcd", blob), 0);
+
+  PCDMappedCloud<PointXYZRGBA> mapped;
+  ASSERT_EQ (mapped.open ("test_pcl_io_mapped.pcd"), 0);
+  EXPECT_TRUE (mapped.isMapped ());
+  EXPECT_EQ (mapped.width (), cloud.width);
+  EXPECT_EQ (mapped.height (), cloud.height);
+  ASSERT_EQ (mapped.size (), nr_p);
+  for (size_t i = 0; i < nr_p; ++i)
+  {
+    ASSERT_EQ (mapped[i].x, cloud.points[i].x);
+    ASSERT_EQ (mapped[i].y, cloud.points[i].y);
+    ASSERT_EQ (mapped[i].z, cloud.points[i].z);
+    ASSERT_EQ (mapped[i].rgba, cloud.points[i].rgba);
+  }
+  EXPECT_EQ (mapped.at (3, 2).x, cloud.at (3, 2).x);
+
+  // The regular reader must not be confused by the header padding
+  PointCloud<PointXYZRGBA> cloud2;
+  PCDReader reader;
+  reader.read ("test_pcl_io_mapped.pcd", cloud2);
+  ASSERT_EQ (cloud2.points.size (), nr_p);
+  EXPECT_EQ (cloud2.points[nr_p - 1].rgba, cloud.points[nr_p - 1].rgba);
+
+  // Padding stripped by the templated writer, or a different type: copied
+  writer.writeBinary ("test_pcl_io_mapped.pcd", cloud);
+  ASSERT_EQ (mapped.open ("test_pcl_io_mapped.pcd"), 0);
+  EXPECT_FALSE (mapped.isMapped ());
+  ASSERT_EQ (mapped.size (), nr_p);
+  for (size_t i = 0; i < nr_p; ++i)
+  {
+    ASSERT_EQ (mapped[i].x, cloud.points[i].x);
+    ASSERT_EQ (mapped[i].rgba, cloud.points[i].rgba);
+  }
+
+  PCDMappedCloud<PointXYZ> mapped_xyz;
+  ASSERT_EQ (mapped_xyz.open ("test_pcl_io_mapped.pcd"), 0);
+  EXPECT_FALSE (mapped_xyz.isMapped ());
+  PointCloud<PointXYZ> cloud_xyz;
+  mapped_xyz.toPointCloud (cloud_xyz);
+  ASSERT_EQ (cloud_xyz.points.size (), nr_p);
+  EXPECT_EQ (cloud_xyz.points[0].z, cloud.points[0].z);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PCDASCIIRoundTrip)
+{
+  PointCloud<PointXYZRGBNormal> cloud, cloud2;
+  cloud.width  = 200;
+  cloud.height = 100;
+  cloud.points.resize (cloud.width * cloud.height);
+  cloud.is_dense = true;
+
+  srand (static_cast<unsigned int> (time (NULL)));
+  size_t nr_p = cloud.points.size ();
+  // Randomly create a new point cloud, with values needing all 9 significant digits
+  for (size_t i = 0; i < nr_p; ++i)
+  {
+    cloud.points[i].x = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0)) - 512.0f;
+    cloud.points[i].y = static_cast<float> (rand () / (RAND_MAX + 1.0)) * 1e-6f;
+    cloud.points[i].z = static_cast<float> (rand () / (RAND_MAX + 1.0)) * 1e7f;
+    cloud.points[i].normal_x = static_cast<float> (rand () / (RAND_MAX + 1.0));
+    cloud.points[i].normal_y = static_cast<float> (rand () / (RAND_MAX + 1.0));
+    cloud.points[i].normal_z = static_cast<float> (rand () / (RAND_MAX + 1.0));
+    cloud.points[i].rgb = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].curvature = static_cast<float> (i);
+  }
+  cloud.points[42].normal_x = std::numeric_limits<float>::quiet_NaN ();
+
+  PCDWriter writer;
+  writer.writeASCII ("test_pcl_io_ascii.pcd", cloud, PCDWriter::ROUND_TRIP_PRECISION);
+
+  PCDReader reader;
+  reader.read ("test_pcl_io_ascii.pcd", cloud2);
+  EXPECT_EQ (cloud2.width, cloud.width);
+  EXPECT_EQ (cloud2.height, cloud.height);
+  EXPECT_FALSE (cloud2.is_dense);
+  ASSERT_EQ (cloud2.points.size (), nr_p);
+  EXPECT_TRUE (pcl_isnan (cloud2.points[42].normal_x));
+  cloud2.points[42].normal_x = cloud.points[42].normal_x = 0;
+
+  for (size_t i = 0; i < nr_p; ++i)
+  {
+    ASSERT_EQ (cloud2.points[i].x, cloud.points[i].x);
+    ASSERT_EQ (cloud2.points[i].y, cloud.points[i].y);
+    ASSERT_EQ (cloud2.points[i].z, cloud.points[i].z);
+    ASSERT_EQ (cloud2.points[i].normal_x, cloud.points[i].normal_x);
+    ASSERT_EQ (cloud2.points[i].normal_y, cloud.points[i].normal_y);
+    ASSERT_EQ (cloud2.points[i].normal_z, cloud.points[i].normal_z);
+    ASSERT_EQ (cloud2.points[i].rgb, cloud.points[i].rgb);
+    ASSERT_EQ (cloud2.points[i].curvature, cloud.points[i].curvature);
+  }
+
+  // Blank lines, CR/LF line endings and uncommon number forms
+  {
+    std::ofstream fs ("test_pcl_io_ascii.pcd", std::ios::binary);
+    fs << "# .PCD v0.7 - Point Cloud Data file format\nVERSION 0.7\nFIELDS x y z\nSIZE 4 4 4\nTYPE F F F\n"
+          "COUNT 1 1 1\nWIDTH 3\nHEIGHT 1\nVIEWPOINT 0 0 0 1 0 0 0\nPOINTS 3\nDATA ascii\n"
+          "1 2 3\r\n\n  \t\n-1.5e2 .25 +7.\r\n1e-50 0.1 1234567890123456789012\n";
+  }
+  PointCloud<PointXYZ> cloud_xyz;
+  reader.read ("test_pcl_io_ascii.pcd", cloud_xyz);
+  ASSERT_EQ (cloud_xyz.points.size (), 3);
+  EXPECT_EQ (cloud_xyz.points[0].z, 3.0f);
+  EXPECT_EQ (cloud_xyz.points[1].x, -150.0f);
+  EXPECT_EQ (cloud_xyz.points[1].y, 0.25f);
+  EXPECT_EQ (cloud_xyz.points[1].z, 7.0f);
+  EXPECT_EQ (cloud_xyz.points[2].y, 0.1f);
+  EXPECT_FLOAT_EQ (cloud_xyz.points[2].z, 1.234567890123456789012e21f);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PCDCompactPointTypes)
+{
+  PointCloud<PointXYZRGBNormalPacked> cloud;
+  cloud.width  = 64;
+  cloud.height = 1;
+  cloud.points.resize (cloud.width * cloud.height);
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud.points[i].x = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].y = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].z = static_cast<float> (1024 * rand () / (RAND_MAX + 1.0));
+    cloud.points[i].rgba = static_cast<uint32_t> (rand ());
+    cloud.points[i].normal_z = 1.0f;
+    cloud.points[i].curvature = static_cast<float> (i);
+  }
+
+  // The packed types share the field names of the padded types
+  PCDWriter writer;
+  writer.writeBinaryCompressed ("test_pcl_io_compact.pcd", cloud);
+  PointCloud<PointXYZRGBNormal> padded;
+  PointCloud<PointXYZRGBNormalPacked> packed;
+  PCDReader reader;
+  reader.read ("test_pcl_io_compact.pcd", padded);
+  reader.read ("test_pcl_io_compact.pcd", packed);
+  ASSERT_EQ (padded.points.size (), cloud.points.size ());
+  ASSERT_EQ (packed.points.size (), cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    EXPECT_EQ (padded.points[i].x, cloud.points[i].x);
+    EXPECT_EQ (padded.points[i].z, cloud.points[i].z);
+    EXPECT_EQ (padded.points[i].rgba, cloud.points[i].rgba);
+    EXPECT_EQ (padded.points[i].normal_z, cloud.points[i].normal_z);
+    EXPECT_EQ (padded.points[i].curvature, cloud.points[i].curvature);
+    EXPECT_EQ (packed.points[i].y, cloud.points[i].y);
+    EXPECT_EQ (packed.points[i].rgba, cloud.points[i].rgba);
+  }
+
+  // 16 bit coordinates, binary and ascii
+  PointCloud<PointXYZQuantized> quantized, quantized2;
+  quantized.width  = 3;
+  quantized.height = 1;
+  quantized.points.push_back (PointXYZQuantized (-32768, 0, 32767));
+  quantized.points.push_back (PointXYZQuantized (1, -2, 3));
+  quantized.points.push_back (PointXYZQuantized (1000, 2000, -3000));
+  for (int binary = 0; binary < 2; ++binary)
+  {
+    writer.write ("test_pcl_io_compact.pcd", quantized, binary == 1);
+    reader.read ("test_pcl_io_compact.pcd", quantized2);
+    ASSERT_EQ (quantized2.points.size (), 3);
+    for (size_t i = 0; i < quantized.points.size (); ++i)
+    {
+      EXPECT_EQ (quantized2.points[i].x, quantized.points[i].x);
+      EXPECT_EQ (quantized2.points[i].y, quantized.points[i].y);
+      EXPECT_EQ (quantized2.points[i].z, quantized.points[i].z);
+    }
+  }
+  remove ("test_pcl_io_compact.pcd");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PCDColumnar)
+{
+  PointCloud<PointXYZRGBNormal> cloud;
+  cloud.width  = 64;
+  cloud.height = 48;
+  cloud.points.resize (cloud.width * cloud.height);
+  cloud.is_dense = true;
+
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    cloud.points[i].x = static_cast<float> (i);
+    cloud.points[i].y = static_cast<float> (i) * 2.0f;
+    cloud.points[i].z = static_cast<float> (i) * 3.0f;
+    cloud.points[i].normal_x = 0.1f;
+    cloud.points[i].normal_y = 0.2f;
+    cloud.points[i].normal_z = static_cast<float> (i) * 0.5f;
+    cloud.points[i].curvature = 1.5f;
+    cloud.points[i].rgba = static_cast<uint32_t> (i * 7);
+  }
+
+  PCDWriter writer;
+  EXPECT_EQ (writer.writeColumnar<PointXYZRGBNormal> ("test_pcl_io_columnar.pcd", cloud), 0);
+
+  // Every column starts on a 16 byte boundary of the file
+  PCDReader reader;
+  sensor_msgs::PointCloud2 blob;
+  Eigen::Vector4f origin;
+  Eigen::Quaternionf orientation;
+  int pcd_version, data_type;
+  unsigned int data_idx;
+  ASSERT_EQ (reader.readHeader ("test_pcl_io_columnar.pcd", blob, origin, orientation, pcd_version, data_type, data_idx), 0);
+  EXPECT_EQ (data_type, 4);
+  EXPECT_EQ (data_idx % 16, 0);
+  std::vector<size_t> offsets = reader.getColumnOffsets ();
+  ASSERT_EQ (offsets.size (), 8);     // x y z rgb normal_x normal_y normal_z curvature
+  for (size_t c = 0; c < offsets.size (); ++c)
+  {
+    EXPECT_EQ (offsets[c] % 16, 0);
+    if (c > 0)
+    {
+      EXPECT_GE (offsets[c], offsets[c - 1] + cloud.points.size () * sizeof (float));
+    }
+  }
+
+  // Full read
+  PointCloud<PointXYZRGBNormal> cloud2;
+  ASSERT_EQ (reader.read ("test_pcl_io_columnar.pcd", cloud2), 0);
+  EXPECT_EQ (cloud2.width, cloud.width);
+  EXPECT_EQ (cloud2.height, cloud.height);
+  EXPECT_EQ (cloud2.is_dense, true);
+  ASSERT_EQ (cloud2.points.size (), cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    EXPECT_EQ (cloud2.points[i].x, cloud.points[i].x);
+    EXPECT_EQ (cloud2.points[i].y, cloud.points[i].y);
+    EXPECT_EQ (cloud2.points[i].z, cloud.points[i].z);
+    EXPECT_EQ (cloud2.points[i].normal_z, cloud.points[i].normal_z);
+    EXPECT_EQ (cloud2.points[i].curvature, cloud.points[i].curvature);
+    EXPECT_EQ (cloud2.points[i].rgba, cloud.points[i].rgba);
+  }
+
+  // Only the fields of the point type
+  PointCloud<PointXYZ> cloud_xyz;
+  ASSERT_EQ (reader.read ("test_pcl_io_columnar.pcd", cloud_xyz), 0);
+  ASSERT_EQ (cloud_xyz.points.size (), cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    EXPECT_EQ (cloud_xyz.points[i].x, cloud.points[i].x);
+    EXPECT_EQ (cloud_xyz.points[i].y, cloud.points[i].y);
+    EXPECT_EQ (cloud_xyz.points[i].z, cloud.points[i].z);
+  }
+
+  // An explicit subset, on the columnar and on a binary file
+  std::vector<std::string> subset;
+  subset.push_back ("z");
+  subset.push_back ("curvature");
+  reader.setFieldSubset (subset);
+  EXPECT_EQ (writer.writeBinary<PointXYZRGBNormal> ("test_pcl_io_columnar_binary.pcd", cloud), 0);
+  const char *files[] = {"test_pcl_io_columnar.pcd", "test_pcl_io_columnar_binary.pcd"};
+  for (int f = 0; f < 2; ++f)
+  {
+    sensor_msgs::PointCloud2 subset_blob;
+    ASSERT_EQ (reader.read (files[f], subset_blob), 0);
+    ASSERT_EQ (subset_blob.fields.size (), 2);
+    EXPECT_EQ (subset_blob.fields[0].name, "z");
+    EXPECT_EQ (subset_blob.fields[1].name, "curvature");
+    EXPECT_EQ (subset_blob.point_step, 2 * sizeof (float));
+    ASSERT_EQ (subset_blob.data.size (), cloud.points.size () * subset_blob.point_step);
+    for (size_t i = 0; i < cloud.points.size (); ++i)
+    {
+      float values[2];
+      memcpy (values, &subset_blob.data[i * subset_blob.point_step], sizeof (values));
+      EXPECT_EQ (values[0], cloud.points[i].z);
+      EXPECT_EQ (values[1], cloud.points[i].curvature);
+    }
+  }
+
+  // The Eigen path recognizes the columnar data type, and refuses it
+  pcl::PointCloud<Eigen::MatrixXf> cloud_eigen;
+  ASSERT_EQ (reader.readHeaderEigen ("test_pcl_io_columnar.pcd", cloud_eigen, pcd_version, data_type, data_idx), 0);
+  EXPECT_EQ (data_type, 4);
+  EXPECT_EQ (reader.getColumnOffsets (), offsets);
+  EXPECT_EQ (reader.readEigen ("test_pcl_io_columnar.pcd", cloud_eigen), -1);
+
+  remove ("test_pcl_io_columnar.pcd");
+  remove ("test_pcl_io_columnar_binary.pcd");
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OBJReader)
+{
+  // Two sub meshes of triangles over a 10x10 grid, with one UV per face vertex
+  PointCloud<PointNormal> cloud;
+  for (int i = 0; i < 100; ++i)
+  {
+    PointNormal p;
+    p.x = static_cast<float> (i % 10) * 0.5f;
+    p.y = static_cast<float> (i / 10) * 0.25f;
+    p.z = static_cast<float> (i % 7);
+    p.normal_x = 0.0f;
+    p.normal_y = 0.0f;
+    p.normal_z = 1.0f;
+    p.curvature = 0.0f;
+    cloud.push_back (p);
+  }
+  TextureMesh mesh;
+  toROSMsg (cloud, mesh.cloud);
+  mesh.tex_polygons.resize (2);
+  mesh.tex_coordinates.resize (2);
+  mesh.tex_materials.resize (2);
+  for (uint32_t i = 0; i < 90; ++i)
+  {
+    if (i % 10 == 9)
+      continue;
+    int m = i < 50 ? 0 : 1;
+    Vertices triangle;
+    triangle.vertices.push_back (i);
+    triangle.vertices.push_back (i + 1);
+    triangle.vertices.push_back (i + 10);
+    mesh.tex_polygons[m].push_back (triangle);
+    for (size_t j = 0; j < 3; ++j)
+      mesh.tex_coordinates[m].push_back (Eigen::Vector2f (cloud.points[triangle.vertices[j]].x / 4.5f, 
+                                                          cloud.points[triangle.vertices[j]].y / 2.25f));
+  }
+  for (int m = 0; m < 2; ++m)
+  {
+    mesh.tex_materials[m].tex_name = m == 0 ? "first" : "second";
+    mesh.tex_materials[m].tex_file = m == 0 ? "first.png" : "second.png";
+    mesh.tex_materials[m].tex_Kd.r = 0.5f;
+    mesh.tex_materials[m].tex_Kd.g = 0.25f * static_cast<float> (m);
+    mesh.tex_materials[m].tex_Kd.b = 1.0f;
+    mesh.tex_materials[m].tex_d = 1.0f;
+    mesh.tex_materials[m].tex_illum = 2;
+  }
+  EXPECT_EQ (io::saveOBJFile ("test_pcl_io.obj", mesh, 8), 0);
+
+  for (unsigned int threads = 1; threads <= 2; ++threads)
+  {
+    OBJReader reader;
+    reader.setNumberOfThreads (threads);
+    TextureMesh mesh2;
+    EXPECT_EQ (reader.read ("test_pcl_io.obj", mesh2), 0);
+
+    PointCloud<PointNormal> cloud2;
+    fromROSMsg (mesh2.cloud, cloud2);
+    ASSERT_EQ (cloud2.points.size (), cloud.points.size ());
+    for (size_t i = 0; i < cloud.points.size (); ++i)
+    {
+      EXPECT_EQ (cloud2.points[i].x, cloud.points[i].x);
+      EXPECT_EQ (cloud2.points[i].y, cloud.points[i].y);
+      EXPECT_EQ (cloud2.points[i].z, cloud.points[i].z);
+      EXPECT_EQ (cloud2.points[i].normal_z, cloud.points[i].normal_z);
+    }
+
+    ASSERT_EQ (mesh2.tex_polygons.size (), 2);
+    ASSERT_EQ (mesh2.tex_coordinates.size (), 2);
+    ASSERT_EQ (mesh2.tex_materials.size (), 2);
+    for (size_t m = 0; m < 2; ++m)
+    {
+      ASSERT_EQ (mesh2.tex_polygons[m].size (), mesh.tex_polygons[m].size ());
+      for (size_t i = 0; i < mesh.tex_polygons[m].size (); ++i)
+        EXPECT_TRUE (mesh2.tex_polygons[m][i].vertices == mesh.tex_polygons[m][i].vertices);
+      ASSERT_EQ (mesh2.tex_coordinates[m].size (), mesh.tex_coordinates[m].size ());
+      for (size_t i = 0; i < mesh.tex_coordinates[m].size (); ++i)
+      {
+        EXPECT_FLOAT_EQ (mesh2.tex_coordinates[m][i][0], mesh.tex_coordinates[m][i][0]);
+        EXPECT_FLOAT_EQ (mesh2.tex_coordinates[m][i][1], mesh.tex_coordinates[m][i][1]);
+      }
+      EXPECT_EQ (mesh2.tex_materials[m].tex_name, mesh.tex_materials[m].tex_name);
+      EXPECT_EQ (mesh2.tex_materials[m].tex_file, mesh.tex_materials[m].tex_file);
+      EXPECT_EQ (mesh2.tex_materials[m].tex_Kd.g, mesh.tex_materials[m].tex_Kd.g);
+      EXPECT_EQ (mesh2.tex_materials[m].tex_illum, 2);
+    }
+
+    PolygonMesh polygon_mesh;
+    EXPECT_EQ (reader.read ("test_pcl_io.obj", polygon_mesh), 0);
+    EXPECT_EQ (polygon_mesh.cloud.width, 100);
+    ASSERT_EQ (polygon_mesh.polygons.size (), mesh.tex_polygons[0].size () + mesh.tex_polygons[1].size ());
+    EXPECT_TRUE (polygon_mesh.polygons.back ().vertices == mesh.tex_polygons[1].back ().vertices);
+  }
+
+  // Relative indices, polygons of mixed sizes, and no normals
+  {
+    std::ofstream fs ("test_pcl_io.obj", std::ios::binary);
+    fs << "# comment\r\nv 0 0 0\r\nv 1 0 0\nv 1 1 0 1\n\nv 0 1 0\no object\n"
+          "f 1 2 3\nf -4 -2 -1\nf 1//1 2//1 3//1 4//1\n";
+  }
+  PolygonMesh polygon_mesh;
+  EXPECT_EQ (io::loadOBJFile ("test_pcl_io.obj", polygon_mesh), 0);
+  EXPECT_EQ (getFieldIndex (polygon_mesh.cloud, "normal_x"), -1);
+  EXPECT_EQ (polygon_mesh.cloud.width, 4);
+  ASSERT_EQ (polygon_mesh.polygons.size (), 3);
+  EXPECT_EQ (polygon_mesh.polygons[1].vertices[0], 0);
+  EXPECT_EQ (polygon_mesh.polygons[1].vertices[1], 2);
+  EXPECT_EQ (polygon_mesh.polygons[1].vertices[2], 3);
+  EXPECT_EQ (polygon_mesh.polygons[2].vertices.size (), 4);
+
+  // Out of range index
+  {
+    std::ofstream fs ("test_pcl_io.obj");
+    fs << "v 0 0 0\nf 1 2 1\n";
+  }
+  EXPECT_LT (io::loadOBJFile ("test_pcl_io.obj", polygon_mesh), 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, AsyncPCDWriter)
+{
+  // Clouds of different sizes, to recognize them in the files
+  std::vector<PointCloud<PointXYZ>::ConstPtr> clouds;
+  for (int i = 0; i < 20; ++i)
+  {
+    PointCloud<PointXYZ>::Ptr cloud (new PointCloud<PointXYZ>);
+    cloud->points.resize (100 + i * 37);
+    for (size_t j = 0; j < cloud->points.size (); ++j)
+      cloud->points[j].x = cloud->points[j].y = cloud->points[j].z = static_cast<float> (i);
+    cloud->width = static_cast<uint32_t> (cloud->points.size ());
+    cloud->height = 1;
+    clouds.push_back (cloud);
+  }
+
+  {
+    AsyncPCDWriter writer ("test_pcl_io_async_", 4);
+    writer.setNumberOfThreads (3);
+    writer.setFormat (AsyncPCDWriter::BINARY_COMPRESSED);
+    writer.start ();
+    EXPECT_TRUE (writer.isRunning ());
+    for (size_t i = 0; i < clouds.size (); ++i)
+      EXPECT_TRUE (writer.push (clouds[i]));
+    writer.flush ();
+
+    AsyncPCDWriter::Statistics stats = writer.getStatistics ();
+    EXPECT_EQ (stats.pushed, clouds.size ());
+    EXPECT_EQ (stats.written, clouds.size ());
+    EXPECT_EQ (stats.dropped, 0);
+    EXPECT_EQ (stats.failed, 0);
+    EXPECT_EQ (stats.queued, 0);
+    EXPECT_LE (stats.max_queued, 4);
+    writer.stop ();
+    EXPECT_FALSE (writer.isRunning ());
+
+    // The files are named in push order
+    EXPECT_EQ (writer.getFileName (7), "test_pcl_io_async_000007.pcd");
+    PCDReader reader;
+    for (size_t i = 0; i < clouds.size (); ++i)
+    {
+      PointCloud<PointXYZ> cloud;
+      ASSERT_EQ (reader.read (writer.getFileName (i), cloud), 0);
+      ASSERT_EQ (cloud.points.size (), clouds[i]->points.size ());
+      EXPECT_EQ (cloud.points.back ().z, static_cast<float> (i));
+      remove (writer.getFileName (i).c_str ());
+    }
+  }
+
+  // Overflow policies, with the writer threads not started yet
+  {
+    AsyncPCDWriter writer ("test_pcl_io_async_", 2);
+    writer.setOverflowPolicy (AsyncPCDWriter::DROP_NEWEST);
+    EXPECT_TRUE (writer.push (clouds[0]));
+    EXPECT_TRUE (writer.push (clouds[1]));
+    EXPECT_FALSE (writer.push (clouds[2]));
+    writer.setOverflowPolicy (AsyncPCDWriter::DROP_OLDEST);
+    EXPECT_TRUE (writer.push (clouds[3]));
+
+    sensor_msgs::PointCloud2::Ptr blob (new sensor_msgs::PointCloud2);
+    toROSMsg (*clouds[4], *blob);
+    EXPECT_TRUE (writer.push (blob, Eigen::Vector4f (1, 2, 3, 0)));
+
+    AsyncPCDWriter::Statistics stats = writer.getStatistics ();
+    EXPECT_EQ (stats.pushed, 4);
+    EXPECT_EQ (stats.dropped, 3);
+    EXPECT_EQ (stats.queued, 2);
+
+    // The remaining clouds (3 and 4) get contiguous names
+    writer.setNextIndex (10);
+    writer.start ();
+    writer.stop ();
+    EXPECT_EQ (writer.getStatistics ().written, 2);
+
+    PCDReader reader;
+    PointCloud<PointXYZ> cloud;
+    ASSERT_EQ (reader.read (writer.getFileName (10), cloud), 0);
+    EXPECT_EQ (cloud.points.size (), clouds[3]->points.size ());
+    ASSERT_EQ (reader.read (writer.getFileName (11), cloud), 0);
+    EXPECT_EQ (cloud.points.size (), clouds[4]->points.size ());
+    EXPECT_EQ (cloud.sensor_origin_[1], 2.0f);
+    remove (writer.getFileName (10).c_str ());
+    remove (writer.getFileName (11).c_str ());
+  }
+
+  // A cloud the PCD writer throws on counts as failed, and the threads keep going
+  {
+    AsyncPCDWriter writer ("test_pcl_io_async_", 4);
+    writer.start ();
+    EXPECT_TRUE (writer.push (PointCloud<PointXYZ>::ConstPtr (new PointCloud<PointXYZ>)));
+    EXPECT_TRUE (writer.push (clouds[0]));
+    writer.stop ();
+
+    AsyncPCDWriter::Statistics stats = writer.getStatistics ();
+    EXPECT_EQ (stats.failed, 1);
+    EXPECT_EQ (stats.written, 1);
+    remove (writer.getFileName (0).c_str ());
+    remove (writer.getFileName (1).c_str ());
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** \brief Append a file to a (USTAR) TAR archive. */
+void
+appendTARFile (std::ofstream &tar, const std::string &name, const std::string &contents)
+{
+  io::TARHeader header;
+  memset (&header, 0, sizeof (header));
+  strncpy (header.file_name, name.c_str (), sizeof (header.file_name) - 1);
+  strcpy (header.file_mode, "0000644");
+  strcpy (header.uid, "0000000");
+  strcpy (header.gid, "0000000");
+  sprintf (header.file_size, "%011o", static_cast<unsigned int> (contents.size ()));
+  strcpy (header.mtime, "00000000000");
+  header.file_type[0] = '0';
+  memcpy (header.ustar, "ustar", 6);
+  memcpy (header.ustar_version, "00", 2);
+  memset (header.chksum, ' ', sizeof (header.chksum));
+  unsigned int chksum = 0;
+  for (size_t i = 0; i < sizeof (header); ++i)
+    chksum += reinterpret_cast<unsigned char*> (&header)[i];
+  sprintf (header.chksum, "%06o", chksum);
+  tar.write (reinterpret_cast<char*> (&header), sizeof (header));
+  tar << contents;
+  tar << std::string ((512 - contents.size () % 512) % 512, '\0');
+}
+
+/** \brief Records the size of the published clouds. */
+struct GrabberRecorder
+{
+  void
+  callback (const PointCloud<PointXYZ>::ConstPtr &cloud)
+  {
+    sizes.push_back (cloud->points.size ());
+  }
+  std::vector<size_t> sizes;
+};
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, PCDGrabberTAR)
+{
+  // A TAR archive holding frames of 1, 2, ... 10 points
+  {
+    std::ofstream tar ("test_pcl_io.tar", std::ios::binary);
+    PCDWriter writer;
+    for (int i = 0; i < 10; ++i)
+    {
+      PointCloud<PointXYZ> cloud;
+      cloud.points.resize (i + 1);
+      cloud.width = i + 1;
+      cloud.height = 1;
+      writer.writeBinary ("test_pcl_io_frame.pcd", cloud);
+      std::ifstream fs ("test_pcl_io_frame.pcd", std::ios::binary);
+      std::ostringstream contents;
+      contents << fs.rdbuf ();
+      appendTARFile (tar, "frame.pcd", contents.str ());
+    }
+    tar << std::string (1024, '\0');
+  }
+  remove ("test_pcl_io.tar.idx");
+
+  for (int run = 0; run < 2; ++run)
+  {
+    // The second run uses the index cached by the first one
+    PCDGrabber<PointXYZ> grabber ("test_pcl_io.tar", 0, true);
+    EXPECT_EQ (grabber.getNumberOfFrames (), 10);
+    EXPECT_TRUE (boost::filesystem::exists ("test_pcl_io.tar.idx"));
+    grabber.setPrefetchWindow (run == 0 ? 0 : 3);
+
+    GrabberRecorder recorder;
+    boost::function<void (const PointCloud<PointXYZ>::ConstPtr&)> f = 
+      boost::bind (&GrabberRecorder::callback, &recorder, _1);
+    grabber.registerCallback (f);
+
+    for (int i = 0; i < 3; ++i)
+      grabber.trigger ();
+    EXPECT_TRUE (grabber.seek (8));
+    EXPECT_FALSE (grabber.seek (10));
+    // Playback goes on from the seek position, and wraps around
+    for (int i = 0; i < 3; ++i)
+      grabber.trigger ();
+    EXPECT_EQ (grabber.getCurrentFrame (), 1);
+    grabber.rewind ();
+    grabber.trigger ();
+
+    ASSERT_EQ (recorder.sizes.size (), 7);
+    EXPECT_EQ (recorder.sizes[0], 1);
+    EXPECT_EQ (recorder.sizes[2], 3);
+    EXPECT_EQ (recorder.sizes[3], 9);
+    EXPECT_EQ (recorder.sizes[4], 10);
+    EXPECT_EQ (recorder.sizes[5], 1);
+    EXPECT_EQ (recorder.sizes[6], 1);
+  }
+
+  // A stale index is rebuilt
+  {
+    std::ofstream tar ("test_pcl_io.tar", std::ios::binary | std::ios::app);
+    tar << std::string (512, '\0');
+  }
+  PCDGrabber<PointXYZ> grabber ("test_pcl_io.tar");
+  EXPECT_EQ (grabber.getNumberOfFrames (), 10);
+
+  remove ("test_pcl_io.tar");
+  remove ("test_pcl_io.tar.idx");
+  remove ("test_pcl_io_frame.pcd");
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, Locale)
 {
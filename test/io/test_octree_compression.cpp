@@ -0,0 +1,308 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012, Willow Garage, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of Willow Garage, Inc. nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ */
+
+#include <gtest/gtest.h>
+#include <pcl/point_types.h>
+#include <pcl/compression/octree_pointcloud_compression.h>
+#include <pcl/compression/tiled_octree_pointcloud_compression.h>
+#include <pcl/compression/octree_pointcloud_sequence.h>
+
+#include <cmath>
+#include <cstdio>
+#include <fstream>
+#include <limits>
+#include <map>
+#include <sstream>
+#include <vector>
+
+typedef pcl::PointXYZRGBA PointT;
+typedef pcl::PointCloud<PointT> PointCloud;
+
+// The points lie on a 5cm grid, far coarser than the 1mm coding precision,
+// so that decoded points can be matched exactly to the original ones
+static const float grid = 0.05f;
+
+typedef std::map<std::vector<int>, uint32_t> GridPoints;
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+std::vector<int>
+gridKey (const PointT &point)
+{
+  std::vector<int> key (3);
+  key[0] = static_cast<int> (floor (point.x / grid + 0.5f));
+  key[1] = static_cast<int> (floor (point.y / grid + 0.5f));
+  key[2] = static_cast<int> (floor (point.z / grid + 0.5f));
+  return (key);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+/** Two clusters, so that some of the tiles are empty, plus a few NaN points. */
+PointCloud::Ptr
+createFrame (int frame, GridPoints &points)
+{
+  PointCloud::Ptr cloud (new PointCloud);
+  points.clear ();
+  srand (static_cast<unsigned int> (frame + 1));
+  for (int i = 0; i < 4000; ++i)
+  {
+    PointT point;
+    int gx = rand () % 20 + ((i % 2) ? 60 : 0) + frame;
+    int gy = rand () % 20;
+    int gz = rand () % 20;
+    point.x = static_cast<float> (gx) * grid;
+    point.y = static_cast<float> (gy) * grid;
+    point.z = static_cast<float> (gz) * grid;
+    point.rgba = (static_cast<uint32_t> (gx * 2) << 16) | (static_cast<uint32_t> (gy * 8) << 8) | static_cast<uint32_t> (gz * 12);
+    if (points.find (gridKey (point)) != points.end ())
+      continue;
+    points[gridKey (point)] = point.rgba;
+    cloud->points.push_back (point);
+  }
+  PointT nan_point;
+  nan_point.x = nan_point.y = nan_point.z = std::numeric_limits<float>::quiet_NaN ();
+  cloud->points.push_back (nan_point);
+  cloud->width = static_cast<uint32_t> (cloud->points.size ());
+  cloud->height = 1;
+  cloud->is_dense = false;
+  return (cloud);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+void
+checkDecodedFrame (const PointCloud &decoded, const GridPoints &points)
+{
+  ASSERT_EQ (decoded.points.size (), points.size ());
+  GridPoints found;
+  for (size_t i = 0; i < decoded.points.size (); ++i)
+  {
+    const PointT &point = decoded.points[i];
+    std::vector<int> key = gridKey (point);
+    EXPECT_NEAR (point.x, static_cast<float> (key[0]) * grid, 0.002f);
+    EXPECT_NEAR (point.y, static_cast<float> (key[1]) * grid, 0.002f);
+    EXPECT_NEAR (point.z, static_cast<float> (key[2]) * grid, 0.002f);
+    GridPoints::const_iterator it = points.find (key);
+    ASSERT_TRUE (it != points.end ());
+    found[key] = point.rgba;
+
+    // 6 bits per channel
+    for (int c = 0; c < 3; ++c)
+      EXPECT_NEAR (static_cast<int> ((point.rgba >> (8 * c)) & 0xFF), static_cast<int> ((it->second >> (8 * c)) & 0xFF), 4);
+  }
+  EXPECT_EQ (found.size (), points.size ());
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OctreeCompressionStages)
+{
+  // encodePointCloud and the serialize/encodeFrameData stages give the same stream
+  pcl::io::OctreePointCloudCompression<PointT> encoder (pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, false, 3, true, 6);
+  pcl::io::OctreePointCloudCompression<PointT> staged (pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, false, 3, true, 6);
+  pcl::io::OctreePointCloudCompression<PointT> decoder (pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, false, 3, true, 6);
+  pcl::StaticRangeCoder coder;
+  std::stringstream stream, staged_stream;
+  std::vector<GridPoints> frames (6);
+  for (int f = 0; f < 6; ++f)
+  {
+    PointCloud::Ptr cloud = createFrame (f, frames[f]);
+    encoder.encodePointCloud (cloud, stream);
+
+    pcl::io::OctreePointCloudCompression<PointT>::FrameData frame;
+    ASSERT_TRUE (staged.serializePointCloud (cloud, frame));
+    if (f == 0)
+    {
+      EXPECT_TRUE (frame.iFrame);
+    }
+    staged_stream.write (frame.header.data (), frame.header.size ());
+    uint64_t point_len, color_len;
+    pcl::io::OctreePointCloudCompression<PointT>::encodeFrameData (frame, coder, staged_stream, point_len, color_len);
+  }
+  EXPECT_EQ (stream.str (), staged_stream.str ());
+
+  for (int f = 0; f < 6; ++f)
+  {
+    PointCloud::Ptr decoded (new PointCloud);
+    decoder.decodePointCloud (stream, decoded);
+    checkDecodedFrame (*decoded, frames[f]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, TiledOctreeCompression)
+{
+  pcl::io::TiledOctreePointCloudCompression<PointT> encoder (pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, false, 3, true, 6);
+  pcl::io::TiledOctreePointCloudCompression<PointT> decoder (pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, false, 3, true, 6);
+  EXPECT_EQ (encoder.getNumberOfTiles (), 8);
+  encoder.setNumberOfTiles (6);
+  EXPECT_EQ (encoder.getNumberOfTiles (), 6);
+
+  std::stringstream stream;
+  std::vector<GridPoints> frames (8);
+  for (int f = 0; f < 8; ++f)
+  {
+    // a different tile layout in the middle of the stream
+    if (f == 5)
+      encoder.setNumberOfTiles (3);
+    encoder.encodePointCloud (createFrame (f, frames[f]), stream);
+  }
+
+  PointCloud::Ptr decoded;
+  for (int f = 0; f < 8; ++f)
+  {
+    decoder.decodePointCloud (stream, decoded);
+    ASSERT_TRUE (decoded.get () != NULL);
+    checkDecodedFrame (*decoded, frames[f]);
+  }
+
+  // the end of the stream gives an empty cloud
+  decoder.decodePointCloud (stream, decoded);
+  EXPECT_EQ (decoded->points.size (), 0);
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, TiledOctreeCompressionPipeline)
+{
+  pcl::io::TiledOctreePointCloudCompression<PointT> encoder (pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, false, 3, true, 6);
+  pcl::io::TiledOctreePointCloudCompression<PointT> reference (pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, false, 3, true, 6);
+  pcl::io::TiledOctreePointCloudCompression<PointT> decoder (pcl::io::MANUAL_CONFIGURATION, false, 0.001, 0.01, false, 3, true, 6);
+
+  std::stringstream stream, reference_stream;
+  std::vector<GridPoints> frames (10);
+  EXPECT_FALSE (encoder.encodePointCloudAsync (createFrame (0, frames[0])));
+  encoder.startPipeline (stream);
+  EXPECT_TRUE (encoder.isPipelineRunning ());
+  for (int f = 0; f < 10; ++f)
+  {
+    PointCloud::Ptr cloud = createFrame (f, frames[f]);
+    EXPECT_TRUE (encoder.encodePointCloudAsync (cloud));
+    reference.encodePointCloud (cloud, reference_stream);
+  }
+  encoder.stopPipeline ();
+  EXPECT_FALSE (encoder.isPipelineRunning ());
+
+  // the pipelined and the synchronous streams are the same
+  EXPECT_EQ (stream.str (), reference_stream.str ());
+
+  PointCloud::Ptr decoded;
+  for (int f = 0; f < 10; ++f)
+  {
+    decoder.decodePointCloud (stream, decoded);
+    checkDecodedFrame (*decoded, frames[f]);
+  }
+}
+
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, OctreePointCloudSequence)
+{
+  const std::string file_name = "test_octree_sequence.pcs";
+  std::vector<GridPoints> frames (14);
+  {
+    pcl::io::OctreePointCloudSequenceWriter<PointT> writer (pcl::io::MANUAL_CONFIGURATION, 0.001, 0.01, false, 4, true, 6);
+    EXPECT_FALSE (writer.writeFrame (createFrame (0, frames[0])));
+    ASSERT_TRUE (writer.open (file_name));
+    for (int f = 0; f < 14; ++f)
+    {
+      PointCloud::Ptr cloud = createFrame (f, frames[f]);
+      // an empty frame in the middle of the sequence
+      if (f == 7)
+      {
+        cloud->points.clear ();
+        frames[f].clear ();
+      }
+      cloud->header.stamp = 1000 + f;
+      cloud->header.frame_id = "/sensor";
+      EXPECT_TRUE (writer.writeFrame (cloud));
+    }
+    EXPECT_EQ (writer.getNumberOfFrames (), 14);
+    EXPECT_TRUE (writer.close ());
+  }
+
+  pcl::io::OctreePointCloudSequenceReader<PointT> reader;
+  ASSERT_TRUE (reader.open (file_name));
+  ASSERT_EQ (reader.getNumberOfFrames (), 14);
+  EXPECT_TRUE (reader.getFrame (0).keyFrame);
+  EXPECT_FALSE (reader.getFrame (1).keyFrame);
+  EXPECT_TRUE (reader.getFrame (7).keyFrame);
+  EXPECT_EQ (reader.getFrame (5).stamp, 1005);
+  EXPECT_EQ (reader.getKeyFrame (9), 8);
+
+  // in order, then out of order
+  PointCloud::Ptr decoded;
+  for (int f = 0; f < 14; ++f)
+  {
+    ASSERT_TRUE (reader.readFrame (f, decoded));
+    EXPECT_EQ (decoded->header.stamp, 1000 + f);
+    EXPECT_EQ (decoded->header.frame_id, "/sensor");
+    checkDecodedFrame (*decoded, frames[f]);
+  }
+  const int order[] = {11, 3, 4, 13, 0, 6, 6, 12};
+  for (int i = 0; i < 8; ++i)
+  {
+    ASSERT_TRUE (reader.readFrame (order[i], decoded));
+    checkDecodedFrame (*decoded, frames[order[i]]);
+  }
+  EXPECT_FALSE (reader.readFrame (14, decoded));
+  reader.close ();
+
+  // a file which was not closed: no index, and a truncated last frame
+  std::string data;
+  {
+    std::ifstream file (file_name.c_str (), std::ios::binary);
+    data.assign (std::istreambuf_iterator<char> (file), std::istreambuf_iterator<char> ());
+  }
+  const size_t index_offset = static_cast<size_t> (*reinterpret_cast<const uint64_t*> (&data[16]));
+  data.resize (index_offset - 10);
+  memset (&data[16], 0, sizeof (uint64_t));
+  {
+    std::ofstream file (file_name.c_str (), std::ios::binary | std::ios::trunc);
+    file.write (data.data (), data.size ());
+  }
+  ASSERT_TRUE (reader.open (file_name));
+  ASSERT_EQ (reader.getNumberOfFrames (), 13);
+  ASSERT_TRUE (reader.readFrame (10, decoded));
+  checkDecodedFrame (*decoded, frames[10]);
+  reader.close ();
+  remove (file_name.c_str ());
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  testing::InitGoogleTest (&argc, argv);
+  return (RUN_ALL_TESTS ());
+}
+/* ]--- */
@@ -170,6 +170,64 @@ TEST (PCL, Static_Range_Coder_Test)
 
 
 
+//////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, Static_Range_Coder_Bitstream_Versions)
+{
+  std::stringstream sstream;
+  unsigned long writeByteLen = 0;
+  unsigned long readByteLen = 0;
+
+  // skewed char data, sparse integers with large values (rANS only, the frequency table of the range
+  // coder would cover all the values), and integers with too many distinct values for rANS
+  std::vector<char> inputCharData (20000);
+  std::vector<unsigned int> sparseIntData (5000);
+  std::vector<unsigned int> wideIntData (100000);
+  for (size_t i = 0; i < inputCharData.size (); i++)
+    inputCharData[i] = static_cast<char> ((rand () % 5) * (rand () % 4));
+  for (size_t i = 0; i < sparseIntData.size (); i++)
+    sparseIntData[i] = static_cast<unsigned int> (rand () % 8) << 28;
+  for (size_t i = 0; i < wideIntData.size (); i++)
+    wideIntData[i] = static_cast<unsigned int> (i);
+  std::vector<char> emptyCharData;
+
+  // write every vector with both bitstream versions into a single stream
+  pcl::StaticRangeCoder encoder;
+  EXPECT_EQ (encoder.getBitstreamVersion (), pcl::StaticRangeCoder::RANS_BITSTREAM);
+  for (int version = 0; version < 2; version++)
+  {
+    encoder.setBitstreamVersion (version ? pcl::StaticRangeCoder::RANS_BITSTREAM : pcl::StaticRangeCoder::RANGE_CODER_BITSTREAM);
+    writeByteLen += encoder.encodeCharVectorToStream (inputCharData, sstream);
+    if (version)
+      writeByteLen += encoder.encodeIntVectorToStream (sparseIntData, sstream);
+    writeByteLen += encoder.encodeIntVectorToStream (wideIntData, sstream);
+    writeByteLen += encoder.encodeCharVectorToStream (emptyCharData, sstream);
+  }
+  EXPECT_EQ (writeByteLen, sstream.str ().length ());
+
+  // the decoder detects the version of every vector
+  pcl::StaticRangeCoder decoder;
+  for (int version = 0; version < 2; version++)
+  {
+    std::vector<char> outputCharData (inputCharData.size ());
+    std::vector<unsigned int> outputSparseData (sparseIntData.size ());
+    std::vector<unsigned int> outputWideData (wideIntData.size ());
+    std::vector<char> outputEmptyData;
+    readByteLen += decoder.decodeStreamToCharVector (sstream, outputCharData);
+    if (version)
+      readByteLen += decoder.decodeStreamToIntVector (sstream, outputSparseData);
+    readByteLen += decoder.decodeStreamToIntVector (sstream, outputWideData);
+    readByteLen += decoder.decodeStreamToCharVector (sstream, outputEmptyData);
+
+    EXPECT_TRUE (inputCharData == outputCharData);
+    if (version)
+    {
+      EXPECT_TRUE (sparseIntData == outputSparseData);
+    }
+    EXPECT_TRUE (wideIntData == outputWideData);
+  }
+  EXPECT_EQ (writeByteLen, readByteLen);
+}
+
 /* ---[ */
 int
   main (int argc, char** argv)
@@ -44,6 +44,7 @@
 #include <pcl/point_types.h>
 #include <pcl/point_cloud.h>
 #include <pcl/common/transforms.h>
+#include <pcl/common/io.h>
 
 using namespace pcl;
 using namespace pcl::io;
@@ -189,6 +190,111 @@ TEST (PCL, Transform)
   EXPECT_EQ (1, points2[3].z);
 }
 
+//////////////////////////////////////////////////////////////////////////////////////////////
+TEST (PCL, TransformPointCloudVectorized)
+{
+  Eigen::Affine3f transform = Eigen::Affine3f::Identity ();
+  transform.rotate (Eigen::AngleAxisf (0.7f, Eigen::Vector3f (1.0f, -2.0f, 0.5f).normalized ()));
+  transform.translation () << 10.0f, -3.0f, 0.25f;
+
+  // 1001 points with normals, some of them non finite
+  PointCloud<PointXYZRGBNormal> cloud_in;
+  cloud_in.width = 1001;
+  cloud_in.height = 1;
+  cloud_in.is_dense = false;
+  cloud_in.points.resize (cloud_in.width);
+  for (size_t i = 0; i < cloud_in.points.size (); ++i)
+  {
+    PointXYZRGBNormal &p = cloud_in.points[i];
+    p.x = static_cast<float> (i % 17) * 0.3f - 2.0f;
+    p.y = static_cast<float> (i % 23) * 0.1f;
+    p.z = 5.0f - static_cast<float> (i) * 0.01f;
+    p.getNormalVector3fMap () = Eigen::Vector3f (p.y, 1.0f, p.x).normalized ();
+    p.rgba = static_cast<uint32_t> (i);
+    p.curvature = static_cast<float> (i);
+  }
+  cloud_in.points[10].x = std::numeric_limits<float>::quiet_NaN ();
+  cloud_in.points[500].z = std::numeric_limits<float>::infinity ();
+
+  // Scalar reference
+  PointCloud<PointXYZRGBNormal> reference = cloud_in;
+  for (size_t i = 0; i < reference.points.size (); ++i)
+  {
+    if (!pcl_isfinite (reference.points[i].x) || !pcl_isfinite (reference.points[i].z))
+      continue;
+    reference.points[i].getVector3fMap () = transform * cloud_in.points[i].getVector3fMap ();
+    reference.points[i].getNormalVector3fMap () = transform.linear () * cloud_in.points[i].getNormalVector3fMap ();
+  }
+
+  for (unsigned int nr_threads = 1; nr_threads <= 4; nr_threads += 3)
+  {
+    PointCloud<PointXYZRGBNormal> cloud_out;
+    transformPointCloudWithNormals (cloud_in, cloud_out, transform, nr_threads);
+    PointCloud<PointXYZRGBNormal> cloud_inplace = cloud_in;
+    transformPointCloudWithNormals (cloud_inplace, transform, nr_threads);
+    PointCloud<PointXYZRGBNormal> cloud_xyz;
+    transformPointCloud (cloud_in, cloud_xyz, transform, nr_threads);
+
+    ASSERT_EQ (cloud_out.points.size (), reference.points.size ());
+    EXPECT_EQ (cloud_out.width, cloud_in.width);
+    EXPECT_FALSE (cloud_out.is_dense);
+    for (size_t i = 0; i < reference.points.size (); ++i)
+    {
+      const PointXYZRGBNormal &r = reference.points[i];
+      const PointXYZRGBNormal &p = cloud_out.points[i];
+      if (!pcl::isFinite (r))
+      {
+        EXPECT_EQ (p.y, r.y);
+        continue;
+      }
+      EXPECT_NEAR (p.x, r.x, 1e-5);
+      EXPECT_NEAR (p.y, r.y, 1e-5);
+      EXPECT_NEAR (p.z, r.z, 1e-5);
+      EXPECT_NEAR (p.normal_x, r.normal_x, 1e-6);
+      EXPECT_NEAR (p.normal_y, r.normal_y, 1e-6);
+      EXPECT_NEAR (p.normal_z, r.normal_z, 1e-6);
+      EXPECT_EQ (p.data[3], r.data[3]);
+      EXPECT_EQ (p.rgba, r.rgba);
+      EXPECT_EQ (p.curvature, r.curvature);
+      EXPECT_EQ (cloud_inplace.points[i].getVector3fMap (), p.getVector3fMap ());
+      EXPECT_EQ (cloud_inplace.points[i].getNormalVector3fMap (), p.getNormalVector3fMap ());
+      EXPECT_EQ (cloud_xyz.points[i].getVector3fMap (), p.getVector3fMap ());
+      EXPECT_EQ (cloud_xyz.points[i].getNormalVector3fMap (), cloud_in.points[i].getNormalVector3fMap ());
+    }
+  }
+
+  // Indexed variant, including non finite points
+  std::vector<int> indices;
+  for (int i = 1000; i >= 0; i -= 7)
+    indices.push_back (i);
+  indices.push_back (10);
+  PointCloud<PointXYZRGBNormal> cloud_indexed;
+  transformPointCloudWithNormals (cloud_in, indices, cloud_indexed, transform);
+  ASSERT_EQ (cloud_indexed.points.size (), indices.size ());
+  EXPECT_EQ (cloud_indexed.height, 1);
+  for (size_t i = 0; i < indices.size (); ++i)
+  {
+    EXPECT_EQ (cloud_indexed.points[i].curvature, reference.points[indices[i]].curvature);
+    EXPECT_NEAR (cloud_indexed.points[i].y, reference.points[indices[i]].y, 1e-5);
+    EXPECT_NEAR (cloud_indexed.points[i].normal_z, reference.points[indices[i]].normal_z, 1e-6);
+  }
+
+  // Point types without padding go through the scalar path
+  PointCloud<PointXYZPacked> packed, packed_out;
+  copyPointCloud (cloud_in, packed);
+  transformPointCloud (packed, packed_out, transform);
+  ASSERT_EQ (packed_out.points.size (), reference.points.size ());
+  for (size_t i = 0; i < reference.points.size (); ++i)
+    if (pcl::isFinite (reference.points[i]))
+      EXPECT_NEAR ((packed_out.points[i].getVector3fMap () - reference.points[i].getVector3fMap ()).norm (), 0.0f, 1e-5);
+
+  // Matrix4f versions
+  PointCloud<PointXYZRGBNormal> cloud_matrix;
+  transformPointCloudWithNormals (cloud_in, cloud_matrix, transform.matrix ());
+  EXPECT_NEAR (cloud_matrix.points[42].x, reference.points[42].x, 1e-5);
+  EXPECT_NEAR (cloud_matrix.points[42].normal_y, reference.points[42].normal_y, 1e-6);
+}
+
 //////////////////////////////////////////////////////////////////////////////////////////////
 TEST (PCL, commonTransform)
 {
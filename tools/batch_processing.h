@@ -0,0 +1,234 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#ifndef PCL_TOOLS_BATCH_PROCESSING_H_
+#define PCL_TOOLS_BATCH_PROCESSING_H_
+
+#include <pcl/console/print.h>
+#include <pcl/console/parse.h>
+#include <pcl/console/time.h>
+#include <pcl/exceptions.h>
+#include <boost/filesystem.hpp>
+#include <boost/algorithm/string.hpp>
+
+#include <algorithm>
+#include <exception>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/** \brief Batch mode shared by the command line converters and filters.
+  *
+  * A tool in batch mode processes all the files of a directory (-input_dir)
+  * or of a list (-input_list) and writes the results to -output_dir, keeping
+  * the file names and changing their extension. The files are processed by
+  * -jobs threads, each one holding a single file at a time, so that the
+  * memory use is bounded by the number of jobs. One line is printed per file,
+  * with its processing time.
+  *
+  * A tool provides a processor, which turns an input file into an output
+  * file without printing anything:
+  * \code
+  * struct Processor
+  * {
+  *   bool operator () (const std::string &input, const std::string &output, size_t &nr_points) const;
+  * };
+  * \endcode
+  */
+namespace batch
+{
+  /** \brief An input file and the corresponding output file. */
+  struct File
+  {
+    std::string input;
+    std::string output;
+  };
+
+  /** \brief Print the help of the batch mode options. */
+  inline void
+  printHelp ()
+  {
+    pcl::console::print_info ("\n  Batch mode options:\n");
+    pcl::console::print_info ("                     -input_dir X  = process all the files of directory X with the input extension\n");
+    pcl::console::print_info ("                     -input_list X = process the files listed in text file X, one per line\n");
+    pcl::console::print_info ("                     -output_dir X = save the processed files in directory X (created if needed)\n");
+    pcl::console::print_info ("                     -jobs X       = number of files processed concurrently (default: number of cores)\n");
+  }
+
+  /** \brief Parse the batch mode options.
+    * \param[in] argc the number of command line arguments
+    * \param[in] argv the command line arguments
+    * \param[in] input_extension the extension of the input files, e.g. ".pcd"
+    * \param[in] output_extension the extension of the output files, e.g. ".ply"
+    * \param[out] files the files to process
+    * \param[out] nr_jobs the number of jobs (0 for one job per core)
+    * \return 1 in batch mode, 0 if no batch option is given, and -1 on errors
+    */
+  inline int
+  parseArguments (int argc, char** argv, const std::string &input_extension, const std::string &output_extension,
+                  std::vector<File> &files, int &nr_jobs)
+  {
+    namespace fs = boost::filesystem;
+    std::string input_dir, input_list, output_dir;
+    const bool has_dir = pcl::console::parse_argument (argc, argv, "-input_dir", input_dir) != -1;
+    const bool has_list = pcl::console::parse_argument (argc, argv, "-input_list", input_list) != -1;
+    if (!has_dir && !has_list)
+      return (0);
+
+    if (pcl::console::parse_argument (argc, argv, "-output_dir", output_dir) == -1)
+    {
+      pcl::console::print_error ("Need an output directory! Please use -output_dir to continue.\n");
+      return (-1);
+    }
+    nr_jobs = 0;
+    pcl::console::parse_argument (argc, argv, "-jobs", nr_jobs);
+
+    std::vector<std::string> inputs;
+    if (has_dir)
+    {
+      if (!fs::is_directory (input_dir))
+      {
+        pcl::console::print_error ("Batch processing mode enabled, but invalid input directory (%s) given!\n", input_dir.c_str ());
+        return (-1);
+      }
+      const std::string extension = boost::algorithm::to_upper_copy (input_extension);
+      for (fs::directory_iterator itr (input_dir), end_itr; itr != end_itr; ++itr)
+        if (!fs::is_directory (itr->status ()) && boost::algorithm::to_upper_copy (fs::extension (itr->path ())) == extension)
+          inputs.push_back (itr->path ().string ());
+      std::sort (inputs.begin (), inputs.end ());
+    }
+    if (has_list)
+    {
+      std::ifstream list (input_list.c_str ());
+      if (!list.is_open ())
+      {
+        pcl::console::print_error ("Could not open the input list %s!\n", input_list.c_str ());
+        return (-1);
+      }
+      std::string line;
+      while (std::getline (list, line))
+      {
+        boost::trim (line);
+        if (!line.empty () && line[0] != '#')
+          inputs.push_back (line);
+      }
+    }
+
+    boost::system::error_code error;
+    fs::create_directories (output_dir, error);
+    if (!fs::is_directory (output_dir))
+    {
+      pcl::console::print_error ("Could not create the output directory %s!\n", output_dir.c_str ());
+      return (-1);
+    }
+
+    files.resize (inputs.size ());
+    for (size_t i = 0; i < inputs.size (); ++i)
+    {
+      files[i].input = inputs[i];
+      files[i].output = (fs::path (output_dir) / fs::path (inputs[i]).stem ()).string () + output_extension;
+    }
+    return (1);
+  }
+
+  /** \brief Process all the files with \a processor, on \a nr_jobs threads.
+    * \param[in] files the files to process
+    * \param[in] nr_jobs the number of files processed concurrently (0 for one per core)
+    * \param[in] processor the processor of the tool
+    * \return the number of files which could not be processed
+    */
+  template <typename Processor> int
+  process (const std::vector<File> &files, int nr_jobs, const Processor &processor)
+  {
+    pcl::console::TicToc total;
+    total.tic ();
+    const int nr_files = static_cast<int> (files.size ());
+    int nr_failed = 0, nr_done = 0;
+
+    // the library output of concurrent files would be interleaved
+    const pcl::console::VERBOSITY_LEVEL level = pcl::console::getVerbosityLevel ();
+    pcl::console::setVerbosityLevel (pcl::console::L_ERROR);
+
+#pragma omp parallel for schedule(dynamic, 1) num_threads(nr_jobs) reduction(+:nr_failed)
+    for (int i = 0; i < nr_files; ++i)
+    {
+      pcl::console::TicToc tt;
+      tt.tic ();
+      size_t nr_points = 0;
+      bool success = false;
+      std::string error;
+      try
+      {
+        success = processor (files[i].input, files[i].output, nr_points);
+      }
+      catch (const pcl::PCLException &e)
+      {
+        error = e.detailedMessage ();
+      }
+      catch (const std::exception &e)
+      {
+        error = e.what ();
+      }
+      const double time = tt.toc ();
+      if (!success)
+        nr_failed++;
+
+#pragma omp critical (batch_report)
+      {
+        nr_done++;
+        if (success)
+        {
+          pcl::console::print_highlight ("[%d/%d] ", nr_done, nr_files);
+          pcl::console::print_value ("%s ", files[i].output.c_str ());
+          pcl::console::print_value ("[%g ms : %zu points]\n", time, nr_points);
+        }
+        else
+          pcl::console::print_error ("[%d/%d] Could not process %s %s\n", nr_done, nr_files, files[i].input.c_str (), error.c_str ());
+      }
+    }
+
+    pcl::console::setVerbosityLevel (level);
+    pcl::console::print_info ("Processed "); pcl::console::print_value ("%d", nr_files - nr_failed);
+    pcl::console::print_info (" files ("); pcl::console::print_value ("%d", nr_failed);
+    pcl::console::print_info (" failed) in "); pcl::console::print_value ("%g", total.toc ()); pcl::console::print_info (" ms\n");
+    return (nr_failed);
+  }
+}
+
+#endif    // PCL_TOOLS_BATCH_PROCESSING_H_
@@ -44,6 +44,7 @@
 #include <pcl/console/print.h>
 #include <pcl/console/parse.h>
 #include <pcl/console/time.h>
+#include "batch_processing.h"
 
 using namespace std;
 using namespace pcl;
@@ -66,9 +67,7 @@ printHelp (int, char **argv)
   print_info ("                     -k X      = use a fixed number of X-nearest neighbors around each point (default: "); 
   print_value ("%f", default_k); print_info (")\n");
   print_info (" For organized datasets, an IntegralImageNormalEstimation approach will be used, with the RADIUS given value as SMOOTHING SIZE.\n");
-  print_info ("\nOptional arguments are:\n");
-  print_info ("                     -input_dir X  = batch process all PCD files found in input_dir\n");
-  print_info ("                     -output_dir X = save the processed files from input_dir in this directory\n");
+  batch::printHelp ();
 }
 
 bool
@@ -87,19 +86,13 @@ loadCloud (const string &filename, sensor_msgs::PointCloud2 &cloud)
 }
 
 void
-compute (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointCloud2 &output,
-         int k, double radius)
+estimate (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointCloud2 &output,
+          int k, double radius)
 {
   // Convert data to PointCloud<T>
   PointCloud<PointXYZ>::Ptr xyz (new PointCloud<PointXYZ>);
   fromROSMsg (*input, *xyz);
 
-  // Estimate
-  TicToc tt;
-  tt.tic ();
-  
-  print_highlight (stderr, "Computing ");
-
   PointCloud<Normal> normals;
 
   // Try our luck with organized integral image based normal estimation
@@ -122,14 +115,27 @@ compute (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointClou
     ne.compute (normals);
   }
 
-  print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", normals.width * normals.height); print_info (" points]\n");
-
   // Convert data back
   sensor_msgs::PointCloud2 output_normals;
   toROSMsg (normals, output_normals);
   concatenateFields (output_normals, *input, output);
 }
 
+void
+compute (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointCloud2 &output,
+         int k, double radius)
+{
+  // Estimate
+  TicToc tt;
+  tt.tic ();
+  
+  print_highlight (stderr, "Computing ");
+
+  estimate (input, output, k, radius);
+
+  print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", output.width * output.height); print_info (" points]\n");
+}
+
 void
 saveCloud (const string &filename, const sensor_msgs::PointCloud2 &output)
 {
@@ -144,33 +150,29 @@ saveCloud (const string &filename, const sensor_msgs::PointCloud2 &output)
   print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", output.width * output.height); print_info (" points]\n");
 }
 
-int
-batchProcess (const vector<string> &pcd_files, string &output_dir, int k, double radius)
+/** \brief Quiet normal estimation of a file, for the batch mode. The
+  * sensor origin and orientation are kept per file, not in the globals.
+  */
+struct Processor
 {
-  vector<string> st;
-  for (size_t i = 0; i < pcd_files.size (); ++i)
+  bool
+  operator () (const std::string &input, const std::string &output, size_t &nr_points) const
   {
-    // Load the first file
+    Eigen::Vector4f origin;
+    Eigen::Quaternionf rotation;
     sensor_msgs::PointCloud2::Ptr cloud (new sensor_msgs::PointCloud2);
-    if (!loadCloud (pcd_files[i], *cloud)) 
-      return (-1);
-
-    // Perform the feature estimation
-    sensor_msgs::PointCloud2 output;
-    compute (cloud, output, k, radius);
-
-    // Prepare output file name
-    string filename = pcd_files[i];
-    boost::trim (filename);
-    boost::split (st, filename, boost::is_any_of ("/\\"), boost::token_compress_on);
-    
-    // Save into the second file
-    stringstream ss;
-    ss << output_dir << "/" << st.at (st.size () - 1);
-    saveCloud (ss.str (), output);
+    if (loadPCDFile (input, *cloud, origin, rotation) < 0)
+      return (false);
+    sensor_msgs::PointCloud2 normals;
+    estimate (cloud, normals, k, radius);
+    nr_points = normals.width * normals.height;
+    PCDWriter w;
+    return (w.writeBinaryCompressed (output, normals, origin, rotation) == 0);
   }
-  return (0);
-}
+
+  int k;
+  double radius;
+};
 
 /* ---[ */
 int
@@ -184,28 +186,17 @@ main (int argc, char** argv)
     return (-1);
   }
 
-  bool batch_mode = false;
-
   // Command line parsing
   int k = default_k;
   double radius = default_radius;
   parse_argument (argc, argv, "-k", k);
   parse_argument (argc, argv, "-radius", radius);
-  string input_dir, output_dir;
-  if (parse_argument (argc, argv, "-input_dir", input_dir) != -1)
-  {
-    PCL_INFO ("Input directory given as %s. Batch process mode on.\n", input_dir.c_str ());
-    if (parse_argument (argc, argv, "-output_dir", output_dir) == -1)
-    {
-      PCL_ERROR ("Need an output directory! Please use -output_dir to continue.\n");
-      return (-1);
-    }
 
-    // Both input dir and output dir given, switch into batch processing mode
-    batch_mode = true;
-  }
-
-  if (!batch_mode)
+  // Batch mode
+  std::vector<batch::File> files;
+  int nr_jobs = 0;
+  int batch_mode = batch::parseArguments (argc, argv, ".pcd", ".pcd", files, nr_jobs);
+  if (batch_mode == 0)
   {
     // Parse the command line arguments for .pcd files
     vector<int> p_file_indices;
@@ -233,26 +224,9 @@ main (int argc, char** argv)
   }
   else
   {
-    if (input_dir != "" && boost::filesystem::exists (input_dir))
-    {
-      vector<string> pcd_files;
-      boost::filesystem::directory_iterator end_itr;
-      for (boost::filesystem::directory_iterator itr (input_dir); itr != end_itr; ++itr)
-      {
-        // Only add PCD files
-        if (!is_directory (itr->status ()) && boost::algorithm::to_upper_copy (boost::filesystem::extension (itr->path ())) == ".PCD" )
-        {
-          pcd_files.push_back (itr->path ().string ());
-          PCL_INFO ("[Batch processing mode] Added %s for processing.\n", itr->path ().string ().c_str ());
-        }
-      }
-      batchProcess (pcd_files, output_dir, k, radius);
-    }
-    else
-    {
-      PCL_ERROR ("Batch processing mode enabled, but invalid input directory (%s) given!\n", input_dir.c_str ());
-      return (-1);
-    }
+    Processor processor;
+    processor.k = k;
+    processor.radius = radius;
+    return (batch_mode < 0 || batch::process (files, nr_jobs, processor) > 0 ? -1 : 0);
   }
 }
-
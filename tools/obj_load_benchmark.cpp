@@ -0,0 +1,126 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <pcl/console/print.h>
+#include <pcl/console/parse.h>
+#include <pcl/console/time.h>
+#include <pcl/io/obj_io.h>
+#include <pcl/io/vtk_lib_io.h>
+
+using namespace pcl;
+using namespace pcl::io;
+using namespace pcl::console;
+
+int default_iterations = 5;
+int default_threads = 0;
+
+void
+printHelp (int, char **argv)
+{
+  print_error ("Syntax is: %s input.obj <options>\n", argv[0]);
+  print_info ("  where options are:\n");
+  print_info ("                     -iterations X = number of times every reader loads the file (default: ");
+  print_value ("%d", default_iterations); print_info (")\n");
+  print_info ("                     -threads X    = number of threads of the parallel OBJReader run (default: ");
+  print_value ("%d", default_threads); print_info (", i.e. automatic)\n");
+}
+
+/** \brief Load the file \a iterations times with \a load, and print the average time. */
+template <typename Loader> void
+benchmark (const std::string &name, const std::string &file_name, int iterations, Loader load)
+{
+  PolygonMesh mesh;
+  TicToc tt;
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+  {
+    if (load (file_name, mesh) < 0)
+    {
+      print_error ("%s failed to load %s.\n", name.c_str (), file_name.c_str ());
+      return;
+    }
+  }
+  print_info ("%-28s: ", name.c_str ()); print_value ("%g", tt.toc () / iterations);
+  print_info (" ms per load, "); print_value ("%u", mesh.cloud.width * mesh.cloud.height);
+  print_info (" vertices, "); print_value ("%zu", mesh.polygons.size ()); print_info (" polygons\n");
+}
+
+/** \brief Adapts OBJReader to the loader signature used by benchmark. */
+struct OBJReaderLoader
+{
+  OBJReaderLoader (unsigned int threads) : threads_ (threads) {}
+
+  int
+  operator () (const std::string &file_name, PolygonMesh &mesh) const
+  {
+    OBJReader reader;
+    reader.setNumberOfThreads (threads_);
+    return (reader.read (file_name, mesh));
+  }
+
+  unsigned int threads_;
+};
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  print_info ("Compare the OBJ mesh loaders. For more information, use: %s -h\n", argv[0]);
+
+  std::vector<int> obj_file_indices = parse_file_extension_argument (argc, argv, ".obj");
+  if (argc < 2 || obj_file_indices.size () != 1)
+  {
+    printHelp (argc, argv);
+    return (-1);
+  }
+  std::string file_name = argv[obj_file_indices[0]];
+
+  int iterations = default_iterations;
+  int threads = default_threads;
+  parse_argument (argc, argv, "-iterations", iterations);
+  parse_argument (argc, argv, "-threads", threads);
+  if (iterations < 1)
+    iterations = 1;
+
+  benchmark ("vtkOBJReader", file_name, iterations, &loadPolygonFileOBJ);
+  benchmark ("OBJReader (1 thread)", file_name, iterations, OBJReaderLoader (1));
+  benchmark ("OBJReader (parallel)", file_name, iterations, OBJReaderLoader (threads));
+
+  return (0);
+}
@@ -0,0 +1,180 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+#include <pcl/point_types.h>
+#include <pcl/console/print.h>
+#include <pcl/console/parse.h>
+#include <pcl/console/time.h>
+#include <pcl/io/pcd_io.h>
+#include <pcl/compression/octree_pointcloud_compression.h>
+#include <pcl/compression/tiled_octree_pointcloud_compression.h>
+
+#include <sstream>
+
+using namespace pcl;
+using namespace pcl::io;
+using namespace pcl::console;
+
+typedef PointXYZRGBA PointT;
+typedef PointCloud<PointT> Cloud;
+
+int default_frames = 30;
+int default_tiles = 8;
+int default_threads = 0;
+double default_point_resolution = 0.001;
+double default_octree_resolution = 0.01;
+
+void
+printHelp (int, char **argv)
+{
+  print_error ("Syntax is: %s input.pcd <options>\n", argv[0]);
+  print_info ("  where options are:\n");
+  print_info ("                     -frames X     = number of times the cloud is encoded as a stream (default: ");
+  print_value ("%d", default_frames); print_info (")\n");
+  print_info ("                     -tiles X      = number of tiles of the tiled encoders (default: ");
+  print_value ("%d", default_tiles); print_info (")\n");
+  print_info ("                     -threads X    = number of threads of the tiled encoders (default: ");
+  print_value ("%d", default_threads); print_info (", i.e. automatic)\n");
+  print_info ("                     -point_res X  = precision of the point coordinates (default: ");
+  print_value ("%g", default_point_resolution); print_info (")\n");
+  print_info ("                     -octree_res X = octree resolution (default: ");
+  print_value ("%g", default_octree_resolution); print_info (")\n");
+}
+
+/** \brief Print the encoding and decoding times and the compression ratio of a stream. */
+void
+printResult (const std::string &name, const Cloud &cloud, int frames, double encode_time, double decode_time, size_t stream_size)
+{
+  const double raw_size = static_cast<double> (cloud.points.size ()) * frames * (3 * sizeof (float) + 3);
+  print_info ("%-28s: ", name.c_str ());
+  print_value ("%g", encode_time / frames); print_info (" ms encode, ");
+  print_value ("%g", decode_time / frames); print_info (" ms decode, ");
+  print_value ("%g", static_cast<double> (stream_size) / frames); print_info (" bytes per frame, ratio ");
+  print_value ("%g", raw_size / static_cast<double> (stream_size)); print_info ("\n");
+}
+
+/** \brief Encode \a frames times the same cloud with \a encoder, then decode the stream with \a decoder. */
+template <typename Encoder, typename Decoder> void
+benchmark (const std::string &name, const Cloud::ConstPtr &cloud, int frames, Encoder &encoder, Decoder &decoder)
+{
+  std::stringstream stream;
+  TicToc tt;
+  tt.tic ();
+  for (int f = 0; f < frames; ++f)
+    encoder.encodePointCloud (cloud, stream);
+  double encode_time = tt.toc ();
+
+  Cloud::Ptr decoded (new Cloud);
+  tt.tic ();
+  for (int f = 0; f < frames; ++f)
+    decoder.decodePointCloud (stream, decoded);
+  double decode_time = tt.toc ();
+
+  printResult (name, *cloud, frames, encode_time, decode_time, stream.str ().size ());
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  print_info ("Compare the octree point cloud compression modes. For more information, use: %s -h\n", argv[0]);
+
+  std::vector<int> pcd_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
+  if (argc < 2 || pcd_file_indices.size () != 1)
+  {
+    printHelp (argc, argv);
+    return (-1);
+  }
+
+  int frames = default_frames;
+  int tiles = default_tiles;
+  int threads = default_threads;
+  double point_resolution = default_point_resolution;
+  double octree_resolution = default_octree_resolution;
+  parse_argument (argc, argv, "-frames", frames);
+  parse_argument (argc, argv, "-tiles", tiles);
+  parse_argument (argc, argv, "-threads", threads);
+  parse_argument (argc, argv, "-point_res", point_resolution);
+  parse_argument (argc, argv, "-octree_res", octree_resolution);
+  if (frames < 1)
+    frames = 1;
+  if (tiles < 1)
+    tiles = 1;
+
+  Cloud::Ptr cloud (new Cloud);
+  if (loadPCDFile (argv[pcd_file_indices[0]], *cloud) < 0)
+  {
+    print_error ("Could not load %s.\n", argv[pcd_file_indices[0]]);
+    return (-1);
+  }
+  print_info ("Loaded "); print_value ("%zu", cloud->points.size ()); print_info (" points\n");
+
+  {
+    OctreePointCloudCompression<PointT> encoder (MANUAL_CONFIGURATION, false, point_resolution, octree_resolution);
+    OctreePointCloudCompression<PointT> decoder (MANUAL_CONFIGURATION, false, point_resolution, octree_resolution);
+    benchmark ("OctreePointCloudCompression", cloud, frames, encoder, decoder);
+  }
+
+  {
+    TiledOctreePointCloudCompression<PointT> encoder (MANUAL_CONFIGURATION, false, point_resolution, octree_resolution);
+    TiledOctreePointCloudCompression<PointT> decoder (MANUAL_CONFIGURATION, false, point_resolution, octree_resolution);
+    encoder.setNumberOfTiles (tiles);
+    encoder.setNumberOfThreads (threads);
+    decoder.setNumberOfThreads (threads);
+    benchmark ("Tiled", cloud, frames, encoder, decoder);
+  }
+
+  {
+    // Pipelined mode: the decoding is the one of the tiled mode
+    TiledOctreePointCloudCompression<PointT> encoder (MANUAL_CONFIGURATION, false, point_resolution, octree_resolution);
+    encoder.setNumberOfTiles (tiles);
+    encoder.setNumberOfThreads (threads);
+    std::stringstream stream;
+    TicToc tt;
+    tt.tic ();
+    encoder.startPipeline (stream);
+    for (int f = 0; f < frames; ++f)
+      encoder.encodePointCloudAsync (cloud);
+    encoder.stopPipeline ();
+    double encode_time = tt.toc ();
+    printResult ("Tiled (pipelined)", *cloud, frames, encode_time, 0, stream.str ().size ());
+  }
+
+  return (0);
+}
@@ -43,6 +43,7 @@
 #include <pcl/console/time.h>
 #include <pcl/filters/radius_outlier_removal.h>
 #include <pcl/filters/statistical_outlier_removal.h>
+#include "batch_processing.h"
 
 using namespace pcl;
 using namespace pcl::io;
@@ -74,6 +75,7 @@ printHelp (int, char **argv)
   print_value ("%f", default_std_dev_mul); print_info (")\n");
   print_info ("                     -inliers X = (StatisticalOutlierRemoval only) decides whether the inliers should be returned (1), or the outliers (0). (default: ");
   print_value ("%d", default_negative); print_info (")\n");
+  batch::printHelp ();
 }
 
 bool
@@ -91,23 +93,19 @@ loadCloud (const std::string &filename, sensor_msgs::PointCloud2 &cloud)
   return (true);
 }
 
-void
-compute (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointCloud2 &output,
-         std::string method,
-         int min_pts, double radius,
-         int mean_k, double std_dev_mul, bool negative)
+bool
+filter (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointCloud2 &output,
+        const std::string &method,
+        int min_pts, double radius,
+        int mean_k, double std_dev_mul, bool negative)
 {
-
   PointCloud<PointXYZ>::Ptr xyz_cloud_pre (new pcl::PointCloud<PointXYZ> ()),
       xyz_cloud (new pcl::PointCloud<PointXYZ> ());
   fromROSMsg (*input, *xyz_cloud_pre);
-  
+
   std::vector<int> index_vector;
   removeNaNFromPointCloud<PointXYZ> (*xyz_cloud_pre, *xyz_cloud, index_vector);
 
-      
-  TicToc tt;
-  tt.tic ();
   PointCloud<PointXYZ>::Ptr xyz_cloud_filtered (new PointCloud<PointXYZ> ());
   if (method == "statistical")
   {
@@ -131,12 +129,25 @@ compute (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointClou
   else
   {
     PCL_ERROR ("%s is not a valid filter name! Quitting!\n", method.c_str ());
-    return;
+    return (false);
   }
-    
-  print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", xyz_cloud_filtered->width * xyz_cloud_filtered->height); print_info (" points]\n");
 
   toROSMsg (*xyz_cloud_filtered, output);
+  return (true);
+}
+
+void
+compute (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointCloud2 &output,
+         std::string method,
+         int min_pts, double radius,
+         int mean_k, double std_dev_mul, bool negative)
+{
+  TicToc tt;
+  tt.tic ();
+  if (!filter (input, output, method, min_pts, radius, mean_k, std_dev_mul, negative))
+    return;
+
+  print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", output.width * output.height); print_info (" points]\n");
 }
 
 void
@@ -153,6 +164,30 @@ saveCloud (const std::string &filename, const sensor_msgs::PointCloud2 &output)
   print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", output.width * output.height); print_info (" points]\n");
 }
 
+/** \brief Quiet outlier removal of a file, for the batch mode. */
+struct Processor
+{
+  bool
+  operator () (const std::string &input, const std::string &output, size_t &nr_points) const
+  {
+    sensor_msgs::PointCloud2::Ptr cloud (new sensor_msgs::PointCloud2);
+    if (loadPCDFile (input, *cloud) < 0)
+      return (false);
+    sensor_msgs::PointCloud2 filtered;
+    if (!filter (cloud, filtered, method, min_pts, radius, mean_k, std_dev_mul, negative))
+      return (false);
+    nr_points = filtered.width * filtered.height;
+    return (savePCDFile (output, filtered, Eigen::Vector4f::Zero (), Eigen::Quaternionf::Identity (), true) == 0);
+  }
+
+  std::string method;
+  int min_pts;
+  double radius;
+  int mean_k;
+  double std_dev_mul;
+  bool negative;
+};
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -165,15 +200,6 @@ main (int argc, char** argv)
     return (-1);
   }
 
-  // Parse the command line arguments for .pcd files
-  std::vector<int> p_file_indices;
-  p_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
-  if (p_file_indices.size () != 2)
-  {
-    print_error ("Need one input PCD file and one output PCD file to continue.\n");
-    return (-1);
-  }
-
   // Command line parsing
   std::string method = default_method;
   int min_pts = default_min_pts;
@@ -181,7 +207,6 @@ main (int argc, char** argv)
   int mean_k = default_mean_k;
   double std_dev_mul = default_std_dev_mul;
   int negative = default_negative;
-  
 
   parse_argument (argc, argv, "-method", method);
   parse_argument (argc, argv, "-radius", radius);
@@ -189,8 +214,31 @@ main (int argc, char** argv)
   parse_argument (argc, argv, "-mean_k", mean_k);
   parse_argument (argc, argv, "-std_dev_mul", std_dev_mul);
   parse_argument (argc, argv, "-inliers", negative);
-  
-  
+
+  // Batch mode
+  std::vector<batch::File> files;
+  int nr_jobs = 0;
+  int batch_mode = batch::parseArguments (argc, argv, ".pcd", ".pcd", files, nr_jobs);
+  if (batch_mode != 0)
+  {
+    Processor processor;
+    processor.method = method;
+    processor.min_pts = min_pts;
+    processor.radius = radius;
+    processor.mean_k = mean_k;
+    processor.std_dev_mul = std_dev_mul;
+    processor.negative = negative != 0;
+    return (batch_mode < 0 || batch::process (files, nr_jobs, processor) > 0 ? -1 : 0);
+  }
+
+  // Parse the command line arguments for .pcd files
+  std::vector<int> p_file_indices;
+  p_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
+  if (p_file_indices.size () != 2)
+  {
+    print_error ("Need one input PCD file and one output PCD file to continue.\n");
+    return (-1);
+  }
 
   // Load the first file
   sensor_msgs::PointCloud2::Ptr cloud (new sensor_msgs::PointCloud2);
@@ -43,6 +43,7 @@
 #include <pcl/console/parse.h>
 #include <pcl/console/time.h>
 #include <pcl/filters/passthrough.h>
+#include "batch_processing.h"
 
 
 using namespace std;
@@ -71,6 +72,7 @@ printHelp (int, char **argv)
   print_value ("%d", default_inside); print_info (")\n");
   print_info ("                     -keep 0/1 = keep the points organized (1) or not (default: ");
   print_value ("%d", default_keep_organized); print_info (")\n");
+  batch::printHelp ();
 }
 
 bool
@@ -88,6 +90,19 @@ loadCloud (const std::string &filename, sensor_msgs::PointCloud2 &cloud)
   return (true);
 }
 
+void
+filter (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointCloud2 &output,
+        const std::string &field_name, float min, float max, bool inside, bool keep_organized)
+{
+  PassThrough<sensor_msgs::PointCloud2> passthrough_filter;
+  passthrough_filter.setInputCloud (input);
+  passthrough_filter.setFilterFieldName (field_name);
+  passthrough_filter.setFilterLimits (min, max);
+  passthrough_filter.setFilterLimitsNegative (!inside);
+  passthrough_filter.setKeepOrganized (keep_organized);
+  passthrough_filter.filter (output);
+}
+
 void
 compute (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointCloud2 &output,
          std::string field_name, float min, float max, bool inside, bool keep_organized)
@@ -98,13 +113,7 @@ compute (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointClou
 
   print_highlight (stderr, "Computing ");
 
-  PassThrough<sensor_msgs::PointCloud2> passthrough_filter;
-  passthrough_filter.setInputCloud (input);
-  passthrough_filter.setFilterFieldName (field_name);
-  passthrough_filter.setFilterLimits (min, max);
-  passthrough_filter.setFilterLimitsNegative (!inside);
-  passthrough_filter.setKeepOrganized (keep_organized);
-  passthrough_filter.filter (output);
+  filter (input, output, field_name, min, max, inside, keep_organized);
 
   print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", output.width * output.height); print_info (" points]\n");
 }
@@ -123,35 +132,26 @@ saveCloud (const std::string &filename, const sensor_msgs::PointCloud2 &output)
   print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", output.width * output.height); print_info (" points]\n");
 }
 
-int
-batchProcess (const vector<string> &pcd_files, string &output_dir,
-              std::string field_name, float min, float max, bool inside, bool keep_organized)
+/** \brief Quiet filtering of a file, for the batch mode. */
+struct Processor
 {
-  vector<string> st;
-  for (size_t i = 0; i < pcd_files.size (); ++i)
+  bool
+  operator () (const std::string &input, const std::string &output, size_t &nr_points) const
   {
-    // Load the first file
     sensor_msgs::PointCloud2::Ptr cloud (new sensor_msgs::PointCloud2);
-    if (!loadCloud (pcd_files[i], *cloud)) 
-      return (-1);
-
-    // Perform the feature estimation
-    sensor_msgs::PointCloud2 output;
-    compute (cloud, output, field_name, min, max, inside, keep_organized);
-
-    // Prepare output file name
-    string filename = pcd_files[i];
-    boost::trim (filename);
-    boost::split (st, filename, boost::is_any_of ("/\\"), boost::token_compress_on);
-    
-    // Save into the second file
-    stringstream ss;
-    ss << output_dir << "/" << st.at (st.size () - 1);
-    saveCloud (ss.str (), output);
+    if (loadPCDFile (input, *cloud) < 0)
+      return (false);
+    sensor_msgs::PointCloud2 filtered;
+    filter (cloud, filtered, field_name, min, max, inside, keep_organized);
+    nr_points = filtered.width * filtered.height;
+    PCDWriter w;
+    return (w.writeBinaryCompressed (output, filtered) == 0);
   }
-  return (0);
-}
 
+  std::string field_name;
+  float min, max;
+  bool inside, keep_organized;
+};
 
 /* ---[ */
 int
@@ -165,8 +165,6 @@ main (int argc, char** argv)
     return (-1);
   }
 
-  bool batch_mode = false;
-
   // Command line parsing
   float min = default_min, max = default_max;
   bool inside = default_inside;
@@ -177,21 +175,12 @@ main (int argc, char** argv)
   parse_argument (argc, argv, "-inside", inside);
   parse_argument (argc, argv, "-field", field_name);
   parse_argument (argc, argv, "-keep", keep_organized);
-  string input_dir, output_dir;
-  if (parse_argument (argc, argv, "-input_dir", input_dir) != -1)
-  {
-    PCL_INFO ("Input directory given as %s. Batch process mode on.\n", input_dir.c_str ());
-    if (parse_argument (argc, argv, "-output_dir", output_dir) == -1)
-    {
-      PCL_ERROR ("Need an output directory! Please use -output_dir to continue.\n");
-      return (-1);
-    }
-
-    // Both input dir and output dir given, switch into batch processing mode
-    batch_mode = true;
-  }
 
-  if (!batch_mode)
+  // Batch mode
+  std::vector<batch::File> files;
+  int nr_jobs = 0;
+  int batch_mode = batch::parseArguments (argc, argv, ".pcd", ".pcd", files, nr_jobs);
+  if (batch_mode == 0)
   {
     // Parse the command line arguments for .pcd files
     std::vector<int> p_file_indices;
@@ -216,25 +205,9 @@ main (int argc, char** argv)
   }
   else
   {
-    if (input_dir != "" && boost::filesystem::exists (input_dir))
-    {
-      vector<string> pcd_files;
-      boost::filesystem::directory_iterator end_itr;
-      for (boost::filesystem::directory_iterator itr (input_dir); itr != end_itr; ++itr)
-      {
-        // Only add PCD files
-        if (!is_directory (itr->status ()) && boost::algorithm::to_upper_copy (boost::filesystem::extension (itr->path ())) == ".PCD" )
-        {
-          pcd_files.push_back (itr->path ().string ());
-          PCL_INFO ("[Batch processing mode] Added %s for processing.\n", itr->path ().string ().c_str ());
-        }
-      }
-      batchProcess (pcd_files, output_dir, field_name, min, max, inside, keep_organized);
-    }
-    else
-    {
-      PCL_ERROR ("Batch processing mode enabled, but invalid input directory (%s) given!\n", input_dir.c_str ());
-      return (-1);
-    }
+    Processor processor;
+    processor.field_name = field_name; processor.min = min; processor.max = max;
+    processor.inside = inside; processor.keep_organized = keep_organized;
+    return (batch_mode < 0 || batch::process (files, nr_jobs, processor) > 0 ? -1 : 0);
   }
 }
@@ -42,6 +42,7 @@
 #include <pcl/console/print.h>
 #include <pcl/console/parse.h>
 #include <pcl/console/time.h>
+#include "batch_processing.h"
 
 using namespace pcl;
 using namespace pcl::io;
@@ -51,6 +52,7 @@ void
 printHelp (int, char **argv)
 {
   print_error ("Syntax is: %s [-format 0|1] [-use_camera 0|1] input.pcd output.ply\n", argv[0]);
+  batch::printHelp ();
 }
 
 bool
@@ -82,6 +84,25 @@ saveCloud (const std::string &filename, const sensor_msgs::PointCloud2 &cloud, b
   print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", cloud.width * cloud.height); print_info (" points]\n");
 }
 
+/** \brief Quiet conversion of a file, for the batch mode. */
+struct Converter
+{
+  Converter (bool binary, bool use_camera) : binary_ (binary), use_camera_ (use_camera) {}
+
+  bool
+  operator () (const std::string &input, const std::string &output, size_t &nr_points) const
+  {
+    sensor_msgs::PointCloud2 cloud;
+    if (loadPCDFile (input, cloud) < 0)
+      return (false);
+    nr_points = cloud.width * cloud.height;
+    pcl::PLYWriter writer;
+    return (writer.write (output, cloud, Eigen::Vector4f::Zero (), Eigen::Quaternionf::Identity (), binary_, use_camera_) == 0);
+  }
+
+  bool binary_, use_camera_;
+};
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -94,6 +115,21 @@ main (int argc, char** argv)
     return (-1);
   }
 
+  // Command line parsing
+  bool format = true;
+  bool use_camera = true;
+  parse_argument (argc, argv, "-format", format);
+  parse_argument (argc, argv, "-use_camera", use_camera);
+  print_info ("PLY output format: "); print_value ("%s, ", (format ? "binary" : "ascii"));
+  print_value ("%s\n", (use_camera ? "using camera" : "no camera"));
+
+  // Batch mode
+  std::vector<batch::File> files;
+  int nr_jobs = 0;
+  int batch_mode = batch::parseArguments (argc, argv, ".pcd", ".ply", files, nr_jobs);
+  if (batch_mode != 0)
+    return (batch_mode < 0 || batch::process (files, nr_jobs, Converter (format, use_camera)) > 0 ? -1 : 0);
+
   // Parse the command line arguments for .pcd and .ply files
   std::vector<int> pcd_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
   std::vector<int> ply_file_indices = parse_file_extension_argument (argc, argv, ".ply");
@@ -103,14 +139,6 @@ main (int argc, char** argv)
     return (-1);
   }
 
-  // Command line parsing
-  bool format = true;
-  bool use_camera = true;
-  parse_argument (argc, argv, "-format", format);
-  parse_argument (argc, argv, "-use_camera", use_camera);
-  print_info ("PLY output format: "); print_value ("%s, ", (format ? "binary" : "ascii"));
-  print_value ("%s\n", (use_camera ? "using camera" : "no camera"));
-
   // Load the first file
   sensor_msgs::PointCloud2 cloud;
   if (!loadCloud (argv[pcd_file_indices[0]], cloud)) 
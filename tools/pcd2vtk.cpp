@@ -41,6 +41,7 @@
 #include <pcl/console/print.h>
 #include <pcl/console/parse.h>
 #include <pcl/console/time.h>
+#include "batch_processing.h"
 
 using namespace pcl;
 using namespace pcl::io;
@@ -50,6 +51,7 @@ void
 printHelp (int, char **argv)
 {
   print_error ("Syntax is: %s input.pcd output.vtk\n", argv[0]);
+  batch::printHelp ();
 }
 
 bool
@@ -80,6 +82,20 @@ saveCloud (const std::string &filename, const sensor_msgs::PointCloud2 &cloud)
   print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", cloud.width * cloud.height); print_info (" points]\n");
 }
 
+/** \brief Quiet conversion of a file, for the batch mode. */
+struct Converter
+{
+  bool
+  operator () (const std::string &input, const std::string &output, size_t &nr_points) const
+  {
+    sensor_msgs::PointCloud2 cloud;
+    if (loadPCDFile (input, cloud) < 0)
+      return (false);
+    nr_points = cloud.width * cloud.height;
+    return (saveVTKFile (output, cloud) == 0);
+  }
+};
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -92,6 +108,13 @@ main (int argc, char** argv)
     return (-1);
   }
 
+  // Batch mode
+  std::vector<batch::File> files;
+  int nr_jobs = 0;
+  int batch_mode = batch::parseArguments (argc, argv, ".pcd", ".vtk", files, nr_jobs);
+  if (batch_mode != 0)
+    return (batch_mode < 0 || batch::process (files, nr_jobs, Converter ()) > 0 ? -1 : 0);
+
   // Parse the command line arguments for .pcd and .vtk files
   std::vector<int> pcd_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
   std::vector<int> vtk_file_indices = parse_file_extension_argument (argc, argv, ".vtk");
@@ -42,6 +42,7 @@
 #include <pcl/console/print.h>
 #include <pcl/console/parse.h>
 #include <pcl/console/time.h>
+#include "batch_processing.h"
 
 using namespace pcl;
 using namespace pcl::io;
@@ -50,7 +51,8 @@ using namespace pcl::console;
 void
 printHelp (int, char **argv)
 {
-  print_error ("Syntax is: %s input.ply output.pcd\n", argv[0]);
+  print_error ("Syntax is: %s [-format 0|1] input.ply output.pcd\n", argv[0]);
+  batch::printHelp ();
 }
 
 bool
@@ -83,6 +85,26 @@ saveCloud (const std::string &filename, const sensor_msgs::PointCloud2 &cloud, b
   print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", cloud.width * cloud.height); print_info (" points]\n");
 }
 
+/** \brief Quiet conversion of a file, for the batch mode. */
+struct Converter
+{
+  Converter (bool binary) : binary_ (binary) {}
+
+  bool
+  operator () (const std::string &input, const std::string &output, size_t &nr_points) const
+  {
+    sensor_msgs::PointCloud2 cloud;
+    pcl::PLYReader reader;
+    if (reader.read (input, cloud) < 0)
+      return (false);
+    nr_points = cloud.width * cloud.height;
+    pcl::PCDWriter writer;
+    return (writer.write (output, cloud, Eigen::Vector4f::Zero (), Eigen::Quaternionf::Identity (), binary_) == 0);
+  }
+
+  bool binary_;
+};
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -95,6 +117,18 @@ main (int argc, char** argv)
     return (-1);
   }
 
+  // Command line parsing
+  bool format = 0;
+  parse_argument (argc, argv, "-format", format);
+  print_info ("PCD output format: "); print_value ("%s\n", (format ? "binary" : "asci"));
+
+  // Batch mode
+  std::vector<batch::File> files;
+  int nr_jobs = 0;
+  int batch_mode = batch::parseArguments (argc, argv, ".ply", ".pcd", files, nr_jobs);
+  if (batch_mode != 0)
+    return (batch_mode < 0 || batch::process (files, nr_jobs, Converter (format)) > 0 ? -1 : 0);
+
   // Parse the command line arguments for .pcd and .ply files
   std::vector<int> pcd_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
   std::vector<int> ply_file_indices = parse_file_extension_argument (argc, argv, ".ply");
@@ -104,11 +138,6 @@ main (int argc, char** argv)
     return (-1);
   }
 
-  // Command line parsing
-  bool format = 0;
-  parse_argument (argc, argv, "-format", format);
-  print_info ("PCD output format: "); print_value ("%s\n", (format ? "binary" : "asci"));
-
   // Load the first file
   sensor_msgs::PointCloud2 cloud;
   if (!loadCloud (argv[ply_file_indices[0]], cloud)) 
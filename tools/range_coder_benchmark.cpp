@@ -0,0 +1,229 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#include <pcl/point_types.h>
+#include <pcl/console/print.h>
+#include <pcl/console/parse.h>
+#include <pcl/console/time.h>
+#include <pcl/io/pcd_io.h>
+#include <pcl/compression/octree_pointcloud_compression.h>
+
+#include <sstream>
+
+using namespace pcl;
+using namespace pcl::io;
+using namespace pcl::console;
+
+typedef PointXYZRGBA PointT;
+typedef PointCloud<PointT> Cloud;
+
+int default_iterations = 10;
+
+void
+printHelp (int, char **argv)
+{
+  print_error ("Syntax is: %s input.pcd <options>\n", argv[0]);
+  print_info ("  where options are:\n");
+  print_info ("                     -iterations X = minimum number of times every stream is encoded and decoded (default: ");
+  print_value ("%d", default_iterations); print_info ("),\n");
+  print_info ("                                     small streams are repeated until 64MB are processed\n");
+}
+
+/** \brief Print the throughput of a coder on a stream of \a size bytes. */
+void
+printResult (const std::string &name, size_t size, size_t compressed_size, int iterations, double encode_time, double decode_time)
+{
+  const double megabytes = static_cast<double> (size) * iterations / (1024.0 * 1024.0);
+  print_info ("  %-26s: ", name.c_str ());
+  print_value ("%8.1f", megabytes / (encode_time / 1000.0)); print_info (" MB/s encode, ");
+  print_value ("%8.1f", megabytes / (decode_time / 1000.0)); print_info (" MB/s decode, ");
+  print_value ("%zu", compressed_size); print_info (" bytes\n");
+}
+
+/** \brief Encode and decode a char stream with the static coder. */
+void
+benchmarkChars (const std::string &name, const std::vector<char> &data, int iterations,
+                StaticRangeCoder::BitstreamVersion version)
+{
+  StaticRangeCoder coder;
+  coder.setBitstreamVersion (version);
+  std::vector<char> decoded (data.size ());
+  std::stringstream stream;
+  TicToc tt;
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+  {
+    stream.str ("");
+    coder.encodeCharVectorToStream (data, stream);
+  }
+  double encode_time = tt.toc ();
+  const std::string compressed = stream.str ();
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+  {
+    std::istringstream input (compressed);
+    coder.decodeStreamToCharVector (input, decoded);
+  }
+  double decode_time = tt.toc ();
+  if (decoded != data)
+    print_error ("  %s: decoded stream differs!\n", name.c_str ());
+  printResult (name, data.size (), compressed.size (), iterations, encode_time, decode_time);
+}
+
+/** \brief Encode and decode a char stream with the adaptive coder. */
+void
+benchmarkAdaptive (const std::string &name, const std::vector<char> &data, int iterations)
+{
+  AdaptiveRangeCoder coder;
+  std::vector<char> decoded (data.size ());
+  std::stringstream stream;
+  TicToc tt;
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+  {
+    stream.str ("");
+    coder.encodeCharVectorToStream (data, stream);
+  }
+  double encode_time = tt.toc ();
+  const std::string compressed = stream.str ();
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+  {
+    std::istringstream input (compressed);
+    coder.decodeStreamToCharVector (input, decoded);
+  }
+  double decode_time = tt.toc ();
+  if (decoded != data)
+    print_error ("  %s: decoded stream differs!\n", name.c_str ());
+  printResult (name, data.size (), compressed.size (), iterations, encode_time, decode_time);
+}
+
+/** \brief Encode and decode an integer stream with the static coder. */
+void
+benchmarkInts (const std::string &name, std::vector<unsigned int> &data, int iterations,
+               StaticRangeCoder::BitstreamVersion version)
+{
+  StaticRangeCoder coder;
+  coder.setBitstreamVersion (version);
+  std::vector<unsigned int> decoded (data.size ());
+  std::stringstream stream;
+  TicToc tt;
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+  {
+    stream.str ("");
+    coder.encodeIntVectorToStream (data, stream);
+  }
+  double encode_time = tt.toc ();
+  const std::string compressed = stream.str ();
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+  {
+    std::istringstream input (compressed);
+    coder.decodeStreamToIntVector (input, decoded);
+  }
+  double decode_time = tt.toc ();
+  if (decoded != data)
+    print_error ("  %s: decoded stream differs!\n", name.c_str ());
+  printResult (name, data.size () * sizeof (unsigned int), compressed.size (), iterations, encode_time, decode_time);
+}
+
+/** \brief Run all the coders on a char stream. */
+void
+benchmarkStream (const std::string &name, const std::vector<char> &data, int iterations)
+{
+  if (data.empty ())
+    return;
+  iterations = std::max (iterations, static_cast<int> ((64 << 20) / data.size ()));
+  print_info ("%s (", name.c_str ()); print_value ("%zu", data.size ()); print_info (" bytes):\n");
+  benchmarkChars ("StaticRangeCoder (range)", data, iterations, StaticRangeCoder::RANGE_CODER_BITSTREAM);
+  benchmarkChars ("StaticRangeCoder (rANS)", data, iterations, StaticRangeCoder::RANS_BITSTREAM);
+  benchmarkAdaptive ("AdaptiveRangeCoder", data, iterations);
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  print_info ("Measure the entropy coders on the streams of the octree compression. For more information, use: %s -h\n", argv[0]);
+
+  std::vector<int> pcd_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
+  if (argc < 2 || pcd_file_indices.size () != 1)
+  {
+    printHelp (argc, argv);
+    return (-1);
+  }
+
+  int iterations = default_iterations;
+  parse_argument (argc, argv, "-iterations", iterations);
+  if (iterations < 1)
+    iterations = 1;
+
+  Cloud::Ptr cloud (new Cloud);
+  if (loadPCDFile (argv[pcd_file_indices[0]], *cloud) < 0)
+  {
+    print_error ("Could not load %s.\n", argv[pcd_file_indices[0]]);
+    return (-1);
+  }
+
+  // The streams of an intra frame, and the voxel color stream of a voxel grid frame
+  OctreePointCloudCompression<PointT> encoder (MANUAL_CONFIGURATION, false, 0.001, 0.01, false, 30, true, 6);
+  OctreePointCloudCompression<PointT>::FrameData frame;
+  encoder.serializePointCloud (cloud, frame);
+  OctreePointCloudCompression<PointT> voxel_encoder (MANUAL_CONFIGURATION, false, 0.01, 0.01, true, 30, true, 6);
+  OctreePointCloudCompression<PointT>::FrameData voxel_frame;
+  voxel_encoder.serializePointCloud (cloud, voxel_frame);
+
+  benchmarkStream ("Octree structure", frame.binaryTreeData, iterations);
+  benchmarkStream ("Point detail", frame.pointDiffData, iterations);
+  benchmarkStream ("Point color", frame.pointDiffColorData, iterations);
+  benchmarkStream ("Voxel color", voxel_frame.avgColorData, iterations);
+
+  std::vector<unsigned int> &counts = frame.pointCountData;
+  if (!counts.empty ())
+  {
+    print_info ("Point counts ("); print_value ("%zu", counts.size ()); print_info (" integers):\n");
+    iterations = std::max (iterations, static_cast<int> ((64 << 20) / (counts.size () * sizeof (unsigned int))));
+    benchmarkInts ("StaticRangeCoder (range)", counts, iterations, StaticRangeCoder::RANGE_CODER_BITSTREAM);
+    benchmarkInts ("StaticRangeCoder (rANS)", counts, iterations, StaticRangeCoder::RANS_BITSTREAM);
+  }
+
+  return (0);
+}
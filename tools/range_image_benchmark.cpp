@@ -0,0 +1,179 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#include <pcl/point_types.h>
+#include <pcl/range_image/range_image_planar.h>
+#include <pcl/console/print.h>
+#include <pcl/console/parse.h>
+#include <pcl/console/time.h>
+#include <pcl/io/pcd_io.h>
+
+using namespace pcl;
+using namespace pcl::io;
+using namespace pcl::console;
+
+typedef PointXYZ PointT;
+typedef PointCloud<PointT> Cloud;
+
+int default_iterations = 10;
+int default_threads = 0;
+float default_resolution = 0.1f;
+float default_noise_level = 0.0f;
+
+void
+printHelp (int, char **argv)
+{
+  print_error ("Syntax is: %s input.pcd <options>\n", argv[0]);
+  print_info ("  where options are:\n");
+  print_info ("                     -iterations X = number of times every construction is run (default: ");
+  print_value ("%d", default_iterations); print_info (")\n");
+  print_info ("                     -threads X    = number of threads of the parallel runs (default: ");
+  print_value ("%d", default_threads); print_info (", automatic)\n");
+  print_info ("                     -resolution X = angular resolution of the range image in degrees (default: ");
+  print_value ("%g", default_resolution); print_info (")\n");
+  print_info ("                     -noise X      = noise level of the z-buffer in meters (default: ");
+  print_value ("%g", default_noise_level); print_info (")\n");
+}
+
+/** \brief Check that two range images are identical. */
+bool
+isSameImage (const RangeImage &a, const RangeImage &b)
+{
+  if (a.width != b.width || a.height != b.height)
+    return (false);
+  for (size_t i = 0; i < a.points.size (); ++i)
+  {
+    if (!pcl_isfinite (a.points[i].range) && !pcl_isfinite (b.points[i].range))
+      continue;
+    if (a.points[i].range != b.points[i].range || a.points[i].x != b.points[i].x ||
+        a.points[i].y != b.points[i].y || a.points[i].z != b.points[i].z)
+      return (false);
+  }
+  return (true);
+}
+
+/** \brief Print the times of the serial and parallel runs. */
+void
+printResult (const std::string &name, int iterations, double serial_time, double parallel_time, bool identical)
+{
+  print_info ("  %-20s: ", name.c_str ());
+  print_value ("%8.2f", serial_time / iterations); print_info (" ms serial, ");
+  print_value ("%8.2f", parallel_time / iterations); print_info (" ms parallel, speedup ");
+  print_value ("%.2f", serial_time / parallel_time);
+  if (identical)
+    print_info (", identical images\n");
+  else
+    print_error (", different images!\n");
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  print_info ("Compare the serial and parallel constructions of range images. For more information, use: %s -h\n", argv[0]);
+
+  std::vector<int> pcd_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
+  if (find_switch (argc, argv, "-h") || pcd_file_indices.empty ())
+  {
+    printHelp (argc, argv);
+    return (0);
+  }
+
+  int iterations = default_iterations, threads = default_threads;
+  float resolution = default_resolution, noise_level = default_noise_level;
+  parse_argument (argc, argv, "-iterations", iterations);
+  parse_argument (argc, argv, "-threads", threads);
+  parse_argument (argc, argv, "-resolution", resolution);
+  parse_argument (argc, argv, "-noise", noise_level);
+  iterations = std::max (iterations, 1);
+
+  Cloud cloud;
+  if (loadPCDFile (argv[pcd_file_indices[0]], cloud) < 0)
+  {
+    print_error ("Could not load %s.\n", argv[pcd_file_indices[0]]);
+    return (-1);
+  }
+  print_info ("Using "); print_value ("%zu", cloud.points.size ()); print_info (" points, ");
+  print_value ("%d", iterations); print_info (" iterations:\n");
+
+  TicToc tt;
+  double serial_time, parallel_time;
+
+  // Spherical projection of the cloud, seen from its origin
+  RangeImage serial, parallel;
+  RangeImage::max_no_of_threads = 1;
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+    serial.createFromPointCloud (cloud, deg2rad (resolution), deg2rad (360.0f), deg2rad (180.0f),
+                                 Eigen::Affine3f::Identity (), RangeImage::CAMERA_FRAME, noise_level);
+  serial_time = tt.toc ();
+  RangeImage::max_no_of_threads = threads;
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+    parallel.createFromPointCloud (cloud, deg2rad (resolution), deg2rad (360.0f), deg2rad (180.0f),
+                                   Eigen::Affine3f::Identity (), RangeImage::CAMERA_FRAME, noise_level);
+  parallel_time = tt.toc ();
+  printResult ("createFromPointCloud", iterations, serial_time, parallel_time, isSameImage (serial, parallel));
+
+  // Depth image of organized clouds, with the focal length of a Kinect
+  if (cloud.height > 1)
+  {
+    std::vector<float> depth_image (cloud.points.size ());
+    for (size_t i = 0; i < cloud.points.size (); ++i)
+      depth_image[i] = cloud.points[i].z;
+    const float center_x = static_cast<float> (cloud.width - 1) / 2.0f, center_y = static_cast<float> (cloud.height - 1) / 2.0f;
+    const float focal_length = 525.0f * static_cast<float> (cloud.width) / 640.0f;
+
+    RangeImagePlanar serial_planar, parallel_planar;
+    RangeImage::max_no_of_threads = 1;
+    tt.tic ();
+    for (int i = 0; i < iterations; ++i)
+      serial_planar.setDepthImage (&depth_image[0], cloud.width, cloud.height, center_x, center_y, focal_length, focal_length);
+    serial_time = tt.toc ();
+    RangeImage::max_no_of_threads = threads;
+    tt.tic ();
+    for (int i = 0; i < iterations; ++i)
+      parallel_planar.setDepthImage (&depth_image[0], cloud.width, cloud.height, center_x, center_y, focal_length, focal_length);
+    parallel_time = tt.toc ();
+    printResult ("setDepthImage", iterations, serial_time, parallel_time, isSameImage (serial_planar, parallel_planar));
+  }
+
+  return (0);
+}
@@ -0,0 +1,198 @@
+/*
+ * Software License Agreement (BSD License)
+ *
+ *  Point Cloud Library (PCL) - www.pointclouds.org
+ *  Copyright (c) 2012-, Open Perception, Inc.
+ *
+ *  All rights reserved.
+ *
+ *  Redistribution and use in source and binary forms, with or without
+ *  modification, are permitted provided that the following conditions
+ *  are met:
+ *
+ *   * Redistributions of source code must retain the above copyright
+ *     notice, this list of conditions and the following disclaimer.
+ *   * Redistributions in binary form must reproduce the above
+ *     copyright notice, this list of conditions and the following
+ *     disclaimer in the documentation and/or other materials provided
+ *     with the distribution.
+ *   * Neither the name of the copyright holder(s) nor the names of its
+ *     contributors may be used to endorse or promote products derived
+ *     from this software without specific prior written permission.
+ *
+ *  THIS SOFTWARE IS PROVIDED BY THE COPYRIGHT HOLDERS AND CONTRIBUTORS
+ *  "AS IS" AND ANY EXPRESS OR IMPLIED WARRANTIES, INCLUDING, BUT NOT
+ *  LIMITED TO, THE IMPLIED WARRANTIES OF MERCHANTABILITY AND FITNESS
+ *  FOR A PARTICULAR PURPOSE ARE DISCLAIMED. IN NO EVENT SHALL THE
+ *  COPYRIGHT OWNER OR CONTRIBUTORS BE LIABLE FOR ANY DIRECT, INDIRECT,
+ *  INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES (INCLUDING,
+ *  BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR SERVICES;
+ *  LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION) HOWEVER
+ *  CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT, STRICT
+ *  LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING IN
+ *  ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+ *  POSSIBILITY OF SUCH DAMAGE.
+ *
+ * $Id$
+ *
+ */
+
+
+#include <pcl/point_types.h>
+#include <pcl/point_cloud_soa.h>
+#include <pcl/common/common.h>
+#include <pcl/common/centroid.h>
+#include <pcl/common/distances.h>
+#include <pcl/common/transforms.h>
+#include <pcl/console/print.h>
+#include <pcl/console/parse.h>
+#include <pcl/console/time.h>
+#include <pcl/io/pcd_io.h>
+
+using namespace pcl;
+using namespace pcl::io;
+using namespace pcl::console;
+
+typedef PointXYZ PointT;
+typedef PointCloud<PointT> Cloud;
+
+int default_iterations = 100;
+int default_points = 1000000;
+
+void
+printHelp (int, char **argv)
+{
+  print_error ("Syntax is: %s [input.pcd] <options>\n", argv[0]);
+  print_info ("  where options are:\n");
+  print_info ("                     -iterations X = minimum number of times every kernel is run (default: ");
+  print_value ("%d", default_iterations); print_info ("),\n");
+  print_info ("                                     small clouds are repeated until 100M points are processed\n");
+  print_info ("                     -points X     = number of random points used without input file (default: ");
+  print_value ("%d", default_points); print_info (")\n");
+}
+
+/** \brief Print the time of a kernel on both layouts. */
+void
+printResult (const std::string &name, size_t nr_points, int iterations, double aos_time, double soa_time)
+{
+  const double megapoints = static_cast<double> (nr_points) * iterations / 1e6;
+  print_info ("  %-20s: ", name.c_str ());
+  print_value ("%8.1f", megapoints / (aos_time / 1000.0)); print_info (" Mpts/s AoS, ");
+  print_value ("%8.1f", megapoints / (soa_time / 1000.0)); print_info (" Mpts/s SoA, speedup ");
+  print_value ("%.2f", aos_time / soa_time); print_info ("\n");
+}
+
+/** \brief Distances of the points to a plane, with the array of structures layout. */
+void
+getPlaneDistances (const Cloud &cloud, const Eigen::Vector4f &plane_coefficients, std::vector<float> &distances)
+{
+  distances.resize (cloud.points.size ());
+  for (size_t i = 0; i < cloud.points.size (); ++i)
+  {
+    Eigen::Vector4f pt (cloud.points[i].x, cloud.points[i].y, cloud.points[i].z, 1.0f);
+    distances[i] = fabsf (plane_coefficients.dot (pt));
+  }
+}
+
+/* ---[ */
+int
+main (int argc, char** argv)
+{
+  print_info ("Compare the kernels on the array of structures and on the structure of arrays layouts. For more information, use: %s -h\n", argv[0]);
+
+  if (find_switch (argc, argv, "-h"))
+  {
+    printHelp (argc, argv);
+    return (0);
+  }
+
+  int iterations = default_iterations;
+  parse_argument (argc, argv, "-iterations", iterations);
+  if (iterations < 1)
+    iterations = 1;
+
+  Cloud cloud;
+  std::vector<int> pcd_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
+  if (!pcd_file_indices.empty ())
+  {
+    if (loadPCDFile (argv[pcd_file_indices[0]], cloud) < 0)
+    {
+      print_error ("Could not load %s.\n", argv[pcd_file_indices[0]]);
+      return (-1);
+    }
+  }
+  else
+  {
+    int nr_points = default_points;
+    parse_argument (argc, argv, "-points", nr_points);
+    cloud.width = std::max (nr_points, 1);
+    cloud.height = 1;
+    cloud.points.resize (cloud.width);
+    for (size_t i = 0; i < cloud.points.size (); ++i)
+    {
+      cloud.points[i].x = static_cast<float> (rand ()) / RAND_MAX;
+      cloud.points[i].y = static_cast<float> (rand ()) / RAND_MAX;
+      cloud.points[i].z = static_cast<float> (rand ()) / RAND_MAX;
+    }
+  }
+
+  PointCloudSoA soa;
+  copyPointCloud (cloud, soa);
+  iterations = std::max (iterations, static_cast<int> (100000000 / std::max<size_t> (soa.size (), 1)));
+  print_info ("Using "); print_value ("%zu", soa.size ()); print_info (" points, ");
+  print_value ("%d", iterations); print_info (" iterations (%s cloud):\n", soa.is_dense ? "dense" : "non dense");
+
+  TicToc tt;
+  double aos_time, soa_time;
+
+  Eigen::Affine3f transform = Eigen::Affine3f::Identity ();
+  transform.rotate (Eigen::AngleAxisf (0.3f, Eigen::Vector3f::UnitZ ()));
+  transform.translation () << 0.1f, 0.2f, 0.3f;
+  Cloud cloud_out;
+  PointCloudSoA soa_out;
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+    transformPointCloud (cloud, cloud_out, transform);
+  aos_time = tt.toc ();
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+    transformPointCloud (soa, soa_out, transform);
+  soa_time = tt.toc ();
+  printResult ("transformPointCloud", soa.size (), iterations, aos_time, soa_time);
+
+  Eigen::Vector4f min_pt, max_pt;
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+    getMinMax3D (cloud, min_pt, max_pt);
+  aos_time = tt.toc ();
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+    getMinMax3D (soa, min_pt, max_pt);
+  soa_time = tt.toc ();
+  printResult ("getMinMax3D", soa.size (), iterations, aos_time, soa_time);
+
+  Eigen::Vector4f centroid;
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+    compute3DCentroid (cloud, centroid);
+  aos_time = tt.toc ();
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+    compute3DCentroid (soa, centroid);
+  soa_time = tt.toc ();
+  printResult ("compute3DCentroid", soa.size (), iterations, aos_time, soa_time);
+
+  const Eigen::Vector4f plane (0.0f, 0.6f, 0.8f, -0.5f);
+  std::vector<float> distances;
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+    getPlaneDistances (cloud, plane, distances);
+  aos_time = tt.toc ();
+  tt.tic ();
+  for (int i = 0; i < iterations; ++i)
+    getPlaneDistances (soa, plane, distances);
+  soa_time = tt.toc ();
+  printResult ("getPlaneDistances", soa.size (), iterations, aos_time, soa_time);
+
+  return (0);
+}
@@ -42,6 +42,7 @@
 #include <pcl/console/print.h>
 #include <pcl/console/parse.h>
 #include <pcl/console/time.h>
+#include "batch_processing.h"
 
 using namespace pcl;
 using namespace pcl::io;
@@ -65,6 +66,7 @@ printHelp (int, char **argv)
   print_value ("-inf"); print_info (")\n");
   print_info ("                     -fmax  X      = filter all data with values along the specified field larger than this value (default: "); 
   print_value ("inf"); print_info (")\n");
+  batch::printHelp ();
 }
 
 bool
@@ -82,6 +84,18 @@ loadCloud (const std::string &filename, sensor_msgs::PointCloud2 &cloud)
   return (true);
 }
 
+void
+filter (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointCloud2 &output,
+        float leaf_x, float leaf_y, float leaf_z, const std::string &field, double fmin, double fmax)
+{
+  VoxelGrid<sensor_msgs::PointCloud2> grid;
+  grid.setInputCloud (input);
+  grid.setFilterFieldName (field);
+  grid.setFilterLimits (fmin, fmax);
+  grid.setLeafSize (leaf_x, leaf_y, leaf_z);
+  grid.filter (output);
+}
+
 void
 compute (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointCloud2 &output,
          float leaf_x, float leaf_y, float leaf_z, const std::string &field, double fmin, double fmax)
@@ -91,12 +105,7 @@ compute (const sensor_msgs::PointCloud2::ConstPtr &input, sensor_msgs::PointClou
   
   print_highlight ("Computing ");
 
-  VoxelGrid<sensor_msgs::PointCloud2> grid;
-  grid.setInputCloud (input);
-  grid.setFilterFieldName (field);
-  grid.setFilterLimits (fmin, fmax);
-  grid.setLeafSize (leaf_x, leaf_y, leaf_z);
-  grid.filter (output);
+  filter (input, output, leaf_x, leaf_y, leaf_z, field, fmin, fmax);
 
   print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", output.width * output.height); print_info (" points]\n");
 }
@@ -115,6 +124,27 @@ saveCloud (const std::string &filename, const sensor_msgs::PointCloud2 &output)
   print_info ("[done, "); print_value ("%g", tt.toc ()); print_info (" ms : "); print_value ("%d", output.width * output.height); print_info (" points]\n");
 }
 
+/** \brief Quiet filtering of a file, for the batch mode. */
+struct Processor
+{
+  bool
+  operator () (const std::string &input, const std::string &output, size_t &nr_points) const
+  {
+    sensor_msgs::PointCloud2::Ptr cloud (new sensor_msgs::PointCloud2);
+    if (loadPCDFile (input, *cloud) < 0)
+      return (false);
+    sensor_msgs::PointCloud2 filtered;
+    filter (cloud, filtered, leaf_x, leaf_y, leaf_z, field, fmin, fmax);
+    nr_points = filtered.width * filtered.height;
+    PCDWriter w;
+    return (w.writeBinaryCompressed (output, filtered) == 0);
+  }
+
+  float leaf_x, leaf_y, leaf_z;
+  std::string field;
+  double fmin, fmax;
+};
+
 /* ---[ */
 int
 main (int argc, char** argv)
@@ -127,15 +157,6 @@ main (int argc, char** argv)
     return (-1);
   }
 
-  // Parse the command line arguments for .pcd files
-  std::vector<int> p_file_indices;
-  p_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
-  if (p_file_indices.size () != 2)
-  {
-    print_error ("Need one input PCD file and one output PCD file to continue.\n");
-    return (-1);
-  }
-
   // Command line parsing
   float leaf_x = default_leaf_size,
         leaf_y = default_leaf_size,
@@ -177,6 +198,27 @@ main (int argc, char** argv)
   else
     print_value ("%f\n", fmax);
 
+  // Batch mode
+  std::vector<batch::File> files;
+  int nr_jobs = 0;
+  int batch_mode = batch::parseArguments (argc, argv, ".pcd", ".pcd", files, nr_jobs);
+  if (batch_mode != 0)
+  {
+    Processor processor;
+    processor.leaf_x = leaf_x; processor.leaf_y = leaf_y; processor.leaf_z = leaf_z;
+    processor.field = field; processor.fmin = fmin; processor.fmax = fmax;
+    return (batch_mode < 0 || batch::process (files, nr_jobs, processor) > 0 ? -1 : 0);
+  }
+
+  // Parse the command line arguments for .pcd files
+  std::vector<int> p_file_indices;
+  p_file_indices = parse_file_extension_argument (argc, argv, ".pcd");
+  if (p_file_indices.size () != 2)
+  {
+    print_error ("Need one input PCD file and one output PCD file to continue.\n");
+    return (-1);
+  }
+
   // Load the first file
   sensor_msgs::PointCloud2::Ptr cloud (new sensor_msgs::PointCloud2);
   if (!loadCloud (argv[p_file_indices[0]], *cloud)) 
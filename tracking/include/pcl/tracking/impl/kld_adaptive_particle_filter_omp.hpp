@@ -4,84 +4,65 @@
 template <typename PointInT, typename StateT> void
 pcl::tracking::KLDAdaptiveParticleFilterOMPTracker<PointInT, StateT>::weight ()
 {
-  if (!use_normal_)
+  // Without normals the coherence uses all the points, and the indices stay empty pointers.
+  // The particles are processed one at a time, each one transforms the whole reference cloud.
+  std::vector<IndicesPtr> indices_list (particle_num_);
+  if (use_normal_)
   {
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads_)
-#endif
     for (int i = 0; i < particle_num_; i++)
-      this->computeTransformedPointCloudWithoutNormal (particles_->points[i], *transed_reference_vector_[i]);
-    
-    PointCloudInPtr coherence_input (new PointCloudIn);
-    this->cropInputPointCloud (input_, *coherence_input);
-    if (change_counter_ == 0)
     {
-      // test change detector
-      if (!use_change_detector_ || this->testChangeDetection (coherence_input))
-      {
-        changed_ = true;
-        change_counter_ = change_detector_interval_;
-        coherence_->setTargetCloud (coherence_input);
-        coherence_->initCompute ();
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads_)
-#endif
-        for (int i = 0; i < particle_num_; i++)
-        {
-          IndicesPtr indices;
-          coherence_->compute (transed_reference_vector_[i], indices, particles_->points[i].weight);
-        }
-      }
-      else
-        changed_ = false;
-    }
-    else
-    {
-      --change_counter_;
-      coherence_->setTargetCloud (coherence_input);
-      coherence_->initCompute ();
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads_)
-#endif
-      for (int i = 0; i < particle_num_; i++)
-      {
-        IndicesPtr indices;
-        coherence_->compute (transed_reference_vector_[i], indices, particles_->points[i].weight);
-      }
+      indices_list[i] = IndicesPtr (new std::vector<int>);
     }
   }
-  else
+  pcl::parallel_for (0, particle_num_,
+                     pcl::makeRangeMethod (*this, &KLDAdaptiveParticleFilterOMPTracker::transformParticlesRange, indices_list),
+                     1, threads_);
+
+  PointCloudInPtr coherence_input (new PointCloudIn);
+  this->cropInputPointCloud (input_, *coherence_input);
+  if (!use_normal_ && change_counter_ == 0)
   {
-    std::vector<IndicesPtr> indices_list (particle_num_);
-    for (int i = 0; i < particle_num_; i++)
+    // test change detector
+    if (use_change_detector_ && !this->testChangeDetection (coherence_input))
     {
-      indices_list[i] = IndicesPtr (new std::vector<int>);
-    }
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads_)
-#endif
-    for (int i = 0; i < particle_num_; i++)
-    {
-      this->computeTransformedPointCloudWithNormal (particles_->points[i], *indices_list[i], *transed_reference_vector_[i]);
-    }
-    
-    PointCloudInPtr coherence_input (new PointCloudIn);
-    this->cropInputPointCloud (input_, *coherence_input);
-    
-    coherence_->setTargetCloud (coherence_input);
-    coherence_->initCompute ();
-#ifdef _OPENMP
-#pragma omp parallel for num_threads(threads_)
-#endif
-    for (int i = 0; i < particle_num_; i++)
-    {
-      coherence_->compute (transed_reference_vector_[i], indices_list[i], particles_->points[i].weight);
+      changed_ = false;
+      normalizeWeight ();
+      return;
     }
+    changed_ = true;
+    change_counter_ = change_detector_interval_;
   }
-  
+  else if (!use_normal_)
+    --change_counter_;
+
+  coherence_->setTargetCloud (coherence_input);
+  coherence_->initCompute ();
+  pcl::parallel_for (0, particle_num_,
+                     pcl::makeRangeMethod (*this, &KLDAdaptiveParticleFilterOMPTracker::computeWeightsRange, indices_list),
+                     1, threads_);
+
   normalizeWeight ();
 }
 
+template <typename PointInT, typename StateT> void
+pcl::tracking::KLDAdaptiveParticleFilterOMPTracker<PointInT, StateT>::transformParticlesRange (int begin, int end, std::vector<IndicesPtr> &indices_list)
+{
+  for (int i = begin; i < end; i++)
+  {
+    if (use_normal_)
+      this->computeTransformedPointCloudWithNormal (particles_->points[i], *indices_list[i], *transed_reference_vector_[i]);
+    else
+      this->computeTransformedPointCloudWithoutNormal (particles_->points[i], *transed_reference_vector_[i]);
+  }
+}
+
+template <typename PointInT, typename StateT> void
+pcl::tracking::KLDAdaptiveParticleFilterOMPTracker<PointInT, StateT>::computeWeightsRange (int begin, int end, std::vector<IndicesPtr> &indices_list)
+{
+  for (int i = begin; i < end; i++)
+    coherence_->compute (transed_reference_vector_[i], indices_list[i], particles_->points[i].weight);
+}
+
 #define PCL_INSTANTIATE_KLDAdaptiveParticleFilterOMPTracker(T,ST) template class PCL_EXPORTS pcl::tracking::KLDAdaptiveParticleFilterOMPTracker<T,ST>;
 
 #endif
@@ -4,6 +4,7 @@
 #include <pcl/tracking/tracking.h>
 #include <pcl/tracking/particle_filter.h>
 #include <pcl/tracking/coherence.h>
+#include <pcl/common/task_scheduler.h>
 
 namespace pcl
 {
@@ -11,7 +12,7 @@ namespace pcl
   {
   /** \brief @b ParticleFilterOMPTracker tracks the PointCloud which is given by
       setReferenceCloud within the measured PointCloud using particle filter method 
-      in parallel, using the OpenMP standard.
+      in parallel, on the threads of the pcl::TaskScheduler.
     * \author Ryohei Ueda
     * \ingroup tracking
     */
@@ -69,7 +70,7 @@ namespace pcl
         tracker_name_ = "ParticleFilterOMPTracker";
       }
 
-      /** \brief Initialize the scheduler and set the number of threads to use.
+      /** \brief Set the maximum number of threads of the pcl::TaskScheduler to use.
         * \param nr_threads the number of hardware threads to use (0 sets the value back to automatic)
         */
       inline void
@@ -84,6 +85,22 @@ namespace pcl
         */
       virtual void weight ();
 
+      /** \brief Transform the reference cloud by the particles [begin, end), run in parallel by weight.
+        * \param[in] begin the first particle
+        * \param[in] end the particle after the last one
+        * \param[out] indices_list the indices of the points used for the coherence of every particle, with normals
+        */
+      void
+      transformParticlesRange (int begin, int end, std::vector<IndicesPtr> &indices_list);
+
+      /** \brief Compute the coherence of the particles [begin, end), run in parallel by weight.
+        * \param[in] begin the first particle
+        * \param[in] end the particle after the last one
+        * \param[in] indices_list the indices of the points used for the coherence of every particle
+        */
+      void
+      computeWeightsRange (int begin, int end, std::vector<IndicesPtr> &indices_list);
+
     };
   }
 }